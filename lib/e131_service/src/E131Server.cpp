@@ -1,5 +1,9 @@
 
 #include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <iterator>
 #include <netinet/in.h>
 #include <pthread.h>
 #include <stdexcept>
@@ -142,57 +146,333 @@ void E131Server::shutdown() {
     }
 }
 
-void E131Server::createUniverseLocked(uint16_t universeNumber) {
+std::shared_ptr<const E131Server::Galaxy> E131Server::loadGalaxy() const {
+#if defined(__cpp_lib_atomic_shared_ptr)
+    return galaxy.load(std::memory_order_acquire);
+#else
+    return std::atomic_load_explicit(&galaxy, std::memory_order_acquire);
+#endif
+}
+
+void E131Server::publishGalaxy(std::shared_ptr<const Galaxy> next) {
+#if defined(__cpp_lib_atomic_shared_ptr)
+    galaxy.store(std::move(next), std::memory_order_release);
+#else
+    std::atomic_store_explicit(&galaxy, std::move(next), std::memory_order_release);
+#endif
+}
+
+std::shared_ptr<Universe> E131Server::findUniverse(const Galaxy &universes, uint16_t universeNumber) {
+    auto it = std::lower_bound(universes.begin(), universes.end(), universeNumber,
+                               [](const auto &entry, uint16_t number) { return entry.first < number; });
+    if (it != universes.end() && it->first == universeNumber) {
+        return it->second;
+    }
+    return nullptr;
+}
+
+std::shared_ptr<Universe> E131Server::createUniverseLocked(uint16_t universeNumber) {
+    auto current = loadGalaxy();
+    if (auto existing = findUniverse(*current, universeNumber)) {
+        return existing;
+    }
+
     logger->info("creating universe {}", universeNumber);
-    this->galaxy[universeNumber] = std::make_shared<Universe>(logger);
+    auto universe = std::make_shared<Universe>(logger);
+    applySettingsLocked(universeNumber, *universe);
+
+    auto next = std::make_shared<Galaxy>(*current);
+    auto it = std::lower_bound(next->begin(), next->end(), universeNumber,
+                               [](const auto &entry, uint16_t number) { return entry.first < number; });
+    next->emplace(it, universeNumber, universe);
+    publishGalaxy(std::move(next));
+
+    return universe;
 }
 
 void E131Server::createUniverse(uint16_t universeNumber) {
-    std::unique_lock<std::shared_mutex> lock(galaxyMutex_);
+    std::lock_guard<std::mutex> lock(galaxyMutex_);
     createUniverseLocked(universeNumber);
 }
 
 void E131Server::destroyUniverse(uint16_t universeNumber) {
     logger->info("destroying universe {}", universeNumber);
-    std::unique_lock<std::shared_mutex> lock(galaxyMutex_);
-    this->galaxy.erase(universeNumber);
+    std::lock_guard<std::mutex> lock(galaxyMutex_);
+
+    auto current = loadGalaxy();
+    if (!findUniverse(*current, universeNumber)) {
+        return;
+    }
+
+    auto next = std::make_shared<Galaxy>();
+    next->reserve(current->size() - 1);
+    std::copy_if(current->begin(), current->end(), std::back_inserter(*next),
+                 [universeNumber](const auto &entry) { return entry.first != universeNumber; });
+    publishGalaxy(std::move(next));
 }
 
 void E131Server::setValues(uint16_t universeNumber, uint16_t firstSlot, std::vector<uint8_t> &values) {
+    writeSlots(universeNumber, firstSlot, values);
+}
+
+std::shared_ptr<Universe> E131Server::universeForWrite(uint16_t universeNumber, uint16_t firstSlot, size_t count) {
     // Validate universe number to prevent DoS attacks with excessive memory usage
     if (universeNumber == 0 || universeNumber > 63999) {
         logger->error("Invalid universe number: {}", universeNumber);
-        return;
+        return nullptr;
     }
 
     // Validate slot and data size
     if (firstSlot == 0 || firstSlot > 512) {
         logger->error("Invalid first slot: {}", firstSlot);
-        return;
+        return nullptr;
+    }
+
+    if (count > 512) {
+        logger->error("Data size too large: {}", count);
+        return nullptr;
+    }
+
+    // Every frame after the first finds its universe already there, so the
+    // common case never touches galaxyMutex_
+    auto universe = findUniverse(*loadGalaxy(), universeNumber);
+    if (!universe) {
+        std::lock_guard<std::mutex> lock(galaxyMutex_);
+        universe = createUniverseLocked(universeNumber);
+        logger->debug("created universe {} and will set values starting at slot {}", universeNumber, firstSlot);
+    }
+    return universe;
+}
+
+bool E131Server::writeSlots(uint16_t universeNumber, uint16_t firstSlot, std::span<const uint8_t> values) {
+    return writeSlots(DEFAULT_MERGE_SOURCE, universeNumber, firstSlot, values);
+}
+
+bool E131Server::writeSlots(const MergeSource &source, uint16_t universeNumber, uint16_t firstSlot,
+                            std::span<const uint8_t> values) {
+    auto universe = universeForWrite(universeNumber, firstSlot, values.size());
+    if (!universe) {
+        return false;
+    }
+
+    // Universe handles its own concurrency, and our reference keeps it
+    // alive even if it's destroyed while we write.
+    universe->setFragment(source, firstSlot, values);
+    logger->trace("source {} set values starting at slot {} on universe {}", source.id, firstSlot, universeNumber);
+    return true;
+}
+
+bool E131Server::releaseSlots(const MergeSource &source, uint16_t universeNumber, uint16_t firstSlot,
+                              uint16_t count) {
+    auto universe = universeForWrite(universeNumber, firstSlot, count);
+    if (!universe) {
+        return false;
+    }
+
+    universe->releaseSlots(source, firstSlot, count);
+    logger->trace("source {} released {} slots from {} on universe {}", source.id, count, firstSlot, universeNumber);
+    return true;
+}
+
+bool E131Server::handOffSlots(const MergeSource &source, const MergeSource &hold, uint16_t universeNumber,
+                              uint16_t firstSlot, uint16_t count) {
+    auto universe = universeForWrite(universeNumber, firstSlot, count);
+    if (!universe) {
+        return false;
+    }
+
+    universe->handOffSlots(source, hold, firstSlot, count);
+    logger->trace("source {} handed {} slots from {} on universe {} to source {}", source.id, count, firstSlot,
+                  universeNumber, hold.id);
+    return true;
+}
+
+void E131Server::applySettingsLocked(uint16_t universeNumber, Universe &universe) const {
+    uint32_t rate = defaultOutputRateHz;
+    MergeMode mode = defaultMergeMode;
+    if (auto it = universeSettings.find(universeNumber); it != universeSettings.end()) {
+        rate = it->second.outputRateHz.value_or(rate);
+        mode = it->second.mergeMode.value_or(mode);
     }
+    universe.setOutputRate(rate);
+    universe.setMergeMode(mode);
+}
+
+void E131Server::setDefaultOutputRate(uint32_t hz) {
+    std::lock_guard<std::mutex> lock(galaxyMutex_);
+    defaultOutputRateHz = hz;
+    for (const auto &[universeNumber, universe] : *loadGalaxy()) {
+        applySettingsLocked(universeNumber, *universe);
+    }
+    logger->info("sACN output rate is {} Hz unless a universe says otherwise", hz);
+}
+
+void E131Server::setDefaultMergeMode(MergeMode mode) {
+    std::lock_guard<std::mutex> lock(galaxyMutex_);
+    defaultMergeMode = mode;
+    for (const auto &[universeNumber, universe] : *loadGalaxy()) {
+        applySettingsLocked(universeNumber, *universe);
+    }
+}
+
+void E131Server::setOutputRate(uint16_t universeNumber, uint32_t hz) {
+    std::lock_guard<std::mutex> lock(galaxyMutex_);
+    universeSettings[universeNumber].outputRateHz = hz;
+    if (auto universe = findUniverse(*loadGalaxy(), universeNumber)) {
+        applySettingsLocked(universeNumber, *universe);
+    }
+    logger->info("universe {} will be sent at {} Hz", universeNumber, hz);
+}
 
-    if (values.size() > 512) {
-        logger->error("Data size too large: {}", values.size());
+void E131Server::setMergeMode(uint16_t universeNumber, MergeMode mode) {
+    std::lock_guard<std::mutex> lock(galaxyMutex_);
+    universeSettings[universeNumber].mergeMode = mode;
+    if (auto universe = findUniverse(*loadGalaxy(), universeNumber)) {
+        applySettingsLocked(universeNumber, *universe);
+    }
+}
+
+void E131Server::setSendOnChange(bool enabled, uint32_t _keepAliveMs) {
+    keepAliveMs.store(_keepAliveMs);
+    sendOnChange.store(enabled);
+    logger->info("sACN send-on-change {}, keep-alive every {}ms", enabled ? "enabled" : "disabled", _keepAliveMs);
+}
+
+void E131Server::setSendStatsCallback(SendStatsCallback callback) { sendStatsCallback = std::move(callback); }
+
+void E131Server::buildPacket(Output &output) const {
+
+    // Everything but the slots and the sequence number stays put from here on
+    e131_pkt_init(&output.packet, output.universeNumber, UNIVERSE_SLOT_COUNT);
+    e131_multicast_dest(&output.dest, output.universeNumber, E131_DEFAULT_PORT);
+    std::copy(std::begin(cid), std::end(cid), std::begin(output.packet.root.cid));
+    std::copy(std::begin(this->sourceName), std::end(this->sourceName),
+              std::begin(output.packet.frame.source_name));
+
+    // Same length e131_send() would put on the wire
+    output.packetLength =
+        sizeof(output.packet.raw) - sizeof(output.packet.dmp.prop_val) + ntohs(output.packet.dmp.prop_val_cnt);
+}
+
+void E131Server::syncOutputs(const std::shared_ptr<const Galaxy> &current) {
+
+    if (current == outputsGalaxy) {
         return;
     }
 
-    std::shared_ptr<Universe> universe;
-    {
-        std::unique_lock<std::shared_mutex> lock(galaxyMutex_);
-        auto it = galaxy.find(universeNumber);
-        if (it == galaxy.end()) {
-            createUniverseLocked(universeNumber);
-            universe = galaxy[universeNumber];
-            logger->debug("created universe {} and will set values starting at slot {}", universeNumber, firstSlot);
+    // Both lists are sorted by universe number, so walk them together and keep
+    // the packets (and stats) for universes that are still around
+    std::vector<Output> next;
+    next.reserve(current->size());
+    auto existing = outputs.begin();
+    for (const auto &[universeNumber, universe] : *current) {
+        while (existing != outputs.end() && existing->universeNumber < universeNumber) {
+            ++existing;
+        }
+
+        if (existing != outputs.end() && existing->universeNumber == universeNumber &&
+            existing->universe == universe) {
+            next.push_back(std::move(*existing));
+            continue;
+        }
+
+        Output output;
+        output.universeNumber = universeNumber;
+        output.universe = universe;
+        output.stats.universe = universeNumber;
+        buildPacket(output);
+        next.push_back(std::move(output));
+    }
+
+    outputs = std::move(next);
+    outputsGalaxy = current;
+    logger->debug("now sending {} universes", outputs.size());
+}
+
+void E131Server::flush(const std::vector<size_t> &ready, std::chrono::steady_clock::time_point flushStart) {
+
+    using namespace std::chrono;
+
+    auto recordSent = [&](size_t index) {
+        auto &stats = outputs[index].stats;
+        ++stats.packetsSent;
+        stats.recordSendTime(
+            static_cast<uint64_t>(duration_cast<microseconds>(steady_clock::now() - flushStart).count()));
+    };
+
+    auto recordError = [&](size_t index) {
+        ++outputs[index].stats.sendErrors;
+        logger->critical("e131_send on universe {}: {}", outputs[index].universeNumber, strerror(errno));
+    };
+
+#if defined(__linux__)
+
+    // One syscall for the whole rig instead of one per universe
+    std::array<mmsghdr, E131_SEND_BATCH_SIZE> messages{};
+    std::array<iovec, E131_SEND_BATCH_SIZE> vectors{};
+
+    for (size_t batchStart = 0; batchStart < ready.size(); batchStart += E131_SEND_BATCH_SIZE) {
+        const size_t batchSize = std::min<size_t>(E131_SEND_BATCH_SIZE, ready.size() - batchStart);
+
+        for (size_t i = 0; i < batchSize; ++i) {
+            auto &output = outputs[ready[batchStart + i]];
+            vectors[i].iov_base = output.packet.raw;
+            vectors[i].iov_len = output.packetLength;
+            messages[i].msg_hdr = {};
+            messages[i].msg_hdr.msg_name = &output.dest;
+            messages[i].msg_hdr.msg_namelen = sizeof(output.dest);
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        // sendmmsg stops at the first packet that fails. Count that one as an
+        // error and carry on with the rest so one bad universe can't starve
+        // the others.
+        size_t offset = 0;
+        while (offset < batchSize) {
+            const int sent =
+                sendmmsg(socket, messages.data() + offset, static_cast<unsigned int>(batchSize - offset), 0);
+            if (sent < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                recordError(ready[batchStart + offset]);
+                ++offset;
+                continue;
+            }
+            for (int i = 0; i < sent; ++i) {
+                recordSent(ready[batchStart + offset + static_cast<size_t>(i)]);
+            }
+            offset += static_cast<size_t>(sent);
+        }
+    }
+
+#else
+
+    // No sendmmsg() here, so it's one at a time
+    for (const size_t index : ready) {
+        auto &output = outputs[index];
+        if (e131_send(socket, &output.packet, &output.dest) < 0) {
+            recordError(index);
         } else {
-            universe = it->second;
+            recordSent(index);
         }
     }
 
-    // Universe::setFragment has its own internal mutex, so it's safe
-    // to call without holding galaxyMutex_.
-    universe->setFragment(firstSlot, values);
-    logger->debug("set values starting at slot {} on universe {}", firstSlot, universeNumber);
+#endif
+}
+
+void E131Server::publishSendStats() {
+    if (!sendStatsCallback) {
+        return;
+    }
+
+    std::vector<UniverseSendStats> stats;
+    stats.reserve(outputs.size());
+    for (const auto &output : outputs) {
+        stats.push_back(output.stats);
+    }
+    sendStatsCallback(stats);
 }
 
 void E131Server::workerTask() {
@@ -208,68 +488,76 @@ void E131Server::workerTask() {
 
     logger->info("hello from the worker task! 👋🏻");
 
-    auto targetDelta = milliseconds(E131_FRAME_TIME_MS);
-    auto nextTargetTime = high_resolution_clock::now() + targetDelta;
+    // Reused every pass: indexes into outputs of the universes going out
+    std::vector<size_t> ready;
 
-    // Reused across iterations to avoid per-tick heap churn; the snapshot
-    // is rebuilt under the galaxy lock on each tick so a writer can't
-    // mutate the map while we iterate it.
-    std::vector<std::pair<uint16_t, std::shared_ptr<Universe>>> snapshot;
+    auto nextStatsTime = steady_clock::now() + milliseconds(E131_STATS_INTERVAL_MS);
 
     while (!stopRequested.load()) {
 
-        {
-            std::shared_lock<std::shared_mutex> lock(galaxyMutex_);
-            snapshot.assign(galaxy.begin(), galaxy.end());
-        }
+        // Whatever galaxy is current right now; it can't change under us
+        syncOutputs(loadGalaxy());
 
-        // Visit all of the universes in the galaxy
-        for (const auto &pair : snapshot) {
-            uint16_t universeNumber = pair.first;
-            auto universe = pair.second;
+        const auto flushStart = steady_clock::now();
+        const bool onlyChanges = sendOnChange.load(std::memory_order_relaxed);
+        const auto keepAlive = milliseconds(keepAliveMs.load(std::memory_order_relaxed));
 
-            auto state = universe->getState();
+        // Never sleep longer than this, so new universes and shutdown get noticed
+        auto wakeAt = flushStart + milliseconds(E131_FRAME_TIME_MS);
 
-            e131_packet_t packet;
-            e131_addr_t dest;
+        ready.clear();
+        for (size_t index = 0; index < outputs.size(); ++index) {
+            auto &output = outputs[index];
 
-            // Create a packet
-            e131_pkt_init(&packet, universeNumber, state.size());
-            e131_multicast_dest(&dest, universeNumber, E131_DEFAULT_PORT);
+            if (flushStart < output.nextDue) {
+                wakeAt = std::min(wakeAt, output.nextDue);
+                continue;
+            }
+
+            // Stay on this universe's own grid, but if we fell behind, don't
+            // burst to catch up on frames that are already stale
+            const auto period = duration_cast<steady_clock::duration>(
+                microseconds(1'000'000 / std::max<uint32_t>(output.universe->getOutputRate(), 1)));
+            output.nextDue += period;
+            if (output.nextDue <= flushStart) {
+                output.nextDue = flushStart + period;
+            }
+            wakeAt = std::min(wakeAt, output.nextDue);
 
-            // Copy our cid
-            std::copy(std::begin(cid), std::end(cid), std::begin(packet.root.cid));
-            std::copy(state.begin(), state.end(), packet.dmp.prop_val);
+            // Straight into the prebuilt packet
+            const std::span<uint8_t, UNIVERSE_SLOT_COUNT> slots(output.packet.dmp.prop_val, UNIVERSE_SLOT_COUNT);
+            const uint64_t version = output.universe->copyStateTo(slots);
 
-            // Copy our source name
-            std::copy(std::begin(this->sourceName), std::end(this->sourceName), std::begin(packet.frame.source_name));
+            if (output.changes.canSkip(version, slots, flushStart, keepAlive) && onlyChanges) {
+                ++output.stats.packetsSkipped;
+                continue;
+            }
+            output.changes.sent(flushStart);
 
             // Make sure we don't set the START code to anything other than zero
-            packet.dmp.prop_val[0] = 0;
-            packet.frame.seq_number = universe->getNextSequenceNumber();
+            output.packet.dmp.prop_val[0] = 0;
+            output.packet.frame.seq_number = output.universe->getNextSequenceNumber();
 
-            // Toss it out on the network and hope it makes something happy 😍
-            if (e131_send(socket, &packet, &dest) < 0) {
-                logger->critical("e131_send: {}", strerror(errno));
-            }
+            ready.push_back(index);
         }
 
-        // Leave a clue on what happened
-        if (++frameCounter % 1000 == 0) {
-            logger->debug("sent {} e1.31 frames", frameCounter);
-        }
+        if (!ready.empty()) {
 
-        // Figure out how much time we have until the next tick
-        auto remainingTime = nextTargetTime - high_resolution_clock::now();
+            // Toss them all out on the network and hope it makes something happy 😍
+            flush(ready, flushStart);
+
+            // Leave a clue on what happened
+            if (++frameCounter % 1000 == 0) {
+                logger->debug("sent {} e1.31 frames", frameCounter);
+            }
+        }
 
-        // If there's time left, wait.
-        if (remainingTime > nanoseconds(0)) {
-            // Sleep for the remaining time
-            std::this_thread::sleep_for(remainingTime);
+        if (flushStart >= nextStatsTime) {
+            publishSendStats();
+            nextStatsTime = flushStart + milliseconds(E131_STATS_INTERVAL_MS);
         }
 
-        // Update the target time for the next iteration
-        nextTargetTime += targetDelta;
+        std::this_thread::sleep_until(wakeAt);
     }
 }
 
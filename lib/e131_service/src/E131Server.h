@@ -2,8 +2,14 @@
 #pragma once
 
 #include <atomic>
-#include <shared_mutex>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <fmt/format.h>
@@ -11,13 +17,25 @@
 
 #include <uuid/uuid.h>
 
+#include "Merge.h"
+#include "SendOnChange.h"
+#include "SendStats.h"
 #include "Universe.h"
 
 extern "C" {
 #include <e131.h>
 }
 
+// The longest the worker sleeps, so it notices new universes and shutdown
+// promptly. Each universe is sent at its own output rate.
 #define E131_FRAME_TIME_MS 20
+
+// Most packets handed to the kernel in one sendmmsg() call
+#define E131_SEND_BATCH_SIZE 64
+
+// How often the per-universe send stats are published
+#define E131_STATS_INTERVAL_MS 1000
+
 #define SOURCE_NAME_LENGTH 63 // The e1.31 spec says that the source name should be 64 bytes (63 + null terminator)
 
 namespace creatures::e131 {
@@ -25,6 +43,8 @@ namespace creatures::e131 {
 class E131Server {
 
   public:
+    using SendStatsCallback = std::function<void(const std::vector<UniverseSendStats> &)>;
+
     E131Server() = default;
     ~E131Server() = default;
 
@@ -45,24 +65,136 @@ class E131Server {
 
     void setValues(uint16_t universeNumber, uint16_t firstSlot, std::vector<uint8_t> &values);
 
+    /**
+     * Write slots straight into a universe, starting at firstSlot (1-based)
+     *
+     * This is the hot path for playback: no copies, no allocation, and no
+     * locks on the galaxy unless the universe has to be created.
+     *
+     * @return false if the write was rejected (bad universe, slot, or size)
+     */
+    bool writeSlots(uint16_t universeNumber, uint16_t firstSlot, std::span<const uint8_t> values);
+
+    /**
+     * Same as above, but merged with everyone else writing to the universe
+     * according to the source's priority (see Universe)
+     */
+    bool writeSlots(const MergeSource &source, uint16_t universeNumber, uint16_t firstSlot,
+                    std::span<const uint8_t> values);
+
+    /**
+     * Hand some slots back so lower priority sources show through
+     *
+     * @return false if the request was rejected (bad universe or slots)
+     */
+    bool releaseSlots(const MergeSource &source, uint16_t universeNumber, uint16_t firstSlot, uint16_t count);
+
+    /**
+     * Hand some slots from one source to a lower priority hold source, so
+     * they keep their last values until something else drives them
+     *
+     * @return false if the request was rejected (bad universe or slots)
+     */
+    bool handOffSlots(const MergeSource &source, const MergeSource &hold, uint16_t universeNumber,
+                      uint16_t firstSlot, uint16_t count);
+
+    // Used for universes that haven't been given their own
+    void setDefaultOutputRate(uint32_t hz);
+    void setDefaultMergeMode(MergeMode mode);
+
+    // Per-universe settings. They stick even if the universe is destroyed and
+    // comes back later.
+    void setOutputRate(uint16_t universeNumber, uint32_t hz);
+    void setMergeMode(uint16_t universeNumber, MergeMode mode);
+
+    /**
+     * Only send a universe when its data changes, plus the E1.31 repeats and
+     * keep-alives receivers need to hold their outputs. Off by default, in
+     * which case every universe goes out every frame.
+     */
+    void setSendOnChange(bool enabled, uint32_t keepAliveMs = E131_DEFAULT_KEEP_ALIVE_MS);
+
+    /**
+     * Called from the worker thread about once a second with the cumulative
+     * stats for every universe. Set this before start().
+     */
+    void setSendStatsCallback(SendStatsCallback callback);
+
   private:
     std::shared_ptr<spdlog::logger> logger;
 
-    // All of our universes. galaxyMutex_ guards both the map structure
-    // and individual entries — the worker thread iterates galaxy at
-    // ~50 Hz while the event loop thread inserts/erases via
-    // setValues/createUniverse/destroyUniverse.
-    mutable std::shared_mutex galaxyMutex_;
-    std::unordered_map<uint16_t, std::shared_ptr<Universe>> galaxy = {};
+    // All of our universes, sorted by universe number. Each published galaxy
+    // is immutable: createUniverse/destroyUniverse copy it, change the copy,
+    // and swap it in. Readers (the worker thread and writeSlots) just grab
+    // whichever galaxy is current and never take a lock.
+    using Galaxy = std::vector<std::pair<uint16_t, std::shared_ptr<Universe>>>;
+
+#if defined(__cpp_lib_atomic_shared_ptr)
+    std::atomic<std::shared_ptr<const Galaxy>> galaxy{std::make_shared<const Galaxy>()};
+#else
+    std::shared_ptr<const Galaxy> galaxy = std::make_shared<const Galaxy>();
+#endif
+
+    // Serializes the writers that republish the galaxy
+    std::mutex galaxyMutex_;
+
+    std::shared_ptr<const Galaxy> loadGalaxy() const;
+    void publishGalaxy(std::shared_ptr<const Galaxy> next);
+
+    static std::shared_ptr<Universe> findUniverse(const Galaxy &universes, uint16_t universeNumber);
+
+    // Checks the arguments and finds (or creates) the universe for a write
+    std::shared_ptr<Universe> universeForWrite(uint16_t universeNumber, uint16_t firstSlot, size_t count);
+
+    // Output rate and merge mode, guarded by galaxyMutex_
+    struct UniverseSettings {
+        std::optional<uint32_t> outputRateHz;
+        std::optional<MergeMode> mergeMode;
+    };
+    uint32_t defaultOutputRateHz = UNIVERSE_DEFAULT_OUTPUT_RATE_HZ;
+    MergeMode defaultMergeMode = MergeMode::LatestTakesPrecedence;
+    std::unordered_map<uint16_t, UniverseSettings> universeSettings;
+
+    void applySettingsLocked(uint16_t universeNumber, Universe &universe) const;
 
     // Internal version of createUniverse that assumes the caller already
-    // holds galaxyMutex_ exclusively. Used by setValues.
-    void createUniverseLocked(uint16_t universeNumber);
+    // holds galaxyMutex_. Returns the universe, new or existing.
+    std::shared_ptr<Universe> createUniverseLocked(uint16_t universeNumber);
 
     std::thread worker;
 
     void workerTask();
 
+    // Everything the worker needs to send one universe. The packet header is
+    // built once; each frame only the slots and sequence number are patched.
+    struct Output {
+        uint16_t universeNumber = 0;
+        std::shared_ptr<Universe> universe;
+        e131_packet_t packet = {};
+        e131_addr_t dest = {};
+        size_t packetLength = 0;
+
+        SendOnChange changes;
+
+        // When this universe is next due to go out, at its own output rate
+        std::chrono::steady_clock::time_point nextDue;
+
+        UniverseSendStats stats;
+    };
+
+    // Only ever touched by the worker thread
+    std::vector<Output> outputs;
+    std::shared_ptr<const Galaxy> outputsGalaxy;
+
+    void syncOutputs(const std::shared_ptr<const Galaxy> &current);
+    void buildPacket(Output &output) const;
+    void flush(const std::vector<size_t> &ready, std::chrono::steady_clock::time_point flushStart);
+    void publishSendStats();
+
+    std::atomic<bool> sendOnChange = false;
+    std::atomic<uint32_t> keepAliveMs = E131_DEFAULT_KEEP_ALIVE_MS;
+    SendStatsCallback sendStatsCallback;
+
     uuid_t cid;
     int socket = -1;
 
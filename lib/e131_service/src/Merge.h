@@ -0,0 +1,39 @@
+
+#pragma once
+
+#include <cstdint>
+
+// How many sources can drive one universe at once
+#define MAX_MERGE_SOURCES 8
+
+// Same range and default as E1.31 source priority
+#define MERGE_PRIORITY_MAX 200
+#define MERGE_PRIORITY_DEFAULT 100
+
+namespace creatures::e131 {
+
+    /**
+     * How a universe settles a slot that more than one source at the same
+     * priority is driving. A higher priority always wins outright.
+     */
+    enum class MergeMode : uint8_t {
+        HighestTakesPrecedence, // HTP: the biggest value wins
+        LatestTakesPrecedence,  // LTP: the most recent write wins
+    };
+
+    /**
+     * Something that writes slots into a universe
+     *
+     * Each source gets its own layer in every universe it touches, so its
+     * values stick around underneath a higher priority source and come back
+     * when that source lets go of the slots.
+     */
+    struct MergeSource {
+        uint8_t id = 0; // < MAX_MERGE_SOURCES
+        uint8_t priority = MERGE_PRIORITY_DEFAULT;
+    };
+
+    // Writes that don't say who they're from
+    inline constexpr MergeSource DEFAULT_MERGE_SOURCE{};
+
+} // creatures::e131
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+#include "Universe.h"
+
+// Send-on-change: after the data stops changing, repeat it this many times and
+// then only send a keep-alive every E131_DEFAULT_KEEP_ALIVE_MS (E1.31 6.6.1)
+#define E131_UNCHANGED_REPEATS 3
+#define E131_DEFAULT_KEEP_ALIVE_MS 800
+
+namespace creatures::e131 {
+
+    /**
+     * Which of one universe's frames send-on-change can hold back
+     *
+     * Playback, patterns and streaming rewrite the same bytes every tick, and
+     * every write bumps the universe's version. So the version only tells us
+     * when nothing can have changed; when it moves, the slots are compared
+     * with the last frame that went out.
+     */
+    class SendOnChange {
+
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        /**
+         * Look at this frame's slots
+         *
+         * @param version what Universe::copyStateTo() returned for them
+         * @return true if they're the same as last time and neither the
+         *         repeats nor the keep-alive need them to go out
+         */
+        bool canSkip(uint64_t version, std::span<const uint8_t, UNIVERSE_SLOT_COUNT> slots, Clock::time_point now,
+                     Clock::duration keepAlive) {
+            changed = !everSent;
+            if (changed || version != lastVersion) {
+                lastVersion = version;
+                if (changed || std::memcmp(lastSlots.data(), slots.data(), UNIVERSE_SLOT_COUNT) != 0) {
+                    std::memcpy(lastSlots.data(), slots.data(), UNIVERSE_SLOT_COUNT);
+                    changed = true;
+                }
+            }
+            return !changed && unchangedSends >= E131_UNCHANGED_REPEATS && now - lastSent < keepAlive;
+        }
+
+        // The frame canSkip() last looked at is going out
+        void sent(Clock::time_point now) {
+            unchangedSends = changed ? 0 : unchangedSends + 1;
+            everSent = true;
+            lastSent = now;
+        }
+
+    private:
+        bool everSent = false;
+        bool changed = true;
+        uint64_t lastVersion = 0;
+        uint32_t unchangedSends = 0;
+        Clock::time_point lastSent;
+        std::array<uint8_t, UNIVERSE_SLOT_COUNT> lastSlots = {};
+    };
+
+} // creatures::e131
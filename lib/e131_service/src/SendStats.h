@@ -0,0 +1,40 @@
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace creatures::e131 {
+
+    /**
+     * What the worker knows about sending one universe
+     *
+     * Send time runs from the start of a flush until the packet has been
+     * handed to the kernel, so when several universes go out in one batch
+     * they all share that batch's completion time.
+     */
+    struct UniverseSendStats {
+
+        // Bucket 0 is under 1us, bucket i is [2^(i-1), 2^i) us, and the last
+        // bucket catches everything from 2^(SEND_TIME_BUCKETS-2) us up
+        static constexpr size_t SEND_TIME_BUCKETS = 16;
+
+        uint16_t universe = 0;
+        uint64_t packetsSent = 0;
+
+        // Held back because nothing changed (send-on-change mode only)
+        uint64_t packetsSkipped = 0;
+
+        uint64_t sendErrors = 0;
+
+        std::array<uint64_t, SEND_TIME_BUCKETS> sendTimeHistogram = {};
+
+        void recordSendTime(uint64_t micros) {
+            const auto bucket = static_cast<size_t>(std::bit_width(micros));
+            ++sendTimeHistogram[bucket < SEND_TIME_BUCKETS ? bucket : SEND_TIME_BUCKETS - 1];
+        }
+    };
+
+} // creatures::e131
@@ -1,5 +1,10 @@
 
+
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <cstring>
+#include <thread>
 
 #include <fmt/format.h>
 #include <spdlog/spdlog.h>
@@ -13,13 +18,7 @@ Universe::Universe(std::shared_ptr<spdlog::logger> _logger)
     logger->debug("new Universe ✨");
 }
 
-void Universe::setFragment(uint16_t firstSlot, std::vector<uint8_t> &values) {
-
-    // Only one thread can touch this at a time
-    std::lock_guard<std::mutex> lock(valuesMutex);
-
-    // Get the number of elements in the vector
-    size_t N = values.size();
+bool Universe::inBounds(uint16_t firstSlot, size_t N) const {
 
     // Useful for debugging sometimes
     logger->trace("firstSlot + N = {}, UNIVERSE_SLOT_COUNT = {}, firstSlot = {}", (firstSlot + N), UNIVERSE_SLOT_COUNT,
@@ -27,29 +26,239 @@ void Universe::setFragment(uint16_t firstSlot, std::vector<uint8_t> &values) {
 
     // Ensure the firstSlot plus the size of values doesn't exceed UNIVERSE_SLOT_COUNT and firstSlot isn't zero
     // Also protect against integer overflow in the addition
-    if (firstSlot > 0 && firstSlot <= UNIVERSE_SLOT_COUNT && N <= UNIVERSE_SLOT_COUNT &&
-        (UNIVERSE_SLOT_COUNT - firstSlot) >= N) {
+    return firstSlot > 0 && firstSlot <= UNIVERSE_SLOT_COUNT && N <= UNIVERSE_SLOT_COUNT &&
+           static_cast<size_t>(UNIVERSE_SLOT_COUNT - firstSlot) >= N;
+}
 
-        // Copy the values into the state
-        std::copy(values.begin(), values.end(), state.begin() + firstSlot);
-        logger->debug("wrote {} bytes to slot {}", N, firstSlot);
+void Universe::setFragment(uint16_t firstSlot, std::span<const uint8_t> values) {
+    setFragment(DEFAULT_MERGE_SOURCE, firstSlot, values);
+}
 
-    } else {
+void Universe::setFragment(const MergeSource &source, uint16_t firstSlot, std::span<const uint8_t> values) {
+
+    // Get the number of elements in the vector
+    size_t N = values.size();
+
+    if (!inBounds(firstSlot, N)) {
 
         // Oh dear 𐂂
         logger->error("setFragment: Attempt to write beyond universe bounds.");
+        return;
+    }
+
+    if (source.id >= MAX_MERGE_SOURCES) {
+        logger->error("setFragment: unknown merge source {}", source.id);
+        return;
+    }
+
+    if (N == 0) {
+        return;
     }
+
+    // Only one writer at a time
+    const uint64_t sequence = claimSequence();
+
+    auto &layer = layerFor(source);
+    const uint64_t now = ++writeClock;
+    std::copy(values.begin(), values.end(), layer.values.begin() + firstSlot);
+    std::fill_n(layer.writtenAt.begin() + firstSlot, N, now);
+
+    if (layerCount == 1) {
+        // Nobody else here, so there's nothing to merge
+        patchWords(firstSlot, values.data(), N);
+    } else {
+        resolveAndPatch(firstSlot, N);
+    }
+
+    stateSequence.store(sequence + 2, std::memory_order_release);
 }
 
-std::array<uint8_t, UNIVERSE_SLOT_COUNT> Universe::getState() {
+void Universe::releaseSlots(const MergeSource &source, uint16_t firstSlot, uint16_t count) {
+
+    if (!inBounds(firstSlot, count)) {
+        logger->error("releaseSlots: Attempt to release beyond universe bounds.");
+        return;
+    }
+
+    if (source.id >= MAX_MERGE_SOURCES || !layers[source.id] || count == 0) {
+        return;
+    }
+
+    const uint64_t sequence = claimSequence();
+
+    std::fill_n(layers[source.id]->writtenAt.begin() + firstSlot, count, 0);
+    resolveAndPatch(firstSlot, count);
+
+    stateSequence.store(sequence + 2, std::memory_order_release);
+}
 
-    // Don't let other people touch the state while we're copying it
-    std::lock_guard<std::mutex> lock(valuesMutex);
-    auto stateCopy = state;
+void Universe::handOffSlots(const MergeSource &source, const MergeSource &hold, uint16_t firstSlot,
+                            uint16_t count) {
+
+    if (!inBounds(firstSlot, count)) {
+        logger->error("handOffSlots: Attempt to hand off beyond universe bounds.");
+        return;
+    }
+
+    if (hold.id >= MAX_MERGE_SOURCES) {
+        logger->error("handOffSlots: unknown merge source {}", hold.id);
+        return;
+    }
+
+    if (source.id >= MAX_MERGE_SOURCES || source.id == hold.id || !layers[source.id] || count == 0) {
+        return;
+    }
+
+    const uint64_t sequence = claimSequence();
+
+    auto &from = *layers[source.id];
+    auto &to = layerFor(hold);
+    for (size_t slot = firstSlot; slot < static_cast<size_t>(firstSlot) + count; ++slot) {
+        if (from.writtenAt[slot] != 0) {
+            to.values[slot] = from.values[slot];
+            to.writtenAt[slot] = from.writtenAt[slot];
+            from.writtenAt[slot] = 0;
+        }
+    }
+    resolveAndPatch(firstSlot, count);
+
+    stateSequence.store(sequence + 2, std::memory_order_release);
+}
+
+void Universe::setMergeMode(MergeMode mode) {
+    if (mergeMode.exchange(mode) == mode) {
+        return;
+    }
+
+    // Ties may come out differently now
+    const uint64_t sequence = claimSequence();
+    resolveAndPatch(1, UNIVERSE_SLOT_COUNT - 1);
+    stateSequence.store(sequence + 2, std::memory_order_release);
+}
+
+MergeMode Universe::getMergeMode() const { return mergeMode.load(); }
+
+void Universe::setOutputRate(uint32_t hz) {
+    outputRateHz.store(std::clamp<uint32_t>(hz, 1, UNIVERSE_MAX_OUTPUT_RATE_HZ));
+}
+
+uint32_t Universe::getOutputRate() const { return outputRateHz.load(std::memory_order_relaxed); }
+
+Universe::Layer &Universe::layerFor(const MergeSource &source) {
+    auto &layer = layers[source.id];
+    if (!layer) {
+        layer = std::make_unique<Layer>();
+        ++layerCount;
+        logger->debug("merge source {} (priority {}) joined the universe", source.id, source.priority);
+    }
+    layer->priority = source.priority;
+    return *layer;
+}
+
+uint8_t Universe::resolveSlot(size_t slot, MergeMode mode) const {
+    const Layer *winner = nullptr;
+    for (const auto &layer : layers) {
+        if (!layer || layer->writtenAt[slot] == 0) {
+            continue;
+        }
+
+        if (!winner || layer->priority > winner->priority) {
+            winner = layer.get();
+        } else if (layer->priority == winner->priority) {
+            const bool takesIt = mode == MergeMode::HighestTakesPrecedence
+                                     ? layer->values[slot] > winner->values[slot]
+                                     : layer->writtenAt[slot] > winner->writtenAt[slot];
+            if (takesIt) {
+                winner = layer.get();
+            }
+        }
+    }
+
+    // Nobody's driving it
+    return winner ? winner->values[slot] : 0;
+}
+
+void Universe::resolveAndPatch(size_t firstSlot, size_t count) {
+    const MergeMode mode = mergeMode.load(std::memory_order_relaxed);
+
+    std::array<uint8_t, UNIVERSE_SLOT_COUNT> merged; // NOLINT(*-member-init)
+    for (size_t slot = firstSlot; slot < firstSlot + count; ++slot) {
+        merged[slot] = resolveSlot(slot, mode);
+    }
+    patchWords(firstSlot, merged.data() + firstSlot, count);
+}
+
+void Universe::patchWords(size_t firstByte, const uint8_t *data, size_t count) {
+
+    // Patch each word the fragment touches. Going through memcpy keeps the
+    // byte order in memory the same as the slot order on every platform.
+    const size_t lastByte = firstByte + count; // one past the end
+    for (size_t word = firstByte / sizeof(uint64_t); word * sizeof(uint64_t) < lastByte; ++word) {
+        const size_t wordStart = word * sizeof(uint64_t);
+        const size_t from = std::max(firstByte, wordStart);
+        const size_t to = std::min(lastByte, wordStart + sizeof(uint64_t));
+
+        uint64_t bits = state[word].load(std::memory_order_relaxed);
+        auto *bytes = reinterpret_cast<uint8_t *>(&bits);
+        std::memcpy(bytes + (from - wordStart), data + (from - firstByte), to - from);
+        state[word].store(bits, std::memory_order_relaxed);
+    }
+}
+
+uint64_t Universe::claimSequence() const {
+    uint64_t sequence = stateSequence.load(std::memory_order_relaxed);
+    for (int attempt = 0;; ++attempt) {
+        if ((sequence & 1) == 0 &&
+            stateSequence.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire,
+                                                std::memory_order_relaxed)) {
+            // Keep the slot stores from being seen before the odd sequence
+            std::atomic_thread_fence(std::memory_order_release);
+            return sequence;
+        }
+        if (attempt >= SPINS_BEFORE_YIELD) {
+            std::this_thread::yield();
+        }
+        sequence = stateSequence.load(std::memory_order_relaxed);
+    }
+}
+
+void Universe::copyWords(uint8_t *out) const {
+    for (size_t word = 0; word < WORD_COUNT; ++word) {
+        const uint64_t bits = state[word].load(std::memory_order_relaxed);
+        std::memcpy(out + word * sizeof(uint64_t), &bits, sizeof(bits));
+    }
+}
+
+uint64_t Universe::copyStateTo(std::span<uint8_t, UNIVERSE_SLOT_COUNT> out) const {
+
+    for (int attempt = 0; attempt < MAX_OPTIMISTIC_READS; ++attempt) {
+        const uint64_t before = stateSequence.load(std::memory_order_acquire);
+        if ((before & 1) == 0) {
+            copyWords(out.data());
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (stateSequence.load(std::memory_order_relaxed) == before) {
+                return before;
+            }
+        }
+        if (attempt >= SPINS_BEFORE_YIELD) {
+            std::this_thread::yield();
+        }
+    }
+
+    // Kept losing to the writers. Make them wait for one copy; it's 64 loads.
+    // Nothing changed, so the sequence goes back to what it was.
+    const uint64_t sequence = claimSequence();
+    copyWords(out.data());
+    stateSequence.store(sequence, std::memory_order_release);
+    return sequence;
+}
 
+std::array<uint8_t, UNIVERSE_SLOT_COUNT> Universe::getState() const {
+    std::array<uint8_t, UNIVERSE_SLOT_COUNT> stateCopy{};
+    copyStateTo(stateCopy);
     return stateCopy;
 }
 
 uint8_t Universe::getNextSequenceNumber() { return this->sequenceNumber++; }
 
-} // namespace creatures::e131
\ No newline at end of file
+} // namespace creatures::e131
@@ -2,38 +2,137 @@
 #pragma once
 
 #include <array>
-#include <mutex>
-#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <span>
 
 #include <fmt/format.h>
 #include <spdlog/spdlog.h>
 
+#include "Merge.h"
+
 #define UNIVERSE_SLOT_COUNT 512
 
+// 50 Hz, what we've always sent at
+#define UNIVERSE_DEFAULT_OUTPUT_RATE_HZ 50
+#define UNIVERSE_MAX_OUTPUT_RATE_HZ 1000
+
 namespace creatures::e131 {
 
+    /**
+     * One DMX universe's worth of slot values
+     *
+     * The state is a seqlock: writers bump the sequence to odd, patch the
+     * words they touch, and bump it back to even. The sender reads the whole
+     * 512 bytes optimistically and simply retries if a write landed in the
+     * middle, so it never blocks the event loop and the event loop never
+     * waits on the sender.
+     *
+     * Writers claim the sequence with a compare-and-swap, so they're
+     * serialized among themselves without a mutex. In practice the event loop
+     * is the only writer and that never contends. If the sender keeps losing
+     * races it claims the sequence itself for one copy, then hands it back
+     * unchanged.
+     *
+     * Every source that writes here gets its own layer. The state the sender
+     * sees is the merge of those layers: for each slot the highest priority
+     * source driving it wins, and ties go to the universe's MergeMode. The
+     * merge happens on write, for just the slots being written, so the sender
+     * never does any of this work.
+     */
     class Universe {
 
     public:
         Universe(std::shared_ptr<spdlog::logger> logger);
         ~Universe() = default;
 
-        void setFragment(uint16_t firstSlot, std::vector<uint8_t>& values);
+        // From the default source
+        void setFragment(uint16_t firstSlot, std::span<const uint8_t> values);
+
+        void setFragment(const MergeSource &source, uint16_t firstSlot, std::span<const uint8_t> values);
+
+        /**
+         * Stop driving some slots. Whatever the next source down has there
+         * shows through, or zero if nobody else is driving them.
+         */
+        void releaseSlots(const MergeSource &source, uint16_t firstSlot, uint16_t count);
+
+        /**
+         * Stop driving some slots, but leave what this source last wrote in
+         * them on hold's layer. Anything above hold shows through as usual,
+         * and if nothing is there the slots stay put instead of going dark.
+         */
+        void handOffSlots(const MergeSource &source, const MergeSource &hold, uint16_t firstSlot, uint16_t count);
+
+        void setMergeMode(MergeMode mode);
+        MergeMode getMergeMode() const;
 
-        std::array<uint8_t, UNIVERSE_SLOT_COUNT> getState();
+        void setOutputRate(uint32_t hz);
+        uint32_t getOutputRate() const;
+
+        std::array<uint8_t, UNIVERSE_SLOT_COUNT> getState() const;
+
+        /**
+         * Copy a consistent snapshot of the universe into out
+         *
+         * @return the version of the snapshot; it changes whenever a write
+         *         lands, so callers can tell if anything is new since last time
+         */
+        uint64_t copyStateTo(std::span<uint8_t, UNIVERSE_SLOT_COUNT> out) const;
 
         uint8_t getNextSequenceNumber();
 
     private:
 
+        static constexpr size_t WORD_COUNT = UNIVERSE_SLOT_COUNT / sizeof(uint64_t);
+
+        // How many times the reader tries before claiming the sequence itself
+        static constexpr int MAX_OPTIMISTIC_READS = 64;
+
+        // Spin this many times waiting on a writer before yielding the CPU
+        static constexpr int SPINS_BEFORE_YIELD = 16;
+
+        // One source's view of the universe
+        struct Layer {
+            uint8_t priority = MERGE_PRIORITY_DEFAULT;
+            std::array<uint8_t, UNIVERSE_SLOT_COUNT> values = {};
+
+            // When each slot was last written; zero if this source isn't driving it
+            std::array<uint64_t, UNIVERSE_SLOT_COUNT> writtenAt = {};
+        };
+
+        bool inBounds(uint16_t firstSlot, size_t count) const;
+
+        // Wait for the sequence to be even and bump it to odd; returns the even value
+        uint64_t claimSequence() const;
+
+        // Everything below needs the sequence claimed
+
+        Layer &layerFor(const MergeSource &source);
+        uint8_t resolveSlot(size_t slot, MergeMode mode) const;
+        void resolveAndPatch(size_t firstSlot, size_t count);
+        void patchWords(size_t firstByte, const uint8_t *data, size_t count);
+
+        void copyWords(uint8_t *out) const;
+
         // Keep track of the sequence number we're currently on
         uint8_t sequenceNumber = 0;
 
-        // The state of the universe as we know it
-        std::array<uint8_t, 512> state = {};
+        // Even when stable, odd while a write is in progress
+        mutable std::atomic<uint64_t> stateSequence{0};
+
+        // The state of the universe as we know it, packed into words so the
+        // seqlock reads and writes are data-race free
+        std::array<std::atomic<uint64_t>, WORD_COUNT> state = {};
 
-        // Make sure only one thread touches the values at once
-        std::mutex valuesMutex;
+        // Merge state, only touched with the sequence claimed
+        std::array<std::unique_ptr<Layer>, MAX_MERGE_SOURCES> layers;
+        size_t layerCount = 0;
+        uint64_t writeClock = 0;
+
+        std::atomic<MergeMode> mergeMode{MergeMode::LatestTakesPrecedence};
+        std::atomic<uint32_t> outputRateHz{UNIVERSE_DEFAULT_OUTPUT_RATE_HZ};
 
         // 🪵
         std::shared_ptr<spdlog::logger> logger;
@@ -42,4 +141,3 @@ namespace creatures::e131 {
 
 } // creatures::e131
 
-
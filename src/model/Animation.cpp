@@ -1,7 +1,10 @@
 
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include <base64.hpp>
+
 #include "model/Animation.h"
 #include "model/AnimationMetadata.h"
 #include "model/Track.h"
@@ -34,16 +37,40 @@ std::shared_ptr<AnimationDto> convertToDto(const Animation &animation) {
     return animationDto.getPtr();
 }
 
-Animation convertFromDto(const std::shared_ptr<AnimationDto> &animationDto) {
+Result<Animation> convertFromDto(const std::shared_ptr<AnimationDto> &animationDto) {
     Animation animation;
     animation.id = animationDto->id;
     animation.metadata = convertFromDto(animationDto->metadata.getPtr());
 
     for (const auto &frameDto : *animationDto->tracks.getPtr()) {
-        animation.tracks.push_back(convertFromDto(frameDto.getPtr()));
+        auto track = convertFromDto(frameDto.getPtr());
+        if (!track.isSuccess()) {
+            return Result<Animation>{track.getError().value()};
+        }
+        animation.tracks.push_back(track.getValue().value());
     }
 
-    return animation;
+    return Result<Animation>{animation};
+}
+
+void storeTrackFrames(nlohmann::json &trackJson, const PackedFrames &frames) {
+    const auto bytes = frames.data();
+    trackJson["frames"] = {
+        {"$binary",
+         {{"base64", base64::to_base64(std::string_view(reinterpret_cast<const char *>(bytes.data()), bytes.size()))},
+          {"subType", "00"}}}};
+    trackJson["frame_width"] = frames.width();
+    trackJson["frame_count"] = frames.size();
+}
+
+void storeAnimationFrames(nlohmann::json &animationJson, const Animation &animation) {
+    if (!animationJson.contains("tracks") || !animationJson["tracks"].is_array()) {
+        return;
+    }
+    auto &tracks = animationJson["tracks"];
+    for (size_t i = 0; i < tracks.size() && i < animation.tracks.size(); ++i) {
+        storeTrackFrames(tracks[i], animation.tracks[i].frames);
+    }
 }
 
 nlohmann::json animationToJson(const Animation &animation) {
@@ -92,7 +119,7 @@ nlohmann::json animationToJson(const Animation &animation) {
         trackJson["id"] = track.id;
         trackJson["creature_id"] = track.creature_id;
         trackJson["animation_id"] = track.animation_id;
-        trackJson["frames"] = track.frames;
+        storeTrackFrames(trackJson, track.frames);
         tracks.push_back(trackJson);
     }
     j["tracks"] = tracks;
@@ -38,7 +38,27 @@ class AnimationDto : public oatpp::DTO {
 #include OATPP_CODEGEN_END(DTO)
 
 std::shared_ptr<AnimationDto> convertToDto(const Animation &creature);
-Animation convertFromDto(const std::shared_ptr<AnimationDto> &creatureDto);
+Result<Animation> convertFromDto(const std::shared_ptr<AnimationDto> &creatureDto);
+
+/**
+ * JSON for storing an animation in Mongo. Track frames are written as one
+ * BSON binary per track (as extended JSON, so JsonParser::jsonStringToBson
+ * makes real binary out of it) rather than a list of base64 strings.
+ * Database::trackFromJson reads either form.
+ */
 nlohmann::json animationToJson(const Animation &animation);
 
+/**
+ * Swap a track's "frames" for the packed storage form, with the
+ * "frame_width" and "frame_count" needed to unpack it
+ */
+void storeTrackFrames(nlohmann::json &trackJson, const PackedFrames &frames);
+
+/**
+ * Same, for every track in an animation's JSON. The tracks in the JSON must
+ * be in the same order as animation.tracks (they are if the animation was
+ * parsed from it).
+ */
+void storeAnimationFrames(nlohmann::json &animationJson, const Animation &animation);
+
 } // namespace creatures
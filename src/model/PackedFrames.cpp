@@ -0,0 +1,117 @@
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <base64.hpp>
+#include <fmt/format.h>
+
+#include "PackedFrames.h"
+#include "util/Base64.h"
+
+namespace creatures {
+
+Result<PackedFrames> PackedFrames::fromBase64Frames(const std::vector<std::string> &encodedFrames) {
+    if (encodedFrames.empty()) {
+        return Result<PackedFrames>{PackedFrames()};
+    }
+
+    // Every frame is the same width, so size the whole buffer from the first one
+    // and decode each frame straight into its slot
+    const auto width = util::base64DecodedSize(encodedFrames.front());
+    if (!width) {
+        return Result<PackedFrames>{ServerError(ServerError::InvalidData, "frame 0 isn't valid base64")};
+    }
+
+    std::vector<uint8_t> bytes(*width * encodedFrames.size());
+    for (std::size_t i = 0; i < encodedFrames.size(); ++i) {
+        const auto frameWidth = util::base64DecodedSize(encodedFrames[i]);
+        if (frameWidth && *frameWidth != *width) {
+            return Result<PackedFrames>{ServerError(
+                ServerError::InvalidData,
+                fmt::format("frame {} is {} bytes wide, but the frames before it are {}", i, *frameWidth, *width))};
+        }
+        if (!frameWidth ||
+            !util::base64DecodeInto(encodedFrames[i], std::span<uint8_t>(bytes).subspan(i * *width, *width))) {
+            return Result<PackedFrames>{
+                ServerError(ServerError::InvalidData, fmt::format("frame {} isn't valid base64", i))};
+        }
+    }
+
+    return fromBytes(static_cast<uint32_t>(*width), encodedFrames.size(), std::move(bytes));
+}
+
+Result<PackedFrames> PackedFrames::fromBytes(uint32_t frameWidth, std::size_t frameCount, std::vector<uint8_t> bytes) {
+    if (bytes.size() != static_cast<std::size_t>(frameWidth) * frameCount) {
+        return Result<PackedFrames>{ServerError(
+            ServerError::InvalidData, fmt::format("{} frames of {} bytes should be {} bytes, got {}", frameCount,
+                                                  frameWidth, static_cast<std::size_t>(frameWidth) * frameCount,
+                                                  bytes.size()))};
+    }
+
+    PackedFrames frames;
+    frames.frameWidth = frameWidth;
+    frames.frameCount = frameCount;
+    frames.bytes = std::make_shared<std::vector<uint8_t>>(std::move(bytes));
+    return Result<PackedFrames>{frames};
+}
+
+std::vector<std::string> PackedFrames::toBase64Frames() const {
+    std::vector<std::string> encoded;
+    encoded.reserve(frameCount);
+    for (std::size_t i = 0; i < frameCount; ++i) {
+        const auto frame = (*this)[i];
+        encoded.push_back(
+            base64::to_base64(std::string_view(reinterpret_cast<const char *>(frame.data()), frame.size())));
+    }
+    return encoded;
+}
+
+void PackedFrames::reserve(std::size_t frames) {
+    if (frameCount == 0) {
+        // Don't know how wide they are yet; the first push_back() reserves
+        reservedFrames = frames;
+        return;
+    }
+    ownBytes().reserve(frames * frameWidth);
+}
+
+void PackedFrames::push_back(std::span<const uint8_t> frame) {
+    if (frameCount == 0) {
+        frameWidth = static_cast<uint32_t>(frame.size());
+        ownBytes().reserve(std::max<std::size_t>(reservedFrames, 1) * frameWidth);
+    } else if (frame.size() != frameWidth) {
+        throw std::invalid_argument(
+            fmt::format("can't add a {} byte frame to frames that are {} bytes wide", frame.size(), frameWidth));
+    }
+
+    auto &owned = ownBytes();
+    owned.insert(owned.end(), frame.begin(), frame.end());
+    ++frameCount;
+}
+
+std::span<uint8_t> PackedFrames::mutableFrame(std::size_t index) {
+    return {ownBytes().data() + index * frameWidth, frameWidth};
+}
+
+bool PackedFrames::operator==(const PackedFrames &other) const {
+    if (frameWidth != other.frameWidth || frameCount != other.frameCount) {
+        return false;
+    }
+    const auto mine = data();
+    const auto theirs = other.data();
+    return std::equal(mine.begin(), mine.end(), theirs.begin(), theirs.end());
+}
+
+std::vector<uint8_t> &PackedFrames::ownBytes() {
+    if (!bytes) {
+        bytes = std::make_shared<std::vector<uint8_t>>();
+    } else if (bytes.use_count() > 1) {
+        bytes = std::make_shared<std::vector<uint8_t>>(*bytes);
+    }
+    return *bytes;
+}
+
+} // namespace creatures
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "util/Result.h"
+
+namespace creatures {
+
+/**
+ * All of a track's DMX frames, packed back to back in one buffer
+ *
+ * Every frame in a track is the same width (it's one creature's or fixture's
+ * channels), so there's no need for a vector per frame or a base64 string
+ * per frame. Frame `i` lives at `bytes[i * width, (i + 1) * width)`.
+ *
+ * The bytes are shared between copies, so copying a Track (or handing its
+ * frames to a PlaybackSession) doesn't copy the frame data. Anything that
+ * changes the frames gets its own copy first.
+ *
+ * Base64 only shows up at the edges: the JSON API still speaks a list of
+ * base64 strings, one per frame, and Mongo stores the whole buffer as one
+ * BSON binary.
+ */
+class PackedFrames {
+
+  public:
+    // Walks the frames in order, handing out a span for each one
+    class const_iterator {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::span<const uint8_t>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = value_type;
+
+        const_iterator() = default;
+        const_iterator(const PackedFrames *_frames, std::size_t _index) : frames(_frames), index(_index) {}
+
+        value_type operator*() const { return (*frames)[index]; }
+        const_iterator &operator++() {
+            ++index;
+            return *this;
+        }
+        const_iterator operator++(int) {
+            auto previous = *this;
+            ++index;
+            return previous;
+        }
+        bool operator==(const const_iterator &other) const = default;
+
+      private:
+        const PackedFrames *frames = nullptr;
+        std::size_t index = 0;
+    };
+
+    PackedFrames() = default;
+
+    /**
+     * Decode a list of base64 frames, like the API sends
+     *
+     * @return InvalidData if a frame isn't valid base64 or the frames aren't
+     *         all the same width
+     */
+    static Result<PackedFrames> fromBase64Frames(const std::vector<std::string> &encodedFrames);
+
+    /**
+     * Wrap an already packed buffer, like the one Mongo stores
+     *
+     * @return InvalidData if bytes isn't exactly frameWidth * frameCount long
+     */
+    static Result<PackedFrames> fromBytes(uint32_t frameWidth, std::size_t frameCount, std::vector<uint8_t> bytes);
+
+    /** @return one base64 string per frame, for the JSON API */
+    std::vector<std::string> toBase64Frames() const;
+
+    /** @return the number of frames */
+    [[nodiscard]] std::size_t size() const { return frameCount; }
+
+    [[nodiscard]] bool empty() const { return frameCount == 0; }
+
+    /** @return the width of every frame, in bytes */
+    [[nodiscard]] uint32_t width() const { return frameWidth; }
+
+    /** @return frame `index`; no bounds checking, just like a vector */
+    std::span<const uint8_t> operator[](std::size_t index) const {
+        return {bytes->data() + index * frameWidth, frameWidth};
+    }
+
+    const_iterator begin() const { return {this, 0}; }
+    const_iterator end() const { return {this, frameCount}; }
+
+    std::span<const uint8_t> front() const { return (*this)[0]; }
+    std::span<const uint8_t> back() const { return (*this)[frameCount - 1]; }
+
+    /** @return every frame, back to back */
+    std::span<const uint8_t> data() const {
+        return bytes ? std::span<const uint8_t>(*bytes) : std::span<const uint8_t>();
+    }
+
+    void reserve(std::size_t frames);
+
+    /**
+     * Add a frame to the end. The first frame sets the width.
+     *
+     * @throws std::invalid_argument if the frame is a different width than the others
+     */
+    void push_back(std::span<const uint8_t> frame);
+
+    /** @return a writable view of frame `index` (copies the buffer if it's shared) */
+    std::span<uint8_t> mutableFrame(std::size_t index);
+
+    bool operator==(const PackedFrames &other) const;
+
+  private:
+    // Make sure we're the only one holding the bytes before changing them
+    std::vector<uint8_t> &ownBytes();
+
+    uint32_t frameWidth = 0;
+    std::size_t frameCount = 0;
+    std::size_t reservedFrames = 0;
+    std::shared_ptr<std::vector<uint8_t>> bytes;
+};
+
+} // namespace creatures
@@ -1,8 +1,10 @@
 
 
 #include <string>
+#include <utility>
 #include <vector>
 
+#include <fmt/format.h>
 #include <oatpp/core/Types.hpp>
 
 #include "Track.h"
@@ -10,22 +12,29 @@
 namespace creatures {
 
 // Convert TrackDto to Track
-Track convertFromDto(const std::shared_ptr<TrackDto> &trackDto) {
+Result<Track> convertFromDto(const std::shared_ptr<TrackDto> &trackDto) {
     Track track;
     track.id = trackDto->id;
     track.creature_id = trackDto->creature_id ? std::string(trackDto->creature_id) : "";
     track.fixture_id = trackDto->fixture_id ? std::string(trackDto->fixture_id) : "";
     track.animation_id = trackDto->animation_id;
 
-    // Ensure the list is initialized before iterating
-    track.frames = std::vector<std::string>();
     if (trackDto->frames) { // Check if the list is not null
+        std::vector<std::string> encoded;
+        encoded.reserve(trackDto->frames->size());
         for (const auto &frame : *trackDto->frames) {
-            track.frames.push_back(std::string(frame));
+            encoded.push_back(frame ? std::string(frame) : std::string());
         }
+        auto decoded = PackedFrames::fromBase64Frames(encoded);
+        if (!decoded.isSuccess()) {
+            return Result<Track>{ServerError(ServerError::InvalidData,
+                                             fmt::format("Track {} has bad frames: {}", track.id,
+                                                         decoded.getError()->getMessage()))};
+        }
+        track.frames = decoded.getValue().value();
     }
 
-    return track;
+    return Result<Track>{track};
 }
 
 // Convert Track to TrackDto
@@ -41,8 +50,8 @@ oatpp::Object<TrackDto> convertToDto(const Track &track) {
     trackDto->animation_id = track.animation_id;
 
     trackDto->frames = oatpp::List<oatpp::String>::createShared();
-    for (const auto &frame : track.frames) {
-        trackDto->frames->emplace_back(frame);
+    for (auto &frame : track.frames.toBase64Frames()) {
+        trackDto->frames->emplace_back(std::move(frame));
     }
 
     return trackDto;
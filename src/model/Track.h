@@ -7,6 +7,9 @@
 #include <oatpp/core/Types.hpp>
 #include <oatpp/core/macro/codegen.hpp>
 
+#include "model/PackedFrames.h"
+#include "util/Result.h"
+
 namespace creatures {
 
 struct Track {
@@ -14,7 +17,7 @@ struct Track {
     std::string creature_id; // Set for creature tracks; empty for fixture tracks
     std::string fixture_id;  // Set for fixture tracks; empty for creature tracks
     std::string animation_id;
-    std::vector<std::string> frames; // The frame data will be base64 encoded strings
+    PackedFrames frames; // Raw DMX frames, base64 only at the JSON API edge
 };
 
 #include OATPP_CODEGEN_BEGIN(DTO)
@@ -56,6 +59,10 @@ class TrackDto : public oatpp::DTO {
 #include OATPP_CODEGEN_END(DTO)
 
 oatpp::Object<TrackDto> convertToDto(const Track &track);
-Track convertFromDto(const std::shared_ptr<TrackDto> &trackDto);
+
+/**
+ * @return the track, or an InvalidData error if any of its frames don't decode
+ */
+Result<Track> convertFromDto(const std::shared_ptr<TrackDto> &trackDto);
 
 } // namespace creatures
\ No newline at end of file
@@ -0,0 +1,109 @@
+
+#include "AnimationCache.h"
+
+#include <utility>
+
+namespace creatures {
+
+AnimationCache::AnimationCache(std::size_t _maxBytes) : maxBytes(_maxBytes) {}
+
+std::shared_ptr<const Animation> AnimationCache::get(const animationId_t &animationId) {
+    std::lock_guard lock(mutex);
+
+    auto it = entries.find(animationId);
+    if (it == entries.end()) {
+        missCount.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    lru.splice(lru.begin(), lru, it->second.lruPosition);
+    hitCount.fetch_add(1, std::memory_order_relaxed);
+    return it->second.animation;
+}
+
+bool AnimationCache::put(std::shared_ptr<const Animation> animation, uint64_t loadedAtGeneration) {
+    if (!animation) {
+        return false;
+    }
+
+    const auto size = footprint(*animation);
+    if (size > maxBytes) {
+        debug("not caching animation {}; it's {} bytes and the cache only holds {}", animation->id, size, maxBytes);
+        return false;
+    }
+
+    std::lock_guard lock(mutex);
+
+    // Something changed while this was loading, so it might already be stale
+    if (currentGeneration.load(std::memory_order_acquire) != loadedAtGeneration) {
+        debug("not caching animation {}; the cache was invalidated while it loaded", animation->id);
+        return false;
+    }
+
+    const auto animationId = animation->id;
+    if (auto it = entries.find(animationId); it != entries.end()) {
+        totalBytes -= it->second.bytes;
+        lru.erase(it->second.lruPosition);
+        entries.erase(it);
+    }
+
+    lru.push_front(animationId);
+    entries.emplace(animationId, Entry{std::move(animation), size, lru.begin()});
+    totalBytes += size;
+
+    evictLocked();
+    return true;
+}
+
+void AnimationCache::invalidate(const animationId_t &animationId) {
+    std::lock_guard lock(mutex);
+    currentGeneration.fetch_add(1, std::memory_order_acq_rel);
+
+    if (auto it = entries.find(animationId); it != entries.end()) {
+        totalBytes -= it->second.bytes;
+        lru.erase(it->second.lruPosition);
+        entries.erase(it);
+        debug("dropped animation {} from the animation cache", animationId);
+    }
+}
+
+void AnimationCache::invalidateAll() {
+    std::lock_guard lock(mutex);
+    currentGeneration.fetch_add(1, std::memory_order_acq_rel);
+
+    debug("dropping all {} animations from the animation cache", entries.size());
+    entries.clear();
+    lru.clear();
+    totalBytes = 0;
+}
+
+std::size_t AnimationCache::footprint(const Animation &animation) {
+    std::size_t size = sizeof(Animation);
+    for (const auto &track : animation.tracks) {
+        size += sizeof(Track) + track.frames.data().size();
+    }
+    return size;
+}
+
+std::size_t AnimationCache::size() const {
+    std::lock_guard lock(mutex);
+    return entries.size();
+}
+
+std::size_t AnimationCache::bytes() const {
+    std::lock_guard lock(mutex);
+    return totalBytes;
+}
+
+void AnimationCache::evictLocked() {
+    while (totalBytes > maxBytes && !lru.empty()) {
+        const auto &oldest = lru.back();
+        auto it = entries.find(oldest);
+        totalBytes -= it->second.bytes;
+        debug("evicting animation {} from the animation cache", oldest);
+        entries.erase(it);
+        lru.pop_back();
+    }
+}
+
+} // namespace creatures
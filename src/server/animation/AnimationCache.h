@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "model/Animation.h"
+#include "server/namespace-stuffs.h"
+
+namespace creatures {
+
+/**
+ * Decoded animations, kept around so playing one again doesn't go back to Mongo
+ *
+ * Playlists, idle loops, and the play endpoint load the same few animations
+ * over and over. Every entry is an immutable `Animation` whose frames are
+ * already packed, so a hit costs a shared_ptr copy: no DB round trip, no
+ * base64 decode. Sessions that are still playing an entry keep it alive after
+ * it's evicted or invalidated.
+ *
+ * The cache is bounded by the frame bytes it holds and evicts the least
+ * recently used animation first. Anything that changes an animation calls
+ * invalidate() (the storage publishers do this alongside the
+ * CacheType::Animation broadcast).
+ *
+ * Every invalidation bumps a generation counter. A loader grabs generation()
+ * before going to the DB and hands it back to put(), which throws the result
+ * away if anything was invalidated in the meantime. That way a slow load
+ * can't put a stale copy back after an edit.
+ */
+class AnimationCache {
+
+  public:
+    /**
+     * @param maxBytes how many bytes of animation to keep (0 turns the cache off)
+     */
+    explicit AnimationCache(std::size_t maxBytes);
+
+    /** @return the cached animation, or nullptr if it's not here */
+    std::shared_ptr<const Animation> get(const animationId_t &animationId);
+
+    /** @return the generation to pass to put() for a load that's about to start */
+    [[nodiscard]] uint64_t generation() const { return currentGeneration.load(std::memory_order_acquire); }
+
+    /**
+     * Remember an animation that was just loaded
+     *
+     * @param animation the animation, keyed by its id
+     * @param loadedAtGeneration what generation() was before it was loaded
+     * @return false if it wasn't kept (invalidated since, or bigger than the whole cache)
+     */
+    bool put(std::shared_ptr<const Animation> animation, uint64_t loadedAtGeneration);
+
+    /** Forget one animation */
+    void invalidate(const animationId_t &animationId);
+
+    /** Forget everything */
+    void invalidateAll();
+
+    /** @return roughly how many bytes an animation takes up in the cache */
+    static std::size_t footprint(const Animation &animation);
+
+    [[nodiscard]] std::size_t size() const;
+    [[nodiscard]] std::size_t bytes() const;
+    [[nodiscard]] uint64_t hits() const { return hitCount.load(std::memory_order_relaxed); }
+    [[nodiscard]] uint64_t misses() const { return missCount.load(std::memory_order_relaxed); }
+
+  private:
+    struct Entry {
+        std::shared_ptr<const Animation> animation;
+        std::size_t bytes = 0;
+        std::list<animationId_t>::iterator lruPosition;
+    };
+
+    // Drop the least recently used animations until we're under maxBytes. Call with the lock held.
+    void evictLocked();
+
+    const std::size_t maxBytes;
+
+    mutable std::mutex mutex;
+    std::unordered_map<animationId_t, Entry> entries;
+    std::list<animationId_t> lru; // most recently used at the front
+    std::size_t totalBytes = 0;
+
+    std::atomic<uint64_t> currentGeneration{0};
+    std::atomic<uint64_t> hitCount{0};
+    std::atomic<uint64_t> missCount{0};
+};
+
+} // namespace creatures
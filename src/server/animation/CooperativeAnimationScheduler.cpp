@@ -5,6 +5,7 @@
 
 #include "CooperativeAnimationScheduler.h"
 
+#include <algorithm>
 #include <chrono>
 #include <filesystem>
 #include <memory>
@@ -20,6 +21,7 @@
 #include "server/audio/AudioTransport.h"
 #include "server/audio/LocalNativeAudioTransport.h"
 #include "server/audio/RtpAudioTransport.h"
+#include "server/audio/RtpMixAudioTransport.h"
 #include "server/config/Configuration.h"
 #include "server/creature-server.h"
 #include "server/eventloop/eventloop.h"
@@ -29,6 +31,7 @@
 #include "server/rtp/AudioLoadExecutor.h"
 #include "server/rtp/AudioStreamBuffer.h"
 #include "server/rtp/MultiOpusRtpServer.h"
+#include "server/rtp/RtpMixer.h"
 #include "server/runtime/Activity.h"
 #include "server/storage/Storage.h"
 #include "server/ws/service/CreatureService.h"
@@ -44,6 +47,7 @@ extern std::shared_ptr<SystemCounters> metrics;
 extern std::shared_ptr<ObservabilityManager> observability;
 extern std::shared_ptr<rtp::AudioLoadExecutor> rtpAudioLoadExecutor;
 extern std::shared_ptr<rtp::MultiOpusRtpServer> rtpServer;
+extern std::shared_ptr<rtp::RtpMixer> rtpMixer;
 extern std::shared_ptr<SessionManager> sessionManager;
 
 namespace {
@@ -498,6 +502,7 @@ Result<void> CooperativeAnimationScheduler::scheduleWithAsyncAudioLoad(
     auto capturedConfig = config;
     auto capturedObservability = observability;
     auto capturedRtpServer = rtpServer;
+    auto capturedRtpMixer = rtpMixer;
 
     // The schedule span ends when scheduleAnimation returns, so the worker gets its own
     // root span carrying trigger.trace_id/span_id attributes for Honeycomb linkage —
@@ -541,7 +546,7 @@ Result<void> CooperativeAnimationScheduler::scheduleWithAsyncAudioLoad(
         cancellationSpan->setSuccess();
     };
     job.run = [session, universe, capturedEventLoop, capturedConfig, capturedObservability, capturedRtpServer,
-               triggerTraceId, triggerSpanId, queuedAt, loadContext, weakExecutor]() {
+               capturedRtpMixer, triggerTraceId, triggerSpanId, queuedAt, loadContext, weakExecutor]() {
         loadContext->stage = "span_setup";
         loadContext->span =
             capturedObservability
@@ -562,8 +567,11 @@ Result<void> CooperativeAnimationScheduler::scheduleWithAsyncAudioLoad(
             }
         }
 
-        loadContext->stage = "load_audio_buffer";
-        auto loadResult = loadAudioBuffer(session->getAnimation(), session, loadSpan);
+        // With the mixer on, the sound is mixed in rather than encoded up front
+        auto mixTransport = std::dynamic_pointer_cast<RtpMixAudioTransport>(session->getAudioTransport());
+        loadContext->stage = mixTransport ? "load_mix_source" : "load_audio_buffer";
+        auto loadResult = mixTransport ? loadMixSource(session->getAnimation(), mixTransport, loadSpan)
+                                       : loadAudioBuffer(session->getAnimation(), session, loadSpan);
 
         if (!loadResult.isSuccess()) {
             const auto loadError = loadResult.getError().value();
@@ -575,6 +583,9 @@ Result<void> CooperativeAnimationScheduler::scheduleWithAsyncAudioLoad(
             // broadcast our (cancelled, stopped) and scheduled an immediate teardown;
             // just don't start anything.
             debug("Async audio load finished for cancelled session {}; skipping start", session->getSessionId());
+            if (mixTransport) {
+                mixTransport->getSource()->cancel();
+            }
             if (loadSpan) {
                 loadSpan->setAttribute("session.cancelled_during_load", true);
                 loadSpan->setAttribute("audio.loader.outcome", "cancelled");
@@ -597,6 +608,75 @@ Result<void> CooperativeAnimationScheduler::scheduleWithAsyncAudioLoad(
                                    "Async audio load finished after the event loop became unavailable");
         }
 
+        // Leave a complete 40ms priming window before playback. The reset event
+        // schedules one silent RTP frame every 10ms rather than blocking the
+        // event loop to send them all at once.
+        const auto nextStartFrame = [&capturedEventLoop, &capturedConfig]() {
+            framenum_t startFrame = capturedEventLoop->getNextFrameNumber() + 2 + RTP_PRIMING_DURATION_FRAMES;
+            const uint32_t delayMs = capturedConfig ? capturedConfig->getAnimationDelayMs() : 0;
+            if (delayMs > 0) {
+                startFrame += static_cast<framenum_t>(delayMs / EVENT_LOOP_PERIOD_MS);
+                debug("Applying animation delay of {}ms to async start", delayMs);
+            }
+            return startFrame;
+        };
+
+        rtp::AsyncAudioTraceContext traceContext;
+        traceContext.triggerTraceId = triggerTraceId;
+        traceContext.triggerSpanId = triggerSpanId;
+        traceContext.sessionId = session->getSessionId();
+        traceContext.animationId = session->getAnimation().id;
+        traceContext.soundFile = session->getAnimation().metadata.sound_file;
+
+        if (mixTransport) {
+            loadContext->stage = "rtp_mixer_validation";
+            if (!capturedRtpServer || !capturedRtpServer->isReady() || !capturedRtpMixer) {
+                throw AudioLoadFailure(ServerError::InternalError, loadContext->stage,
+                                       "Async audio load finished without an available RTP server and mixer");
+            }
+
+            loadContext->stage = "playback_schedule";
+            if (activeExecutor->isStopping()) {
+                throw AudioLoadFailure(ServerError::InternalError, loadContext->stage,
+                                       "RTP audio loader stopped before event scheduling");
+            }
+
+            const framenum_t startFrame = nextStartFrame();
+            session->setStartingFrame(startFrame);
+
+            // The mix doesn't change hands, so there's no lease to take and no
+            // reset of our own. The track event goes early enough for its reset
+            // (two frames out) and priming to land before startFrame in case it
+            // has to start the mix; if the mix is already going it waits for
+            // startFrame. Either way the sound lines up with the DMX to within a
+            // 10ms frame.
+            const framenum_t trackFrame = std::max(startFrame - RTP_PRIMING_DURATION_FRAMES - 3,
+                                                   capturedEventLoop->getNextFrameNumber());
+            rtp::RtpMixTrackOptions options;
+            options.role = rtp::RtpMixRole::Dialog;
+            options.name = session->getAnimation().metadata.sound_file;
+            capturedEventLoop->scheduleEvent(std::make_shared<RtpMixerTrackEvent>(
+                trackFrame, mixTransport->getSource(), std::move(options), traceContext, startFrame));
+
+            auto initialRunner = std::make_shared<PlaybackRunnerEvent>(startFrame, session);
+            capturedEventLoop->scheduleEvent(initialRunner);
+
+            try {
+                info("✅ Async audio ready; animation '{}' mixes in at frame {} (session {})",
+                     session->getAnimation().metadata.title, startFrame, session->getSessionId());
+                if (loadSpan) {
+                    loadSpan->setAttribute("session.starting_frame", static_cast<int64_t>(startFrame));
+                    loadSpan->setAttribute("rtp.mixer", true);
+                    loadSpan->setAttribute("audio.loader.outcome", "completed");
+                    loadSpan->setAttribute("audio.loader.stage", loadContext->stage);
+                    loadSpan->setSuccess();
+                }
+            } catch (...) {
+                error("Could not record successful async audio publication for session {}", session->getSessionId());
+            }
+            return;
+        }
+
         loadContext->stage = "rtp_transport_validation";
         auto rtpTransport = std::dynamic_pointer_cast<RtpAudioTransport>(session->getAudioTransport());
         if (!capturedRtpServer || !capturedRtpServer->isReady() || !rtpTransport) {
@@ -609,12 +689,6 @@ Result<void> CooperativeAnimationScheduler::scheduleWithAsyncAudioLoad(
         // send without ever delaying the 1ms event loop.
         loadContext->stage = "rtp_output_acquire";
         auto outputLease = capturedRtpServer->acquireOutput("session:" + session->getSessionId());
-        rtp::AsyncAudioTraceContext traceContext;
-        traceContext.triggerTraceId = triggerTraceId;
-        traceContext.triggerSpanId = triggerSpanId;
-        traceContext.sessionId = session->getSessionId();
-        traceContext.animationId = session->getAnimation().id;
-        traceContext.soundFile = session->getAnimation().metadata.sound_file;
         loadContext->stage = "rtp_output_lease";
         rtpTransport->setOutputLease(outputLease, traceContext);
         if (loadSpan) {
@@ -640,15 +714,7 @@ Result<void> CooperativeAnimationScheduler::scheduleWithAsyncAudioLoad(
                                    "RTP audio loader stopped before event scheduling");
         }
 
-        // Leave a complete 40ms priming window before playback. The reset event
-        // schedules one silent RTP frame every 10ms rather than blocking the
-        // event loop to send them all at once.
-        framenum_t startFrame = capturedEventLoop->getNextFrameNumber() + 2 + RTP_PRIMING_DURATION_FRAMES;
-        const uint32_t delayMs = capturedConfig ? capturedConfig->getAnimationDelayMs() : 0;
-        if (delayMs > 0) {
-            startFrame += static_cast<framenum_t>(delayMs / EVENT_LOOP_PERIOD_MS);
-            debug("Applying animation delay of {}ms to async start", delayMs);
-        }
+        const framenum_t startFrame = nextStartFrame();
         session->setStartingFrame(startFrame);
 
         // Rotate SSRC values and begin decoder priming immediately before the
@@ -802,8 +868,9 @@ Result<void> CooperativeAnimationScheduler::loadAudioBuffer(const Animation &ani
 
     debug("Loading audio buffer from: {}", soundFilePath.string());
 
-    // Load and encode audio buffer (heavy I/O operation)
-    auto audioBuffer = rtp::AudioStreamBuffer::loadFromWavFile(soundFilePath.string(), loadSpan);
+    // Load the audio buffer (heavy I/O operation). On a cache miss this returns once
+    // the start is encoded, and RtpAudioTransport keeps behind the encoder from there.
+    auto audioBuffer = rtp::AudioStreamBuffer::streamFromWavFile(soundFilePath.string(), loadSpan);
     if (!audioBuffer) {
         std::string errorMsg = fmt::format("Failed to load audio buffer from '{}'", soundFilePath.string());
         error(errorMsg);
@@ -825,6 +892,36 @@ Result<void> CooperativeAnimationScheduler::loadAudioBuffer(const Animation &ani
     return Result<void>{};
 }
 
+Result<void> CooperativeAnimationScheduler::loadMixSource(const Animation &animation,
+                                                          std::shared_ptr<RtpMixAudioTransport> transport,
+                                                          std::shared_ptr<OperationSpan> parentSpan) {
+    auto loadSpan = observability ? observability->createChildOperationSpan("load_mix_source", parentSpan) : nullptr;
+    if (loadSpan) {
+        loadSpan->setAttribute("sound_file", animation.metadata.sound_file);
+    }
+
+    std::filesystem::path soundFilePath = creatures::storage::resolveSoundPath(animation.metadata.sound_file);
+    debug("Opening {} for the RTP mixer", soundFilePath.string());
+
+    // Only opens the file; its feeder thread reads ahead of the mix from here
+    auto opened = rtp::openWavMixSource(soundFilePath.string());
+    if (!opened.isSuccess()) {
+        const auto openError = opened.getError().value();
+        error("Unable to mix in '{}': {}", soundFilePath.string(), openError.getMessage());
+        if (loadSpan) {
+            loadSpan->setError(openError.getMessage());
+        }
+        return Result<void>{openError};
+    }
+
+    transport->setSource(opened.getValue().value());
+
+    if (loadSpan) {
+        loadSpan->setSuccess();
+    }
+    return Result<void>{};
+}
+
 std::shared_ptr<AudioTransport>
 CooperativeAnimationScheduler::createAudioTransport(std::shared_ptr<PlaybackSession> /* session */) {
     if (!config) {
@@ -835,6 +932,11 @@ CooperativeAnimationScheduler::createAudioTransport(std::shared_ptr<PlaybackSess
     // Check audio mode configuration
     auto audioMode = config->getAudioMode();
 
+    if (audioMode == Configuration::AudioMode::RTP && config->getRtpMixer() && rtpMixer) {
+        debug("Creating RTP mixer audio transport");
+        return std::make_shared<RtpMixAudioTransport>();
+    }
+
     if (audioMode == Configuration::AudioMode::RTP) {
         debug("Creating RTP audio transport");
         return std::make_shared<RtpAudioTransport>(rtpServer);
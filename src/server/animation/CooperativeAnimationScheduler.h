@@ -34,7 +34,7 @@ class CooperativeAnimationScheduler {
      *    and audio load (issues #62/#63)
      * 3. Broadcasts the (reason, running) activity state
      * 4. Loads and decodes audio buffer if present
-     * 5. Creates the appropriate RTP or native-local AudioTransport
+     * 5. Creates the appropriate RTP, RTP mixer or native-local AudioTransport
      * 6. Sets up lifecycle callbacks (status lights, metrics)
      * 7. Schedules initial PlaybackRunnerEvent
      *
@@ -75,11 +75,22 @@ class CooperativeAnimationScheduler {
     static Result<void> loadAudioBuffer(const Animation &animation, std::shared_ptr<PlaybackSession> session,
                                         std::shared_ptr<class OperationSpan> parentSpan);
 
+    /**
+     * Open the animation's sound as a source for the RTP mixer
+     *
+     * @param animation The animation with sound file metadata
+     * @param transport The mixer transport to hand the source to
+     * @param parentSpan Observability span for tracing
+     * @return Success or error
+     */
+    static Result<void> loadMixSource(const Animation &animation, std::shared_ptr<class RtpMixAudioTransport> transport,
+                                      std::shared_ptr<class OperationSpan> parentSpan);
+
     /**
      * Create appropriate audio transport for the configuration
      *
      * @param session The playback session
-     * @return RTP or native-local AudioTransport instance
+     * @return RTP, RTP mixer or native-local AudioTransport instance
      */
     static std::shared_ptr<class AudioTransport> createAudioTransport(std::shared_ptr<PlaybackSession> session);
 
@@ -94,6 +105,8 @@ class CooperativeAnimationScheduler {
     /**
      * Submit the RTP audio buffer load to the fixed, bounded executor, then schedule
      * the encoder reset and initial PlaybackRunnerEvent from its worker (issues #70/#95).
+     * With the RTP mixer on, the worker opens the sound as a mix source instead and
+     * schedules its dialog track in place of the reset.
      * The session must already be adopted, broadcast as running, and have its callbacks
      * set. Admission failure is synchronous and fully unwinds the adopted session.
      *
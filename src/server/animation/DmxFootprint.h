@@ -0,0 +1,80 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+#include "server/namespace-stuffs.h"
+
+namespace creatures {
+
+/**
+ * Some channels a playback has written to
+ */
+struct DmxFootprint {
+    universe_t universe{0};
+    uint32_t channelOffset{0};
+    uint16_t count{0};
+
+    bool operator==(const DmxFootprint &) const = default;
+};
+
+/**
+ * Everywhere a playback has written DMX, so it can hand those channels off when it ends
+ *
+ * Each track keeps its own footprint, so noting a frame is one comparison. A track only
+ * gets a second footprint if its creature or fixture is moved to other channels while
+ * it's playing.
+ *
+ * Only the event loop touches these, so there's no lock.
+ */
+class DmxFootprints {
+  public:
+    void note(size_t track, universe_t universe, uint32_t channelOffset, size_t count) {
+        const auto channels = static_cast<uint16_t>(std::min<size_t>(count, UINT16_MAX));
+        if (track >= byTrack_.size()) {
+            byTrack_.resize(track + 1);
+        }
+        auto &footprint = byTrack_[track];
+        if (footprint && footprint->universe == universe && footprint->channelOffset == channelOffset) {
+            footprint->count = std::max(footprint->count, channels);
+            return;
+        }
+        if (footprint) {
+            moved_.push_back(*footprint);
+        }
+        footprint = DmxFootprint{universe, channelOffset, channels};
+    }
+
+    /** Every footprint, once each (tracks that wrote to the same channels are merged) */
+    [[nodiscard]] std::vector<DmxFootprint> all() const {
+        std::vector<DmxFootprint> footprints = moved_;
+        for (const auto &footprint : byTrack_) {
+            if (footprint) {
+                footprints.push_back(*footprint);
+            }
+        }
+        std::sort(footprints.begin(), footprints.end(), [](const DmxFootprint &a, const DmxFootprint &b) {
+            return std::tie(a.universe, a.channelOffset) < std::tie(b.universe, b.channelOffset);
+        });
+
+        std::vector<DmxFootprint> merged;
+        for (const auto &footprint : footprints) {
+            if (!merged.empty() && merged.back().universe == footprint.universe &&
+                merged.back().channelOffset == footprint.channelOffset) {
+                merged.back().count = std::max(merged.back().count, footprint.count);
+            } else {
+                merged.push_back(footprint);
+            }
+        }
+        return merged;
+    }
+
+  private:
+    std::vector<std::optional<DmxFootprint>> byTrack_;
+    std::vector<DmxFootprint> moved_;
+};
+
+} // namespace creatures
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace creatures {
+
+/**
+ * A playback's background loads of creatures and fixtures that weren't cached
+ *
+ * The runner asks for one when it misses the cache and skips that track's
+ * frame; a prefetcher worker does the load and reports back whatever the
+ * database didn't have. Those don't get asked for again: the runner fails
+ * the track (or the session) on them instead.
+ *
+ * The runner only comes here on a cache miss, so the lock stays off the
+ * normal path.
+ */
+class PlaybackCacheLookups {
+  public:
+    /**
+     * Event loop: claim the next lookup
+     *
+     * @return false if one's already underway
+     */
+    bool begin() {
+        std::lock_guard lock(mutex_);
+        if (pending_) {
+            return false;
+        }
+        pending_ = true;
+        return true;
+    }
+
+    /** Worker: the lookup's done, and these ids couldn't be loaded */
+    void finish(const std::vector<std::string> &notFound) {
+        std::lock_guard lock(mutex_);
+        pending_ = false;
+        notFound_.insert(notFound.begin(), notFound.end());
+    }
+
+    /** Has a lookup already failed to find this creature or fixture? */
+    [[nodiscard]] bool isNotFound(const std::string &id) const {
+        std::lock_guard lock(mutex_);
+        return notFound_.contains(id);
+    }
+
+  private:
+    mutable std::mutex mutex_;
+    bool pending_{false};
+    std::unordered_set<std::string> notFound_;
+};
+
+} // namespace creatures
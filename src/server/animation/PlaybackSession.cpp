@@ -55,65 +55,28 @@ PlaybackSession::PlaybackSession(const Animation &animation, universe_t universe
         }
     }
 
-    // Decode all track frames upfront for fast playback
+    // The frames are already packed, so each track just shares its buffer
     trackStates_.reserve(animation_.tracks.size());
-    uint64_t totalFramesDecoded = 0;
-
-    bool decodeFailed = false;
+    uint64_t totalFrames = 0;
 
     for (const auto &track : animation_.tracks) {
         TrackState state;
         state.creatureId = track.creature_id;
         state.fixtureId = track.fixture_id;
+        state.frames = track.frames;
         state.currentFrameIndex = 0;
         state.nextDispatchFrame = startingFrame_;
 
-        const std::string trackTarget = !track.fixture_id.empty() ? fmt::format("fixture {}", track.fixture_id)
-                                                                  : fmt::format("creature {}", track.creature_id);
-
-        // Decode all frames for this track
-        state.decodedFrames.reserve(track.frames.size());
-        for (const auto &frameData : track.frames) {
-            try {
-                state.decodedFrames.push_back(decodeBase64(frameData));
-            } catch (const std::exception &ex) {
-                std::string errorMsg = fmt::format("Failed to decode frame for {}: {}", trackTarget, ex.what());
-                error(errorMsg);
-                if (sessionSpan_) {
-                    sessionSpan_->setError(errorMsg);
-                }
-                cancelled_.store(true);
-                decodeFailed = true;
-                break;
-            } catch (...) {
-                std::string errorMsg = fmt::format("Failed to decode frame for {}: unknown error", trackTarget);
-                error(errorMsg);
-                if (sessionSpan_) {
-                    sessionSpan_->setError(errorMsg);
-                }
-                cancelled_.store(true);
-                decodeFailed = true;
-                break;
-            }
-        }
-
-        if (decodeFailed) {
-            break;
-        }
-
-        totalFramesDecoded += track.frames.size();
+        totalFrames += track.frames.size();
         trackStates_.push_back(std::move(state));
-
-        trace("Decoded {} frames for {} in animation '{}'", track.frames.size(), trackTarget,
-              animation_.metadata.title);
     }
 
     if (sessionSpan_) {
-        sessionSpan_->setAttribute("session.total_frames_decoded", static_cast<int64_t>(totalFramesDecoded));
+        sessionSpan_->setAttribute("session.total_frames", static_cast<int64_t>(totalFrames));
     }
 
     debug("Created PlaybackSession for animation '{}' on universe {} starting at frame {} ({} tracks, {} total frames)",
-          animation_.metadata.title, universe_, startingFrame_, trackStates_.size(), totalFramesDecoded);
+          animation_.metadata.title, universe_, startingFrame_, trackStates_.size(), totalFrames);
 }
 
 PlaybackSession::~PlaybackSession() {
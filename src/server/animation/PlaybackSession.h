@@ -4,9 +4,12 @@
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <span>
 #include <vector>
 
 #include "model/Animation.h"
+#include "server/animation/DmxFootprint.h"
+#include "server/animation/PlaybackCacheLookups.h"
 #include "server/namespace-stuffs.h"
 #include "server/rtp/AudioStreamBuffer.h"
 #include "server/runtime/Activity.h"
@@ -20,20 +23,22 @@ class OperationSpan;
 /**
  * TrackState - Per-track playback state
  *
- * Holds decoded DMX frames and playback position for a single track
+ * Points at the track's packed DMX frames (shared with the Animation, not
+ * copied) and holds the playback position for a single track
  */
 struct TrackState {
     // Exactly one of `creatureId` / `fixtureId` is set per track. The playback runner picks the
     // matching lookup path based on which one is non-empty.
-    creatureId_t creatureId;                         // Creature this track controls, or empty
-    fixtureId_t fixtureId;                           // Fixture this track controls, or empty
-    std::vector<std::vector<uint8_t>> decodedFrames; // Decoded DMX data for each frame
-    uint32_t currentFrameIndex{0};                   // Current playback position
-    framenum_t nextDispatchFrame{0};                 // Next event loop frame to emit on
-
-    [[nodiscard]] bool isFinished() const { return currentFrameIndex >= decodedFrames.size(); }
-    [[nodiscard]] uint32_t getTotalFrames() const { return static_cast<uint32_t>(decodedFrames.size()); }
+    creatureId_t creatureId;         // Creature this track controls, or empty
+    fixtureId_t fixtureId;           // Fixture this track controls, or empty
+    PackedFrames frames;             // DMX data for every frame
+    uint32_t currentFrameIndex{0};   // Current playback position
+    framenum_t nextDispatchFrame{0}; // Next event loop frame to emit on
+
+    [[nodiscard]] bool isFinished() const { return currentFrameIndex >= frames.size(); }
+    [[nodiscard]] uint32_t getTotalFrames() const { return static_cast<uint32_t>(frames.size()); }
     [[nodiscard]] bool isFixtureTrack() const { return !fixtureId.empty(); }
+    [[nodiscard]] std::span<const uint8_t> currentFrame() const { return frames[currentFrameIndex]; }
 };
 
 /**
@@ -152,6 +157,16 @@ class PlaybackSession {
      */
     void setAudioBuffer(std::shared_ptr<rtp::AudioStreamBuffer> buffer) { audioBuffer_ = buffer; }
 
+    /**
+     * Where the runner has written DMX, for teardown to hand off. Event loop only.
+     */
+    [[nodiscard]] DmxFootprints &getDmxWritten() { return dmxWritten_; }
+
+    /**
+     * Creatures and fixtures being loaded because they weren't cached. Any thread.
+     */
+    [[nodiscard]] PlaybackCacheLookups &getCacheLookups() { return cacheLookups_; }
+
     /**
      * Get the audio transport (may be nullptr if no audio or not yet set)
      */
@@ -270,6 +285,12 @@ class PlaybackSession {
     // Audio transport for playback
     std::shared_ptr<class AudioTransport> audioTransport_;
 
+    // Where the runner has written DMX
+    DmxFootprints dmxWritten_;
+
+    // Background loads of whatever wasn't cached
+    PlaybackCacheLookups cacheLookups_;
+
     // Cancellation flag (atomic for thread-safety)
     std::atomic<bool> cancelled_{false};
 
@@ -0,0 +1,175 @@
+
+#include "PlaylistPrefetcher.h"
+
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "util/threadName.h"
+
+namespace creatures {
+
+PlaylistPrefetcher::PlaylistPrefetcher(std::size_t workerCount, Loader _loader) : loader(std::move(_loader)) {
+    if (workerCount == 0) {
+        throw std::invalid_argument("PlaylistPrefetcher requires at least one worker");
+    }
+    if (!loader) {
+        throw std::invalid_argument("PlaylistPrefetcher requires a loader");
+    }
+
+    workers.reserve(workerCount);
+    for (std::size_t i = 0; i < workerCount; ++i) {
+        workers.emplace_back(&PlaylistPrefetcher::workerLoop, this);
+    }
+    debug("playlist prefetcher started with {} workers", workerCount);
+}
+
+PlaylistPrefetcher::~PlaylistPrefetcher() { shutdown(); }
+
+void PlaylistPrefetcher::request(universe_t universe, const playlistId_t &playlistId) {
+    std::lock_guard lock(mutex);
+    if (stopping) {
+        return;
+    }
+
+    // Already loading (or loaded) this one
+    if (auto it = slots.find(universe); it != slots.end() && it->second.playlistId == playlistId) {
+        return;
+    }
+    requestLocked(universe, playlistId);
+}
+
+std::optional<Result<PlaylistPrefetcher::Item>> PlaylistPrefetcher::take(universe_t universe,
+                                                                        const playlistId_t &playlistId) {
+    std::lock_guard lock(mutex);
+    if (stopping) {
+        return std::nullopt;
+    }
+
+    auto it = slots.find(universe);
+    if (it == slots.end() || it->second.playlistId != playlistId) {
+        requestLocked(universe, playlistId);
+        return std::nullopt;
+    }
+    if (!it->second.item) {
+        return std::nullopt;
+    }
+
+    auto item = std::move(it->second.item);
+    slots.erase(it);
+    return item;
+}
+
+void PlaylistPrefetcher::invalidateAll() {
+    std::lock_guard lock(mutex);
+    debug("dropping {} prefetched playlist items", slots.size());
+
+    // Loads that are running now won't find their slot when they finish, so they'll be dropped too.
+    // Background tasks aren't items, so they stay.
+    std::erase_if(jobs, [](const Job &job) { return !job.task; });
+    slots.clear();
+}
+
+bool PlaylistPrefetcher::runInBackground(const std::string &key, Task task) {
+    {
+        std::lock_guard lock(mutex);
+        if (stopping || !pendingTasks.insert(key).second) {
+            return false;
+        }
+
+        Job job;
+        job.taskKey = key;
+        job.task = std::move(task);
+        jobs.push_back(std::move(job));
+    }
+    jobsReady.notify_one();
+    debug("running {} in the background", key);
+    return true;
+}
+
+void PlaylistPrefetcher::shutdown() {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+        jobs.clear();
+        pendingTasks.clear();
+    }
+    jobsReady.notify_all();
+
+    for (auto &worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers.clear();
+}
+
+void PlaylistPrefetcher::requestLocked(universe_t universe, const playlistId_t &playlistId) {
+    const auto ticket = nextTicket++;
+    slots[universe] = Slot{playlistId, ticket, std::nullopt};
+    jobs.push_back(Job{universe, playlistId, ticket});
+    jobsReady.notify_one();
+    debug("prefetching the next item of playlist {} for universe {}", playlistId, universe);
+}
+
+void PlaylistPrefetcher::workerLoop() {
+    setThreadName("PlaylistPrefetcher");
+
+    while (true) {
+        Job job;
+        {
+            std::unique_lock lock(mutex);
+            jobsReady.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (stopping) {
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        if (job.task) {
+            runTask(job);
+            continue;
+        }
+
+        // Don't let one bad load take the worker down with it
+        std::optional<Result<Item>> loaded;
+        try {
+            loaded.emplace(loader(job.playlistId));
+        } catch (const std::exception &e) {
+            loaded.emplace(ServerError(ServerError::InternalError,
+                                       fmt::format("Unable to load the next item of playlist {}: {}", job.playlistId,
+                                                   e.what())));
+        } catch (...) {
+            loaded.emplace(ServerError(ServerError::InternalError,
+                                       fmt::format("Unable to load the next item of playlist {}", job.playlistId)));
+        }
+
+        std::lock_guard lock(mutex);
+        auto it = slots.find(job.universe);
+        if (it == slots.end() || it->second.ticket != job.ticket) {
+            debug("dropping a prefetched item of playlist {} for universe {}; it's been replaced", job.playlistId,
+                  job.universe);
+            continue;
+        }
+        it->second.item = std::move(loaded);
+    }
+}
+
+void PlaylistPrefetcher::runTask(Job &job) {
+    try {
+        job.task();
+    } catch (const std::exception &e) {
+        warn("background task {} failed: {}", job.taskKey, e.what());
+    } catch (...) {
+        warn("background task {} failed", job.taskKey);
+    }
+
+    std::lock_guard lock(mutex);
+    pendingTasks.erase(job.taskKey);
+}
+
+} // namespace creatures
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "model/Animation.h"
+#include "model/Playlist.h"
+#include "server/namespace-stuffs.h"
+#include "util/Result.h"
+
+namespace creatures {
+
+/**
+ * Loads each universe's next playlist item on a worker thread, one item ahead
+ *
+ * Picking the next animation means reading the playlist and the animation out
+ * of Mongo, and PlaylistEvent runs on the event loop, where waiting on that
+ * stalls every universe. So the event asks for the *next* item as soon as it's
+ * scheduled the current one, and by the time that animation finishes the next
+ * one is sitting here ready to take().
+ *
+ * There's at most one item per universe, loading or ready. If a PlaylistEvent
+ * shows up before its item is ready, take() says so and the event tries again
+ * a few frames later rather than waiting.
+ *
+ * Anything that changes playlists or animations calls invalidateAll(), which
+ * throws away every item loaded before it so the next take() loads a fresh one.
+ *
+ * The same workers take the event loop's other database reads, like a creature
+ * the playback runner doesn't have cached or an idle animation to start. The
+ * loop hands those to runInBackground() and carries on without them.
+ */
+class PlaylistPrefetcher {
+
+  public:
+    /** What a PlaylistEvent needs to play the next thing in a playlist */
+    struct Item {
+        Playlist playlist;
+        animationId_t animationId;
+        Animation animation;
+    };
+
+    /** Loads (and picks) the next item of a playlist. Runs on a worker thread. */
+    using Loader = std::function<Result<Item>(const playlistId_t &playlistId)>;
+
+    /** Something that has to read the database, just not on the event loop */
+    using Task = std::function<void()>;
+
+    /**
+     * @param workerCount how many worker threads to run (at least one)
+     * @param loader what does the actual loading
+     */
+    PlaylistPrefetcher(std::size_t workerCount, Loader loader);
+    ~PlaylistPrefetcher();
+
+    PlaylistPrefetcher(const PlaylistPrefetcher &) = delete;
+    PlaylistPrefetcher &operator=(const PlaylistPrefetcher &) = delete;
+
+    /**
+     * Start loading the next item for a universe, unless that's already happening
+     *
+     * Never waits, so it's safe to call from the event loop.
+     */
+    void request(universe_t universe, const playlistId_t &playlistId);
+
+    /**
+     * Take a universe's next item, if it's ready
+     *
+     * Never waits. If nothing usable is here (never requested, still loading,
+     * for a different playlist, or invalidated since) it makes sure a load is on
+     * the way and returns nullopt; try again later.
+     *
+     * @return the item, or the error loading it; nullopt if it isn't ready yet
+     */
+    std::optional<Result<Item>> take(universe_t universe, const playlistId_t &playlistId);
+
+    /** Drop everything that's loaded or loading, so the next take() for each universe starts over */
+    void invalidateAll();
+
+    /**
+     * Run a task on a worker, unless one with the same key is already waiting or running
+     *
+     * Never waits, so it's safe to call from the event loop. Tasks are run in
+     * the order they came in, along with the playlist loads; one that throws
+     * is logged and forgotten.
+     *
+     * @param key what the task is for, so asking every frame only runs it once
+     * @param task the work
+     * @return false if it wasn't queued (already pending, or shutting down)
+     */
+    bool runInBackground(const std::string &key, Task task);
+
+    /** Stop the workers. Loads that haven't started yet are dropped. Safe to call more than once. */
+    void shutdown();
+
+  private:
+    struct Slot {
+        playlistId_t playlistId;
+        uint64_t ticket = 0; // which load this slot is waiting for
+        std::optional<Result<Item>> item; // empty while it's loading
+    };
+
+    struct Job {
+        universe_t universe = 0;
+        playlistId_t playlistId;
+        uint64_t ticket = 0;
+
+        // Set for runInBackground() jobs, which don't load an item
+        std::string taskKey;
+        Task task;
+    };
+
+    // Queue a load for a universe, replacing whatever slot it had. Call with the lock held.
+    void requestLocked(universe_t universe, const playlistId_t &playlistId);
+
+    void workerLoop();
+
+    // Run a runInBackground() job and let its key be queued again
+    void runTask(Job &job);
+
+    const Loader loader;
+
+    std::mutex mutex;
+    std::condition_variable jobsReady;
+    std::deque<Job> jobs;
+    std::unordered_map<universe_t, Slot> slots;
+    std::unordered_set<std::string> pendingTasks;
+    uint64_t nextTicket = 1;
+    bool stopping = false;
+
+    std::vector<std::thread> workers;
+};
+
+} // namespace creatures
@@ -8,6 +8,8 @@
 #include <vector>
 
 #include "model/Animation.h"
+#include "server/animation/DmxFootprint.h"
+#include "server/animation/PlaybackCacheLookups.h"
 #include "server/namespace-stuffs.h"
 #include "server/rtp/AudioStreamBuffer.h"
 #include "server/runtime/Activity.h"
@@ -135,6 +137,12 @@ class StreamingPlaybackSession {
     [[nodiscard]] std::shared_ptr<rtp::AudioStreamBuffer> getAudioBuffer() const { return audioBuffer_; }
     void setAudioBuffer(std::shared_ptr<rtp::AudioStreamBuffer> buffer) { audioBuffer_ = buffer; }
 
+    // Where the runner has written DMX, for teardown to hand off. Event loop only.
+    [[nodiscard]] DmxFootprints &getDmxWritten() { return dmxWritten_; }
+
+    // Creatures being loaded because they weren't cached. Any thread.
+    [[nodiscard]] PlaybackCacheLookups &getCacheLookups() { return cacheLookups_; }
+
     [[nodiscard]] std::shared_ptr<class AudioTransport> getAudioTransport() const { return audioTransport_; }
     void setAudioTransport(std::shared_ptr<class AudioTransport> transport) { audioTransport_ = transport; }
 
@@ -192,6 +200,12 @@ class StreamingPlaybackSession {
     std::shared_ptr<rtp::AudioStreamBuffer> audioBuffer_;
     std::shared_ptr<class AudioTransport> audioTransport_;
 
+    // Where the runner has written DMX
+    DmxFootprints dmxWritten_;
+
+    // Background loads of whatever wasn't cached
+    PlaybackCacheLookups cacheLookups_;
+
     // Lifecycle
     bool hasStarted_{false};
     std::function<void()> onStart_;
@@ -11,6 +11,7 @@
 #include <mongocxx/client.hpp>
 
 #include "exception/exception.h"
+#include "server/animation/AnimationCache.h"
 #include "server/creature-server.h"
 #include "server/database.h"
 #include "util/JsonParser.h"
@@ -24,6 +25,7 @@ using bsoncxx::builder::stream::document;
 namespace creatures {
 extern std::shared_ptr<Database> db;
 extern std::shared_ptr<ObservabilityManager> observability;
+extern std::shared_ptr<AnimationCache> animationCache;
 
 // Conforms to docs/database-observability.md (issue #17). Was previously
 // over-instrumented with sub-spans like `Database.buildFilter`, `MongoDB.findOne`,
@@ -155,6 +157,22 @@ Result<creatures::Animation> Database::getAnimation(const animationId_t &animati
         return Result<creatures::Animation>{ServerError(ServerError::InvalidData, errorMessage)};
     }
 
+    // Already decoded? Then there's no need to go to Mongo at all. The copy
+    // shares the cached frames.
+    uint64_t cacheGeneration = 0;
+    if (creatures::animationCache) {
+        if (auto cached = creatures::animationCache->get(animationId)) {
+            if (dbSpan) {
+                dbSpan->setAttribute("animation.cache", "hit");
+                dbSpan->setAttribute("animation.title", cached->metadata.title);
+                dbSpan->setAttribute("animation.tracks_count", static_cast<int64_t>(cached->tracks.size()));
+                dbSpan->setSuccess();
+            }
+            return Result<creatures::Animation>{*cached};
+        }
+        cacheGeneration = creatures::animationCache->generation();
+    }
+
     auto jsonSpan = creatures::observability->createChildOperationSpan("getAnimation.getAnimationJson", dbSpan);
     auto animationJson = getAnimationJson(animationId, jsonSpan);
     if (!animationJson.isSuccess()) {
@@ -196,7 +214,11 @@ Result<creatures::Animation> Database::getAnimation(const animationId_t &animati
         fetchSpan->setSuccess();
 
     auto animation = result.getValue().value();
+    if (creatures::animationCache) {
+        creatures::animationCache->put(std::make_shared<const creatures::Animation>(animation), cacheGeneration);
+    }
     if (dbSpan) {
+        dbSpan->setAttribute("animation.cache", "miss");
         dbSpan->setAttribute("animation.title", animation.metadata.title);
         dbSpan->setAttribute("animation.tracks_count", static_cast<int64_t>(animation.tracks.size()));
         dbSpan->setAttribute("animation.number_of_frames", static_cast<int64_t>(animation.metadata.number_of_frames));
@@ -7,6 +7,7 @@ using json = nlohmann::json;
 #include "model/DialogScript.h"
 #include "server/database.h"
 
+#include "util/Base64.h"
 #include "util/Result.h"
 #include "util/helpers.h"
 
@@ -20,6 +21,42 @@ Result<creatures::Animation> Database::parseAnimationJson(json animationJson) {
     return animationFromJson(std::move(animationJson));
 }
 
+namespace {
+
+    /**
+     * A track's frames come in one of two shapes: the API's list of base64
+     * strings (which is also how older documents are stored), or the packed
+     * BSON binary we store now. Binary comes back out of bsoncxx::to_json as
+     * either {"$binary": "...", "$type": "00"} (legacy extended JSON) or
+     * {"$binary": {"base64": "...", "subType": "00"}} (canonical/relaxed).
+     */
+    Result<PackedFrames> framesFromJson(const json &trackJson) {
+        const auto &frames = trackJson.at("frames");
+        if (frames.is_array()) {
+            return PackedFrames::fromBase64Frames(frames.get<std::vector<std::string>>());
+        }
+
+        if (!frames.is_object() || !frames.contains("$binary")) {
+            return Result<PackedFrames>{
+                ServerError(ServerError::InvalidData, "frames must be a list of base64 strings or binary")};
+        }
+
+        const auto &binary = frames.at("$binary");
+        const std::string encoded =
+            binary.is_object() ? binary.at("base64").get<std::string>() : binary.get<std::string>();
+        const auto width = trackJson.at("frame_width").get<uint32_t>();
+        const auto count = trackJson.at("frame_count").get<std::size_t>();
+
+        const auto size = util::base64DecodedSize(encoded);
+        std::vector<uint8_t> bytes(size.value_or(0));
+        if (!size || !util::base64DecodeInto(encoded, bytes)) {
+            return Result<PackedFrames>{ServerError(ServerError::InvalidData, "frame binary is corrupt")};
+        }
+        return PackedFrames::fromBytes(width, count, std::move(bytes));
+    }
+
+} // namespace
+
 Result<creatures::Track> Database::trackFromJson(json trackJson) {
 
     debug("attempting to create a Track from JSON via trackFromJson()");
@@ -62,7 +99,14 @@ Result<creatures::Track> Database::trackFromJson(json trackJson) {
             return ServerError(ServerError::InvalidData, errorMessage);
         }
 
-        track.frames = trackJson["frames"];
+        auto framesResult = framesFromJson(trackJson);
+        if (!framesResult.isSuccess()) {
+            std::string errorMessage =
+                fmt::format("Track {} has bad frames: {}", track.id, framesResult.getError()->getMessage());
+            warn(errorMessage);
+            return ServerError(ServerError::InvalidData, errorMessage);
+        }
+        track.frames = framesResult.getValue().value();
 
         debug("all checked out, returning a valid Track");
         return Result<creatures::Track>{track};
@@ -87,6 +87,9 @@ Result<std::string> Database::playStoredAnimation(const animationId_t &animation
     // the idle-restart race can't reopen in between (issue #62). The old pre-cancel here
     // left a gap during the audio load in which cancelled idle sessions restarted.
 
+    // Look up the creatures here, so the runner doesn't have to from the event loop
+    warmPlaybackCaches(animation, playSpan);
+
     auto playResult = scheduleAnimation(startingFrame, animation, universe);
     if (!playResult.isSuccess()) {
         auto error = playResult.getError().value();
@@ -27,6 +27,7 @@ namespace creatures {
 extern std::shared_ptr<Configuration> config;
 extern std::shared_ptr<Database> db;
 extern std::shared_ptr<ObjectCache<creatureId_t, Creature>> creatureCache;
+extern std::shared_ptr<ObjectCache<fixtureId_t, DmxFixture>> fixtureCache;
 extern std::shared_ptr<EventLoop> eventLoop;
 extern std::shared_ptr<SessionManager> sessionManager;
 extern std::shared_ptr<SystemCounters> metrics;
@@ -89,4 +90,52 @@ Result<framenum_t> scheduleAnimation(framenum_t startingFrame, const creatures::
     return Result<framenum_t>{lastFrame};
 }
 
+std::vector<std::string> warmPlaybackCaches(const creatures::Animation &animation,
+                                            std::shared_ptr<OperationSpan> parentSpan) {
+    std::vector<std::string> notLoaded;
+    uint32_t loaded = 0;
+    for (const auto &track : animation.tracks) {
+        if (!track.fixture_id.empty()) {
+            if (!fixtureCache || fixtureCache->contains(track.fixture_id)) {
+                continue;
+            }
+            if (!db) {
+                notLoaded.push_back(track.fixture_id);
+                continue;
+            }
+            auto fixtureResult = db->getFixture(track.fixture_id, parentSpan);
+            if (!fixtureResult.isSuccess()) {
+                warn("Fixture {} in animation {} couldn't be loaded: {}", track.fixture_id, animation.id,
+                     fixtureResult.getError()->getMessage());
+                notLoaded.push_back(track.fixture_id);
+                continue;
+            }
+            fixtureCache->put(track.fixture_id, fixtureResult.getValue().value());
+            loaded++;
+        } else if (!track.creature_id.empty()) {
+            if (!creatureCache || creatureCache->contains(track.creature_id)) {
+                continue;
+            }
+            if (!db) {
+                notLoaded.push_back(track.creature_id);
+                continue;
+            }
+            auto creatureResult = db->getCreature(track.creature_id, parentSpan);
+            if (!creatureResult.isSuccess()) {
+                warn("Creature {} in animation {} couldn't be loaded: {}", track.creature_id, animation.id,
+                     creatureResult.getError()->getMessage());
+                notLoaded.push_back(track.creature_id);
+                continue;
+            }
+            creatureCache->put(track.creature_id, creatureResult.getValue().value());
+            loaded++;
+        }
+    }
+
+    if (loaded > 0) {
+        debug("loaded {} creatures and fixtures into the cache ahead of animation {}", loaded, animation.id);
+    }
+    return notLoaded;
+}
+
 } // namespace creatures
@@ -1,7 +1,12 @@
 #pragma once
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "server/namespace-stuffs.h"
 #include "server/runtime/Activity.h"
+#include "util/ObservabilityManager.h"
 #include "util/Result.h"
 #include "util/helpers.h"
 
@@ -25,4 +30,22 @@ Result<framenum_t>
 scheduleAnimation(framenum_t startingFrame, const creatures::Animation &animation, universe_t universe,
                   creatures::runtime::ActivityReason reason = creatures::runtime::ActivityReason::Play);
 
+/**
+ * Make sure every creature and fixture an animation drives is in its cache
+ *
+ * The playback runner looks these up on the event loop every frame it emits.
+ * Anything that isn't cached yet is loaded from the database here, on the
+ * calling thread, so the runner never has to. Call this before scheduling an
+ * animation, from anywhere but the event loop.
+ *
+ * Missing creatures or fixtures are only logged; the runner reports those
+ * when it gets to them.
+ *
+ * @param animation the animation that's about to play
+ * @param parentSpan the span to hang the lookups off of, if any
+ * @return the ids of the creatures and fixtures that couldn't be loaded
+ */
+std::vector<std::string> warmPlaybackCaches(const creatures::Animation &animation,
+                                            std::shared_ptr<creatures::OperationSpan> parentSpan = nullptr);
+
 } // namespace creatures
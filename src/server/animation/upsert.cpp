@@ -182,6 +182,9 @@ Result<creatures::Animation> Database::upsertAnimation(const std::string &animat
             }
         }
 
+        // Whatever shape the frames came in as, they're stored packed
+        storeAnimationFrames(jsonObject, animation);
+
         auto bsonSpan = creatures::observability->createChildOperationSpan("upsertAnimation.json-to-bson", upsertSpan);
         auto bsonResult =
             JsonParser::jsonStringToBson(jsonObject.dump(), fmt::format("animation {}", animation.id), bsonSpan);
@@ -0,0 +1,207 @@
+#include "AudioCachePrewarmer.h"
+
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <unordered_set>
+#include <utility>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#include <fmt/format.h>
+
+#include "server/namespace-stuffs.h"
+#include "util/threadName.h"
+
+namespace creatures::audio {
+
+AudioCachePrewarmer::AudioCachePrewarmer(Budget _budget, Lister _lister, Warmer _warmer, StatsObserver _statsObserver)
+    : budget(_budget), lister(std::move(_lister)), warmer(std::move(_warmer)),
+      statsObserver(std::move(_statsObserver)) {
+    if (budget.maxCores == 0) {
+        throw std::invalid_argument("AudioCachePrewarmer requires at least one core");
+    }
+    if (!lister || !warmer) {
+        throw std::invalid_argument("AudioCachePrewarmer requires a lister and a warmer");
+    }
+
+    worker = std::thread(&AudioCachePrewarmer::workerLoop, this);
+    debug("audio cache prewarmer started (nice {}, at most {} cores)", budget.niceLevel, budget.maxCores);
+}
+
+AudioCachePrewarmer::~AudioCachePrewarmer() { shutdown(); }
+
+void AudioCachePrewarmer::requestScan() {
+    {
+        std::lock_guard lock(mutex);
+        if (stopping) {
+            return;
+        }
+        scanPending = true;
+    }
+    scanRequested.notify_one();
+}
+
+AudioCachePrewarmer::Stats AudioCachePrewarmer::getStats() const {
+    std::lock_guard lock(mutex);
+    return stats;
+}
+
+void AudioCachePrewarmer::shutdown() {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    scanRequested.notify_all();
+
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void AudioCachePrewarmer::applyBudget() const {
+#if defined(__linux__)
+    // Both of these are per thread on Linux, and threads started from this one (the pool's) inherit them
+    if (setpriority(PRIO_PROCESS, static_cast<id_t>(gettid()), budget.niceLevel) != 0) {
+        warn("Unable to set the audio cache prewarmer to nice {}: {}", budget.niceLevel, std::strerror(errno));
+    }
+
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        warn("Unable to read the audio cache prewarmer's CPU affinity: {}", std::strerror(errno));
+        return;
+    }
+
+    // The highest-numbered cores, leaving the first ones alone
+    cpu_set_t capped;
+    CPU_ZERO(&capped);
+    std::size_t cores = 0;
+    for (int cpu = CPU_SETSIZE - 1; cpu >= 0 && cores < budget.maxCores; --cpu) {
+        if (CPU_ISSET(cpu, &allowed)) {
+            CPU_SET(cpu, &capped);
+            ++cores;
+        }
+    }
+    if (sched_setaffinity(0, sizeof(capped), &capped) != 0) {
+        warn("Unable to keep the audio cache prewarmer to {} cores: {}", budget.maxCores, std::strerror(errno));
+    }
+#else
+    debug("the audio cache prewarmer's CPU budget only applies on Linux");
+#endif
+}
+
+void AudioCachePrewarmer::workerLoop() {
+    setThreadName("AudioPrewarmer");
+    applyBudget();
+    const auto pool = std::make_shared<util::ComputePool>(budget.maxCores, std::vector<int>{}, "AudioPrewarm");
+
+    while (true) {
+        {
+            std::unique_lock lock(mutex);
+            scanRequested.wait(lock, [this] { return stopping || scanPending; });
+            if (stopping) {
+                return;
+            }
+            scanPending = false;
+        }
+
+        std::optional<Result<std::vector<std::string>>> listed;
+        try {
+            listed.emplace(lister());
+        } catch (const std::exception &e) {
+            listed.emplace(
+                ServerError(ServerError::InternalError, fmt::format("Unable to list sounds to prewarm: {}", e.what())));
+        }
+        if (!listed->isSuccess()) {
+            warn("Not prewarming the audio cache: {}", listed->getError()->getMessage());
+            continue;
+        }
+
+        auto listedSounds = listed->getValue().value();
+        std::vector<std::string> sounds;
+        std::unordered_set<std::string> seen;
+        for (auto &sound : listedSounds) {
+            if (!sound.empty() && seen.insert(sound).second) {
+                sounds.push_back(std::move(sound));
+            }
+        }
+        debug("prewarming the audio cache for {} sounds", sounds.size());
+
+        {
+            std::lock_guard lock(mutex);
+            stats.pending = sounds.size();
+        }
+        publishStats();
+
+        bool startedOver = false;
+        for (const auto &sound : sounds) {
+            {
+                std::lock_guard lock(mutex);
+                if (stopping) {
+                    return;
+                }
+                if (scanPending) {
+                    startedOver = true;
+                    break;
+                }
+            }
+
+            std::optional<Result<bool>> warmed;
+            try {
+                warmed.emplace(warmer(sound, stopping, pool));
+            } catch (const std::exception &e) {
+                warmed.emplace(ServerError(ServerError::InternalError, e.what()));
+            }
+            if (stopping) {
+                return;
+            }
+
+            {
+                std::lock_guard lock(mutex);
+                --stats.pending;
+                ++stats.checked;
+                if (!warmed->isSuccess()) {
+                    ++stats.failed;
+                } else if (warmed->getValue().value()) {
+                    ++stats.encoded;
+                }
+            }
+            if (!warmed->isSuccess()) {
+                warn("Unable to prewarm the audio cache for {}: {}", sound, warmed->getError()->getMessage());
+            } else if (warmed->getValue().value()) {
+                info("Prewarmed the audio cache for {}", sound);
+            }
+            publishStats();
+        }
+
+        {
+            std::lock_guard lock(mutex);
+            if (!startedOver) {
+                ++stats.scans;
+            }
+            stats.pending = 0;
+        }
+        publishStats();
+        debug("audio cache prewarm scan {}", startedOver ? "started over" : "finished");
+    }
+}
+
+void AudioCachePrewarmer::publishStats() const {
+    if (!statsObserver) {
+        return;
+    }
+    try {
+        statsObserver(getStats());
+    } catch (const std::exception &e) {
+        error("Audio cache prewarmer stats observer failed: {}", e.what());
+    }
+}
+
+} // namespace creatures::audio
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "util/ComputePool.h"
+#include "util/Result.h"
+
+namespace creatures::audio {
+
+/**
+ * Encodes every sound the animations and playlists use into the AudioCache, in the background
+ *
+ * Without this, the first play of a sound after a deploy (or after it's
+ * uploaded) pays for the whole Opus encode. A scan asks the lister for every
+ * sound that could be played, most urgent first, and has the warmer encode
+ * each one that isn't cached or whose cache no longer matches the WAV. Sounds
+ * are done one at a time on a single worker thread.
+ *
+ * The worker runs at a low priority (a nice level) and is kept to a few cores.
+ * It encodes on a ComputePool of its own, one thread per core, whose threads
+ * inherit both, so it only gets CPU the event loop, the RTP server, and
+ * playback encodes aren't using.
+ *
+ * requestScan() never waits. Asking again while a scan is running drops the
+ * rest of that scan and starts over, which is cheap since everything it's
+ * already done is cached now.
+ */
+class AudioCachePrewarmer {
+
+  public:
+    /** Every sound worth warming, most urgent first (duplicates are skipped). Runs on the worker. */
+    using Lister = std::function<Result<std::vector<std::string>>()>;
+
+    /**
+     * Make sure one sound is cached. Runs on the worker.
+     *
+     * @param stopping set when the prewarmer is shutting down; give up if it is
+     * @param pool the prewarmer's own pool, within its budget; do the encoding here
+     * @return true if it had to be encoded, false if it was already cached
+     */
+    using Warmer = std::function<Result<bool>(const std::string &soundPath, const std::atomic<bool> &stopping,
+                                              const std::shared_ptr<util::ComputePool> &pool)>;
+
+    /** How much of the machine the worker (and everything it starts) may use */
+    struct Budget {
+        int niceLevel{10};
+        std::size_t maxCores{1};
+    };
+
+    struct Stats {
+        std::size_t pending{0}; // sounds left in the current scan
+        uint64_t scans{0};      // scans that made it all the way through
+        uint64_t checked{0};
+        uint64_t encoded{0};
+        uint64_t failed{0};
+    };
+
+    using StatsObserver = std::function<void(const Stats &)>;
+
+    /**
+     * Starts the worker, which waits for the first requestScan()
+     *
+     * @param budget how much CPU the worker gets (at least one core)
+     * @param lister what to warm
+     * @param warmer does the warming
+     * @param statsObserver called from the worker whenever the stats change
+     */
+    AudioCachePrewarmer(Budget budget, Lister lister, Warmer warmer, StatsObserver statsObserver = {});
+    ~AudioCachePrewarmer();
+
+    AudioCachePrewarmer(const AudioCachePrewarmer &) = delete;
+    AudioCachePrewarmer &operator=(const AudioCachePrewarmer &) = delete;
+
+    /** Start a scan, or start the running one over. Never waits, so it's safe to call from the event loop. */
+    void requestScan();
+
+    [[nodiscard]] Stats getStats() const;
+
+    /** Stop the worker, cancelling whatever it's encoding. Safe to call more than once. */
+    void shutdown();
+
+  private:
+    // Lower this thread's priority and pin it to the last few allowed cores
+    void applyBudget() const;
+
+    void workerLoop();
+    void publishStats() const;
+
+    const Budget budget;
+    const Lister lister;
+    const Warmer warmer;
+    const StatsObserver statsObserver;
+
+    mutable std::mutex mutex;
+    std::condition_variable scanRequested;
+    bool scanPending = false;
+    std::atomic<bool> stopping{false};
+    Stats stats;
+
+    std::thread worker;
+};
+
+} // namespace creatures::audio
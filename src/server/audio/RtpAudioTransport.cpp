@@ -87,7 +87,9 @@ Result<void> RtpAudioTransport::start(std::shared_ptr<PlaybackSession> session)
 
     totalFrames_ = audioBuffer->getFrameCount();
     currentFrameIndex_ = 0;
+    pendingSkippedFrames_ = 0;
     nextDispatchFrame_ = session_->getStartingFrame();
+    enqueueLead_ = rtpServer_->getEnqueueLeadFrames();
     started_ = true;
     stopped_ = false;
     if (auto span = session_->getSpan()) {
@@ -146,9 +148,9 @@ Result<framenum_t> RtpAudioTransport::dispatchNextChunk(framenum_t currentFrame)
     }
 
     // Check if we should dispatch on this frame
-    if (currentFrame < nextDispatchFrame_) {
+    if (currentFrame + enqueueLead_ < nextDispatchFrame_) {
         // Not time yet
-        return Result<framenum_t>{nextDispatchFrame_};
+        return Result<framenum_t>{enqueueFrameFor(nextDispatchFrame_)};
     }
 
     // Check if finished or stopped
@@ -194,6 +196,7 @@ Result<framenum_t> RtpAudioTransport::dispatchNextChunk(framenum_t currentFrame)
             const size_t remainingFrames = totalFrames_ - currentFrameIndex_;
             framesToSkip = std::min(missedFrames, remainingFrames);
             currentFrameIndex_ += framesToSkip;
+            pendingSkippedFrames_ += framesToSkip;
             nextDispatchFrame_ += static_cast<framenum_t>(framesToSkip) * dispatchStep;
             warn("RTP audio skipped {} late frame(s) for session {}", framesToSkip, session_->getSessionId());
         }
@@ -203,11 +206,30 @@ Result<framenum_t> RtpAudioTransport::dispatchNextChunk(framenum_t currentFrame)
         return Result<framenum_t>{currentFrame};
     }
 
+    // On a cache miss the file is still being encoded. If the playhead has
+    // caught up with the encoder, hold this packet and try again next tick;
+    // the late-frame skip above keeps the audio in sync once it's ready.
+    if (currentFrameIndex_ >= audioBuffer->getFramesReady()) {
+        if (audioBuffer->hasEncodeFailed()) {
+            stopped_ = true;
+            rtpServer_->releaseOutput(outputState.lease);
+            const auto errorMsg = fmt::format("Opus encoding failed before frame {} for session {}",
+                                              currentFrameIndex_, session_->getSessionId());
+            error(errorMsg);
+            return Result<framenum_t>{ServerError(ServerError::InternalError, errorMsg)};
+        }
+        if (metrics && currentFrameIndex_ != lastUnderrunFrameIndex_) {
+            metrics->incrementRtpEncodeUnderruns();
+        }
+        lastUnderrunFrameIndex_ = currentFrameIndex_;
+        return Result<framenum_t>{currentFrame};
+    }
+
     try {
         const bool isFinalFrame = currentFrameIndex_ + 1 >= totalFrames_;
         outputState.traceContext.enqueueFrame = currentFrame;
         const auto enqueueResult =
-            rtpServer_->enqueueAudioFrame(outputState.lease, audioBuffer, currentFrameIndex_, framesToSkip,
+            rtpServer_->enqueueAudioFrame(outputState.lease, audioBuffer, currentFrameIndex_, pendingSkippedFrames_,
                                           isFinalFrame, nullptr, outputState.traceContext);
         if (enqueueResult == rtp::RtpEnqueueResult::StaleLease) {
             stopped_ = true;
@@ -223,6 +245,7 @@ Result<framenum_t> RtpAudioTransport::dispatchNextChunk(framenum_t currentFrame)
         }
 
         currentFrameIndex_++;
+        pendingSkippedFrames_ = 0;
         finalFrameQueued_ = isFinalFrame;
         nextDispatchFrame_ += dispatchStep;
         if (metrics) {
@@ -242,14 +265,18 @@ Result<framenum_t> RtpAudioTransport::dispatchNextChunk(framenum_t currentFrame)
         return Result<framenum_t>{ServerError(ServerError::InternalError, errorMsg)};
     }
 
-    return Result<framenum_t>{nextDispatchFrame_};
+    return Result<framenum_t>{enqueueFrameFor(nextDispatchFrame_)};
 }
 
 std::optional<framenum_t> RtpAudioTransport::getNextDispatchFrame() const {
     if (!started_ || stopped_ || currentFrameIndex_ >= totalFrames_) {
         return std::nullopt;
     }
-    return nextDispatchFrame_;
+    return enqueueFrameFor(nextDispatchFrame_);
+}
+
+framenum_t RtpAudioTransport::enqueueFrameFor(framenum_t dueFrame) const {
+    return dueFrame > enqueueLead_ ? dueFrame - enqueueLead_ : 0;
 }
 
 bool RtpAudioTransport::isFinished() const {
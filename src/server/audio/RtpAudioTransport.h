@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <mutex>
 
 #include "AudioTransport.h"
@@ -53,6 +54,9 @@ class RtpAudioTransport : public AudioTransport {
 
     [[nodiscard]] OutputState getOutputState() const;
 
+    /** The event loop frame to queue the frame set that's due at dueFrame */
+    [[nodiscard]] framenum_t enqueueFrameFor(framenum_t dueFrame) const;
+
     /** Record a breaker-terminated generation and stop the transport. */
     Result<framenum_t> markTerminalFailure(const OutputState &outputState);
 
@@ -72,7 +76,10 @@ class RtpAudioTransport : public AudioTransport {
     // Playback state
     size_t currentFrameIndex_{0};
     size_t totalFrames_{0};
-    framenum_t nextDispatchFrame_{0};
+    size_t pendingSkippedFrames_{0}; // skipped while waiting on the encoder; the next packet carries them
+    size_t lastUnderrunFrameIndex_{SIZE_MAX}; // so each held packet is only counted once
+    framenum_t nextDispatchFrame_{0}; // when the next frame set is due; it's queued enqueueLead_ frames before that
+    framenum_t enqueueLead_{0};
     size_t finalDrainTicks_{0};
     bool started_{false};
     bool stopped_{false};
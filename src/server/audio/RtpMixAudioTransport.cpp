@@ -0,0 +1,98 @@
+//
+// RtpMixAudioTransport.cpp
+// An animation's sound, mixed into the RTP output
+//
+
+#include "RtpMixAudioTransport.h"
+
+#include "server/animation/PlaybackSession.h"
+#include "spdlog/spdlog.h"
+
+namespace creatures {
+
+void RtpMixAudioTransport::setSource(std::shared_ptr<rtp::RtpMixSource> source) {
+    std::lock_guard lock(stateMutex_);
+    source_ = std::move(source);
+    if (stopped_ && source_) {
+        // Stopped while the loader was still opening it
+        source_->cancel();
+    }
+}
+
+std::shared_ptr<rtp::RtpMixSource> RtpMixAudioTransport::getSource() const {
+    std::lock_guard lock(stateMutex_);
+    return source_;
+}
+
+Result<void> RtpMixAudioTransport::start(std::shared_ptr<PlaybackSession> session) {
+    if (!session) {
+        std::string errorMsg = "No playback session provided";
+        error(errorMsg);
+        return Result<void>{ServerError(ServerError::InvalidData, errorMsg)};
+    }
+
+    std::unique_lock lock(stateMutex_);
+    if (!source_) {
+        stopped_ = true;
+        lock.unlock();
+        std::string errorMsg = fmt::format("Session {} has no RTP mix source", session->getSessionId());
+        error(errorMsg);
+        return Result<void>{ServerError(ServerError::InternalError, errorMsg)};
+    }
+
+    started_ = true;
+    lock.unlock();
+    debug("Session {} is playing through the RTP mixer", session->getSessionId());
+    return Result<void>{};
+}
+
+void RtpMixAudioTransport::stop() {
+    std::shared_ptr<rtp::RtpMixSource> source;
+    {
+        std::lock_guard lock(stateMutex_);
+        stopped_ = true;
+        source = source_;
+    }
+    if (source) {
+        // The mixer drops a cancelled track on its next frame set
+        source->cancel();
+    }
+}
+
+Result<framenum_t> RtpMixAudioTransport::dispatchNextChunk(framenum_t currentFrame) {
+    // The mixer sends the audio; all there is to do is check back on it
+    if (currentFrame >= nextPollFrame_) {
+        nextPollFrame_ = currentFrame + POLL_FRAMES;
+    }
+    return Result<framenum_t>{nextPollFrame_};
+}
+
+std::optional<framenum_t> RtpMixAudioTransport::getNextDispatchFrame() const {
+    {
+        std::lock_guard lock(stateMutex_);
+        if (!started_) {
+            return std::nullopt;
+        }
+    }
+    if (isFinished()) {
+        return std::nullopt;
+    }
+    return nextPollFrame_;
+}
+
+bool RtpMixAudioTransport::isFinished() const {
+    std::shared_ptr<rtp::RtpMixSource> source;
+    {
+        std::lock_guard lock(stateMutex_);
+        if (stopped_) {
+            return true;
+        }
+        if (!started_) {
+            return false;
+        }
+        source = source_;
+    }
+    return source->isDrained();
+}
+
+} // namespace creatures
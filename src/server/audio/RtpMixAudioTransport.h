@@ -0,0 +1,59 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+
+#include "AudioTransport.h"
+#include "server/config.h"
+#include "server/rtp/RtpMixSource.h"
+
+namespace creatures {
+
+/**
+ * RtpMixAudioTransport - an animation's sound as one of the RTP mixer's tracks
+ *
+ * With the mixer on, an animation doesn't take the RTP output for itself.
+ * The loader opens its WAV as a mix source and adds it as a dialog track, so
+ * a bed that's playing ducks under it and keeps going afterwards. The mixer
+ * does the sending; this just lets the PlaybackRunnerEvent wait for the last
+ * frame to go out, and pulls the track when the session stops.
+ */
+class RtpMixAudioTransport : public AudioTransport {
+  public:
+    RtpMixAudioTransport() = default;
+
+    ~RtpMixAudioTransport() override = default;
+
+    /** The source the loader opened for this session. Call before the session starts. */
+    void setSource(std::shared_ptr<rtp::RtpMixSource> source);
+
+    [[nodiscard]] std::shared_ptr<rtp::RtpMixSource> getSource() const;
+
+    Result<void> start(std::shared_ptr<PlaybackSession> session) override;
+
+    void stop() override;
+
+    [[nodiscard]] bool needsPerFrameDispatch() const override { return true; }
+
+    Result<framenum_t> dispatchNextChunk(framenum_t currentFrame) override;
+
+    [[nodiscard]] std::optional<framenum_t> getNextDispatchFrame() const override;
+
+    [[nodiscard]] bool isFinished() const override;
+
+  private:
+    // How often the runner looks to see if the mixer's read the last frame
+    static constexpr framenum_t POLL_FRAMES = RTP_FRAME_MS / EVENT_LOOP_PERIOD_MS;
+
+    // The loader thread sets the source while the event loop may already be
+    // stopping the session, so the source and the start/stop flags share a lock
+    mutable std::mutex stateMutex_;
+    std::shared_ptr<rtp::RtpMixSource> source_;
+    bool started_{false};
+    bool stopped_{false};
+
+    // Event loop only
+    framenum_t nextPollFrame_{0};
+};
+
+} // namespace creatures
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 
 #define DEBUG_DMX_SENDER 0
@@ -21,9 +22,24 @@
 // How many frames should we wait before starting an animation
 #define ANIMATION_DELAY_FRAMES 500
 
+// Playlist events load their next item on these worker threads instead of the event loop. If
+// an event comes up before its item is ready, it tries again this many frames later.
+#define PLAYLIST_PREFETCH_WORKERS 2
+#define PLAYLIST_PREFETCH_RETRY_FRAMES 10
+
 // How many milliseconds per frame? (This should almost always be 1.)
 #define EVENT_LOOP_PERIOD_MS 1
 
+// Each thread that schedules events gets its own lock-free submission ring, which the
+// event loop drains once per frame. A full ring (or running out of rings) falls back to
+// a mutex-protected overflow list, so nothing is ever dropped.
+#define EVENT_SUBMISSION_RING_CAPACITY 1024
+#define EVENT_SUBMISSION_MAX_PRODUCERS 64
+
+// Each websocket client has its own queue of outgoing messages, drained by its own thread.
+// A client that gets this far behind (after dropping stale logs and counters) is hung up on.
+#define WEBSOCKET_CLIENT_QUEUE_DEPTH 512
+
 #define DB_URI_ENV "MONGO_URI"
 #define DEFAULT_DB_URI "mongodb://10.19.63.5/?serverSelectionTimeoutMS=2000"
 #define SERVER_PORT_ENV "SERVER_PORT"
@@ -74,6 +90,34 @@
 #define NETWORK_DEVICE_NAME_ENV "NETWORK_DEVICE_NAME"
 #define DEFAULT_NETWORK_DEVICE_NAME "eth0"
 
+// sACN send-on-change: only put a universe on the wire when its data changes,
+// plus the E1.31 repeats and keep-alives. Saves a lot on big fixture rigs.
+#define SACN_SEND_ON_CHANGE_ENV "SACN_SEND_ON_CHANGE"
+#define DEFAULT_SACN_SEND_ON_CHANGE 0
+#define SACN_KEEP_ALIVE_MS_ENV "SACN_KEEP_ALIVE_MS"
+#define DEFAULT_SACN_KEEP_ALIVE_MS 800
+
+// How often each sACN universe goes out. Creature controllers can take a lot
+// more than the classic DMX 44 Hz. Individual universes can be overridden
+// with a list like "1:250,2:44".
+#define SACN_OUTPUT_RATE_HZ_ENV "SACN_OUTPUT_RATE_HZ"
+#define DEFAULT_SACN_OUTPUT_RATE_HZ 50
+#define SACN_UNIVERSE_RATES_ENV "SACN_UNIVERSE_RATES"
+#define DEFAULT_SACN_UNIVERSE_RATES ""
+
+// What happens when two DMX sources at the same priority drive the same
+// channel: "ltp" (latest takes precedence) or "htp" (highest takes precedence)
+#define SACN_MERGE_MODE_ENV "SACN_MERGE_MODE"
+#define DEFAULT_SACN_MERGE_MODE "ltp"
+
+// Merge priorities for everything that writes DMX. Higher wins. Hold is where a
+// playback or stream leaves its channels when it ends, under everything else.
+#define DMX_PRIORITY_HOLD 0
+#define DMX_PRIORITY_PATTERN 50
+#define DMX_PRIORITY_PLAYBACK 100
+#define DMX_PRIORITY_DIRECT 100
+#define DMX_PRIORITY_LIVE 150
+
 #define VOICE_API_KEY_ENV "VOICE_API_KEY"
 #define DEFAULT_VOICE_API_KEY ""
 
@@ -93,6 +137,10 @@
 #define ADHOC_ANIMATION_TTL_HOURS_ENV "ADHOC_ANIMATION_TTL_HOURS"
 #define DEFAULT_ADHOC_ANIMATION_TTL_HOURS 12
 
+// How much decoded animation to keep in memory for replays (0 turns it off)
+#define ANIMATION_CACHE_MB_ENV "ANIMATION_CACHE_MB"
+#define DEFAULT_ANIMATION_CACHE_MB 128
+
 #define HONEYCOMB_API_KEY_ENV "HONEYCOMB_API_KEY"
 #define DEFAULT_HONEYCOMB_API_KEY ""
 
@@ -102,18 +150,93 @@
 #define EVENT_LOOP_TRACE_SAMPLING_ENV "EVENT_LOOP_TRACE_SAMPLING"
 #define DEFAULT_EVENT_LOOP_TRACE_SAMPLING 0.0005 // 0.05% = 5 in 10000 frames
 
+// How the event loop waits for its next tick. "sleep" is a plain sleep. "hybrid" sleeps to just
+// short of the deadline (an absolute clock_nanosleep), then spins the rest of the way, trading
+// a little CPU for waking up on time.
+#define EVENT_LOOP_SLEEP_MODE_ENV "EVENT_LOOP_SLEEP_MODE"
+#define DEFAULT_EVENT_LOOP_SLEEP_MODE "sleep"
+#define EVENT_LOOP_SPIN_US_ENV "EVENT_LOOP_SPIN_US"
+#define DEFAULT_EVENT_LOOP_SPIN_US 100
+
 // RTP Fragmentation - useful for WiFi and networks without jumbo frame support
 #define RTP_FRAGMENT_PACKETS_ENV "RTP_FRAGMENT_PACKETS"
 #define DEFAULT_RTP_FRAGMENT_PACKETS 0 // Disabled by default (assume jumbo frames)
 
+// How RTP packets get to the network: "sendmmsg" sends every channel's packet for a
+// frame set in one syscall from one socket; "uvgrtp" is a uvgRTP stream per channel.
+#define RTP_BACKEND_ENV "RTP_BACKEND"
+#define DEFAULT_RTP_BACKEND "sendmmsg"
+
+// How RTP frame sets are timed. "event-loop" sends each one when the event loop's 1ms tick gets
+// to it. "paced" has the event loop queue them RTP_PACING_LEAD_MS early and the RTP output thread
+// send each one at its own deadline, worked out from the stream's RTP clock mapping. That thread
+// can run SCHED_FIFO at RTP_PACING_PRIORITY (1-99, which needs CAP_SYS_NICE; 0 leaves it alone).
+// The lead has to be shorter than the decoder priming (RTP_PRIMING_FRAMES frames).
+#define RTP_PACING_ENV "RTP_PACING"
+#define DEFAULT_RTP_PACING "event-loop"
+#define RTP_PACING_LEAD_MS_ENV "RTP_PACING_LEAD_MS"
+#define DEFAULT_RTP_PACING_LEAD_MS 20
+#define RTP_PACING_PRIORITY_ENV "RTP_PACING_PRIORITY"
+#define DEFAULT_RTP_PACING_PRIORITY 0
+
+// Live RTP mixer. With it on, sounds played over RTP are added as tracks to one mix that owns
+// the RTP output, so a music bed and dialog can play at the same time. Bed tracks duck by
+// RTP_MIXER_DUCK_DB while a dialog track is playing; the mix is limited to LIMITER_CEILING_DB.
+#define RTP_MIXER_ENV "RTP_MIXER"
+#define DEFAULT_RTP_MIXER 0
+#define RTP_MIXER_DUCK_DB_ENV "RTP_MIXER_DUCK_DB"
+#define DEFAULT_RTP_MIXER_DUCK_DB -12.0
+#define RTP_MIXER_MAX_TRACKS 8
+#define RTP_MIXER_DUCK_ATTACK_MS 50
+#define RTP_MIXER_DUCK_RELEASE_MS 500
+#define RTP_MIXER_SOURCE_BUFFER_FRAMES 50 // how far (in 10ms frames) a track's reader stays ahead of the mix
+
+// Silent-channel suppression. A channel whose audio has been silent (every sample within
+// RTP_SILENCE_PEAK of zero) for a whole frame after a silent one sends no packet for it, apart
+// from one every RTP_SILENCE_KEEPALIVE_FRAMES (400 ms, as Opus DTX does) so receivers know the
+// stream's still there. The first packet after a gap has the RTP marker bit set. RTP_SEND_SILENCE
+// turns this off, for receivers that can't cope with the gaps.
+#define RTP_SEND_SILENCE_ENV "RTP_SEND_SILENCE"
+#define DEFAULT_RTP_SEND_SILENCE 0
+#define RTP_SILENCE_PEAK 8 // about -72 dBFS, above the dither in a silent 16-bit WAV
+#define RTP_SILENCE_KEEPALIVE_FRAMES 40
+
 // Cooperative animation RTP audio loader. Main production servers have enough
-// CPU/RAM to keep several cache-hit loads resident; cache-miss encoding still
-// has its own single-flight gate because each file fans out to 17 Opus workers.
+// CPU/RAM to keep several cache-hit loads resident; cache-miss encoding is
+// bounded by the compute pool below, not by the number of loaders.
 #define RTP_AUDIO_LOAD_WORKERS_ENV "RTP_AUDIO_LOAD_WORKERS"
 #define DEFAULT_RTP_AUDIO_LOAD_WORKERS 4
 #define RTP_AUDIO_LOAD_QUEUE_CAPACITY_ENV "RTP_AUDIO_LOAD_QUEUE_CAPACITY"
 #define DEFAULT_RTP_AUDIO_LOAD_QUEUE_CAPACITY 64
 
+// On a cache miss, RTP playback starts once this much of the file is Opus-encoded;
+// the rest is encoded in the background, ahead of the playhead
+#define RTP_ENCODE_LEAD_MS_ENV "RTP_ENCODE_LEAD_MS"
+#define DEFAULT_RTP_ENCODE_LEAD_MS 200
+
+// In RTP mode every sound the animations use is Opus-encoded into the audio cache in the
+// background, at this nice level and on at most this many cores (0 turns it off)
+#define AUDIO_PREWARM_NICE_ENV "AUDIO_PREWARM_NICE"
+#define DEFAULT_AUDIO_PREWARM_NICE 10
+#define AUDIO_PREWARM_CORES_ENV "AUDIO_PREWARM_CORES"
+#define DEFAULT_AUDIO_PREWARM_CORES 2
+
+// CPU-heavy audio work (Opus, MP3 and Ogg encoding) runs on one pool of threads pinned to these
+// CPUs, a list like "2-15". Left empty it's every CPU but the first COMPUTE_POOL_RESERVED_CPUS,
+// which are kept for the event loop and the RTP sender (on machines with CPUs to spare).
+// 0 threads means one per CPU.
+#define COMPUTE_POOL_CPUS_ENV "COMPUTE_POOL_CPUS"
+#define DEFAULT_COMPUTE_POOL_CPUS ""
+#define COMPUTE_POOL_THREADS_ENV "COMPUTE_POOL_THREADS"
+#define DEFAULT_COMPUTE_POOL_THREADS 0
+#define COMPUTE_POOL_RESERVED_CPUS 2
+
+// The event loop and the RTP output worker are pinned to these CPUs, a list like "0-1". Left
+// empty it's the first COMPUTE_POOL_RESERVED_CPUS (on machines with CPUs to spare; otherwise
+// they run wherever the scheduler puts them).
+#define REALTIME_CPUS_ENV "REALTIME_CPUS"
+#define DEFAULT_REALTIME_CPUS ""
+
 #define SOUND_BUFFER_SIZE 2048 // Higher = less CPU, lower = less latency
 
 #define STREAMING_TIMEOUT_FRAMES_ENV "STREAMING_TIMEOUT_FRAMES"
@@ -166,6 +289,8 @@ static constexpr int RTP_PCM_BYTES = RTP_SAMPLES * sizeof(int16_t) * RTP_STREAMI
 static constexpr int RTP_STANDARD_MTU_PAYLOAD = 1452; // Standard ethernet MTU minus IP/UDP/RTP headers
 static constexpr int RTP_OPUS_PAYLOAD_PT = 96;        // dynamic PT we’ll advertise
 static constexpr int RTP_BITRATE = 256000;            // 256 kbps for Opus (super quality)
+static constexpr std::size_t RTP_ENCODE_CHUNK_FRAMES = 20; // 200 ms of audio per progressive encode step
+static constexpr std::size_t RTP_MAX_FRAMES_PER_CHANNEL = 1000000; // Longest sound, about 2.8 hours of frames
 
 // One multicast group per channel: 239.19.63.[1-17]
 inline constexpr std::array<const char *, RTP_STREAMING_CHANNELS> RTP_GROUPS = {
@@ -11,6 +11,7 @@
 #include <string>
 #include <system_error>
 #include <utility>
+#include <vector>
 
 #include <argparse/argparse.hpp>
 #include <fmt/format.h>
@@ -24,6 +25,7 @@
 #include "server/audio/NativeAudioConfig.h"
 #include "server/config.h"
 #include "server/namespace-stuffs.h"
+#include "util/ComputePool.h"
 #include "util/environment.h"
 
 /*
@@ -110,6 +112,33 @@ std::shared_ptr<Configuration> CommandLine::parseCommandLine(int argc, char **ar
         .default_value(environmentToString(NETWORK_DEVICE_NAME_ENV, DEFAULT_NETWORK_DEVICE_NAME))
         .nargs(1);
 
+    program.add_argument("--sacn-send-on-change")
+        .help("only send sACN universes when their data changes, plus E1.31 keep-alives")
+        .default_value(environmentToInt(SACN_SEND_ON_CHANGE_ENV, DEFAULT_SACN_SEND_ON_CHANGE) == 1)
+        .implicit_value(true);
+
+    program.add_argument("--sacn-keep-alive-ms")
+        .help("how often an unchanged sACN universe is refreshed in send-on-change mode")
+        .default_value(environmentToInt(SACN_KEEP_ALIVE_MS_ENV, DEFAULT_SACN_KEEP_ALIVE_MS))
+        .scan<'i', int>()
+        .nargs(1);
+
+    program.add_argument("--sacn-output-rate-hz")
+        .help("how often each sACN universe is sent")
+        .default_value(environmentToInt(SACN_OUTPUT_RATE_HZ_ENV, DEFAULT_SACN_OUTPUT_RATE_HZ))
+        .scan<'i', int>()
+        .nargs(1);
+
+    program.add_argument("--sacn-universe-rates")
+        .help("per-universe sACN output rates, like \"1:250,2:44\"")
+        .default_value(environmentToString(SACN_UNIVERSE_RATES_ENV, DEFAULT_SACN_UNIVERSE_RATES))
+        .nargs(1);
+
+    program.add_argument("--sacn-merge-mode")
+        .help("how DMX sources at the same priority are merged: ltp or htp")
+        .default_value(environmentToString(SACN_MERGE_MODE_ENV, DEFAULT_SACN_MERGE_MODE))
+        .nargs(1);
+
     program.add_argument("-v", "--voice-api-key")
         .help("ElevenLabs API key")
         .default_value(environmentToString(VOICE_API_KEY_ENV, DEFAULT_VOICE_API_KEY))
@@ -146,6 +175,17 @@ std::shared_ptr<Configuration> CommandLine::parseCommandLine(int argc, char **ar
         .scan<'g', double>()
         .nargs(1);
 
+    program.add_argument("--event-loop-sleep-mode")
+        .help("how the event loop waits for its next tick: 'sleep' or 'hybrid' (sleep, then spin to the deadline)")
+        .default_value(environmentToString(EVENT_LOOP_SLEEP_MODE_ENV, DEFAULT_EVENT_LOOP_SLEEP_MODE))
+        .nargs(1);
+
+    program.add_argument("--event-loop-spin-us")
+        .help("microseconds before each tick's deadline that the hybrid sleep mode starts spinning")
+        .default_value(environmentToInt(EVENT_LOOP_SPIN_US_ENV, DEFAULT_EVENT_LOOP_SPIN_US))
+        .scan<'i', int>()
+        .nargs(1);
+
     program.add_argument("--streaming-timeout-frames")
         .help("number of 1ms frames to wait before marking streaming as stopped")
         .default_value(environmentToInt(STREAMING_TIMEOUT_FRAMES_ENV, DEFAULT_STREAMING_TIMEOUT_FRAMES))
@@ -157,6 +197,45 @@ std::shared_ptr<Configuration> CommandLine::parseCommandLine(int argc, char **ar
         .default_value(environmentToInt(RTP_FRAGMENT_PACKETS_ENV, DEFAULT_RTP_FRAGMENT_PACKETS) == 1)
         .implicit_value(true);
 
+    program.add_argument("--rtp-backend")
+        .help("how RTP packets are sent: 'sendmmsg' (one syscall per frame set) or 'uvgrtp' (a stream per channel)")
+        .default_value(environmentToString(RTP_BACKEND_ENV, DEFAULT_RTP_BACKEND))
+        .nargs(1);
+
+    program.add_argument("--rtp-pacing")
+        .help("what times RTP frame sets: 'event-loop' (its 1ms tick) or 'paced' (a deadline per frame set on the "
+              "RTP output thread)")
+        .default_value(environmentToString(RTP_PACING_ENV, DEFAULT_RTP_PACING))
+        .nargs(1);
+
+    program.add_argument("--rtp-pacing-lead-ms")
+        .help("with --rtp-pacing paced, how far ahead the event loop queues frame sets")
+        .default_value(environmentToInt(RTP_PACING_LEAD_MS_ENV, DEFAULT_RTP_PACING_LEAD_MS))
+        .scan<'i', int>()
+        .nargs(1);
+
+    program.add_argument("--rtp-pacing-priority")
+        .help("with --rtp-pacing paced, the SCHED_FIFO priority (1-99) for the RTP output thread, or 0 for none")
+        .default_value(environmentToInt(RTP_PACING_PRIORITY_ENV, DEFAULT_RTP_PACING_PRIORITY))
+        .scan<'i', int>()
+        .nargs(1);
+
+    program.add_argument("--rtp-mixer")
+        .help("mix sounds into the RTP output instead of each one taking it over")
+        .default_value(environmentToInt(RTP_MIXER_ENV, DEFAULT_RTP_MIXER) == 1)
+        .implicit_value(true);
+
+    program.add_argument("--rtp-mixer-duck-db")
+        .help("with --rtp-mixer, how far to duck music under dialog in dB (-90 to 0)")
+        .default_value(environmentToDouble(RTP_MIXER_DUCK_DB_ENV, DEFAULT_RTP_MIXER_DUCK_DB))
+        .scan<'g', double>()
+        .nargs(1);
+
+    program.add_argument("--rtp-send-silence")
+        .help("send every RTP packet, instead of leaving out silent channels' between keepalives")
+        .default_value(environmentToInt(RTP_SEND_SILENCE_ENV, DEFAULT_RTP_SEND_SILENCE) == 1)
+        .implicit_value(true);
+
     program.add_argument("--rtp-audio-load-workers")
         .help("fixed worker count for cooperative RTP WAV/cache loads")
         .default_value(environmentToInt(RTP_AUDIO_LOAD_WORKERS_ENV, DEFAULT_RTP_AUDIO_LOAD_WORKERS))
@@ -169,6 +248,42 @@ std::shared_ptr<Configuration> CommandLine::parseCommandLine(int argc, char **ar
         .scan<'i', int>()
         .nargs(1);
 
+    program.add_argument("--rtp-encode-lead-ms")
+        .help("on a cache miss, how much audio to Opus-encode before RTP playback starts")
+        .default_value(environmentToInt(RTP_ENCODE_LEAD_MS_ENV, DEFAULT_RTP_ENCODE_LEAD_MS))
+        .scan<'i', int>()
+        .nargs(1);
+
+    program.add_argument("--audio-prewarm-nice")
+        .help("nice level (0-19) for encoding every animation's sound into the audio cache in the background")
+        .default_value(environmentToInt(AUDIO_PREWARM_NICE_ENV, DEFAULT_AUDIO_PREWARM_NICE))
+        .scan<'i', int>()
+        .nargs(1);
+
+    program.add_argument("--audio-prewarm-cores")
+        .help("most cores the background audio cache encoding may use (0 turns it off)")
+        .default_value(environmentToInt(AUDIO_PREWARM_CORES_ENV, DEFAULT_AUDIO_PREWARM_CORES))
+        .scan<'i', int>()
+        .nargs(1);
+
+    program.add_argument("--compute-pool-cpus")
+        .help("CPUs (like 2-15) for Opus/MP3/Ogg encoding; by default all but the first " +
+              std::to_string(COMPUTE_POOL_RESERVED_CPUS) + ", which are left to the event loop and RTP")
+        .default_value(environmentToString(COMPUTE_POOL_CPUS_ENV, DEFAULT_COMPUTE_POOL_CPUS))
+        .nargs(1);
+
+    program.add_argument("--compute-pool-threads")
+        .help("threads for Opus/MP3/Ogg encoding (0 for one per compute pool CPU)")
+        .default_value(environmentToInt(COMPUTE_POOL_THREADS_ENV, DEFAULT_COMPUTE_POOL_THREADS))
+        .scan<'i', int>()
+        .nargs(1);
+
+    program.add_argument("--realtime-cpus")
+        .help("CPUs (like 0-1) to pin the event loop and RTP output worker to; by default the first " +
+              std::to_string(COMPUTE_POOL_RESERVED_CPUS))
+        .default_value(environmentToString(REALTIME_CPUS_ENV, DEFAULT_REALTIME_CPUS))
+        .nargs(1);
+
     auto &oneShots = program.add_mutually_exclusive_group();
     oneShots.add_argument("--list-sound-devices")
         .help("list available sound devices and exit")
@@ -217,6 +332,12 @@ std::shared_ptr<Configuration> CommandLine::parseCommandLine(int argc, char **ar
         .scan<'i', int>()
         .nargs(1);
 
+    program.add_argument("--animation-cache-mb")
+        .help("megabytes of decoded animations to keep in memory for replays (0 to turn off)")
+        .default_value(environmentToInt(ANIMATION_CACHE_MB_ENV, DEFAULT_ANIMATION_CACHE_MB))
+        .scan<'i', int>()
+        .nargs(1);
+
     program.add_description("Creature Server for April's Creature Workshop\n\n"
                             "This application is the heart of my creature magic. It contains a websocket-based\n"
                             "server as well as the event loop that schedules events to happen in real time.");
@@ -285,6 +406,57 @@ std::shared_ptr<Configuration> CommandLine::parseCommandLine(int argc, char **ar
     config->setRtpFragmentPackets(rtpFragment);
     debug("RTP packet fragmentation: {}", rtpFragment ? "enabled" : "disabled");
 
+    std::string rtpBackend = program.get<std::string>("--rtp-backend");
+    std::transform(rtpBackend.begin(), rtpBackend.end(), rtpBackend.begin(),
+                   [](unsigned char character) { return static_cast<char>(std::tolower(character)); });
+    if (rtpBackend != "sendmmsg" && rtpBackend != "uvgrtp") {
+        critical("--rtp-backend must be 'sendmmsg' or 'uvgrtp'");
+        std::exit(1);
+    }
+    config->setRtpBackend(rtpBackend == "uvgrtp" ? Configuration::RtpBackend::UvgRtp
+                                                 : Configuration::RtpBackend::Sendmmsg);
+    debug("RTP backend: {}", rtpBackend);
+
+    std::string rtpPacing = program.get<std::string>("--rtp-pacing");
+    std::transform(rtpPacing.begin(), rtpPacing.end(), rtpPacing.begin(),
+                   [](unsigned char character) { return static_cast<char>(std::tolower(character)); });
+    if (rtpPacing != "event-loop" && rtpPacing != "paced") {
+        critical("--rtp-pacing must be 'event-loop' or 'paced'");
+        std::exit(1);
+    }
+    config->setRtpPacing(rtpPacing == "paced" ? Configuration::RtpPacing::Paced : Configuration::RtpPacing::EventLoop);
+
+    // Frame sets queued any earlier than this could get ahead of the decoder priming's silence
+    constexpr int maximumPacingLeadMs = RTP_PRIMING_FRAMES * RTP_FRAME_MS - 1;
+    const auto rtpPacingLeadMs = program.get<int>("--rtp-pacing-lead-ms");
+    if (rtpPacingLeadMs < 0 || rtpPacingLeadMs > maximumPacingLeadMs) {
+        critical("--rtp-pacing-lead-ms must be between 0 and {}", maximumPacingLeadMs);
+        std::exit(1);
+    }
+    config->setRtpPacingLeadMs(static_cast<uint32_t>(rtpPacingLeadMs));
+
+    const auto rtpPacingPriority = program.get<int>("--rtp-pacing-priority");
+    if (rtpPacingPriority < 0 || rtpPacingPriority > 99) {
+        critical("--rtp-pacing-priority must be between 0 and 99");
+        std::exit(1);
+    }
+    config->setRtpPacingPriority(rtpPacingPriority);
+    debug("RTP pacing: {} (lead {}ms, SCHED_FIFO priority {})", rtpPacing, rtpPacingLeadMs, rtpPacingPriority);
+
+    const auto rtpMixer = program.get<bool>("--rtp-mixer");
+    const auto rtpMixerDuckDb = program.get<double>("--rtp-mixer-duck-db");
+    if (!std::isfinite(rtpMixerDuckDb) || rtpMixerDuckDb < audio::MIN_AUDIO_GAIN_DB || rtpMixerDuckDb > 0.0) {
+        critical("--rtp-mixer-duck-db must be finite and between -90 and 0");
+        std::exit(1);
+    }
+    config->setRtpMixer(rtpMixer);
+    config->setRtpMixerDuckDb(static_cast<float>(rtpMixerDuckDb));
+    debug("RTP mixer: {} (ducking {}dB)", rtpMixer, rtpMixerDuckDb);
+
+    auto rtpSendSilence = program.get<bool>("--rtp-send-silence");
+    config->setRtpSendSilence(rtpSendSilence);
+    debug("RTP silent-channel suppression: {}", !rtpSendSilence);
+
     auto rtpAudioLoadWorkers = program.get<int>("--rtp-audio-load-workers");
     const bool rtpAudioLoadWorkersOverridden =
         program.is_used("--rtp-audio-load-workers") || std::getenv(RTP_AUDIO_LOAD_WORKERS_ENV) != nullptr;
@@ -308,6 +480,109 @@ std::shared_ptr<Configuration> CommandLine::parseCommandLine(int argc, char **ar
     debug("RTP audio loader configured with {} workers and {} queued jobs", rtpAudioLoadWorkers,
           rtpAudioLoadQueueCapacity);
 
+    auto rtpEncodeLeadMs = program.get<int>("--rtp-encode-lead-ms");
+    if (rtpEncodeLeadMs < RTP_FRAME_MS || rtpEncodeLeadMs > 60000) {
+        critical("--rtp-encode-lead-ms must be between {} and 60000", RTP_FRAME_MS);
+        std::exit(1);
+    }
+    config->setRtpEncodeLeadMs(static_cast<uint32_t>(rtpEncodeLeadMs));
+
+    auto audioPrewarmNice = program.get<int>("--audio-prewarm-nice");
+    if (audioPrewarmNice < 0 || audioPrewarmNice > 19) {
+        critical("--audio-prewarm-nice must be between 0 and 19");
+        std::exit(1);
+    }
+    config->setAudioPrewarmNice(audioPrewarmNice);
+
+    auto audioPrewarmCores = program.get<int>("--audio-prewarm-cores");
+    if (audioPrewarmCores < 0 || audioPrewarmCores > 1024) {
+        critical("--audio-prewarm-cores must be between 0 and 1024");
+        std::exit(1);
+    }
+    config->setAudioPrewarmCores(static_cast<uint32_t>(audioPrewarmCores));
+
+    if (const auto computePoolCpus = program.get<std::string>("--compute-pool-cpus"); !computePoolCpus.empty()) {
+        const auto parsedCpus = util::ComputePool::parseCpuList(computePoolCpus);
+        if (!parsedCpus.isSuccess()) {
+            critical("--compute-pool-cpus: {}", parsedCpus.getError()->getMessage());
+            std::exit(1);
+        }
+        config->setComputePoolCpus(parsedCpus.getValue().value());
+    }
+
+    auto computePoolThreads = program.get<int>("--compute-pool-threads");
+    if (computePoolThreads < 0 || computePoolThreads > 1024) {
+        critical("--compute-pool-threads must be between 0 and 1024");
+        std::exit(1);
+    }
+    config->setComputePoolThreads(static_cast<uint32_t>(computePoolThreads));
+
+    if (const auto realtimeCpus = program.get<std::string>("--realtime-cpus"); !realtimeCpus.empty()) {
+        const auto parsedCpus = util::ComputePool::parseCpuList(realtimeCpus);
+        if (!parsedCpus.isSuccess()) {
+            critical("--realtime-cpus: {}", parsedCpus.getError()->getMessage());
+            std::exit(1);
+        }
+        config->setRealtimeCpus(parsedCpus.getValue().value());
+    }
+
+    // sACN output. Receivers time out after 2.5s without a packet, so keep
+    // the keep-alive comfortably under that.
+    const bool sacnSendOnChange = program.get<bool>("--sacn-send-on-change");
+    config->setSacnSendOnChange(sacnSendOnChange);
+    auto sacnKeepAliveMs = program.get<int>("--sacn-keep-alive-ms");
+    if (sacnKeepAliveMs < 100 || sacnKeepAliveMs > 1000) {
+        critical("--sacn-keep-alive-ms must be between 100 and 1000");
+        std::exit(1);
+    }
+    config->setSacnKeepAliveMs(static_cast<uint32_t>(sacnKeepAliveMs));
+    debug("sACN send-on-change: {} (keep-alive {}ms)", sacnSendOnChange ? "enabled" : "disabled", sacnKeepAliveMs);
+
+    auto sacnOutputRateHz = program.get<int>("--sacn-output-rate-hz");
+    if (sacnOutputRateHz < 1 || sacnOutputRateHz > 1000) {
+        critical("--sacn-output-rate-hz must be between 1 and 1000");
+        std::exit(1);
+    }
+    config->setSacnOutputRateHz(static_cast<uint32_t>(sacnOutputRateHz));
+
+    std::vector<std::pair<uint16_t, uint32_t>> sacnUniverseRates;
+    const auto universeRates = program.get<std::string>("--sacn-universe-rates");
+    size_t start = 0;
+    while (start < universeRates.size()) {
+        size_t end = universeRates.find(',', start);
+        if (end == std::string::npos) {
+            end = universeRates.size();
+        }
+        const std::string entry = universeRates.substr(start, end - start);
+        start = end + 1;
+        if (entry.empty()) {
+            continue;
+        }
+
+        unsigned int universe = 0;
+        unsigned int hz = 0;
+        int consumed = 0;
+        if (std::sscanf(entry.c_str(), "%u:%u%n", &universe, &hz, &consumed) != 2 ||
+            consumed != static_cast<int>(entry.size()) || universe < 1 || universe > 63999 || hz < 1 || hz > 1000) {
+            critical("--sacn-universe-rates entry '{}' must look like universe:hz (1-63999, 1-1000 Hz)", entry);
+            std::exit(1);
+        }
+        sacnUniverseRates.emplace_back(static_cast<uint16_t>(universe), static_cast<uint32_t>(hz));
+    }
+    config->setSacnUniverseRates(sacnUniverseRates);
+
+    std::string sacnMergeMode = program.get<std::string>("--sacn-merge-mode");
+    std::transform(sacnMergeMode.begin(), sacnMergeMode.end(), sacnMergeMode.begin(),
+                   [](unsigned char character) { return static_cast<char>(std::tolower(character)); });
+    if (sacnMergeMode != "ltp" && sacnMergeMode != "htp") {
+        critical("--sacn-merge-mode must be 'ltp' or 'htp'");
+        std::exit(1);
+    }
+    config->setSacnMergeMode(sacnMergeMode == "htp" ? Configuration::SacnMergeMode::HTP
+                                                    : Configuration::SacnMergeMode::LTP);
+    debug("sACN output at {}Hz ({} universe overrides), {} merge", sacnOutputRateHz, sacnUniverseRates.size(),
+          sacnMergeMode);
+
     // Animation delay for audio sync compensation
     auto animationDelayMs = program.get<int>("--animation-delay-ms");
     if (animationDelayMs < 0) {
@@ -335,6 +610,14 @@ std::shared_ptr<Configuration> CommandLine::parseCommandLine(int argc, char **ar
     config->setAdHocAnimationTtlHours(static_cast<uint32_t>(adHocTtlHours));
     debug("ad-hoc animation TTL set to {} hours", adHocTtlHours);
 
+    auto animationCacheMb = program.get<int>("--animation-cache-mb");
+    if (animationCacheMb < 0) {
+        critical("--animation-cache-mb can't be negative");
+        std::exit(1);
+    }
+    config->setAnimationCacheMb(static_cast<uint32_t>(animationCacheMb));
+    debug("animation cache set to {}MB", animationCacheMb);
+
     // Set the GPIO usage
     auto useGPIO = program.get<bool>("-g");
     debug("read use GPIO {} from command line", useGPIO);
@@ -445,6 +728,24 @@ std::shared_ptr<Configuration> CommandLine::parseCommandLine(int argc, char **ar
     config->setEventLoopTraceSampling(eventLoopTraceSampling);
     debug("set event loop trace sampling rate to {}", eventLoopTraceSampling);
 
+    std::string eventLoopSleepMode = program.get<std::string>("--event-loop-sleep-mode");
+    std::transform(eventLoopSleepMode.begin(), eventLoopSleepMode.end(), eventLoopSleepMode.begin(),
+                   [](unsigned char character) { return static_cast<char>(std::tolower(character)); });
+    if (eventLoopSleepMode != "sleep" && eventLoopSleepMode != "hybrid") {
+        critical("--event-loop-sleep-mode must be 'sleep' or 'hybrid'");
+        std::exit(1);
+    }
+    config->setEventLoopSleepMode(eventLoopSleepMode == "hybrid" ? Configuration::EventLoopSleepMode::Hybrid
+                                                                 : Configuration::EventLoopSleepMode::Sleep);
+
+    auto eventLoopSpinUs = program.get<int>("--event-loop-spin-us");
+    if (eventLoopSpinUs < 0 || eventLoopSpinUs >= EVENT_LOOP_PERIOD_MS * 1000) {
+        critical("--event-loop-spin-us must be between 0 and {}", EVENT_LOOP_PERIOD_MS * 1000 - 1);
+        std::exit(1);
+    }
+    config->setEventLoopSpinUs(static_cast<uint32_t>(eventLoopSpinUs));
+    debug("event loop will wait with '{}' ({}us spin)", eventLoopSleepMode, eventLoopSpinUs);
+
     auto whisperModelPath = program.get<std::string>("--whisper-model-path");
     if (!whisperModelPath.empty()) {
         config->setWhisperModelPath(whisperModelPath);
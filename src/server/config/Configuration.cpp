@@ -65,6 +65,34 @@ bool Configuration::getRtpFragmentPackets() const { return this->rtpFragmentPack
 
 void Configuration::setRtpFragmentPackets(const bool _fragmentPackets) { this->rtpFragmentPackets = _fragmentPackets; }
 
+Configuration::RtpBackend Configuration::getRtpBackend() const { return this->rtpBackend; }
+
+void Configuration::setRtpBackend(const RtpBackend _backend) { this->rtpBackend = _backend; }
+
+Configuration::RtpPacing Configuration::getRtpPacing() const { return this->rtpPacing; }
+
+void Configuration::setRtpPacing(const RtpPacing _pacing) { this->rtpPacing = _pacing; }
+
+uint32_t Configuration::getRtpPacingLeadMs() const { return this->rtpPacingLeadMs; }
+
+void Configuration::setRtpPacingLeadMs(const uint32_t _leadMs) { this->rtpPacingLeadMs = _leadMs; }
+
+int Configuration::getRtpPacingPriority() const { return this->rtpPacingPriority; }
+
+void Configuration::setRtpPacingPriority(const int _priority) { this->rtpPacingPriority = _priority; }
+
+bool Configuration::getRtpMixer() const { return this->rtpMixer; }
+
+void Configuration::setRtpMixer(const bool _mixer) { this->rtpMixer = _mixer; }
+
+float Configuration::getRtpMixerDuckDb() const { return this->rtpMixerDuckDb; }
+
+void Configuration::setRtpMixerDuckDb(const float _duckDb) { this->rtpMixerDuckDb = _duckDb; }
+
+bool Configuration::getRtpSendSilence() const { return this->rtpSendSilence; }
+
+void Configuration::setRtpSendSilence(const bool _sendSilence) { this->rtpSendSilence = _sendSilence; }
+
 uint32_t Configuration::getRtpAudioLoadWorkers() const { return this->rtpAudioLoadWorkers; }
 
 void Configuration::setRtpAudioLoadWorkers(const uint32_t _workers) { this->rtpAudioLoadWorkers = _workers; }
@@ -75,12 +103,60 @@ void Configuration::setRtpAudioLoadQueueCapacity(const uint32_t _capacity) {
     this->rtpAudioLoadQueueCapacity = _capacity;
 }
 
+uint32_t Configuration::getRtpEncodeLeadMs() const { return this->rtpEncodeLeadMs; }
+
+void Configuration::setRtpEncodeLeadMs(const uint32_t _leadMs) { this->rtpEncodeLeadMs = _leadMs; }
+
+int Configuration::getAudioPrewarmNice() const { return this->audioPrewarmNice; }
+
+void Configuration::setAudioPrewarmNice(const int _niceLevel) { this->audioPrewarmNice = _niceLevel; }
+
+uint32_t Configuration::getAudioPrewarmCores() const { return this->audioPrewarmCores; }
+
+void Configuration::setAudioPrewarmCores(const uint32_t _cores) { this->audioPrewarmCores = _cores; }
+
+std::vector<int> Configuration::getComputePoolCpus() const { return this->computePoolCpus; }
+
+void Configuration::setComputePoolCpus(std::vector<int> _cpus) { this->computePoolCpus = std::move(_cpus); }
+
+uint32_t Configuration::getComputePoolThreads() const { return this->computePoolThreads; }
+
+void Configuration::setComputePoolThreads(const uint32_t _threads) { this->computePoolThreads = _threads; }
+
+std::vector<int> Configuration::getRealtimeCpus() const { return this->realtimeCpus; }
+
+void Configuration::setRealtimeCpus(std::vector<int> _cpus) { this->realtimeCpus = std::move(_cpus); }
+
 // Network Configuration
 
 uint16_t Configuration::getNetworkDevice() const { return this->networkDevice; }
 
 void Configuration::setNetworkDevice(const uint16_t _networkDevice) { this->networkDevice = _networkDevice; }
 
+bool Configuration::getSacnSendOnChange() const { return this->sacnSendOnChange; }
+
+void Configuration::setSacnSendOnChange(const bool _sendOnChange) { this->sacnSendOnChange = _sendOnChange; }
+
+uint32_t Configuration::getSacnKeepAliveMs() const { return this->sacnKeepAliveMs; }
+
+void Configuration::setSacnKeepAliveMs(const uint32_t _keepAliveMs) { this->sacnKeepAliveMs = _keepAliveMs; }
+
+uint32_t Configuration::getSacnOutputRateHz() const { return this->sacnOutputRateHz; }
+
+void Configuration::setSacnOutputRateHz(const uint32_t _outputRateHz) { this->sacnOutputRateHz = _outputRateHz; }
+
+std::vector<std::pair<uint16_t, uint32_t>> Configuration::getSacnUniverseRates() const {
+    return this->sacnUniverseRates;
+}
+
+void Configuration::setSacnUniverseRates(std::vector<std::pair<uint16_t, uint32_t>> _universeRates) {
+    this->sacnUniverseRates = std::move(_universeRates);
+}
+
+Configuration::SacnMergeMode Configuration::getSacnMergeMode() const { return this->sacnMergeMode; }
+
+void Configuration::setSacnMergeMode(const SacnMergeMode _mergeMode) { this->sacnMergeMode = _mergeMode; }
+
 // External API Configuration
 
 std::string Configuration::getVoiceApiKey() const { return this->voiceApiKey; }
@@ -109,6 +185,14 @@ void Configuration::setEventLoopTraceSampling(const double _eventLoopTraceSampli
     this->eventLoopTraceSampling = _eventLoopTraceSampling;
 }
 
+Configuration::EventLoopSleepMode Configuration::getEventLoopSleepMode() const { return this->eventLoopSleepMode; }
+
+void Configuration::setEventLoopSleepMode(const EventLoopSleepMode _sleepMode) { this->eventLoopSleepMode = _sleepMode; }
+
+uint32_t Configuration::getEventLoopSpinUs() const { return this->eventLoopSpinUs; }
+
+void Configuration::setEventLoopSpinUs(const uint32_t _spinUs) { this->eventLoopSpinUs = _spinUs; }
+
 // Animation Scheduler Configuration
 
 uint32_t Configuration::getAnimationDelayMs() const { return this->animationDelayMs; }
@@ -119,6 +203,10 @@ uint32_t Configuration::getAdHocAnimationTtlHours() const { return this->adHocAn
 
 void Configuration::setAdHocAnimationTtlHours(const uint32_t _ttlHours) { this->adHocAnimationTtlHours = _ttlHours; }
 
+uint32_t Configuration::getAnimationCacheMb() const { return this->animationCacheMb; }
+
+void Configuration::setAnimationCacheMb(const uint32_t _cacheMb) { this->animationCacheMb = _cacheMb; }
+
 uint32_t Configuration::getStreamingTimeoutFrames() const { return this->streamingTimeoutFrames; }
 
 void Configuration::setStreamingTimeoutFrames(const uint32_t _timeoutFrames) {
@@ -2,6 +2,8 @@
 
 #include <optional>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "server/config.h"
 
@@ -30,6 +32,42 @@ class Configuration {
         RTP    ///< Stream audio via RTP multicast
     };
 
+    /**
+     * @enum SacnMergeMode
+     * @brief How two DMX sources at the same priority on the same channel are merged
+     */
+    enum class SacnMergeMode {
+        LTP, ///< Latest takes precedence
+        HTP  ///< Highest takes precedence
+    };
+
+    /**
+     * @enum EventLoopSleepMode
+     * @brief How the event loop waits for its next tick
+     */
+    enum class EventLoopSleepMode {
+        Sleep, ///< Sleep until the deadline
+        Hybrid ///< Sleep until just before the deadline, then spin
+    };
+
+    /**
+     * @enum RtpBackend
+     * @brief How RTP packets are put on the wire
+     */
+    enum class RtpBackend {
+        Sendmmsg, ///< Every channel's packet in one sendmmsg() per frame set
+        UvgRtp    ///< A uvgRTP session per channel
+    };
+
+    /**
+     * @enum RtpPacing
+     * @brief What decides when each RTP frame set goes out
+     */
+    enum class RtpPacing {
+        EventLoop, ///< The event loop's tick that queues it
+        Paced      ///< Its own deadline, on the RTP output thread
+    };
+
     /** CommandLine class is allowed to modify configuration settings */
     friend class CommandLine;
 
@@ -68,15 +106,69 @@ class Configuration {
     /** @return True if RTP packets should be fragmented for standard MTU networks */
     bool getRtpFragmentPackets() const;
 
+    /** @return How RTP packets are put on the wire */
+    RtpBackend getRtpBackend() const;
+
+    /** @return What decides when each RTP frame set goes out */
+    RtpPacing getRtpPacing() const;
+
+    /** @return How far ahead (ms) the event loop queues frame sets when they're paced */
+    uint32_t getRtpPacingLeadMs() const;
+
+    /** @return SCHED_FIFO priority for the pacing thread, 0 for a normal thread */
+    int getRtpPacingPriority() const;
+
+    /** @return True if sounds are mixed into the RTP output rather than each taking it over */
+    bool getRtpMixer() const;
+
+    /** @return How far (dB) the mixer ducks Bed tracks while dialog is playing */
+    float getRtpMixerDuckDb() const;
+
+    /** @return True if silent RTP channels still send every packet */
+    bool getRtpSendSilence() const;
+
     /** @return Number of fixed workers used for cooperative RTP audio loads */
     uint32_t getRtpAudioLoadWorkers() const;
 
     /** @return Maximum number of cooperative RTP audio loads waiting for a worker */
     uint32_t getRtpAudioLoadQueueCapacity() const;
 
+    /** @return How much audio (ms) to encode on a cache miss before RTP playback starts */
+    uint32_t getRtpEncodeLeadMs() const;
+
+    /** @return Nice level the background audio cache prewarmer runs at */
+    int getAudioPrewarmNice() const;
+
+    /** @return Most cores the background audio cache prewarmer may use (0 means it's off) */
+    uint32_t getAudioPrewarmCores() const;
+
+    /** @return CPUs the compute pool is pinned to (empty means all but the reserved ones) */
+    std::vector<int> getComputePoolCpus() const;
+
+    /** @return Threads in the compute pool (0 means one per CPU it's pinned to) */
+    uint32_t getComputePoolThreads() const;
+
+    /** @return CPUs the event loop and RTP output worker are pinned to (empty means the reserved ones) */
+    std::vector<int> getRealtimeCpus() const;
+
     /** @return Network interface device ID for E1.31 communication */
     uint16_t getNetworkDevice() const;
 
+    /** @return True if sACN universes are only sent when their data changes (plus keep-alives) */
+    bool getSacnSendOnChange() const;
+
+    /** @return Keep-alive interval in milliseconds for unchanged universes in send-on-change mode */
+    uint32_t getSacnKeepAliveMs() const;
+
+    /** @return How often each sACN universe is sent, in Hz, unless overridden */
+    uint32_t getSacnOutputRateHz() const;
+
+    /** @return Per-universe output rate overrides as (universe, Hz) pairs */
+    std::vector<std::pair<uint16_t, uint32_t>> getSacnUniverseRates() const;
+
+    /** @return Merge mode for DMX sources at the same priority */
+    SacnMergeMode getSacnMergeMode() const;
+
     /** @return API key for voice synthesis service */
     std::string getVoiceApiKey() const;
 
@@ -89,12 +181,21 @@ class Configuration {
     /** @return Sampling rate for event loop tracing (0.0 to 1.0) */
     double getEventLoopTraceSampling() const;
 
+    /** @return How the event loop waits for its next tick */
+    EventLoopSleepMode getEventLoopSleepMode() const;
+
+    /** @return How long before a tick's deadline the hybrid sleep mode starts spinning, in microseconds */
+    uint32_t getEventLoopSpinUs() const;
+
     /** @return Animation delay in milliseconds for audio sync compensation */
     uint32_t getAnimationDelayMs() const;
 
     /** @return TTL (in hours) for ad-hoc animations */
     uint32_t getAdHocAnimationTtlHours() const;
 
+    /** @return how many megabytes of decoded animations to keep cached */
+    uint32_t getAnimationCacheMb() const;
+
     /** @return Number of frames to wait before declaring streaming stopped */
     uint32_t getStreamingTimeoutFrames() const;
 
@@ -136,6 +237,21 @@ class Configuration {
     /** @param _networkDevice Network interface device ID */
     void setNetworkDevice(uint16_t _networkDevice);
 
+    /** @param _sendOnChange Whether to only send sACN universes when their data changes */
+    void setSacnSendOnChange(bool _sendOnChange);
+
+    /** @param _keepAliveMs Keep-alive interval for unchanged universes in send-on-change mode */
+    void setSacnKeepAliveMs(uint32_t _keepAliveMs);
+
+    /** @param _outputRateHz How often each sACN universe is sent, in Hz */
+    void setSacnOutputRateHz(uint32_t _outputRateHz);
+
+    /** @param _universeRates Per-universe output rate overrides as (universe, Hz) pairs */
+    void setSacnUniverseRates(std::vector<std::pair<uint16_t, uint32_t>> _universeRates);
+
+    /** @param _mergeMode Merge mode for DMX sources at the same priority */
+    void setSacnMergeMode(SacnMergeMode _mergeMode);
+
     /** @param _voiceApiKey API key for voice synthesis service */
     void setVoiceApiKey(std::string _voiceApiKey);
 
@@ -148,6 +264,12 @@ class Configuration {
     /** @param _eventLoopTraceSampling Sampling rate for event loop tracing (0.0 to 1.0) */
     void setEventLoopTraceSampling(double _eventLoopTraceSampling);
 
+    /** @param _sleepMode How the event loop waits for its next tick */
+    void setEventLoopSleepMode(EventLoopSleepMode _sleepMode);
+
+    /** @param _spinUs How long before a tick's deadline the hybrid sleep mode starts spinning, in microseconds */
+    void setEventLoopSpinUs(uint32_t _spinUs);
+
     /** @param _mode Audio mode to use (local playback or RTP streaming) */
     void setAudioMode(AudioMode _mode);
 
@@ -157,18 +279,60 @@ class Configuration {
     /** @param _fragmentPackets Whether to enable RTP packet fragmentation */
     void setRtpFragmentPackets(bool _fragmentPackets);
 
+    /** @param _backend How RTP packets are put on the wire */
+    void setRtpBackend(RtpBackend _backend);
+
+    /** @param _pacing What decides when each RTP frame set goes out */
+    void setRtpPacing(RtpPacing _pacing);
+
+    /** @param _leadMs How far ahead the event loop queues frame sets when they're paced */
+    void setRtpPacingLeadMs(uint32_t _leadMs);
+
+    /** @param _priority SCHED_FIFO priority for the pacing thread, 0 for a normal thread */
+    void setRtpPacingPriority(int _priority);
+
+    /** @param _mixer True to mix sounds into the RTP output */
+    void setRtpMixer(bool _mixer);
+
+    /** @param _duckDb How far (dB) to duck Bed tracks while dialog is playing */
+    void setRtpMixerDuckDb(float _duckDb);
+
+    /** @param _sendSilence True to send every packet, even for silent channels */
+    void setRtpSendSilence(bool _sendSilence);
+
     /** @param _workers Fixed cooperative RTP audio loader worker count */
     void setRtpAudioLoadWorkers(uint32_t _workers);
 
     /** @param _capacity Maximum queued cooperative RTP audio loads */
     void setRtpAudioLoadQueueCapacity(uint32_t _capacity);
 
+    /** @param _leadMs Audio to encode on a cache miss before RTP playback starts */
+    void setRtpEncodeLeadMs(uint32_t _leadMs);
+
+    /** @param _niceLevel Nice level for the background audio cache prewarmer */
+    void setAudioPrewarmNice(int _niceLevel);
+
+    /** @param _cores Most cores the background audio cache prewarmer may use; 0 turns it off */
+    void setAudioPrewarmCores(uint32_t _cores);
+
+    /** @param _cpus CPUs to pin the compute pool to; empty for all but the reserved ones */
+    void setComputePoolCpus(std::vector<int> _cpus);
+
+    /** @param _threads Threads in the compute pool; 0 for one per CPU */
+    void setComputePoolThreads(uint32_t _threads);
+
+    /** @param _cpus CPUs to pin the event loop and RTP output worker to; empty for the reserved ones */
+    void setRealtimeCpus(std::vector<int> _cpus);
+
     /** @param _delayMs Animation delay in milliseconds for audio sync compensation */
     void setAnimationDelayMs(uint32_t _delayMs);
 
     /** @param _ttlHours TTL (hours) for ad-hoc animations */
     void setAdHocAnimationTtlHours(uint32_t _ttlHours);
 
+    /** @param _cacheMb megabytes of decoded animations to keep cached (0 turns it off) */
+    void setAnimationCacheMb(uint32_t _cacheMb);
+
     /** @param _timeoutFrames Number of frames to wait before declaring streaming stopped */
     void setStreamingTimeoutFrames(uint32_t _timeoutFrames);
 
@@ -222,17 +386,71 @@ class Configuration {
     /** Whether to fragment RTP packets for standard MTU networks (WiFi, etc.) */
     bool rtpFragmentPackets = DEFAULT_RTP_FRAGMENT_PACKETS;
 
+    /** How RTP packets are put on the wire */
+    RtpBackend rtpBackend = RtpBackend::Sendmmsg;
+
+    /** The event loop sends frame sets unless they're paced by the RTP output thread */
+    RtpPacing rtpPacing = RtpPacing::EventLoop;
+
+    /** How early paced frame sets are queued, so event loop jitter under this doesn't reach the wire */
+    uint32_t rtpPacingLeadMs = DEFAULT_RTP_PACING_LEAD_MS;
+
+    /** SCHED_FIFO priority for the pacing thread */
+    int rtpPacingPriority = DEFAULT_RTP_PACING_PRIORITY;
+
+    /** Mix sounds into the RTP output */
+    bool rtpMixer = DEFAULT_RTP_MIXER;
+
+    /** How far (dB) the mixer ducks Bed tracks under dialog */
+    float rtpMixerDuckDb = DEFAULT_RTP_MIXER_DUCK_DB;
+
+    /** Send silent channels' packets instead of leaving them out */
+    bool rtpSendSilence = DEFAULT_RTP_SEND_SILENCE;
+
     /** Fixed workers for cooperative RTP WAV reads/cache loads */
     uint32_t rtpAudioLoadWorkers = DEFAULT_RTP_AUDIO_LOAD_WORKERS;
 
     /** Waiting cooperative RTP loads retained in memory before explicit rejection */
     uint32_t rtpAudioLoadQueueCapacity = DEFAULT_RTP_AUDIO_LOAD_QUEUE_CAPACITY;
 
+    /** Audio encoded on a cache miss before RTP playback starts; the rest encodes ahead of the playhead */
+    uint32_t rtpEncodeLeadMs = DEFAULT_RTP_ENCODE_LEAD_MS;
+
+    /** The background audio cache prewarmer stays out of the way of playback with this nice level... */
+    int audioPrewarmNice = DEFAULT_AUDIO_PREWARM_NICE;
+
+    /** ...and this many cores */
+    uint32_t audioPrewarmCores = DEFAULT_AUDIO_PREWARM_CORES;
+
+    /** Where Opus/MP3/Ogg encoding runs, kept off the event loop's and RTP sender's cores */
+    std::vector<int> computePoolCpus;
+
+    /** How many threads do it */
+    uint32_t computePoolThreads = DEFAULT_COMPUTE_POOL_THREADS;
+
+    /** Where the event loop and the RTP output worker run */
+    std::vector<int> realtimeCpus;
+
     // Network configuration
 
     /** Network interface device ID for E1.31 communication */
     uint16_t networkDevice = 0;
 
+    /** Only send sACN universes when their data changes (plus repeats and keep-alives) */
+    bool sacnSendOnChange = DEFAULT_SACN_SEND_ON_CHANGE;
+
+    /** How often an unchanged universe is refreshed in send-on-change mode */
+    uint32_t sacnKeepAliveMs = DEFAULT_SACN_KEEP_ALIVE_MS;
+
+    /** How often each sACN universe is sent, unless it has its own rate */
+    uint32_t sacnOutputRateHz = DEFAULT_SACN_OUTPUT_RATE_HZ;
+
+    /** Universes with their own output rate */
+    std::vector<std::pair<uint16_t, uint32_t>> sacnUniverseRates;
+
+    /** Tie-break between DMX sources at the same priority */
+    SacnMergeMode sacnMergeMode = SacnMergeMode::LTP;
+
     // External API configuration
 
     /** API key for ElevenLabs voice synthesis service */
@@ -251,6 +469,14 @@ class Configuration {
     /** Sampling rate for event loop tracing (0.0 to 1.0) */
     double eventLoopTraceSampling = DEFAULT_EVENT_LOOP_TRACE_SAMPLING;
 
+    // Event loop timing configuration
+
+    /** How the event loop waits for its next tick */
+    EventLoopSleepMode eventLoopSleepMode = EventLoopSleepMode::Sleep;
+
+    /** How long the hybrid sleep mode spins before each deadline, in microseconds */
+    uint32_t eventLoopSpinUs = DEFAULT_EVENT_LOOP_SPIN_US;
+
     // Animation scheduler configuration
 
     /** Animation delay in milliseconds for audio sync compensation */
@@ -259,6 +485,9 @@ class Configuration {
     /** TTL (hours) for ad-hoc animations (default 12h) */
     uint32_t adHocAnimationTtlHours = DEFAULT_ADHOC_ANIMATION_TTL_HOURS;
 
+    /** Megabytes of decoded animations kept for replays */
+    uint32_t animationCacheMb = DEFAULT_ANIMATION_CACHE_MB;
+
     /** Timeout (frames) after the last stream frame before marking streaming stopped */
     uint32_t streamingTimeoutFrames = DEFAULT_STREAMING_TIMEOUT_FRAMES;
 
@@ -7,6 +7,7 @@
 #include "spdlog/spdlog.h"
 
 #include "server/database.h"
+#include "server/eventloop/eventloop.h"
 
 #include <bsoncxx/builder/stream/document.hpp>
 #include <mongocxx/client.hpp>
@@ -34,6 +35,9 @@ Result<mongocxx::collection> Database::getCollection(const std::string &collecti
 
     debug("getting a handle to collection {}", collectionName);
 
+    // Everything that talks to Mongo comes through here, so this is where we catch the event loop doing it
+    EventLoop::noteBlockingIo(collectionName);
+
     // Don't do this if we can't ping the server (ie, short-circuit quickly)
     if (!serverPingable.load()) {
         const std::string errorMessage = "Unable to get a collection because the server is not pingable";
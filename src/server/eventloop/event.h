@@ -3,15 +3,83 @@
 //
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <cxxabi.h>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <string>
+#include <string_view>
+#include <typeinfo>
 
 #include "server/namespace-stuffs.h"
 #include "util/Result.h"
 
 namespace creatures {
 
+/**
+ * Gives every kind of event a small number, so the event loop can keep per-type
+ * stats in a flat array instead of a map
+ *
+ * A type gets its number the first time one of its events runs. Past
+ * MAX_TYPES, everything else shares the last slot.
+ */
+class EventTypes {
+  public:
+    static constexpr std::size_t MAX_TYPES = 48;
+
+    template <typename T> static std::size_t slotFor() {
+        static const std::size_t slot = add(typeid(T));
+        return slot;
+    }
+
+    /** @return how many slots are in use */
+    static std::size_t count() { return used().load(std::memory_order_acquire); }
+
+    /** @return the event's class name (without the namespace) for a slot below count() */
+    static const std::string &name(std::size_t slot) { return names()[slot]; }
+
+  private:
+    static std::size_t add(const std::type_info &type) {
+        static std::mutex mutex;
+        std::lock_guard lock(mutex);
+
+        const auto slot = used().load(std::memory_order_relaxed);
+        if (slot == MAX_TYPES - 1) {
+            names()[slot] = "Other";
+            used().store(MAX_TYPES, std::memory_order_release);
+            return slot;
+        }
+        if (slot == MAX_TYPES) {
+            return MAX_TYPES - 1;
+        }
+
+        int status = 0;
+        char *demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+        std::string name = status == 0 && demangled ? demangled : type.name();
+        std::free(demangled);
+        if (constexpr std::string_view prefix = "creatures::"; name.starts_with(prefix)) {
+            name.erase(0, prefix.size());
+        }
+
+        names()[slot] = std::move(name);
+        used().store(slot + 1, std::memory_order_release);
+        return slot;
+    }
+
+    static std::array<std::string, MAX_TYPES> &names() {
+        static std::array<std::string, MAX_TYPES> typeNames;
+        return typeNames;
+    }
+
+    static std::atomic<std::size_t> &used() {
+        static std::atomic<std::size_t> slotsUsed{0};
+        return slotsUsed;
+    }
+};
+
 /**
  * Base class for the items in the event queue
  *
@@ -31,6 +99,9 @@ class Event {
      */
     virtual Result<framenum_t> execute() = 0;
 
+    /** @return this event's slot in EventTypes */
+    [[nodiscard]] virtual std::size_t eventType() const = 0;
+
     framenum_t frameNumber = 0;
 };
 
@@ -52,47 +123,8 @@ template <typename Derived> class EventBase : public Event {
      * @return Result from the derived implementation
      */
     Result<framenum_t> execute() override { return static_cast<Derived *>(this)->executeImpl(); }
-};
-
-/**
- * Comparator for the priority queue
- *
- * Events with smaller frame numbers have higher priority
- * (they should be executed first)
- */
-struct EventComparator {
-    bool operator()(const std::shared_ptr<Event> &e1, const std::shared_ptr<Event> &e2) const {
-        return e1->frameNumber > e2->frameNumber;
-    }
-};
-
-/**
- * Event scheduler using a priority queue
- *
- * Thread safety note: If you're scheduling events from multiple threads,
- * you'll want to add mutex protection around the queue operations.
- */
-class EventScheduler {
-  public:
-    EventScheduler() = default;
-
-    // Non-copyable to avoid accidental queue duplication
-    EventScheduler(const EventScheduler &) = delete;
-    EventScheduler &operator=(const EventScheduler &) = delete;
-
-    // Move operations are fine
-    EventScheduler(EventScheduler &&) = default;
-    EventScheduler &operator=(EventScheduler &&) = default;
-
-    /**
-     * Priority queue that keeps events sorted by frame number
-     * Events with smaller frame numbers will be at the top
-     */
-    std::priority_queue<std::shared_ptr<Event>, std::vector<std::shared_ptr<Event>>, EventComparator> event_queue;
 
-    // If you need thread safety for multi-threaded event scheduling:
-    // std::mutex queue_mutex;
-    // std::condition_variable queue_condition;
+    [[nodiscard]] std::size_t eventType() const override { return EventTypes::slotFor<Derived>(); }
 };
 
 } // namespace creatures
\ No newline at end of file
@@ -16,7 +16,9 @@
 #include "server/config.h"
 #include "server/config/Configuration.h"
 #include "server/eventloop/eventloop.h"
+#include "server/eventloop/sleep.h"
 #include "server/metrics/counters.h"
+#include "util/ComputePool.h"
 #include "util/ObservabilityManager.h"
 #include "util/threadName.h"
 
@@ -26,7 +28,30 @@ extern std::shared_ptr<SystemCounters> metrics;
 extern std::shared_ptr<ObservabilityManager> observability;
 extern std::shared_ptr<Configuration> config;
 
-EventLoop::EventLoop() : eventScheduler(std::make_unique<EventScheduler>()) { debug("event loop created"); }
+namespace {
+
+// Only ever set on the event loop thread: the frame it's working on (0 everywhere else)
+thread_local framenum_t loopThreadFrame = 0;
+
+// The last frame noteBlockingIo() counted, and the last one it warned about
+thread_local framenum_t lastBlockedFrame = 0;
+thread_local framenum_t lastBlockedWarningFrame = 0;
+
+// Don't warn about blocked frames more than about once a second
+constexpr framenum_t BLOCKED_FRAME_WARNING_INTERVAL = 1000 / EVENT_LOOP_PERIOD_MS;
+
+// Nanoseconds from one time to a later one (0 if it isn't later)
+uint64_t nanosBetween(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return to > from ? static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count())
+                     : 0;
+}
+
+} // namespace
+
+EventLoop::EventLoop(std::vector<int> _cpus)
+    : cpus(std::move(_cpus)), eventScheduler(std::make_unique<EventScheduler>()) {
+    debug("event loop created");
+}
 
 void EventLoop::start() {
 
@@ -39,15 +64,30 @@ void EventLoop::start() {
 void EventLoop::run() {
 
     setThreadName("EventLoop::run");
+    eventScheduler->bindConsumerThread();
+    if (const auto pinned = util::ComputePool::pinThisThread(cpus); !pinned.isSuccess()) {
+        warn("Unable to pin the event loop to its CPUs: {}", pinned.getError()->getMessage());
+    }
 
     using namespace std::chrono;
     info("✨ eventloop running!");
 
+    const bool hybridSleep = config && config->getEventLoopSleepMode() == Configuration::EventLoopSleepMode::Hybrid;
+    const auto spin = microseconds(config ? config->getEventLoopSpinUs() : DEFAULT_EVENT_LOOP_SPIN_US);
+    if (hybridSleep) {
+        info("event loop is using hybrid sleep with a {}us spin", spin.count());
+    }
+
+    // Always on; see EventLoopTimings for what each one means
+    EventLoopTimings *timings = metrics ? &metrics->getEventLoopTimings() : nullptr;
+
     constexpr auto target_delta = milliseconds(EVENT_LOOP_PERIOD_MS);
-    auto next_target_time = high_resolution_clock::now() + target_delta;
+    auto next_target_time = steady_clock::now() + target_delta;
 
     while (!stop_requested.load()) {
 
+        const auto tickStart = steady_clock::now();
+
         // Create a sampling span for this event loop iteration
         // Use configured sampling rate (default 0.1% = 1 in 1000 frames)
         auto samplingRate = config ? config->getEventLoopTraceSampling() : DEFAULT_EVENT_LOOP_TRACE_SAMPLING;
@@ -64,40 +104,33 @@ void EventLoop::run() {
 
         // Publish the new frame count for cross-thread readers
         frameCount.store(currentFrame, std::memory_order_release);
+        loopThreadFrame = currentFrame;
         if (metrics) {
             metrics->incrementTotalFrames();
         }
 
-        // Process the events for this frame, if any, keeping the queue locked as short as possible.
+        // Process the events for this frame, if any
         uint32_t eventsProcessedThisFrame = 0;
         std::string eventErrorMessage;
         bool frameHadError = false;
 
-        while (true) {
-            std::shared_ptr<Event> event;
-
-            {
-                std::unique_lock lock(eventQueueMutex); // Unlocks when it goes out of scope
-                if (!eventScheduler->event_queue.empty() &&
-                    eventScheduler->event_queue.top()->frameNumber <= frameCount.load(std::memory_order_relaxed)) {
-                    event = eventScheduler->event_queue.top();
-                    eventScheduler->event_queue.pop();
-                } else {
-                    break;
-                }
-            }
+        // Pull in whatever other threads submitted since the last frame and
+        // move the wheel up to this one
+        eventScheduler->advanceTo(currentFrame);
+
+        while (auto event = eventScheduler->popDue()) {
+
+            const auto eventStart = steady_clock::now();
 
             // Run the event in a try/catch, in case something happens. I don't want one bad event
             // to bring down the system. I want it to log and keep on going.
             try {
 
-                if (event) {
-                    event->execute();
-                    if (metrics) {
-                        metrics->incrementEventsProcessed();
-                    }
-                    eventsProcessedThisFrame++;
+                event->execute();
+                if (metrics) {
+                    metrics->incrementEventsProcessed();
                 }
+                eventsProcessedThisFrame++;
 
             } catch (const std::runtime_error &e) {
                 frameHadError = true;
@@ -122,6 +155,17 @@ void EventLoop::run() {
                     frameSpan->setError("Unknown exception occurred during event processing");
                 }
             }
+
+            if (timings) {
+                timings->eventExecutionNs[event->eventType()].record(nanosBetween(eventStart, steady_clock::now()));
+            }
+        }
+
+        if (timings) {
+            const auto workDone = steady_clock::now();
+            timings->tickWorkNs.record(nanosBetween(tickStart, workDone));
+            timings->tickOverrunNs.record(nanosBetween(next_target_time, workDone));
+            timings->eventsPerTick.record(eventsProcessedThisFrame);
         }
 
         // Add frame summary to span
@@ -139,9 +183,15 @@ void EventLoop::run() {
         // Figure out how much time we have until the next tick
 
         // If there's time left, wait.
-        if (auto remaining_time = next_target_time - high_resolution_clock::now(); remaining_time > nanoseconds(0)) {
-            // Sleep for the remaining time
-            std::this_thread::sleep_for(remaining_time);
+        if (steady_clock::now() < next_target_time) {
+            if (hybridSleep) {
+                hybridSleepUntil(next_target_time, spin);
+            } else {
+                sleepUntil(next_target_time);
+            }
+            if (timings) {
+                timings->oversleepNs.record(nanosBetween(next_target_time, steady_clock::now()));
+            }
         }
 
         // Update the target time for the next iteration
@@ -155,18 +205,33 @@ framenum_t EventLoop::getCurrentFrameNumber() const { return frameCount.load(std
 
 framenum_t EventLoop::getNextFrameNumber() const { return frameCount.load(std::memory_order_acquire) + 1; }
 
-uint32_t EventLoop::getQueueSize() const {
-    std::lock_guard lock(eventQueueMutex);
-    return eventScheduler->event_queue.size();
+void EventLoop::noteBlockingIo(std::string_view what) {
+    if (loopThreadFrame == 0 || lastBlockedFrame == loopThreadFrame) {
+        return;
+    }
+    lastBlockedFrame = loopThreadFrame;
+
+    if (metrics) {
+        metrics->incrementEventLoopBlockedFrames();
+    }
+
+    if (lastBlockedWarningFrame == 0 || loopThreadFrame - lastBlockedWarningFrame >= BLOCKED_FRAME_WARNING_INTERVAL) {
+        lastBlockedWarningFrame = loopThreadFrame;
+        warn("event loop frame {} is waiting on I/O ({}); this should happen on a worker thread", loopThreadFrame,
+             what);
+    }
 }
 
+bool EventLoop::onLoopThread() { return loopThreadFrame != 0; }
+
+uint32_t EventLoop::getQueueSize() const { return static_cast<uint32_t>(eventScheduler->size()); }
+
 void EventLoop::scheduleEvent(const std::shared_ptr<Event> &e) {
     if (!e) {
         warn("EventLoop: attempted to schedule null event");
         return;
     }
-    std::lock_guard lock(eventQueueMutex);
-    eventScheduler->event_queue.push(e);
+    eventScheduler->submit(e);
 }
 
 } // namespace creatures
\ No newline at end of file
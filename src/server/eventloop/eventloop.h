@@ -6,13 +6,14 @@
 
 #include <atomic>
 #include <memory>
-#include <mutex>
-#include <queue>
+#include <string_view>
 #include <thread>
+#include <vector>
 
 #include "spdlog/spdlog.h"
 
 #include "server/eventloop/event.h"
+#include "server/eventloop/scheduler.h"
 #include "util/StoppableThread.h"
 
 namespace creatures {
@@ -20,7 +21,8 @@ namespace creatures {
 class EventLoop final : public StoppableThread {
 
   public:
-    EventLoop();
+    /** @param cpus CPUs to pin the loop's thread to; empty leaves it unpinned */
+    explicit EventLoop(std::vector<int> cpus = {});
     ~EventLoop() = default;
 
     void scheduleEvent(const std::shared_ptr<Event> &e);
@@ -31,6 +33,21 @@ class EventLoop final : public StoppableThread {
 
     void start() override;
 
+    /**
+     * Note that the calling thread is about to wait on I/O, like a database round trip
+     *
+     * Nothing on the event loop should ever do that, so this is a tripwire: off the
+     * loop it does nothing, and on the loop it counts the frame in
+     * eventLoopBlockedFrames (once per frame, no matter how many calls the frame
+     * made) and warns about it every so often.
+     *
+     * @param what what's being waited on, for the log
+     */
+    static void noteBlockingIo(std::string_view what);
+
+    /** True on the event loop thread, where nothing should wait on I/O */
+    static bool onLoopThread();
+
   protected:
     void run() override;
 
@@ -40,8 +57,11 @@ class EventLoop final : public StoppableThread {
     // Atomic so the cross-thread reads aren't UB on weakly-ordered hardware.
     std::atomic<framenum_t> frameCount{0};
 
+    // Kept clear of the compute pool so encoding can't hold up a tick
+    const std::vector<int> cpus;
+
+    // Lock-free for producers; only this thread advances it or pops from it
     std::unique_ptr<EventScheduler> eventScheduler;
-    mutable std::mutex eventQueueMutex;
 };
 
 } // namespace creatures
\ No newline at end of file
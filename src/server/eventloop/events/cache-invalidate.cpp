@@ -3,24 +3,41 @@
 #include <spdlog/spdlog.h>
 
 #include "model/CacheInvalidation.h"
+#include "server/audio/AudioCachePrewarmer.h"
 #include "server/eventloop/events/types.h"
 #include "server/namespace-stuffs.h"
+#include "server/ws/messaging/StreamFrameHandler.h"
 #include "util/websocketUtils.h"
 
 extern std::shared_ptr<creatures::EventLoop> eventLoop;
 
 namespace creatures {
 
+extern std::shared_ptr<audio::AudioCachePrewarmer> audioCachePrewarmer;
+
 CacheInvalidateEvent::CacheInvalidateEvent(framenum_t frameNumber_, CacheType cacheType_)
     : EventBase(frameNumber_), cacheType(cacheType_) {}
 
 /**
  * Tells the clients to invalidate a certain cache type
+ *
+ * New sounds or animations might mean new sounds to encode, too, so this also
+ * has the audio cache prewarmer look again (which never waits). Changed creatures
+ * mean anything being streamed to has to look its creature up again.
  */
 Result<framenum_t> CacheInvalidateEvent::executeImpl() {
     debug("cache invalidate event for {}", toString(cacheType));
     broadcastCacheInvalidationToAllClients(cacheType);
 
+    if (audioCachePrewarmer && (cacheType == CacheType::SoundList || cacheType == CacheType::Animation)) {
+        audioCachePrewarmer->requestScan();
+    }
+
+    // A creature that's being streamed to might have moved to different channels
+    if (cacheType == CacheType::Creature) {
+        ws::StreamFrameHandler::forgetStreamingContexts();
+    }
+
     return Result{this->frameNumber};
 }
 
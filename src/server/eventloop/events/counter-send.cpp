@@ -1,3 +1,5 @@
+#include <utility>
+
 #include <spdlog/spdlog.h>
 
 #include <oatpp/core/Types.hpp>
@@ -16,6 +18,8 @@
 #include "server/ws/dto/websocket/MessageTypes.h"
 #include "server/ws/dto/websocket/ServerCountersMessage.h"
 #include "server/ws/service/CreatureService.h"
+#include "server/ws/websocket/OutgoingMessage.h"
+#include "server/ws/websocket/TopicSubscriptions.h"
 
 // Include the ObservabilityManager for metrics export
 #include "server/sensors/SensorDataCache.h"
@@ -25,7 +29,7 @@ namespace creatures {
 
 extern std::shared_ptr<EventLoop> eventLoop;
 extern std::shared_ptr<SystemCounters> metrics;
-extern std::shared_ptr<moodycamel::BlockingConcurrentQueue<std::string>> websocketOutgoingMessages;
+extern std::shared_ptr<moodycamel::BlockingConcurrentQueue<ws::OutgoingMessage>> websocketOutgoingMessages;
 extern std::shared_ptr<ObservabilityManager> observability;
 extern std::shared_ptr<SensorDataCache> sensorDataCache;
 
@@ -47,36 +51,36 @@ Result<framenum_t> CounterSendEvent::executeImpl() {
         return Result<framenum_t>{ServerError(ServerError::InternalError, errorMsg)};
     }
 
-    auto jsonMapper = oatpp::parser::json::mapping::ObjectMapper::createShared();
-
     debug("sending the server metrics to all clients");
 
-    // First, send to websocket clients
-    auto message = oatpp::Object<ws::ServerCountersMessage>::createShared();
-    message->command = toString(ws::MessageType::ServerCounters);
-
-    // Build payload with counters and runtime state snapshot
-    auto payload = ws::ServerCountersPayloadDto::createShared();
-    payload->counters = metrics->convertToDto();
-
-    auto runtimeSnapshot = creatures::ws::CreatureService::getRuntimeStates();
-    auto runtimeList = oatpp::List<oatpp::Object<ws::ServerCountersCreatureRuntimeDto>>::createShared();
-    for (const auto &entry : runtimeSnapshot) {
-        auto runtimeDto = ws::ServerCountersCreatureRuntimeDto::createShared();
-        runtimeDto->creature_id = entry.first.c_str();
-        runtimeDto->runtime = entry.second;
-        runtimeList->emplace_back(runtimeDto);
-    }
-    payload->runtime_states = runtimeList;
+    // First, send to websocket clients, if any of them want the counters
+    if (ws::anyoneSubscribedTo(ws::MessageType::ServerCounters)) {
+        auto message = oatpp::Object<ws::ServerCountersMessage>::createShared();
+        message->command = toString(ws::MessageType::ServerCounters);
+
+        // Build payload with counters and runtime state snapshot
+        auto payload = ws::ServerCountersPayloadDto::createShared();
+        payload->counters = metrics->convertToDto();
+
+        auto runtimeSnapshot = creatures::ws::CreatureService::getRuntimeStates();
+        auto runtimeList = oatpp::List<oatpp::Object<ws::ServerCountersCreatureRuntimeDto>>::createShared();
+        for (const auto &entry : runtimeSnapshot) {
+            auto runtimeDto = ws::ServerCountersCreatureRuntimeDto::createShared();
+            runtimeDto->creature_id = entry.first.c_str();
+            runtimeDto->runtime = entry.second;
+            runtimeList->emplace_back(runtimeDto);
+        }
+        payload->runtime_states = runtimeList;
 
-    message->payload = payload;
+        message->payload = payload;
 
-    // Serialize our message to a string
-    std::string messageAsString = jsonMapper->writeToString(message);
-    trace("websocket message as string: {}", messageAsString);
+        // Serialize our message once, for every client to share
+        auto outgoingMessage = ws::serializeForClients(ws::MessageType::ServerCounters, message);
+        trace("websocket message as string: {}", *outgoingMessage.json);
 
-    // Push this into the websocket queue
-    websocketOutgoingMessages->enqueue(messageAsString);
+        // Push this into the websocket queue
+        websocketOutgoingMessages->enqueue(std::move(outgoingMessage));
+    }
 
     // Now export metrics to OTel if observability is enabled
     if (observability && observability->isInitialized()) {
@@ -1,5 +1,7 @@
 
 
+#include <limits>
+#include <span>
 #include <sstream>
 
 #include <spdlog/spdlog.h>
@@ -21,16 +23,46 @@ namespace creatures {
 extern std::shared_ptr<creatures::e131::E131Server> e131Server;
 extern std::shared_ptr<SystemCounters> metrics;
 
-Result<framenum_t> DMXEvent::executeImpl() {
+namespace {
+
+    e131::MergeSource mergeSourceFor(DmxSource source) {
+        switch (source) {
+        case DmxSource::Playback:
+            return {static_cast<uint8_t>(source), DMX_PRIORITY_PLAYBACK};
+        case DmxSource::Pattern:
+            return {static_cast<uint8_t>(source), DMX_PRIORITY_PATTERN};
+        case DmxSource::Live:
+            return {static_cast<uint8_t>(source), DMX_PRIORITY_LIVE};
+        case DmxSource::Hold:
+            return {static_cast<uint8_t>(source), DMX_PRIORITY_HOLD};
+        case DmxSource::Direct:
+        default:
+            return {static_cast<uint8_t>(DmxSource::Direct), DMX_PRIORITY_DIRECT};
+        }
+    }
 
-    if (!e131Server) {
-        const std::string errorMsg = "DMXEvent: e131Server unavailable";
-        error(errorMsg);
-        return Result<framenum_t>{ServerError(ServerError::InternalError, errorMsg)};
+    bool fitsInUniverse(universe_t universe, uint32_t channelOffset) {
+        return universe <= std::numeric_limits<uint16_t>::max() &&
+               channelOffset <= std::numeric_limits<uint16_t>::max();
     }
 
-    // Send the DMX data
-    e131Server->setValues(universe, channelOffset, data);
+} // namespace
+
+bool DMXEvent::writeSlots(universe_t universe, uint32_t channelOffset, std::span<const uint8_t> data) {
+    return writeSlots(DmxSource::Direct, universe, channelOffset, data);
+}
+
+bool DMXEvent::writeSlots(DmxSource source, universe_t universe, uint32_t channelOffset,
+                          std::span<const uint8_t> data) {
+
+    if (!e131Server || !fitsInUniverse(universe, channelOffset)) {
+        return false;
+    }
+
+    if (!e131Server->writeSlots(mergeSourceFor(source), static_cast<uint16_t>(universe),
+                                static_cast<uint16_t>(channelOffset), data)) {
+        return false;
+    }
 
     // Update our metrics
     if (metrics) {
@@ -38,9 +70,44 @@ Result<framenum_t> DMXEvent::executeImpl() {
     }
 
 #if DEBUG_EVENT_DMX
-    debug("DMX data: Offset: {}, data: {}", channelOffset, vectorToHexString(data));
+    debug("DMX data: Offset: {}, data: {}", channelOffset,
+          vectorToHexString(std::vector<uint8_t>(data.begin(), data.end())));
 #endif
 
+    return true;
+}
+
+bool DMXEvent::releaseSlots(DmxSource source, universe_t universe, uint32_t channelOffset, uint16_t count) {
+
+    if (!e131Server || !fitsInUniverse(universe, channelOffset)) {
+        return false;
+    }
+
+    return e131Server->releaseSlots(mergeSourceFor(source), static_cast<uint16_t>(universe),
+                                    static_cast<uint16_t>(channelOffset), count);
+}
+
+bool DMXEvent::handOffSlots(DmxSource source, universe_t universe, uint32_t channelOffset, uint16_t count) {
+
+    if (!e131Server || !fitsInUniverse(universe, channelOffset)) {
+        return false;
+    }
+
+    return e131Server->handOffSlots(mergeSourceFor(source), mergeSourceFor(DmxSource::Hold),
+                                    static_cast<uint16_t>(universe), static_cast<uint16_t>(channelOffset), count);
+}
+
+Result<framenum_t> DMXEvent::executeImpl() {
+
+    if (!e131Server) {
+        const std::string errorMsg = "DMXEvent: e131Server unavailable";
+        error(errorMsg);
+        return Result<framenum_t>{ServerError(ServerError::InternalError, errorMsg)};
+    }
+
+    // Send the DMX data
+    writeSlots(source, universe, channelOffset, data);
+
     return Result{this->frameNumber};
 }
 
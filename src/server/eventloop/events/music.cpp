@@ -169,11 +169,13 @@ class StandaloneRtpFrameEvent : public EventBase<StandaloneRtpFrameEvent> {
             return Result<framenum_t>{this->frameNumber};
         }
 
+        // With paced output this runs ahead of when its frame set is due; lateness is measured against the latter
         constexpr framenum_t dispatchStep = RTP_FRAME_MS / EVENT_LOOP_PERIOD_MS;
+        const framenum_t dueFrame = this->frameNumber + rtpServer->getEnqueueLeadFrames();
         size_t framesToSkip = 0;
         const framenum_t currentFrame = eventLoop->getCurrentFrameNumber();
-        if (currentFrame > this->frameNumber) {
-            framesToSkip = static_cast<size_t>((currentFrame - this->frameNumber) / dispatchStep);
+        if (currentFrame > dueFrame) {
+            framesToSkip = static_cast<size_t>((currentFrame - dueFrame) / dispatchStep);
             framesToSkip = std::min(framesToSkip, buffer_->getFrameCount() - frameIndex_);
         }
 
@@ -578,7 +580,8 @@ Result<framenum_t> MusicEvent::scheduleRtpAudio(std::shared_ptr<OperationSpan> p
                 capturedEventLoop->scheduleEvent(
                     std::make_shared<RtpEncoderResetEvent>(resetFrame, *outputLease, traceContext));
                 capturedEventLoop->scheduleEvent(std::make_shared<StandaloneRtpFrameEvent>(
-                    streamingStartFrame, buffer, 0, *outputLease, span, std::move(reservation), traceContext));
+                    streamingStartFrame - capturedRtpServer->getEnqueueLeadFrames(), buffer, 0, *outputLease, span,
+                    std::move(reservation), traceContext));
 
                 debug("Scheduled the first of {} self-chaining RTP audio frames", buffer->getFrameCount());
             } catch (const std::exception &exception) {
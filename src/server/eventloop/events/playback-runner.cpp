@@ -14,7 +14,9 @@
 
 #include "model/DmxFixture.h"
 #include "server/animation/PlaybackSession.h"
+#include "server/animation/PlaylistPrefetcher.h"
 #include "server/animation/SessionManager.h"
+#include "server/animation/player.h"
 #include "server/audio/AudioTransport.h"
 #include "server/config.h"
 #include "server/creature-server.h"
@@ -38,15 +40,34 @@ framenum_t frameStepForMs(uint32_t msPerFrame) {
 }
 } // namespace
 
-extern std::shared_ptr<Database> db;
 extern std::shared_ptr<EventLoop> eventLoop;
 extern std::shared_ptr<GPIO> gpioPins;
 extern std::shared_ptr<ObservabilityManager> observability;
 extern std::shared_ptr<ObjectCache<creatureId_t, Creature>> creatureCache;
 extern std::shared_ptr<ObjectCache<fixtureId_t, DmxFixture>> fixtureCache;
 extern std::shared_ptr<ObjectCache<fixtureId_t, universe_t>> fixtureUniverseMap;
+extern std::shared_ptr<PlaylistPrefetcher> playlistPrefetcher;
 extern std::shared_ptr<SessionManager> sessionManager;
 
+namespace {
+
+// Something this session drives isn't cached. Load it on a prefetcher worker rather than
+// waiting on the database here; the track skips its frames until it shows up. One load
+// at a time, and whatever it can't find is remembered rather than asked for again.
+void warmCachesInBackground(const std::shared_ptr<PlaybackSession> &session) {
+    if (!playlistPrefetcher || !session->getCacheLookups().begin()) {
+        return;
+    }
+    if (!playlistPrefetcher->runInBackground(fmt::format("playback-caches:{}", session->getSessionId()), [session] {
+            session->getCacheLookups().finish(warmPlaybackCaches(session->getAnimation()));
+        })) {
+        // Not queued (shutting down, or the last one is still winding up); a later frame asks again
+        session->getCacheLookups().finish({});
+    }
+}
+
+} // namespace
+
 PlaybackRunnerEvent::PlaybackRunnerEvent(framenum_t frameNumber, std::shared_ptr<PlaybackSession> session)
     : EventBase(frameNumber), session_(session) {}
 
@@ -275,7 +296,11 @@ void PlaybackRunnerEvent::performTeardown() {
     debug("PlaybackRunnerEvent performing teardown for animation '{}'", session_->getAnimation().metadata.title);
 
     // NOTE: We do NOT send DMX blackout - creatures are left in their final state
-    // This is intentional to avoid dangerous rapid state changes
+    // This is intentional to avoid dangerous rapid state changes. Handing the channels
+    // off keeps them there, but lets a fixture pattern underneath show through again.
+    for (const auto &written : session_->getDmxWritten().all()) {
+        DMXEvent::handOffSlots(DmxSource::Playback, written.universe, written.channelOffset, written.count);
+    }
 
     if (!eventLoop) {
         warn("PlaybackRunnerEvent teardown skipped: missing event loop");
@@ -303,23 +328,13 @@ Result<framenum_t> PlaybackRunnerEvent::emitDmxFrames(std::shared_ptr<SamplingSp
         return Result<framenum_t>{ServerError(ServerError::InternalError, errorMsg)};
     }
 
-    if (!db) {
-        std::string errorMsg = "Database unavailable during playback";
-        error(errorMsg);
-        return Result<framenum_t>{ServerError(ServerError::InternalError, errorMsg)};
-    }
-
-    if (!eventLoop) {
-        std::string errorMsg = "Event loop unavailable during playback";
-        error(errorMsg);
-        return Result<framenum_t>{ServerError(ServerError::InternalError, errorMsg)};
-    }
-
     auto &trackStates = session_->getTrackStates();
     uint32_t framesEmitted = 0;
 
     // Emit DMX frames for any tracks ready to dispatch on this frame
-    for (auto &trackState : trackStates) {
+    for (size_t track = 0; track < trackStates.size(); ++track) {
+        auto &trackState = trackStates[track];
+
         // Check if this track is finished
         if (trackState.isFinished()) {
             continue;
@@ -332,7 +347,6 @@ Result<framenum_t> PlaybackRunnerEvent::emitDmxFrames(std::shared_ptr<SamplingSp
 
         uint16_t channelOffset = 0;
         universe_t targetUniverse = session_->getUniverse();
-        std::string targetLabel; // for logging
 
         if (trackState.isFixtureTrack()) {
             // Fixture track — look up via fixtureCache and resolve its persisted universe via fixtureUniverseMap.
@@ -344,17 +358,19 @@ Result<framenum_t> PlaybackRunnerEvent::emitDmxFrames(std::shared_ptr<SamplingSp
             }
 
             std::shared_ptr<DmxFixture> fixture = fixtureCache->tryGet(trackState.fixtureId);
+            if (!fixture && session_->getCacheLookups().isNotFound(trackState.fixtureId)) {
+                std::string errorMsg =
+                    fmt::format("Fixture {} not found in database during playback", trackState.fixtureId);
+                error(errorMsg);
+                return Result<framenum_t>{ServerError(ServerError::NotFound, errorMsg)};
+            }
             if (!fixture) {
-                debug("Fixture {} not in cache, fetching from database", trackState.fixtureId);
-                auto fixtureResult = db->getFixture(trackState.fixtureId, nullptr);
-                if (!fixtureResult.isSuccess()) {
-                    std::string errorMsg =
-                        fmt::format("Fixture {} not found in database during playback", trackState.fixtureId);
-                    error(errorMsg);
-                    return Result<framenum_t>{ServerError(ServerError::InternalError, errorMsg)};
-                }
-                fixture = std::make_shared<DmxFixture>(fixtureResult.getValue().value());
-                fixtureCache->put(trackState.fixtureId, fixture);
+                debug("Fixture {} not in cache; skipping frame {} while it loads", trackState.fixtureId,
+                      trackState.currentFrameIndex);
+                warmCachesInBackground(session_);
+                trackState.currentFrameIndex++;
+                trackState.nextDispatchFrame = this->frameNumber + frameStepForMs(session_->getMsPerFrame());
+                continue;
             }
 
             // Single locked lookup — a concurrent DELETE /universe between contains/get
@@ -376,7 +392,6 @@ Result<framenum_t> PlaybackRunnerEvent::emitDmxFrames(std::shared_ptr<SamplingSp
             }
             targetUniverse = *universePtr;
             channelOffset = fixture->channel_offset;
-            targetLabel = fmt::format("fixture {} ({})", fixture->name, trackState.fixtureId);
             if (runnerSpan) {
                 runnerSpan->setAttribute("track.kind", "fixture");
                 runnerSpan->setAttribute("fixture.id", trackState.fixtureId);
@@ -389,23 +404,23 @@ Result<framenum_t> PlaybackRunnerEvent::emitDmxFrames(std::shared_ptr<SamplingSp
             // into a single locked section.
             std::shared_ptr<Creature> creature = creatureCache->tryGet(trackState.creatureId);
 
+            if (!creature && session_->getCacheLookups().isNotFound(trackState.creatureId)) {
+                std::string errorMsg =
+                    fmt::format("Creature {} not found in database during playback", trackState.creatureId);
+                error(errorMsg);
+                return Result<framenum_t>{ServerError(ServerError::NotFound, errorMsg)};
+            }
             if (!creature) {
-                debug("Creature {} not in cache, fetching from database", trackState.creatureId);
-                auto creatureResult = db->getCreature(trackState.creatureId, nullptr);
-                if (!creatureResult.isSuccess()) {
-                    std::string errorMsg =
-                        fmt::format("Creature {} not found in database during playback", trackState.creatureId);
-                    error(errorMsg);
-                    return Result<framenum_t>{ServerError(ServerError::InternalError, errorMsg)};
-                }
-                creature = std::make_shared<Creature>(creatureResult.getValue().value());
-                creatureCache->put(trackState.creatureId, creature);
-                debug("Cached creature {} for playback", trackState.creatureId);
+                debug("Creature {} not in cache; skipping frame {} while it loads", trackState.creatureId,
+                      trackState.currentFrameIndex);
+                warmCachesInBackground(session_);
+                trackState.currentFrameIndex++;
+                trackState.nextDispatchFrame = this->frameNumber + frameStepForMs(session_->getMsPerFrame());
+                continue;
             }
 
             channelOffset = creature->channel_offset;
             targetUniverse = session_->getUniverse();
-            targetLabel = fmt::format("creature {} ({})", creature->name, trackState.creatureId);
             if (runnerSpan) {
                 runnerSpan->setAttribute("track.kind", "creature");
                 runnerSpan->setAttribute("creature.id", trackState.creatureId);
@@ -414,22 +429,17 @@ Result<framenum_t> PlaybackRunnerEvent::emitDmxFrames(std::shared_ptr<SamplingSp
             }
         }
 
-        // Create DMX event for this frame
-        auto dmxEvent = std::make_shared<DMXEvent>(this->frameNumber);
-        dmxEvent->universe = targetUniverse;
-        dmxEvent->channelOffset = channelOffset;
-
-        // Copy the decoded frame data
-        const auto &frameData = trackState.decodedFrames[trackState.currentFrameIndex];
-        dmxEvent->data.reserve(frameData.size());
-        for (uint8_t byte : frameData) {
-            dmxEvent->data.push_back(byte);
-        }
-
-        // Schedule the DMX event
-        eventLoop->scheduleEvent(dmxEvent);
-
-        trace("Emitted DMX frame {} for {} on universe {}", trackState.currentFrameIndex, targetLabel, targetUniverse);
+        // We're already on the event loop for this frame, so write straight into the
+        // universe instead of bouncing a DMXEvent (and a copy of the frame) through the queue.
+        // Rejections are logged by the E1.31 server; keep the timeline moving like the
+        // DMXEvent path always did rather than failing the whole session.
+        const auto frame = trackState.currentFrame();
+        DMXEvent::writeSlots(DmxSource::Playback, targetUniverse, channelOffset, frame);
+        session_->getDmxWritten().note(track, targetUniverse, channelOffset, frame.size());
+
+        trace("Emitted DMX frame {} for {} {} on universe {}", trackState.currentFrameIndex,
+              trackState.isFixtureTrack() ? "fixture" : "creature",
+              trackState.isFixtureTrack() ? trackState.fixtureId : trackState.creatureId, targetUniverse);
 
         // Advance track state
         trackState.currentFrameIndex++;
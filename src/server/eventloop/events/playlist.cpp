@@ -9,6 +9,7 @@
 #include "spdlog/spdlog.h"
 
 #include "model/PlaylistStatus.h"
+#include "server/animation/PlaylistPrefetcher.h"
 #include "server/animation/SessionManager.h"
 #include "server/animation/player.h"
 #include "server/config.h"
@@ -35,6 +36,7 @@ extern std::shared_ptr<SystemCounters> metrics;
 extern std::shared_ptr<ObservabilityManager> observability;
 extern std::shared_ptr<SessionManager> sessionManager;
 extern std::shared_ptr<ObjectCache<creatureId_t, universe_t>> creatureUniverseMap;
+extern std::shared_ptr<PlaylistPrefetcher> playlistPrefetcher;
 
 PlaylistEvent::PlaylistEvent(framenum_t frameNumber_, universe_t universe_)
     : EventBase(frameNumber_), activeUniverse(universe_) {}
@@ -73,29 +75,17 @@ Result<framenum_t> PlaylistEvent::executeImpl() {
 
     debug("the active playlistStatus snapshot is {}", activePlaylistStatus.playlist);
 
-    auto playlistResult = fetchPlaylist(activePlaylistStatus, span);
-    if (!playlistResult.isSuccess()) {
-        return Result<framenum_t>{playlistResult.getError().value()};
+    PlaylistPrefetcher::Item nextItem;
+    if (auto itemResult = takeNextItem(activePlaylistStatus, nextItem, span)) {
+        return *itemResult;
     }
-    auto playlist = playlistResult.getValue().value();
-    debug("playlist found. name: {}", playlist.name);
-
-    auto chosenResult = chooseWeightedAnimation(playlist);
-    if (!chosenResult.isSuccess()) {
-        return Result<framenum_t>{chosenResult.getError().value()};
-    }
-    auto chosenAnimation = chosenResult.getValue().value();
-    debug("...and the chosen one is {}", chosenAnimation);
+    const auto &chosenAnimation = nextItem.animationId;
+    const auto &animation = nextItem.animation;
+    debug("playlist {} is playing {} next", nextItem.playlist.name, chosenAnimation);
     if (span) {
         span->setAttribute("chosen_animation", chosenAnimation);
     }
 
-    auto animationResult = fetchAnimation(chosenAnimation, span);
-    if (!animationResult.isSuccess()) {
-        return Result<framenum_t>{animationResult.getError().value()};
-    }
-    auto animation = animationResult.getValue().value();
-
     auto involvedCreatures = collectInvolvedCreatures(animation);
     if (span) {
         span->setAttribute("playlist.animation_creature_count", static_cast<int64_t>(involvedCreatures.size()));
@@ -111,6 +101,9 @@ Result<framenum_t> PlaylistEvent::executeImpl() {
 
     scheduleNextPlaylistEvent(lastFrame);
 
+    // Get the item after this one loading while this one plays
+    playlistPrefetcher->request(activeUniverse, activePlaylistStatus.playlist);
+
     updatePlaylistStatus(activePlaylistStatus, chosenAnimation);
 
     startIdleLoopsForUniverse(involvedCreatures, span);
@@ -152,6 +145,14 @@ Result<void> PlaylistEvent::ensureDependencies(std::shared_ptr<OperationSpan> sp
         }
         return Result<void>{ServerError(ServerError::InternalError, errorMessage)};
     }
+    if (!playlistPrefetcher) {
+        const std::string errorMessage = "PlaylistEvent: playlist prefetcher unavailable";
+        error(errorMessage);
+        if (span) {
+            span->setError(errorMessage);
+        }
+        return Result<void>{ServerError(ServerError::InternalError, errorMessage)};
+    }
 
     return Result<void>{};
 }
@@ -221,20 +222,98 @@ std::optional<Result<framenum_t>> PlaylistEvent::loadActivePlaylistStatus(Playli
     return std::nullopt;
 }
 
-Result<Playlist> PlaylistEvent::fetchPlaylist(const PlaylistStatus &playlistStatus,
-                                              std::shared_ptr<OperationSpan> span) {
+std::optional<Result<framenum_t>> PlaylistEvent::takeNextItem(const PlaylistStatus &playlistStatus,
+                                                              PlaylistPrefetcher::Item &nextItem,
+                                                              std::shared_ptr<OperationSpan> span) {
+    auto itemResult = playlistPrefetcher->take(activeUniverse, playlistStatus.playlist);
+
+    // Still loading. Come back in a bit rather than waiting for it here.
+    if (!itemResult) {
+        framenum_t retryFrame = eventLoop->getNextFrameNumber() + PLAYLIST_PREFETCH_RETRY_FRAMES;
+        debug("next item of playlist {} isn't ready yet; trying again at frame {}", playlistStatus.playlist,
+              retryFrame);
+        eventLoop->scheduleEvent(std::make_shared<PlaylistEvent>(retryFrame, activeUniverse));
+        if (span) {
+            span->setAttribute("reason", "prefetch_pending");
+            span->setSuccess();
+        }
+        return Result<framenum_t>{this->frameNumber};
+    }
+
+    if (!itemResult->isSuccess()) {
+        auto loadError = itemResult->getError().value();
+        std::string errorMessage = fmt::format("{} Halting playlist playback.", loadError.getMessage());
+        warn(errorMessage);
+        sessionManager->clearPlaylist(activeUniverse);
+        sendEmptyPlaylistUpdate(activeUniverse);
+        if (span) {
+            span->setError(errorMessage);
+        }
+        return Result<framenum_t>{ServerError(ServerError::InternalError, errorMessage)};
+    }
+
+    nextItem = itemResult->getValue().value();
+    return std::nullopt;
+}
+
+Result<PlaylistPrefetcher::Item> PlaylistEvent::loadNextItem(const playlistId_t &playlistId) {
+    auto span = observability ? observability->createOperationSpan("playlist_prefetch.load") : nullptr;
+    if (span) {
+        span->setAttribute("playlist.id", playlistId);
+    }
+
+    if (!db) {
+        const std::string errorMessage = "PlaylistEvent: database unavailable";
+        if (span) {
+            span->setError(errorMessage);
+        }
+        return Result<PlaylistPrefetcher::Item>{ServerError(ServerError::InternalError, errorMessage)};
+    }
+
+    auto playlistResult = fetchPlaylist(playlistId, span);
+    if (!playlistResult.isSuccess()) {
+        return Result<PlaylistPrefetcher::Item>{playlistResult.getError().value()};
+    }
+
+    PlaylistPrefetcher::Item item;
+    item.playlist = playlistResult.getValue().value();
+    debug("playlist found. name: {}", item.playlist.name);
+
+    auto chosenResult = chooseWeightedAnimation(item.playlist);
+    if (!chosenResult.isSuccess()) {
+        return Result<PlaylistPrefetcher::Item>{chosenResult.getError().value()};
+    }
+    item.animationId = chosenResult.getValue().value();
+    debug("...and the chosen one is {}", item.animationId);
+    if (span) {
+        span->setAttribute("chosen_animation", item.animationId);
+    }
+
+    auto animationResult = fetchAnimation(item.animationId, span);
+    if (!animationResult.isSuccess()) {
+        return Result<PlaylistPrefetcher::Item>{animationResult.getError().value()};
+    }
+    item.animation = animationResult.getValue().value();
+
+    // The playback runner shouldn't have to go to the database either
+    warmPlaybackCaches(item.animation, span);
+
+    if (span) {
+        span->setSuccess();
+    }
+    return Result<PlaylistPrefetcher::Item>{item};
+}
+
+Result<Playlist> PlaylistEvent::fetchPlaylist(const playlistId_t &playlistId, std::shared_ptr<OperationSpan> span) {
     auto dbSpan = observability ? observability->createChildOperationSpan("music_event.db_lookup", span) : nullptr;
     if (dbSpan) {
-        dbSpan->setAttribute("playlist.id", playlistStatus.playlist);
+        dbSpan->setAttribute("playlist.id", playlistId);
     }
 
-    auto playListResult = db->getPlaylist(playlistStatus.playlist, dbSpan);
+    auto playListResult = db->getPlaylist(playlistId, dbSpan);
     if (!playListResult.isSuccess()) {
-        std::string errorMessage = fmt::format("Playlist ID {} not found while in a playlist event. halting playback.",
-                                               playlistStatus.playlist);
+        std::string errorMessage = fmt::format("Playlist ID {} not found while in a playlist event.", playlistId);
         warn(errorMessage);
-        sessionManager->clearPlaylist(activeUniverse);
-        sendEmptyPlaylistUpdate(activeUniverse);
         if (dbSpan) {
             dbSpan->setError(errorMessage);
         }
@@ -259,11 +338,8 @@ Result<std::string> PlaylistEvent::chooseWeightedAnimation(const Playlist &playl
     }
 
     if (choices.empty()) {
-        std::string errorMessage =
-            fmt::format("Playlist {} has no animations to schedule. Halting playlist playback.", playlist.id);
+        std::string errorMessage = fmt::format("Playlist {} has no animations to schedule.", playlist.id);
         warn(errorMessage);
-        sessionManager->clearPlaylist(activeUniverse);
-        sendEmptyPlaylistUpdate(activeUniverse);
         return Result<std::string>{ServerError(ServerError::InternalError, errorMessage)};
     }
 
@@ -284,14 +360,11 @@ Result<Animation> PlaylistEvent::fetchAnimation(const std::string &animationId,
 
     Result<Animation> animationResult = db->getAnimation(animationId, animationSpan);
     if (!animationResult.isSuccess()) {
-        std::string errorMessage =
-            fmt::format("Animation ID {} not found while in a playlist event. Halting playlist playback.", animationId);
+        std::string errorMessage = fmt::format("Animation ID {} not found while in a playlist event.", animationId);
         warn(errorMessage);
         if (animationSpan) {
             animationSpan->setError(errorMessage);
         }
-        sessionManager->clearPlaylist(activeUniverse);
-        sendEmptyPlaylistUpdate(activeUniverse);
         return Result<Animation>{ServerError(ServerError::InternalError, errorMessage)};
     }
 
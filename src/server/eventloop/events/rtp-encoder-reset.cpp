@@ -121,31 +121,39 @@ Result<framenum_t> RtpSilentFrameEvent::executeImpl() {
             ServerError(ServerError::InternalError, "RTP server unavailable during decoder priming")};
     }
 
+    // Paced output holds each frame set until it's due, so the whole priming
+    // sequence can be queued at once. It has to be: audio is queued ahead of
+    // time when paced, and it mustn't get in front of the last silent frames.
+    const uint8_t framesNow = rtpServer->getEnqueueLeadFrames() > 0 ? framesRemaining_ : 1;
+
     traceContext_.enqueueFrame = frameNumber;
-    const auto enqueueResult = rtpServer->enqueueSilentFrame(outputLease_, primingFrameIndex_, traceContext_);
-    if (enqueueResult == rtp::RtpEnqueueResult::StaleLease) {
-        debug("Stopping stale RTP priming for {} generation {}", outputLease_.ownerId, outputLease_.generation);
-        return Result<framenum_t>{frameNumber};
-    }
-    if (enqueueResult != rtp::RtpEnqueueResult::Accepted) {
-        rtpServer->releaseOutput(outputLease_);
-        return Result<framenum_t>{
-            ServerError(ServerError::InternalError, fmt::format("RTP silent frame enqueue failed with result {}",
-                                                                static_cast<int>(enqueueResult)))};
-    }
+    for (uint8_t frame = 0; frame < framesNow; ++frame) {
+        const auto enqueueResult =
+            rtpServer->enqueueSilentFrame(outputLease_, primingFrameIndex_ + frame, traceContext_);
+        if (enqueueResult == rtp::RtpEnqueueResult::StaleLease) {
+            debug("Stopping stale RTP priming for {} generation {}", outputLease_.ownerId, outputLease_.generation);
+            return Result<framenum_t>{frameNumber};
+        }
+        if (enqueueResult != rtp::RtpEnqueueResult::Accepted) {
+            rtpServer->releaseOutput(outputLease_);
+            return Result<framenum_t>{
+                ServerError(ServerError::InternalError, fmt::format("RTP silent frame enqueue failed with result {}",
+                                                                    static_cast<int>(enqueueResult)))};
+        }
 
-    if (metrics) {
-        metrics->incrementRtpEventsProcessed();
+        if (metrics) {
+            metrics->incrementRtpEventsProcessed();
+        }
     }
 
-    if (framesRemaining_ > 1) {
+    if (framesRemaining_ > framesNow) {
         if (!eventLoop) {
             return Result<framenum_t>{
                 ServerError(ServerError::InternalError, "Event loop unavailable during decoder priming")};
         }
         constexpr framenum_t primingStep = RTP_FRAME_MS / EVENT_LOOP_PERIOD_MS;
         eventLoop->scheduleEvent(std::make_shared<RtpSilentFrameEvent>(frameNumber + primingStep, outputLease_,
-                                                                       framesRemaining_ - 1, traceContext_));
+                                                                       framesRemaining_ - framesNow, traceContext_));
     }
 
     return Result<framenum_t>{frameNumber};
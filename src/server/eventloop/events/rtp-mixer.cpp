@@ -0,0 +1,163 @@
+// src/server/eventloop/events/rtp-mixer.cpp
+
+#include <optional>
+
+#include <spdlog/spdlog.h>
+
+#include "server/eventloop/events/types.h"
+#include "server/metrics/counters.h"
+#include "server/rtp/MultiOpusRtpServer.h"
+#include "server/rtp/RtpMixer.h"
+
+#include "server/namespace-stuffs.h"
+
+namespace creatures {
+
+extern std::shared_ptr<rtp::MultiOpusRtpServer> rtpServer;
+extern std::shared_ptr<rtp::RtpMixer> rtpMixer;
+extern std::shared_ptr<EventLoop> eventLoop;
+extern std::shared_ptr<SystemCounters> metrics;
+
+namespace {
+
+// The lease the running chain of RtpMixerFrameEvents sends with. Event loop
+// only; empty when no chain is running.
+std::optional<rtp::RtpOutputLease> mixLease;
+
+constexpr framenum_t MIX_FRAME_STEP = RTP_FRAME_MS / EVENT_LOOP_PERIOD_MS;
+
+} // namespace
+
+RtpMixerTrackEvent::RtpMixerTrackEvent(framenum_t frameNumber_, std::shared_ptr<rtp::RtpMixSource> source,
+                                       rtp::RtpMixTrackOptions options, rtp::AsyncAudioTraceContext traceContext,
+                                       framenum_t mixAt)
+    : EventBase(frameNumber_), source_(std::move(source)), options_(std::move(options)),
+      traceContext_(std::move(traceContext)), mixAt_(mixAt) {}
+
+Result<framenum_t> RtpMixerTrackEvent::executeImpl() {
+    if (!rtpMixer || !rtpServer || !rtpServer->isReady() || !eventLoop) {
+        if (source_) {
+            source_->cancel();
+        }
+        return Result<framenum_t>{ServerError(ServerError::InternalError, "RTP mixer is unavailable")};
+    }
+
+    const std::string name = options_.name;
+    if (source_ && source_->isCancelled()) {
+        // Its animation stopped before it got here
+        debug("Not mixing in {}; it's already been cancelled", name);
+        return Result<framenum_t>{frameNumber};
+    }
+
+    // The worker mixes each frame set as it's due, so a running mix plays the
+    // track from the moment it's added; only starting one needs the head start
+    const bool mixing = mixLease && rtpServer->isCurrentOutput(*mixLease);
+    if (mixing && frameNumber < mixAt_) {
+        eventLoop->scheduleEvent(
+            std::make_shared<RtpMixerTrackEvent>(mixAt_, source_, std::move(options_), traceContext_, mixAt_));
+        return Result<framenum_t>{frameNumber};
+    }
+
+    const auto added = rtpMixer->addTrack(source_, std::move(options_));
+    if (!added.isSuccess()) {
+        source_->cancel();
+        warn("Unable to mix {} into the RTP output: {}", name, added.getError()->getMessage());
+        return Result<framenum_t>{added.getError().value()};
+    }
+    debug("Added {} to the RTP mix as track {} ({} playing)", name, added.getValue().value(),
+          rtpMixer->getTrackCount());
+
+    if (mixing) {
+        return Result<framenum_t>{frameNumber};
+    }
+
+    // Nothing's sending the mix, so start it the way a standalone sound starts:
+    // reset and prime, then the first frame set right behind the priming
+    mixLease = rtpServer->acquireOutput("mixer");
+    const framenum_t resetFrame = eventLoop->getNextFrameNumber() + 2;
+    eventLoop->scheduleEvent(std::make_shared<RtpEncoderResetEvent>(resetFrame, *mixLease, traceContext_));
+    eventLoop->scheduleEvent(std::make_shared<RtpMixerFrameEvent>(
+        resetFrame + RTP_PRIMING_DURATION_FRAMES - rtpServer->getEnqueueLeadFrames(), *mixLease, 0, traceContext_));
+    info("RTP mixer took the output at generation {}", mixLease->generation);
+
+    return Result<framenum_t>{frameNumber};
+}
+
+RtpMixerFrameEvent::RtpMixerFrameEvent(framenum_t frameNumber_, rtp::RtpOutputLease outputLease, size_t frameIndex,
+                                       rtp::AsyncAudioTraceContext traceContext)
+    : EventBase(frameNumber_), outputLease_(std::move(outputLease)), frameIndex_(frameIndex),
+      traceContext_(std::move(traceContext)) {}
+
+Result<framenum_t> RtpMixerFrameEvent::executeImpl() {
+    if (!rtpMixer || !rtpServer || !rtpServer->isReady() || !eventLoop) {
+        return stop("RTP mixer dependencies are unavailable");
+    }
+
+    if (rtpServer->isGenerationTripped(outputLease_.generation)) {
+        return stop(fmt::format("RTP mix stopped: {}", rtpServer->terminalFailureMessage(outputLease_.generation)));
+    }
+    if (!rtpServer->isCurrentOutput(outputLease_)) {
+        // Something else took the output; the mix doesn't resume after it
+        debug("RTP mix at generation {} was superseded", outputLease_.generation);
+        return stop();
+    }
+
+    // With paced output this runs ahead of when its frame set is due; lateness is measured against the latter
+    const framenum_t dueFrame = this->frameNumber + rtpServer->getEnqueueLeadFrames();
+    const framenum_t currentFrame = eventLoop->getCurrentFrameNumber();
+    const size_t framesToSkip =
+        currentFrame > dueFrame ? static_cast<size_t>((currentFrame - dueFrame) / MIX_FRAME_STEP) : 0;
+
+    const bool isFinalFrame = rtpMixer->getTrackCount() == 0;
+    traceContext_.enqueueFrame = currentFrame;
+    const auto enqueueResult =
+        rtpServer->enqueueMixedFrame(outputLease_, rtpMixer, frameIndex_, framesToSkip, isFinalFrame, traceContext_);
+    if (enqueueResult == rtp::RtpEnqueueResult::StaleLease) {
+        return stop();
+    }
+    if (enqueueResult != rtp::RtpEnqueueResult::Accepted) {
+        return stop(fmt::format("RTP output queue rejected mixed frame {} with result {}", frameIndex_,
+                                static_cast<int>(enqueueResult)));
+    }
+    if (metrics) {
+        metrics->incrementRtpEventsProcessed();
+    }
+
+    if (isFinalFrame) {
+        // The worker gives the output back once it's sent this one
+        debug("RTP mix finished after {} frame sets", frameIndex_ + 1);
+        if (mixLease && mixLease->generation == outputLease_.generation) {
+            mixLease.reset();
+        }
+        return Result<framenum_t>{this->frameNumber};
+    }
+
+    eventLoop->scheduleEvent(std::make_shared<RtpMixerFrameEvent>(
+        this->frameNumber + static_cast<framenum_t>(framesToSkip + 1) * MIX_FRAME_STEP, outputLease_,
+        frameIndex_ + framesToSkip + 1, traceContext_));
+    return Result<framenum_t>{this->frameNumber};
+}
+
+/**
+ * End this chain. Its tracks go with it, unless a newer chain has already
+ * started, in which case they're that one's.
+ */
+Result<framenum_t> RtpMixerFrameEvent::stop(const std::string &errorMessage) {
+    if (mixLease && mixLease->generation == outputLease_.generation) {
+        mixLease.reset();
+        if (rtpMixer) {
+            rtpMixer->clear();
+        }
+    }
+    if (errorMessage.empty()) {
+        return Result<framenum_t>{this->frameNumber};
+    }
+
+    if (rtpServer) {
+        rtpServer->releaseOutput(outputLease_);
+    }
+    error("{}", errorMessage);
+    return Result<framenum_t>{ServerError(ServerError::InternalError, errorMessage)};
+}
+
+} // namespace creatures
@@ -11,7 +11,9 @@
 #include "spdlog/spdlog.h"
 #include <fmt/format.h>
 
+#include "server/animation/PlaylistPrefetcher.h"
 #include "server/animation/StreamingPlaybackSession.h"
+#include "server/animation/player.h"
 #include "server/audio/AudioTransport.h"
 #include "server/config.h"
 #include "server/creature-server.h"
@@ -35,11 +37,30 @@ framenum_t frameStepForMs(uint32_t msPerFrame) {
 }
 } // namespace
 
-extern std::shared_ptr<Database> db;
 extern std::shared_ptr<EventLoop> eventLoop;
 extern std::shared_ptr<GPIO> gpioPins;
 extern std::shared_ptr<ObservabilityManager> observability;
 extern std::shared_ptr<ObjectCache<creatureId_t, Creature>> creatureCache;
+extern std::shared_ptr<PlaylistPrefetcher> playlistPrefetcher;
+
+namespace {
+
+// A creature this session drives isn't cached. Have a prefetcher worker load it instead
+// of waiting on the database here; its frames are skipped until it shows up. One load at
+// a time, and whatever it can't find is remembered rather than asked for again.
+void warmCachesInBackground(const std::shared_ptr<StreamingPlaybackSession> &session) {
+    if (!playlistPrefetcher || !session->getCacheLookups().begin()) {
+        return;
+    }
+    if (!playlistPrefetcher->runInBackground(fmt::format("playback-caches:{}", session->getSessionId()), [session] {
+            session->getCacheLookups().finish(warmPlaybackCaches(session->getAnimation()));
+        })) {
+        // Not queued (shutting down, or the last one is still winding up); a later frame asks again
+        session->getCacheLookups().finish({});
+    }
+}
+
+} // namespace
 
 StreamingPlaybackRunnerEvent::StreamingPlaybackRunnerEvent(framenum_t frameNumber,
                                                            std::shared_ptr<StreamingPlaybackSession> session)
@@ -138,9 +159,9 @@ Result<framenum_t> StreamingPlaybackRunnerEvent::emitDmxFrames() {
     }
 
     // Get the animation's tracks to know which creatures are involved
-    const auto &animation = session_->getAnimation();
-    for (const auto &track : animation.tracks) {
-        auto creatureId = track.creature_id;
+    const auto &tracks = session_->getAnimation().tracks;
+    for (size_t track = 0; track < tracks.size(); ++track) {
+        auto creatureId = tracks[track].creature_id;
         if (creatureId.empty()) {
             continue;
         }
@@ -164,21 +185,20 @@ Result<framenum_t> StreamingPlaybackRunnerEvent::emitDmxFrames() {
         // the TOCTOU window between the check and the fetch.
         std::shared_ptr<Creature> creature = creatureCache->tryGet(creatureId);
         if (!creature) {
-            auto creatureResult = db->getCreature(creatureId, nullptr);
-            if (!creatureResult.isSuccess()) {
-                error("Creature {} not found during streaming playback", creatureId);
-                continue;
+            if (session_->getCacheLookups().isNotFound(creatureId)) {
+                // The database doesn't have it; like before, its track plays to nothing
+                trace("Creature {} not found during streaming playback", creatureId);
+            } else {
+                debug("Creature {} not in cache; skipping frame {} while it loads", creatureId, frameIdx);
+                warmCachesInBackground(session_);
             }
-            creature = std::make_shared<Creature>(creatureResult.getValue().value());
-            creatureCache->put(creatureId, creature);
+            session_->advanceFrame(creatureId);
+            continue;
         }
 
-        // Create and schedule DMX event
-        auto dmxEvent = std::make_shared<DMXEvent>(this->frameNumber);
-        dmxEvent->universe = session_->getUniverse();
-        dmxEvent->channelOffset = creature->channel_offset;
-        dmxEvent->data.assign(frameData.begin(), frameData.end());
-        eventLoop->scheduleEvent(dmxEvent);
+        // Already on the event loop for this frame; write straight into the universe
+        DMXEvent::writeSlots(DmxSource::Playback, session_->getUniverse(), creature->channel_offset, frameData);
+        session_->getDmxWritten().note(track, session_->getUniverse(), creature->channel_offset, frameData.size());
 
         // Advance playback position
         session_->advanceFrame(creatureId);
@@ -194,6 +214,11 @@ void StreamingPlaybackRunnerEvent::performTeardown() {
 
     debug("StreamingPlaybackRunnerEvent performing teardown for '{}'", session_->getAnimation().metadata.title);
 
+    // Leave the creatures where they ended up, but let go of their channels
+    for (const auto &written : session_->getDmxWritten().all()) {
+        DMXEvent::handOffSlots(DmxSource::Playback, written.universe, written.channelOffset, written.count);
+    }
+
     if (eventLoop) {
         auto statusLightOff =
             std::make_shared<StatusLightEvent>(eventLoop->getNextFrameNumber(), StatusLight::Animation, false);
@@ -6,17 +6,20 @@
 
 #include <cstdlib>
 #include <optional>
+#include <span>
 #include <unordered_set>
 #include <vector>
 
 #include "model/CacheInvalidation.h"
 #include "model/PlaylistStatus.h"
+#include "server/animation/PlaylistPrefetcher.h"
 #include "server/config.h"
 #include "server/eventloop/event.h"
 #include "server/eventloop/eventloop.h"
 #include "server/rtp/AsyncAudioTraceContext.h"
 #include "server/rtp/AudioChunk.h"
 #include "server/rtp/AudioStreamBuffer.h"
+#include "server/rtp/RtpMixer.h"
 #include "server/rtp/RtpOutputCoordinator.h"
 #include "server/rtp/StandaloneRtpAdmission.h"
 
@@ -50,6 +53,14 @@ class CounterSendEvent : public EventBase<CounterSendEvent> {
     virtual ~CounterSendEvent() = default;
 };
 
+/**
+ * Who's writing DMX. Each source gets its own layer in the universe, and the
+ * E1.31 server merges them by priority (see the DMX_PRIORITY_* defines), so
+ * an animation track always beats a fixture pattern on the same channels no
+ * matter which one wrote last.
+ */
+enum class DmxSource : uint8_t { Direct, Playback, Pattern, Live, Hold };
+
 class DMXEvent : public EventBase<DMXEvent> {
   public:
     using EventBase::EventBase;
@@ -58,8 +69,36 @@ class DMXEvent : public EventBase<DMXEvent> {
 
     Result<framenum_t> executeImpl();
 
+    /**
+     * Write a frame straight into the E1.31 universe without going through an
+     * event. For code that's already running on the event loop (the playback
+     * runners) there's nothing to gain from scheduling a DMXEvent for the
+     * current frame, and skipping it saves an allocation and a copy per track
+     * per frame.
+     *
+     * @return false if the E1.31 server is unavailable or rejected the write
+     */
+    static bool writeSlots(universe_t universe, uint32_t channelOffset, std::span<const uint8_t> data);
+    static bool writeSlots(DmxSource source, universe_t universe, uint32_t channelOffset,
+                           std::span<const uint8_t> data);
+
+    /**
+     * Stop driving some channels from this source, so whatever is underneath
+     * it (or zero, if nothing is) goes out instead
+     */
+    static bool releaseSlots(DmxSource source, universe_t universe, uint32_t channelOffset, uint16_t count);
+
+    /**
+     * Stop driving some channels from this source, but leave them where it put
+     * them (on the Hold source) until something else writes there. Creatures
+     * don't snap anywhere when a playback or a stream ends, and a fixture
+     * pattern underneath shows through again.
+     */
+    static bool handOffSlots(DmxSource source, universe_t universe, uint32_t channelOffset, uint16_t count);
+
     universe_t universe;
     uint32_t channelOffset;
+    DmxSource source = DmxSource::Direct;
 
     // Used every time to send data
     std::vector<uint8_t> data;
@@ -110,6 +149,14 @@ class PlaylistEvent : public EventBase<PlaylistEvent> {
 
     Result<framenum_t> executeImpl();
 
+    /**
+     * Load a playlist and pick (and load) the animation to play next
+     *
+     * This is the PlaylistPrefetcher's loader, so it runs on a worker thread. It
+     * goes to the database and warms the playback caches for the animation.
+     */
+    static Result<PlaylistPrefetcher::Item> loadNextItem(const playlistId_t &playlistId);
+
   private:
     universe_t activeUniverse;
 
@@ -120,9 +167,12 @@ class PlaylistEvent : public EventBase<PlaylistEvent> {
     bool shouldSkipForActiveSession(std::shared_ptr<OperationSpan> span);
     std::optional<Result<framenum_t>> loadActivePlaylistStatus(PlaylistStatus &playlistStatus,
                                                                std::shared_ptr<OperationSpan> span);
-    Result<Playlist> fetchPlaylist(const PlaylistStatus &playlistStatus, std::shared_ptr<OperationSpan> span);
-    Result<std::string> chooseWeightedAnimation(const Playlist &playlist);
-    Result<Animation> fetchAnimation(const std::string &animationId, std::shared_ptr<OperationSpan> span);
+    std::optional<Result<framenum_t>> takeNextItem(const PlaylistStatus &playlistStatus,
+                                                   PlaylistPrefetcher::Item &nextItem,
+                                                   std::shared_ptr<OperationSpan> span);
+    static Result<Playlist> fetchPlaylist(const playlistId_t &playlistId, std::shared_ptr<OperationSpan> span);
+    static Result<std::string> chooseWeightedAnimation(const Playlist &playlist);
+    static Result<Animation> fetchAnimation(const std::string &animationId, std::shared_ptr<OperationSpan> span);
     std::unordered_set<creatureId_t> collectInvolvedCreatures(const Animation &animation);
     Result<framenum_t> scheduleChosenAnimation(const Animation &animation);
     void scheduleNextPlaylistEvent(framenum_t lastFrame);
@@ -209,6 +259,55 @@ class RtpSilentFrameEvent : public EventBase<RtpSilentFrameEvent> {
     rtp::AsyncAudioTraceContext traceContext_;
 };
 
+/**
+ * Adds a sound to the RTP mixer. If the mix isn't already playing, this takes
+ * the RTP output, primes the decoders, and starts the RtpMixerFrameEvents
+ * that send it.
+ *
+ * Something that has to line up with the sound (an animation) passes the
+ * frame it should be heard at as mixAt, and schedules this far enough ahead
+ * of that to start the mix. If the mix is already playing by then, the track
+ * waits for mixAt rather than going in early.
+ */
+class RtpMixerTrackEvent : public EventBase<RtpMixerTrackEvent> {
+  public:
+    RtpMixerTrackEvent(framenum_t frameNumber_, std::shared_ptr<rtp::RtpMixSource> source,
+                       rtp::RtpMixTrackOptions options, rtp::AsyncAudioTraceContext traceContext = {},
+                       framenum_t mixAt = 0);
+
+    virtual ~RtpMixerTrackEvent() = default;
+
+    Result<framenum_t> executeImpl();
+
+  private:
+    std::shared_ptr<rtp::RtpMixSource> source_;
+    rtp::RtpMixTrackOptions options_;
+    rtp::AsyncAudioTraceContext traceContext_;
+    framenum_t mixAt_{0};
+};
+
+/**
+ * Queues the RTP mixer's next 10ms frame set and reschedules itself for the
+ * one after, for as long as the mixer has tracks. When the last one's done
+ * it sends a final frame set and gives the output back.
+ */
+class RtpMixerFrameEvent : public EventBase<RtpMixerFrameEvent> {
+  public:
+    RtpMixerFrameEvent(framenum_t frameNumber_, rtp::RtpOutputLease outputLease, size_t frameIndex,
+                       rtp::AsyncAudioTraceContext traceContext = {});
+
+    virtual ~RtpMixerFrameEvent() = default;
+
+    Result<framenum_t> executeImpl();
+
+  private:
+    Result<framenum_t> stop(const std::string &errorMessage = {});
+
+    rtp::RtpOutputLease outputLease_;
+    size_t frameIndex_{0};
+    rtp::AsyncAudioTraceContext traceContext_;
+};
+
 /**
  * PlaybackRunnerEvent - Cooperative playback event that executes one "slice" of animation
  *
@@ -0,0 +1,185 @@
+/**
+ * @file scheduler.cpp
+ * @brief Timing-wheel event scheduler with per-thread submission rings
+ */
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "server/eventloop/scheduler.h"
+
+namespace creatures {
+
+namespace {
+std::atomic<uint64_t> nextSchedulerId{1};
+} // namespace
+
+EventScheduler::EventScheduler(size_t ringCapacity)
+    : id_(nextSchedulerId.fetch_add(1, std::memory_order_relaxed)), ringCapacity_(ringCapacity) {
+    for (auto &ring : rings_) {
+        ring.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+EventScheduler::~EventScheduler() {
+    // Drop anything still sitting in a ring. Threads that exit later only hold
+    // the (now empty) ring itself.
+    const size_t ringCount = ringCount_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < ringCount; ++i) {
+        std::shared_ptr<Event> event;
+        while (rings_[i].load(std::memory_order_acquire)->ring.tryPop(event)) {
+        }
+    }
+    wheel_.drain([](TimerWheelNode *node) { static_cast<ScheduledEvent *>(node)->event.reset(); });
+}
+
+void EventScheduler::bindConsumerThread() { consumerThread_.store(std::this_thread::get_id(), std::memory_order_release); }
+
+void EventScheduler::submit(std::shared_ptr<Event> event) {
+    if (!event) {
+        return;
+    }
+
+    pending_.fetch_add(1, std::memory_order_relaxed);
+
+    if (consumerThread_.load(std::memory_order_relaxed) == std::this_thread::get_id()) {
+        file(std::move(event));
+        return;
+    }
+
+    if (auto *producer = ringForThisThread(); producer && producer->ring.tryPush(std::move(event))) {
+        return;
+    }
+
+    // Ring full, or no ring left to hand out. Slow, but never lossy.
+    overflowSubmissions_.fetch_add(1, std::memory_order_relaxed);
+    std::lock_guard lock(overflowMutex_);
+    overflow_.push_back(std::move(event));
+    overflowPending_.store(true, std::memory_order_release);
+}
+
+void EventScheduler::advanceTo(framenum_t frame) {
+    drainSubmissions();
+    wheel_.advanceTo(frame);
+}
+
+std::shared_ptr<Event> EventScheduler::popDue() {
+    auto *node = static_cast<ScheduledEvent *>(wheel_.popDue());
+    if (!node) {
+        return nullptr;
+    }
+
+    auto event = std::move(node->event);
+    releaseNode(node);
+    pending_.fetch_sub(1, std::memory_order_relaxed);
+    return event;
+}
+
+EventScheduler::ProducerRing *EventScheduler::ringForThisThread() {
+
+    // One entry per scheduler this thread has submitted to. The destructor
+    // hands the ring back when the thread exits.
+    struct Claim {
+        uint64_t schedulerId;
+        std::shared_ptr<ProducerRing> ring;
+
+        Claim(uint64_t schedulerId_, std::shared_ptr<ProducerRing> ring_)
+            : schedulerId(schedulerId_), ring(std::move(ring_)) {}
+        Claim(Claim &&) noexcept = default;
+        Claim &operator=(Claim &&) noexcept = default;
+        ~Claim() {
+            if (ring) {
+                ring->claimed.store(false, std::memory_order_release);
+            }
+        }
+    };
+    thread_local std::vector<Claim> claims;
+
+    for (const auto &claim : claims) {
+        if (claim.schedulerId == id_) {
+            return claim.ring.get();
+        }
+    }
+
+    std::lock_guard lock(ringRegistrationMutex_);
+
+    // Reuse a ring abandoned by a thread that has since exited
+    for (const auto &ring : ringStorage_) {
+        bool expected = false;
+        if (ring->claimed.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+            claims.emplace_back(id_, ring);
+            return ring.get();
+        }
+    }
+
+    const size_t index = ringCount_.load(std::memory_order_relaxed);
+    if (index >= rings_.size()) {
+        return nullptr;
+    }
+
+    auto ring = std::make_shared<ProducerRing>(ringCapacity_);
+    ring->claimed.store(true, std::memory_order_relaxed);
+    ringStorage_.push_back(ring);
+    rings_[index].store(ring.get(), std::memory_order_release);
+    ringCount_.store(index + 1, std::memory_order_release);
+
+    claims.emplace_back(id_, std::move(ring));
+    return claims.back().ring.get();
+}
+
+void EventScheduler::drainSubmissions() {
+
+    const size_t ringCount = ringCount_.load(std::memory_order_acquire);
+    std::shared_ptr<Event> event;
+    for (size_t i = 0; i < ringCount; ++i) {
+        auto *producer = rings_[i].load(std::memory_order_acquire);
+        while (producer->ring.tryPop(event)) {
+            file(std::move(event));
+        }
+    }
+
+    if (overflowPending_.exchange(false, std::memory_order_acquire)) {
+        {
+            std::lock_guard lock(overflowMutex_);
+            overflowScratch_.swap(overflow_);
+        }
+        for (auto &overflowed : overflowScratch_) {
+            file(std::move(overflowed));
+        }
+        overflowScratch_.clear();
+    }
+}
+
+void EventScheduler::file(std::shared_ptr<Event> event) {
+    auto *node = allocateNode();
+    node->deadline = event->frameNumber;
+    node->event = std::move(event);
+    wheel_.insert(node);
+}
+
+EventScheduler::ScheduledEvent *EventScheduler::allocateNode() {
+    if (!freeNodes_) {
+        auto block = std::make_unique<ScheduledEvent[]>(kNodeBlockSize);
+        for (size_t i = 0; i < kNodeBlockSize; ++i) {
+            block[i].next = freeNodes_;
+            freeNodes_ = &block[i];
+        }
+        nodeBlocks_.push_back(std::move(block));
+    }
+
+    auto *node = freeNodes_;
+    freeNodes_ = static_cast<ScheduledEvent *>(node->next);
+    node->next = nullptr;
+    return node;
+}
+
+void EventScheduler::releaseNode(ScheduledEvent *node) {
+    node->next = freeNodes_;
+    freeNodes_ = node;
+}
+
+} // namespace creatures
@@ -0,0 +1,137 @@
+//
+// scheduler.h
+//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "server/config.h"
+#include "server/eventloop/event.h"
+#include "server/eventloop/timerwheel.h"
+#include "util/SpscRing.h"
+
+#include "server/namespace-stuffs.h"
+
+namespace creatures {
+
+/**
+ * Event scheduler backed by a hierarchical timing wheel
+ *
+ * Any thread may submit(). Only the event loop thread (the "consumer") may call
+ * bindConsumerThread(), advanceTo() and popDue().
+ *
+ *  - Submissions from the consumer thread itself (runners rescheduling their
+ *    next slice, fixture ticks, etc.) go straight into the wheel. No atomics
+ *    beyond the pending count, no locks.
+ *  - Every other thread gets its own SPSC submission ring on first use, which
+ *    the consumer drains once per frame. HTTP handlers never contend with the
+ *    event loop or with each other.
+ *  - Wheel entries come from a node pool owned by the consumer, so filing an
+ *    event doesn't touch the allocator once the pool has warmed up.
+ *
+ * A ring that's full, or a process with more scheduling threads than
+ * EVENT_SUBMISSION_MAX_PRODUCERS, falls back to a mutex-protected overflow
+ * list. That path is slow but never drops an event.
+ */
+class EventScheduler {
+  public:
+    explicit EventScheduler(size_t ringCapacity = EVENT_SUBMISSION_RING_CAPACITY);
+    ~EventScheduler();
+
+    EventScheduler(const EventScheduler &) = delete;
+    EventScheduler &operator=(const EventScheduler &) = delete;
+
+    /**
+     * Queue an event to run on (or after) its frameNumber. Safe from any thread.
+     */
+    void submit(std::shared_ptr<Event> event);
+
+    /**
+     * Mark the calling thread as the consumer. Submissions from this thread
+     * bypass the rings from now on.
+     */
+    void bindConsumerThread();
+
+    /**
+     * Pull in everything other threads have submitted and move the wheel
+     * forward to the given frame. Consumer thread only.
+     */
+    void advanceTo(framenum_t frame);
+
+    /**
+     * Next event due at or before the current frame, or nullptr. Consumer
+     * thread only.
+     */
+    [[nodiscard]] std::shared_ptr<Event> popDue();
+
+    /**
+     * Events submitted but not yet handed out by popDue(). Safe from any thread.
+     */
+    [[nodiscard]] size_t size() const { return pending_.load(std::memory_order_relaxed); }
+
+    /**
+     * How many submissions had to take the locked overflow path
+     */
+    [[nodiscard]] uint64_t getOverflowSubmissions() const {
+        return overflowSubmissions_.load(std::memory_order_relaxed);
+    }
+
+  private:
+    struct ScheduledEvent : TimerWheelNode {
+        std::shared_ptr<Event> event;
+    };
+
+    struct ProducerRing {
+        explicit ProducerRing(size_t capacity) : ring(capacity) {}
+
+        SpscRing<std::shared_ptr<Event>> ring;
+
+        // Set while a live thread owns the producer side. Released when that
+        // thread exits so the next new thread can reuse the ring instead of
+        // growing the list forever (oatpp spins up a thread per connection).
+        std::atomic<bool> claimed{false};
+    };
+
+    static constexpr size_t kNodeBlockSize = 256;
+
+    ProducerRing *ringForThisThread();
+    void drainSubmissions();
+    void file(std::shared_ptr<Event> event);
+    ScheduledEvent *allocateNode();
+    void releaseNode(ScheduledEvent *node);
+
+    // Unique per instance so thread-local ring claims can't be confused
+    // between schedulers (tests and the benchmark make several).
+    const uint64_t id_;
+    const size_t ringCapacity_;
+
+    std::atomic<std::thread::id> consumerThread_{};
+    std::atomic<size_t> pending_{0};
+    std::atomic<uint64_t> overflowSubmissions_{0};
+
+    // Published lock-free for the consumer; registration itself takes the mutex
+    std::array<std::atomic<ProducerRing *>, EVENT_SUBMISSION_MAX_PRODUCERS> rings_{};
+    std::atomic<size_t> ringCount_{0};
+    std::mutex ringRegistrationMutex_;
+    std::vector<std::shared_ptr<ProducerRing>> ringStorage_;
+
+    std::mutex overflowMutex_;
+    std::vector<std::shared_ptr<Event>> overflow_;
+    std::vector<std::shared_ptr<Event>> overflowScratch_; // consumer-only
+    std::atomic<bool> overflowPending_{false};
+
+    // Consumer-only state
+    TimerWheel wheel_;
+    std::vector<std::unique_ptr<ScheduledEvent[]>> nodeBlocks_;
+    ScheduledEvent *freeNodes_ = nullptr;
+};
+
+} // namespace creatures
@@ -0,0 +1,48 @@
+
+#include "server/eventloop/sleep.h"
+
+#include <cerrno>
+#include <ctime>
+#include <thread>
+
+namespace creatures {
+
+namespace {
+
+// Tell the CPU we're spinning so it can go easy on the sibling hyperthread (and power)
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield");
+#endif
+}
+
+} // namespace
+
+void sleepUntil(std::chrono::steady_clock::time_point deadline) { std::this_thread::sleep_until(deadline); }
+
+void hybridSleepUntil(std::chrono::steady_clock::time_point deadline, std::chrono::nanoseconds spin) {
+    using namespace std::chrono;
+
+    const auto wakeAt = deadline - spin;
+    if (steady_clock::now() < wakeAt) {
+#if defined(__linux__)
+        // steady_clock is CLOCK_MONOTONIC on Linux, so its epoch lines up with clock_nanosleep's
+        const auto sinceEpoch = duration_cast<nanoseconds>(wakeAt.time_since_epoch()).count();
+        timespec wake{};
+        wake.tv_sec = static_cast<time_t>(sinceEpoch / 1'000'000'000);
+        wake.tv_nsec = static_cast<long>(sinceEpoch % 1'000'000'000);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, nullptr) == EINTR) {
+        }
+#else
+        std::this_thread::sleep_until(wakeAt);
+#endif
+    }
+
+    while (steady_clock::now() < deadline) {
+        cpuRelax();
+    }
+}
+
+} // namespace creatures
@@ -0,0 +1,28 @@
+//
+// sleep.h
+//
+
+#pragma once
+
+#include <chrono>
+
+namespace creatures {
+
+/**
+ * Sleep until a deadline on the steady clock
+ *
+ * Wakes up whenever the scheduler gets around to it, which is usually 50-100us
+ * late and sometimes much later.
+ */
+void sleepUntil(std::chrono::steady_clock::time_point deadline);
+
+/**
+ * Sleep until `spin` before a deadline, then spin until it arrives
+ *
+ * The sleep is an absolute clock_nanosleep() where there is one, so a late
+ * wakeup doesn't push the deadline back. The spin soaks up the usual scheduler
+ * lateness, at the cost of keeping a core busy for up to `spin` per call.
+ */
+void hybridSleepUntil(std::chrono::steady_clock::time_point deadline, std::chrono::nanoseconds spin);
+
+} // namespace creatures
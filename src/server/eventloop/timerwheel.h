@@ -0,0 +1,235 @@
+//
+// timerwheel.h
+//
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#include "server/namespace-stuffs.h"
+
+namespace creatures {
+
+/**
+ * Intrusive hook for anything that lives in a TimerWheel.
+ *
+ * The wheel never allocates; it just threads these together. A node may only
+ * be in one wheel at a time.
+ */
+struct TimerWheelNode {
+    TimerWheelNode *next = nullptr;
+    framenum_t deadline = 0;
+};
+
+/**
+ * Hierarchical timing wheel keyed by frame number
+ *
+ * Four levels of 256 slots each cover 2^32 frames (~49 days at 1ms) with O(1)
+ * insert and O(1) amortized expiry. Anything further out than that parks on an
+ * overflow list and gets re-filed whenever the top level wraps.
+ *
+ * Nodes whose deadline has already arrived go straight onto the due list, so
+ * an event that schedules another event for the current frame still runs in
+ * this frame — the same contract the old priority queue had.
+ *
+ * Like the priority queue it replaced, there's no ordering promise between
+ * nodes due on the same frame (in practice it's first-in, first-out).
+ *
+ * Not thread safe. The event loop owns it; other threads go through the
+ * submission rings in EventScheduler.
+ */
+class TimerWheel {
+  public:
+    static constexpr unsigned kBitsPerLevel = 8;
+    static constexpr unsigned kLevels = 4;
+    static constexpr size_t kSlotsPerLevel = size_t{1} << kBitsPerLevel;
+    static constexpr uint64_t kSlotMask = kSlotsPerLevel - 1;
+    static constexpr uint64_t kWheelSpanMask = (uint64_t{1} << (kLevels * kBitsPerLevel)) - 1;
+
+    explicit TimerWheel(framenum_t startFrame = 0) : now_(startFrame) {}
+
+    TimerWheel(const TimerWheel &) = delete;
+    TimerWheel &operator=(const TimerWheel &) = delete;
+
+    /**
+     * File a node under its deadline
+     */
+    void insert(TimerWheelNode *node) {
+        node->next = nullptr;
+        ++size_;
+        file(node);
+    }
+
+    /**
+     * Move the wheel forward to the given frame, collecting everything that
+     * comes due onto the due list. Stretches with nothing on the wheel are
+     * skipped rather than stepped through.
+     */
+    void advanceTo(framenum_t frame) {
+        while (now_ < frame) {
+            if (onWheel_ == 0) {
+                // Nothing on the wheel proper, so there's nothing to step
+                // through. Jump to the frame, or to just before the next
+                // overflow re-file if that comes first.
+                const framenum_t lastBeforeWrap = now_ | kWheelSpanMask;
+                if (lastBeforeWrap >= frame) {
+                    now_ = frame;
+                    return;
+                }
+                now_ = lastBeforeWrap;
+            }
+            tick();
+        }
+    }
+
+    /**
+     * Take the next due node, or nullptr if nothing is due at now()
+     */
+    [[nodiscard]] TimerWheelNode *popDue() {
+        TimerWheelNode *node = due_.head;
+        if (node) {
+            due_.head = node->next;
+            if (!due_.head) {
+                due_.tail = nullptr;
+            }
+            --due_.count;
+            node->next = nullptr;
+            --size_;
+        }
+        return node;
+    }
+
+    [[nodiscard]] framenum_t now() const { return now_; }
+    [[nodiscard]] size_t size() const { return size_; }
+    [[nodiscard]] bool empty() const { return size_ == 0; }
+
+    /**
+     * Unlink every node, handing each to the callback (used on shutdown so the
+     * owner can release whatever the nodes hold)
+     */
+    template <typename Fn> void drain(Fn &&fn) {
+        auto drainList = [&fn](List &list) {
+            TimerWheelNode *node = list.take();
+            while (node) {
+                TimerWheelNode *next = node->next;
+                node->next = nullptr;
+                fn(node);
+                node = next;
+            }
+        };
+        drainList(due_);
+        for (auto &level : levels_) {
+            for (auto &slot : level) {
+                drainList(slot);
+            }
+        }
+        drainList(overflow_);
+        size_ = 0;
+        onWheel_ = 0;
+    }
+
+  private:
+    struct List {
+        TimerWheelNode *head = nullptr;
+        TimerWheelNode *tail = nullptr;
+        size_t count = 0;
+
+        void append(TimerWheelNode *node) {
+            if (tail) {
+                tail->next = node;
+            } else {
+                head = node;
+            }
+            tail = node;
+            ++count;
+        }
+
+        void splice(List &other) {
+            if (!other.head) {
+                return;
+            }
+            if (tail) {
+                tail->next = other.head;
+            } else {
+                head = other.head;
+            }
+            tail = other.tail;
+            count += other.count;
+            other.head = other.tail = nullptr;
+            other.count = 0;
+        }
+
+        TimerWheelNode *take() {
+            TimerWheelNode *node = head;
+            head = tail = nullptr;
+            count = 0;
+            return node;
+        }
+    };
+
+    void file(TimerWheelNode *node) {
+        if (node->deadline <= now_) {
+            due_.append(node);
+            return;
+        }
+
+        // The highest bit that differs between now and the deadline picks the
+        // level: everything above it is shared, so the node only needs to
+        // wait for that digit to roll over before it's re-filed lower down.
+        const uint64_t differing = node->deadline ^ now_;
+        const unsigned level = (static_cast<unsigned>(std::bit_width(differing)) - 1) / kBitsPerLevel;
+        if (level >= kLevels) {
+            overflow_.append(node);
+            return;
+        }
+
+        const auto slot = static_cast<size_t>((node->deadline >> (level * kBitsPerLevel)) & kSlotMask);
+        levels_[level][slot].append(node);
+        ++onWheel_;
+    }
+
+    void refile(List &list, bool fromWheel) {
+        TimerWheelNode *node = list.take();
+        while (node) {
+            TimerWheelNode *next = node->next;
+            node->next = nullptr;
+            if (fromWheel) {
+                --onWheel_;
+            }
+            file(node);
+            node = next;
+        }
+    }
+
+    void tick() {
+        ++now_;
+
+        // Cascade from the top down so nodes can fall more than one level in
+        // the same tick.
+        if ((now_ & kWheelSpanMask) == 0) {
+            refile(overflow_, false);
+        }
+        for (unsigned level = kLevels - 1; level > 0; --level) {
+            const uint64_t lowerMask = (uint64_t{1} << (level * kBitsPerLevel)) - 1;
+            if ((now_ & lowerMask) == 0) {
+                refile(levels_[level][(now_ >> (level * kBitsPerLevel)) & kSlotMask], true);
+            }
+        }
+
+        List &slot = levels_[0][now_ & kSlotMask];
+        onWheel_ -= slot.count;
+        due_.splice(slot);
+    }
+
+    framenum_t now_;
+    size_t size_ = 0;
+    size_t onWheel_ = 0; // filed in a level slot (not due, not overflow)
+    std::array<std::array<List, kSlotsPerLevel>, kLevels> levels_{};
+    List overflow_;
+    List due_;
+};
+
+} // namespace creatures
@@ -13,7 +13,6 @@
 
 namespace creatures {
 
-extern std::shared_ptr<EventLoop> eventLoop;
 extern std::shared_ptr<ObservabilityManager> observability;
 
 bool FixturePatternRunner::start(const DmxFixture &fixture, const FixturePattern &pattern, universe_t universe,
@@ -343,25 +342,13 @@ bool FixturePatternRunner::hasLive(const fixtureId_t &fixtureId) const {
 
 bool FixturePatternRunner::tick(framenum_t currentFrame, std::shared_ptr<OperationSpan> tickSpan) {
 
-    // KNOWN LIMITATION: animation-vs-pattern precedence is not enforced here.
-    //
-    // The plan (plan/dmx-fixture.md → "Precedence: animation tracks vs patterns") says
-    // animation tracks should win over fixture patterns when both target the same
-    // (universe, channel) range. That is NOT currently implemented — both this tick
-    // and PlaybackRunnerEvent::emitDmxFrames enqueue DMXEvents to the same event loop,
-    // and the wire value for any given byte is just "whichever event the loop processes
-    // last for that frame." Because the pattern tick runs at ~20 ms cadence and the
-    // playback runner at 1 ms, animation will usually win by writing more recently —
-    // but this is incidental, not guaranteed, and a fixture whose channel range overlaps
-    // a creature's animation output can stomp the animation in unpredictable ways.
-    //
-    // Mitigations (not yet implemented):
-    //   1. Cheap: at start() time, refuse to start a pattern on a fixture whose
-    //      (universe, channel_offset..+span) overlaps an active PlaybackSession track.
-    //   2. Proper: a merge step in the event loop that combines pending DMXEvents
-    //      for the same frame, with documented priority.
-    //
-    // This is tracked in the "DmxFixture follow-up work" section of AGENTS.md.
+    // Precedence: patterns, live control, and animation tracks each write into the
+    // universe as their own merge source (see DmxSource). The E1.31 server keeps a layer
+    // per source and the highest priority one driving a channel wins, so an animation
+    // track beats a pattern on the same (universe, channel) range no matter which one
+    // wrote last, and live control beats both. When a pattern finishes or live control
+    // times out it releases its channels instead of writing zeros, so whatever is
+    // underneath shows through.
 
     std::vector<ActivePattern *> toEmit;
     std::vector<fixtureId_t> finished;
@@ -460,6 +447,8 @@ bool FixturePatternRunner::tick(framenum_t currentFrame, std::shared_ptr<Operati
     struct LiveEmit {
         universe_t universe;
         uint16_t channelOffset;
+        uint16_t channelSpan;
+        bool release = false;
         std::vector<uint8_t> data;
         const std::string *triggerTraceId;
         const std::string *triggerSpanId;
@@ -477,9 +466,10 @@ bool FixturePatternRunner::tick(framenum_t currentFrame, std::shared_ptr<Operati
         le.triggerTraceId = &entry.triggerTraceId;
         le.triggerSpanId = &entry.triggerSpanId;
         le.fixtureId = &entry.fixtureId;
+        le.channelSpan = entry.channelSpan;
         if (currentFrame >= entry.deadlineFrame) {
-            // Deadline reached: emit one final blackout and queue for removal.
-            le.data.assign(entry.channelSpan, 0);
+            // Deadline reached: hand the channels back and queue for removal.
+            le.release = true;
             liveFinished.push_back(entry.fixtureId);
             ++liveBlackoutCount;
         } else {
@@ -488,29 +478,39 @@ bool FixturePatternRunner::tick(framenum_t currentFrame, std::shared_ptr<Operati
         liveToEmit.push_back(std::move(le));
     }
 
-    // Schedule DMX events. We keep the lock during scheduling so the entries don't get yanked
-    // out from under us, but the eventLoop has its own internal synchronization.
-    if (eventLoop) {
-        for (auto *entry : toEmit) {
-            auto dmxEvent = std::make_shared<DMXEvent>(currentFrame);
-            dmxEvent->universe = entry->universe;
-            dmxEvent->channelOffset = entry->channelOffset;
-            dmxEvent->data = entry->lastRenderedValues;
-            eventLoop->scheduleEvent(dmxEvent);
+    // Write straight into the universes. We're already on the event loop (this runs from
+    // FixturePatternTickEvent), so there's nothing to gain from scheduling a DMXEvent for
+    // the current frame. We keep the lock so the entries don't get yanked out from under us.
+    size_t dmxWrites = 0;
+    size_t dmxFailures = 0;
+    for (auto *entry : toEmit) {
+        const bool ok = entry->phase == FixturePatternPhase::Done
+                            ? DMXEvent::releaseSlots(DmxSource::Pattern, entry->universe, entry->channelOffset,
+                                                     entry->channelSpan)
+                            : DMXEvent::writeSlots(DmxSource::Pattern, entry->universe, entry->channelOffset,
+                                                   entry->lastRenderedValues);
+        if (ok) {
+            ++dmxWrites;
+        } else {
+            ++dmxFailures;
         }
-        for (const auto &le : liveToEmit) {
-            auto dmxEvent = std::make_shared<DMXEvent>(currentFrame);
-            dmxEvent->universe = le.universe;
-            dmxEvent->channelOffset = le.channelOffset;
-            dmxEvent->data = le.data;
-            eventLoop->scheduleEvent(dmxEvent);
+    }
+    for (const auto &le : liveToEmit) {
+        const bool ok = le.release ? DMXEvent::releaseSlots(DmxSource::Live, le.universe, le.channelOffset,
+                                                            le.channelSpan)
+                                   : DMXEvent::writeSlots(DmxSource::Live, le.universe, le.channelOffset, le.data);
+        if (ok) {
+            ++dmxWrites;
+        } else {
+            ++dmxFailures;
         }
-    } else {
-        warn("FixturePatternRunner::tick: eventLoop unavailable, dropping {} pattern + {} live frames", toEmit.size(),
-             liveToEmit.size());
+    }
+
+    if (dmxFailures > 0) {
+        warn("FixturePatternRunner::tick: {} of {} DMX writes were rejected", dmxFailures, dmxWrites + dmxFailures);
         if (tickSpan) {
-            tickSpan->setAttribute("error.type", "EventLoopUnavailable");
-            tickSpan->setError("eventLoop unavailable, DMX frames dropped");
+            tickSpan->setAttribute("error.type", "DmxWriteRejected");
+            tickSpan->setError("DMX writes rejected by the E1.31 server");
         }
     }
 
@@ -522,8 +522,7 @@ bool FixturePatternRunner::tick(framenum_t currentFrame, std::shared_ptr<Operati
         tickSpan->setAttribute("fixture.patterns.fade_out_count", static_cast<int64_t>(fadeOutCount));
         tickSpan->setAttribute("fixture.live.active_count", static_cast<int64_t>(liveToEmit.size()));
         tickSpan->setAttribute("fixture.live.blackout_count", liveBlackoutCount);
-        tickSpan->setAttribute("fixture.dmx_events.emitted",
-                               static_cast<int64_t>(eventLoop ? (toEmit.size() + liveToEmit.size()) : 0));
+        tickSpan->setAttribute("fixture.dmx_events.emitted", static_cast<int64_t>(dmxWrites));
 
         // Surface the trigger trace IDs of the first entry (pattern or live) that has one.
         // This gives a single Honeycomb-searchable link back to the originating REST/activity
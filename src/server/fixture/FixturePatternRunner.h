@@ -144,11 +144,10 @@ class FixturePatternRunner {
     bool hasLive(const fixtureId_t &fixtureId) const;
 
     /**
-     * Advance all active patterns and schedule one DMXEvent per fixture for the current frame.
+     * Advance all active patterns and write each fixture's DMX for the current frame.
      *
-     * @param tickSpan optional span for recording per-tick counters (active count, emitted
-     *                 DMX events, fixtures finished, etc.). Treated as parent for emitted
-     *                 DMXEvents' linkage — see FixturePatternTickEvent.
+     * @param tickSpan optional span for recording per-tick counters (active count, DMX
+     *                 writes, fixtures finished, etc.) — see FixturePatternTickEvent.
      * @return true if any patterns are still active (caller should reschedule the tick)
      */
     bool tick(framenum_t currentFrame, std::shared_ptr<class OperationSpan> tickSpan = nullptr);
@@ -823,12 +823,9 @@ void JobWorker::handleAdHocSpeechJob(JobState &jobState) {
             creatureName = creature.name.empty() ? creatureId : creature.name;
             updateProgress(0.45f);
 
-            // Prewarm audio cache in background
-            auto cacheFuture = std::async(std::launch::async, [wp = wavPath, span = jobState.span]() {
-                debug("Starting background cache prewarm for {}", wp.string());
-                return prewarmAudioCache(wp, span);
-            });
-            auto cacheResult = cacheFuture.get();
+            // Prewarm the audio cache; the encode itself runs on the compute pool
+            debug("Starting cache prewarm for {}", wavPath.string());
+            auto cacheResult = prewarmAudioCache(wavPath, jobState.span);
             if (!cacheResult.isSuccess()) {
                 warn("Audio cache prewarm failed: {}", cacheResult.getError()->getMessage());
             }
@@ -1308,9 +1305,8 @@ void JobWorker::handleStageRerenderJob(JobState &jobState) {
             const std::size_t slot = creatures::resolvedMouthSlot(creatureResult.getValue().value());
             std::vector<uint8_t> scraped;
             scraped.reserve(track.frames.size());
-            for (const auto &encoded : track.frames) {
-                const auto decoded = decodeBase64(encoded);
-                scraped.push_back(slot < decoded.size() ? decoded[slot] : 0);
+            for (const auto frame : track.frames) {
+                scraped.push_back(slot < frame.size() ? frame[slot] : 0);
             }
             mouthByCreature[track.creature_id] = std::move(scraped);
         }
@@ -1389,8 +1385,8 @@ void JobWorker::handleStageRerenderJob(JobState &jobState) {
                 if (loopTrack == loopAnimation.tracks.end()) {
                     return fmt::format("animation {} has no track for this creature", loopAnimationId);
                 }
-                for (const auto &frame : loopTrack->frames) {
-                    out.push_back(decodeBase64(frame));
+                for (const auto frame : loopTrack->frames) {
+                    out.emplace_back(frame.begin(), frame.end());
                 }
                 return {};
             };
@@ -2249,8 +2245,8 @@ void JobWorker::handleDialogJob(JobState &jobState) {
 
         std::vector<std::vector<uint8_t>> baseFrames;
         baseFrames.reserve(trackIt->frames.size());
-        for (const auto &f : trackIt->frames) {
-            baseFrames.push_back(decodeBase64(f));
+        for (const auto frame : trackIt->frames) {
+            baseFrames.emplace_back(frame.begin(), frame.end());
         }
         if (baseFrames.empty()) {
             return failJob(
@@ -2292,8 +2288,8 @@ void JobWorker::handleDialogJob(JobState &jobState) {
                     warn("creature '{}': idle anim {} has no track for this creature; freezing during silence instead",
                          cinfo->creatureId, idleChosenId);
                 } else {
-                    for (const auto &ef : idleTrackIt->frames) {
-                        idleFrames.push_back(decodeBase64(ef));
+                    for (const auto frame : idleTrackIt->frames) {
+                        idleFrames.emplace_back(frame.begin(), frame.end());
                     }
                     if (idleFrames.empty() || idleFrames.front().size() != baseFrames.front().size()) {
                         warn("creature '{}': idle anim {} frames unusable ({} frames, width {} vs speech width {}); "
@@ -11,11 +11,12 @@
 #include "spdlog/sinks/base_sink.h"
 
 #include <oatpp/core/Types.hpp>
-#include <oatpp/parser/json/mapping/ObjectMapper.hpp>
 
 #include "model/LogItem.h"
 #include "server/ws/dto/websocket/LogMessage.h"
 #include "server/ws/dto/websocket/MessageTypes.h"
+#include "server/ws/websocket/OutgoingMessage.h"
+#include "server/ws/websocket/TopicSubscriptions.h"
 
 namespace spdlog::sinks {
 
@@ -29,9 +30,9 @@ namespace spdlog::sinks {
  */
 template <typename Mutex> class CreatureLogSink final : public base_sink<Mutex> {
   public:
-    explicit CreatureLogSink(std::shared_ptr<moodycamel::BlockingConcurrentQueue<std::string>> &queue) : queue_(queue) {
-        jsonMapper = oatpp::parser::json::mapping::ObjectMapper::createShared();
-    }
+    using Queue = moodycamel::BlockingConcurrentQueue<creatures::ws::OutgoingMessage>;
+
+    explicit CreatureLogSink(std::shared_ptr<Queue> &queue) : queue_(queue) {}
 
   protected:
     void sink_it_(const details::log_msg &msg) override {
@@ -43,6 +44,11 @@ template <typename Mutex> class CreatureLogSink final : public base_sink<Mutex>
          * recursive call to sink_it_. 😅
          */
 
+        // Skip the conversion and serialization if no client wants logs at this level
+        if (!creatures::ws::anyoneSubscribedToLogsAt(mapSpdlogLevel(msg.level))) {
+            return;
+        }
+
         const auto logItem = convertSpdlogToLogItem(msg);
         const auto logItemDto = creatures::convertToDto(logItem);
 
@@ -50,10 +56,8 @@ template <typename Mutex> class CreatureLogSink final : public base_sink<Mutex>
         message->command = toString(creatures::ws::MessageType::LogMessage);
         message->payload = logItemDto;
 
-        std::string messageAsString = jsonMapper->writeToString(message);
-
         // Off to the queue with you!
-        queue_->enqueue(std::move(messageAsString));
+        queue_->enqueue(creatures::ws::serializeForClients(creatures::ws::MessageType::LogMessage, message));
     }
 
     void flush_() override {}
@@ -109,7 +113,6 @@ template <typename Mutex> class CreatureLogSink final : public base_sink<Mutex>
     }
 
   private:
-    std::shared_ptr<moodycamel::BlockingConcurrentQueue<std::string>> &queue_;
-    std::shared_ptr<oatpp::parser::json::mapping::ObjectMapper> jsonMapper;
+    std::shared_ptr<Queue> &queue_;
 };
 } // namespace spdlog::sinks
\ No newline at end of file
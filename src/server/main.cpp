@@ -2,13 +2,17 @@
 // main.cpp
 //
 
+#include <algorithm>
 #include <atomic>
 #include <csignal>
 #include <filesystem>
+#include <iterator>
 #include <locale>
 #include <memory>
 #include <string>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 
 // spdlog
 #include "spdlog/sinks/stdout_color_sinks.h"
@@ -29,7 +33,10 @@
 // Our stuff
 #include "Version.h"
 #include "model/PlaylistStatus.h"
+#include "server/animation/AnimationCache.h"
+#include "server/animation/PlaylistPrefetcher.h"
 #include "server/animation/SessionManager.h"
+#include "server/audio/AudioCachePrewarmer.h"
 #include "server/audio/LocalAudioPlaybackCoordinator.h"
 #include "server/audio/NativeAudioPlaybackService.h"
 #include "server/config.h"
@@ -48,10 +55,16 @@
 #include "server/rtp/AudioLoadExecutor.h"
 #include "server/rtp/AudioStreamBuffer.h"
 #include "server/rtp/MultiOpusRtpServer.h"
+#include "server/rtp/RtpMixer.h"
+#include "server/rtp/SendmmsgRtpTransport.h"
+#include "server/rtp/UvgRtpTransport.h"
 #include "server/sensors/SensorDataCache.h"
+#include "server/storage/Storage.h"
 #include "server/ws/service/DmxFixtureService.h"
 #include "server/ws/service/FixtureActivityHook.h"
+#include "server/ws/websocket/OutgoingMessage.h"
 #include "util/AudioCache.h"
+#include "util/ComputePool.h"
 #include "util/ObservabilityManager.h"
 #include "util/cache.h"
 #include "util/loggingUtils.h"
@@ -98,6 +111,19 @@ std::shared_ptr<ObjectCache<fixtureId_t, DmxFixture>> fixtureCache;
  */
 std::shared_ptr<ObjectCache<fixtureId_t, universe_t>> fixtureUniverseMap;
 
+/**
+ * Decoded animations, so replaying one (playlists, idle loops, the play endpoint) doesn't go
+ * back to Mongo and decode it all over again. Dropped by the storage publishers when an
+ * animation changes.
+ */
+std::shared_ptr<AnimationCache> animationCache;
+
+/**
+ * Loads each playing playlist's next animation on a worker thread while the current one plays,
+ * so PlaylistEvent never has to wait on Mongo from the event loop.
+ */
+std::shared_ptr<PlaylistPrefetcher> playlistPrefetcher;
+
 /**
  * Renders fixture patterns into DMX output over time (fade-in / hold / fade-out).
  * Driven by FixturePatternTickEvent at ~50 Hz when any patterns are active.
@@ -122,7 +148,7 @@ std::shared_ptr<StatusLights> statusLights;
 std::atomic serverShouldRun{true};
 
 // MoodyCamel queue for outgoing websocket messages
-std::shared_ptr<moodycamel::BlockingConcurrentQueue<std::string>> websocketOutgoingMessages;
+std::shared_ptr<moodycamel::BlockingConcurrentQueue<ws::OutgoingMessage>> websocketOutgoingMessages;
 
 // Observability manager for tracing and metrics
 std::shared_ptr<ObservabilityManager> observability;
@@ -130,6 +156,9 @@ std::shared_ptr<ObservabilityManager> observability;
 // RTP server for handling real-time protocol streaming
 std::shared_ptr<rtp::MultiOpusRtpServer> rtpServer;
 
+// Mixes sounds into the RTP output; only made when the mixer's turned on
+std::shared_ptr<rtp::RtpMixer> rtpMixer;
+
 // Fixed worker pool for cooperative animation WAV/cache loads in RTP mode
 std::shared_ptr<rtp::AudioLoadExecutor> rtpAudioLoadExecutor;
 
@@ -142,6 +171,9 @@ std::shared_ptr<audio::NativeAudioPlaybackService> nativeAudioPlaybackService;
 // Audio cache for pre-encoded Opus files
 std::shared_ptr<util::AudioCache> audioCache;
 
+// Encodes every sound the animations use into the audio cache in the background (RTP mode only)
+std::shared_ptr<audio::AudioCachePrewarmer> audioCachePrewarmer;
+
 // Sensor data cache for storing current sensor readings from creatures
 std::shared_ptr<SensorDataCache> sensorDataCache;
 
@@ -202,6 +234,113 @@ void cleanupAdHocTempDirectory(uint32_t ttlHours) {
     }
 }
 
+// The CPUs the event loop and the RTP sender are pinned to: the ones asked for, or the first
+// few (unless there aren't enough to go around, in which case they aren't pinned)
+std::vector<int> realtimeCpus() {
+    auto cpus = creatures::config->getRealtimeCpus();
+    if (!cpus.empty()) {
+        return cpus;
+    }
+    cpus = creatures::util::ComputePool::allowedCpus();
+    if (cpus.size() <= COMPUTE_POOL_RESERVED_CPUS + 1) {
+        return {};
+    }
+    cpus.resize(COMPUTE_POOL_RESERVED_CPUS);
+    return cpus;
+}
+
+// The CPUs for the compute pool: the ones asked for, or all but the ones the event loop and
+// the RTP sender get to themselves
+std::vector<int> computePoolCpus() {
+    auto cpus = creatures::config->getComputePoolCpus();
+    if (!cpus.empty()) {
+        return cpus;
+    }
+    cpus = creatures::util::ComputePool::allowedCpus();
+    const auto reserved = realtimeCpus();
+    std::vector<int> rest;
+    std::ranges::copy_if(cpus, std::back_inserter(rest),
+                         [&reserved](int cpu) { return std::ranges::find(reserved, cpu) == reserved.end(); });
+    return rest.empty() ? cpus : rest;
+}
+
+// The configured RTP transport, or uvgRTP if the sendmmsg one can't be set up
+std::unique_ptr<creatures::rtp::RtpTransport> makeRtpTransport() {
+    if (creatures::config->getRtpBackend() == creatures::Configuration::RtpBackend::Sendmmsg) {
+        try {
+            return std::make_unique<creatures::rtp::SendmmsgRtpTransport>();
+        } catch (const std::exception &e) {
+            warn("Unable to set up the sendmmsg RTP transport ({}); falling back to uvgRTP", e.what());
+        }
+    }
+    try {
+        return std::make_unique<creatures::rtp::UvgRtpTransport>();
+    } catch (const std::exception &e) {
+        error("Unable to set up the uvgRTP transport: {}", e.what());
+        return nullptr;
+    }
+}
+
+// How the RTP output worker should time frame sets, from the config
+creatures::rtp::RtpPacingOptions rtpPacingOptions() {
+    return creatures::rtp::RtpPacingOptions{
+        .paced = creatures::config->getRtpPacing() == creatures::Configuration::RtpPacing::Paced,
+        .leadMs = creatures::config->getRtpPacingLeadMs(),
+        .realtimePriority = creatures::config->getRtpPacingPriority(),
+    };
+}
+
+// Every sound an animation uses, for the audio cache prewarmer. The ones in the
+// playlists that are playing come first, since they're the likeliest to play next.
+creatures::Result<std::vector<std::string>> listSoundsToPrewarm() {
+    auto span =
+        creatures::observability ? creatures::observability->createOperationSpan("audio_prewarm.list") : nullptr;
+
+    auto animationsResult = creatures::db->listAnimations(creatures::SortBy::name, span);
+    if (!animationsResult.isSuccess()) {
+        if (span) {
+            span->setError(animationsResult.getError()->getMessage());
+        }
+        return creatures::Result<std::vector<std::string>>{animationsResult.getError().value()};
+    }
+    const auto animations = animationsResult.getValue().value();
+
+    std::unordered_map<animationId_t, std::string> soundFiles;
+    for (const auto &metadata : animations) {
+        if (!metadata.sound_file.empty()) {
+            soundFiles.emplace(metadata.animation_id, metadata.sound_file);
+        }
+    }
+
+    std::vector<std::string> sounds;
+    for (const auto &status : creatures::sessionManager->getAllPlaylistStatuses()) {
+        if (status.playlist.empty()) {
+            continue;
+        }
+        auto playlistResult = creatures::db->getPlaylist(status.playlist, span);
+        if (!playlistResult.isSuccess()) {
+            debug("Not prewarming playlist {} first: {}", status.playlist, playlistResult.getError()->getMessage());
+            continue;
+        }
+        for (const auto &item : playlistResult.getValue()->items) {
+            if (const auto soundFile = soundFiles.find(item.animation_id); soundFile != soundFiles.end()) {
+                sounds.push_back(creatures::storage::resolveSoundPath(soundFile->second).string());
+            }
+        }
+    }
+    for (const auto &metadata : animations) {
+        if (!metadata.sound_file.empty()) {
+            sounds.push_back(creatures::storage::resolveSoundPath(metadata.sound_file).string());
+        }
+    }
+
+    if (span) {
+        span->setAttribute("sounds", static_cast<int64_t>(sounds.size()));
+        span->setSuccess();
+    }
+    return creatures::Result<std::vector<std::string>>{sounds};
+}
+
 } // namespace
 
 // Records which signal was received, so the main loop can log it after
@@ -247,7 +386,8 @@ int main(const int argc, char **argv) {
     creatures::metrics = std::make_shared<creatures::SystemCounters>();
 
     // Bring up the websocket outgoing queue
-    creatures::websocketOutgoingMessages = std::make_shared<moodycamel::BlockingConcurrentQueue<std::string>>();
+    creatures::websocketOutgoingMessages =
+        std::make_shared<moodycamel::BlockingConcurrentQueue<creatures::ws::OutgoingMessage>>();
 
     // Make a logger that goes to the console and websocket clients
     const auto logger = creatures::makeLogger("main", spdlog::level::debug);
@@ -389,6 +529,13 @@ int main(const int argc, char **argv) {
     creatures::creatureUniverseMap = std::make_shared<creatures::ObjectCache<creatureId_t, universe_t>>();
     debug("Created the creature-to-universe mapping cache");
 
+    // Create the decoded animation cache
+    if (creatures::config->getAnimationCacheMb() > 0) {
+        creatures::animationCache = std::make_shared<creatures::AnimationCache>(
+            static_cast<std::size_t>(creatures::config->getAnimationCacheMb()) * 1024 * 1024);
+        debug("Created the animation cache ({}MB)", creatures::config->getAnimationCacheMb());
+    }
+
     // Create the DmxFixture cache and universe mapping, then hydrate from DB.
     creatures::fixtureCache = std::make_shared<creatures::ObjectCache<fixtureId_t, creatures::DmxFixture>>();
     creatures::fixtureUniverseMap = std::make_shared<creatures::ObjectCache<fixtureId_t, universe_t>>();
@@ -412,6 +559,18 @@ int main(const int argc, char **argv) {
     creatures::sessionManager = std::make_shared<creatures::SessionManager>();
     debug("Created the session manager");
 
+    // Opus, MP3, and Ogg encoding all happen on one pool, kept off the event loop's and RTP's cores
+    {
+        const auto cpus = computePoolCpus();
+        const auto threads = creatures::config->getComputePoolThreads() > 0
+                                 ? std::size_t{creatures::config->getComputePoolThreads()}
+                                 : std::max<std::size_t>(1, cpus.empty() ? std::thread::hardware_concurrency()
+                                                                         : cpus.size());
+        creatures::util::ComputePool::setShared(std::make_shared<creatures::util::ComputePool>(threads, cpus));
+        info("Compute pool started with {} threads on {} CPUs", threads,
+             cpus.empty() ? std::string{"any"} : std::to_string(cpus.size()));
+    }
+
     // Create the job manager and worker for background tasks
     creatures::jobManager = std::make_shared<creatures::jobs::JobManager>();
     debug("Created the job manager");
@@ -420,8 +579,17 @@ int main(const int argc, char **argv) {
     creatures::jobWorker->start();
     info("JobWorker thread started");
 
+    // Playlists load their next item on these workers
+    creatures::playlistPrefetcher = std::make_shared<creatures::PlaylistPrefetcher>(
+        PLAYLIST_PREFETCH_WORKERS, creatures::PlaylistEvent::loadNextItem);
+    debug("Created the playlist prefetcher");
+
     // Start up the event loop
-    creatures::eventLoop = std::make_shared<EventLoop>();
+    const auto reservedCpus = realtimeCpus();
+    if (!reservedCpus.empty()) {
+        info("The event loop and the RTP sender are pinned to {} CPUs", reservedCpus.size());
+    }
+    creatures::eventLoop = std::make_shared<EventLoop>(reservedCpus);
     creatures::eventLoop->start();
 
     // Seed the tick task
@@ -434,7 +602,8 @@ int main(const int argc, char **argv) {
     // Start the RtpServer
     if (creatures::config->getAudioMode() == creatures::Configuration::AudioMode::RTP) {
         info("RTP audio mode enabled, starting RTP server");
-        creatures::rtpServer = std::make_shared<creatures::rtp::MultiOpusRtpServer>();
+        creatures::rtpServer = std::make_shared<creatures::rtp::MultiOpusRtpServer>(
+            makeRtpTransport(), rtpPacingOptions(), !creatures::config->getRtpSendSilence(), reservedCpus);
         std::weak_ptr<creatures::SystemCounters> weakMetrics = creatures::metrics;
         creatures::rtpAudioLoadExecutor = std::make_shared<creatures::rtp::AudioLoadExecutor>(
             creatures::config->getRtpAudioLoadWorkers(), creatures::config->getRtpAudioLoadQueueCapacity(),
@@ -446,6 +615,15 @@ int main(const int argc, char **argv) {
             });
         info("RTP animation audio loader started with {} workers and {} queued-job capacity",
              creatures::config->getRtpAudioLoadWorkers(), creatures::config->getRtpAudioLoadQueueCapacity());
+        creatures::rtp::AudioStreamBuffer::setEncodeLeadFrames(creatures::config->getRtpEncodeLeadMs() / RTP_FRAME_MS);
+
+        if (creatures::config->getRtpMixer()) {
+            creatures::rtpMixer = std::make_shared<creatures::rtp::RtpMixer>(creatures::rtp::RtpMixer::Options{
+                .duckDb = creatures::config->getRtpMixerDuckDb(),
+                .limiterCeilingDb = creatures::config->getLimiterCeilingDb(),
+            });
+            info("RTP mixer enabled, ducking music {}dB under dialog", creatures::config->getRtpMixerDuckDb());
+        }
     }
 
     // Initialize audio cache for faster Opus encoding
@@ -465,6 +643,29 @@ int main(const int argc, char **argv) {
         creatures::rtp::AudioStreamBuffer::setAudioCacheInstance(nullptr);
     }
 
+    // Only RTP playback reads the audio cache
+    if (creatures::audioCache && creatures::config->getAudioMode() == creatures::Configuration::AudioMode::RTP &&
+        creatures::config->getAudioPrewarmCores() > 0) {
+        std::weak_ptr<creatures::SystemCounters> weakMetrics = creatures::metrics;
+        creatures::audioCachePrewarmer = std::make_shared<creatures::audio::AudioCachePrewarmer>(
+            creatures::audio::AudioCachePrewarmer::Budget{creatures::config->getAudioPrewarmNice(),
+                                                          creatures::config->getAudioPrewarmCores()},
+            listSoundsToPrewarm,
+            [](const std::string &soundPath, const std::atomic<bool> &stopping,
+               const std::shared_ptr<creatures::util::ComputePool> &pool) {
+                return creatures::rtp::AudioStreamBuffer::prewarm(soundPath, stopping, pool);
+            },
+            [weakMetrics](const creatures::audio::AudioCachePrewarmer::Stats &stats) {
+                if (auto counters = weakMetrics.lock()) {
+                    counters->setAudioPrewarmMetrics(stats.pending, stats.scans, stats.checked, stats.encoded,
+                                                     stats.failed);
+                }
+            });
+        creatures::audioCachePrewarmer->requestScan();
+        info("Audio cache prewarmer started (nice {}, at most {} cores)", creatures::config->getAudioPrewarmNice(),
+             creatures::config->getAudioPrewarmCores());
+    }
+
     // Initialize whisper lip sync engine if configured
     if (creatures::config->getLipSyncEngine() == "whisper") {
         auto whisperModelPath = creatures::config->getWhisperModelPath();
@@ -481,6 +682,25 @@ int main(const int argc, char **argv) {
     // Bring the E131Server online
     creatures::e131Server = std::make_shared<creatures::e131::E131Server>();
     creatures::e131Server->init(creatures::config->getNetworkDevice(), version, creatures::config->getTravelMode());
+    creatures::e131Server->setSendOnChange(creatures::config->getSacnSendOnChange(),
+                                           creatures::config->getSacnKeepAliveMs());
+    creatures::e131Server->setDefaultOutputRate(creatures::config->getSacnOutputRateHz());
+    for (const auto &[universe, hz] : creatures::config->getSacnUniverseRates()) {
+        creatures::e131Server->setOutputRate(universe, hz);
+    }
+    creatures::e131Server->setDefaultMergeMode(
+        creatures::config->getSacnMergeMode() == creatures::Configuration::SacnMergeMode::HTP
+            ? creatures::e131::MergeMode::HighestTakesPrecedence
+            : creatures::e131::MergeMode::LatestTakesPrecedence);
+    {
+        std::weak_ptr<creatures::SystemCounters> weakMetrics = creatures::metrics;
+        creatures::e131Server->setSendStatsCallback(
+            [weakMetrics](const std::vector<creatures::e131::UniverseSendStats> &stats) {
+                if (auto counters = weakMetrics.lock()) {
+                    counters->setE131SendMetrics(stats);
+                }
+            });
+    }
     creatures::e131Server->start();
 
     // TODO: Remove this, this is just for debugging. Universe 1000 is "production."
@@ -540,6 +760,18 @@ int main(const int argc, char **argv) {
     creatures::jobWorker->shutdown();
     debug("JobWorker stopped");
 
+    // Prefetch loads talk to Mongo and the caches; let them finish before anything goes away
+    info("Stopping playlist prefetcher...");
+    creatures::playlistPrefetcher->shutdown();
+    debug("Playlist prefetcher stopped");
+
+    // This cancels whatever it's encoding rather than waiting for it
+    if (creatures::audioCachePrewarmer) {
+        info("Stopping audio cache prewarmer...");
+        creatures::audioCachePrewarmer->shutdown();
+        debug("Audio cache prewarmer stopped");
+    }
+
     // Loader jobs retain event-loop, session-manager, and RTP-server handles.
     // Join them before any of those services begin teardown.
     if (creatures::rtpAudioLoadExecutor) {
@@ -566,6 +798,7 @@ int main(const int argc, char **argv) {
 
     // Cleanup the RTP server
     creatures::rtpServer.reset(); // implicit cleanup
+    creatures::rtpMixer.reset();
 
     creatures::gpioPins->serverOnline(false);
     creatures::statusLights->shutdown();
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <array>
+
+#include "server/eventloop/event.h"
+#include "util/LatencyHistogram.h"
+
+namespace creatures {
+
+/**
+ * Where the event loop's time goes, tick by tick
+ *
+ * The event loop thread records into these on every tick; anyone can read
+ * them. Between them they tell you why a frame was missed: the work ran long
+ * (tickWorkNs, and which event type did it), or the thread woke up late
+ * (oversleepNs).
+ */
+struct EventLoopTimings {
+    /** How long each tick's work (draining the scheduler and running events) took */
+    LatencyHistogram tickWorkNs;
+
+    /** How far past its deadline each tick finished its work (0 when it finished in time) */
+    LatencyHistogram tickOverrunNs;
+
+    /** How late the thread woke up, for ticks that slept */
+    LatencyHistogram oversleepNs;
+
+    /** How many events each tick ran */
+    LatencyHistogram eventsPerTick;
+
+    /** How long each event's execute() took, by EventTypes slot */
+    std::array<LatencyHistogram, EventTypes::MAX_TYPES> eventExecutionNs;
+};
+
+} // namespace creatures
@@ -1,3 +1,4 @@
+#include <utility>
 
 #include <spdlog/spdlog.h>
 
@@ -17,12 +18,14 @@
 
 #include "server/ws/dto/websocket/MessageTypes.h"
 #include "server/ws/dto/websocket/VirtualStatusLightsMessage.h"
+#include "server/ws/websocket/OutgoingMessage.h"
+#include "server/ws/websocket/TopicSubscriptions.h"
 
 namespace creatures {
 
 extern std::shared_ptr<SystemCounters> metrics;
 extern std::shared_ptr<GPIO> gpioPins;
-extern std::shared_ptr<moodycamel::BlockingConcurrentQueue<std::string>> websocketOutgoingMessages;
+extern std::shared_ptr<moodycamel::BlockingConcurrentQueue<ws::OutgoingMessage>> websocketOutgoingMessages;
 
 StatusLights::StatusLights() {
 
@@ -165,6 +168,11 @@ void StatusLights::run() {
 
 void StatusLights::sendUpdateToClients() const {
 
+    // Nobody's watching the lights, so there's nothing to build
+    if (!ws::anyoneSubscribedTo(ws::MessageType::VirtualStatusLights)) {
+        return;
+    }
+
     // Create the object to send
     auto virtualStatusLights = VirtualStatusLights();
     virtualStatusLights.running = runningLightOn;
@@ -177,13 +185,10 @@ void StatusLights::sendUpdateToClients() const {
     message->command = toString(ws::MessageType::VirtualStatusLights);
     message->payload = convertToDto(virtualStatusLights);
 
-    // Make a JSON mapper
-    auto jsonMapper = oatpp::parser::json::mapping::ObjectMapper::createShared();
-
-    std::string outgoingMessage = jsonMapper->writeToString(message);
-    debug("Outgoing message to clients: {}", outgoingMessage);
+    auto outgoingMessage = ws::serializeForClients(ws::MessageType::VirtualStatusLights, message);
+    debug("Outgoing message to clients: {}", *outgoingMessage.json);
 
-    websocketOutgoingMessages->enqueue(outgoingMessage);
+    websocketOutgoingMessages->enqueue(std::move(outgoingMessage));
 }
 
 } // namespace creatures
\ No newline at end of file
@@ -3,8 +3,29 @@
 
 namespace creatures {
 
+namespace {
+
+oatpp::Object<EventLoopHistogramDto> histogramToDto(const std::string &name, const char *unit,
+                                                    const LatencyHistogram &histogram) {
+    const auto snapshot = histogram.snapshot();
+    auto timingDto = EventLoopHistogramDto::createShared();
+    timingDto->name = name;
+    timingDto->unit = unit;
+    timingDto->count = snapshot.count;
+    timingDto->mean = snapshot.mean();
+    timingDto->p50 = snapshot.valueAtPercentile(50.0);
+    timingDto->p90 = snapshot.valueAtPercentile(90.0);
+    timingDto->p99 = snapshot.valueAtPercentile(99.0);
+    timingDto->p999 = snapshot.valueAtPercentile(99.9);
+    timingDto->max = snapshot.max;
+    return timingDto;
+}
+
+} // namespace
+
 SystemCounters::SystemCounters() {
     totalFrames = 0;
+    eventLoopBlockedFrames = 0;
     eventsProcessed = 0;
     framesStreamed = 0;
     dmxEventsProcessed = 0;
@@ -16,10 +37,14 @@ SystemCounters::SystemCounters() {
     playlistStatusRequests = 0;
     restRequestsProcessed = 0;
     rtpEventsProcessed = 0;
+    rtpEncodeUnderruns = 0;
     rtpSendFailures = 0;
     rtpSendFailuresSuppressed = 0;
     rtpSendRecoveries = 0;
     rtpCircuitBreakerTrips = 0;
+    rtpSendSyscalls = 0;
+    rtpMixerUnderruns = 0;
+    rtpPacketsSuppressed = 0;
     rtcpReportsSent = 0;
     rtcpSendFailures = 0;
     rtpEncoderResets = 0;
@@ -30,6 +55,11 @@ SystemCounters::SystemCounters() {
     rtpAudioLoadsRejected = 0;
     rtpAudioLoadsCancelled = 0;
     rtpAudioLoadsFailed = 0;
+    audioPrewarmPending = 0;
+    audioPrewarmScans = 0;
+    audioPrewarmChecked = 0;
+    audioPrewarmEncoded = 0;
+    audioPrewarmFailed = 0;
     localAudioPlaybacksActive = 0;
     localAudioPlaybacksQueued = 0;
     localAudioPlaybacksAccepted = 0;
@@ -45,10 +75,15 @@ SystemCounters::SystemCounters() {
     websocketMessagesSent = 0;
     websocketPingsSent = 0;
     websocketPongsReceived = 0;
+    websocketMessagesCoalesced = 0;
+    websocketMessagesDropped = 0;
+    websocketSlowClientHangups = 0;
 }
 
 void SystemCounters::incrementTotalFrames() { totalFrames++; }
 
+void SystemCounters::incrementEventLoopBlockedFrames() { eventLoopBlockedFrames++; }
+
 void SystemCounters::incrementEventsProcessed() { eventsProcessed++; }
 
 void SystemCounters::incrementFramesStreamed() { framesStreamed++; }
@@ -71,6 +106,8 @@ void SystemCounters::incrementRestRequestsProcessed() { restRequestsProcessed++;
 
 void SystemCounters::incrementRtpEventsProcessed() { rtpEventsProcessed++; }
 
+void SystemCounters::incrementRtpEncodeUnderruns() { rtpEncodeUnderruns++; }
+
 void SystemCounters::incrementRtpSendFailures() { rtpSendFailures++; }
 
 void SystemCounters::incrementRtpSendFailuresSuppressed() { rtpSendFailuresSuppressed++; }
@@ -95,8 +132,20 @@ void SystemCounters::incrementWebsocketPingsSent() { websocketPingsSent++; }
 
 void SystemCounters::incrementWebsocketPongsReceived() { websocketPongsReceived++; }
 
+void SystemCounters::incrementWebsocketMessagesCoalesced() { websocketMessagesCoalesced++; }
+
+void SystemCounters::incrementWebsocketMessagesDropped() { websocketMessagesDropped++; }
+
+void SystemCounters::incrementWebsocketSlowClientHangups() { websocketSlowClientHangups++; }
+
 void SystemCounters::incrementRtpEncoderResets() { rtpEncoderResets++; }
 
+void SystemCounters::addRtpSendSyscalls(uint64_t syscalls) { rtpSendSyscalls += syscalls; }
+
+void SystemCounters::addRtpMixerUnderruns(uint64_t underruns) { rtpMixerUnderruns += underruns; }
+
+void SystemCounters::addRtpPacketsSuppressed(uint64_t packets) { rtpPacketsSuppressed += packets; }
+
 void SystemCounters::setRtpAudioLoadMetrics(uint64_t active, uint64_t queued, uint64_t accepted, uint64_t completed,
                                             uint64_t rejected, uint64_t cancelled, uint64_t failed) {
     rtpAudioLoadersActive.store(active);
@@ -108,6 +157,15 @@ void SystemCounters::setRtpAudioLoadMetrics(uint64_t active, uint64_t queued, ui
     rtpAudioLoadsFailed.store(failed);
 }
 
+void SystemCounters::setAudioPrewarmMetrics(uint64_t pending, uint64_t scans, uint64_t checked, uint64_t encoded,
+                                            uint64_t failed) {
+    audioPrewarmPending.store(pending);
+    audioPrewarmScans.store(scans);
+    audioPrewarmChecked.store(checked);
+    audioPrewarmEncoded.store(encoded);
+    audioPrewarmFailed.store(failed);
+}
+
 void SystemCounters::setLocalAudioPlaybackMetrics(uint64_t active, uint64_t queued, uint64_t accepted,
                                                   uint64_t completed, uint64_t replaced, uint64_t rejected,
                                                   uint64_t stopped, uint64_t failed, uint64_t timedOut) {
@@ -122,8 +180,15 @@ void SystemCounters::setLocalAudioPlaybackMetrics(uint64_t active, uint64_t queu
     localAudioPlaybacksTimedOut.store(timedOut);
 }
 
+void SystemCounters::setE131SendMetrics(const std::vector<e131::UniverseSendStats> &stats) {
+    std::lock_guard<std::mutex> lock(e131SendMetricsMutex);
+    e131SendMetrics = stats;
+}
+
 uint64_t SystemCounters::getTotalFrames() { return totalFrames.load(); }
 
+uint64_t SystemCounters::getEventLoopBlockedFrames() { return eventLoopBlockedFrames.load(); }
+
 uint64_t SystemCounters::getEventsProcessed() { return eventsProcessed.load(); }
 
 uint64_t SystemCounters::getFramesStreamed() { return framesStreamed.load(); }
@@ -146,6 +211,8 @@ uint64_t SystemCounters::getRestRequestsProcessed() { return restRequestsProcess
 
 uint64_t SystemCounters::getRtpEventsProcessed() { return rtpEventsProcessed.load(); }
 
+uint64_t SystemCounters::getRtpEncodeUnderruns() { return rtpEncodeUnderruns.load(); }
+
 uint64_t SystemCounters::getRtpSendFailures() { return rtpSendFailures.load(); }
 
 uint64_t SystemCounters::getRtpSendFailuresSuppressed() { return rtpSendFailuresSuppressed.load(); }
@@ -160,6 +227,12 @@ uint64_t SystemCounters::getRtcpSendFailures() { return rtcpSendFailures.load();
 
 uint64_t SystemCounters::getRtpEncoderResets() { return rtpEncoderResets.load(); }
 
+uint64_t SystemCounters::getRtpSendSyscalls() { return rtpSendSyscalls.load(); }
+
+uint64_t SystemCounters::getRtpMixerUnderruns() { return rtpMixerUnderruns.load(); }
+
+uint64_t SystemCounters::getRtpPacketsSuppressed() { return rtpPacketsSuppressed.load(); }
+
 uint64_t SystemCounters::getRtpAudioLoadersActive() { return rtpAudioLoadersActive.load(); }
 
 uint64_t SystemCounters::getRtpAudioLoadsQueued() { return rtpAudioLoadsQueued.load(); }
@@ -174,6 +247,16 @@ uint64_t SystemCounters::getRtpAudioLoadsCancelled() { return rtpAudioLoadsCance
 
 uint64_t SystemCounters::getRtpAudioLoadsFailed() { return rtpAudioLoadsFailed.load(); }
 
+uint64_t SystemCounters::getAudioPrewarmPending() { return audioPrewarmPending.load(); }
+
+uint64_t SystemCounters::getAudioPrewarmScans() { return audioPrewarmScans.load(); }
+
+uint64_t SystemCounters::getAudioPrewarmChecked() { return audioPrewarmChecked.load(); }
+
+uint64_t SystemCounters::getAudioPrewarmEncoded() { return audioPrewarmEncoded.load(); }
+
+uint64_t SystemCounters::getAudioPrewarmFailed() { return audioPrewarmFailed.load(); }
+
 uint64_t SystemCounters::getLocalAudioPlaybacksActive() { return localAudioPlaybacksActive.load(); }
 
 uint64_t SystemCounters::getLocalAudioPlaybacksQueued() { return localAudioPlaybacksQueued.load(); }
@@ -204,6 +287,41 @@ uint64_t SystemCounters::getWebsocketPingsSent() { return websocketPingsSent.loa
 
 uint64_t SystemCounters::getWebsocketPongsReceived() { return websocketPongsReceived.load(); }
 
+uint64_t SystemCounters::getWebsocketMessagesCoalesced() { return websocketMessagesCoalesced.load(); }
+
+uint64_t SystemCounters::getWebsocketMessagesDropped() { return websocketMessagesDropped.load(); }
+
+uint64_t SystemCounters::getWebsocketSlowClientHangups() { return websocketSlowClientHangups.load(); }
+
+std::vector<e131::UniverseSendStats> SystemCounters::getE131SendMetrics() {
+    std::lock_guard<std::mutex> lock(e131SendMetricsMutex);
+    return e131SendMetrics;
+}
+
+EventLoopTimings &SystemCounters::getEventLoopTimings() { return eventLoopTimings; }
+
+LatencyHistogram &SystemCounters::getRtpFrameSetSendTimes() { return rtpFrameSetSendNs; }
+
+std::array<LatencyHistogram, RTP_STREAMING_CHANNELS> &SystemCounters::getRtpPacketJitter() { return rtpPacketJitterNs; }
+
+LatencyHistogram &SystemCounters::getRtpPacingLateness() { return rtpPacingLatenessNs; }
+
+void SystemCounters::recordWebsocketSerialization(ws::MessageType type, uint64_t nanoseconds) {
+    websocketSerializationNs[static_cast<std::size_t>(type)].recordConcurrent(nanoseconds);
+}
+
+std::array<LatencyHistogram, ws::allMessageTypes.size()> &SystemCounters::getWebsocketSerializationTimes() {
+    return websocketSerializationNs;
+}
+
+void SystemCounters::recordStreamFrameLatency(bool fastLane, uint64_t nanoseconds) {
+    (fastLane ? streamFrameFastLaneNs : streamFrameFullPathNs).recordConcurrent(nanoseconds);
+}
+
+LatencyHistogram &SystemCounters::getStreamFrameFastLaneLatency() { return streamFrameFastLaneNs; }
+
+LatencyHistogram &SystemCounters::getStreamFrameFullPathLatency() { return streamFrameFullPathNs; }
+
 /**
  * Create a DTO from the current state of the counters
  *
@@ -214,6 +332,7 @@ oatpp::Object<SystemCountersDto> SystemCounters::convertToDto() {
     auto dto = SystemCountersDto::createShared();
 
     dto->totalFrames = totalFrames.load();
+    dto->eventLoopBlockedFrames = eventLoopBlockedFrames.load();
     dto->eventsProcessed = eventsProcessed.load();
     dto->framesStreamed = framesStreamed.load();
     dto->dmxEventsProcessed = dmxEventsProcessed.load();
@@ -225,10 +344,14 @@ oatpp::Object<SystemCountersDto> SystemCounters::convertToDto() {
     dto->playlistStatusRequests = playlistStatusRequests.load();
     dto->restRequestsProcessed = restRequestsProcessed.load();
     dto->rtpEventsProcessed = rtpEventsProcessed.load();
+    dto->rtpEncodeUnderruns = rtpEncodeUnderruns.load();
     dto->rtpSendFailures = rtpSendFailures.load();
     dto->rtpSendFailuresSuppressed = rtpSendFailuresSuppressed.load();
     dto->rtpSendRecoveries = rtpSendRecoveries.load();
     dto->rtpCircuitBreakerTrips = rtpCircuitBreakerTrips.load();
+    dto->rtpSendSyscalls = rtpSendSyscalls.load();
+    dto->rtpMixerUnderruns = rtpMixerUnderruns.load();
+    dto->rtpPacketsSuppressed = rtpPacketsSuppressed.load();
     dto->rtcpReportsSent = rtcpReportsSent.load();
     dto->rtcpSendFailures = rtcpSendFailures.load();
     dto->rtpEncoderResets = rtpEncoderResets.load();
@@ -239,6 +362,11 @@ oatpp::Object<SystemCountersDto> SystemCounters::convertToDto() {
     dto->rtpAudioLoadsRejected = rtpAudioLoadsRejected.load();
     dto->rtpAudioLoadsCancelled = rtpAudioLoadsCancelled.load();
     dto->rtpAudioLoadsFailed = rtpAudioLoadsFailed.load();
+    dto->audioPrewarmPending = audioPrewarmPending.load();
+    dto->audioPrewarmScans = audioPrewarmScans.load();
+    dto->audioPrewarmChecked = audioPrewarmChecked.load();
+    dto->audioPrewarmEncoded = audioPrewarmEncoded.load();
+    dto->audioPrewarmFailed = audioPrewarmFailed.load();
     dto->localAudioPlaybacksActive = localAudioPlaybacksActive.load();
     dto->localAudioPlaybacksQueued = localAudioPlaybacksQueued.load();
     dto->localAudioPlaybacksAccepted = localAudioPlaybacksAccepted.load();
@@ -253,6 +381,56 @@ oatpp::Object<SystemCountersDto> SystemCounters::convertToDto() {
     dto->websocketMessagesSent = websocketMessagesSent.load();
     dto->websocketPingsSent = websocketPingsSent.load();
     dto->websocketPongsReceived = websocketPongsReceived.load();
+    dto->websocketMessagesCoalesced = websocketMessagesCoalesced.load();
+    dto->websocketMessagesDropped = websocketMessagesDropped.load();
+    dto->websocketSlowClientHangups = websocketSlowClientHangups.load();
+
+    dto->e131Universes = oatpp::List<oatpp::Object<E131UniverseSendStatsDto>>::createShared();
+    for (const auto &universeStats : getE131SendMetrics()) {
+        auto universeDto = E131UniverseSendStatsDto::createShared();
+        universeDto->universe = universeStats.universe;
+        universeDto->packetsSent = universeStats.packetsSent;
+        universeDto->packetsSkipped = universeStats.packetsSkipped;
+        universeDto->sendErrors = universeStats.sendErrors;
+        universeDto->sendTimeHistogram = oatpp::List<oatpp::UInt64>::createShared();
+        for (const auto count : universeStats.sendTimeHistogram) {
+            universeDto->sendTimeHistogram->emplace_back(count);
+        }
+        dto->e131Universes->emplace_back(universeDto);
+    }
+
+    dto->eventLoopTimings = oatpp::List<oatpp::Object<EventLoopHistogramDto>>::createShared();
+    const auto addTiming = [&dto](const std::string &name, const char *unit, const LatencyHistogram &histogram) {
+        dto->eventLoopTimings->emplace_back(histogramToDto(name, unit, histogram));
+    };
+    addTiming("tickWork", "ns", eventLoopTimings.tickWorkNs);
+    addTiming("tickOverrun", "ns", eventLoopTimings.tickOverrunNs);
+    addTiming("oversleep", "ns", eventLoopTimings.oversleepNs);
+    addTiming("eventsPerTick", "events", eventLoopTimings.eventsPerTick);
+    for (std::size_t slot = 0; slot < EventTypes::count(); ++slot) {
+        addTiming(EventTypes::name(slot), "ns", eventLoopTimings.eventExecutionNs[slot]);
+    }
+    dto->rtpFrameSetSendTime = histogramToDto("rtpFrameSetSend", "ns", rtpFrameSetSendNs);
+
+    dto->rtpPacketJitter = oatpp::List<oatpp::Object<EventLoopHistogramDto>>::createShared();
+    for (std::size_t channel = 0; channel < rtpPacketJitterNs.size(); ++channel) {
+        dto->rtpPacketJitter->emplace_back(
+            histogramToDto("channel" + std::to_string(channel), "ns", rtpPacketJitterNs[channel]));
+    }
+    dto->rtpPacingLateness = histogramToDto("rtpPacingLateness", "ns", rtpPacingLatenessNs);
+
+    // Only the types the server actually sends, rather than a row of zeros for the rest
+    dto->websocketSerializationTime = oatpp::List<oatpp::Object<EventLoopHistogramDto>>::createShared();
+    for (const auto type : ws::allMessageTypes) {
+        const auto &histogram = websocketSerializationNs[static_cast<std::size_t>(type)];
+        if (histogram.totalCount() != 0) {
+            dto->websocketSerializationTime->emplace_back(histogramToDto(ws::toString(type), "ns", histogram));
+        }
+    }
+
+    dto->streamFrameLatency = oatpp::List<oatpp::Object<EventLoopHistogramDto>>::createShared();
+    dto->streamFrameLatency->emplace_back(histogramToDto("fastLane", "ns", streamFrameFastLaneNs));
+    dto->streamFrameLatency->emplace_back(histogramToDto("fullPath", "ns", streamFrameFullPathNs));
 
     return dto;
 }
@@ -1,11 +1,20 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
+#include <mutex>
+#include <vector>
+
+#include <SendStats.h>
 
 #include <oatpp/core/Types.hpp>
 #include <oatpp/core/macro/codegen.hpp>
 
+#include "server/config.h"
+#include "server/metrics/EventLoopTimings.h"
+#include "server/ws/dto/websocket/MessageTypes.h"
+
 /**
  * A helper class to keep track of some counters for system usage
  */
@@ -17,6 +26,67 @@ namespace creatures {
 
 #include OATPP_CODEGEN_BEGIN(DTO)
 
+class E131UniverseSendStatsDto : public oatpp::DTO {
+
+    DTO_INIT(E131UniverseSendStatsDto, DTO /* extends */)
+
+    DTO_FIELD_INFO(universe) { info->description = "The sACN universe number"; }
+    DTO_FIELD(UInt16, universe);
+
+    DTO_FIELD_INFO(packetsSent) { info->description = "Number of E1.31 packets sent for this universe"; }
+    DTO_FIELD(UInt64, packetsSent);
+
+    DTO_FIELD_INFO(packetsSkipped) {
+        info->description = "Number of frames held back because nothing changed (send-on-change mode)";
+    }
+    DTO_FIELD(UInt64, packetsSkipped);
+
+    DTO_FIELD_INFO(sendErrors) { info->description = "Number of E1.31 packets the kernel refused"; }
+    DTO_FIELD(UInt64, sendErrors);
+
+    DTO_FIELD_INFO(sendTimeHistogram) {
+        info->description = "Send time from the start of a flush to the kernel, in log2 microsecond buckets: "
+                            "bucket 0 is under 1us, bucket i is [2^(i-1), 2^i) us, the last bucket is open-ended";
+    }
+    DTO_FIELD(List<UInt64>, sendTimeHistogram);
+};
+
+class EventLoopHistogramDto : public oatpp::DTO {
+
+    DTO_INIT(EventLoopHistogramDto, DTO /* extends */)
+
+    DTO_FIELD_INFO(name) {
+        info->description =
+            "What's measured: tickWork, tickOverrun, oversleep, eventsPerTick, an event type, rtpFrameSetSend, "
+            "rtpPacingLateness, or an RTP channel (channel0, channel1, ...)";
+    }
+    DTO_FIELD(String, name);
+
+    DTO_FIELD_INFO(unit) { info->description = "Unit of the values (ns or events)"; }
+    DTO_FIELD(String, unit);
+
+    DTO_FIELD_INFO(count) { info->description = "Number of values recorded since the server started"; }
+    DTO_FIELD(UInt64, count);
+
+    DTO_FIELD_INFO(mean) { info->description = "Mean of every value recorded"; }
+    DTO_FIELD(Float64, mean);
+
+    DTO_FIELD_INFO(p50) { info->description = "Median (values are accurate to within 12.5%)"; }
+    DTO_FIELD(UInt64, p50);
+
+    DTO_FIELD_INFO(p90) { info->description = "90th percentile"; }
+    DTO_FIELD(UInt64, p90);
+
+    DTO_FIELD_INFO(p99) { info->description = "99th percentile"; }
+    DTO_FIELD(UInt64, p99);
+
+    DTO_FIELD_INFO(p999) { info->description = "99.9th percentile"; }
+    DTO_FIELD(UInt64, p999);
+
+    DTO_FIELD_INFO(max) { info->description = "Largest value recorded"; }
+    DTO_FIELD(UInt64, max);
+};
+
 class SystemCountersDto : public oatpp::DTO {
 
     DTO_INIT(SystemCountersDto, DTO /* extends */)
@@ -24,6 +94,11 @@ class SystemCountersDto : public oatpp::DTO {
     DTO_FIELD_INFO(totalFrames) { info->description = "Number of frames that have been processed"; }
     DTO_FIELD(UInt64, totalFrames);
 
+    DTO_FIELD_INFO(eventLoopBlockedFrames) {
+        info->description = "Number of event loop frames that waited on database I/O";
+    }
+    DTO_FIELD(UInt64, eventLoopBlockedFrames);
+
     DTO_FIELD_INFO(eventsProcessed) {
         info->description = "Number of events that have been processed by the event loop";
     }
@@ -63,6 +138,11 @@ class SystemCountersDto : public oatpp::DTO {
     DTO_FIELD_INFO(rtpEventsProcessed) { info->description = "Number of RTP events that have been processed"; }
     DTO_FIELD(UInt64, rtpEventsProcessed);
 
+    DTO_FIELD_INFO(rtpEncodeUnderruns) {
+        info->description = "Number of RTP packets held back because the Opus encoder hadn't reached them yet";
+    }
+    DTO_FIELD(UInt64, rtpEncodeUnderruns);
+
     DTO_FIELD_INFO(rtpSendFailures) { info->description = "Number of RTP output sends that have failed"; }
     DTO_FIELD(UInt64, rtpSendFailures);
 
@@ -82,6 +162,21 @@ class SystemCountersDto : public oatpp::DTO {
     }
     DTO_FIELD(UInt64, rtpCircuitBreakerTrips);
 
+    DTO_FIELD_INFO(rtpSendSyscalls) {
+        info->description = "Number of calls into the kernel the RTP output has made to send frame sets";
+    }
+    DTO_FIELD(UInt64, rtpSendSyscalls);
+
+    DTO_FIELD_INFO(rtpMixerUnderruns) {
+        info->description = "Number of times a mixed RTP track had no audio ready and played a frame of silence";
+    }
+    DTO_FIELD(UInt64, rtpMixerUnderruns);
+
+    DTO_FIELD_INFO(rtpPacketsSuppressed) {
+        info->description = "Number of RTP packets not sent because their channel was silent";
+    }
+    DTO_FIELD(UInt64, rtpPacketsSuppressed);
+
     DTO_FIELD_INFO(rtcpReportsSent) {
         info->description = "Number of RTCP Sender Report compound packets successfully sent";
     }
@@ -125,6 +220,31 @@ class SystemCountersDto : public oatpp::DTO {
     }
     DTO_FIELD(UInt64, rtpAudioLoadsFailed);
 
+    DTO_FIELD_INFO(audioPrewarmPending) {
+        info->description = "Number of sounds left in the audio cache prewarmer's current scan";
+    }
+    DTO_FIELD(UInt64, audioPrewarmPending);
+
+    DTO_FIELD_INFO(audioPrewarmScans) {
+        info->description = "Number of times the audio cache prewarmer has checked every sound";
+    }
+    DTO_FIELD(UInt64, audioPrewarmScans);
+
+    DTO_FIELD_INFO(audioPrewarmChecked) {
+        info->description = "Number of sounds the audio cache prewarmer has checked";
+    }
+    DTO_FIELD(UInt64, audioPrewarmChecked);
+
+    DTO_FIELD_INFO(audioPrewarmEncoded) {
+        info->description = "Number of sounds the audio cache prewarmer had to encode";
+    }
+    DTO_FIELD(UInt64, audioPrewarmEncoded);
+
+    DTO_FIELD_INFO(audioPrewarmFailed) {
+        info->description = "Number of sounds the audio cache prewarmer was unable to encode";
+    }
+    DTO_FIELD(UInt64, audioPrewarmFailed);
+
     DTO_FIELD_INFO(localAudioPlaybacksActive) {
         info->description = "Number of local audio device jobs currently running";
     }
@@ -192,10 +312,60 @@ class SystemCountersDto : public oatpp::DTO {
     }
     DTO_FIELD(UInt64, websocketPongsReceived);
 
+    DTO_FIELD_INFO(websocketMessagesCoalesced) {
+        info->description = "Number of websocket messages that replaced an older one still waiting for a client";
+    }
+    DTO_FIELD(UInt64, websocketMessagesCoalesced);
+
+    DTO_FIELD_INFO(websocketMessagesDropped) {
+        info->description = "Number of websocket messages dropped because a client had fallen behind";
+    }
+    DTO_FIELD(UInt64, websocketMessagesDropped);
+
+    DTO_FIELD_INFO(websocketSlowClientHangups) {
+        info->description = "Number of websocket clients hung up on for falling too far behind";
+    }
+    DTO_FIELD(UInt64, websocketSlowClientHangups);
+
     DTO_FIELD_INFO(rtpEncoderResets) {
         info->description = "Number of RTP encoder resets (SSRC rotations) that have been performed";
     }
     DTO_FIELD(UInt64, rtpEncoderResets);
+
+    DTO_FIELD_INFO(e131Universes) { info->description = "Per-universe sACN output stats"; }
+    DTO_FIELD(List<Object<E131UniverseSendStatsDto>>, e131Universes);
+
+    DTO_FIELD_INFO(eventLoopTimings) {
+        info->description = "Always-on event loop latency histograms: per tick, then per event type";
+    }
+    DTO_FIELD(List<Object<EventLoopHistogramDto>>, eventLoopTimings);
+
+    DTO_FIELD_INFO(rtpFrameSetSendTime) {
+        info->description = "How long the RTP output took to hand each frame set (every channel) to the kernel";
+    }
+    DTO_FIELD(Object<EventLoopHistogramDto>, rtpFrameSetSendTime);
+
+    DTO_FIELD_INFO(rtpPacketJitter) {
+        info->description = "Per RTP channel, how far each packet's send time strayed from where its RTP timestamp "
+                            "said it should be, relative to the channel's last packet (RFC 3550 style)";
+    }
+    DTO_FIELD(List<Object<EventLoopHistogramDto>>, rtpPacketJitter);
+
+    DTO_FIELD_INFO(rtpPacingLateness) {
+        info->description = "With paced RTP output, how late the output worker woke up for each frame set's deadline";
+    }
+    DTO_FIELD(Object<EventLoopHistogramDto>, rtpPacingLateness);
+
+    DTO_FIELD_INFO(websocketSerializationTime) {
+        info->description = "Per websocket message type, how long serializing each message for the clients took";
+    }
+    DTO_FIELD(List<Object<EventLoopHistogramDto>>, websocketSerializationTime);
+
+    DTO_FIELD_INFO(streamFrameLatency) {
+        info->description = "How long a streamed frame took from arriving to being written to its universe, for frames "
+                            "that took the fast lane and ones that had to look their creature up";
+    }
+    DTO_FIELD(List<Object<EventLoopHistogramDto>>, streamFrameLatency);
 };
 
 #include OATPP_CODEGEN_END(DTO)
@@ -207,6 +377,7 @@ class SystemCounters {
     ~SystemCounters() = default;
 
     void incrementTotalFrames();
+    void incrementEventLoopBlockedFrames();
     void incrementEventsProcessed();
     void incrementFramesStreamed();
     void incrementDMXEventsProcessed();
@@ -217,10 +388,14 @@ class SystemCounters {
     void incrementPlaylistsEventsProcessed();
     void incrementPlaylistStatusRequests();
     void incrementRtpEventsProcessed();
+    void incrementRtpEncodeUnderruns();
     void incrementRtpSendFailures();
     void incrementRtpSendFailuresSuppressed();
     void incrementRtpSendRecoveries();
     void incrementRtpCircuitBreakerTrips();
+    void addRtpSendSyscalls(uint64_t syscalls);
+    void addRtpMixerUnderruns(uint64_t underruns);
+    void addRtpPacketsSuppressed(uint64_t packets);
     void incrementRtcpReportsSent();
     void incrementRtcpSendFailures();
     void incrementRtpEncoderResets();
@@ -231,13 +406,20 @@ class SystemCounters {
     void incrementWebsocketMessagesSent();
     void incrementWebsocketPingsSent();
     void incrementWebsocketPongsReceived();
+    void incrementWebsocketMessagesCoalesced();
+    void incrementWebsocketMessagesDropped();
+    void incrementWebsocketSlowClientHangups();
     void setRtpAudioLoadMetrics(uint64_t active, uint64_t queued, uint64_t accepted, uint64_t completed,
                                 uint64_t rejected, uint64_t cancelled, uint64_t failed);
+    void setAudioPrewarmMetrics(uint64_t pending, uint64_t scans, uint64_t checked, uint64_t encoded,
+                                uint64_t failed);
     void setLocalAudioPlaybackMetrics(uint64_t active, uint64_t queued, uint64_t accepted, uint64_t completed,
                                       uint64_t replaced, uint64_t rejected, uint64_t stopped, uint64_t failed,
                                       uint64_t timedOut);
+    void setE131SendMetrics(const std::vector<e131::UniverseSendStats> &stats);
 
     uint64_t getTotalFrames();
+    uint64_t getEventLoopBlockedFrames();
     uint64_t getEventsProcessed();
     uint64_t getFramesStreamed();
     uint64_t getDMXEventsProcessed();
@@ -249,10 +431,14 @@ class SystemCounters {
     uint64_t getPlaylistStatusRequests();
     uint64_t getRestRequestsProcessed();
     uint64_t getRtpEventsProcessed();
+    uint64_t getRtpEncodeUnderruns();
     uint64_t getRtpSendFailures();
     uint64_t getRtpSendFailuresSuppressed();
     uint64_t getRtpSendRecoveries();
     uint64_t getRtpCircuitBreakerTrips();
+    uint64_t getRtpSendSyscalls();
+    uint64_t getRtpMixerUnderruns();
+    uint64_t getRtpPacketsSuppressed();
     uint64_t getRtcpReportsSent();
     uint64_t getRtcpSendFailures();
     uint64_t getRtpEncoderResets();
@@ -263,6 +449,11 @@ class SystemCounters {
     uint64_t getRtpAudioLoadsRejected();
     uint64_t getRtpAudioLoadsCancelled();
     uint64_t getRtpAudioLoadsFailed();
+    uint64_t getAudioPrewarmPending();
+    uint64_t getAudioPrewarmScans();
+    uint64_t getAudioPrewarmChecked();
+    uint64_t getAudioPrewarmEncoded();
+    uint64_t getAudioPrewarmFailed();
     uint64_t getLocalAudioPlaybacksActive();
     uint64_t getLocalAudioPlaybacksQueued();
     uint64_t getLocalAudioPlaybacksAccepted();
@@ -278,12 +469,34 @@ class SystemCounters {
     uint64_t getWebsocketMessagesSent();
     uint64_t getWebsocketPingsSent();
     uint64_t getWebsocketPongsReceived();
+    uint64_t getWebsocketMessagesCoalesced();
+    uint64_t getWebsocketMessagesDropped();
+    uint64_t getWebsocketSlowClientHangups();
+    std::vector<e131::UniverseSendStats> getE131SendMetrics();
+
+    // The event loop records into these directly; they're lock-free for it
+    EventLoopTimings &getEventLoopTimings();
+
+    // Only the RTP output worker records into these
+    LatencyHistogram &getRtpFrameSetSendTimes();
+    std::array<LatencyHistogram, RTP_STREAMING_CHANNELS> &getRtpPacketJitter();
+    LatencyHistogram &getRtpPacingLateness();
+
+    // Messages are serialized on whichever thread sends them, so these record concurrently
+    void recordWebsocketSerialization(ws::MessageType type, uint64_t nanoseconds);
+    std::array<LatencyHistogram, ws::allMessageTypes.size()> &getWebsocketSerializationTimes();
+
+    // Frames are streamed from whichever thread their websocket is on, so these record concurrently
+    void recordStreamFrameLatency(bool fastLane, uint64_t nanoseconds);
+    LatencyHistogram &getStreamFrameFastLaneLatency();
+    LatencyHistogram &getStreamFrameFullPathLatency();
 
     // This one is different for how it gets to a DTO since it's not a normal type of object
     oatpp::Object<SystemCountersDto> convertToDto();
 
   private:
     std::atomic<uint64_t> totalFrames;
+    std::atomic<uint64_t> eventLoopBlockedFrames;
     std::atomic<uint64_t> eventsProcessed;
     std::atomic<uint64_t> framesStreamed;
     std::atomic<uint64_t> dmxEventsProcessed;
@@ -296,10 +509,14 @@ class SystemCounters {
     std::atomic<uint64_t> restRequestsProcessed;
     std::atomic<uint64_t> soundFilesServed;
     std::atomic<uint64_t> rtpEventsProcessed;
+    std::atomic<uint64_t> rtpEncodeUnderruns;
     std::atomic<uint64_t> rtpSendFailures;
     std::atomic<uint64_t> rtpSendFailuresSuppressed;
     std::atomic<uint64_t> rtpSendRecoveries;
     std::atomic<uint64_t> rtpCircuitBreakerTrips;
+    std::atomic<uint64_t> rtpSendSyscalls;
+    std::atomic<uint64_t> rtpMixerUnderruns;
+    std::atomic<uint64_t> rtpPacketsSuppressed;
     std::atomic<uint64_t> rtcpReportsSent;
     std::atomic<uint64_t> rtcpSendFailures;
     std::atomic<uint64_t> rtpEncoderResets;
@@ -310,6 +527,11 @@ class SystemCounters {
     std::atomic<uint64_t> rtpAudioLoadsRejected;
     std::atomic<uint64_t> rtpAudioLoadsCancelled;
     std::atomic<uint64_t> rtpAudioLoadsFailed;
+    std::atomic<uint64_t> audioPrewarmPending;
+    std::atomic<uint64_t> audioPrewarmScans;
+    std::atomic<uint64_t> audioPrewarmChecked;
+    std::atomic<uint64_t> audioPrewarmEncoded;
+    std::atomic<uint64_t> audioPrewarmFailed;
     std::atomic<uint64_t> localAudioPlaybacksActive;
     std::atomic<uint64_t> localAudioPlaybacksQueued;
     std::atomic<uint64_t> localAudioPlaybacksAccepted;
@@ -324,6 +546,23 @@ class SystemCounters {
     std::atomic<uint64_t> websocketMessagesSent;
     std::atomic<uint64_t> websocketPingsSent;
     std::atomic<uint64_t> websocketPongsReceived;
+    std::atomic<uint64_t> websocketMessagesCoalesced;
+    std::atomic<uint64_t> websocketMessagesDropped;
+    std::atomic<uint64_t> websocketSlowClientHangups;
+
+    // Published by the E131Server worker about once a second
+    std::mutex e131SendMetricsMutex;
+    std::vector<e131::UniverseSendStats> e131SendMetrics;
+
+    EventLoopTimings eventLoopTimings;
+    LatencyHistogram rtpFrameSetSendNs;
+    std::array<LatencyHistogram, RTP_STREAMING_CHANNELS> rtpPacketJitterNs;
+    LatencyHistogram rtpPacingLatenessNs;
+
+    std::array<LatencyHistogram, ws::allMessageTypes.size()> websocketSerializationNs;
+
+    LatencyHistogram streamFrameFastLaneNs;
+    LatencyHistogram streamFrameFullPathNs;
 };
 
 } // namespace creatures
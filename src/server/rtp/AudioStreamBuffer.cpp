@@ -8,9 +8,15 @@
  */
 //
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
 #include <filesystem>
-#include <future>
 #include <mutex>
+#include <optional>
+#include <span>
 #include <thread>
 #include <unordered_map>
 
@@ -18,9 +24,10 @@
 
 #include "AudioStreamBuffer.h"
 #include "server/audio/MonoWavDownmixer.h"
-#include "server/rtp/opus/OpusPriming.h"
+#include "server/rtp/opus/PrimedEncoderPool.h"
 #include "util/ObservabilityManager.h"
 #include "util/Result.h"
+#include "util/threadName.h"
 
 namespace creatures {
 extern std::shared_ptr<ObservabilityManager> observability;
@@ -31,13 +38,15 @@ using namespace creatures::rtp;
 
 namespace {
 
-std::shared_ptr<std::mutex> getFileLoadMutex(const std::string &audioFilePath) {
-    static std::mutex mutexMapMutex;
-    static std::unordered_map<std::string, std::weak_ptr<std::mutex>> mutexes;
-
+std::string fileLoadKey(const std::string &audioFilePath) {
     std::error_code error;
     const auto canonicalPath = std::filesystem::weakly_canonical(audioFilePath, error);
-    const std::string key = error ? audioFilePath : canonicalPath.string();
+    return error ? audioFilePath : canonicalPath.string();
+}
+
+std::shared_ptr<std::mutex> getFileLoadMutex(const std::string &key) {
+    static std::mutex mutexMapMutex;
+    static std::unordered_map<std::string, std::weak_ptr<std::mutex>> mutexes;
 
     std::lock_guard lock(mutexMapMutex);
     if (const auto existing = mutexes.find(key); existing != mutexes.end()) {
@@ -52,25 +61,113 @@ std::shared_ptr<std::mutex> getFileLoadMutex(const std::string &audioFilePath) {
     return mutex;
 }
 
-std::mutex &encodingJobMutex() {
-    // One 17-channel job already launches 17 Opus workers and saturates the
-    // production encoder host. Serializing cache misses prevents request bursts
-    // from multiplying that CPU load while cache hits remain concurrent.
-    static std::mutex mutex;
-    return mutex;
-}
+// Buffers that are still encoding, so a second load of the same file shares
+// the encode instead of starting another one. Only touched with that file's
+// load mutex held.
+std::mutex inFlightMutex;
+std::unordered_map<std::string, std::weak_ptr<AudioStreamBuffer>> inFlightEncodes;
 
 } // namespace
 
 // Static cache instance shared across all AudioStreamBuffer instances
 std::shared_ptr<util::AudioCache> AudioStreamBuffer::sharedAudioCacheInstance_ = nullptr;
 
+std::atomic<std::size_t> AudioStreamBuffer::encodeLeadFrames_{DEFAULT_RTP_ENCODE_LEAD_MS / RTP_FRAME_MS};
+
 std::shared_ptr<AudioStreamBuffer> AudioStreamBuffer::loadFromWavFile(const std::string &audioFilePath,
                                                                       std::shared_ptr<OperationSpan> parentSpan) {
-    const auto fileLoadMutex = getFileLoadMutex(audioFilePath);
+    auto buf = streamFromWavFile(audioFilePath, parentSpan);
+    if (!buf) {
+        return nullptr;
+    }
+    if (!buf->waitForFrames(buf->getFrameCount())) {
+        error("Failed to encode WAV file '{}'", audioFilePath);
+        return nullptr;
+    }
+    return buf;
+}
+
+std::shared_ptr<AudioStreamBuffer> AudioStreamBuffer::streamFromWavFile(const std::string &audioFilePath,
+                                                                        std::shared_ptr<OperationSpan> parentSpan) {
+    return startLoad(audioFilePath, std::move(parentSpan), nullptr);
+}
+
+Result<bool> AudioStreamBuffer::prewarm(const std::string &audioFilePath, const std::atomic<bool> &cancelled,
+                                        std::shared_ptr<util::ComputePool> pool,
+                                        std::shared_ptr<OperationSpan> parentSpan) {
+    if (!sharedAudioCacheInstance_) {
+        return Result<bool>{ServerError(ServerError::InternalError, "There's no audio cache to prewarm")};
+    }
+    if (sharedAudioCacheInstance_->isCached(audioFilePath)) {
+        return Result<bool>{false};
+    }
+
+    if (!pool) {
+        return Result<bool>{ServerError(ServerError::InternalError, "Prewarming needs a pool to encode on")};
+    }
+
+    auto buf = startLoad(audioFilePath, std::move(parentSpan), std::move(pool));
+    if (!buf) {
+        return Result<bool>{
+            ServerError(ServerError::InternalError, fmt::format("Failed to load WAV file '{}'", audioFilePath))};
+    }
+
+    // Wake up now and then to check for cancellation; dropping the buffer cancels its encode
+    std::unique_lock lock(buf->progressMutex_);
+    while (!buf->progressChanged_.wait_for(lock, std::chrono::milliseconds(100), [&buf] {
+        return buf->isFullyEncoded() || buf->hasEncodeFailed();
+    })) {
+        if (cancelled.load(std::memory_order_relaxed)) {
+            return Result<bool>{ServerError(ServerError::InternalError,
+                                            fmt::format("Prewarming {} was cancelled", audioFilePath))};
+        }
+    }
+    if (!buf->isFullyEncoded()) {
+        return Result<bool>{
+            ServerError(ServerError::InternalError, fmt::format("Failed to encode WAV file '{}'", audioFilePath))};
+    }
+    lock.unlock();
+
+    // The buffer's encode thread writes the cache file once it's done; wait for that too
+    buf.reset();
+    return Result<bool>{true};
+}
+
+std::shared_ptr<AudioStreamBuffer> AudioStreamBuffer::startLoad(const std::string &audioFilePath,
+                                                                std::shared_ptr<OperationSpan> parentSpan,
+                                                                std::shared_ptr<util::ComputePool> backgroundPool) {
+    const bool background = backgroundPool != nullptr;
+    const auto key = fileLoadKey(audioFilePath);
+    const auto fileLoadMutex = getFileLoadMutex(key);
     std::lock_guard fileLoadLock(*fileLoadMutex);
 
+    const auto leadFrames = encodeLeadFrames_.load(std::memory_order_relaxed);
+
+    // Somebody else is already encoding this file; share it
+    std::shared_ptr<AudioStreamBuffer> inFlight;
+    {
+        std::lock_guard lock(inFlightMutex);
+        if (const auto existing = inFlightEncodes.find(key); existing != inFlightEncodes.end()) {
+            inFlight = existing->second.lock();
+            if (!inFlight || inFlight->isFullyEncoded() || inFlight->hasEncodeFailed()) {
+                inFlightEncodes.erase(existing);
+                inFlight = nullptr;
+            }
+        }
+    }
+    if (inFlight && !background) {
+        // Somebody's about to play it, so the rest of it gets the shared pool
+        inFlight->backgroundEncode_.store(false, std::memory_order_relaxed);
+    }
+    if (inFlight && (background || inFlight->waitForFrames(std::min(leadFrames, inFlight->getFrameCount())))) {
+        debug("Sharing the in-progress encode of {} ({} of {} frames ready)", audioFilePath,
+              inFlight->getFramesReady(), inFlight->getFrameCount());
+        return inFlight;
+    }
+
     auto buf = std::shared_ptr<AudioStreamBuffer>(new AudioStreamBuffer());
+    buf->backgroundEncode_.store(background, std::memory_order_relaxed);
+    buf->backgroundPool_ = std::move(backgroundPool);
 
     // Try cache-enabled loading first if cache is available
     Result<size_t> loadResult = sharedAudioCacheInstance_
@@ -78,13 +175,26 @@ std::shared_ptr<AudioStreamBuffer> AudioStreamBuffer::loadFromWavFile(const std:
                                     : (debug("No audio cache available, loading directly from WAV file"),
                                        buf->loadWaveFile(audioFilePath, parentSpan));
 
-    if (loadResult.isSuccess()) {
-        debug("Successfully loaded audio buffer with {} frames", loadResult.getValue().value_or(0));
-        return buf;
-    } else {
+    if (!loadResult.isSuccess()) {
         error("Failed to load WAV file '{}': {}", audioFilePath, loadResult.getError()->getMessage());
         return nullptr;
     }
+
+    if (!buf->isFullyEncoded()) {
+        {
+            std::lock_guard lock(inFlightMutex);
+            inFlightEncodes[key] = buf;
+        }
+        // A background load doesn't wait for the lead; it's only interested in the whole file
+        if (!background && !buf->waitForFrames(std::min(leadFrames, buf->getFrameCount()))) {
+            error("Failed to encode the start of WAV file '{}'", audioFilePath);
+            return nullptr;
+        }
+        debug("Encode lead ready for {}: {} of {} frames", audioFilePath, buf->getFramesReady(), buf->getFrameCount());
+    }
+
+    debug("Successfully loaded audio buffer with {} frames", loadResult.getValue().value_or(0));
+    return buf;
 }
 
 void AudioStreamBuffer::setAudioCacheInstance(std::shared_ptr<util::AudioCache> audioCacheInstance) {
@@ -96,10 +206,42 @@ void AudioStreamBuffer::setAudioCacheInstance(std::shared_ptr<util::AudioCache>
     }
 }
 
-Result<size_t> AudioStreamBuffer::loadWaveFile(const std::string &audioFilePath,
-                                               std::shared_ptr<OperationSpan> parentSpan) {
-    const auto span =
-        observability ? observability->createChildOperationSpan("AudioStreamBuffer.loadWaveFile", parentSpan) : nullptr;
+void AudioStreamBuffer::setEncodeLeadFrames(std::size_t leadFrames) {
+    encodeLeadFrames_.store(std::max<std::size_t>(1, leadFrames), std::memory_order_relaxed);
+}
+
+AudioStreamBuffer::~AudioStreamBuffer() {
+    cancelEncoding_.store(true, std::memory_order_relaxed);
+    if (encodeThread_.joinable()) {
+        encodeThread_.join();
+    }
+}
+
+bool AudioStreamBuffer::waitForFrames(std::size_t frames) const {
+    std::unique_lock lock(progressMutex_);
+    progressChanged_.wait(lock, [this, frames] { return getFramesReady() >= frames || hasEncodeFailed(); });
+    return getFramesReady() >= frames;
+}
+
+void AudioStreamBuffer::publishFramesReady(std::size_t frames) {
+    {
+        std::lock_guard lock(progressMutex_);
+        framesReady_.store(frames, std::memory_order_release);
+    }
+    progressChanged_.notify_all();
+}
+
+void AudioStreamBuffer::markEncodeFailed() {
+    {
+        std::lock_guard lock(progressMutex_);
+        encodeFailed_.store(true, std::memory_order_release);
+    }
+    progressChanged_.notify_all();
+}
+
+Result<std::shared_ptr<audio::MonoWavStream>> AudioStreamBuffer::openWaveFile(const std::string &audioFilePath,
+                                                                              std::shared_ptr<OperationSpan> span) {
+    using OpenResult = Result<std::shared_ptr<audio::MonoWavStream>>;
     if (span) {
         span->setAttribute("file_path", audioFilePath);
     }
@@ -111,7 +253,7 @@ Result<size_t> AudioStreamBuffer::loadWaveFile(const std::string &audioFilePath,
             span->setError(errorMsg);
         }
         error(errorMsg);
-        return Result<size_t>{ServerError(ServerError::InvalidData, errorMsg)};
+        return OpenResult{ServerError(ServerError::InvalidData, errorMsg)};
     }
 
     if (!std::filesystem::exists(audioFilePath)) {
@@ -120,7 +262,7 @@ Result<size_t> AudioStreamBuffer::loadWaveFile(const std::string &audioFilePath,
             span->setError(errorMsg);
         }
         error(errorMsg);
-        return Result<size_t>{ServerError(ServerError::NotFound, errorMsg)};
+        return OpenResult{ServerError(ServerError::NotFound, errorMsg)};
     }
 
     if (!std::filesystem::is_regular_file(audioFilePath)) {
@@ -129,7 +271,7 @@ Result<size_t> AudioStreamBuffer::loadWaveFile(const std::string &audioFilePath,
             span->setError(errorMsg);
         }
         error(errorMsg);
-        return Result<size_t>{ServerError(ServerError::InvalidData, errorMsg)};
+        return OpenResult{ServerError(ServerError::InvalidData, errorMsg)};
     }
 
     debug("Loading WAV file: {}", audioFilePath);
@@ -141,7 +283,7 @@ Result<size_t> AudioStreamBuffer::loadWaveFile(const std::string &audioFilePath,
             span->setError(errorMsg);
         }
         error(errorMsg);
-        return Result<size_t>{ServerError(ServerError::InvalidData, errorMsg)};
+        return OpenResult{ServerError(ServerError::InvalidData, errorMsg)};
     }
     const auto wav = wavResult.getValue().value();
 
@@ -155,7 +297,7 @@ Result<size_t> AudioStreamBuffer::loadWaveFile(const std::string &audioFilePath,
         if (span) {
             span->setError(errorMsg);
         }
-        return Result<size_t>{ServerError(ServerError::InvalidData, errorMsg)};
+        return OpenResult{ServerError(ServerError::InvalidData, errorMsg)};
     }
 
     // Calculate frame counts with overflow protection
@@ -165,7 +307,7 @@ Result<size_t> AudioStreamBuffer::loadWaveFile(const std::string &audioFilePath,
         if (span) {
             span->setError(errorMsg);
         }
-        return Result<size_t>{ServerError(ServerError::InvalidData, errorMsg)};
+        return OpenResult{ServerError(ServerError::InvalidData, errorMsg)};
     }
 
     if (wav->totalFrames() > SIZE_MAX / RTP_STREAMING_CHANNELS) {
@@ -173,7 +315,7 @@ Result<size_t> AudioStreamBuffer::loadWaveFile(const std::string &audioFilePath,
         if (span) {
             span->setError(errorMsg);
         }
-        return Result<size_t>{ServerError(ServerError::InvalidData, errorMsg)};
+        return OpenResult{ServerError(ServerError::InvalidData, errorMsg)};
     }
     const auto totalSamples = static_cast<size_t>(wav->totalFrames()) * RTP_STREAMING_CHANNELS;
     constexpr size_t MAX_RTP_PCM_BYTES = 512ULL * 1024ULL * 1024ULL;
@@ -183,7 +325,7 @@ Result<size_t> AudioStreamBuffer::loadWaveFile(const std::string &audioFilePath,
         if (span) {
             span->setError(errorMsg);
         }
-        return Result<size_t>{ServerError(ServerError::InvalidData, errorMsg)};
+        return OpenResult{ServerError(ServerError::InvalidData, errorMsg)};
     }
 
     // Validate divisor to prevent division by zero
@@ -194,7 +336,7 @@ Result<size_t> AudioStreamBuffer::loadWaveFile(const std::string &audioFilePath,
         if (span) {
             span->setError(errorMsg);
         }
-        return Result<size_t>{ServerError(ServerError::InternalError, errorMsg)};
+        return OpenResult{ServerError(ServerError::InternalError, errorMsg)};
     }
 
     // Safe division with range checking
@@ -205,7 +347,7 @@ Result<size_t> AudioStreamBuffer::loadWaveFile(const std::string &audioFilePath,
         if (span) {
             span->setError(errorMsg);
         }
-        return Result<size_t>{ServerError(ServerError::InvalidData, errorMsg)};
+        return OpenResult{ServerError(ServerError::InvalidData, errorMsg)};
     }
 
     numberOfFramesPerChannel_ = totalSamples / samplesPerFrame;
@@ -217,152 +359,222 @@ Result<size_t> AudioStreamBuffer::loadWaveFile(const std::string &audioFilePath,
         if (span) {
             span->setError(errorMsg);
         }
-        return Result<size_t>{ServerError(ServerError::InvalidData, errorMsg)};
+        return OpenResult{ServerError(ServerError::InvalidData, errorMsg)};
     }
 
     // Additional safety check for maximum supported frames
-    constexpr size_t MAX_FRAMES_PER_CHANNEL = 1000000; // ~5.5 hours at 48kHz/20ms frames
-    if (numberOfFramesPerChannel_ > MAX_FRAMES_PER_CHANNEL) {
+    if (numberOfFramesPerChannel_ > RTP_MAX_FRAMES_PER_CHANNEL) {
         const auto errorMsg = fmt::format("WAV file too long: {} frames per channel (maximum supported: {})",
-                                          numberOfFramesPerChannel_, MAX_FRAMES_PER_CHANNEL);
+                                          numberOfFramesPerChannel_, RTP_MAX_FRAMES_PER_CHANNEL);
         error(errorMsg);
         if (span) {
             span->setError(errorMsg);
         }
-        return Result<size_t>{ServerError(ServerError::InvalidData, errorMsg)};
-    }
-
-    const size_t sampleFramesToEncode = numberOfFramesPerChannel_ * RTP_SAMPLES;
-    const size_t samplesToEncode = sampleFramesToEncode * RTP_STREAMING_CHANNELS;
-    debug("WAV file loaded: {} declared samples, {} samples used for {} frames per channel", totalSamples,
-          samplesToEncode, numberOfFramesPerChannel_);
-
-    std::vector<int16_t> pcmSamples(samplesToEncode);
-    size_t sampleFramesRead = 0;
-    while (sampleFramesRead < sampleFramesToEncode) {
-        const size_t framesRemaining = sampleFramesToEncode - sampleFramesRead;
-        const size_t framesRequested = std::min<size_t>(4096, framesRemaining);
-        auto readResult = wav->readInterleavedFrames(
-            std::span<int16_t>(pcmSamples)
-                .subspan(sampleFramesRead * RTP_STREAMING_CHANNELS, framesRequested * RTP_STREAMING_CHANNELS));
-        if (!readResult.isSuccess()) {
+        return OpenResult{ServerError(ServerError::InvalidData, errorMsg)};
+    }
+
+    if (span) {
+        span->setAttribute("frames_per_channel", static_cast<int64_t>(numberOfFramesPerChannel_));
+    }
+    return OpenResult{wav};
+}
+
+Result<size_t> AudioStreamBuffer::loadWaveFile(const std::string &audioFilePath,
+                                               std::shared_ptr<OperationSpan> parentSpan) {
+    const auto span =
+        observability ? observability->createChildOperationSpan("AudioStreamBuffer.loadWaveFile", parentSpan) : nullptr;
+
+    auto openResult = openWaveFile(audioFilePath, span);
+    if (!openResult.isSuccess()) {
+        return Result<size_t>{openResult.getError().value()};
+    }
+
+    // The encoder runs in CBR mode, so this is usually exactly enough for one allocation
+    constexpr std::size_t expectedPacketBytes = RTP_BITRATE / 8 * RTP_FRAME_MS / 1000;
+    auto frames = std::make_shared<util::OpusFrameArena>(
+        numberOfFramesPerChannel_, numberOfFramesPerChannel_ * RTP_STREAMING_CHANNELS * expectedPacketBytes);
+    encodedOpusFrames_ = frames;
+
+    startEncoding(openResult.getValue().value(), std::move(frames), audioFilePath, span);
+
+    if (span) {
+        span->setSuccess();
+    }
+    return Result<size_t>{numberOfFramesPerChannel_};
+}
+
+void AudioStreamBuffer::startEncoding(std::shared_ptr<audio::MonoWavStream> wav,
+                                      std::shared_ptr<util::OpusFrameArena> frames, std::string audioFilePath,
+                                      std::shared_ptr<OperationSpan> parentSpan) {
+    encodeThread_ = std::thread([this, wav = std::move(wav), frames = std::move(frames),
+                                 audioFilePath = std::move(audioFilePath), parentSpan = std::move(parentSpan)]() {
+        setThreadName("OpusEncode");
+
+        const auto span = observability
+                              ? observability->createChildOperationSpan("AudioStreamBuffer.encodeWaveFile", parentSpan)
+                              : nullptr;
+        if (span) {
+            span->setAttribute("file_path", audioFilePath);
+            span->setAttribute("frames_per_channel", static_cast<int64_t>(numberOfFramesPerChannel_));
+        }
+
+        Result<size_t> encodeResult{ServerError(ServerError::InternalError, "Opus encoding did not run")};
+        try {
+            encodeResult = encodeWaveFile(*wav, *frames, audioFilePath, span);
+        } catch (const std::exception &e) {
+            encodeResult = Result<size_t>{
+                ServerError(ServerError::InternalError, fmt::format("Error while encoding WAV to Opus: {}", e.what()))};
+        } catch (...) {
+            encodeResult =
+                Result<size_t>{ServerError(ServerError::InternalError, "Unknown error occurred during Opus encoding")};
+        }
+
+        if (!encodeResult.isSuccess()) {
+            const auto errorMsg = encodeResult.getError()->getMessage();
+            if (!cancelEncoding_.load(std::memory_order_relaxed)) {
+                error("Opus encoding of {} failed: {}", audioFilePath, errorMsg);
+            }
             if (span) {
-                span->setError(readResult.getError()->getMessage());
+                span->setError(errorMsg);
             }
-            return Result<size_t>{readResult.getError().value()};
+            markEncodeFailed();
+            return;
         }
-        const size_t framesRead = readResult.getValue().value();
-        if (framesRead == 0) {
-            break;
-        }
-        sampleFramesRead += framesRead;
-    }
-    if (sampleFramesRead < sampleFramesToEncode) {
-        const auto errorMsg = fmt::format("WAV file '{}' ended before its declared sample data", audioFilePath);
+
+        info("Successfully loaded and encoded {} frames per channel from WAV file: {}", numberOfFramesPerChannel_,
+             audioFilePath);
+        saveToCache(audioFilePath, span);
         if (span) {
-            span->setError(errorMsg);
+            span->setSuccess();
         }
-        return Result<size_t>{ServerError(ServerError::InvalidData, errorMsg)};
+    });
+}
+
+Result<size_t> AudioStreamBuffer::encodeWaveFile(audio::MonoWavStream &wav, util::OpusFrameArena &frames,
+                                                 const std::string &audioFilePath,
+                                                 std::shared_ptr<OperationSpan> parentSpan) {
+    debug("Encoding {} frames to Opus, {} frames at a time", numberOfFramesPerChannel_, RTP_ENCODE_CHUNK_FRAMES);
+
+    // Each channel keeps its own encoder for the whole file, so chunk
+    // boundaries are invisible in the output. They come already primed to
+    // match the decoder history established by MultiOpusRtpServer's startup
+    // silence sequence.
+    const auto encoderPool = opus::PrimedEncoderPool::shared();
+    std::array<opus::PrimedEncoderPool::Lease, RTP_STREAMING_CHANNELS> encoders;
+    for (auto &encoder : encoders) {
+        encoder = encoderPool->acquire();
     }
 
-    // Prepare for Opus encoding
-    debug("Encoding {} frames to Opus", numberOfFramesPerChannel_);
+    std::vector<int16_t> pcmSamples(RTP_ENCODE_CHUNK_FRAMES * RTP_SAMPLES * RTP_STREAMING_CHANNELS);
 
-    try {
-        // Resize storage for all encoded frames
-        for (auto &frameVector : encodedOpusFrames_) {
-            frameVector.resize(numberOfFramesPerChannel_);
-        }
+    // The channel workers encode into here; this thread is the only one that writes to the arena
+    std::array<std::array<std::vector<uint8_t>, RTP_ENCODE_CHUNK_FRAMES>, RTP_STREAMING_CHANNELS> chunkPackets;
+    std::array<std::array<bool, RTP_ENCODE_CHUNK_FRAMES>, RTP_STREAMING_CHANNELS> chunkSilent{};
+    std::size_t chunks = 0;
 
-        const int16_t *pcm = pcmSamples.data();
+    // A frame only counts as silent after a silent one: the encoder's lookahead
+    // carries the end of the audio before it into its packet. The priming was silent.
+    std::array<bool, RTP_STREAMING_CHANNELS> previousFrameSilent{};
+    previousFrameSilent.fill(true);
 
-        // Encode all 17 channels in parallel — each channel is independent
-        // with its own Opus encoder state, so this is trivially parallelizable.
-        // On the Ryzen 9 16-core server, all 17 channels encode simultaneously.
-        std::array<std::future<Result<size_t>>, RTP_STREAMING_CHANNELS> futures;
+    for (std::size_t firstFrame = 0; firstFrame < numberOfFramesPerChannel_; firstFrame += RTP_ENCODE_CHUNK_FRAMES) {
+        if (cancelEncoding_.load(std::memory_order_relaxed)) {
+            return Result<size_t>{ServerError(ServerError::InternalError, "Opus encoding cancelled")};
+        }
 
-        for (uint8_t channelIndex = 0; channelIndex < RTP_STREAMING_CHANNELS; ++channelIndex) {
-            futures[channelIndex] = std::async(std::launch::async, [this, pcm, channelIndex, span]() -> Result<size_t> {
-                auto channelSpan = observability
-                                       ? observability->createChildOperationSpan(
-                                             fmt::format("AudioStreamBuffer.encodeChannel.{}", channelIndex), span)
-                                       : nullptr;
-                if (channelSpan) {
-                    channelSpan->setAttribute("channel", static_cast<int64_t>(channelIndex));
-                    channelSpan->setAttribute("frames", static_cast<int64_t>(numberOfFramesPerChannel_));
-                }
+        const std::size_t frameCount = std::min(RTP_ENCODE_CHUNK_FRAMES, numberOfFramesPerChannel_ - firstFrame);
+        const std::size_t sampleFramesToRead = frameCount * RTP_SAMPLES;
+        std::size_t sampleFramesRead = 0;
+        while (sampleFramesRead < sampleFramesToRead) {
+            auto readResult = wav.readInterleavedFrames(
+                std::span<int16_t>(pcmSamples)
+                    .subspan(sampleFramesRead * RTP_STREAMING_CHANNELS,
+                             (sampleFramesToRead - sampleFramesRead) * RTP_STREAMING_CHANNELS));
+            if (!readResult.isSuccess()) {
+                return Result<size_t>{readResult.getError().value()};
+            }
+            const size_t framesRead = readResult.getValue().value();
+            if (framesRead == 0) {
+                return Result<size_t>{ServerError(
+                    ServerError::InvalidData,
+                    fmt::format("WAV file '{}' ended before its declared sample data", audioFilePath))};
+            }
+            sampleFramesRead += framesRead;
+        }
 
-                opus::Encoder encoder;
-                // Match the decoder history established by
-                // MultiOpusRtpServer's startup silence sequence.
-                static_cast<void>(opus::encodePrimingSequence(encoder));
+        // Encode all 17 channels in parallel — each channel is independent
+        // with its own Opus encoder state. A prewarm stays on its own pool
+        // unless somebody started playing the file in the meantime.
+        const auto pool =
+            backgroundEncode_.load(std::memory_order_relaxed) ? backgroundPool_ : util::ComputePool::shared();
+        const int16_t *pcm = pcmSamples.data();
+        std::array<std::optional<std::string>, RTP_STREAMING_CHANNELS> channelErrors;
+        pool->parallelFor(RTP_STREAMING_CHANNELS, [this, pcm, frameCount, &encoders, &chunkPackets, &chunkSilent,
+                                                   &previousFrameSilent, &channelErrors](std::size_t channelIndex) {
+            try {
+                auto &encoder = *encoders[channelIndex];
+                auto &packets = chunkPackets[channelIndex];
+                for (std::size_t frame = 0; frame < frameCount; ++frame) {
+                    // The destructor waits on this, maybe from the event loop or the RTP
+                    // sender, so don't make it sit through the rest of the chunk
+                    if (cancelEncoding_.load(std::memory_order_relaxed)) {
+                        return;
+                    }
 
-                for (std::size_t frameIndex = 0; frameIndex < numberOfFramesPerChannel_; ++frameIndex) {
-                    const int16_t *frameBase = pcm + frameIndex * RTP_SAMPLES * RTP_STREAMING_CHANNELS;
+                    const int16_t *frameBase = pcm + frame * RTP_SAMPLES * RTP_STREAMING_CHANNELS;
 
                     // De-interleave this channel's samples from the interleaved PCM
                     std::array<int16_t, RTP_SAMPLES> mono{};
+                    int peak = 0;
                     for (std::size_t s = 0; s < RTP_SAMPLES; ++s) {
                         mono[s] = frameBase[s * RTP_STREAMING_CHANNELS + channelIndex];
+                        peak = std::max(peak, std::abs(static_cast<int>(mono[s])));
                     }
 
-                    encodedOpusFrames_[channelIndex][frameIndex] = encoder.encode(mono.data());
-                }
+                    packets[frame] = encoder.encode(mono.data());
 
-                if (channelSpan) {
-                    channelSpan->setSuccess();
+                    const bool silent = peak <= RTP_SILENCE_PEAK;
+                    chunkSilent[channelIndex][frame] = silent && previousFrameSilent[channelIndex];
+                    previousFrameSilent[channelIndex] = silent;
                 }
-                return Result<size_t>{numberOfFramesPerChannel_};
-            });
+            } catch (const std::exception &e) {
+                channelErrors[channelIndex] =
+                    fmt::format("Opus encoding failed for channel {}: {}", channelIndex, e.what());
+            } catch (...) {
+                channelErrors[channelIndex] = fmt::format("Opus encoding failed for channel {}", channelIndex);
+            }
+        });
+
+        if (cancelEncoding_.load(std::memory_order_relaxed)) {
+            return Result<size_t>{ServerError(ServerError::InternalError, "Opus encoding cancelled")};
         }
 
-        // Wait for all channels to complete
-        for (uint8_t channelIndex = 0; channelIndex < RTP_STREAMING_CHANNELS; ++channelIndex) {
-            auto channelResult = futures[channelIndex].get();
-            if (!channelResult.isSuccess()) {
-                auto errorMsg = fmt::format("Opus encoding failed for channel {}: {}", channelIndex,
-                                            channelResult.getError()->getMessage());
-                error(errorMsg);
-                if (span) {
-                    span->setError(errorMsg);
-                }
-                return Result<size_t>{channelResult.getError().value()};
+        // Every channel is done by now, even if one of them failed, since they all share this chunk's PCM
+        for (const auto &channelError : channelErrors) {
+            if (channelError) {
+                return Result<size_t>{ServerError(ServerError::InternalError, *channelError)};
             }
         }
 
-        debug("Parallel encoding completed - {} frames × {} channels encoded to Opus", numberOfFramesPerChannel_,
-              RTP_STREAMING_CHANNELS);
-
-    } catch (const std::exception &e) {
-        const auto errorMsg = fmt::format("Error while encoding WAV to Opus: {}", e.what());
-        error(errorMsg);
-        if (span) {
-            span->setError(errorMsg);
-        }
-        return Result<size_t>{ServerError(ServerError::InternalError, errorMsg)};
-    } catch (...) {
-        const auto errorMsg = "Unknown error occurred during Opus encoding";
-        error(errorMsg);
-        if (span) {
-            span->setError(errorMsg);
+        for (uint8_t channelIndex = 0; channelIndex < RTP_STREAMING_CHANNELS; ++channelIndex) {
+            for (std::size_t frame = 0; frame < frameCount; ++frame) {
+                frames.set(channelIndex, firstFrame + frame, chunkPackets[channelIndex][frame],
+                           chunkSilent[channelIndex][frame]);
+            }
         }
-        return Result<size_t>{ServerError(ServerError::InternalError, errorMsg)};
-    }
 
-    info("Successfully loaded and encoded {} frames per channel from WAV file: {}", numberOfFramesPerChannel_,
-         audioFilePath);
-
-    if (span) {
-        span->setSuccess();
+        publishFramesReady(firstFrame + frameCount);
+        ++chunks;
     }
-    if (span) {
-        span->setAttribute("frames_per_channel", static_cast<int64_t>(numberOfFramesPerChannel_));
-    }
-    if (span) {
-        span->setAttribute("total_frames", static_cast<int64_t>(numberOfFramesPerChannel_ * RTP_STREAMING_CHANNELS));
+
+    debug("Parallel encoding completed - {} frames × {} channels encoded to Opus in {} chunks",
+          numberOfFramesPerChannel_, RTP_STREAMING_CHANNELS, chunks);
+    if (parentSpan) {
+        parentSpan->setAttribute("chunks", static_cast<int64_t>(chunks));
+        parentSpan->setAttribute("total_frames", static_cast<int64_t>(numberOfFramesPerChannel_ * RTP_STREAMING_CHANNELS));
     }
 
-    // Return the number of frames we successfully loaded
+    // Return the number of frames we successfully encoded
     return Result<size_t>{numberOfFramesPerChannel_};
 }
 
@@ -398,14 +610,12 @@ Result<size_t> AudioStreamBuffer::loadWithCaching(const std::string &audioFilePa
         return Result<size_t>{numberOfFramesPerChannel_};
     }
 
-    // Cache miss: load from WAV and cache the result
-    debug("Cache miss for {}, loading from WAV file and caching", audioFilePath);
+    // Cache miss: encode the WAV in the background; it's cached once the encode finishes
+    debug("Cache miss for {}, encoding from WAV file and caching", audioFilePath);
     if (span) {
         span->setAttribute("cache_result", "miss");
     }
 
-    std::lock_guard encodingJobLock(encodingJobMutex());
-
     auto loadResult = loadWaveFile(audioFilePath, span);
     if (!loadResult.isSuccess()) {
         if (span) {
@@ -414,10 +624,20 @@ Result<size_t> AudioStreamBuffer::loadWithCaching(const std::string &audioFilePa
         return loadResult;
     }
 
-    // Save to cache for next time
+    if (span) {
+        span->setSuccess();
+    }
+    return loadResult;
+}
+
+void AudioStreamBuffer::saveToCache(const std::string &audioFilePath, std::shared_ptr<OperationSpan> span) const {
+    if (!sharedAudioCacheInstance_) {
+        return;
+    }
+
     util::AudioCache::CachedAudioData audioDataToCache;
     audioDataToCache.framesPerChannel = numberOfFramesPerChannel_;
-    audioDataToCache.encodedFrames = encodedOpusFrames_;
+    audioDataToCache.frames = encodedOpusFrames_;
 
     auto cacheResult = sharedAudioCacheInstance_->saveToCache(audioFilePath, audioDataToCache, span);
     if (cacheResult.isSuccess()) {
@@ -429,16 +649,12 @@ Result<size_t> AudioStreamBuffer::loadWithCaching(const std::string &audioFilePa
         warn("Failed to cache audio data for {}: {}", audioFilePath, cacheResult.getError()->getMessage());
         // Don't fail the overall operation if caching fails
     }
-
-    if (span) {
-        span->setSuccess();
-    }
-    return loadResult;
 }
 
 void AudioStreamBuffer::loadFromCachedAudioData(const util::AudioCache::CachedAudioData &cachedAudioData) {
     numberOfFramesPerChannel_ = cachedAudioData.framesPerChannel;
-    encodedOpusFrames_ = cachedAudioData.encodedFrames;
+    encodedOpusFrames_ = cachedAudioData.frames;
+    publishFramesReady(numberOfFramesPerChannel_);
 
     debug("Loaded {} frames per channel from cached audio data", numberOfFramesPerChannel_);
 }
@@ -8,53 +8,151 @@
 
 #pragma once
 
-#include <array>
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <span>
 #include <string>
-#include <vector>
+#include <thread>
 
 #include "server/config.h"
 #include "server/rtp/opus/OpusEncoderWrapper.h"
 #include "util/AudioCache.h"
+#include "util/ComputePool.h"
 #include "util/ObservabilityManager.h"
+#include "util/OpusFrameArena.h"
 #include "util/Result.h"
 
+namespace creatures::audio {
+class MonoWavStream;
+}
+
 namespace creatures::rtp {
 
+/**
+ * The Opus frames for one 17-channel WAV file
+ *
+ * On a cache miss the file is encoded progressively: a background thread reads
+ * it a chunk at a time and has the shared ComputePool encode the channels of
+ * each chunk in parallel, and getFramesReady() is a watermark that
+ * grows until it reaches getFrameCount(). streamFromWavFile() hands the buffer
+ * back as soon as the configured lead is encoded, so playback can start while
+ * the rest is still being encoded. The finished result is written to the
+ * AudioCache once the last chunk is done.
+ */
 class AudioStreamBuffer {
   public:
-    /// Factory method: load a 48 kHz / 17-channel WAV file and build Opus frames (with caching)
+    /// Factory method: load a 48 kHz / 17-channel WAV file and build Opus frames (with caching).
+    /// Returns once every frame is encoded.
     static std::shared_ptr<AudioStreamBuffer> loadFromWavFile(const std::string &audioFilePath,
                                                               std::shared_ptr<OperationSpan> parentSpan = nullptr);
 
+    /// Like loadFromWavFile(), but returns as soon as the encode lead is ready and
+    /// keeps encoding the rest in the background
+    static std::shared_ptr<AudioStreamBuffer> streamFromWavFile(const std::string &audioFilePath,
+                                                                std::shared_ptr<OperationSpan> parentSpan = nullptr);
+
+    /// Make sure a WAV file is in the AudioCache, encoding it on `pool` if it isn't.
+    /// The encode moves over to the shared pool if a playback load of the same file shares it.
+    /// @param cancelled checked while encoding; set it to give up (the encode is dropped)
+    /// @param pool where to encode; a small one kept to a CPU budget, so playback encodes aren't slowed down
+    /// @return true if the file had to be encoded, false if it was already cached
+    static Result<bool> prewarm(const std::string &audioFilePath, const std::atomic<bool> &cancelled,
+                                std::shared_ptr<util::ComputePool> pool,
+                                std::shared_ptr<OperationSpan> parentSpan = nullptr);
+
     /// Set the audio cache instance to use for caching encoded files
     static void setAudioCacheInstance(std::shared_ptr<util::AudioCache> audioCacheInstance);
 
-    /// Number of 10ms frames available (same for every channel)
+    /// Set how many frames streamFromWavFile() waits for before handing the buffer back
+    static void setEncodeLeadFrames(std::size_t leadFrames);
+
+    ~AudioStreamBuffer();
+
+    AudioStreamBuffer(const AudioStreamBuffer &) = delete;
+    AudioStreamBuffer &operator=(const AudioStreamBuffer &) = delete;
+
+    /// Number of 10ms frames in the file (same for every channel)
     [[nodiscard]] std::size_t getFrameCount() const { return numberOfFramesPerChannel_; }
 
-    /// Get encoded Opus payload for specified channel (0-16) at given frame index
-    [[nodiscard]] const std::vector<uint8_t> &getEncodedFrame(uint8_t channelIndex, std::size_t frameIndex) const {
-        return encodedOpusFrames_[channelIndex][frameIndex];
+    /// Frames [0, getFramesReady()) are encoded and safe to read from any thread
+    [[nodiscard]] std::size_t getFramesReady() const { return framesReady_.load(std::memory_order_acquire); }
+
+    [[nodiscard]] bool isFullyEncoded() const { return getFramesReady() >= numberOfFramesPerChannel_; }
+
+    /// True if the background encode gave up; getFramesReady() won't grow any more
+    [[nodiscard]] bool hasEncodeFailed() const { return encodeFailed_.load(std::memory_order_acquire); }
+
+    /// Wait until at least `frames` frames are ready (or the encode fails)
+    /// @return true if they're ready
+    bool waitForFrames(std::size_t frames) const;
+
+    /// Get encoded Opus payload for specified channel (0-16) at given frame index (below getFramesReady())
+    [[nodiscard]] std::span<const uint8_t> getEncodedFrame(uint8_t channelIndex, std::size_t frameIndex) const {
+        return encodedOpusFrames_->frame(channelIndex, frameIndex);
+    }
+
+    /// Was that frame silent, and the one before it? Then receivers can do without the packet.
+    [[nodiscard]] bool isSilentFrame(uint8_t channelIndex, std::size_t frameIndex) const {
+        return encodedOpusFrames_->isSilent(channelIndex, frameIndex);
     }
 
   private:
     AudioStreamBuffer() = default;
+
+    /// streamFromWavFile(), but a background load (one with a pool of its own) doesn't wait for the encode lead
+    static std::shared_ptr<AudioStreamBuffer> startLoad(const std::string &audioFilePath,
+                                                        std::shared_ptr<OperationSpan> parentSpan,
+                                                        std::shared_ptr<util::ComputePool> backgroundPool);
+
+    /// Validate the WAV file and count its frames; encoding starts with startEncoding()
+    Result<std::shared_ptr<audio::MonoWavStream>> openWaveFile(const std::string &audioFilePath,
+                                                                std::shared_ptr<OperationSpan> span);
+
+    /// Validate the WAV file and start encoding it in the background
     Result<size_t> loadWaveFile(const std::string &audioFilePath, std::shared_ptr<OperationSpan> parentSpan);
 
-    /// Load from cache if available, otherwise encode and cache
+    /// Start encoding on a background thread, writing the result to the cache (if any) when it's done
+    void startEncoding(std::shared_ptr<audio::MonoWavStream> wav, std::shared_ptr<util::OpusFrameArena> frames,
+                       std::string audioFilePath, std::shared_ptr<OperationSpan> parentSpan);
+
+    /// Read and encode the whole file a chunk at a time into `frames`, publishing each chunk as it's done
+    Result<size_t> encodeWaveFile(audio::MonoWavStream &wav, util::OpusFrameArena &frames,
+                                  const std::string &audioFilePath, std::shared_ptr<OperationSpan> parentSpan);
+
+    /// Load from cache if available, otherwise start encoding
     Result<size_t> loadWithCaching(const std::string &audioFilePath, std::shared_ptr<OperationSpan> parentSpan);
 
-    /// Load cached data into this buffer
+    /// Share the cached frames with this buffer
     void loadFromCachedAudioData(const util::AudioCache::CachedAudioData &cachedAudioData);
 
+    /// Save the finished encode to the cache
+    void saveToCache(const std::string &audioFilePath, std::shared_ptr<OperationSpan> span) const;
+
+    void publishFramesReady(std::size_t frames);
+    void markEncodeFailed();
+
     std::size_t numberOfFramesPerChannel_{0};
 
-    // Layout: encodedOpusFrames_[channel][frame] -> bytes
-    std::array<std::vector<std::vector<uint8_t>>, RTP_STREAMING_CHANNELS> encodedOpusFrames_;
+    // Shared with the AudioCache: a cache hit hands over the arena it loaded,
+    // and a finished encode hands this one to the cache. While encoding, only
+    // the encode thread writes to it, and only frames below framesReady_ are read.
+    std::shared_ptr<const util::OpusFrameArena> encodedOpusFrames_;
+
+    std::atomic<std::size_t> framesReady_{0};
+    std::atomic<bool> encodeFailed_{false};
+    std::atomic<bool> cancelEncoding_{false};
+    std::atomic<bool> backgroundEncode_{false}; // encoding on backgroundPool_ rather than the shared pool
+    std::shared_ptr<util::ComputePool> backgroundPool_;
+    mutable std::mutex progressMutex_;
+    mutable std::condition_variable progressChanged_;
+    std::thread encodeThread_;
 
     // Static cache instance shared across all AudioStreamBuffer instances
     static std::shared_ptr<util::AudioCache> sharedAudioCacheInstance_;
+
+    static std::atomic<std::size_t> encodeLeadFrames_;
 };
 
 } // namespace creatures::rtp
\ No newline at end of file
@@ -6,25 +6,31 @@
  * which manages multiple RTP streams for Opus-encoded audio channels.
  */
 
+#include <algorithm>
+#include <cerrno>
 #include <chrono>
+#include <cstring>
 #include <exception>
 #include <limits>
 #include <random>
 #include <stdexcept>
+#include <utility>
+
+#include <pthread.h>
+#include <sched.h>
 
 #include <fmt/format.h>
 #include <spdlog/spdlog.h>
-#include <uvgrtp/lib.hh>
-#include <uvgrtp/media_stream.hh>
-#include <uvgrtp/util.hh>
 
 #include "MultiOpusRtpServer.h"
 #include "server/config.h"
 #include "server/metrics/counters.h"
 #include "server/namespace-stuffs.h"
 #include "server/rtp/AudioStreamBuffer.h"
+#include "server/rtp/RtpMixer.h"
 #include "server/rtp/opus/OpusEncoderWrapper.h"
 #include "server/rtp/opus/OpusPriming.h"
+#include "util/ComputePool.h"
 #include "util/ObservabilityManager.h"
 #include "util/threadName.h"
 #include "util/websocketUtils.h"
@@ -47,36 +53,16 @@ uint32_t randomSynchronizationSourceBase() {
 
 } // namespace
 
-MultiOpusRtpServer::MultiOpusRtpServer() {
+MultiOpusRtpServer::MultiOpusRtpServer(std::unique_ptr<RtpTransport> transport, RtpPacingOptions pacing,
+                                       bool suppressSilence, std::vector<int> outputCpus)
+    : pacing_(pacing), outputCpus_(std::move(outputCpus)), silenceGate_(suppressSilence),
+      transport_(std::move(transport)) {
     try {
-        for (size_t channelIndex = 0; channelIndex < RTP_STREAMING_CHANNELS; ++channelIndex) {
-            // Create session with multicast address
-            rtpSessions_[channelIndex] = rtpContext_.create_session(RTP_GROUPS[channelIndex]);
-            if (!rtpSessions_[channelIndex]) {
-                throw std::runtime_error(fmt::format("unable to create RTP session for channel {}", channelIndex));
-            }
-
-            // Create media stream with local port, remote port, format, and flags
-            mediaStreams_[channelIndex] = rtpSessions_[channelIndex]->create_stream(RTP_PORT,        // source port
-                                                                                    RTP_PORT,        // destination port
-                                                                                    RTP_FORMAT_OPUS, // format
-                                                                                    RCE_SEND_ONLY);  // flags
-            if (!mediaStreams_[channelIndex]) {
-                throw std::runtime_error(fmt::format("unable to create RTP stream for channel {}", channelIndex));
-            }
-
-            // Override the dynamic payload type so VLC/Wireshark recognize Opus (payload type 96)
-            if (mediaStreams_[channelIndex]->configure_ctx(RCC_DYN_PAYLOAD_TYPE, RTP_OPUS_PAYLOAD_PT) != RTP_OK) {
-                throw std::runtime_error(
-                    fmt::format("unable to configure RTP payload type for channel {}", channelIndex));
-            }
-
-            // Configure the clock rate for accurate timing (48 kHz)
-            if (mediaStreams_[channelIndex]->configure_ctx(RCC_CLOCK_RATE, RTP_SRATE) != RTP_OK) {
-                throw std::runtime_error(
-                    fmt::format("unable to configure RTP clock rate for channel {}", channelIndex));
-            }
+        if (!transport_) {
+            throw std::invalid_argument("no RTP transport");
+        }
 
+        for (size_t channelIndex = 0; channelIndex < RTP_STREAMING_CHANNELS; ++channelIndex) {
             // Pre-encode the complete silence sequence. Reusing packet zero
             // would repeatedly present the decoder with the wrong encoder
             // history at stream startup.
@@ -89,7 +75,9 @@ MultiOpusRtpServer::MultiOpusRtpServer() {
         outputThread_ = std::thread(&MultiOpusRtpServer::runOutputWorker, this);
         isServerReady_.store(true);
 
-        info("MultiOpusRtpServer initialized with {} channels, starting SSRC: {}", RTP_STREAMING_CHANNELS,
+        info("MultiOpusRtpServer initialized with {} channels over {} ({}), starting SSRC: {}", RTP_STREAMING_CHANNELS,
+             transport_->name(),
+             pacing_.paced ? fmt::format("paced, {}ms lead", pacing_.leadMs) : std::string("event loop timed"),
              currentSynchronizationSourceIdentifier_);
     } catch (const std::exception &exception) {
         isServerReady_.store(false);
@@ -105,31 +93,23 @@ MultiOpusRtpServer::~MultiOpusRtpServer() {
         outputThread_.join();
     }
     rtcpSender_.shutdown();
-
-    for (size_t channelIndex = 0; channelIndex < RTP_STREAMING_CHANNELS; ++channelIndex) {
-        if (rtpSessions_[channelIndex] && mediaStreams_[channelIndex]) {
-            rtpSessions_[channelIndex]->destroy_stream(mediaStreams_[channelIndex]);
-        }
-        if (rtpSessions_[channelIndex]) {
-            rtpContext_.destroy_session(rtpSessions_[channelIndex]);
-        }
-    }
 }
 
 RtpOutputLease MultiOpusRtpServer::acquireOutput(std::string ownerId) {
     auto lease = outputCoordinator_.acquire(std::move(ownerId));
-    size_t purged = 0;
     {
         auto guard = outputCoordinator_.lockIfCurrent(lease);
         if (guard) {
             readyGeneration_.store(0);
             rtcpSender_.discardSessionUnless(lease.generation);
-            purged = outputQueue_.eraseIf(
-                [&lease](const OutputCommand &command) { return command.lease.generation != lease.generation; });
         }
     }
-    info("RTP output acquired by {} at generation {} ({} stale command(s) purged)", lease.ownerId, lease.generation,
-         purged);
+
+    // The old generation's queued commands are skipped as the worker gets to
+    // them; this has it let go of their buffers now
+    outputQueue_.wake();
+    info("RTP output acquired by {} at generation {} ({} command(s) queued)", lease.ownerId, lease.generation,
+         outputQueue_.size());
     return lease;
 }
 
@@ -138,32 +118,31 @@ void MultiOpusRtpServer::releaseOutput(const RtpOutputLease &lease) {
     rtcpSender_.endSession(lease.generation);
     uint64_t expectedGeneration = lease.generation;
     readyGeneration_.compare_exchange_strong(expectedGeneration, 0);
-    const size_t purged = outputQueue_.eraseIf(
-        [&lease](const OutputCommand &command) { return command.lease.generation == lease.generation; });
-    debug("RTP output release requested by {} at generation {} ({} queued command(s) purged)", lease.ownerId,
-          lease.generation, purged);
+    outputQueue_.wake();
+    debug("RTP output release requested by {} at generation {} ({} command(s) queued)", lease.ownerId,
+          lease.generation, outputQueue_.size());
 }
 
 bool MultiOpusRtpServer::isCurrentOutput(const RtpOutputLease &lease) const {
     return outputCoordinator_.isCurrent(lease);
 }
 
-RtpEnqueueResult MultiOpusRtpServer::enqueueReset(const RtpOutputLease &lease, AsyncAudioTraceContext traceContext) {
+RtpEnqueueResult MultiOpusRtpServer::enqueueReset(const RtpOutputLease &lease,
+                                                  const AsyncAudioTraceContext &traceContext) {
     if (!isReady()) {
         return RtpEnqueueResult::ServerNotReady;
     }
     if (!outputCoordinator_.isCurrent(lease)) {
         return RtpEnqueueResult::StaleLease;
     }
-    if (!outputQueue_.tryPush(
-            OutputCommand{OutputCommandType::Reset, lease, nullptr, 0, 0, false, nullptr, std::move(traceContext)})) {
-        return RtpEnqueueResult::QueueFull;
-    }
-    return RtpEnqueueResult::Accepted;
+    OutputCommand command;
+    command.type = OutputCommandType::Reset;
+    command.enqueueFrame = traceContext.enqueueFrame;
+    return enqueue(command, lease, nullptr, nullptr, nullptr, traceContext);
 }
 
 RtpEnqueueResult MultiOpusRtpServer::enqueueSilentFrame(const RtpOutputLease &lease, size_t primingFrameIndex,
-                                                        AsyncAudioTraceContext traceContext) {
+                                                        const AsyncAudioTraceContext &traceContext) {
     if (!isReady()) {
         return RtpEnqueueResult::ServerNotReady;
     }
@@ -173,30 +152,96 @@ RtpEnqueueResult MultiOpusRtpServer::enqueueSilentFrame(const RtpOutputLease &le
     if (primingFrameIndex >= RTP_PRIMING_FRAMES) {
         return RtpEnqueueResult::InvalidData;
     }
-    if (!outputQueue_.tryPush(OutputCommand{OutputCommandType::SilentFrame, lease, nullptr, primingFrameIndex, 0, false,
-                                            nullptr, std::move(traceContext)})) {
-        return RtpEnqueueResult::QueueFull;
-    }
-    return RtpEnqueueResult::Accepted;
+    OutputCommand command;
+    command.type = OutputCommandType::SilentFrame;
+    command.frameIndex = primingFrameIndex;
+    command.enqueueFrame = traceContext.enqueueFrame;
+    return enqueue(command, lease, nullptr, nullptr, nullptr, traceContext);
 }
 
 RtpEnqueueResult MultiOpusRtpServer::enqueueAudioFrame(const RtpOutputLease &lease,
-                                                       std::shared_ptr<AudioStreamBuffer> buffer, size_t frameIndex,
+                                                       const std::shared_ptr<AudioStreamBuffer> &buffer,
+                                                       size_t frameIndex, size_t skippedFrames, bool releaseAfterSend,
+                                                       const std::shared_ptr<void> &releaseAfterSendHold,
+                                                       const AsyncAudioTraceContext &traceContext) {
+    if (!isReady()) {
+        return RtpEnqueueResult::ServerNotReady;
+    }
+    if (!buffer || frameIndex >= buffer->getFramesReady()) {
+        return RtpEnqueueResult::InvalidData;
+    }
+    if (!outputCoordinator_.isCurrent(lease)) {
+        return RtpEnqueueResult::StaleLease;
+    }
+    OutputCommand command;
+    command.type = OutputCommandType::AudioFrame;
+    command.frameIndex = frameIndex;
+    command.skippedFrames = skippedFrames;
+    command.enqueueFrame = traceContext.enqueueFrame;
+    command.releaseAfterSend = releaseAfterSend;
+    return enqueue(command, lease, buffer, releaseAfterSendHold, nullptr, traceContext);
+}
+
+RtpEnqueueResult MultiOpusRtpServer::enqueueMixedFrame(const RtpOutputLease &lease,
+                                                       const std::shared_ptr<RtpMixer> &mixer, size_t frameIndex,
                                                        size_t skippedFrames, bool releaseAfterSend,
-                                                       std::shared_ptr<void> releaseAfterSendHold,
-                                                       AsyncAudioTraceContext traceContext) {
+                                                       const AsyncAudioTraceContext &traceContext) {
     if (!isReady()) {
         return RtpEnqueueResult::ServerNotReady;
     }
-    if (!buffer || frameIndex >= buffer->getFrameCount()) {
+    if (!mixer) {
         return RtpEnqueueResult::InvalidData;
     }
     if (!outputCoordinator_.isCurrent(lease)) {
         return RtpEnqueueResult::StaleLease;
     }
-    if (!outputQueue_.tryPush(OutputCommand{OutputCommandType::AudioFrame, lease, std::move(buffer), frameIndex,
-                                            skippedFrames, releaseAfterSend, std::move(releaseAfterSendHold),
-                                            std::move(traceContext)})) {
+    OutputCommand command;
+    command.type = OutputCommandType::MixedFrame;
+    command.frameIndex = frameIndex;
+    command.skippedFrames = skippedFrames;
+    command.enqueueFrame = traceContext.enqueueFrame;
+    command.releaseAfterSend = releaseAfterSend;
+    return enqueue(command, lease, nullptr, nullptr, mixer, traceContext);
+}
+
+/**
+ * Point the command at its stream and queue it (event loop only).
+ *
+ * Consecutive commands with the same generation, buffer and hold share a
+ * stream table slot, so a playing stream costs a slot once and a copy of a
+ * small struct every frame after that. When the stream changes, the new
+ * command tells the worker it can close the old slot: the queue's in order,
+ * so nothing behind it can still need it.
+ */
+RtpEnqueueResult MultiOpusRtpServer::enqueue(OutputCommand command, const RtpOutputLease &lease,
+                                             const std::shared_ptr<AudioStreamBuffer> &buffer,
+                                             const std::shared_ptr<void> &releaseAfterSendHold,
+                                             const std::shared_ptr<RtpMixer> &mixer,
+                                             const AsyncAudioTraceContext &traceContext) {
+    // Check for room before opening a slot, since a slot that's opened has to
+    // go out with this command for the worker to ever close it
+    if (outputQueue_.full()) {
+        return RtpEnqueueResult::QueueFull;
+    }
+
+    const bool sameStream = producerStream_.generation == lease.generation &&
+                            producerStream_.buffer == buffer.get() &&
+                            producerStream_.releaseAfterSendHold == releaseAfterSendHold.get() &&
+                            producerStream_.mixer == mixer.get() && streams_.isOpen(producerStream_.handle);
+    if (!sameStream) {
+        const auto handle = streams_.open(RtpStream{lease, buffer, releaseAfterSendHold, traceContext, mixer});
+        if (!handle) {
+            warn("RTP stream table is full ({} streams); dropping a {} command for {} generation {}",
+                 RtpStreamTable::SLOTS, commandTypeName(command.type), lease.ownerId, lease.generation);
+            return RtpEnqueueResult::QueueFull;
+        }
+        command.retire = producerStream_.handle;
+        producerStream_ =
+            ProducerStream{*handle, lease.generation, buffer.get(), releaseAfterSendHold.get(), mixer.get()};
+    }
+    command.stream = producerStream_.handle;
+
+    if (!outputQueue_.tryPush(command)) {
         return RtpEnqueueResult::QueueFull;
     }
     return RtpEnqueueResult::Accepted;
@@ -204,64 +249,146 @@ RtpEnqueueResult MultiOpusRtpServer::enqueueAudioFrame(const RtpOutputLease &lea
 
 void MultiOpusRtpServer::runOutputWorker() {
     setThreadName("RtpOutputWorker");
-    while (auto command = outputQueue_.waitPop()) {
-        try {
-            processOutputCommand(*command);
-        } catch (...) {
-            // processOutputCommand handles its own exceptions (including the
-            // publish-before-release ordering); this is a last-resort guard so
-            // the worker thread can never die.
-            error("Unexpected exception escaped RTP output command processing for {} generation {}",
-                  command->lease.ownerId, command->lease.generation);
+    if (const auto pinned = util::ComputePool::pinThisThread(outputCpus_); !pinned.isSuccess()) {
+        warn("Unable to pin the RTP output worker to its CPUs: {}", pinned.getError()->getMessage());
+    }
+    if (pacing_.paced && pacing_.realtimePriority > 0) {
+        applyRealtimePriority();
+    }
+
+    OutputCommand command;
+    while (true) {
+        const auto waited = outputQueue_.waitPop(command);
+        if (waited == RtpCommandWait::Stopped) {
+            break;
+        }
+        if (waited == RtpCommandWait::Woken) {
+            closeStaleStreamsPending_ = true;
+        } else {
+            try {
+                processOutputCommand(command);
+            } catch (...) {
+                // processOutputCommand handles its own exceptions (including the
+                // publish-before-release ordering); this is a last-resort guard so
+                // the worker thread can never die.
+                error("Unexpected exception escaped RTP output processing of a {} command (frame {})",
+                      commandTypeName(command.type), command.frameIndex);
+            }
+        }
+        if (closeStaleStreamsPending_) {
+            closeStaleStreams();
         }
     }
+
+    // Don't keep buffers and holds around until the server's destroyed
+    streams_.closeIf([](const RtpStream &) { return true; });
+}
+
+void MultiOpusRtpServer::applyRealtimePriority() const {
+#if defined(__linux__)
+    sched_param parameters{};
+    parameters.sched_priority = pacing_.realtimePriority;
+    const int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &parameters);
+    if (result != 0) {
+        warn("Unable to run the RTP output worker SCHED_FIFO at priority {}: {}; pacing at normal priority",
+             pacing_.realtimePriority, std::strerror(result));
+        return;
+    }
+    info("RTP output worker running SCHED_FIFO at priority {}", pacing_.realtimePriority);
+#else
+    warn("Real-time priority for the RTP output worker is only supported on Linux; pacing at normal priority");
+#endif
+}
+
+/** Let go of every stream whose generation is over; their queued commands will find nothing and be skipped */
+void MultiOpusRtpServer::closeStaleStreams() {
+    closeStaleStreamsPending_ = false;
+    const size_t closed =
+        streams_.closeIf([this](const RtpStream &stream) { return !outputCoordinator_.isCurrent(stream.lease); });
+    if (closed > 0) {
+        trace("Closed {} stale RTP stream(s)", closed);
+    }
 }
 
 void MultiOpusRtpServer::processOutputCommand(const OutputCommand &command) {
+    // Every command that used the event loop's previous stream is ahead of this one
+    streams_.close(command.retire);
+
+    const RtpStream *found = streams_.find(command.stream);
+    if (!found) {
+        debug("Discarding RTP {} command (frame {}) for a stream that's already closed", commandTypeName(command.type),
+              command.frameIndex);
+        return;
+    }
+    const RtpStream &stream = *found;
+
+    if (pacing_.paced && command.type != OutputCommandType::Reset) {
+        waitForDeadline(command, stream);
+    }
+
     OutputResult result;
     try {
         {
-            auto guard = outputCoordinator_.lockIfCurrent(command.lease);
+            auto guard = outputCoordinator_.lockIfCurrent(stream.lease);
             if (!guard) {
-                debug("Discarding stale RTP command for {} generation {}", command.lease.ownerId,
-                      command.lease.generation);
+                debug("Discarding stale RTP command for {} generation {}", stream.lease.ownerId,
+                      stream.lease.generation);
+                closeStaleStreamsPending_ = true;
                 return;
             }
 
             switch (command.type) {
             case OutputCommandType::Reset:
                 readyGeneration_.store(0);
-                rotateSynchronizationSourceIdentifiers(command.lease.generation, command.lease.ownerId,
-                                                       command.traceContext);
-                readyGeneration_.store(command.lease.generation);
-                failureTracker_.beginGeneration(command.lease.generation, std::chrono::steady_clock::now());
+                rotateSynchronizationSourceIdentifiers(stream.lease.generation, stream.lease.ownerId,
+                                                       traceContextFor(command, stream));
+                readyGeneration_.store(stream.lease.generation);
+                failureTracker_.beginGeneration(stream.lease.generation, std::chrono::steady_clock::now());
                 break;
             case OutputCommandType::SilentFrame:
-                if (readyGeneration_.load() != command.lease.generation) {
+                if (readyGeneration_.load() != stream.lease.generation) {
                     throw std::runtime_error("RTP silent frame rejected because its generation was not reset");
                 }
                 result = sendSilentFrameSet(command.frameIndex);
-                rtcpSender_.recordFrame(command.lease.generation, result.sentOctets);
+                rtcpSender_.recordFrame(stream.lease.generation, result.sentOctets);
                 frameClock_.advance();
                 break;
             case OutputCommandType::AudioFrame:
-                if (readyGeneration_.load() != command.lease.generation) {
+                if (readyGeneration_.load() != stream.lease.generation) {
                     throw std::runtime_error("RTP audio frame rejected because its generation was not reset");
                 }
+                if (!stream.buffer) {
+                    throw std::runtime_error("RTP audio frame has no buffer");
+                }
                 frameClock_.advance(command.skippedFrames);
-                result = sendAudioFrameSet(*command.buffer, command.frameIndex);
-                rtcpSender_.recordFrame(command.lease.generation, result.sentOctets);
+                result = sendAudioFrameSet(*stream.buffer, command.frameIndex);
+                rtcpSender_.recordFrame(stream.lease.generation, result.sentOctets);
                 frameClock_.advance();
                 break;
+            case OutputCommandType::MixedFrame:
+                if (readyGeneration_.load() != stream.lease.generation) {
+                    throw std::runtime_error("RTP mixed frame rejected because its generation was not reset");
+                }
+                if (!stream.mixer) {
+                    throw std::runtime_error("RTP mixed frame has no mixer");
+                }
+                frameClock_.advance(command.skippedFrames);
+                result = sendMixedFrameSet(*stream.mixer, command.frameIndex == 0, command.skippedFrames);
+                rtcpSender_.recordFrame(stream.lease.generation, result.sentOctets);
+                frameClock_.advance();
+                if (creatures::metrics) {
+                    creatures::metrics->addRtpMixerUnderruns(stream.mixer->takeUnderruns());
+                }
+                break;
             }
         }
 
     } catch (const std::exception &exception) {
-        handleCommandException(command, exception);
+        handleCommandException(command, stream, exception);
         return;
     } catch (...) {
         const std::runtime_error exception("unknown RTP output exception");
-        handleCommandException(command, exception);
+        handleCommandException(command, stream, exception);
         return;
     }
 
@@ -270,10 +397,29 @@ void MultiOpusRtpServer::processOutputCommand(const OutputCommand &command) {
     // must always be able to find its terminal record. (Both run after the
     // guard scope; the coordinator mutex is non-recursive.)
     if (command.type != OutputCommandType::Reset) {
-        handleSendOutcome(command, &result, nullptr);
+        handleSendOutcome(command, stream, &result, nullptr);
     }
     if (command.releaseAfterSend) {
-        releaseGeneration(command.lease);
+        releaseGeneration(stream.lease);
+    }
+}
+
+/**
+ * Hold a frame set until its RTP timestamp says it's due.
+ *
+ * This sleeps before the lease guard is taken so acquireOutput() never waits
+ * on it. A command from a generation that's over (or not reset yet) doesn't
+ * wait at all; it's about to be skipped or rejected anyway.
+ */
+void MultiOpusRtpServer::waitForDeadline(const OutputCommand &command, const RtpStream &stream) {
+    if (readyGeneration_.load() != stream.lease.generation || !outputCoordinator_.isCurrent(stream.lease)) {
+        return;
+    }
+
+    const uint32_t timestamp = frameClock_.current() + static_cast<uint32_t>(command.skippedFrames * RTP_SAMPLES);
+    const auto lateness = pacer_.waitUntilDue(timestamp);
+    if (creatures::metrics) {
+        creatures::metrics->getRtpPacingLateness().record(static_cast<uint64_t>(lateness.count()));
     }
 }
 
@@ -286,20 +432,20 @@ void MultiOpusRtpServer::processOutputCommand(const OutputCommand &command) {
  * release as a benign supersede. Send-command exceptions feed the breaker
  * like any failed send, then honor the final-frame release contract.
  */
-void MultiOpusRtpServer::handleCommandException(const OutputCommand &command,
+void MultiOpusRtpServer::handleCommandException(const OutputCommand &command, const RtpStream &stream,
                                                 const std::exception &exception) noexcept {
     try {
         if (command.type == OutputCommandType::Reset) {
             const RtpSendFailureTracker::Action action{};
-            recordOutputException(command, exception, action);
-            tripCircuitBreaker(command, nullptr, &exception, action, "reset_failed");
+            recordOutputException(command, stream, exception, action);
+            tripCircuitBreaker(command, stream, nullptr, &exception, action, "reset_failed");
             return;
         }
 
-        handleSendOutcome(command, nullptr, &exception);
+        handleSendOutcome(command, stream, nullptr, &exception);
         if (command.releaseAfterSend) {
             // No-op if the breaker already released this generation.
-            releaseGeneration(command.lease);
+            releaseGeneration(stream.lease);
         }
     } catch (const std::exception &handlerException) {
         error("Failed to handle RTP command exception: {}", handlerException.what());
@@ -309,12 +455,15 @@ void MultiOpusRtpServer::handleCommandException(const OutputCommand &command,
 }
 
 /** The worker's release idiom: every step is generation-guarded, so releasing
- *  an already-released or superseded generation is a safe no-op. */
+ *  an already-released or superseded generation is a safe no-op. The
+ *  generation's streams are closed once the command that released it is done
+ *  with them. */
 void MultiOpusRtpServer::releaseGeneration(const RtpOutputLease &lease) noexcept {
     outputCoordinator_.release(lease);
     rtcpSender_.endSession(lease.generation);
     uint64_t expectedGeneration = lease.generation;
     readyGeneration_.compare_exchange_strong(expectedGeneration, 0);
+    closeStaleStreamsPending_ = true;
 }
 
 /**
@@ -326,16 +475,16 @@ void MultiOpusRtpServer::releaseGeneration(const RtpOutputLease &lease) noexcept
  * the first failure of a run and every Nth thereafter. Crossing a trip
  * threshold terminates the generation.
  */
-void MultiOpusRtpServer::handleSendOutcome(const OutputCommand &command, const OutputResult *result,
-                                           const std::exception *exception) noexcept {
+void MultiOpusRtpServer::handleSendOutcome(const OutputCommand &command, const RtpStream &stream,
+                                           const OutputResult *result, const std::exception *exception) noexcept {
     try {
         const auto now = std::chrono::steady_clock::now();
 
-        if (!exception && result && result->error == RTP_OK) {
-            const auto action = failureTracker_.recordSuccess(command.lease.generation, now);
+        if (!exception && result && result->error == 0) {
+            const auto action = failureTracker_.recordSuccess(stream.lease.generation, now);
             if (action.recovered) {
                 info("RTP output sends recovered for {} generation {} after {} consecutive failure(s)",
-                     command.lease.ownerId, command.lease.generation, action.consecutiveFailures);
+                     stream.lease.ownerId, stream.lease.generation, action.consecutiveFailures);
                 if (creatures::metrics) {
                     creatures::metrics->incrementRtpSendRecoveries();
                 }
@@ -343,28 +492,28 @@ void MultiOpusRtpServer::handleSendOutcome(const OutputCommand &command, const O
             return;
         }
 
-        const auto action = failureTracker_.recordFailure(command.lease.generation, now);
+        const auto action = failureTracker_.recordFailure(stream.lease.generation, now);
         if (creatures::metrics) {
             creatures::metrics->incrementRtpSendFailures();
         }
         if (action.emitDetail) {
             if (exception) {
-                recordOutputException(command, *exception, action);
+                recordOutputException(command, stream, *exception, action);
             } else if (result) {
-                recordOutputFailure(command, *result, action);
+                recordOutputFailure(command, stream, *result, action);
             }
         } else if (creatures::metrics) {
             creatures::metrics->incrementRtpSendFailuresSuppressed();
         }
         if (action.trip) {
-            tripCircuitBreaker(command, result, exception, action, "failure_threshold");
+            tripCircuitBreaker(command, stream, result, exception, action, "failure_threshold");
         } else if (command.releaseAfterSend && action.consecutiveFailures >= 2) {
             // The stream's FINAL frame set failed as part of a failure run: no
             // further send will retry it and the lease is about to be released,
             // so end the generation terminally even though no threshold
             // tripped. An isolated single-frame blip on the last frame stays a
             // delivered-with-loss success (April's ≥2 rule, 2026-08-21).
-            tripCircuitBreaker(command, result, exception, action, "final_frame_failure");
+            tripCircuitBreaker(command, stream, result, exception, action, "final_frame_failure");
         }
     } catch (const std::exception &handlerException) {
         error("Failed to handle RTP send outcome: {}", handlerException.what());
@@ -376,27 +525,27 @@ void MultiOpusRtpServer::handleSendOutcome(const OutputCommand &command, const O
 /**
  * Open the circuit for a generation whose sends keep failing: publish the
  * terminal record (so the event loop can distinguish this from a benign
- * supersede even after the lease is gone), release the generation, drop its
- * queued frames, and tell connected clients — the same notice broadcast the
- * shutdown path uses.
+ * supersede even after the lease is gone), release the generation (its
+ * queued frames are skipped as stale), and tell connected clients — the same
+ * notice broadcast the shutdown path uses.
  */
-void MultiOpusRtpServer::tripCircuitBreaker(const OutputCommand &command, const OutputResult *result,
-                                            const std::exception *exception,
+void MultiOpusRtpServer::tripCircuitBreaker(const OutputCommand &command, const RtpStream &stream,
+                                            const OutputResult *result, const std::exception *exception,
                                             const RtpSendFailureTracker::Action &action, const char *reason) noexcept {
     try {
         TerminalFailure failure;
-        failure.generation = command.lease.generation;
-        failure.ownerId = command.lease.ownerId;
+        failure.generation = stream.lease.generation;
+        failure.ownerId = stream.lease.ownerId;
         failure.commandType = commandTypeName(command.type);
         failure.frameIndex = command.frameIndex;
         failure.consecutiveFailures = action.consecutiveFailures;
-        failure.traceContext = command.traceContext;
+        failure.traceContext = traceContextFor(command, stream);
         if (result) {
-            failure.errorCode = static_cast<int>(result->error);
+            failure.errorCode = result->error;
             failure.firstFailedChannel = result->firstFailedChannel;
             failure.rtpTimestamp = result->timestamp;
-            failure.errorMessage = fmt::format("RTP send failed on channel {} with error {}",
-                                               result->firstFailedChannel, static_cast<int>(result->error));
+            failure.errorMessage =
+                fmt::format("RTP send failed on channel {} with error {}", result->firstFailedChannel, result->error);
         } else if (exception) {
             failure.errorMessage = exception->what();
         }
@@ -405,14 +554,13 @@ void MultiOpusRtpServer::tripCircuitBreaker(const OutputCommand &command, const
         // released lease without the terminal record being findable.
         terminalFailures_.publish(failure);
 
-        releaseGeneration(command.lease);
-        const size_t purged = outputQueue_.eraseIf(
-            [&command](const OutputCommand &queued) { return queued.lease.generation == command.lease.generation; });
+        releaseGeneration(stream.lease);
+        const size_t queued = outputQueue_.size();
 
         error("RTP circuit breaker OPEN ({}) for {} generation {}: {} ({} consecutive / {} windowed failures, {} "
-              "queued command(s) dropped)",
-              reason, command.lease.ownerId, command.lease.generation, failure.errorMessage, action.consecutiveFailures,
-              action.windowedFailures, purged);
+              "command(s) still queued)",
+              reason, stream.lease.ownerId, stream.lease.generation, failure.errorMessage, action.consecutiveFailures,
+              action.windowedFailures, queued);
 
         if (creatures::metrics) {
             creatures::metrics->incrementRtpCircuitBreakerTrips();
@@ -421,15 +569,15 @@ void MultiOpusRtpServer::tripCircuitBreaker(const OutputCommand &command, const
         if (auto span = creatures::observability
                             ? creatures::observability->createOperationSpan("rtp.output.circuit_open")
                             : nullptr) {
-            span->setAttribute("rtp.owner_id", command.lease.ownerId);
-            span->setAttribute("rtp.generation", static_cast<int64_t>(command.lease.generation));
+            span->setAttribute("rtp.owner_id", stream.lease.ownerId);
+            span->setAttribute("rtp.generation", static_cast<int64_t>(stream.lease.generation));
             span->setAttribute("rtp.command.type", failure.commandType);
             span->setAttribute("rtp.frame.index", static_cast<int64_t>(failure.frameIndex));
             span->setAttribute("rtp.circuit_open.reason", reason);
             span->setAttribute("rtp.failures.consecutive", static_cast<int64_t>(action.consecutiveFailures));
             span->setAttribute("rtp.failures.windowed", static_cast<int64_t>(action.windowedFailures));
-            span->setAttribute("rtp.queue.purged", static_cast<int64_t>(purged));
-            applyTraceContextAttributes(span, command.traceContext);
+            span->setAttribute("rtp.queue.depth", static_cast<int64_t>(queued));
+            applyTraceContextAttributes(span, stream.traceContext);
             span->setAttribute("error.type", "RtpCircuitBreakerOpen");
             span->setAttribute("error.code", failure.errorCode);
             span->setAttribute("error.message", failure.errorMessage);
@@ -440,7 +588,7 @@ void MultiOpusRtpServer::tripCircuitBreaker(const OutputCommand &command, const
         // broadcast just enqueues onto the websocket outgoing queue, so it is
         // safe from this worker thread.
         const auto broadcastResult = creatures::broadcastNoticeToAllClients(fmt::format(
-            "RTP audio output failed and playback was stopped ({} — {})", command.lease.ownerId, failure.errorMessage));
+            "RTP audio output failed and playback was stopped ({} — {})", stream.lease.ownerId, failure.errorMessage));
         if (!broadcastResult.isSuccess()) {
             warn("Unable to broadcast RTP circuit breaker notice: {}", broadcastResult.getError()->getMessage());
         }
@@ -479,6 +627,12 @@ void MultiOpusRtpServer::applyTraceContextAttributes(const std::shared_ptr<creat
     }
 }
 
+AsyncAudioTraceContext MultiOpusRtpServer::traceContextFor(const OutputCommand &command, const RtpStream &stream) {
+    auto traceContext = stream.traceContext;
+    traceContext.enqueueFrame = command.enqueueFrame;
+    return traceContext;
+}
+
 const char *MultiOpusRtpServer::commandTypeName(OutputCommandType type) {
     switch (type) {
     case OutputCommandType::Reset:
@@ -487,17 +641,20 @@ const char *MultiOpusRtpServer::commandTypeName(OutputCommandType type) {
         return "silent_frame";
     case OutputCommandType::AudioFrame:
         return "audio_frame";
+    case OutputCommandType::MixedFrame:
+        return "mixed_frame";
     }
     return "unknown";
 }
 
-void MultiOpusRtpServer::recordOutputFailure(const OutputCommand &command, const OutputResult &result,
+void MultiOpusRtpServer::recordOutputFailure(const OutputCommand &command, const RtpStream &stream,
+                                             const OutputResult &result,
                                              const RtpSendFailureTracker::Action &action) noexcept {
     try {
         const auto errorMessage =
             fmt::format("RTP {} send failed on channel {} at timestamp {} with error {}", commandTypeName(command.type),
-                        result.firstFailedChannel, result.timestamp, static_cast<int>(result.error));
-        error("{} (owner {}, generation {}, frame {})", errorMessage, command.lease.ownerId, command.lease.generation,
+                        result.firstFailedChannel, result.timestamp, result.error);
+        error("{} (owner {}, generation {}, frame {})", errorMessage, stream.lease.ownerId, stream.lease.generation,
               command.frameIndex);
 
         auto span = creatures::observability ? creatures::observability->createOperationSpan("rtp.output.send_failure")
@@ -506,21 +663,21 @@ void MultiOpusRtpServer::recordOutputFailure(const OutputCommand &command, const
             return;
         }
         span->setAttribute("rtp.command.type", commandTypeName(command.type));
-        span->setAttribute("rtp.owner_id", command.lease.ownerId);
-        span->setAttribute("rtp.generation", static_cast<int64_t>(command.lease.generation));
+        span->setAttribute("rtp.owner_id", stream.lease.ownerId);
+        span->setAttribute("rtp.generation", static_cast<int64_t>(stream.lease.generation));
         span->setAttribute("rtp.channel", result.firstFailedChannel);
         span->setAttribute("rtp.timestamp", result.timestamp);
         span->setAttribute("rtp.frame.index", static_cast<int64_t>(command.frameIndex));
         span->setAttribute("rtp.frames.skipped", static_cast<int64_t>(command.skippedFrames));
-        span->setAttribute("rtp.enqueue.frame", command.traceContext.enqueueFrame);
+        span->setAttribute("rtp.enqueue.frame", command.enqueueFrame);
         span->setAttribute("rtp.queue.depth", static_cast<int64_t>(outputQueue_.size()));
         span->setAttribute("rtp.queue.capacity", static_cast<int64_t>(outputQueue_.capacity()));
-        applyTraceContextAttributes(span, command.traceContext);
+        applyTraceContextAttributes(span, stream.traceContext);
         span->setAttribute("rtp.failures.consecutive", static_cast<int64_t>(action.consecutiveFailures));
         span->setAttribute("rtp.failures.windowed", static_cast<int64_t>(action.windowedFailures));
         span->setAttribute("rtp.failures.suppressed_since_last", static_cast<int64_t>(action.suppressedSinceLastEmit));
         span->setAttribute("error.type", "RtpSendFailure");
-        span->setAttribute("error.code", static_cast<int>(result.error));
+        span->setAttribute("error.code", result.error);
         span->setAttribute("error.message", errorMessage);
         span->setError(errorMessage);
     } catch (const std::exception &exception) {
@@ -530,12 +687,13 @@ void MultiOpusRtpServer::recordOutputFailure(const OutputCommand &command, const
     }
 }
 
-void MultiOpusRtpServer::recordOutputException(const OutputCommand &command, const std::exception &exception,
+void MultiOpusRtpServer::recordOutputException(const OutputCommand &command, const RtpStream &stream,
+                                               const std::exception &exception,
                                                const RtpSendFailureTracker::Action &action) noexcept {
     try {
         const auto errorMessage =
             fmt::format("RTP {} command threw: {}", commandTypeName(command.type), exception.what());
-        error("{} (owner {}, generation {}, frame {})", errorMessage, command.lease.ownerId, command.lease.generation,
+        error("{} (owner {}, generation {}, frame {})", errorMessage, stream.lease.ownerId, stream.lease.generation,
               command.frameIndex);
 
         auto span = creatures::observability
@@ -545,12 +703,12 @@ void MultiOpusRtpServer::recordOutputException(const OutputCommand &command, con
             return;
         }
         span->setAttribute("rtp.command.type", commandTypeName(command.type));
-        span->setAttribute("rtp.owner_id", command.lease.ownerId);
-        span->setAttribute("rtp.generation", static_cast<int64_t>(command.lease.generation));
+        span->setAttribute("rtp.owner_id", stream.lease.ownerId);
+        span->setAttribute("rtp.generation", static_cast<int64_t>(stream.lease.generation));
         span->setAttribute("rtp.frame.index", static_cast<int64_t>(command.frameIndex));
         span->setAttribute("rtp.frames.skipped", static_cast<int64_t>(command.skippedFrames));
-        span->setAttribute("rtp.enqueue.frame", command.traceContext.enqueueFrame);
-        applyTraceContextAttributes(span, command.traceContext);
+        span->setAttribute("rtp.enqueue.frame", command.enqueueFrame);
+        applyTraceContextAttributes(span, stream.traceContext);
         span->setAttribute("rtp.failures.consecutive", static_cast<int64_t>(action.consecutiveFailures));
         span->setAttribute("rtp.failures.windowed", static_cast<int64_t>(action.windowedFailures));
         span->setAttribute("rtp.failures.suppressed_since_last", static_cast<int64_t>(action.suppressedSinceLastEmit));
@@ -565,17 +723,6 @@ void MultiOpusRtpServer::recordOutputException(const OutputCommand &command, con
     }
 }
 
-rtp_error_t MultiOpusRtpServer::send(uint8_t channelIndex, const std::vector<uint8_t> &opusEncodedFrame,
-                                     uint32_t timestamp) {
-    if (channelIndex >= RTP_STREAMING_CHANNELS || !mediaStreams_[channelIndex]) {
-        return RTP_INVALID_VALUE;
-    }
-
-    return mediaStreams_[channelIndex]->push_frame(
-        const_cast<uint8_t *>(opusEncodedFrame.data()), // uvgRTP requires non-const pointer
-        opusEncodedFrame.size(), timestamp, RTP_NO_FLAGS);
-}
-
 void MultiOpusRtpServer::rotateSynchronizationSourceIdentifiers(uint64_t generation, const std::string &ownerId,
                                                                 const AsyncAudioTraceContext &traceContext) {
     nextSynchronizationSourceIdentifier_ = randomSynchronizationSourceBase();
@@ -583,55 +730,65 @@ void MultiOpusRtpServer::rotateSynchronizationSourceIdentifiers(uint64_t generat
     RtcpSender::SynchronizationSources synchronizationSources{};
 
     for (size_t channelIndex = 0; channelIndex < RTP_STREAMING_CHANNELS; ++channelIndex) {
-        if (mediaStreams_[channelIndex]) {
-            // Assign fresh SSRC, then increment for next channel
-            const uint32_t synchronizationSource = nextSynchronizationSourceIdentifier_++;
-            if (mediaStreams_[channelIndex]->configure_ctx(RCC_SSRC, synchronizationSource) != RTP_OK) {
-                throw std::runtime_error(fmt::format("unable to configure RTP SSRC for channel {}", channelIndex));
-            }
-            synchronizationSources[channelIndex] = synchronizationSource;
-        }
+        // Assign fresh SSRC, then increment for next channel
+        synchronizationSources[channelIndex] = nextSynchronizationSourceIdentifier_++;
     }
+    transport_->setSynchronizationSources(synchronizationSources);
+    silenceGate_.reset();
 
     const auto clockMapping = resetFrameTimestamp();
+    pacer_.beginStream(clockMapping);
     rtcpSender_.beginSession(generation, ownerId, synchronizationSources, clockMapping, traceContext);
     debug("SSRC rotated! New range: {} to {}", currentSynchronizationSourceIdentifier_,
           nextSynchronizationSourceIdentifier_ - 1);
 }
 
-MultiOpusRtpServer::OutputResult MultiOpusRtpServer::sendSilentFrameSet(size_t primingFrameIndex) {
+MultiOpusRtpServer::OutputResult MultiOpusRtpServer::sendFrameSet(const RtpTransport::FrameSet &frames) {
     const uint32_t timestamp = frameClock_.current();
-    OutputResult frameResult{RTP_OK, 0, timestamp, {}};
+    const auto started = std::chrono::steady_clock::now();
+    const auto sent = transport_->sendFrameSet(frames, timestamp);
+    const auto elapsed = std::chrono::steady_clock::now() - started;
+
+    if (creatures::metrics) {
+        creatures::metrics->addRtpSendSyscalls(sent.syscalls);
+        creatures::metrics->addRtpPacketsSuppressed(static_cast<uint64_t>(
+            std::count_if(frames.begin(), frames.end(), [](const auto &frame) { return frame.empty(); })));
+        creatures::metrics->getRtpFrameSetSendTimes().record(
+            static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        pacer_.recordSent(timestamp, sent.sentOctets, started, creatures::metrics->getRtpPacketJitter());
+    }
+    return OutputResult{sent.error, sent.firstFailedChannel, timestamp, sent.sentOctets};
+}
 
-    for (uint8_t channelIndex = 0; channelIndex < RTP_STREAMING_CHANNELS; ++channelIndex) {
-        const auto &encodedFrame = encodedSilentFrames_[channelIndex][primingFrameIndex];
-        const auto transmissionResult = send(channelIndex, encodedFrame, timestamp);
-        if (transmissionResult != RTP_OK && frameResult.error == RTP_OK) {
-            frameResult.error = transmissionResult;
-            frameResult.firstFailedChannel = channelIndex;
-        } else if (transmissionResult == RTP_OK) {
-            frameResult.sentOctets[channelIndex] = static_cast<uint32_t>(encodedFrame.size());
-        }
+MultiOpusRtpServer::OutputResult MultiOpusRtpServer::sendSilentFrameSet(size_t primingFrameIndex) {
+    RtpTransport::FrameSet frames;
+    for (size_t channelIndex = 0; channelIndex < RTP_STREAMING_CHANNELS; ++channelIndex) {
+        frames[channelIndex] = encodedSilentFrames_[channelIndex][primingFrameIndex];
     }
-    return frameResult;
+    return sendFrameSet(frames);
 }
 
 MultiOpusRtpServer::OutputResult MultiOpusRtpServer::sendAudioFrameSet(const AudioStreamBuffer &buffer,
                                                                        size_t frameIndex) {
-    const uint32_t timestamp = frameClock_.current();
-    OutputResult frameResult{RTP_OK, 0, timestamp, {}};
-
+    RtpTransport::FrameSet frames;
     for (uint8_t channelIndex = 0; channelIndex < RTP_STREAMING_CHANNELS; ++channelIndex) {
-        const auto &encodedFrame = buffer.getEncodedFrame(channelIndex, frameIndex);
-        const auto transmissionResult = send(channelIndex, encodedFrame, timestamp);
-        if (transmissionResult != RTP_OK && frameResult.error == RTP_OK) {
-            frameResult.error = transmissionResult;
-            frameResult.firstFailedChannel = channelIndex;
-        } else if (transmissionResult == RTP_OK) {
-            frameResult.sentOctets[channelIndex] = static_cast<uint32_t>(encodedFrame.size());
+        if (silenceGate_.admit(channelIndex, buffer.isSilentFrame(channelIndex, frameIndex))) {
+            frames[channelIndex] = buffer.getEncodedFrame(channelIndex, frameIndex);
+        }
+    }
+    return sendFrameSet(frames);
+}
+
+MultiOpusRtpServer::OutputResult MultiOpusRtpServer::sendMixedFrameSet(RtpMixer &mixer, bool newStream,
+                                                                       size_t skippedFrames) {
+    // Every channel's still encoded, so the encoders' history stays what the decoders would have heard
+    RtpTransport::FrameSet frames = mixer.renderFrameSet(newStream, skippedFrames);
+    for (size_t channelIndex = 0; channelIndex < RTP_STREAMING_CHANNELS; ++channelIndex) {
+        if (!silenceGate_.admit(channelIndex, mixer.isChannelSilent(channelIndex))) {
+            frames[channelIndex] = {};
         }
     }
-    return frameResult;
+    return sendFrameSet(frames);
 }
 
 RtpClockMapping MultiOpusRtpServer::resetFrameTimestamp() {
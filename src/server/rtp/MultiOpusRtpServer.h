@@ -11,19 +11,24 @@
 #include <array>
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <span>
 #include <string>
 #include <thread>
-#include <uvgrtp/lib.hh>
 #include <vector>
 
 #include "server/config.h"
 #include "server/rtp/AsyncAudioTraceContext.h"
-#include "server/rtp/BoundedCommandQueue.h"
 #include "server/rtp/RtcpSender.h"
+#include "server/rtp/RtpCommandRing.h"
 #include "server/rtp/RtpFrameClock.h"
 #include "server/rtp/RtpOutputCoordinator.h"
 #include "server/rtp/RtpOutputHealth.h"
+#include "server/rtp/RtpPacer.h"
+#include "server/rtp/RtpSilenceGate.h"
+#include "server/rtp/RtpStreamTable.h"
+#include "server/rtp/RtpTransport.h"
 
 namespace creatures {
 class OperationSpan;
@@ -32,6 +37,7 @@ class OperationSpan;
 namespace creatures::rtp {
 
 class AudioStreamBuffer;
+class RtpMixer;
 
 enum class RtpEnqueueResult {
     Accepted,
@@ -41,11 +47,25 @@ enum class RtpEnqueueResult {
     InvalidData,
 };
 
+/** How the output worker times frame sets (see RTP_PACING in config.h) */
+struct RtpPacingOptions {
+    bool paced{false};       // send each frame set at its RTP clock deadline instead of when it's dequeued
+    uint32_t leadMs{0};      // paced only: how far ahead of its deadline the event loop queues a frame set
+    int realtimePriority{0}; // paced only: SCHED_FIFO priority for the output worker, 0 to leave it alone
+};
+
 class MultiOpusRtpServer {
   public:
     static constexpr size_t OUTPUT_QUEUE_CAPACITY = 64;
 
-    MultiOpusRtpServer();
+    /**
+     * @param transport how packets get to the network; the server isn't ready without one
+     * @param pacing how the output worker times frame sets
+     * @param suppressSilence leave out silent channels' packets (see RTP_SILENCE_SUPPRESSION in config.h)
+     * @param outputCpus CPUs to pin the output worker to; empty leaves it unpinned
+     */
+    explicit MultiOpusRtpServer(std::unique_ptr<RtpTransport> transport, RtpPacingOptions pacing = {},
+                                bool suppressSilence = false, std::vector<int> outputCpus = {});
     ~MultiOpusRtpServer();
 
     /**
@@ -57,20 +77,47 @@ class MultiOpusRtpServer {
     void releaseOutput(const RtpOutputLease &lease);
     [[nodiscard]] bool isCurrentOutput(const RtpOutputLease &lease) const;
 
-    // Non-blocking event-loop-to-output-worker commands.
-    [[nodiscard]] RtpEnqueueResult enqueueReset(const RtpOutputLease &lease, AsyncAudioTraceContext traceContext = {});
+    // Non-blocking event-loop-to-output-worker commands. Only the event loop
+    // may call these: the queue has exactly one producer. The lease, buffer,
+    // hold and trace context (apart from enqueueFrame) are copied when the
+    // generation, buffer or hold changes, not for every frame.
+    [[nodiscard]] RtpEnqueueResult enqueueReset(const RtpOutputLease &lease,
+                                                const AsyncAudioTraceContext &traceContext = {});
     [[nodiscard]] RtpEnqueueResult enqueueSilentFrame(const RtpOutputLease &lease, size_t primingFrameIndex,
-                                                      AsyncAudioTraceContext traceContext = {});
+                                                      const AsyncAudioTraceContext &traceContext = {});
     [[nodiscard]] RtpEnqueueResult enqueueAudioFrame(const RtpOutputLease &lease,
-                                                     std::shared_ptr<AudioStreamBuffer> buffer, size_t frameIndex,
+                                                     const std::shared_ptr<AudioStreamBuffer> &buffer,
+                                                     size_t frameIndex, size_t skippedFrames = 0,
+                                                     bool releaseAfterSend = false,
+                                                     const std::shared_ptr<void> &releaseAfterSendHold = nullptr,
+                                                     const AsyncAudioTraceContext &traceContext = {});
+
+    /**
+     * Queue the mixer's next frame set. The worker mixes and encodes it when
+     * it's sent, so whatever tracks the mixer has then are what goes out.
+     *
+     * @param frameIndex frames since the mix started; 0 starts the mixer's encoders over
+     */
+    [[nodiscard]] RtpEnqueueResult enqueueMixedFrame(const RtpOutputLease &lease,
+                                                     const std::shared_ptr<RtpMixer> &mixer, size_t frameIndex,
                                                      size_t skippedFrames = 0, bool releaseAfterSend = false,
-                                                     std::shared_ptr<void> releaseAfterSendHold = nullptr,
-                                                     AsyncAudioTraceContext traceContext = {});
+                                                     const AsyncAudioTraceContext &traceContext = {});
 
     [[nodiscard]] bool isReady() const { return isServerReady_.load(); }
     [[nodiscard]] size_t getPendingCommandCount() const { return outputQueue_.size(); }
     [[nodiscard]] size_t getOutputQueueCapacity() const { return outputQueue_.capacity(); }
 
+    /**
+     * How many event loop frames early producers should queue frame sets.
+     *
+     * Zero unless the output is paced, in which case the worker holds each
+     * frame set until its deadline and the lead is what keeps a late event
+     * loop tick from making it miss.
+     */
+    [[nodiscard]] uint64_t getEnqueueLeadFrames() const {
+        return pacing_.paced ? pacing_.leadMs / EVENT_LOOP_PERIOD_MS : 0;
+    }
+
     /**
      * Did the send-failure circuit breaker terminate this generation?
      *
@@ -99,63 +146,91 @@ class MultiOpusRtpServer {
         Reset,
         SilentFrame,
         AudioFrame,
+        MixedFrame,
     };
 
+    // Plain bytes, so queueing one is a copy. Everything else is in the stream table.
     struct OutputCommand {
-        OutputCommandType type;
-        RtpOutputLease lease;
-        std::shared_ptr<AudioStreamBuffer> buffer;
+        OutputCommandType type{OutputCommandType::Reset};
+        RtpStreamTable::Handle stream;
+        RtpStreamTable::Handle retire; // the stream before this one, which nothing queued after us uses
         size_t frameIndex{0};
         size_t skippedFrames{0};
+        uint64_t enqueueFrame{0};
         bool releaseAfterSend{false};
-        std::shared_ptr<void> releaseAfterSendHold;
-        AsyncAudioTraceContext traceContext;
+    };
+
+    // The stream the event loop's last command used, so the next one can use it too
+    struct ProducerStream {
+        RtpStreamTable::Handle handle;
+        uint64_t generation{0};
+        const AudioStreamBuffer *buffer{nullptr};
+        const void *releaseAfterSendHold{nullptr};
+        const RtpMixer *mixer{nullptr};
     };
 
     struct OutputResult {
-        rtp_error_t error{RTP_OK};
+        int error{0}; // see RtpFrameSetResult
         uint8_t firstFailedChannel{0};
         uint32_t timestamp{0};
         RtcpSender::SentOctets sentOctets{};
     };
 
+    [[nodiscard]] RtpEnqueueResult enqueue(OutputCommand command, const RtpOutputLease &lease,
+                                           const std::shared_ptr<AudioStreamBuffer> &buffer,
+                                           const std::shared_ptr<void> &releaseAfterSendHold,
+                                           const std::shared_ptr<RtpMixer> &mixer,
+                                           const AsyncAudioTraceContext &traceContext);
     void runOutputWorker();
+    void applyRealtimePriority() const;
+    void waitForDeadline(const OutputCommand &command, const RtpStream &stream);
+    void closeStaleStreams();
     void processOutputCommand(const OutputCommand &command);
-    void handleSendOutcome(const OutputCommand &command, const OutputResult *result,
+    void handleSendOutcome(const OutputCommand &command, const RtpStream &stream, const OutputResult *result,
                            const std::exception *exception) noexcept;
-    void handleCommandException(const OutputCommand &command, const std::exception &exception) noexcept;
-    void recordOutputFailure(const OutputCommand &command, const OutputResult &result,
+    void handleCommandException(const OutputCommand &command, const RtpStream &stream,
+                                const std::exception &exception) noexcept;
+    void recordOutputFailure(const OutputCommand &command, const RtpStream &stream, const OutputResult &result,
                              const RtpSendFailureTracker::Action &action) noexcept;
-    void recordOutputException(const OutputCommand &command, const std::exception &exception,
+    void recordOutputException(const OutputCommand &command, const RtpStream &stream, const std::exception &exception,
                                const RtpSendFailureTracker::Action &action) noexcept;
-    void tripCircuitBreaker(const OutputCommand &command, const OutputResult *result, const std::exception *exception,
-                            const RtpSendFailureTracker::Action &action, const char *reason) noexcept;
+    void tripCircuitBreaker(const OutputCommand &command, const RtpStream &stream, const OutputResult *result,
+                            const std::exception *exception, const RtpSendFailureTracker::Action &action,
+                            const char *reason) noexcept;
     void releaseGeneration(const RtpOutputLease &lease) noexcept;
+    [[nodiscard]] static AsyncAudioTraceContext traceContextFor(const OutputCommand &command,
+                                                                const RtpStream &stream);
     static void applyTraceContextAttributes(const std::shared_ptr<creatures::OperationSpan> &span,
                                             const AsyncAudioTraceContext &traceContext);
     [[nodiscard]] static const char *commandTypeName(OutputCommandType type);
     void rotateSynchronizationSourceIdentifiers(uint64_t generation, const std::string &ownerId,
                                                 const AsyncAudioTraceContext &traceContext);
     [[nodiscard]] RtpClockMapping resetFrameTimestamp();
-    rtp_error_t send(uint8_t channelIndex, const std::vector<uint8_t> &opusEncodedFrame, uint32_t timestamp);
+    OutputResult sendFrameSet(const RtpTransport::FrameSet &frames);
     OutputResult sendSilentFrameSet(size_t primingFrameIndex);
     OutputResult sendAudioFrameSet(const AudioStreamBuffer &buffer, size_t frameIndex);
+    OutputResult sendMixedFrameSet(RtpMixer &mixer, bool newStream, size_t skippedFrames);
 
+    const RtpPacingOptions pacing_;
+    const std::vector<int> outputCpus_;
     std::atomic<bool> isServerReady_{false};
     uint32_t nextSynchronizationSourceIdentifier_{1000}; // Start from a round number for easy debugging
     uint32_t currentSynchronizationSourceIdentifier_{0}; // Track current SSRC for logging
     RtpFrameClock frameClock_;
+    RtpPacer pacer_; // output worker only, once it's running
+    RtpSilenceGate silenceGate_; // output worker only, once it's running
     RtcpSender rtcpSender_;
     std::atomic<uint64_t> readyGeneration_{0};
     RtpOutputCoordinator outputCoordinator_;
-    BoundedCommandQueue<OutputCommand> outputQueue_{OUTPUT_QUEUE_CAPACITY};
+    RtpCommandRing<OutputCommand> outputQueue_{OUTPUT_QUEUE_CAPACITY};
+    RtpStreamTable streams_;
+    ProducerStream producerStream_;        // event loop only
+    bool closeStaleStreamsPending_{false}; // worker-thread only
     RtpSendFailureTracker failureTracker_; // worker-thread only
     RtpTerminalFailureRegistry terminalFailures_;
     std::thread outputThread_;
 
-    uvgrtp::context rtpContext_;
-    std::array<uvgrtp::session *, RTP_STREAMING_CHANNELS> rtpSessions_{};
-    std::array<uvgrtp::media_stream *, RTP_STREAMING_CHANNELS> mediaStreams_{};
+    std::unique_ptr<RtpTransport> transport_; // output worker only, once it's running
 
     // Each successive packet advances Opus encoder state. AudioStreamBuffer
     // applies the same silence pre-roll before encoding program frame zero.
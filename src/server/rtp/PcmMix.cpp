@@ -0,0 +1,88 @@
+#include "server/rtp/PcmMix.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__x86_64__)
+#include <emmintrin.h>
+#define CREATURES_PCM_MIX_SSE2 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define CREATURES_PCM_MIX_NEON 1
+#endif
+
+namespace creatures::rtp {
+
+int16_t toMixGain(float linearGain) {
+    if (!std::isfinite(linearGain) || linearGain <= 0.0F) {
+        return 0;
+    }
+    const float scaled = std::round(linearGain * static_cast<float>(PCM_MIX_UNITY_GAIN));
+    return static_cast<int16_t>(std::min(scaled, static_cast<float>(std::numeric_limits<int16_t>::max())));
+}
+
+void accumulateScaled(int32_t *bus, const int16_t *samples, std::size_t count, int16_t gain) {
+    std::size_t i = 0;
+
+#if defined(CREATURES_PCM_MIX_SSE2)
+    // mullo/mulhi give the low and high halves of each 16x16 product;
+    // interleaving them puts the whole 32-bit products back together
+    const __m128i gains = _mm_set1_epi16(gain);
+    for (; i + 8 <= count; i += 8) {
+        const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(samples + i));
+        const __m128i low = _mm_mullo_epi16(in, gains);
+        const __m128i high = _mm_mulhi_epi16(in, gains);
+        const __m128i first = _mm_srai_epi32(_mm_unpacklo_epi16(low, high), PCM_MIX_GAIN_SHIFT);
+        const __m128i second = _mm_srai_epi32(_mm_unpackhi_epi16(low, high), PCM_MIX_GAIN_SHIFT);
+        auto *out = reinterpret_cast<__m128i *>(bus + i);
+        _mm_storeu_si128(out, _mm_add_epi32(_mm_loadu_si128(out), first));
+        _mm_storeu_si128(out + 1, _mm_add_epi32(_mm_loadu_si128(out + 1), second));
+    }
+#elif defined(CREATURES_PCM_MIX_NEON)
+    const int16x4_t gains = vdup_n_s16(gain);
+    for (; i + 8 <= count; i += 8) {
+        const int16x8_t in = vld1q_s16(samples + i);
+        const int32x4_t first = vshrq_n_s32(vmull_s16(vget_low_s16(in), gains), PCM_MIX_GAIN_SHIFT);
+        const int32x4_t second = vshrq_n_s32(vmull_s16(vget_high_s16(in), gains), PCM_MIX_GAIN_SHIFT);
+        vst1q_s32(bus + i, vaddq_s32(vld1q_s32(bus + i), first));
+        vst1q_s32(bus + i + 4, vaddq_s32(vld1q_s32(bus + i + 4), second));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        bus[i] += (static_cast<int32_t>(samples[i]) * gain) >> PCM_MIX_GAIN_SHIFT;
+    }
+}
+
+int32_t peakMagnitude(const int32_t *bus, std::size_t count) {
+    // A bus sample is at most a few hundred thousand, so negating one can't overflow
+    int32_t peak = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        peak = std::max(peak, bus[i] < 0 ? -bus[i] : bus[i]);
+    }
+    return peak;
+}
+
+void saturateToInt16(const int32_t *bus, int16_t *out, std::size_t count) {
+    std::size_t i = 0;
+
+#if defined(CREATURES_PCM_MIX_SSE2)
+    for (; i + 8 <= count; i += 8) {
+        const __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bus + i));
+        const __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bus + i + 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_packs_epi32(first, second));
+    }
+#elif defined(CREATURES_PCM_MIX_NEON)
+    for (; i + 8 <= count; i += 8) {
+        vst1q_s16(out + i, vcombine_s16(vqmovn_s32(vld1q_s32(bus + i)), vqmovn_s32(vld1q_s32(bus + i + 4))));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        out[i] = static_cast<int16_t>(std::clamp(bus[i], static_cast<int32_t>(std::numeric_limits<int16_t>::min()),
+                                                 static_cast<int32_t>(std::numeric_limits<int16_t>::max())));
+    }
+}
+
+} // namespace creatures::rtp
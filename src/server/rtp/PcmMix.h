@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace creatures::rtp {
+
+/**
+ * The RTP mixer's inner loops, on a 32-bit bus
+ *
+ * Gains are fixed point with PCM_MIX_GAIN_SHIFT fractional bits, so unity is
+ * 4096 and the loudest a track can be turned up is just under 8x (+18 dB).
+ * Each product fits in 32 bits and a bus sample is the sum of a handful of
+ * them, so nothing clips until the bus is brought back down to int16.
+ *
+ * SSE2 on x86-64 and NEON on 64-bit ARM (both always there), a plain loop
+ * anywhere else. All three give bit-identical results.
+ */
+inline constexpr int PCM_MIX_GAIN_SHIFT = 12;
+inline constexpr int32_t PCM_MIX_UNITY_GAIN = 1 << PCM_MIX_GAIN_SHIFT;
+
+/** A linear gain as a mix gain, clamped to what fits */
+[[nodiscard]] int16_t toMixGain(float linearGain);
+
+/** bus[i] += (samples[i] * gain) >> PCM_MIX_GAIN_SHIFT */
+void accumulateScaled(int32_t *bus, const int16_t *samples, std::size_t count, int16_t gain);
+
+/** The largest |bus[i]| */
+[[nodiscard]] int32_t peakMagnitude(const int32_t *bus, std::size_t count);
+
+/** out[i] = bus[i], saturated to int16 */
+void saturateToInt16(const int32_t *bus, int16_t *out, std::size_t count);
+
+} // namespace creatures::rtp
@@ -54,6 +54,14 @@ RtpWallClockTimestamp RtpClockMapping::at(MonotonicClock::time_point monotonicTi
     };
 }
 
+RtpClockMapping::MonotonicClock::time_point RtpClockMapping::monotonicAt(uint32_t rtpTimestamp) const {
+    // Unsigned subtraction, so this is right across the 32-bit wrap
+    const uint64_t samples = rtpTimestamp - rtpEpoch_;
+    const auto elapsed =
+        std::chrono::nanoseconds(static_cast<int64_t>(samples * NANOSECONDS_PER_SECOND / sampleRate_));
+    return monotonicEpoch_ + std::chrono::duration_cast<MonotonicClock::duration>(elapsed);
+}
+
 uint64_t wallClockToNtp(RtpClockMapping::WallClock::time_point wallTime) {
     const auto sinceUnixEpoch = std::chrono::duration_cast<std::chrono::nanoseconds>(wallTime.time_since_epoch());
     auto wholeSeconds = std::chrono::duration_cast<std::chrono::seconds>(sinceUnixEpoch);
@@ -28,6 +28,9 @@ class RtpClockMapping {
 
     [[nodiscard]] static RtpClockMapping capture(uint32_t sampleRate);
     [[nodiscard]] RtpWallClockTimestamp at(MonotonicClock::time_point monotonicTime) const;
+
+    /** When the sample stamped rtpTimestamp is due: the inverse of at(), for timestamps at or after rtpEpoch() */
+    [[nodiscard]] MonotonicClock::time_point monotonicAt(uint32_t rtpTimestamp) const;
     [[nodiscard]] uint32_t rtpEpoch() const { return rtpEpoch_; }
 
   private:
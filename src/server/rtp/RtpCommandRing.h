@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "util/SpscRing.h"
+
+namespace creatures::rtp {
+
+/** Why RtpCommandRing::waitPop() returned */
+enum class RtpCommandWait {
+    Command, // there's a command to run
+    Woken,   // somebody called wake(); nothing was popped
+    Stopped, // the ring is shut down; whatever was queued has been thrown away
+};
+
+/**
+ * The event loop's queue of work for the RTP output worker.
+ *
+ * Exactly one thread (the event loop) pushes and exactly one thread (the
+ * worker) pops. Commands are copied into a fixed ring, so a push never
+ * allocates, locks or blocks; a full ring rejects the command and the caller
+ * decides what that means.
+ *
+ * When there's nothing to do the worker sleeps on an atomic counter, which is
+ * a futex on Linux. A push only makes the wake-up call if the worker is
+ * actually asleep, so at 100 frame sets a second the event loop usually doesn't
+ * go into the kernel at all.
+ *
+ * wake() and stop() can be called from any thread. wake() gets the worker out
+ * of waitPop() without giving it a command, for when something it keeps track
+ * of has changed under it.
+ */
+template <typename Command> class RtpCommandRing {
+    static_assert(std::is_trivially_copyable_v<Command>, "ring commands are copied around as plain bytes");
+
+  public:
+    explicit RtpCommandRing(size_t capacity) : ring_(capacity) {}
+
+    RtpCommandRing(const RtpCommandRing &) = delete;
+    RtpCommandRing &operator=(const RtpCommandRing &) = delete;
+
+    /** Producer only. False if the ring is full or stopped. */
+    [[nodiscard]] bool tryPush(const Command &command) {
+        if (stopped_.load(std::memory_order_acquire) || !ring_.tryPush(command)) {
+            return false;
+        }
+        signal();
+        return true;
+    }
+
+    /** Producer only. If this is false the next tryPush() will succeed, unless the ring's stopped. */
+    [[nodiscard]] bool full() const { return ring_.size() >= ring_.capacity(); }
+
+    /** Consumer only. Blocks until there's a command, a wake() or a stop(). */
+    [[nodiscard]] RtpCommandWait waitPop(Command &command) {
+        while (true) {
+            if (stopped_.load(std::memory_order_acquire)) {
+                while (ring_.tryPop(command)) {
+                }
+                return RtpCommandWait::Stopped;
+            }
+            if (ring_.tryPop(command)) {
+                return RtpCommandWait::Command;
+            }
+            if (woken_.exchange(false, std::memory_order_acq_rel)) {
+                return RtpCommandWait::Woken;
+            }
+
+            // Take the counter before the last look, and tell producers we're
+            // going to sleep. Either they see sleeping_ and notify, or their
+            // bump of signals_ lands before wait() reads it and it returns
+            // straight away. All seq_cst, so one of the two has to happen.
+            const uint32_t observed = signals_.load(std::memory_order_seq_cst);
+            sleeping_.store(true, std::memory_order_seq_cst);
+            if (!stopped_.load(std::memory_order_seq_cst) && ring_.empty() &&
+                !woken_.load(std::memory_order_seq_cst)) {
+                signals_.wait(observed, std::memory_order_seq_cst);
+            }
+            sleeping_.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    /** Any thread. The worker's next waitPop() returns Woken if there's no command first. */
+    void wake() {
+        woken_.store(true, std::memory_order_release);
+        signal();
+    }
+
+    /** Any thread. Producers are turned away from now on and the worker stops. */
+    void stop() {
+        stopped_.store(true, std::memory_order_release);
+        signal();
+    }
+
+    [[nodiscard]] size_t size() const { return ring_.size(); }
+
+    [[nodiscard]] size_t capacity() const { return ring_.capacity(); }
+
+  private:
+    void signal() {
+        signals_.fetch_add(1, std::memory_order_seq_cst);
+        if (sleeping_.load(std::memory_order_seq_cst)) {
+            signals_.notify_one();
+        }
+    }
+
+    SpscRing<Command> ring_;
+
+    // 32 bits so std::atomic::wait() can be a plain futex
+    std::atomic<uint32_t> signals_{0};
+    std::atomic<bool> sleeping_{false};
+    std::atomic<bool> woken_{false};
+    std::atomic<bool> stopped_{false};
+};
+
+} // namespace creatures::rtp
@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <thread>
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+#include "server/audio/MonoWavDownmixer.h"
+#include "server/rtp/RtpMixSource.h"
+#include "util/threadName.h"
+
+#include "server/namespace-stuffs.h"
+
+namespace creatures::rtp {
+
+RtpMixSource::RtpMixSource(uint16_t channels, size_t capacityFrames)
+    : channels_(channels), capacityFrames_(std::max<size_t>(capacityFrames, 1)),
+      frameSamples_(static_cast<size_t>(channels) * RTP_SAMPLES), storage_(capacityFrames_ * frameSamples_) {}
+
+size_t RtpMixSource::write(std::span<const int16_t> interleaved) {
+    const size_t sampleFrames = interleaved.size() / channels_;
+    size_t taken = 0;
+    while (taken < sampleFrames) {
+        const uint64_t written = written_.load(std::memory_order_relaxed);
+        if (written - read_.load(std::memory_order_acquire) >= capacityFrames_) {
+            break;
+        }
+
+        // Deinterleave into the frame being written, channel by channel
+        int16_t *frame = slot(written);
+        const size_t count = std::min(sampleFrames - taken, RTP_SAMPLES - partialSamples_);
+        const int16_t *in = interleaved.data() + taken * channels_;
+        for (uint16_t channel = 0; channel < channels_; ++channel) {
+            int16_t *out = frame + static_cast<size_t>(channel) * RTP_SAMPLES + partialSamples_;
+            for (size_t i = 0; i < count; ++i) {
+                out[i] = in[i * channels_ + channel];
+            }
+        }
+        taken += count;
+        partialSamples_ += count;
+
+        if (partialSamples_ == RTP_SAMPLES) {
+            partialSamples_ = 0;
+            written_.store(written + 1, std::memory_order_release);
+        }
+    }
+    return taken;
+}
+
+bool RtpMixSource::full() const {
+    return written_.load(std::memory_order_relaxed) - read_.load(std::memory_order_acquire) >= capacityFrames_;
+}
+
+void RtpMixSource::finish() {
+    if (partialSamples_ > 0) {
+        // A frame's only started once there's room for it, so there's room to publish it
+        const uint64_t written = written_.load(std::memory_order_relaxed);
+        int16_t *frame = slot(written);
+        for (uint16_t channel = 0; channel < channels_; ++channel) {
+            int16_t *out = frame + static_cast<size_t>(channel) * RTP_SAMPLES;
+            std::fill(out + partialSamples_, out + RTP_SAMPLES, int16_t{0});
+        }
+        partialSamples_ = 0;
+        written_.store(written + 1, std::memory_order_release);
+    }
+    finished_.store(true, std::memory_order_release);
+}
+
+RtpMixSource::Read RtpMixSource::read(std::span<int16_t> planar) {
+    // finished_ first: everything written before it was set is visible once it's seen
+    const bool finished = finished_.load(std::memory_order_acquire);
+    const uint64_t read = read_.load(std::memory_order_relaxed);
+    if (read == written_.load(std::memory_order_acquire)) {
+        return finished ? Read::Finished : Read::Underrun;
+    }
+
+    const int16_t *frame = slot(read);
+    std::copy_n(frame, std::min(frameSamples_, planar.size()), planar.begin());
+    read_.store(read + 1, std::memory_order_release);
+    return Read::Frame;
+}
+
+bool RtpMixSource::isDrained() const {
+    if (isCancelled()) {
+        return true;
+    }
+    return finished_.load(std::memory_order_acquire) &&
+           read_.load(std::memory_order_acquire) == written_.load(std::memory_order_acquire);
+}
+
+Result<std::shared_ptr<RtpMixSource>> openWavMixSource(const std::string &filePath) {
+    auto opened = audio::MonoWavStream::open(filePath);
+    if (!opened.isSuccess()) {
+        return Result<std::shared_ptr<RtpMixSource>>{opened.getError().value()};
+    }
+    std::shared_ptr<audio::MonoWavStream> stream = opened.getValue().value();
+    if (stream->sampleRate() != RTP_SRATE) {
+        return Result<std::shared_ptr<RtpMixSource>>{
+            ServerError(ServerError::InvalidData, fmt::format("Mixed RTP tracks must be {}Hz; {} is {}Hz", RTP_SRATE,
+                                                              filePath, stream->sampleRate()))};
+    }
+    if (stream->channels() != 1 && stream->channels() != RTP_STREAMING_CHANNELS) {
+        return Result<std::shared_ptr<RtpMixSource>>{ServerError(
+            ServerError::InvalidData, fmt::format("Mixed RTP tracks must be mono or {} channels; {} has {}",
+                                                  RTP_STREAMING_CHANNELS, filePath, stream->channels()))};
+    }
+
+    auto source = std::make_shared<RtpMixSource>(stream->channels());
+    try {
+        std::thread feeder([source, stream, name = std::filesystem::path(filePath).filename().string()] {
+            setThreadName("RtpMixFeeder");
+            std::vector<int16_t> chunk(static_cast<size_t>(RTP_SAMPLES) * source->channels());
+            try {
+                while (!source->isCancelled()) {
+                    auto readResult = stream->readInterleavedFrames(chunk);
+                    if (!readResult.isSuccess()) {
+                        warn("Stopped reading mixed RTP track {}: {}", name, readResult.getError()->getMessage());
+                        break;
+                    }
+                    const size_t frames = readResult.getValue().value();
+                    if (frames == 0) {
+                        break;
+                    }
+
+                    std::span<const int16_t> pending(chunk.data(), frames * source->channels());
+                    while (!pending.empty() && !source->isCancelled()) {
+                        const size_t taken = source->write(pending);
+                        pending = pending.subspan(taken * source->channels());
+                        if (!pending.empty()) {
+                            std::this_thread::sleep_for(std::chrono::milliseconds(RTP_FRAME_MS));
+                        }
+                    }
+                }
+            } catch (const std::exception &exception) {
+                warn("Stopped reading mixed RTP track {}: {}", name, exception.what());
+            }
+            source->finish();
+        });
+        feeder.detach();
+    } catch (const std::exception &exception) {
+        return Result<std::shared_ptr<RtpMixSource>>{ServerError(
+            ServerError::InternalError, fmt::format("Unable to start reading {}: {}", filePath, exception.what()))};
+    }
+    return Result<std::shared_ptr<RtpMixSource>>{source};
+}
+
+} // namespace creatures::rtp
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "server/config.h"
+#include "util/Result.h"
+
+namespace creatures::rtp {
+
+/**
+ * PCM for one of the RTP mixer's tracks, a 10ms frame at a time.
+ *
+ * A single-producer, single-consumer ring of frames. Whatever's reading the
+ * sound (a WAV feeder thread, see openWavMixSource()) writes interleaved
+ * samples in; the RTP output worker, mixing, reads one frame per frame set.
+ * Each frame is stored channel by channel, so the mixer can add a channel's
+ * RTP_SAMPLES straight onto its bus.
+ *
+ * Neither side blocks. A full ring takes nothing, and an empty one reads as an
+ * underrun until the producer catches up or says it's finished.
+ */
+class RtpMixSource {
+  public:
+    enum class Read {
+        Frame,    // the next frame's in the output
+        Underrun, // nothing ready yet; the producer's behind
+        Finished, // nothing left, ever
+    };
+
+    /**
+     * @param channels 1 (a mono sound) or RTP_STREAMING_CHANNELS (a workshop WAV, one lane per channel)
+     * @param capacityFrames how many 10ms frames the ring holds
+     */
+    explicit RtpMixSource(uint16_t channels, size_t capacityFrames = RTP_MIXER_SOURCE_BUFFER_FRAMES);
+
+    RtpMixSource(const RtpMixSource &) = delete;
+    RtpMixSource &operator=(const RtpMixSource &) = delete;
+
+    [[nodiscard]] uint16_t channels() const { return channels_; }
+
+    // Producer side
+
+    /**
+     * Take as many interleaved sample frames as there's room for.
+     *
+     * @return how many sample frames (not samples) were taken
+     */
+    size_t write(std::span<const int16_t> interleaved);
+
+    /** Is there no room for another sample frame right now? */
+    [[nodiscard]] bool full() const;
+
+    /** No more audio is coming. Pads out a partly written frame with silence. */
+    void finish();
+
+    /** Has the reader given up on this source? */
+    [[nodiscard]] bool isCancelled() const { return cancelled_.load(std::memory_order_acquire); }
+
+    // Consumer side
+
+    /**
+     * Take the next frame.
+     *
+     * @param planar room for channels() * RTP_SAMPLES samples, filled channel by channel
+     */
+    Read read(std::span<int16_t> planar);
+
+    /** Stop wanting audio; the producer should stop writing, and the mixer drops the track */
+    void cancel() { cancelled_.store(true, std::memory_order_release); }
+
+    /** Has the last frame of a finished source been read (or has it been cancelled)? Any thread. */
+    [[nodiscard]] bool isDrained() const;
+
+  private:
+    [[nodiscard]] int16_t *slot(uint64_t frame) {
+        return storage_.data() + (frame % capacityFrames_) * frameSamples_;
+    }
+
+    const uint16_t channels_;
+    const size_t capacityFrames_;
+    const size_t frameSamples_; // channels_ * RTP_SAMPLES
+    std::vector<int16_t> storage_;
+
+    std::atomic<uint64_t> written_{0}; // frames the producer has published
+    std::atomic<uint64_t> read_{0};    // frames the consumer has taken
+    std::atomic<bool> finished_{false};
+    std::atomic<bool> cancelled_{false};
+    size_t partialSamples_{0}; // producer only: samples per channel already in the frame being written
+};
+
+/**
+ * Open a WAV file as a mix source, fed by a background thread.
+ *
+ * The WAV has to be 48kHz 16-bit PCM and either mono or the workshop's
+ * 17-channel layout. The thread reads ahead of the mix by as much as the
+ * source holds, and stops at the end of the file, on a read error, or once
+ * the source is cancelled.
+ */
+Result<std::shared_ptr<RtpMixSource>> openWavMixSource(const std::string &filePath);
+
+} // namespace creatures::rtp
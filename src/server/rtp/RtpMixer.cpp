@@ -0,0 +1,276 @@
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "server/audio/NativeAudioConfig.h"
+#include "server/rtp/PcmMix.h"
+#include "server/rtp/RtpMixer.h"
+#include "server/rtp/opus/OpusPriming.h"
+
+#include "server/namespace-stuffs.h"
+
+namespace creatures::rtp {
+
+namespace {
+
+// How fast the limiter lets go once a peak has passed
+constexpr float LIMITER_RELEASE_DB_PER_SECOND = 60.0F;
+
+float dbToLinear(float db) { return std::pow(10.0F, db / 20.0F); }
+
+} // namespace
+
+RtpMixer::RtpMixer(Options options)
+    : options_(options), limiterCeiling_(32767.0F * dbToLinear(std::min(options.limiterCeilingDb, 0.0F))),
+      limiterRelease_(dbToLinear(LIMITER_RELEASE_DB_PER_SECOND * RTP_FRAME_MS / 1000.0F)),
+      sourceFrame_(static_cast<size_t>(RTP_STREAMING_CHANNELS) * RTP_SAMPLES) {
+    limiterGain_.fill(1.0F);
+    previousFrameSilent_.fill(true);
+    tracks_.reserve(RTP_MIXER_MAX_TRACKS);
+    encoders_.reserve(RTP_STREAMING_CHANNELS);
+    for (size_t channel = 0; channel < RTP_STREAMING_CHANNELS; ++channel) {
+        encoders_.emplace_back();
+    }
+}
+
+Result<RtpMixer::TrackId> RtpMixer::addTrack(std::shared_ptr<RtpMixSource> source, RtpMixTrackOptions options) {
+    if (!source) {
+        return Result<TrackId>{ServerError(ServerError::InvalidData, "A mixed RTP track needs a source")};
+    }
+    if (!std::isfinite(options.gainDb) || options.gainDb < audio::MIN_AUDIO_GAIN_DB ||
+        options.gainDb > audio::MAX_AUDIO_GAIN_DB) {
+        return Result<TrackId>{ServerError(ServerError::InvalidData,
+                                           fmt::format("Track gain must be between {} and {} dB",
+                                                       audio::MIN_AUDIO_GAIN_DB, audio::MAX_AUDIO_GAIN_DB))};
+    }
+    const uint8_t channel = options.channel.value_or(RTP_STREAMING_CHANNELS - 1);
+    if (channel >= RTP_STREAMING_CHANNELS) {
+        return Result<TrackId>{ServerError(
+            ServerError::InvalidData, fmt::format("There are only {} RTP channels", RTP_STREAMING_CHANNELS))};
+    }
+
+    std::lock_guard lock(pendingMutex_);
+    if (pending_.added.size() + tracksWithWorker_ >= RTP_MIXER_MAX_TRACKS) {
+        return Result<TrackId>{ServerError(
+            ServerError::Conflict, fmt::format("The RTP mixer is already playing {} tracks", RTP_MIXER_MAX_TRACKS))};
+    }
+    const TrackId trackId = nextTrackId_++;
+    pending_.added.push_back(
+        Track{trackId, std::move(source), options.role, dbToLinear(options.gainDb), channel, std::move(options.name)});
+    publishTrackCount();
+    hasPending_.store(true, std::memory_order_release);
+    return Result<TrackId>{trackId};
+}
+
+void RtpMixer::removeTrack(TrackId trackId) {
+    std::lock_guard lock(pendingMutex_);
+    auto &added = pending_.added;
+    const auto waiting = std::find_if(added.begin(), added.end(), [trackId](const Track &track) {
+        return track.id == trackId;
+    });
+    if (waiting != added.end()) {
+        dropTrack(*waiting);
+        added.erase(waiting);
+        publishTrackCount();
+        return;
+    }
+    pending_.removed.push_back(trackId);
+    hasPending_.store(true, std::memory_order_release);
+}
+
+/**
+ * The tracks stop counting straight away, even though the worker won't let
+ * go of them until its next frame set: whoever cleared the mix may well not
+ * be sending any more of them.
+ */
+void RtpMixer::clear() {
+    std::lock_guard lock(pendingMutex_);
+    for (auto &track : pending_.added) {
+        dropTrack(track);
+    }
+    pending_.added.clear();
+    pending_.removed.clear();
+    pending_.cleared = true;
+    tracksWithWorker_ = 0;
+    publishTrackCount();
+    hasPending_.store(true, std::memory_order_release);
+}
+
+/** Tell the track's reader to stop */
+void RtpMixer::dropTrack(Track &track) {
+    if (track.source) {
+        track.source->cancel();
+        track.source.reset();
+    }
+}
+
+/** With pendingMutex_ held */
+void RtpMixer::publishTrackCount() {
+    trackCount_.store(pending_.added.size() + tracksWithWorker_, std::memory_order_release);
+}
+
+/**
+ * Pick up what other threads have asked for, and tell them which tracks ran out.
+ *
+ * The worker only tries the lock: if a caller happens to be holding it, the
+ * changes wait for the next frame set rather than the worker waiting for them.
+ */
+void RtpMixer::applyPendingChanges() {
+    if (!hasPending_.load(std::memory_order_acquire) && finishedUnreported_ == 0) {
+        return;
+    }
+    std::unique_lock lock(pendingMutex_, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        return;
+    }
+
+    if (pending_.cleared) {
+        // Already uncounted, along with any of them that have finished since
+        for (auto &track : tracks_) {
+            dropTrack(track);
+        }
+        tracks_.clear();
+    } else {
+        tracksWithWorker_ -= std::min(finishedUnreported_, tracksWithWorker_);
+    }
+    finishedUnreported_ = 0;
+
+    for (const TrackId trackId : pending_.removed) {
+        const auto found = std::find_if(tracks_.begin(), tracks_.end(),
+                                        [trackId](const Track &track) { return track.id == trackId; });
+        if (found != tracks_.end()) {
+            dropTrack(*found);
+            tracks_.erase(found);
+            --tracksWithWorker_;
+        }
+    }
+    for (auto &track : pending_.added) {
+        debug("RTP mixer starting track {} ({})", track.id, track.name);
+        tracks_.push_back(std::move(track));
+        ++tracksWithWorker_;
+    }
+    pending_ = PendingChanges{};
+    publishTrackCount();
+    hasPending_.store(false, std::memory_order_release);
+}
+
+const RtpMixer::MixedFrame &RtpMixer::mixFrame(size_t skippedFrames) {
+    applyPendingChanges();
+
+    // Keep every track where it would have been if the skipped frames had gone out
+    for (size_t skipped = 0; skipped < skippedFrames; ++skipped) {
+        for (auto &track : tracks_) {
+            static_cast<void>(track.source->read(sourceFrame_));
+        }
+    }
+
+    const bool dialogPlaying = std::any_of(tracks_.begin(), tracks_.end(),
+                                           [](const Track &track) { return track.role == RtpMixRole::Dialog; });
+    updateDuck(dialogPlaying);
+    const float duckLinear = dbToLinear(currentDuckDb_);
+
+    for (auto &channelBus : bus_) {
+        channelBus.fill(0);
+    }
+    for (auto track = tracks_.begin(); track != tracks_.end();) {
+        // Whoever owns a source can cancel it (an animation that's stopped) to take it out straight away
+        const auto read =
+            track->source->isCancelled() ? RtpMixSource::Read::Finished : track->source->read(sourceFrame_);
+        if (read == RtpMixSource::Read::Finished) {
+            debug("RTP mixer finished track {} ({})", track->id, track->name);
+            dropTrack(*track);
+            track = tracks_.erase(track);
+            ++finishedUnreported_;
+            continue;
+        }
+        if (read == RtpMixSource::Read::Underrun) {
+            ++underruns_;
+            ++track;
+            continue;
+        }
+
+        const int16_t gain =
+            toMixGain(track->role == RtpMixRole::Bed ? track->gainLinear * duckLinear : track->gainLinear);
+        if (track->source->channels() == 1) {
+            accumulateScaled(bus_[track->channel].data(), sourceFrame_.data(), RTP_SAMPLES, gain);
+        } else {
+            for (size_t channel = 0; channel < RTP_STREAMING_CHANNELS; ++channel) {
+                accumulateScaled(bus_[channel].data(), sourceFrame_.data() + channel * RTP_SAMPLES, RTP_SAMPLES,
+                                 gain);
+            }
+        }
+        ++track;
+    }
+
+    for (size_t channel = 0; channel < RTP_STREAMING_CHANNELS; ++channel) {
+        limitAndSaturate(channel);
+    }
+
+    // So the count drops as soon as a track's done, not a frame set later
+    applyPendingChanges();
+    return mixed_;
+}
+
+const RtpTransport::FrameSet &RtpMixer::renderFrameSet(bool newStream, size_t skippedFrames) {
+    if (newStream) {
+        // Match the silence the decoders were just primed with, as AudioStreamBuffer does
+        for (auto &encoder : encoders_) {
+            encoder.reset();
+            static_cast<void>(opus::encodePrimingSequence(encoder));
+        }
+        previousFrameSilent_.fill(true);
+    }
+
+    const auto &mixed = mixFrame(skippedFrames);
+    for (size_t channel = 0; channel < RTP_STREAMING_CHANNELS; ++channel) {
+        encoded_[channel] = encoders_[channel].encode(mixed[channel].data());
+        frames_[channel] = encoded_[channel];
+    }
+    return frames_;
+}
+
+uint64_t RtpMixer::takeUnderruns() { return std::exchange(underruns_, 0); }
+
+/** Move the duck a frame's worth toward where it should be */
+void RtpMixer::updateDuck(bool dialogPlaying) {
+    const float duckDb = std::min(options_.duckDb, 0.0F);
+    if (dialogPlaying) {
+        const float step = duckDb * RTP_FRAME_MS / static_cast<float>(std::max<uint32_t>(options_.duckAttackMs, 1));
+        currentDuckDb_ = std::max(currentDuckDb_ + step, duckDb);
+    } else {
+        const float step = duckDb * RTP_FRAME_MS / static_cast<float>(std::max<uint32_t>(options_.duckReleaseMs, 1));
+        currentDuckDb_ = std::min(currentDuckDb_ - step, 0.0F);
+    }
+}
+
+/**
+ * Bring a channel's bus down to int16 without letting it clip.
+ *
+ * The limiter pulls in at once, far enough to put the frame's peak at the
+ * ceiling, and lets go gradually over the frames after. It only touches the
+ * samples when it's actually turning the channel down. The peak also says
+ * whether the channel's silent.
+ */
+void RtpMixer::limitAndSaturate(size_t channel) {
+    auto &channelBus = bus_[channel];
+    const int32_t busPeak = peakMagnitude(channelBus.data(), channelBus.size());
+    const bool silent = busPeak <= RTP_SILENCE_PEAK;
+    channelSilent_[channel] = silent && previousFrameSilent_[channel];
+    previousFrameSilent_[channel] = silent;
+
+    const auto peak = static_cast<float>(busPeak);
+    const float fits = peak > limiterCeiling_ ? limiterCeiling_ / peak : 1.0F;
+
+    float &gain = limiterGain_[channel];
+    gain = std::min({gain * limiterRelease_, fits, 1.0F});
+    if (gain < 1.0F) {
+        for (auto &sample : channelBus) {
+            sample = static_cast<int32_t>(std::lrint(static_cast<float>(sample) * gain));
+        }
+    }
+    saturateToInt16(channelBus.data(), mixed_[channel].data(), channelBus.size());
+}
+
+} // namespace creatures::rtp
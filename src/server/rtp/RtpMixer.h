@@ -0,0 +1,160 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "server/config.h"
+#include "server/rtp/RtpMixSource.h"
+#include "server/rtp/RtpTransport.h"
+#include "server/rtp/opus/OpusEncoderWrapper.h"
+#include "util/Result.h"
+
+namespace creatures::rtp {
+
+/** What a mixed track is, which decides how it's treated in the mix */
+enum class RtpMixRole {
+    Program, // plays as it is
+    Dialog,  // plays as it is, and ducks every Bed track while it's playing
+    Bed,     // music or ambience that makes way for dialog
+};
+
+struct RtpMixTrackOptions {
+    RtpMixRole role{RtpMixRole::Program};
+    float gainDb{0.0F};
+
+    /** Mono sources only: the channel (0-based) to play on. The BGM channel if unset. */
+    std::optional<uint8_t> channel;
+
+    std::string name; // for logs
+};
+
+/**
+ * Sums several sounds into the RTP output's 17 channels.
+ *
+ * Tracks are added and removed from any thread; the changes are picked up by
+ * the RTP output worker at the start of its next frame set. The worker mixes
+ * every track's next 10ms into a 32-bit bus per channel (see PcmMix.h),
+ * ducks Bed tracks while a Dialog track is playing, limits each channel to
+ * the ceiling, and encodes each channel once. A track whose source has
+ * nothing ready plays silence for that frame rather than holding up the rest.
+ *
+ * One mixer owns the output for as long as it has tracks, so there's one
+ * SSRC set and one encoder per channel no matter how many sounds are playing.
+ */
+class RtpMixer {
+  public:
+    using TrackId = uint64_t;
+    using ChannelFrame = std::array<int16_t, RTP_SAMPLES>;
+    using MixedFrame = std::array<ChannelFrame, RTP_STREAMING_CHANNELS>;
+
+    struct Options {
+        float duckDb{static_cast<float>(DEFAULT_RTP_MIXER_DUCK_DB)};
+        float limiterCeilingDb{static_cast<float>(DEFAULT_LIMITER_CEILING_DB)};
+        uint32_t duckAttackMs{RTP_MIXER_DUCK_ATTACK_MS};
+        uint32_t duckReleaseMs{RTP_MIXER_DUCK_RELEASE_MS};
+    };
+
+    explicit RtpMixer(Options options);
+
+    RtpMixer(const RtpMixer &) = delete;
+    RtpMixer &operator=(const RtpMixer &) = delete;
+
+    /**
+     * Start playing a source on its next frame set. Any thread.
+     *
+     * @return the track's id, Conflict if there are already RTP_MIXER_MAX_TRACKS,
+     *         or InvalidData if the options don't fit the source
+     */
+    Result<TrackId> addTrack(std::shared_ptr<RtpMixSource> source, RtpMixTrackOptions options);
+
+    /** Stop a track. Any thread; does nothing if it's already gone. */
+    void removeTrack(TrackId trackId);
+
+    /** Stop every track. Any thread. */
+    void clear();
+
+    /** Tracks playing or about to be. Any thread. */
+    [[nodiscard]] size_t getTrackCount() const { return trackCount_.load(std::memory_order_acquire); }
+
+    /**
+     * Mix and encode the next frame set. RTP output worker only.
+     *
+     * @param newStream the decoders have just been primed, so the encoders start over
+     * @param skippedFrames frames the output skipped before this one; each track skips them too
+     * @return one Opus packet per channel, good until the next call
+     */
+    const RtpTransport::FrameSet &renderFrameSet(bool newStream, size_t skippedFrames);
+
+    /** renderFrameSet() without the encoding. RTP output worker only. */
+    const MixedFrame &mixFrame(size_t skippedFrames);
+
+    /** Frames a track had nothing ready for since the last call. RTP output worker only. */
+    uint64_t takeUnderruns();
+
+    /** How far Bed tracks are ducked right now, in dB. RTP output worker only. */
+    [[nodiscard]] float getDuckDb() const { return currentDuckDb_; }
+
+    /**
+     * Were this frame and the one before it silent on a channel, as AudioStreamBuffer
+     * flags its frames? RTP output worker only.
+     */
+    [[nodiscard]] bool isChannelSilent(size_t channel) const { return channelSilent_[channel]; }
+
+  private:
+    struct Track {
+        TrackId id{0};
+        std::shared_ptr<RtpMixSource> source;
+        RtpMixRole role{RtpMixRole::Program};
+        float gainLinear{1.0F};
+        uint8_t channel{0}; // mono sources only
+        std::string name;
+    };
+
+    // Changes from other threads, waiting for the worker. Guarded by pendingMutex_.
+    struct PendingChanges {
+        std::vector<Track> added;
+        std::vector<TrackId> removed;
+        bool cleared{false};
+    };
+
+    void applyPendingChanges();
+    void publishTrackCount();
+    static void dropTrack(Track &track);
+    void updateDuck(bool dialogPlaying);
+    void limitAndSaturate(size_t channel);
+
+    const Options options_;
+    const float limiterCeiling_; // in sample units
+    const float limiterRelease_; // per-frame gain factor as the limiter lets go
+
+    mutable std::mutex pendingMutex_;
+    PendingChanges pending_;
+    size_t tracksWithWorker_{0}; // guarded by pendingMutex_: handed over and not reported finished or cleared
+    TrackId nextTrackId_{1};     // guarded by pendingMutex_
+    std::atomic<bool> hasPending_{false};
+    std::atomic<size_t> trackCount_{0}; // pending_.added plus tracksWithWorker_, for reading without the lock
+
+    // Output worker only
+    std::vector<Track> tracks_;
+    size_t finishedUnreported_{0}; // tracks that ran out since the worker last had the lock
+    float currentDuckDb_{0.0F};
+    uint64_t underruns_{0};
+    std::array<float, RTP_STREAMING_CHANNELS> limiterGain_{};
+    std::array<bool, RTP_STREAMING_CHANNELS> channelSilent_{};
+    std::array<bool, RTP_STREAMING_CHANNELS> previousFrameSilent_{};
+    std::vector<int16_t> sourceFrame_; // one frame of the widest source
+    std::array<std::array<int32_t, RTP_SAMPLES>, RTP_STREAMING_CHANNELS> bus_{};
+    MixedFrame mixed_{};
+    std::vector<opus::Encoder> encoders_;
+    std::array<std::vector<uint8_t>, RTP_STREAMING_CHANNELS> encoded_;
+    RtpTransport::FrameSet frames_{};
+};
+
+} // namespace creatures::rtp
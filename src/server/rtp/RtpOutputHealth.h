@@ -160,7 +160,7 @@ class RtpSendFailureTracker {
  */
 struct TerminalFailure {
     uint64_t generation{0};
-    int errorCode{0}; // rtp_error_t value, or 0 when the send threw instead
+    int errorCode{0}; // RtpFrameSetResult::error, or 0 when the send threw instead
     std::string errorMessage;
     uint8_t firstFailedChannel{0};
     uint32_t rtpTimestamp{0};
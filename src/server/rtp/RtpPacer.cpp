@@ -0,0 +1,60 @@
+#include "server/rtp/RtpPacer.h"
+
+#include <algorithm>
+
+#include "server/eventloop/sleep.h"
+
+namespace creatures::rtp {
+
+namespace {
+
+std::chrono::nanoseconds samplesToDuration(uint32_t samples) {
+    return std::chrono::nanoseconds(static_cast<int64_t>(uint64_t{samples} * 1'000'000'000ULL / RTP_SRATE));
+}
+
+} // namespace
+
+void RtpPacer::beginStream(const RtpClockMapping &clockMapping) {
+    clockMapping_ = clockMapping;
+    lastPackets_ = {};
+}
+
+std::optional<RtpPacer::Clock::time_point> RtpPacer::deadline(uint32_t rtpTimestamp) const {
+    if (!clockMapping_) {
+        return std::nullopt;
+    }
+    return clockMapping_->monotonicAt(rtpTimestamp);
+}
+
+std::chrono::nanoseconds RtpPacer::waitUntilDue(uint32_t rtpTimestamp) const {
+    const auto due = deadline(rtpTimestamp);
+    if (!due) {
+        return std::chrono::nanoseconds::zero();
+    }
+
+    // No spin: an absolute clock_nanosleep(), and whatever the scheduler adds
+    // after that is what the jitter histograms are there to show
+    hybridSleepUntil(*due, std::chrono::nanoseconds::zero());
+    return std::max(std::chrono::nanoseconds::zero(),
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - *due));
+}
+
+void RtpPacer::recordSent(uint32_t rtpTimestamp, const RtcpSender::SentOctets &sentOctets, Clock::time_point sentAt,
+                          ChannelJitter &jitter) {
+    for (size_t channelIndex = 0; channelIndex < RTP_STREAMING_CHANNELS; ++channelIndex) {
+        if (sentOctets[channelIndex] == 0) {
+            continue;
+        }
+
+        auto &last = lastPackets_[channelIndex];
+        if (last.valid) {
+            const auto spacing = sentAt - last.sentAt;
+            const auto expected = samplesToDuration(rtpTimestamp - last.rtpTimestamp);
+            const auto deviation = std::chrono::duration_cast<std::chrono::nanoseconds>(spacing - expected).count();
+            jitter[channelIndex].record(static_cast<uint64_t>(deviation < 0 ? -deviation : deviation));
+        }
+        last = LastPacket{sentAt, rtpTimestamp, true};
+    }
+}
+
+} // namespace creatures::rtp
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+#include "server/config.h"
+#include "server/rtp/RtcpSender.h"
+#include "server/rtp/RtpClockMapping.h"
+#include "util/LatencyHistogram.h"
+
+namespace creatures::rtp {
+
+/**
+ * Times frame sets off the stream's RTP clock instead of off the event loop.
+ *
+ * A stream's RtpClockMapping pins its first RTP timestamp to a moment on the
+ * monotonic clock, so the frame set stamped T is due (T - epoch) / 48kHz
+ * after that. waitUntilDue() sleeps to that deadline with an absolute
+ * clock_nanosleep(), so waking up late once doesn't make every later frame
+ * set late too.
+ *
+ * It also tracks how evenly each channel's packets went out: for consecutive
+ * packets on a channel, how far the time between sending them was from the
+ * time between their timestamps. That's the sending side of RFC 3550's
+ * interarrival jitter.
+ *
+ * Output worker only.
+ */
+class RtpPacer {
+  public:
+    using Clock = RtpClockMapping::MonotonicClock;
+    using ChannelJitter = std::array<LatencyHistogram, RTP_STREAMING_CHANNELS>;
+
+    /** Time frame sets against this stream's clock from now on */
+    void beginStream(const RtpClockMapping &clockMapping);
+
+    /** When the frame set stamped rtpTimestamp should go out, if there's a stream */
+    [[nodiscard]] std::optional<Clock::time_point> deadline(uint32_t rtpTimestamp) const;
+
+    /**
+     * Sleep until the frame set stamped rtpTimestamp is due
+     *
+     * @return how late it is now (zero if there's no stream)
+     */
+    std::chrono::nanoseconds waitUntilDue(uint32_t rtpTimestamp) const;
+
+    /**
+     * Note that a frame set went out, and record each channel's jitter (in ns)
+     *
+     * Channels that didn't send (sentOctets of 0) are skipped; their next
+     * packet is measured against the last one that did go out.
+     */
+    void recordSent(uint32_t rtpTimestamp, const RtcpSender::SentOctets &sentOctets, Clock::time_point sentAt,
+                    ChannelJitter &jitter);
+
+  private:
+    struct LastPacket {
+        Clock::time_point sentAt;
+        uint32_t rtpTimestamp{0};
+        bool valid{false};
+    };
+
+    std::optional<RtpClockMapping> clockMapping_;
+    std::array<LastPacket, RTP_STREAMING_CHANNELS> lastPackets_{};
+};
+
+} // namespace creatures::rtp
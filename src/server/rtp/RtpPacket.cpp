@@ -0,0 +1,33 @@
+#include "server/rtp/RtpPacket.h"
+
+#include <cstdint>
+#include <span>
+
+namespace creatures::rtp {
+namespace {
+
+constexpr uint8_t RTP_VERSION = 2;
+
+void writeU16(uint8_t *destination, uint16_t value) {
+    destination[0] = static_cast<uint8_t>(value >> 8U);
+    destination[1] = static_cast<uint8_t>(value);
+}
+
+void writeU32(uint8_t *destination, uint32_t value) {
+    destination[0] = static_cast<uint8_t>(value >> 24U);
+    destination[1] = static_cast<uint8_t>(value >> 16U);
+    destination[2] = static_cast<uint8_t>(value >> 8U);
+    destination[3] = static_cast<uint8_t>(value);
+}
+
+} // namespace
+
+void writeRtpHeader(std::span<uint8_t, RTP_HEADER_BYTES> header, const RtpHeaderData &data) {
+    header[0] = static_cast<uint8_t>(RTP_VERSION << 6U);
+    header[1] = static_cast<uint8_t>((data.marker ? 0x80U : 0U) | (data.payloadType & 0x7fU));
+    writeU16(header.data() + 2, data.sequenceNumber);
+    writeU32(header.data() + 4, data.timestamp);
+    writeU32(header.data() + 8, data.synchronizationSource);
+}
+
+} // namespace creatures::rtp
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace creatures::rtp {
+
+/** An RTP fixed header with no CSRCs or extension: all we ever send */
+inline constexpr std::size_t RTP_HEADER_BYTES = 12;
+
+struct RtpHeaderData {
+    uint8_t payloadType{0};
+    bool marker{false};
+    uint16_t sequenceNumber{0};
+    uint32_t timestamp{0};
+    uint32_t synchronizationSource{0};
+};
+
+/**
+ * Write an RFC 3550 fixed header (V=2, no padding, extension or CSRCs) in
+ * network byte order.
+ */
+void writeRtpHeader(std::span<uint8_t, RTP_HEADER_BYTES> header, const RtpHeaderData &data);
+
+} // namespace creatures::rtp
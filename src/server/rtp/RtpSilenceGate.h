@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "server/config.h"
+
+namespace creatures::rtp {
+
+/**
+ * Decides which channels' packets a frame set actually sends.
+ *
+ * A channel that's silent sends nothing, apart from one packet every
+ * keepaliveFrames silent frames so receivers can tell a quiet stream from a
+ * dead one. Anything that isn't silent always goes out. Output worker only.
+ */
+class RtpSilenceGate {
+  public:
+    explicit RtpSilenceGate(bool enabled, uint32_t keepaliveFrames = RTP_SILENCE_KEEPALIVE_FRAMES)
+        : enabled_(enabled), keepaliveFrames_(keepaliveFrames == 0 ? 1 : keepaliveFrames) {}
+
+    /** A new stream: nothing's been silent yet */
+    void reset() { silentFrames_.fill(0); }
+
+    /** @return true if the channel's packet for this frame set should be sent */
+    [[nodiscard]] bool admit(size_t channel, bool silent) {
+        if (!enabled_ || !silent) {
+            silentFrames_[channel] = 0;
+            return true;
+        }
+        return ++silentFrames_[channel] % keepaliveFrames_ == 0;
+    }
+
+    [[nodiscard]] bool isEnabled() const { return enabled_; }
+
+  private:
+    const bool enabled_;
+    const uint32_t keepaliveFrames_;
+    std::array<uint32_t, RTP_STREAMING_CHANNELS> silentFrames_{}; // in a row, per channel
+};
+
+} // namespace creatures::rtp
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+#include "server/rtp/AsyncAudioTraceContext.h"
+#include "server/rtp/RtpOutputCoordinator.h"
+
+namespace creatures::rtp {
+
+class AudioStreamBuffer;
+class RtpMixer;
+
+/**
+ * Everything the RTP output worker needs about a stream that doesn't change
+ * from one frame to the next
+ */
+struct RtpStream {
+    RtpOutputLease lease;
+    std::shared_ptr<AudioStreamBuffer> buffer; // null for resets and priming silence
+    std::shared_ptr<void> releaseAfterSendHold;
+    AsyncAudioTraceContext traceContext; // enqueueFrame is per command, not in here
+    std::shared_ptr<RtpMixer> mixer;     // mixed frames only
+};
+
+/**
+ * Fixed table of streams the event loop has handed to the RTP output worker.
+ *
+ * This is what lets RtpCommandRing's commands be plain bytes: a command names
+ * its stream with a Handle (a slot and that slot's version) instead of
+ * carrying shared_ptrs and strings itself. The event loop is the only thread
+ * that opens slots and the output worker is the only thread that closes them,
+ * so there are no locks and no reference counting per frame.
+ *
+ * Each slot's version is odd while it's open and even while it's free. Closing
+ * a slot bumps its version, so a handle to a closed (or since reopened) slot
+ * just doesn't resolve any more.
+ */
+class RtpStreamTable {
+  public:
+    static constexpr size_t SLOTS = 64;
+
+    struct Handle {
+        uint32_t slot{0};
+        uint32_t version{0}; // 0 never names an open slot
+    };
+
+    RtpStreamTable() = default;
+    RtpStreamTable(const RtpStreamTable &) = delete;
+    RtpStreamTable &operator=(const RtpStreamTable &) = delete;
+
+    /** Event loop only. Empty if every slot is in use. */
+    [[nodiscard]] std::optional<Handle> open(RtpStream stream) {
+        for (size_t i = 0; i < SLOTS; ++i) {
+            const size_t slotIndex = (nextSlot_ + i) % SLOTS;
+            auto &slot = slots_[slotIndex];
+            const uint32_t version = slot.version.load(std::memory_order_acquire);
+            if (version % 2 != 0) {
+                continue;
+            }
+            slot.stream = std::move(stream);
+            slot.version.store(version + 1, std::memory_order_release);
+            nextSlot_ = (slotIndex + 1) % SLOTS;
+            return Handle{static_cast<uint32_t>(slotIndex), version + 1};
+        }
+        return std::nullopt;
+    }
+
+    /** Event loop or output worker. Is the slot still holding the stream it was opened with? */
+    [[nodiscard]] bool isOpen(Handle handle) const {
+        return handle.slot < SLOTS && handle.version % 2 != 0 &&
+               slots_[handle.slot].version.load(std::memory_order_acquire) == handle.version;
+    }
+
+    /** Output worker only. Null if the stream's been closed since the handle was made. */
+    [[nodiscard]] const RtpStream *find(Handle handle) const {
+        return isOpen(handle) ? &slots_[handle.slot].stream : nullptr;
+    }
+
+    /** Output worker only. Lets go of the stream's buffer and hold; does nothing if it's already closed. */
+    void close(Handle handle) {
+        if (!isOpen(handle)) {
+            return;
+        }
+        auto &slot = slots_[handle.slot];
+        slot.stream = RtpStream{};
+        slot.version.store(handle.version + 1, std::memory_order_release);
+    }
+
+    /** Output worker only. Close every open stream the predicate picks, and say how many that was. */
+    template <typename Predicate> size_t closeIf(Predicate predicate) {
+        size_t closed = 0;
+        for (uint32_t slotIndex = 0; slotIndex < SLOTS; ++slotIndex) {
+            const Handle handle{slotIndex, slots_[slotIndex].version.load(std::memory_order_acquire)};
+            if (isOpen(handle) && predicate(slots_[slotIndex].stream)) {
+                close(handle);
+                ++closed;
+            }
+        }
+        return closed;
+    }
+
+    /** Approximate, for metrics */
+    [[nodiscard]] size_t openCount() const {
+        size_t count = 0;
+        for (const auto &slot : slots_) {
+            count += slot.version.load(std::memory_order_relaxed) % 2;
+        }
+        return count;
+    }
+
+  private:
+    struct Slot {
+        std::atomic<uint32_t> version{0};
+        RtpStream stream;
+    };
+
+    std::array<Slot, SLOTS> slots_;
+    size_t nextSlot_{0}; // event loop only; round robin so a just-closed slot isn't reused right away
+};
+
+} // namespace creatures::rtp
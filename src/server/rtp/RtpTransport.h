@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "server/config.h"
+#include "server/rtp/RtcpSender.h"
+
+namespace creatures::rtp {
+
+/**
+ * What happened to one frame set (a packet on every channel, all with the same timestamp)
+ */
+struct RtpFrameSetResult {
+    /**
+     * 0 if every channel went out. Otherwise the first failure: uvgRTP's
+     * rtp_error_t (negative) or the errno from sendmmsg() (positive).
+     */
+    int error{0};
+    uint8_t firstFailedChannel{0};
+
+    /** Payload bytes that made it to the kernel, by channel, for the RTCP Sender Reports */
+    RtcpSender::SentOctets sentOctets{};
+
+    /** Calls into the kernel it took to send the set */
+    uint32_t syscalls{0};
+};
+
+/**
+ * Puts MultiOpusRtpServer's Opus frames on the wire, one multicast group per channel.
+ *
+ * Only the RTP output worker calls these, so implementations don't lock.
+ * Sequence numbers belong to the transport; SSRCs and timestamps belong to
+ * MultiOpusRtpServer, which hands the same values to the RtcpSender.
+ */
+class RtpTransport {
+  public:
+    using SynchronizationSources = RtcpSender::SynchronizationSources;
+    using FrameSet = std::array<std::span<const uint8_t>, RTP_STREAMING_CHANNELS>;
+
+    virtual ~RtpTransport() = default;
+
+    /** Start new streams with these SSRCs. Throws if the transport can't. */
+    virtual void setSynchronizationSources(const SynchronizationSources &synchronizationSources) = 0;
+
+    /**
+     * Send one Opus packet on every channel, all stamped with the same RTP timestamp.
+     * A channel whose packet is empty sends nothing this time.
+     */
+    virtual RtpFrameSetResult sendFrameSet(const FrameSet &frames, uint32_t timestamp) = 0;
+
+    /** For logs */
+    [[nodiscard]] virtual const char *name() const = 0;
+};
+
+} // namespace creatures::rtp
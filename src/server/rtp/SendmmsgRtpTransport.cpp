@@ -0,0 +1,161 @@
+#include "server/rtp/SendmmsgRtpTransport.h"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <unistd.h>
+
+#include <fmt/format.h>
+
+#include "server/namespace-stuffs.h"
+
+namespace creatures::rtp {
+
+SendmmsgRtpTransport::SendmmsgRtpTransport() : SendmmsgRtpTransport(RTP_GROUPS, RTP_PORT, RTP_PORT) {}
+
+SendmmsgRtpTransport::SendmmsgRtpTransport(const Groups &groups, uint16_t destinationPort, uint16_t sourcePort) {
+    for (size_t channelIndex = 0; channelIndex < RTP_STREAMING_CHANNELS; ++channelIndex) {
+        auto &destination = destinations_[channelIndex];
+        destination.sin_family = AF_INET;
+        destination.sin_port = htons(destinationPort);
+        if (inet_pton(AF_INET, groups[channelIndex], &destination.sin_addr) != 1) {
+            throw std::invalid_argument(
+                fmt::format("'{}' isn't an IPv4 address (channel {})", groups[channelIndex], channelIndex));
+        }
+
+        vectors_[channelIndex][0].iov_base = headers_[channelIndex].data();
+        vectors_[channelIndex][0].iov_len = headers_[channelIndex].size();
+
+#if defined(__linux__)
+        auto &message = messages_[channelIndex].msg_hdr;
+#else
+        auto &message = messages_[channelIndex];
+#endif
+        message.msg_name = &destination;
+        message.msg_namelen = sizeof(destination);
+        message.msg_iov = vectors_[channelIndex].data();
+        message.msg_iovlen = vectors_[channelIndex].size();
+    }
+
+    socket_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (socket_ < 0) {
+        throw std::runtime_error(fmt::format("unable to create RTP socket: {}", std::strerror(errno)));
+    }
+
+    if (sourcePort != 0) {
+        // uvgRTP sends from RTP_PORT too, and Wireshark's RTP heuristics like it
+        const int reuseAddress = 1;
+        if (setsockopt(socket_, SOL_SOCKET, SO_REUSEADDR, &reuseAddress, sizeof(reuseAddress)) < 0) {
+            warn("Unable to set SO_REUSEADDR on the RTP socket: {}", std::strerror(errno));
+        }
+        sockaddr_in localAddress{};
+        localAddress.sin_family = AF_INET;
+        localAddress.sin_addr.s_addr = htonl(INADDR_ANY);
+        localAddress.sin_port = htons(sourcePort);
+        if (bind(socket_, reinterpret_cast<sockaddr *>(&localAddress), sizeof(localAddress)) < 0) {
+            warn("Unable to bind RTP source port {}: {}; sending from any port", sourcePort, std::strerror(errno));
+        }
+    }
+}
+
+SendmmsgRtpTransport::~SendmmsgRtpTransport() {
+    if (socket_ >= 0) {
+        close(socket_);
+        socket_ = -1;
+    }
+}
+
+void SendmmsgRtpTransport::setSynchronizationSources(const SynchronizationSources &synchronizationSources) {
+    synchronizationSources_ = synchronizationSources;
+
+    // A new SSRC is a new stream, so it gets a new random starting sequence number (RFC 3550 5.1)
+    std::random_device randomDevice;
+    std::uniform_int_distribution<uint32_t> distribution(0U, UINT16_MAX);
+    for (auto &sequenceNumber : sequenceNumbers_) {
+        sequenceNumber = static_cast<uint16_t>(distribution(randomDevice));
+    }
+    resuming_.fill(false);
+}
+
+RtpFrameSetResult SendmmsgRtpTransport::sendFrameSet(const FrameSet &frames, uint32_t timestamp) {
+    RtpFrameSetResult result;
+
+    // Only the channels with a packet this time go in the batch, in channel order
+    size_t batchSize = 0;
+    for (size_t channelIndex = 0; channelIndex < RTP_STREAMING_CHANNELS; ++channelIndex) {
+        if (frames[channelIndex].empty()) {
+            resuming_[channelIndex] = true;
+            continue;
+        }
+        writeRtpHeader(headers_[channelIndex], {
+                                                   .payloadType = RTP_OPUS_PAYLOAD_PT,
+                                                   .marker = resuming_[channelIndex],
+                                                   .sequenceNumber = sequenceNumbers_[channelIndex]++,
+                                                   .timestamp = timestamp,
+                                                   .synchronizationSource = synchronizationSources_[channelIndex],
+                                               });
+        resuming_[channelIndex] = false;
+        // iovec isn't const-correct; the kernel only reads from it
+        vectors_[channelIndex][1].iov_base = const_cast<uint8_t *>(frames[channelIndex].data());
+        vectors_[channelIndex][1].iov_len = frames[channelIndex].size();
+        batch_[batchSize] = messages_[channelIndex];
+        batchChannels_[batchSize] = static_cast<uint8_t>(channelIndex);
+        ++batchSize;
+    }
+
+    auto recordFailure = [&result](size_t channelIndex, int systemError) {
+        if (result.error == 0) {
+            result.error = systemError;
+            result.firstFailedChannel = static_cast<uint8_t>(channelIndex);
+        }
+    };
+
+#if defined(__linux__)
+
+    // sendmmsg stops at the first packet that fails. Count that channel as
+    // failed and carry on with the rest so one bad group can't silence the
+    // others.
+    size_t offset = 0;
+    while (offset < batchSize) {
+        const int sent = sendmmsg(socket_, batch_.data() + offset, static_cast<unsigned int>(batchSize - offset), 0);
+        ++result.syscalls;
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            recordFailure(batchChannels_[offset], errno);
+            ++offset;
+            continue;
+        }
+        for (size_t message = offset; message < offset + static_cast<size_t>(sent); ++message) {
+            const auto channelIndex = batchChannels_[message];
+            result.sentOctets[channelIndex] = static_cast<uint32_t>(frames[channelIndex].size());
+        }
+        offset += static_cast<size_t>(sent);
+    }
+
+#else
+
+    // No sendmmsg() here, so it's one at a time
+    for (size_t message = 0; message < batchSize; ++message) {
+        const auto channelIndex = batchChannels_[message];
+        ssize_t sent;
+        do {
+            sent = sendmsg(socket_, &batch_[message], 0);
+            ++result.syscalls;
+        } while (sent < 0 && errno == EINTR);
+        if (sent < 0) {
+            recordFailure(channelIndex, errno);
+        } else {
+            result.sentOctets[channelIndex] = static_cast<uint32_t>(frames[channelIndex].size());
+        }
+    }
+
+#endif
+
+    return result;
+}
+
+} // namespace creatures::rtp
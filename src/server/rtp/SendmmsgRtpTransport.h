@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include "server/config.h"
+#include "server/rtp/RtpPacket.h"
+#include "server/rtp/RtpTransport.h"
+
+namespace creatures::rtp {
+
+/**
+ * Every channel's packet for a frame set in one sendmmsg() call, from one socket
+ *
+ * The headers, iovecs, destinations and message headers for all the channels
+ * are set up once. Sending a frame set writes 12 header bytes per channel and
+ * points each message's second iovec at that channel's Opus packet, so the
+ * payloads aren't copied until the kernel does it. Where there's no
+ * sendmmsg() (anything but Linux) the same messages go out with one sendmsg()
+ * each.
+ *
+ * A channel with no packet in the set is left out of the call. Its sequence
+ * number doesn't move, and its next packet has the marker bit set, as the
+ * start of a talkspurt (RFC 3551 4.1).
+ */
+class SendmmsgRtpTransport : public RtpTransport {
+  public:
+    using Groups = std::array<const char *, RTP_STREAMING_CHANNELS>;
+
+    /** To RTP_GROUPS on RTP_PORT, from RTP_PORT (or any port, if that one's taken) */
+    SendmmsgRtpTransport();
+
+    /**
+     * @param groups where each channel goes (any IPv4 address will do, which is handy for tests)
+     * @param destinationPort the port every channel is sent to
+     * @param sourcePort the port to send from, or 0 to let the kernel pick
+     * @throws std::runtime_error if the socket can't be made, std::invalid_argument for a bad address
+     */
+    SendmmsgRtpTransport(const Groups &groups, uint16_t destinationPort, uint16_t sourcePort);
+    ~SendmmsgRtpTransport() override;
+
+    SendmmsgRtpTransport(const SendmmsgRtpTransport &) = delete;
+    SendmmsgRtpTransport &operator=(const SendmmsgRtpTransport &) = delete;
+
+    void setSynchronizationSources(const SynchronizationSources &synchronizationSources) override;
+    RtpFrameSetResult sendFrameSet(const FrameSet &frames, uint32_t timestamp) override;
+    [[nodiscard]] const char *name() const override { return "sendmmsg"; }
+
+  private:
+    int socket_{-1};
+    SynchronizationSources synchronizationSources_{};
+    std::array<uint16_t, RTP_STREAMING_CHANNELS> sequenceNumbers_{};
+    std::array<bool, RTP_STREAMING_CHANNELS> resuming_{}; // skipped last time, so the next packet's marked
+
+    std::array<sockaddr_in, RTP_STREAMING_CHANNELS> destinations_{};
+    std::array<std::array<uint8_t, RTP_HEADER_BYTES>, RTP_STREAMING_CHANNELS> headers_{};
+    std::array<std::array<iovec, 2>, RTP_STREAMING_CHANNELS> vectors_{}; // header, then payload
+#if defined(__linux__)
+    std::array<mmsghdr, RTP_STREAMING_CHANNELS> messages_{};
+    std::array<mmsghdr, RTP_STREAMING_CHANNELS> batch_{}; // the messages being sent this time
+#else
+    std::array<msghdr, RTP_STREAMING_CHANNELS> messages_{};
+    std::array<msghdr, RTP_STREAMING_CHANNELS> batch_{};
+#endif
+    std::array<uint8_t, RTP_STREAMING_CHANNELS> batchChannels_{}; // which channel each of batch_ is
+};
+
+} // namespace creatures::rtp
@@ -0,0 +1,92 @@
+#include "server/rtp/UvgRtpTransport.h"
+
+#include <stdexcept>
+
+#include <fmt/format.h>
+#include <uvgrtp/lib.hh>
+#include <uvgrtp/media_stream.hh>
+#include <uvgrtp/util.hh>
+
+namespace creatures::rtp {
+
+UvgRtpTransport::UvgRtpTransport() {
+    try {
+        for (size_t channelIndex = 0; channelIndex < RTP_STREAMING_CHANNELS; ++channelIndex) {
+            // Create session with multicast address
+            rtpSessions_[channelIndex] = rtpContext_.create_session(RTP_GROUPS[channelIndex]);
+            if (!rtpSessions_[channelIndex]) {
+                throw std::runtime_error(fmt::format("unable to create RTP session for channel {}", channelIndex));
+            }
+
+            // Create media stream with local port, remote port, format, and flags
+            mediaStreams_[channelIndex] = rtpSessions_[channelIndex]->create_stream(RTP_PORT,        // source port
+                                                                                    RTP_PORT,        // destination port
+                                                                                    RTP_FORMAT_OPUS, // format
+                                                                                    RCE_SEND_ONLY);  // flags
+            if (!mediaStreams_[channelIndex]) {
+                throw std::runtime_error(fmt::format("unable to create RTP stream for channel {}", channelIndex));
+            }
+
+            // Override the dynamic payload type so VLC/Wireshark recognize Opus (payload type 96)
+            if (mediaStreams_[channelIndex]->configure_ctx(RCC_DYN_PAYLOAD_TYPE, RTP_OPUS_PAYLOAD_PT) != RTP_OK) {
+                throw std::runtime_error(
+                    fmt::format("unable to configure RTP payload type for channel {}", channelIndex));
+            }
+
+            // Configure the clock rate for accurate timing (48 kHz)
+            if (mediaStreams_[channelIndex]->configure_ctx(RCC_CLOCK_RATE, RTP_SRATE) != RTP_OK) {
+                throw std::runtime_error(
+                    fmt::format("unable to configure RTP clock rate for channel {}", channelIndex));
+            }
+        }
+    } catch (...) {
+        destroyStreams();
+        throw;
+    }
+}
+
+UvgRtpTransport::~UvgRtpTransport() { destroyStreams(); }
+
+void UvgRtpTransport::destroyStreams() {
+    for (size_t channelIndex = 0; channelIndex < RTP_STREAMING_CHANNELS; ++channelIndex) {
+        if (rtpSessions_[channelIndex] && mediaStreams_[channelIndex]) {
+            rtpSessions_[channelIndex]->destroy_stream(mediaStreams_[channelIndex]);
+        }
+        if (rtpSessions_[channelIndex]) {
+            rtpContext_.destroy_session(rtpSessions_[channelIndex]);
+        }
+        mediaStreams_[channelIndex] = nullptr;
+        rtpSessions_[channelIndex] = nullptr;
+    }
+}
+
+void UvgRtpTransport::setSynchronizationSources(const SynchronizationSources &synchronizationSources) {
+    for (size_t channelIndex = 0; channelIndex < RTP_STREAMING_CHANNELS; ++channelIndex) {
+        if (mediaStreams_[channelIndex]->configure_ctx(RCC_SSRC, synchronizationSources[channelIndex]) != RTP_OK) {
+            throw std::runtime_error(fmt::format("unable to configure RTP SSRC for channel {}", channelIndex));
+        }
+    }
+}
+
+RtpFrameSetResult UvgRtpTransport::sendFrameSet(const FrameSet &frames, uint32_t timestamp) {
+    RtpFrameSetResult result;
+    for (uint8_t channelIndex = 0; channelIndex < RTP_STREAMING_CHANNELS; ++channelIndex) {
+        const auto &frame = frames[channelIndex];
+        if (frame.empty()) {
+            continue; // silent; uvgRTP doesn't offer the marker bit, so the gap is all receivers get
+        }
+        const auto transmissionResult =
+            mediaStreams_[channelIndex]->push_frame(const_cast<uint8_t *>(frame.data()), // uvgRTP requires non-const
+                                                    frame.size(), timestamp, RTP_NO_FLAGS);
+        ++result.syscalls;
+        if (transmissionResult != RTP_OK && result.error == 0) {
+            result.error = static_cast<int>(transmissionResult);
+            result.firstFailedChannel = channelIndex;
+        } else if (transmissionResult == RTP_OK) {
+            result.sentOctets[channelIndex] = static_cast<uint32_t>(frame.size());
+        }
+    }
+    return result;
+}
+
+} // namespace creatures::rtp
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include <uvgrtp/lib.hh>
+
+#include "server/config.h"
+#include "server/rtp/RtpTransport.h"
+
+namespace creatures::rtp {
+
+/**
+ * The original transport: a uvgRTP session and media stream per channel
+ *
+ * Every channel has its own socket and its own push_frame() (and so at least
+ * one sendto()) per frame set. Kept as the fallback for when sendmmsg()
+ * isn't available.
+ */
+class UvgRtpTransport : public RtpTransport {
+  public:
+    /** Throws std::runtime_error if a session or stream can't be set up */
+    UvgRtpTransport();
+    ~UvgRtpTransport() override;
+
+    UvgRtpTransport(const UvgRtpTransport &) = delete;
+    UvgRtpTransport &operator=(const UvgRtpTransport &) = delete;
+
+    void setSynchronizationSources(const SynchronizationSources &synchronizationSources) override;
+    RtpFrameSetResult sendFrameSet(const FrameSet &frames, uint32_t timestamp) override;
+    [[nodiscard]] const char *name() const override { return "uvgrtp"; }
+
+  private:
+    void destroyStreams();
+
+    uvgrtp::context rtpContext_;
+    std::array<uvgrtp::session *, RTP_STREAMING_CHANNELS> rtpSessions_{};
+    std::array<uvgrtp::media_stream *, RTP_STREAMING_CHANNELS> mediaStreams_{};
+};
+
+} // namespace creatures::rtp
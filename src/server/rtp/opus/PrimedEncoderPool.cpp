@@ -0,0 +1,83 @@
+#include "PrimedEncoderPool.h"
+
+#include <exception>
+#include <utility>
+
+#include "server/config.h"
+#include "server/namespace-stuffs.h"
+#include "server/rtp/opus/OpusPriming.h"
+
+namespace creatures::rtp::opus {
+
+PrimedEncoderPool::Lease::Lease(std::shared_ptr<PrimedEncoderPool> _pool, std::unique_ptr<Encoder> _encoder)
+    : pool(std::move(_pool)), encoder(std::move(_encoder)) {}
+
+PrimedEncoderPool::Lease::~Lease() {
+    if (pool && encoder) {
+        pool->giveBack(std::move(encoder));
+    }
+}
+
+PrimedEncoderPool::Lease &PrimedEncoderPool::Lease::operator=(Lease &&other) noexcept {
+    if (this != &other) {
+        if (pool && encoder) {
+            pool->giveBack(std::move(encoder));
+        }
+        pool = std::move(other.pool);
+        encoder = std::move(other.encoder);
+    }
+    return *this;
+}
+
+PrimedEncoderPool::PrimedEncoderPool(std::size_t _maxIdle) : maxIdle(_maxIdle) {}
+
+PrimedEncoderPool::Lease PrimedEncoderPool::acquire() {
+    {
+        std::lock_guard lock(mutex);
+        if (!idle.empty()) {
+            auto encoder = std::move(idle.back());
+            idle.pop_back();
+            return Lease{shared_from_this(), std::move(encoder)};
+        }
+    }
+
+    // Match the decoder history established by MultiOpusRtpServer's startup silence sequence
+    auto encoder = std::make_unique<Encoder>();
+    static_cast<void>(encodePrimingSequence(*encoder));
+    return Lease{shared_from_this(), std::move(encoder)};
+}
+
+std::size_t PrimedEncoderPool::idleCount() const {
+    std::lock_guard lock(mutex);
+    return idle.size();
+}
+
+std::shared_ptr<PrimedEncoderPool> PrimedEncoderPool::shared() {
+    static const auto pool = std::make_shared<PrimedEncoderPool>(2 * RTP_STREAMING_CHANNELS);
+    return pool;
+}
+
+void PrimedEncoderPool::giveBack(std::unique_ptr<Encoder> encoder) {
+    {
+        std::lock_guard lock(mutex);
+        if (idle.size() >= maxIdle) {
+            return;
+        }
+    }
+
+    // Whatever it was encoding (or how far it got before something went wrong), it's fresh after this
+    try {
+        encoder->reset();
+        static_cast<void>(encodePrimingSequence(*encoder));
+    } catch (const std::exception &e) {
+        warn("Not reusing an Opus encoder that couldn't be primed again: {}", e.what());
+        return;
+    }
+
+    std::lock_guard lock(mutex);
+    if (idle.size() < maxIdle) {
+        idle.push_back(std::move(encoder));
+    }
+}
+
+} // namespace creatures::rtp::opus
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "server/rtp/opus/OpusEncoderWrapper.h"
+
+namespace creatures::rtp::opus {
+
+/**
+ * Opus encoders that have already been through encodePrimingSequence(), ready to encode frame zero
+ *
+ * A cache miss needs one primed encoder per channel. Rather than creating and
+ * priming 17 of them for every file, encoders are handed back when the encode
+ * is done, reset (OPUS_RESET_STATE puts an encoder back the way
+ * opus_encoder_create() left it, keeping its settings), primed again, and kept
+ * for the next one. The reset and priming happen when the encoder is handed
+ * back, after the last frame has been published, so they're never in the way
+ * of playback.
+ */
+class PrimedEncoderPool : public std::enable_shared_from_this<PrimedEncoderPool> {
+
+  public:
+    /** One encoder, borrowed from the pool until this goes away */
+    class Lease {
+      public:
+        Lease() = default;
+        ~Lease();
+
+        Lease(Lease &&other) noexcept = default;
+        Lease &operator=(Lease &&other) noexcept;
+
+        Lease(const Lease &) = delete;
+        Lease &operator=(const Lease &) = delete;
+
+        Encoder &operator*() const { return *encoder; }
+        Encoder *operator->() const { return encoder.get(); }
+        explicit operator bool() const { return encoder != nullptr; }
+
+      private:
+        friend class PrimedEncoderPool;
+        Lease(std::shared_ptr<PrimedEncoderPool> pool, std::unique_ptr<Encoder> encoder);
+
+        std::shared_ptr<PrimedEncoderPool> pool;
+        std::unique_ptr<Encoder> encoder;
+    };
+
+    /** @param maxIdle most encoders to keep between loads; any more than that are destroyed when handed back */
+    explicit PrimedEncoderPool(std::size_t maxIdle);
+
+    /** A primed encoder, making one if there aren't any idle. Has to be owned by a shared_ptr. */
+    Lease acquire();
+
+    [[nodiscard]] std::size_t idleCount() const;
+
+    /** The process-wide pool, which keeps enough for a couple of 17-channel encodes */
+    static std::shared_ptr<PrimedEncoderPool> shared();
+
+  private:
+    void giveBack(std::unique_ptr<Encoder> encoder);
+
+    const std::size_t maxIdle;
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<Encoder>> idle;
+};
+
+} // namespace creatures::rtp::opus
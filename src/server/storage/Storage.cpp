@@ -9,6 +9,8 @@
 
 #include "model/CacheInvalidation.h"
 #include "server/config.h"
+#include "server/animation/AnimationCache.h"
+#include "server/animation/PlaylistPrefetcher.h"
 #include "server/config/Configuration.h"
 #include "server/database.h"
 #include "server/namespace-stuffs.h"
@@ -17,6 +19,8 @@
 namespace creatures {
 extern std::shared_ptr<Configuration> config;
 extern std::shared_ptr<Database> db;
+extern std::shared_ptr<AnimationCache> animationCache;
+extern std::shared_ptr<PlaylistPrefetcher> playlistPrefetcher;
 } // namespace creatures
 
 namespace creatures::storage {
@@ -131,6 +135,25 @@ template <typename DbCall, typename... Caches> auto runPublisher(const char *opN
     return result;
 }
 
+// Playlists load their next item ahead of time. When an animation or a
+// playlist changes, whatever they've already loaded has to be loaded again.
+void forgetPrefetchedPlaylistItems() {
+    if (creatures::playlistPrefetcher) {
+        creatures::playlistPrefetcher->invalidateAll();
+    }
+}
+
+// Playback keeps decoded animations around. The clients hear about a change
+// on the next event loop frame, but the server's own copy has to go now, or a
+// play in between would get the old frames.
+void forgetCachedAnimation(const animationId_t &animationId) {
+    if (creatures::animationCache) {
+        creatures::animationCache->invalidate(animationId);
+    }
+    // A playlist's next item might be this animation, already loaded
+    forgetPrefetchedPlaylistItems();
+}
+
 } // namespace
 
 Result<std::filesystem::path> root(Persistence persistence) {
@@ -195,9 +218,13 @@ Result<StoragePath> writeSoundFile(Persistence persistence, std::string filename
 
 Result<creatures::Animation> publishAnimation(const std::string &animationJson,
                                               std::shared_ptr<OperationSpan> parentSpan) {
-    return runPublisher(
+    auto result = runPublisher(
         "publishAnimation", [&] { return creatures::db->upsertAnimation(animationJson, parentSpan); },
         CacheType::Animation, CacheType::SoundList);
+    if (result.isSuccess()) {
+        forgetCachedAnimation(result.getValue()->id);
+    }
+    return result;
 }
 
 Result<void> publishAdHocAnimation(const creatures::Animation &animation, std::shared_ptr<OperationSpan> parentSpan) {
@@ -226,9 +253,13 @@ Result<creatures::Animation> republishAnimation(const std::string &animationJson
     // Animation only — no SoundList invalidation because the sound file
     // reference didn't change (the lipsync handler mutates tracks in-place
     // on the existing animation's existing sound).
-    return runPublisher(
+    auto result = runPublisher(
         "republishAnimation", [&] { return creatures::db->upsertAnimation(animationJson, parentSpan); },
         CacheType::Animation);
+    if (result.isSuccess()) {
+        forgetCachedAnimation(result.getValue()->id);
+    }
+    return result;
 }
 
 Result<creatures::Creature> publishCreature(const std::string &creatureJson,
@@ -258,9 +289,13 @@ Result<void> setFixtureUniverse(const fixtureId_t &fixtureId, std::optional<univ
 
 Result<creatures::Playlist> publishPlaylist(const std::string &playlistJson,
                                             std::shared_ptr<OperationSpan> parentSpan) {
-    return runPublisher(
+    auto result = runPublisher(
         "publishPlaylist", [&] { return creatures::db->upsertPlaylist(playlistJson, parentSpan); },
         CacheType::Playlist);
+    if (result.isSuccess()) {
+        forgetPrefetchedPlaylistItems();
+    }
+    return result;
 }
 
 Result<creatures::DialogScript> publishDialogScript(const std::string &scriptJson,
@@ -300,15 +335,25 @@ Result<void> deleteStoryboard(const storyboardId_t &storyboardId, std::shared_pt
 }
 
 Result<void> deleteAnimation(const animationId_t &animationId, std::shared_ptr<OperationSpan> parentSpan) {
-    return runPublisher(
+    auto result = runPublisher(
         "deleteAnimation", [&] { return creatures::db->deleteAnimation(animationId, parentSpan); },
         CacheType::Animation);
+    if (result.isSuccess()) {
+        forgetCachedAnimation(animationId);
+    }
+    return result;
 }
 
 void broadcastCacheInvalidation(CacheType type) {
     // No DB call to pair with — explicit standalone broadcast. The name
     // signals "this is a deliberate manual case" so a reader can tell at a
     // glance it's not a forgotten pairing.
+    if (type == CacheType::Animation && creatures::animationCache) {
+        creatures::animationCache->invalidateAll();
+    }
+    if (type == CacheType::Animation || type == CacheType::Playlist) {
+        forgetPrefetchedPlaylistItems();
+    }
     scheduleCacheInvalidationEvent(CACHE_INVALIDATION_DELAY_TIME, type);
 }
 
@@ -149,6 +149,8 @@ Result<Animation> buildDialogAnimation(const DialogAssembled &assembled,
 
     // MongoDB documents cap at 16 MiB. Conservatively estimate each base64
     // frame as a BSON array string element before materializing any tracks.
+    // Tracks are stored as packed binary now, which is much smaller, but this
+    // is still the shape the API hands the scene back to clients in.
     // Besides the string itself, every element carries a type byte, an array
     // index cstring (up to 10 digits for uint32 frame indices), a four-byte
     // string length, and its terminating NUL. Keep 4 MiB of additional
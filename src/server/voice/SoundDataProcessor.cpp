@@ -1,7 +1,6 @@
 #include "SoundDataProcessor.h"
 
 #include <algorithm>
-#include <base64.hpp>
 
 #include "server/namespace-stuffs.h"
 #include "util/helpers.h"
@@ -54,9 +53,8 @@ Result<Track> SoundDataProcessor::replaceAxisDataWithSoundData(const RhubarbSoun
         return ServerError(ServerError::InvalidData, "Track has no frames to replace");
     }
 
-    // Decode first frame to determine width
-    std::vector<uint8_t> firstFrameData = decodeFrame(track.frames[0]);
-    const size_t frameWidth = firstFrameData.size();
+    // Every frame is the same width
+    const size_t frameWidth = track.frames.width();
 
     // Validate axis index is in bounds
     if (axisIndex >= frameWidth) {
@@ -68,21 +66,12 @@ Result<Track> SoundDataProcessor::replaceAxisDataWithSoundData(const RhubarbSoun
     // Process the sound data into byte array
     const std::vector<uint8_t> newAxisData = processSoundData(soundData, millisecondsPerFrame, track.frames.size());
 
-    // Create modified track
+    // Create modified track (the first write gives it its own copy of the frames)
     Track modifiedTrack = track;
 
     // Replace the specified axis in each frame
     for (size_t frameIdx = 0; frameIdx < modifiedTrack.frames.size(); ++frameIdx) {
-        // Decode the frame
-        std::vector<uint8_t> frameData = decodeFrame(modifiedTrack.frames[frameIdx]);
-
-        // Replace the axis value
-        if (axisIndex < frameData.size()) {
-            frameData[axisIndex] = newAxisData[frameIdx];
-        }
-
-        // Re-encode the frame
-        modifiedTrack.frames[frameIdx] = encodeFrame(frameData);
+        modifiedTrack.frames.mutableFrame(frameIdx)[axisIndex] = newAxisData[frameIdx];
     }
 
     info("Successfully replaced axis {} in {} frames", axisIndex, modifiedTrack.frames.size());
@@ -90,14 +79,4 @@ Result<Track> SoundDataProcessor::replaceAxisDataWithSoundData(const RhubarbSoun
     return modifiedTrack;
 }
 
-std::vector<uint8_t> SoundDataProcessor::decodeFrame(const std::string &base64Frame) const {
-    return decodeBase64(base64Frame);
-}
-
-std::string SoundDataProcessor::encodeFrame(const std::vector<uint8_t> &frameData) const {
-    // Convert vector to string_view for base64 encoding
-    std::string dataStr(frameData.begin(), frameData.end());
-    return base64::to_base64(dataStr);
-}
-
 } // namespace creatures
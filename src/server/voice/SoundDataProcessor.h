@@ -51,21 +51,6 @@ class SoundDataProcessor {
      */
     Result<Track> replaceAxisDataWithSoundData(const RhubarbSoundData &soundData, size_t axisIndex, const Track &track,
                                                uint32_t millisecondsPerFrame) const;
-
-  private:
-    /**
-     * @brief Decode a base64-encoded frame into a byte vector
-     * @param base64Frame The base64-encoded frame string
-     * @return Vector of bytes representing servo positions
-     */
-    std::vector<uint8_t> decodeFrame(const std::string &base64Frame) const;
-
-    /**
-     * @brief Encode a byte vector into a base64-encoded string
-     * @param frameData Vector of servo position bytes
-     * @return Base64-encoded string
-     */
-    std::string encodeFrame(const std::vector<uint8_t> &frameData) const;
 };
 
 } // namespace creatures
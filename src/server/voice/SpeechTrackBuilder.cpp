@@ -4,7 +4,6 @@
 #include <cmath>
 #include <limits>
 
-#include <base64.hpp>
 #include <fmt/format.h>
 #include <spdlog/spdlog.h>
 
@@ -16,21 +15,13 @@ namespace creatures::voice {
 
 namespace {
 
-// Decode a Track's base64 frames into raw byte vectors. Returns InvalidData
-// if any frame fails to decode.
-Result<std::vector<std::vector<uint8_t>>> decodeFrames(const std::vector<std::string> &encodedFrames,
-                                                       const std::string &creatureId) {
+// Unpack a Track's frames into one vector per frame, which is what the
+// builder cycles through
+std::vector<std::vector<uint8_t>> unpackFrames(const PackedFrames &frames) {
     std::vector<std::vector<uint8_t>> out;
-    out.reserve(encodedFrames.size());
-    for (std::size_t i = 0; i < encodedFrames.size(); ++i) {
-        try {
-            const std::string raw = base64::from_base64(encodedFrames[i]);
-            out.emplace_back(raw.begin(), raw.end());
-        } catch (const std::exception &e) {
-            return Result<std::vector<std::vector<uint8_t>>>{ServerError(
-                ServerError::InvalidData,
-                fmt::format("Creature '{}' base-frame[{}] base64 decode failed: {}", creatureId, i, e.what()))};
-        }
+    out.reserve(frames.size());
+    for (std::size_t i = 0; i < frames.size(); ++i) {
+        out.emplace_back(frames[i].begin(), frames[i].end());
     }
     return out;
 }
@@ -84,11 +75,7 @@ Result<ResolvedSpeechBase> resolveLoopFrames(const creatures::Creature &creature
                                                   creature.name, baseAnim.metadata.title))};
     }
 
-    auto decodeResult = decodeFrames(trackIt->frames, creature.id);
-    if (!decodeResult.isSuccess()) {
-        return Result<ResolvedSpeechBase>{decodeResult.getError().value()};
-    }
-    auto baseFrames = decodeResult.getValue().value();
+    auto baseFrames = unpackFrames(trackIt->frames);
 
     // Width consistency check. All frames must be the same width or the
     // modular cycle in buildSpeechTrack would shift mouth_slot mid-scene.
@@ -341,8 +328,7 @@ Result<SpeechTrackResult> buildSpeechTrack(const SpeechTrackInput &input, const
             lastCockByte = cockByte;
         }
 
-        std::string raw(reinterpret_cast<const char *>(frame.data()), frame.size());
-        result.track.frames.push_back(base64::to_base64(raw));
+        result.track.frames.push_back(frame);
     }
 
     // For streaming continuity: where would the body counter land at the
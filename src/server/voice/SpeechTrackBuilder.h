@@ -23,7 +23,7 @@ namespace creatures::voice {
 
 // =============================================================================
 // resolveSpeechBaseFrames — pick a speech_loop_animation_ids entry, look up
-// the animation, find the right track, decode base64 frames, validate widths.
+// the animation, find the right track, unpack its frames, validate widths.
 // =============================================================================
 
 struct ResolvedSpeechBase {
@@ -52,7 +52,7 @@ enum class LoopKind {
 };
 
 // The shared resolver: pick one id at random from `animationIds`, load it,
-// find the creature's track, decode the base64 frames, validate widths. RNG
+// find the creature's track, unpack its frames, validate widths. RNG
 // comes in by reference so tests can pin the choice with a seeded generator;
 // production callers thread their existing rng through unchanged.
 //
@@ -319,7 +319,7 @@ Result<void> StreamingAdHocSession::addText(const std::string &text) {
             return Result<Animation>{trackResult.getError().value()};
         }
         const std::size_t endOffset = trackResult.getValue()->endOffset;
-        std::vector<std::string> encodedFrames = std::move(trackResult.getValue()->track.frames);
+        PackedFrames frames = std::move(trackResult.getValue()->track.frames);
 
         // 7. Signal next sentence with our ending offset and request ID
         {
@@ -338,14 +338,14 @@ Result<void> StreamingAdHocSession::addText(const std::string &text) {
         animation.metadata.title = fmt::format("{} - s{} - {}", creatureName, sentenceIndex, textSlug);
         animation.metadata.sound_file = wavPath.string();
         animation.metadata.note = fmt::format("Streaming sentence {}: {}", sentenceIndex, text);
-        animation.metadata.number_of_frames = static_cast<uint32_t>(encodedFrames.size());
+        animation.metadata.number_of_frames = static_cast<uint32_t>(frames.size());
         animation.metadata.multitrack_audio = true;
 
         Track newTrack;
         newTrack.id = util::generateUUID();
         newTrack.creature_id = creatureId_;
         newTrack.animation_id = animation.id;
-        newTrack.frames = std::move(encodedFrames);
+        newTrack.frames = std::move(frames);
         animation.tracks = {newTrack};
 
         // 9. Insert into DB. Storage facade pairs the insert + invalidations
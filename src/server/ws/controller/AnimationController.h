@@ -373,7 +373,16 @@ class AnimationController : public oatpp::web::server::api::ApiController,
                     // Convert from oatpp DTO to internal model
                     std::shared_ptr<AnimationDto> animationDtoPtr(animationDto.get(),
                                                                   [](AnimationDto *) {}); // Non-owning shared_ptr
-                    auto animation = convertFromDto(animationDtoPtr);
+                    auto animationResult = convertFromDto(animationDtoPtr);
+                    if (!animationResult.isSuccess()) {
+                        auto errorMsg = animationResult.getError()->getMessage();
+                        error("Animation {} can't be played: {}", std::string(requestBody->animation_id), errorMsg);
+                        if (span) {
+                            span->setAttribute("error.message", errorMsg);
+                        }
+                        return bailFromServerError(span, animationResult.getError().value());
+                    }
+                    const auto animation = animationResult.getValue().value();
 
                     // Use SessionManager to interrupt
                     auto sessionResult =
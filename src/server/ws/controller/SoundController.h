@@ -252,7 +252,9 @@ class SoundController : public oatpp::web::server::api::ApiController, public Ht
                                if (span && requestBody && requestBody->file_name) {
                                    span->setAttribute("audio.file.name", std::string(requestBody->file_name));
                                }
-                               const auto result = m_soundService.playSound(std::string(requestBody->file_name), span);
+                               const auto result =
+                                   m_soundService.playSound(std::string(requestBody->file_name), requestBody->mix_role,
+                                                            requestBody->gain_db, requestBody->channel, span);
                                if (span)
                                    span->setHttpStatus(200);
                                return createDtoResponse(Status::CODE_200, result);
@@ -41,6 +41,11 @@ class WebSocketController : public oatpp::web::server::api::ApiController {
 
     ENDPOINT_INFO(ws) {
         info->summary = "WebSocket endpoint";
+        info->description = "Clients get every message until they send a \"subscribe\" command with a list of "
+                            "topics, each a message type with an optional creature_id, universe, or log_level. "
+                            "\"unsubscribe\" takes the same list and drops those types. A \"stream-binding\" "
+                            "command binds slots to creatures, after which stream frames can be sent as binary "
+                            "messages: version (1), slot, universe (2 bytes), sequence (4 bytes), then the channels.";
         info->addTag("WebSocket");
     }
     ENDPOINT("GET", "api/v1/websocket", ws, REQUEST(std::shared_ptr<IncomingRequest>, request)) {
@@ -17,6 +17,24 @@ class PlaySoundRequestDTO : public oatpp::DTO {
         info->required = true;
     }
     DTO_FIELD(String, file_name);
+
+    DTO_FIELD_INFO(mix_role) {
+        info->description = "With the RTP mixer on: 'program' (the default), 'dialog' (ducks music), or 'bed' (music)";
+        info->required = false;
+    }
+    DTO_FIELD(String, mix_role);
+
+    DTO_FIELD_INFO(gain_db) {
+        info->description = "With the RTP mixer on: the sound's gain in the mix, in dB (-90 to +12)";
+        info->required = false;
+    }
+    DTO_FIELD(Float32, gain_db);
+
+    DTO_FIELD_INFO(channel) {
+        info->description = "With the RTP mixer on: the channel (0-16) a mono sound plays on; BGM if unset";
+        info->required = false;
+    }
+    DTO_FIELD(Int32, channel);
 };
 } // namespace creatures::ws
 #include OATPP_CODEGEN_END(DTO)
@@ -40,10 +40,48 @@ std::string toString(MessageType type) {
         return "idle-state-changed";
     case MessageType::CreatureActivity:
         return "creature-activity";
+    case MessageType::Subscribe:
+        return "subscribe";
+    case MessageType::Unsubscribe:
+        return "unsubscribe";
+    case MessageType::StreamBinding:
+        return "stream-binding";
 
     default:
         return "unknown";
     }
 }
 
+std::optional<MessageType> messageTypeOf(std::string_view json) {
+    constexpr std::string_view commandKey = "\"command\"";
+    auto position = json.find(commandKey);
+    if (position == std::string_view::npos) {
+        return std::nullopt;
+    }
+    position = json.find('"', json.find(':', position + commandKey.size()));
+    if (position == std::string_view::npos) {
+        return std::nullopt;
+    }
+    const auto end = json.find('"', position + 1);
+    if (end == std::string_view::npos) {
+        return std::nullopt;
+    }
+    const auto command = json.substr(position + 1, end - position - 1);
+
+    // Every message sent goes through here, so only build the names once
+    static const auto commands = [] {
+        std::array<std::string, allMessageTypes.size()> names;
+        for (size_t index = 0; index < allMessageTypes.size(); ++index) {
+            names[index] = toString(allMessageTypes[index]);
+        }
+        return names;
+    }();
+    for (size_t index = 0; index < commands.size(); ++index) {
+        if (commands[index] == command) {
+            return allMessageTypes[index];
+        }
+    }
+    return std::nullopt;
+}
+
 } // namespace creatures::ws
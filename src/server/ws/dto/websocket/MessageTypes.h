@@ -1,7 +1,10 @@
 
 #pragma once
 
+#include <array>
+#include <optional>
 #include <string>
+#include <string_view>
 
 namespace creatures::ws {
 
@@ -22,9 +25,37 @@ enum class MessageType {
     JobComplete,
     IdleStateChanged,
     CreatureActivity,
+    Subscribe,
+    Unsubscribe,
+    StreamBinding,
 };
 
-// Don't forget to update the toString function in MessageTypes.cpp
+// Every type, so a command can be looked up (and so they can be counted)
+inline constexpr std::array allMessageTypes = {
+    MessageType::Database,          MessageType::LogMessage,
+    MessageType::ServerCounters,    MessageType::Notice,
+    MessageType::StreamFrame,       MessageType::VirtualStatusLights,
+    MessageType::UpsertCreature,    MessageType::BoardSensorReport,
+    MessageType::MotorSensorReport, MessageType::DynamixelSensorReport,
+    MessageType::CacheInvalidation, MessageType::PlaylistStatus,
+    MessageType::JobProgress,       MessageType::JobComplete,
+    MessageType::IdleStateChanged,  MessageType::CreatureActivity,
+    MessageType::Subscribe,         MessageType::Unsubscribe,
+    MessageType::StreamBinding,
+};
+
+// Don't forget to update allMessageTypes above and the toString function in MessageTypes.cpp
 std::string toString(MessageType type);
 
+/**
+ * Work out which kind of message an outgoing JSON string is from its "command" field
+ *
+ * Our messages are all serialized with the command first, so this only has to look at
+ * the start of the string rather than parse the whole thing.
+ *
+ * @param json a serialized websocket message
+ * @return the message's type, or std::nullopt if it doesn't have one we know
+ */
+std::optional<MessageType> messageTypeOf(std::string_view json);
+
 } // namespace creatures::ws
@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <limits>
+
+#include <fmt/format.h>
+
+#include "server/ws/messaging/BinaryStreamFrame.h"
+
+namespace creatures ::ws {
+
+namespace {
+
+using Bindings = std::vector<std::pair<uint8_t, creatureId_t>>;
+
+uint32_t readBigEndian(std::span<const uint8_t> bytes) {
+    uint32_t value = 0;
+    for (const auto byte : bytes) {
+        value = (value << 8) | byte;
+    }
+    return value;
+}
+
+void writeBigEndian(uint32_t value, std::span<uint8_t> bytes) {
+    for (auto byte = bytes.rbegin(); byte != bytes.rend(); ++byte) {
+        *byte = static_cast<uint8_t>(value & 0xFF);
+        value >>= 8;
+    }
+}
+
+} // namespace
+
+Result<BinaryStreamFrame> readBinaryStreamFrame(std::span<const uint8_t> message) {
+    if (message.size() <= binaryStreamFrameHeaderSize) {
+        return Result<BinaryStreamFrame>{
+            ServerError(ServerError::InvalidData, "A binary stream frame needs a header and at least one channel")};
+    }
+    if (message[0] != binaryStreamFrameVersion) {
+        return Result<BinaryStreamFrame>{ServerError(
+            ServerError::InvalidData, fmt::format("Binary stream frame version {} isn't one we know", message[0]))};
+    }
+
+    BinaryStreamFrame frame;
+    frame.slot = message[1];
+    frame.universe = readBigEndian(message.subspan(2, 2));
+    frame.sequence = readBigEndian(message.subspan(4, 4));
+    frame.channels = message.subspan(binaryStreamFrameHeaderSize);
+
+    if (frame.channels.size() > binaryStreamFrameMaxChannels) {
+        return Result<BinaryStreamFrame>{
+            ServerError(ServerError::InvalidData, fmt::format("A binary stream frame can't have {} channels",
+                                                              frame.channels.size()))};
+    }
+    return Result<BinaryStreamFrame>{frame};
+}
+
+Result<std::vector<uint8_t>> writeBinaryStreamFrame(const BinaryStreamFrame &frame) {
+    if (frame.channels.empty() || frame.channels.size() > binaryStreamFrameMaxChannels) {
+        return Result<std::vector<uint8_t>>{
+            ServerError(ServerError::InvalidData, fmt::format("A binary stream frame can't have {} channels",
+                                                              frame.channels.size()))};
+    }
+    if (frame.universe > std::numeric_limits<uint16_t>::max()) {
+        return Result<std::vector<uint8_t>>{ServerError(
+            ServerError::InvalidData, fmt::format("Universe {} doesn't fit in a binary stream frame", frame.universe))};
+    }
+
+    std::vector<uint8_t> message(binaryStreamFrameHeaderSize + frame.channels.size());
+    const std::span<uint8_t> bytes(message);
+    bytes[0] = binaryStreamFrameVersion;
+    bytes[1] = frame.slot;
+    writeBigEndian(frame.universe, bytes.subspan(2, 2));
+    writeBigEndian(frame.sequence, bytes.subspan(4, 4));
+    std::copy(frame.channels.begin(), frame.channels.end(), bytes.begin() + binaryStreamFrameHeaderSize);
+    return Result<std::vector<uint8_t>>{message};
+}
+
+void StreamSlots::bind(const Bindings &bindings) {
+    slots_.fill(std::nullopt);
+    for (const auto &[slot, creatureId] : bindings) {
+        slots_[slot] = Slot{creatureId, std::nullopt};
+    }
+    enabled_ = !bindings.empty();
+}
+
+bool StreamSlots::isEnabled() const { return enabled_; }
+
+const creatureId_t *StreamSlots::creatureIn(uint8_t slot) const {
+    return slots_[slot] ? &slots_[slot]->creatureId : nullptr;
+}
+
+bool StreamSlots::accept(uint8_t slot, uint32_t sequence) {
+    auto &bound = slots_[slot];
+    if (!bound) {
+        return false;
+    }
+
+    // Serial number arithmetic, so the sequence can wrap around
+    if (bound->lastSequence && static_cast<int32_t>(sequence - *bound->lastSequence) <= 0) {
+        return false;
+    }
+    bound->lastSequence = sequence;
+    return true;
+}
+
+Result<Bindings> streamSlotsFromDto(const oatpp::Object<StreamBindingPayloadDto> &payload) {
+    if (!payload || !payload->slots) {
+        return Result<Bindings>{ServerError(ServerError::InvalidData, "No slots were given")};
+    }
+
+    Bindings bindings;
+    bindings.reserve(payload->slots->size());
+    for (const auto &slot : *payload->slots) {
+        if (!slot || !slot->slot || !slot->creature_id || slot->creature_id->empty()) {
+            return Result<Bindings>{ServerError(ServerError::InvalidData, "Every slot needs a number and a creature")};
+        }
+        if (*slot->slot > std::numeric_limits<uint8_t>::max()) {
+            return Result<Bindings>{
+                ServerError(ServerError::InvalidData, fmt::format("There's no slot {}", *slot->slot))};
+        }
+
+        const auto number = static_cast<uint8_t>(*slot->slot);
+        const auto alreadyGiven = [number](const auto &bound) { return bound.first == number; };
+        if (std::any_of(bindings.begin(), bindings.end(), alreadyGiven)) {
+            return Result<Bindings>{
+                ServerError(ServerError::InvalidData, fmt::format("Slot {} was given more than once", number))};
+        }
+        bindings.emplace_back(number, std::string(slot->creature_id));
+    }
+    return Result<Bindings>{bindings};
+}
+
+} // namespace creatures::ws
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <oatpp/core/Types.hpp>
+
+#include "server/namespace-stuffs.h"
+#include "server/ws/messaging/StreamBindingCommandDTO.h"
+#include "util/Result.h"
+
+namespace creatures ::ws {
+
+/*
+ * A stream frame as a binary websocket message, for consoles that would rather not build
+ * (and have us parse) JSON with base64 in it fifty times a second per creature.
+ *
+ * Every multi-byte field is big-endian.
+ *
+ *   offset  size  field
+ *        0     1  version (binaryStreamFrameVersion)
+ *        1     1  slot, which stands for a creature (see StreamSlots)
+ *        2     2  universe
+ *        4     4  sequence number, one more than the last frame's for this slot
+ *        8     n  the creature's channels, starting at its channel offset
+ *
+ * A connection has to bind its slots with a "stream-binding" message before it sends any
+ * of these. Plain "stream-frame" JSON messages keep working either way.
+ */
+
+inline constexpr uint8_t binaryStreamFrameVersion = 1;
+inline constexpr size_t binaryStreamFrameHeaderSize = 8;
+inline constexpr size_t binaryStreamFrameMaxChannels = 512;
+
+/**
+ * One decoded binary stream frame. The channels point into the message it came from.
+ */
+struct BinaryStreamFrame {
+    uint8_t slot{0};
+    universe_t universe{0};
+    uint32_t sequence{0};
+    std::span<const uint8_t> channels;
+};
+
+/**
+ * Read a binary stream frame out of a websocket message without copying it
+ *
+ * @param message the whole message
+ * @return the frame, or an InvalidData error if the message isn't one
+ */
+Result<BinaryStreamFrame> readBinaryStreamFrame(std::span<const uint8_t> message);
+
+/**
+ * Build a binary stream frame, the way a console would
+ *
+ * @return the message, or an InvalidData error if the frame can't be sent as one
+ */
+Result<std::vector<uint8_t>> writeBinaryStreamFrame(const BinaryStreamFrame &frame);
+
+/**
+ * The creatures one connection has bound to slots for binary stream frames
+ *
+ * Only the connection's reader thread touches this, so it's not locked.
+ */
+class StreamSlots {
+  public:
+    /**
+     * Replace every binding. An empty list turns binary frames off.
+     */
+    void bind(const std::vector<std::pair<uint8_t, creatureId_t>> &bindings);
+
+    /**
+     * @return true if the connection has bound any slots
+     */
+    [[nodiscard]] bool isEnabled() const;
+
+    /**
+     * @return the creature bound to this slot, or nullptr if there isn't one
+     */
+    [[nodiscard]] const creatureId_t *creatureIn(uint8_t slot) const;
+
+    /**
+     * Note a frame's sequence number for its slot
+     *
+     * @return false if it isn't newer than the last frame's, in which case the frame is stale
+     */
+    bool accept(uint8_t slot, uint32_t sequence);
+
+  private:
+    struct Slot {
+        creatureId_t creatureId;
+        std::optional<uint32_t> lastSequence;
+    };
+
+    std::array<std::optional<Slot>, 256> slots_;
+    bool enabled_{false};
+};
+
+/**
+ * Turn a "stream-binding" payload into slot bindings
+ *
+ * @return the bindings, or an InvalidData error describing what's wrong with them
+ */
+Result<std::vector<std::pair<uint8_t, creatureId_t>>>
+streamSlotsFromDto(const oatpp::Object<StreamBindingPayloadDto> &payload);
+
+} // namespace creatures::ws
@@ -10,9 +10,9 @@
 #include "server/sensors/SensorDataCache.h"
 #include "util/ObservabilityManager.h"
 #include "util/cache.h"
+#include "util/websocketUtils.h"
 
 namespace creatures {
-extern std::shared_ptr<moodycamel::BlockingConcurrentQueue<std::string>> websocketOutgoingMessages;
 extern std::shared_ptr<SensorDataCache> sensorDataCache;
 extern std::shared_ptr<ObservabilityManager> observability;
 extern std::shared_ptr<ObjectCache<creatureId_t, Creature>> creatureCache;
@@ -114,7 +114,7 @@ void DynamixelSensorReportHandler::processMessage(const oatpp::String &message)
 
         // Always forward the message to connected clients
         messageSpan->setAttribute("phase", "forwarding");
-        websocketOutgoingMessages->enqueue(message);
+        forwardToAllClients(message);
 
     } catch (const std::bad_cast &e) {
         auto errorMessage = fmt::format("Error (std::bad_cast) while processing dynamixel sensor report '{}': {}",
@@ -125,7 +125,7 @@ void DynamixelSensorReportHandler::processMessage(const oatpp::String &message)
         messageSpan->setAttribute("error.message", errorMessage);
 
         // Still forward message to clients even if parsing failed
-        websocketOutgoingMessages->enqueue(message);
+        forwardToAllClients(message);
     } catch (const std::exception &e) {
         auto errorMessage = fmt::format("Error (std::exception) while processing dynamixel sensor report '{}': {}",
                                         std::string(message), e.what());
@@ -135,7 +135,7 @@ void DynamixelSensorReportHandler::processMessage(const oatpp::String &message)
         messageSpan->setAttribute("error.message", errorMessage);
 
         // Still forward message to clients even if parsing failed
-        websocketOutgoingMessages->enqueue(message);
+        forwardToAllClients(message);
     } catch (...) {
         auto errorMessage =
             fmt::format("Unknown error while processing dynamixel sensor report '{}'", std::string(message));
@@ -144,7 +144,7 @@ void DynamixelSensorReportHandler::processMessage(const oatpp::String &message)
         messageSpan->setAttribute("error.type", "unknown");
 
         // Still forward message to clients even if parsing failed
-        websocketOutgoingMessages->enqueue(message);
+        forwardToAllClients(message);
     }
 }
 } // namespace creatures::ws
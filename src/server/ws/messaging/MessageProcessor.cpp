@@ -1,5 +1,7 @@
 
 
+#include <utility>
+
 #include <spdlog/spdlog.h>
 
 #include <oatpp/core/Types.hpp>
@@ -24,7 +26,9 @@ MessageProcessor::MessageProcessor() {
     handlers[toString(MessageType::Notice)] = std::make_unique<creatures::ws::NoticeMessageHandler>();
     appLogger->debug("added the handler for {}", toString(MessageType::Notice));
 
-    handlers[toString(MessageType::StreamFrame)] = std::make_unique<creatures::ws::StreamFrameHandler>();
+    auto streamFrames = std::make_unique<creatures::ws::StreamFrameHandler>();
+    streamFrameHandler = streamFrames.get();
+    handlers[toString(MessageType::StreamFrame)] = std::move(streamFrames);
     appLogger->debug("added the handler for {}", toString(MessageType::StreamFrame));
 
     handlers[toString(MessageType::BoardSensorReport)] = std::make_unique<creatures::ws::SensorReportHandler>();
@@ -52,4 +56,8 @@ void MessageProcessor::processIncomingMessage(const std::string &command, const
     }
 }
 
+void MessageProcessor::processBinaryStreamFrame(StreamSlots &slots, std::span<const uint8_t> message) {
+    streamFrameHandler->processBinaryFrame(slots, message);
+}
+
 } // namespace creatures::ws
\ No newline at end of file
@@ -1,25 +1,41 @@
 
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <span>
 #include <string>
 #include <unordered_map>
 
 #include <oatpp/core/Types.hpp>
 
+#include "BinaryStreamFrame.h"
 #include "IMessageHandler.h"
 
 namespace creatures ::ws {
 
+class StreamFrameHandler;
+
 class MessageProcessor {
 
   public:
     MessageProcessor();
     void processIncomingMessage(const std::string &command, const oatpp::String &message);
 
+    /**
+     * Handle a binary message, which is always a stream frame
+     *
+     * @param slots the slots the connection that sent it has bound
+     * @param message the whole message
+     */
+    void processBinaryStreamFrame(StreamSlots &slots, std::span<const uint8_t> message);
+
   private:
     std::unordered_map<std::string, std::unique_ptr<creatures::ws::IMessageHandler>> handlers;
+
+    // The stream frame handler in `handlers`, which binary frames go straight to
+    StreamFrameHandler *streamFrameHandler = nullptr;
 };
 
 } // namespace creatures::ws
\ No newline at end of file
@@ -10,9 +10,9 @@
 #include "server/sensors/SensorDataCache.h"
 #include "util/ObservabilityManager.h"
 #include "util/cache.h"
+#include "util/websocketUtils.h"
 
 namespace creatures {
-extern std::shared_ptr<moodycamel::BlockingConcurrentQueue<std::string>> websocketOutgoingMessages;
 extern std::shared_ptr<SensorDataCache> sensorDataCache;
 extern std::shared_ptr<ObservabilityManager> observability;
 extern std::shared_ptr<ObjectCache<creatureId_t, Creature>> creatureCache;
@@ -141,7 +141,7 @@ void SensorReportHandler::processMessage(const oatpp::String &message) {
 
         // Always forward the message to connected clients (original behavior)
         messageSpan->setAttribute("phase", "forwarding");
-        websocketOutgoingMessages->enqueue(message);
+        forwardToAllClients(message);
 
     } catch (const std::bad_cast &e) {
         auto errorMessage = fmt::format("Error (std::bad_cast) while processing sensor report '{}': {}",
@@ -152,7 +152,7 @@ void SensorReportHandler::processMessage(const oatpp::String &message) {
         messageSpan->setAttribute("error.message", errorMessage);
 
         // Still forward message to clients even if parsing failed
-        websocketOutgoingMessages->enqueue(message);
+        forwardToAllClients(message);
     } catch (const std::exception &e) {
         auto errorMessage = fmt::format("Error (std::exception) while processing sensor report '{}': {}",
                                         std::string(message), e.what());
@@ -162,7 +162,7 @@ void SensorReportHandler::processMessage(const oatpp::String &message) {
         messageSpan->setAttribute("error.message", errorMessage);
 
         // Still forward message to clients even if parsing failed
-        websocketOutgoingMessages->enqueue(message);
+        forwardToAllClients(message);
     } catch (...) {
         auto errorMessage = fmt::format("Unknown error while processing sensor report '{}'", std::string(message));
         appLogger->warn(errorMessage);
@@ -170,7 +170,7 @@ void SensorReportHandler::processMessage(const oatpp::String &message) {
         messageSpan->setAttribute("error.type", "unknown");
 
         // Still forward message to clients even if parsing failed
-        websocketOutgoingMessages->enqueue(message);
+        forwardToAllClients(message);
     }
 }
 } // namespace creatures::ws
\ No newline at end of file
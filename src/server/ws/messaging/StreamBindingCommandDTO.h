@@ -0,0 +1,48 @@
+#pragma once
+
+#include <oatpp/core/Types.hpp>
+#include <oatpp/core/macro/codegen.hpp>
+
+#include "server/ws/dto/websocket/WebSocketMessageDto.h"
+
+namespace creatures::ws {
+
+#include OATPP_CODEGEN_BEGIN(DTO)
+
+/**
+ * Which creature a slot in a binary stream frame's header stands for
+ */
+class StreamSlotDto : public oatpp::DTO {
+
+    DTO_INIT(StreamSlotDto, DTO)
+
+    DTO_FIELD_INFO(slot) {
+        info->description = "The slot number binary frames for this creature will carry (0-255)";
+        info->required = true;
+    }
+    DTO_FIELD(UInt32, slot);
+
+    DTO_FIELD_INFO(creature_id) {
+        info->description = "The creature to stream to";
+        info->required = true;
+    }
+    DTO_FIELD(String, creature_id);
+};
+
+class StreamBindingPayloadDto : public oatpp::DTO {
+
+    DTO_INIT(StreamBindingPayloadDto, DTO)
+
+    DTO_FIELD_INFO(slots) {
+        info->description = "Every slot this connection will stream to. An empty list turns binary frames off.";
+    }
+    DTO_FIELD(List<Object<StreamSlotDto>>, slots);
+};
+
+class StreamBindingCommandDTO : public WebSocketMessageDto<oatpp::Object<StreamBindingPayloadDto>> {
+
+    DTO_INIT(StreamBindingCommandDTO, WebSocketMessageDto<oatpp::Object<StreamBindingPayloadDto>>)
+};
+
+} // namespace creatures::ws
+#include OATPP_CODEGEN_END(DTO)
@@ -1,8 +1,12 @@
 
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <mutex>
 #include <optional>
+#include <span>
 #include <unordered_set>
 
 #include <oatpp/core/macro/component.hpp>
@@ -20,8 +24,10 @@
 #include "util/cache.h"
 #include "util/helpers.h"
 
+#include "BinaryStreamFrame.h"
 #include "StreamFrameCommandDTO.h"
 #include "StreamFrameHandler.h"
+#include "StreamingContexts.h"
 
 /**
  * This handler does a lot of heavy lifting. Streaming from the console is one of the most
@@ -46,40 +52,35 @@ extern std::shared_ptr<SessionManager> sessionManager;
 namespace creatures ::ws {
 
 namespace {
+// Guards the timeout bookkeeping below. A session's start (marking the creature as
+// streaming and opening its context) and its expiry also happen under it, so neither
+// sees half of the other.
 std::mutex streamingMutex;
-std::unordered_map<creatureId_t, framenum_t> streamingDeadlines;
 // Creatures with a StreamingTimeoutEvent already in flight. Frames arrive at 50Hz, so
 // scheduling an event per frame would leave dozens queued per creature — instead exactly
 // one event chases the (constantly extended) deadline per creature (issue #73).
 // (Which creatures are *streaming* lives in CreatureService's registry, where the
 // schedulers can see it — issue #74. Only the timeout bookkeeping lives here.)
 std::unordered_set<creatureId_t> timeoutEventPending;
-// When each streaming session started, so the session-end span can report a duration
-// (once per session — zero cost on the 50Hz frame path).
-std::unordered_map<creatureId_t, std::chrono::steady_clock::time_point> streamingStartedAt;
-
-void markStreamingStarted(const creatureId_t &creatureId) {
-    std::lock_guard<std::mutex> lock(streamingMutex);
-    streamingStartedAt[creatureId] = std::chrono::steady_clock::now();
-}
-
-void updateStreamingDeadline(const creatureId_t &creatureId, framenum_t deadline) {
-    std::lock_guard<std::mutex> lock(streamingMutex);
-    streamingDeadlines[creatureId] = deadline;
-}
-
-/// Returns true if the caller should schedule a new timeout event (none is in flight).
-bool markTimeoutEventPending(const creatureId_t &creatureId) {
-    std::lock_guard<std::mutex> lock(streamingMutex);
-    auto [it, inserted] = timeoutEventPending.insert(creatureId);
-    return inserted;
-}
+// What each creature being streamed to resolved to on its first frame, along with its
+// deadline and when its session started. Every frame after the first looks it up here
+// without taking streamingMutex and goes straight to the universe.
+StreamingContexts streamingContexts;
 
 void clearTimeoutEventPending(const creatureId_t &creatureId) {
     std::lock_guard<std::mutex> lock(streamingMutex);
     timeoutEventPending.erase(creatureId);
 }
 
+/// The frame a creature's stream times out on if nothing else arrives
+framenum_t nextStreamingDeadline() {
+    framenum_t streamingTimeoutFrames = DEFAULT_STREAMING_TIMEOUT_FRAMES;
+    if (creatures::config) {
+        streamingTimeoutFrames = creatures::config->getStreamingTimeoutFrames();
+    }
+    return eventLoop->getNextFrameNumber() + streamingTimeoutFrames;
+}
+
 /// The timeout event's atomic expire-or-chase decision. The deadline re-check and the
 /// bookkeeping teardown happen under one lock, so a frame that extends the deadline
 /// between the event firing and the teardown is never lost (it either moves us to
@@ -89,25 +90,37 @@ struct ExpiryDecision {
     Action action;
     framenum_t chaseDeadline{0};
     std::optional<std::chrono::steady_clock::time_point> startedAt{};
+    std::shared_ptr<StreamingContext> context{};
 };
 
 ExpiryDecision decideExpiry(const creatureId_t &creatureId, framenum_t eventFrame) {
     std::lock_guard<std::mutex> lock(streamingMutex);
-    auto it = streamingDeadlines.find(creatureId);
-    if (it == streamingDeadlines.end()) {
+    auto context = streamingContexts.find(creatureId);
+    if (!context) {
         timeoutEventPending.erase(creatureId);
         return {ExpiryDecision::Action::alreadyGone};
     }
-    if (it->second > eventFrame) {
-        return {ExpiryDecision::Action::chase, it->second};
+    const auto deadline = context->deadline.load(std::memory_order_acquire);
+    if (deadline > eventFrame) {
+        return {ExpiryDecision::Action::chase, deadline};
     }
 
-    ExpiryDecision decision{ExpiryDecision::Action::expired};
-    if (auto startIt = streamingStartedAt.find(creatureId); startIt != streamingStartedAt.end()) {
-        decision.startedAt = startIt->second;
-        streamingStartedAt.erase(startIt);
+    // Frames extend the deadline on the fast lane without this lock. If one got in since
+    // the check above, it wins and gets chased; once this succeeds, no frame can extend
+    // the context, so closing it can't cut off a stream that's still going.
+    if (!context->expire(deadline)) {
+        return {ExpiryDecision::Action::chase, context->deadline.load(std::memory_order_acquire)};
     }
-    streamingDeadlines.erase(it);
+
+    // The registry goes with the context, under the same lock the long way marks and opens
+    // under. A frame that shows up once this is done starts a whole new session, rather
+    // than finding the creature still marked as streaming and skipping the setup.
+    creatures::ws::CreatureService::clearStreaming(creatureId);
+    streamingContexts.close(context);
+
+    ExpiryDecision decision{ExpiryDecision::Action::expired};
+    decision.startedAt = context->startedAt;
+    decision.context = context;
     timeoutEventPending.erase(creatureId);
     return decision;
 }
@@ -139,12 +152,29 @@ class StreamingTimeoutEvent : public EventBase<StreamingTimeoutEvent> {
             return Result<framenum_t>{this->frameNumber};
         }
 
-        // Genuinely expired. Clear the registry FIRST: it's the load-bearing state. If
-        // any of the broadcast/idle work below throws, the event loop's catch swallows
-        // it — with the bookkeeping already cleared the next stream frame re-arms
-        // cleanly instead of leaving the creature permanently "streaming" with no
-        // timeout event ever scheduled again (security review, PR #75).
-        creatures::ws::CreatureService::clearStreaming(creatureId_);
+        // Genuinely expired, and decideExpiry() has already cleared the registry: it's the
+        // load-bearing state. If any of the broadcast/idle work below throws, the event
+        // loop's catch swallows it — with the bookkeeping already cleared the next stream
+        // frame re-arms cleanly instead of leaving the creature permanently "streaming"
+        // with no timeout event ever scheduled again (security review, PR #75).
+
+        // A frame came in since and started a new session. It's already said the creature's
+        // streaming, and going idle now would fight it; all that's left is to let go of the
+        // channels if it's moved off them.
+        if (const auto newer = streamingContexts.find(creatureId_)) {
+            const auto &ended = *decision.context;
+            if (newer->universe != ended.universe || newer->channelOffset != ended.channelOffset) {
+                DMXEvent::handOffSlots(DmxSource::Direct, ended.universe, ended.channelOffset, ended.channelCount);
+            }
+            info("Streaming to creature {} started again as it timed out at frame {}", creatureId_,
+                 this->frameNumber);
+            return Result<framenum_t>{this->frameNumber};
+        }
+
+        // Leave the creature where the console put it, but let go of its channels so
+        // idle (or a fixture pattern underneath) can have them
+        DMXEvent::handOffSlots(DmxSource::Direct, decision.context->universe, decision.context->channelOffset,
+                               decision.context->channelCount);
 
         // This fires once per streaming session, so a real (unsampled) span is cheap and
         // gives the session end a creature identity, a duration, and a parent for the
@@ -184,6 +214,8 @@ class StreamingTimeoutEvent : public EventBase<StreamingTimeoutEvent> {
 
 void StreamFrameHandler::processMessage(const oatpp::String &message) {
 
+    const auto received = std::chrono::steady_clock::now();
+
     // Create a sampling span for this high-frequency operation. createSamplingSpan
     // returns nullptr when ObservabilityManager is uninitialized, so all subsequent
     // dereferences need to be guarded.
@@ -203,10 +235,16 @@ void StreamFrameHandler::processMessage(const oatpp::String &message) {
                 messageSpan->setAttribute("phase", "processing");
             }
             StreamFrame frame = convertFromDto(dto->payload.getPtr() /*, messageSpan */); // This is super fast, no span
+            const auto frameData = decodeBase64(frame.data);
+
+#ifdef STREAM_FRAME_DEBUG
+            appLogger->debug("Requested frame data: {}", vectorToHexString(frameData));
+#endif
+
             if (messageSpan) {
                 messageSpan->setAttribute("phase", "streaming");
             }
-            stream(frame, messageSpan);
+            stream(frame.creature_id, frame.universe, frameData, received, messageSpan);
             if (messageSpan) {
                 messageSpan->setSuccess();
             }
@@ -247,31 +285,112 @@ void StreamFrameHandler::processMessage(const oatpp::String &message) {
     }
 }
 
-void StreamFrameHandler::stream(creatures::StreamFrame frame, std::shared_ptr<SamplingSpan> parentSpan) {
+void StreamFrameHandler::processBinaryFrame(StreamSlots &slots, std::span<const uint8_t> message) {
+
+    const auto received = std::chrono::steady_clock::now();
+
+    auto messageSpan = creatures::observability
+                           ? creatures::observability->createSamplingSpan("StreamFrameHandler.processBinaryFrame")
+                           : nullptr;
+
+    const auto decoded = readBinaryStreamFrame(message);
+    if (!decoded.isSuccess()) {
+        auto errorMessage = fmt::format("Dropping a binary stream frame: {}", decoded.getError()->getMessage());
+        appLogger->warn(errorMessage);
+        if (messageSpan) {
+            messageSpan->setError(errorMessage);
+            messageSpan->setAttribute("error.type", "InvalidData");
+            messageSpan->setAttribute("error.code", static_cast<int64_t>(ServerError::InvalidData));
+        }
+        return;
+    }
+    const auto frame = *decoded.getValue();
+
+    const auto *creatureId = slots.creatureIn(frame.slot);
+    if (!creatureId) {
+        auto errorMessage = fmt::format("Dropping a binary stream frame for slot {}, which isn't bound", frame.slot);
+        appLogger->warn(errorMessage);
+        if (messageSpan) {
+            messageSpan->setError(errorMessage);
+            messageSpan->setAttribute("error.type", "NotFound");
+            messageSpan->setAttribute("error.code", static_cast<int64_t>(ServerError::NotFound));
+        }
+        return;
+    }
+
+    // A frame that's older than one we've already streamed would only move the creature backwards
+    if (!slots.accept(frame.slot, frame.sequence)) {
+        appLogger->debug("Dropping stale binary stream frame {} for slot {}", frame.sequence, frame.slot);
+        return;
+    }
+
+    try {
+        stream(*creatureId, frame.universe, frame.channels, received, messageSpan);
+        if (messageSpan) {
+            messageSpan->setSuccess();
+        }
+    } catch (const std::exception &e) {
+        auto errorMessage = fmt::format("Error (std::exception) while streaming a binary frame to {}: {}",
+                                        *creatureId, e.what());
+        appLogger->warn(errorMessage);
+        if (messageSpan) {
+            messageSpan->recordException(e);
+            messageSpan->setAttribute("error.type", "std::exception");
+            messageSpan->setAttribute("error.message", errorMessage);
+        }
+    }
+}
+
+void StreamFrameHandler::stream(const creatureId_t &creatureId, universe_t universe, std::span<const uint8_t> channels,
+                                std::chrono::steady_clock::time_point received,
+                                std::shared_ptr<SamplingSpan> parentSpan) {
 
     // Use the parent sampling span instead of creating a child span for this high-frequency operation.
     // `span` may be nullptr if observability is uninitialized — guard every dereference.
     auto span = parentSpan;
 
+    // The fast lane. Once a creature's streaming, everything below has already been done for
+    // it: its playback was cancelled (and the schedulers won't start more while it streams),
+    // and its creature was resolved. All that's left is to push the deadline out and write
+    // its channels. If the timeout has just claimed the context, the frame takes the long way
+    // and opens a new one.
+    if (const auto context = streamingContexts.findCurrent(creatureId, universe);
+        context && channels.size() <= context->channelCount && context->extend(nextStreamingDeadline())) {
+        DMXEvent::writeSlots(DmxSource::Direct, universe, context->channelOffset, channels);
+        if (span) {
+            span->setAttribute("streaming.fast_lane", true);
+        }
+        countFrame(true, received, span);
+        return;
+    }
+
     appLogger->trace("Entered StreamFrameHandler::stream()");
+    if (span) {
+        span->setAttribute("streaming.fast_lane", false);
+    }
+
+    // Taken before the creature is resolved, so a change to it that lands in the meantime
+    // leaves the context out of date (and the next frame comes back this way) rather than
+    // stuck with the old creature
+    const auto generation = streamingContexts.currentGeneration();
 
     // Cancel any active playback on this universe for the targeted creature (live streaming takes priority)
-    creatures::sessionManager->cancelSessionsForCreatures(frame.universe, {frame.creature_id});
+    creatures::sessionManager->cancelSessionsForCreatures(universe, {creatureId});
     if (span) {
         span->setAttribute("streaming.preempted_session", true);
     }
 
     // Also stop any playlist state
-    auto playlistState = creatures::sessionManager->getPlaylistState(frame.universe);
+    auto playlistState = creatures::sessionManager->getPlaylistState(universe);
     if (playlistState == PlaylistState::Active || playlistState == PlaylistState::Interrupted) {
-        appLogger->info("Stopping playlist on universe {} for live streaming", frame.universe);
-        creatures::sessionManager->stopPlaylist(frame.universe);
+        appLogger->info("Stopping playlist on universe {} for live streaming", universe);
+        creatures::sessionManager->stopPlaylist(universe);
     }
 
     // Make sure this creature is in the cache
     std::shared_ptr<Creature> creature;
     try {
-        creature = creatureCache->get(frame.creature_id);
+        creature = creatureCache->get(creatureId);
         if (span) {
             span->setAttribute("creature_cache.hit", true);
         }
@@ -279,7 +398,7 @@ void StreamFrameHandler::stream(creatures::StreamFrame frame, std::shared_ptr<Sa
         if (span) {
             span->setAttribute("creature_cache.hit", false);
         }
-        appLogger->debug(" 🛜  creature {} was not found in the cache. Going to the DB...", frame.creature_id);
+        appLogger->debug(" 🛜  creature {} was not found in the cache. Going to the DB...", creatureId);
 
         // Create a child span specifically for the database fallback operation
         auto dbFallbackSpan =
@@ -288,14 +407,14 @@ void StreamFrameHandler::stream(creatures::StreamFrame frame, std::shared_ptr<Sa
                                                                      std::static_pointer_cast<OperationSpan>(span))
                 : nullptr;
         if (dbFallbackSpan) {
-            dbFallbackSpan->setAttribute("creature.id", frame.creature_id);
+            dbFallbackSpan->setAttribute("creature.id", creatureId);
             dbFallbackSpan->setAttribute("cache.result", std::string("miss"));
         }
 
-        auto result = db->getCreature(frame.creature_id, dbFallbackSpan);
+        auto result = db->getCreature(creatureId, dbFallbackSpan);
         if (!result.isSuccess()) {
             auto errorMessage = fmt::format("Dropping stream frame to {} because it can't be found: {}",
-                                            frame.creature_id, result.getError().value().getMessage());
+                                            creatureId, result.getError().value().getMessage());
             appLogger->warn(errorMessage);
             if (dbFallbackSpan) {
                 dbFallbackSpan->setError(errorMessage);
@@ -321,7 +440,7 @@ void StreamFrameHandler::stream(creatures::StreamFrame frame, std::shared_ptr<Sa
 
     // Make sure it's valid before we go on
     if (!creature) {
-        auto errorMessage = fmt::format("Creature {} was not found in the cache or the database", frame.creature_id);
+        auto errorMessage = fmt::format("Creature {} was not found in the cache or the database", creatureId);
         appLogger->warn(errorMessage);
         if (span) {
             span->setError(errorMessage);
@@ -331,21 +450,63 @@ void StreamFrameHandler::stream(creatures::StreamFrame frame, std::shared_ptr<Sa
         return;
     }
 
+    // Marking the creature as streaming and opening its context happen together under the
+    // lock the timeout expires under, so it sees either both or neither
+    auto startedAt = std::chrono::steady_clock::now();
+    auto channelCount = static_cast<uint16_t>(std::min<size_t>(channels.size(), UINT16_MAX));
+    const auto deadline = nextStreamingDeadline();
+    std::shared_ptr<StreamingContext> previous;
+    bool isNewSession = false;
+    bool needsTimeoutEvent = false;
+    {
+        std::lock_guard<std::mutex> lock(streamingMutex);
+
+        // A context the timeout has claimed belongs to the session that just ended, and the
+        // timeout hands its channels off itself
+        previous = streamingContexts.find(creatureId);
+        if (previous && previous->isClosed()) {
+            previous = nullptr;
+        }
+
+        isNewSession = creatures::ws::CreatureService::markStreamingIfNew(creatureId);
+        if (!isNewSession && previous) {
+            // Still the same session, just out of date
+            startedAt = previous->startedAt;
+        }
+
+        // Keep covering every channel the stream has driven here, so the timeout can hand
+        // them all off
+        if (previous && previous->universe == universe && previous->channelOffset == creature->channel_offset) {
+            channelCount = std::max(channelCount, previous->channelCount);
+        }
+
+        streamingContexts.open(creatureId, universe, creature->channel_offset, channelCount, generation, startedAt,
+                               deadline);
+
+        // One timeout event per creature: if one is already in flight it will chase the
+        // extended deadline itself when it fires (issue #73).
+        needsTimeoutEvent = timeoutEventPending.insert(creatureId).second;
+    }
+
+    // ...and let go of the channels it's moved away from
+    if (previous && (previous->universe != universe || previous->channelOffset != creature->channel_offset)) {
+        DMXEvent::handOffSlots(DmxSource::Direct, previous->universe, previous->channelOffset, previous->channelCount);
+    }
+
     // Mark runtime activity as streaming (only once per creature). Session start is a
     // once-per-session transition, so give it a real span — the sampled frame span is
     // null 99.95% of the time and would leave the activity write an orphan root.
-    if (creatures::ws::CreatureService::markStreamingIfNew(frame.creature_id)) {
-        markStreamingStarted(frame.creature_id);
+    if (isNewSession) {
         auto startSpan = creatures::observability
                              ? creatures::observability->createOperationSpan("StreamFrameHandler.streamingStarted")
                              : nullptr;
         if (startSpan) {
-            startSpan->setAttribute("creature.id", frame.creature_id);
+            startSpan->setAttribute("creature.id", creatureId);
             startSpan->setAttribute("creature.name", creature->name);
-            startSpan->setAttribute("streaming.universe", static_cast<int64_t>(frame.universe));
+            startSpan->setAttribute("streaming.universe", static_cast<int64_t>(universe));
         }
         creatures::ws::CreatureService::setActivityState(
-            {frame.creature_id}, "" /*animationId*/, creatures::runtime::ActivityReason::Streaming,
+            {creatureId}, "" /*animationId*/, creatures::runtime::ActivityReason::Streaming,
             creatures::runtime::ActivityState::Running, "" /*sessionId*/, startSpan);
         if (startSpan) {
             startSpan->setSuccess();
@@ -353,48 +514,26 @@ void StreamFrameHandler::stream(creatures::StreamFrame frame, std::shared_ptr<Sa
     }
 
     // Schedule a timeout to mark streaming stopped if frames stop arriving
-    framenum_t streamingTimeoutFrames = DEFAULT_STREAMING_TIMEOUT_FRAMES;
-    if (creatures::config) {
-        streamingTimeoutFrames = creatures::config->getStreamingTimeoutFrames();
-    }
-
-    auto deadline = eventLoop->getNextFrameNumber() + streamingTimeoutFrames;
-    updateStreamingDeadline(frame.creature_id, deadline);
-    // One timeout event per creature: if one is already in flight it will chase the
-    // extended deadline itself when it fires (issue #73).
-    if (markTimeoutEventPending(frame.creature_id)) {
-        auto timeoutEvent = std::make_shared<StreamingTimeoutEvent>(deadline, frame.creature_id);
+    if (needsTimeoutEvent) {
+        auto timeoutEvent = std::make_shared<StreamingTimeoutEvent>(deadline, creatureId);
         eventLoop->scheduleEvent(timeoutEvent);
     }
 
-    // appLogger->debug("Creature: {}, Offset: {}", creature->name, creature->channel_offset);
-
-    // Parse this out
-    auto frameData = decodeBase64(frame.data);
-
-#ifdef STREAM_FRAME_DEBUG
-    appLogger->debug("Requested frame data: {}", vectorToHexString(frameData));
-#endif
-
-    auto event = std::make_shared<DMXEvent>(eventLoop->getNextFrameNumber());
-    event->universe = frame.universe;
-    event->channelOffset = creature->channel_offset;
-    event->data.reserve(frameData.size());
-
-    // appLogger->debug("universe: {}, channelOffset: {}", event->universe, event->channelOffset);
-
-    for (uint8_t byte : frameData) {
-
-#ifdef STREAM_FRAME_DEBUG
-        trace("byte {}: 0x{:02x}", i++, byte);
-#endif
-        event->data.push_back(byte);
-    }
+    // Write straight into the universe rather than scheduling a DMXEvent for the next frame.
+    // The universe takes writes from any thread, and this saves an allocation and a copy per frame.
+    DMXEvent::writeSlots(DmxSource::Direct, universe, creature->channel_offset, channels);
+    countFrame(false, received, span);
+}
 
-    eventLoop->scheduleEvent(event);
+void StreamFrameHandler::countFrame(bool fastLane, std::chrono::steady_clock::time_point received,
+                                    const std::shared_ptr<SamplingSpan> &span) {
 
     // Update the global metrics
     metrics->incrementFramesStreamed();
+    metrics->recordStreamFrameLatency(
+        fastLane, static_cast<uint64_t>(
+                      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - received)
+                          .count()));
 
     // Keep some metrics internally
     framesStreamed += 1;
@@ -407,4 +546,6 @@ void StreamFrameHandler::stream(creatures::StreamFrame frame, std::shared_ptr<Sa
     }
 }
 
+void StreamFrameHandler::forgetStreamingContexts() { streamingContexts.invalidate(); }
+
 } // namespace creatures::ws
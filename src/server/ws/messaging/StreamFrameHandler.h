@@ -1,6 +1,10 @@
 
 #pragma once
 
+#include <chrono>
+#include <cstdint>
+#include <span>
+
 #include <oatpp/core/Types.hpp>
 #include <oatpp/core/macro/component.hpp>
 #include <oatpp/parser/json/mapping/ObjectMapper.hpp>
@@ -8,6 +12,7 @@
 #include "model/StreamFrame.h"
 #include "util/ObservabilityManager.h"
 
+#include "BinaryStreamFrame.h"
 #include "IMessageHandler.h"
 
 namespace creatures::ws {
@@ -17,13 +22,40 @@ class StreamFrameHandler : public IMessageHandler {
   public:
     void processMessage(const oatpp::String &payload) override;
 
+    /**
+     * Stream a binary stream frame (see BinaryStreamFrame.h). Nothing is allocated between
+     * reading the frame and writing it to the universe.
+     *
+     * @param slots the slots the connection that sent it has bound
+     * @param message the whole websocket message
+     */
+    void processBinaryFrame(StreamSlots &slots, std::span<const uint8_t> message);
+
+    /**
+     * The creatures have changed, so the next frame to each one being streamed to has to
+     * look its creature up again
+     */
+    static void forgetStreamingContexts();
+
   private:
     /**
      * Does the actual work of streaming a frame
      *
-     * @param frame the frame to stream
+     * @param creatureId the creature to stream to
+     * @param universe the universe it's on
+     * @param channels the creature's channels, starting at its channel offset
+     * @param received when the frame came in
+     */
+    void stream(const creatureId_t &creatureId, universe_t universe, std::span<const uint8_t> channels,
+                std::chrono::steady_clock::time_point received, std::shared_ptr<SamplingSpan> parentSpan);
+
+    /**
+     * Count a frame that's made it to the universe
+     *
+     * @param fastLane true if the creature's streaming context was already there
      */
-    void stream(StreamFrame frame, std::shared_ptr<SamplingSpan> parentSpan);
+    void countFrame(bool fastLane, std::chrono::steady_clock::time_point received,
+                    const std::shared_ptr<SamplingSpan> &span);
 
     OATPP_COMPONENT(std::shared_ptr<spdlog::logger>, appLogger);
     OATPP_COMPONENT(std::shared_ptr<oatpp::data::mapping::ObjectMapper>, apiObjectMapper);
@@ -0,0 +1,75 @@
+#include <utility>
+
+#include "server/ws/messaging/StreamingContexts.h"
+
+namespace creatures ::ws {
+
+StreamingContexts::StreamingContexts() { publishContexts(std::make_shared<const ContextMap>()); }
+
+std::shared_ptr<const StreamingContexts::ContextMap> StreamingContexts::loadContexts() const {
+#if defined(__cpp_lib_atomic_shared_ptr)
+    return contexts.load(std::memory_order_acquire);
+#else
+    return std::atomic_load_explicit(&contexts, std::memory_order_acquire);
+#endif
+}
+
+void StreamingContexts::publishContexts(std::shared_ptr<const ContextMap> next) {
+#if defined(__cpp_lib_atomic_shared_ptr)
+    contexts.store(std::move(next), std::memory_order_release);
+#else
+    std::atomic_store_explicit(&contexts, std::move(next), std::memory_order_release);
+#endif
+}
+
+std::shared_ptr<StreamingContext> StreamingContexts::findCurrent(const creatureId_t &creatureId,
+                                                                 universe_t universe) const {
+    auto context = find(creatureId);
+    if (!context || context->universe != universe || context->generation != currentGeneration()) {
+        return nullptr;
+    }
+    return context;
+}
+
+std::shared_ptr<StreamingContext> StreamingContexts::find(const creatureId_t &creatureId) const {
+    const auto current = loadContexts();
+    const auto found = current->find(creatureId);
+    return found != current->end() ? found->second : nullptr;
+}
+
+std::shared_ptr<StreamingContext> StreamingContexts::open(const creatureId_t &creatureId, universe_t universe,
+                                                          uint32_t channelOffset, uint16_t channelCount,
+                                                          uint64_t generation,
+                                                          std::chrono::steady_clock::time_point startedAt,
+                                                          framenum_t deadline) {
+    auto context = std::make_shared<StreamingContext>(creatureId, universe, channelOffset, channelCount, generation,
+                                                      startedAt, deadline);
+
+    std::lock_guard<std::mutex> lock(contextsMutex);
+    auto next = std::make_shared<ContextMap>(*loadContexts());
+    (*next)[creatureId] = context;
+    publishContexts(std::move(next));
+    return context;
+}
+
+bool StreamingContexts::close(const std::shared_ptr<StreamingContext> &context) {
+    std::lock_guard<std::mutex> lock(contextsMutex);
+
+    const auto current = loadContexts();
+    const auto found = current->find(context->creatureId);
+    if (found == current->end() || found->second != context) {
+        return false;
+    }
+    auto next = std::make_shared<ContextMap>(*current);
+    next->erase(context->creatureId);
+    publishContexts(std::move(next));
+    return true;
+}
+
+uint64_t StreamingContexts::currentGeneration() const { return currentGeneration_.load(std::memory_order_acquire); }
+
+void StreamingContexts::invalidate() { currentGeneration_.fetch_add(1, std::memory_order_acq_rel); }
+
+size_t StreamingContexts::size() const { return loadContexts()->size(); }
+
+} // namespace creatures::ws
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "server/namespace-stuffs.h"
+
+namespace creatures ::ws {
+
+/**
+ * Everything a streamed frame needs to know about its creature, worked out once when
+ * streaming to it starts
+ *
+ * Only the deadline changes after that. Anything else that changes (the creature's been
+ * edited, or the console moved it to another universe) gets it a new context.
+ *
+ * Frames extend the deadline without a lock, so the timeout claims the context with a
+ * compare-and-swap on the deadline it checked. Whichever of the two gets there first
+ * wins: either the frame's new deadline stands and the timeout chases it, or the context
+ * is closed and the frame takes the long way to open a new one.
+ */
+struct StreamingContext {
+    StreamingContext(creatureId_t creatureId_, universe_t universe_, uint32_t channelOffset_, uint16_t channelCount_,
+                     uint64_t generation_, std::chrono::steady_clock::time_point startedAt_, framenum_t deadline_)
+        : creatureId(std::move(creatureId_)), universe(universe_), channelOffset(channelOffset_),
+          channelCount(channelCount_), generation(generation_), startedAt(startedAt_), deadline(deadline_) {}
+
+    const creatureId_t creatureId;
+    const universe_t universe;
+    const uint32_t channelOffset;
+
+    // The most channels a frame has written, which the fast lane stays within
+    const uint16_t channelCount;
+
+    // Which version of the creature cache this was resolved against
+    const uint64_t generation;
+
+    // When this streaming session started, carried over when a context is replaced
+    const std::chrono::steady_clock::time_point startedAt;
+
+    // What the deadline is once the timeout has claimed the context
+    static constexpr framenum_t CLOSED = std::numeric_limits<framenum_t>::max();
+
+    // The frame streaming times out on unless another frame arrives first
+    std::atomic<framenum_t> deadline;
+
+    /**
+     * Push the deadline out for a frame that's just arrived
+     *
+     * @return false if the timeout has already claimed this context
+     */
+    bool extend(framenum_t nextDeadline) {
+        auto current = deadline.load(std::memory_order_relaxed);
+        while (current != CLOSED) {
+            if (deadline.compare_exchange_weak(current, nextDeadline, std::memory_order_release,
+                                               std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Claim the context for the timeout, as long as nothing has extended it since
+     *
+     * @param checkedDeadline the deadline the timeout found had passed
+     * @return false if a frame pushed the deadline out in the meantime
+     */
+    bool expire(framenum_t checkedDeadline) {
+        return deadline.compare_exchange_strong(checkedDeadline, CLOSED, std::memory_order_acq_rel,
+                                                std::memory_order_acquire);
+    }
+
+    [[nodiscard]] bool isClosed() const { return deadline.load(std::memory_order_acquire) == CLOSED; }
+};
+
+/**
+ * The creatures being streamed to, for the frames that follow the first
+ *
+ * Looking a context up never waits on a writer: the contexts are published as an immutable
+ * map that's copied and swapped whenever a creature starts or stops streaming, which happens
+ * far less often than the 50 Hz a frame arrives at. Loading the map's pointer isn't quite
+ * lock-free, though. libstdc++ guards std::atomic<std::shared_ptr> with a spin bit, and
+ * std::atomic_load with a pool of mutexes, but either is only held while the pointer is
+ * copied, never while a writer builds the next map.
+ */
+class StreamingContexts {
+  public:
+    StreamingContexts();
+
+    /**
+     * The context for a creature, if it's streaming on this universe and its creature
+     * hasn't changed since the context was made
+     *
+     * @return the context, or nullptr if the frame has to take the long way
+     */
+    [[nodiscard]] std::shared_ptr<StreamingContext> findCurrent(const creatureId_t &creatureId,
+                                                                universe_t universe) const;
+
+    /**
+     * The context for a creature, current or not
+     *
+     * @return the context, or nullptr if the creature isn't streaming
+     */
+    [[nodiscard]] std::shared_ptr<StreamingContext> find(const creatureId_t &creatureId) const;
+
+    /**
+     * @return the creatures' current generation. Read it before resolving the creature a
+     *         context is made from, so a change that lands in between isn't missed.
+     */
+    [[nodiscard]] uint64_t currentGeneration() const;
+
+    /**
+     * Make (or replace) a creature's context
+     *
+     * @param channelCount how many channels the stream drives from channelOffset
+     * @param generation what currentGeneration() was before the creature was resolved
+     * @param startedAt when the streaming session started
+     * @param deadline the frame streaming times out on
+     * @return the new context
+     */
+    std::shared_ptr<StreamingContext> open(const creatureId_t &creatureId, universe_t universe,
+                                           uint32_t channelOffset, uint16_t channelCount, uint64_t generation,
+                                           std::chrono::steady_clock::time_point startedAt, framenum_t deadline);
+
+    /**
+     * Forget a creature's context when streaming to it stops
+     *
+     * @param context the context that timed out
+     * @return false if it had already been replaced by a newer one, which is left alone
+     */
+    bool close(const std::shared_ptr<StreamingContext> &context);
+
+    /**
+     * The creatures have changed, so every context has to be worked out again on its next frame
+     */
+    void invalidate();
+
+    /**
+     * @return how many creatures have a context
+     */
+    [[nodiscard]] size_t size() const;
+
+  private:
+    using ContextMap = std::unordered_map<creatureId_t, std::shared_ptr<StreamingContext>>;
+
+#if defined(__cpp_lib_atomic_shared_ptr)
+    std::atomic<std::shared_ptr<const ContextMap>> contexts;
+#else
+    std::shared_ptr<const ContextMap> contexts;
+#endif
+
+    // Serializes the writers that republish the map
+    std::mutex contextsMutex;
+
+    std::atomic<uint64_t> currentGeneration_{0};
+
+    std::shared_ptr<const ContextMap> loadContexts() const;
+    void publishContexts(std::shared_ptr<const ContextMap> next);
+};
+
+} // namespace creatures::ws
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <oatpp/core/Types.hpp>
+#include <oatpp/core/macro/codegen.hpp>
+
+#include "server/ws/dto/websocket/WebSocketMessageDto.h"
+
+namespace creatures::ws {
+
+#include OATPP_CODEGEN_BEGIN(DTO)
+
+/**
+ * One topic a client wants (or no longer wants). Any filter left out matches everything.
+ */
+class TopicDto : public oatpp::DTO {
+
+    DTO_INIT(TopicDto, DTO)
+
+    DTO_FIELD_INFO(type) { info->description = "The message command to subscribe to, such as \"log\""; }
+    DTO_FIELD(String, type);
+
+    DTO_FIELD_INFO(creature_id) { info->description = "Only messages about this creature"; }
+    DTO_FIELD(String, creature_id);
+
+    DTO_FIELD_INFO(universe) { info->description = "Only messages about this universe"; }
+    DTO_FIELD(UInt32, universe);
+
+    DTO_FIELD_INFO(log_level) { info->description = "Only log messages at this level or above"; }
+    DTO_FIELD(String, log_level);
+};
+
+class SubscriptionPayloadDto : public oatpp::DTO {
+
+    DTO_INIT(SubscriptionPayloadDto, DTO)
+
+    DTO_FIELD(List<Object<TopicDto>>, topics);
+};
+
+class SubscriptionCommandDTO : public WebSocketMessageDto<oatpp::Object<SubscriptionPayloadDto>> {
+
+    DTO_INIT(SubscriptionCommandDTO, WebSocketMessageDto<oatpp::Object<SubscriptionPayloadDto>>)
+};
+
+} // namespace creatures::ws
+#include OATPP_CODEGEN_END(DTO)
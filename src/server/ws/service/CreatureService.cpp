@@ -17,6 +17,7 @@
 
 #include "exception/exception.h"
 #include "model/Creature.h"
+#include "server/animation/PlaylistPrefetcher.h"
 #include "server/animation/SessionManager.h"
 #include "server/animation/player.h"
 #include "server/config.h"
@@ -32,6 +33,8 @@
 #include "server/ws/dto/ListDto.h"
 #include "server/ws/dto/websocket/CreatureActivityMessage.h"
 #include "server/ws/dto/websocket/MessageTypes.h"
+#include "server/ws/websocket/OutgoingMessage.h"
+#include "server/ws/websocket/TopicSubscriptions.h"
 #include "util/JsonParser.h"
 #include "util/ObservabilityManager.h" // Include ObservabilityManager
 #include "util/helpers.h"
@@ -43,10 +46,11 @@ namespace creatures {
 extern std::shared_ptr<Database> db;
 extern std::shared_ptr<ObservabilityManager> observability; // Declare observability extern
 extern std::shared_ptr<ObjectCache<creatureId_t, universe_t>> creatureUniverseMap;
-extern std::shared_ptr<moodycamel::BlockingConcurrentQueue<std::string>> websocketOutgoingMessages;
+extern std::shared_ptr<moodycamel::BlockingConcurrentQueue<ws::OutgoingMessage>> websocketOutgoingMessages;
 extern std::shared_ptr<EventLoop> eventLoop;
 extern std::shared_ptr<SessionManager> sessionManager;
 extern std::shared_ptr<ObjectCache<creatureId_t, Creature>> creatureCache;
+extern std::shared_ptr<PlaylistPrefetcher> playlistPrefetcher;
 extern FixtureActivityHook fixtureActivityHook;
 } // namespace creatures
 
@@ -135,8 +139,10 @@ void broadcastIdleStateChanged(const std::string &creatureId, bool enabled) {
         warn("CreatureService: websocket queue unavailable, skipping idle state broadcast for {}", creatureId);
         return;
     }
+    if (!creatures::ws::anyoneSubscribedTo(creatures::ws::MessageType::IdleStateChanged)) {
+        return;
+    }
 
-    auto jsonMapper = oatpp::parser::json::mapping::ObjectMapper::createShared();
     auto msg = creatures::ws::IdleStateChangedMessage::createShared();
     msg->command = toString(creatures::ws::MessageType::IdleStateChanged).c_str();
 
@@ -146,7 +152,8 @@ void broadcastIdleStateChanged(const std::string &creatureId, bool enabled) {
     payload->timestamp = getCurrentTimeISO8601();
     msg->payload = payload;
 
-    creatures::websocketOutgoingMessages->enqueue(jsonMapper->writeToString(msg));
+    creatures::websocketOutgoingMessages->enqueue(
+        creatures::ws::serializeForClients(creatures::ws::MessageType::IdleStateChanged, msg));
 }
 
 /**
@@ -166,7 +173,9 @@ void broadcastCreatureActivitySnapshot(const std::string &creatureId, const Acti
         warn("CreatureService: websocket queue unavailable, skipping activity broadcast for {}", creatureId);
         return;
     }
-    auto jsonMapper = oatpp::parser::json::mapping::ObjectMapper::createShared();
+    if (!creatures::ws::anyoneSubscribedTo(creatures::ws::MessageType::CreatureActivity)) {
+        return;
+    }
     auto msg = creatures::ws::CreatureActivityMessage::createShared();
     msg->command = toString(creatures::ws::MessageType::CreatureActivity).c_str();
 
@@ -180,7 +189,8 @@ void broadcastCreatureActivitySnapshot(const std::string &creatureId, const Acti
     payload->timestamp = getCurrentTimeISO8601();
 
     msg->payload = payload;
-    creatures::websocketOutgoingMessages->enqueue(jsonMapper->writeToString(msg));
+    creatures::websocketOutgoingMessages->enqueue(
+        creatures::ws::serializeForClients(creatures::ws::MessageType::CreatureActivity, msg));
 }
 
 void broadcastCreatureActivity(const std::string &creatureId, const oatpp::Object<creatures::CreatureRuntimeDto> &rt) {
@@ -1010,6 +1020,19 @@ bool CreatureService::startIdleIfNeeded(const creatureId_t &creatureId, std::sha
         return false;
     }
 
+    // Picking the animation reads the database, which the event loop can't wait on. A
+    // worker does it instead, checking all of the above again when it gets there.
+    if (EventLoop::onLoopThread()) {
+        if (!creatures::playlistPrefetcher) {
+            warn("CreatureService: no workers to start idle for {} on", creatureId);
+            return false;
+        }
+        creatures::playlistPrefetcher->runInBackground(fmt::format("idle:{}", creatureId), [creatureId, parentSpan] {
+            startIdleIfNeeded(creatureId, parentSpan);
+        });
+        return true;
+    }
+
     Creature creature;
     bool creatureLoaded = false;
     if (creatures::creatureCache && creatures::creatureCache->contains(creatureId)) {
@@ -120,7 +120,10 @@ class CreatureService {
     /**
      * Start idle playback for a creature if it's idle-enabled and available.
      *
-     * @return true if an idle animation was scheduled
+     * On the event loop this only hands the work to the playlist prefetcher's
+     * workers, since choosing an idle animation reads the database.
+     *
+     * @return true if an idle animation was scheduled (or handed off to be)
      */
     static bool startIdleIfNeeded(const creatureId_t &creatureId, std::shared_ptr<OperationSpan> parentSpan = nullptr);
 
@@ -3,6 +3,7 @@
 #include <string>
 
 #include "model/Playlist.h"
+#include "server/animation/PlaylistPrefetcher.h"
 #include "server/animation/SessionManager.h"
 #include "server/database.h"
 #include "server/eventloop/eventloop.h"
@@ -23,6 +24,7 @@ extern std::shared_ptr<EventLoop> eventLoop;
 extern std::shared_ptr<SystemCounters> metrics;
 extern std::shared_ptr<ObservabilityManager> observability;
 extern std::shared_ptr<SessionManager> sessionManager;
+extern std::shared_ptr<PlaylistPrefetcher> playlistPrefetcher;
 } // namespace creatures
 
 namespace creatures ::ws {
@@ -409,6 +411,11 @@ oatpp::Object<creatures::ws::StatusDto> PlaylistService::startPlaylist(universe_
     }
     OATPP_ASSERT_HTTP(!error, status, errorMessage)
 
+    // Start loading the first item now so it's (hopefully) ready when the event runs
+    if (playlistPrefetcher) {
+        playlistPrefetcher->request(universe, playlistId);
+    }
+
     auto playEvent = std::make_shared<PlaylistEvent>(eventLoop->getNextFrameNumber(), universe);
     eventLoop->scheduleEvent(playEvent);
 
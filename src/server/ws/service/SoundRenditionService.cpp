@@ -6,6 +6,7 @@
 #include "server/audio/Mp3Writer.h"
 #include "server/audio/OggOpusWriter.h"
 #include "server/voice/IxmlReader.h"
+#include "util/ComputePool.h"
 
 namespace creatures::ws {
 
@@ -160,11 +161,14 @@ SoundRenditionService::renderMonoPcm(const std::vector<int16_t> &samples, int sa
                                      const creatures::voice::WavProvenance &provenance, SoundRenditionFormat format,
                                      const std::string &artistOverride) const {
     const auto comments = provenanceTags(provenance, artistOverride);
-    creatures::Result<std::vector<uint8_t>> encoded =
-        format == SoundRenditionFormat::Mp3
-            ? creatures::audio::encodeMonoToMp3(samples, sampleRate, creatures::audio::kShareableMp3Bitrate, comments)
-            : creatures::audio::encodeMonoToOggOpus(samples, sampleRate, creatures::audio::kShareableOpusBitrate,
-                                                    comments);
+    // On the compute pool, so a burst of downloads can't take over the cores playback needs
+    creatures::Result<std::vector<uint8_t>> encoded = creatures::util::ComputePool::shared()->run([&] {
+        return format == SoundRenditionFormat::Mp3
+                   ? creatures::audio::encodeMonoToMp3(samples, sampleRate, creatures::audio::kShareableMp3Bitrate,
+                                                       comments)
+                   : creatures::audio::encodeMonoToOggOpus(samples, sampleRate,
+                                                           creatures::audio::kShareableOpusBitrate, comments);
+    });
     if (!encoded.isSuccess()) {
         return creatures::Result<SoundRendition>{encoded.getError().value()};
     }
@@ -178,7 +182,8 @@ SoundRenditionService::renderMonoPcm(const std::vector<int16_t> &samples, int sa
 creatures::Result<SoundRendition> SoundRenditionService::renderWav(const std::filesystem::path &wavPath,
                                                                    SoundRenditionFormat format,
                                                                    const MetadataProvider &fallback) const {
-    auto mono = creatures::audio::loadWavAsMono(wavPath.string());
+    auto mono = creatures::util::ComputePool::shared()->run(
+        [&wavPath] { return creatures::audio::loadWavAsMono(wavPath.string()); });
     if (!mono.isSuccess()) {
         return creatures::Result<SoundRendition>{mono.getError().value()};
     }
@@ -1,5 +1,6 @@
 
 #include <algorithm>
+#include <cmath>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -15,8 +16,11 @@
 #include "server/eventloop/eventloop.h"
 #include "server/eventloop/events/types.h"
 
+#include "server/audio/NativeAudioConfig.h"
 #include "server/audio/SoundPathResolver.h"
 #include "server/config/Configuration.h"
+#include "server/rtp/RtpMixSource.h"
+#include "server/rtp/RtpMixer.h"
 #include "server/storage/Storage.h"
 #include "server/voice/IxmlReader.h"
 
@@ -39,6 +43,7 @@ extern std::shared_ptr<creatures::Configuration> config;
 extern std::shared_ptr<EventLoop> eventLoop;
 extern std::shared_ptr<ObservabilityManager> observability;
 extern std::shared_ptr<Database> db;
+extern std::shared_ptr<rtp::RtpMixer> rtpMixer;
 } // namespace creatures
 
 namespace fs = std::filesystem;
@@ -464,10 +469,14 @@ oatpp::Object<creatures::SoundDto> SoundService::buildSoundMetadata(const std::s
  * Admit an ad-hoc sound for playback.
  *
  * RTP keeps its single reserved MusicEvent because frame dispatch belongs on
- * the event loop. Local/travel playback goes straight to the one-slot audio
- * coordinator so HTTP floods cannot accumulate on the sacred 1 ms queue.
+ * the event loop. With the RTP mixer on, a WAV is added to the mix instead of
+ * taking the output over. Local/travel playback goes straight to the one-slot
+ * audio coordinator so HTTP floods cannot accumulate on the sacred 1 ms queue.
  */
 oatpp::Object<creatures::ws::StatusDto> SoundService::playSound(const oatpp::String &inSoundFile,
+                                                                const oatpp::String &mixRole,
+                                                                const oatpp::Float32 &gainDb,
+                                                                const oatpp::Int32 &channel,
                                                                 std::shared_ptr<RequestSpan> parentSpan) {
     OATPP_COMPONENT(std::shared_ptr<spdlog::logger>, appLogger);
     auto logger = appLogger ? appLogger : spdlog::default_logger();
@@ -517,7 +526,56 @@ oatpp::Object<creatures::ws::StatusDto> SoundService::playSound(const oatpp::Str
         }
 
         oatpp::String message;
-        if (rtpMode) {
+        if (rtpMode && rtpMixer) {
+            OATPP_ASSERT_HTTP(eventLoop, Status::CODE_500, "Sound event loop unavailable");
+            OATPP_ASSERT_HTTP(extension == ".wav", Status::CODE_400, "The RTP mixer only plays WAV files");
+            OATPP_ASSERT_HTTP(rtpMixer->getTrackCount() < RTP_MIXER_MAX_TRACKS, Status::CODE_409,
+                              "The RTP mixer is already playing as many sounds as it can");
+
+            rtp::RtpMixTrackOptions options;
+            options.name = soundFile;
+            const std::string role = mixRole ? std::string(mixRole) : std::string("program");
+            if (role == "dialog") {
+                options.role = rtp::RtpMixRole::Dialog;
+            } else if (role == "bed") {
+                options.role = rtp::RtpMixRole::Bed;
+            } else {
+                OATPP_ASSERT_HTTP(role == "program", Status::CODE_400, "mix_role must be program, dialog, or bed");
+            }
+            if (gainDb) {
+                OATPP_ASSERT_HTTP(std::isfinite(*gainDb) && *gainDb >= audio::MIN_AUDIO_GAIN_DB &&
+                                      *gainDb <= audio::MAX_AUDIO_GAIN_DB,
+                                  Status::CODE_400, "gain_db must be between -90 and +12");
+                options.gainDb = *gainDb;
+            }
+            if (channel) {
+                OATPP_ASSERT_HTTP(*channel >= 0 && *channel < RTP_STREAMING_CHANNELS, Status::CODE_400,
+                                  fmt::format("channel must be between 0 and {}", RTP_STREAMING_CHANNELS - 1).c_str());
+                options.channel = static_cast<uint8_t>(*channel);
+            }
+
+            auto source = rtp::openWavMixSource(fullFilePath);
+            if (!source.isSuccess()) {
+                const auto error = source.getError().value();
+                const auto status = error.getCode() == ServerError::InvalidData ? Status::CODE_400 : Status::CODE_500;
+                OATPP_ASSERT_HTTP(false, status, error.getMessage().c_str());
+            }
+
+            rtp::AsyncAudioTraceContext traceContext;
+            traceContext.triggerTraceId = serviceSpan ? serviceSpan->getTraceIdHex() : std::string{};
+            traceContext.triggerSpanId = serviceSpan ? serviceSpan->getSpanIdHex() : std::string{};
+            traceContext.soundFile = soundFile;
+
+            const framenum_t frameNumber = eventLoop->getNextFrameNumber();
+            eventLoop->scheduleEvent(std::make_shared<RtpMixerTrackEvent>(frameNumber, source.getValue().value(),
+                                                                          std::move(options), traceContext));
+            if (serviceSpan) {
+                serviceSpan->setAttribute("audio.admission.result", "mixed");
+                serviceSpan->setAttribute("audio.mix.role", role);
+                serviceSpan->setAttribute("event.frame_number", static_cast<int64_t>(frameNumber));
+            }
+            message = fmt::format("Mixing {} in from frame {}", soundFile, frameNumber);
+        } else if (rtpMode) {
             OATPP_ASSERT_HTTP(eventLoop, Status::CODE_500, "Sound event loop unavailable");
             auto rtpReservation = rtp::standaloneRtpAdmission().tryAcquire();
             OATPP_ASSERT_HTTP(rtpReservation, Status::CODE_409, "Standalone RTP audio loader is busy");
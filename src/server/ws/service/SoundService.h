@@ -59,9 +59,15 @@ class SoundService {
      * Play a sound file for testing
      *
      * @param soundFile
+     * @param mixRole with the RTP mixer on, how the sound sits in the mix ("program" if null)
+     * @param gainDb with the RTP mixer on, the sound's gain in the mix (0 dB if null)
+     * @param channel with the RTP mixer on, the channel a mono sound plays on (BGM if null)
      * @return
      */
     oatpp::Object<creatures::ws::StatusDto> playSound(const oatpp::String &soundFile,
+                                                      const oatpp::String &mixRole = nullptr,
+                                                      const oatpp::Float32 &gainDb = nullptr,
+                                                      const oatpp::Int32 &channel = nullptr,
                                                       std::shared_ptr<RequestSpan> parentSpan = nullptr);
 
     /**
@@ -1,5 +1,7 @@
 
+#include <algorithm>
 #include <mutex>
+#include <optional>
 
 #include <spdlog/spdlog.h>
 
@@ -8,15 +10,18 @@
 #include "blockingconcurrentqueue.h"
 
 #include "server/metrics/counters.h"
+#include "server/ws/dto/websocket/MessageTypes.h"
 #include "server/ws/messaging/MessageProcessor.h"
 #include "server/ws/websocket/ClientCafe.h"
 #include "server/ws/websocket/ClientConnection.h"
+#include "server/ws/websocket/OutgoingMessage.h"
+#include "server/ws/websocket/TopicSubscriptions.h"
 
 #include "util/threadName.h"
 
 namespace creatures {
 extern std::shared_ptr<SystemCounters> metrics;
-extern std::shared_ptr<moodycamel::BlockingConcurrentQueue<std::string>> websocketOutgoingMessages;
+extern std::shared_ptr<moodycamel::BlockingConcurrentQueue<ws::OutgoingMessage>> websocketOutgoingMessages;
 } // namespace creatures
 
 #define DEBUG_WS_LOGGING 0
@@ -25,18 +30,44 @@ namespace creatures ::ws {
 
 std::atomic<v_int32> ClientCafe::clientsConnected(0);
 
-void ClientCafe::broadcastMessage(const std::string &message) {
+void ClientCafe::broadcastMessage(const OutgoingMessage &message) {
 
 #if DEBUG_WS_LOGGING
     appLogger->debug("Broadcasting message to all clients");
 #endif
 
+    if (!message.json) {
+        return;
+    }
+
+    MessageTopic topic{message.type, std::nullopt, std::nullopt, std::nullopt};
+
+    // This only queues the message on each client, so a slow one can't hold up the rest
     std::lock_guard<std::mutex> guard(clientConnectionMapMutex);
+
+    // Only look inside the message if someone's filtering on what's in it
+    if (topic.type && std::any_of(clientConnectionMap.begin(), clientConnectionMap.end(),
+                                  [&topic](const auto &client) { return client.second->needsDetails(*topic.type); })) {
+        addTopicDetails(topic, *message.json);
+    }
+
     for (const auto &client : clientConnectionMap) {
-        client.second->sendTextMessage(message);
+        if (client.second->wants(topic)) {
+            client.second->sendTextMessage(topic.type, message.json);
+        }
     }
 }
 
+void ClientCafe::refreshTopicInterest() {
+    std::lock_guard<std::mutex> guard(clientConnectionMapMutex);
+
+    TopicInterest interest;
+    for (const auto &client : clientConnectionMap) {
+        client.second->addInterestTo(interest);
+    }
+    interest.publish();
+}
+
 v_int64 ClientCafe::getNextClientId() { return clientIdCounter++; }
 
 void ClientCafe::onAfterCreate(const oatpp::websocket::WebSocket &socket,
@@ -56,6 +87,9 @@ void ClientCafe::onAfterCreate(const oatpp::websocket::WebSocket &socket,
         clientConnectionMap[clientId] = client;
     }
 
+    // It gets everything until it subscribes to something
+    refreshTopicInterest();
+
     // Create a new client connection for this socket
     socket.setListener(client);
 
@@ -77,6 +111,10 @@ void ClientCafe::onBeforeDestroy(const oatpp::websocket::WebSocket &socket) {
         std::lock_guard<std::mutex> guard(clientConnectionMapMutex);
         clientConnectionMap.erase(client->clientId);
     }
+    refreshTopicInterest();
+
+    // The socket's about to go away, so its writer has to stop first
+    client->stopSending();
 }
 
 void ClientCafe::runMessageLoop() {
@@ -84,7 +122,7 @@ void ClientCafe::runMessageLoop() {
     // Make sure this shows up in the debugger correctly
     setThreadName("ClientCafe::runMessageLoop");
 
-    std::string message;
+    OutgoingMessage message;
     while (!shutdownRequested.load()) {
         // Use wait_dequeue_timed instead of wait_dequeue to allow checking shutdown flag
         if (creatures::websocketOutgoingMessages->wait_dequeue_timed(message, std::chrono::milliseconds(100))) {
@@ -122,11 +160,10 @@ void ClientCafe::runPingLoop(const std::chrono::duration<v_int64, std::micro> &i
 
         // Only send pings if not shutting down
         if (!shutdownRequested.load()) {
-            // Keep the scope tight on this lock
+            // This only queues the pings, so it's quick even with a slow client connected
             std::lock_guard<std::mutex> lock(clientConnectionMapMutex);
             for (const auto &client : clientConnectionMap) {
                 client.second->sendPing();
-                metrics->incrementWebsocketPingsSent();
             }
         }
     }
@@ -11,6 +11,7 @@
 #include <oatpp/core/macro/component.hpp>
 
 #include "server/ws/websocket/ClientConnection.h"
+#include "server/ws/websocket/OutgoingMessage.h"
 
 namespace creatures ::ws {
 
@@ -29,9 +30,15 @@ class ClientCafe : public oatpp::websocket::ConnectionHandler::SocketInstanceLis
     virtual ~ClientCafe() {};
 
     /**
-     * Broadcast a message to all connected clients
+     * Broadcast a message to all connected clients that want it. They all share the one copy.
      */
-    void broadcastMessage(const std::string &message);
+    void broadcastMessage(const OutgoingMessage &message);
+
+    /**
+     * Work out what every client is subscribed to and publish it for whoever builds
+     * messages. Call this whenever a client comes, goes, or changes its subscriptions.
+     */
+    void refreshTopicInterest();
 
     /**
      * Gets the next client ID
@@ -1,10 +1,20 @@
 
+#include <cstdint>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sys/socket.h>
 
 #include <fmt/format.h>
+#include <fmt/ranges.h>
 #include <spdlog/spdlog.h>
 
+#include <oatpp-websocket/Frame.hpp>
 #include <oatpp-websocket/WebSocket.hpp>
 #include <oatpp/core/macro/component.hpp>
+#include <oatpp/network/tcp/Connection.hpp>
 
 #include "model/Notice.h"
 
@@ -14,8 +24,11 @@
 #include "server/ws/dto/websocket/WebSocketMessageDto.h"
 #include "server/ws/messaging/BasicCommandDto.h"
 #include "server/ws/messaging/MessageProcessor.h"
+#include "server/ws/messaging/StreamBindingCommandDTO.h"
+#include "server/ws/messaging/SubscriptionCommandDTO.h"
 #include "server/ws/websocket/ClientCafe.h"
 #include "server/ws/websocket/ClientConnection.h"
+#include "server/ws/websocket/OutgoingMessage.h"
 
 #include "util/helpers.h"
 
@@ -25,36 +38,182 @@ extern std::shared_ptr<SystemCounters> metrics;
 
 namespace creatures ::ws {
 
-void ClientConnection::sendTextMessage(const std::string &message) {
+void ClientConnection::sendTextMessage(std::optional<MessageType> type, std::shared_ptr<const std::string> message) {
+    switch (outbox.offer(type, std::move(message))) {
+    case ClientOutbox::Offer::Coalesced:
+        metrics->incrementWebsocketMessagesCoalesced();
+        break;
+    case ClientOutbox::Offer::Dropped:
+        metrics->incrementWebsocketMessagesDropped();
+        break;
+    case ClientOutbox::Offer::TooFarBehind:
+        metrics->incrementWebsocketSlowClientHangups();
+        break;
+    default:
+        break;
+    }
+}
+
+void ClientConnection::stopSending() { outbox.stop(); }
+
+bool ClientConnection::wants(const MessageTopic &topic) {
+    std::lock_guard lock(subscriptionsMutex);
+    return subscriptions.wants(topic);
+}
+
+bool ClientConnection::needsDetails(MessageType type) {
+    std::lock_guard lock(subscriptionsMutex);
+    return subscriptions.needsDetails(type);
+}
+
+void ClientConnection::addInterestTo(TopicInterest &interest) {
+    std::lock_guard lock(subscriptionsMutex);
+    interest.include(subscriptions);
+}
+
+/**
+ * The payload's a list of topics, each with a type and any filters:
+ *
+ *   {"command": "subscribe", "payload": {"topics": [{"type": "log", "log_level": "warning"},
+ *                                                   {"type": "creature-activity", "creature_id": "..."}]}}
+ *
+ * Unsubscribing drops every subscription to each type listed, whatever its filters.
+ */
+void ClientConnection::updateSubscriptions(MessageType command, const oatpp::String &message) {
+    auto permissiveJsonMapper = oatpp::parser::json::mapping::ObjectMapper::createShared();
+    permissiveJsonMapper->getDeserializer()->getConfig()->allowUnknownFields = true;
+    const auto dto = permissiveJsonMapper->readFromString<oatpp::Object<SubscriptionCommandDTO>>(message);
+
+    oatpp::Object<SubscriptionPayloadDto> payload;
+    if (dto) {
+        payload = dto->payload;
+    }
+
+    const auto requests = topicRequestsFromDto(payload);
+    if (!requests.isSuccess()) {
+        const auto error = requests.getError()->getMessage();
+        appLogger->warn("Client {} sent a bad {}: {}", clientId, toString(command), error);
+        sendNotice(fmt::format("Unable to {}: {}", toString(command), error));
+        return;
+    }
+
+    const auto topicRequests = requests.getValue().value();
+    std::vector<std::string> types;
+    {
+        std::lock_guard lock(subscriptionsMutex);
+        for (const auto &request : topicRequests) {
+            if (command == MessageType::Subscribe) {
+                subscriptions.subscribe(request.type, request.filter);
+            } else {
+                subscriptions.unsubscribe(request.type);
+            }
+            types.push_back(toString(request.type));
+        }
+    }
+    cafe->refreshTopicInterest();
+
+    appLogger->info("Client {} {}d: {}", clientId, toString(command), fmt::join(types, ", "));
+}
+
+void ClientConnection::bindStreamSlots(const oatpp::String &message) {
+    auto permissiveJsonMapper = oatpp::parser::json::mapping::ObjectMapper::createShared();
+    permissiveJsonMapper->getDeserializer()->getConfig()->allowUnknownFields = true;
+    const auto dto = permissiveJsonMapper->readFromString<oatpp::Object<StreamBindingCommandDTO>>(message);
+
+    oatpp::Object<StreamBindingPayloadDto> payload;
+    if (dto) {
+        payload = dto->payload;
+    }
+
+    const auto bindings = streamSlotsFromDto(payload);
+    if (!bindings.isSuccess()) {
+        const auto error = bindings.getError()->getMessage();
+        appLogger->warn("Client {} sent a bad {}: {}", clientId, toString(MessageType::StreamBinding), error);
+        sendNotice(fmt::format("Unable to bind stream slots: {}", error));
+        return;
+    }
+
+    const auto slots = bindings.getValue().value();
+    streamSlots.bind(slots);
+    if (slots.empty()) {
+        appLogger->info("Client {} turned binary stream frames off", clientId);
+        sendNotice("Binary stream frames are off");
+        return;
+    }
+
+    std::vector<std::string> bound;
+    for (const auto &[slot, creatureId] : slots) {
+        bound.push_back(fmt::format("{}={}", slot, creatureId));
+    }
+    appLogger->info("Client {} bound stream slots: {}", clientId, fmt::join(bound, ", "));
+    sendNotice(fmt::format("Binary stream frames are on for slots {}", fmt::join(bound, ", ")));
+}
+
+void ClientConnection::sendNotice(const std::string &text) {
+    Notice notice;
+    notice.timestamp = getCurrentTimeISO8601();
+    notice.message = text;
+
+    auto message = oatpp::Object<ws::NoticeMessage>::createShared();
+    message->command = toString(ws::MessageType::Notice);
+    message->payload = creatures::convertToDto(notice);
+
+    // Let the outbox send it, so it doesn't cross a broadcast on the socket
+    sendTextMessage(ws::MessageType::Notice, serializeForClients(ws::MessageType::Notice, message).json);
+}
+
+bool ClientConnection::send(ClientOutbox::Frame frame, const std::shared_ptr<const std::string> &payload) {
     // appLogger->trace("Sending message to client {}", clientId);
+
+    // oatpp wants a mutable string but only reads it, so every client can send the same buffer
+    const oatpp::String text(std::const_pointer_cast<std::string>(payload));
     try {
-        ourSocket.sendOneFrameText(message);
-        creatures::metrics->incrementWebsocketMessagesSent();
+        if (frame == ClientOutbox::Frame::Ping) {
+            appLogger->debug("Sending ping to client {}", clientId);
+            ourSocket.sendPing(text);
+            creatures::metrics->incrementWebsocketPingsSent();
+        } else if (frame == ClientOutbox::Frame::Pong) {
+            ourSocket.sendPong(text);
+        } else {
+            ourSocket.sendOneFrameText(text);
+            creatures::metrics->incrementWebsocketMessagesSent();
+        }
+        return true;
     } catch (const std::runtime_error &e) {
-        appLogger->warn("Failed to send message to client {}: {} (likely disconnected)", clientId, e.what());
+        appLogger->warn("Failed to send to client {}: {} (likely disconnected)", clientId, e.what());
     } catch (const std::exception &e) {
-        appLogger->warn("Exception sending message to client {}: {}", clientId, e.what());
+        appLogger->warn("Exception sending to client {}: {}", clientId, e.what());
     } catch (...) {
-        appLogger->warn("Unknown exception sending message to client {}", clientId);
+        appLogger->warn("Unknown exception sending to client {}", clientId);
     }
+    return false;
 }
 
-void ClientConnection::sendPing() {
-    appLogger->debug("Sending ping to client {}", clientId);
-    try {
-        ourSocket.sendPing("ping"); // We should be reference counting here
-    } catch (const std::runtime_error &e) {
-        appLogger->warn("Failed to send ping to client {}: {} (likely disconnected)", clientId, e.what());
-    } catch (const std::exception &e) {
-        appLogger->warn("Exception sending ping to client {}: {}", clientId, e.what());
-    } catch (...) {
-        appLogger->warn("Unknown exception sending ping to client {}", clientId);
+/**
+ * Shutting the socket down (rather than closing it) unblocks the writer if it's stuck
+ * sending, and ends oatpp's read loop, which then tears the connection down as usual.
+ */
+void ClientConnection::hangUp() {
+    appLogger->warn("Client {} fell {} messages behind, hanging up", clientId, WEBSOCKET_CLIENT_QUEUE_DEPTH);
+
+    ourSocket.stopListening();
+    auto connection = std::dynamic_pointer_cast<oatpp::network::tcp::Connection>(ourSocket.getConnection().object);
+    if (connection) {
+        ::shutdown(static_cast<int>(connection->getHandle()), SHUT_RDWR);
+    } else {
+        appLogger->warn("Client {} isn't on a plain TCP connection; waiting for it to notice", clientId);
     }
 }
 
+void ClientConnection::sendPing() { static_cast<void>(outbox.offerPing()); }
+
 void ClientConnection::onPing(const WebSocket &socket, const oatpp::String &message) {
+    (void)socket;
     appLogger->debug("client {} sent a ping!", clientId);
-    socket.sendPong(message);
+
+    // The writer thread answers it, so the pong can't land in the middle of a message
+    auto payload = message ? std::make_shared<const std::string>(*message) : std::make_shared<const std::string>();
+    static_cast<void>(outbox.offerPong(std::move(payload)));
 }
 
 void ClientConnection::onPong(const WebSocket &socket, const oatpp::String &message) {
@@ -81,8 +240,12 @@ static constexpr oatpp::v_io_size MAX_INBOUND_MESSAGE_BYTES = 4ULL * 1024 * 1024
 
 void ClientConnection::readMessage(const WebSocket &socket, v_uint8 opcode, p_char8 data, oatpp::v_io_size size) {
 
-    // Silence the warnings about an unused parameter
-    (void)opcode;
+    // Silence the warning about an unused parameter
+    (void)socket;
+
+    if (opcode != oatpp::websocket::Frame::OPCODE_CONTINUATION) {
+        m_messageOpcode = opcode;
+    }
 
     if (m_bufferOverflowed) {
         // We've already decided to drop this message. Keep ignoring frames
@@ -96,7 +259,21 @@ void ClientConnection::readMessage(const WebSocket &socket, v_uint8 opcode, p_ch
         return;
     }
 
-    if (size == 0) { // message transfer finished
+    if (size == 0 && m_messageOpcode == oatpp::websocket::Frame::OPCODE_BINARY) {
+
+        // Binary messages are stream frames, read right out of the buffer without a copy
+        if (streamSlots.isEnabled()) {
+            messageProcessor->processBinaryStreamFrame(
+                streamSlots, std::span<const uint8_t>(reinterpret_cast<const uint8_t *>(m_messageBuffer.getData()),
+                                                      static_cast<size_t>(m_messageBuffer.getCurrentPosition())));
+        } else {
+            appLogger->warn("Client {} sent a binary message without a {} first", clientId,
+                            toString(MessageType::StreamBinding));
+        }
+        m_messageBuffer.setCurrentPosition(0);
+        metrics->incrementWebsocketMessagesReceived();
+
+    } else if (size == 0) { // message transfer finished
 
         auto wholeMessage = m_messageBuffer.toString();
         m_messageBuffer.setCurrentPosition(0);
@@ -115,8 +292,16 @@ void ClientConnection::readMessage(const WebSocket &socket, v_uint8 opcode, p_ch
 
                 appLogger->trace("request decoded, command: {}", std::string(basicDto->command));
 
-                auto command = basicDto->command;
-                messageProcessor->processIncomingMessage(command, wholeMessage);
+                const std::string command = basicDto->command;
+                if (command == toString(MessageType::Subscribe)) {
+                    updateSubscriptions(MessageType::Subscribe, wholeMessage);
+                } else if (command == toString(MessageType::Unsubscribe)) {
+                    updateSubscriptions(MessageType::Unsubscribe, wholeMessage);
+                } else if (command == toString(MessageType::StreamBinding)) {
+                    bindStreamSlots(wholeMessage);
+                } else {
+                    messageProcessor->processIncomingMessage(command, wholeMessage);
+                }
 
             } else {
                 appLogger->warn("Failed to parse command from message");
@@ -139,25 +324,7 @@ void ClientConnection::readMessage(const WebSocket &socket, v_uint8 opcode, p_ch
                                 std::string(wholeMessage));
 
                 // Send a message back to the client to let them know something was wrong
-                Notice notice;
-                notice.timestamp = getCurrentTimeISO8601();
-                notice.message = clientMessage;
-
-                auto message = oatpp::Object<ws::NoticeMessage>::createShared();
-                message->command = toString(ws::MessageType::Notice);
-                message->payload = creatures::convertToDto(notice);
-
-                // Switch back to the real JSON parser to send things
-                std::string messageAsString = apiObjectMapper->writeToString(message);
-                try {
-                    socket.sendOneFrameText(messageAsString);
-                } catch (const std::runtime_error &e) {
-                    appLogger->warn("Failed to send notice to client {}: {} (likely disconnected)", clientId, e.what());
-                } catch (const std::exception &e) {
-                    appLogger->warn("Exception sending notice to client {}: {}", clientId, e.what());
-                } catch (...) {
-                    appLogger->warn("Unknown exception sending notice to client {}", clientId);
-                }
+                sendNotice(clientMessage);
             } catch (...) {
                 appLogger->warn("Unable to send a message to a client that sent us junk?!");
             }
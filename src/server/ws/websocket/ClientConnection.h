@@ -2,7 +2,10 @@
 #pragma once
 
 #include <atomic>
+#include <memory>
 #include <mutex>
+#include <optional>
+#include <string>
 #include <vector>
 
 #include <oatpp-websocket/ConnectionHandler.hpp>
@@ -11,8 +14,13 @@
 
 #include <oatpp/core/macro/component.hpp>
 
+#include "server/config.h"
+#include "server/ws/dto/websocket/MessageTypes.h"
+#include "server/ws/messaging/BinaryStreamFrame.h"
 #include "server/ws/websocket/ClientCafe.h"
 #include "server/ws/websocket/ClientConnection.h"
+#include "server/ws/websocket/ClientOutbox.h"
+#include "server/ws/websocket/TopicSubscriptions.h"
 
 namespace creatures ::ws {
 
@@ -25,8 +33,15 @@ class ClientConnection : public oatpp::websocket::WebSocket::Listener {
 
   public:
     ClientConnection(const oatpp::websocket::WebSocket &socket, v_int64 clientId_, std::shared_ptr<ClientCafe> cafe_)
-        : clientId(clientId_), ourSocket(socket), cafe(cafe_) {
+        : clientId(clientId_), ourSocket(socket), cafe(cafe_),
+          outbox(
+              clientId_, WEBSOCKET_CLIENT_QUEUE_DEPTH,
+              [this](ClientOutbox::Frame frame, const std::shared_ptr<const std::string> &payload) {
+                  return send(frame, payload);
+              },
+              [this] { hangUp(); }) {
         appLogger->debug("Client {} checking in!", clientId_);
+        outbox.start();
     }
     /**
      * Called on "ping" frame.
@@ -50,11 +65,32 @@ class ClientConnection : public oatpp::websocket::WebSocket::Listener {
     void readMessage(const WebSocket &socket, v_uint8 opcode, p_char8 data, oatpp::v_io_size size) override;
 
     /**
-     * Send a message to our client
+     * Queue a message for our client. This doesn't wait for it to be sent.
      *
-     * @param message the message to send
+     * @param type the message's type, which decides what happens if the client's behind
+     * @param message the message to send, which is shared with every other client it's going to
      */
-    void sendTextMessage(const std::string &message);
+    void sendTextMessage(std::optional<MessageType> type, std::shared_ptr<const std::string> message);
+
+    /**
+     * Stop sending to the client. This has to happen before the socket goes away.
+     */
+    void stopSending();
+
+    /**
+     * @return true if the client's subscribed to this message (or hasn't subscribed to anything yet)
+     */
+    bool wants(const MessageTopic &topic);
+
+    /**
+     * @return true if working out whether the client wants a message of this type means looking inside it
+     */
+    bool needsDetails(MessageType type);
+
+    /**
+     * Add what this client wants to a summary of what every client wants
+     */
+    void addInterestTo(TopicInterest &interest);
 
     /**
      * Our client ID
@@ -62,11 +98,38 @@ class ClientConnection : public oatpp::websocket::WebSocket::Listener {
     v_int64 clientId;
 
     /**
-     * Send a ping to the client
+     * Queue a ping for the client
      */
     void sendPing();
 
   private:
+    /**
+     * Send one frame on the socket (on the outbox's thread)
+     *
+     * @return false if the client's gone
+     */
+    bool send(ClientOutbox::Frame frame, const std::shared_ptr<const std::string> &payload);
+
+    /**
+     * Shut the connection down under a client that's fallen too far behind
+     */
+    void hangUp();
+
+    /**
+     * Handle a subscribe or unsubscribe message from the client
+     */
+    void updateSubscriptions(MessageType command, const oatpp::String &message);
+
+    /**
+     * Handle a stream-binding message, which sets up (or turns off) binary stream frames
+     */
+    void bindStreamSlots(const oatpp::String &message);
+
+    /**
+     * Let the client know about something with a notice
+     */
+    void sendNotice(const std::string &text);
+
     /**
      * Buffer for messages. Needed for multi-frame messages.
      */
@@ -78,8 +141,12 @@ class ClientConnection : public oatpp::websocket::WebSocket::Listener {
      */
     bool m_bufferOverflowed = false;
 
+    /**
+     * Whether the message being read is text or binary (its later frames are continuations)
+     */
+    v_uint8 m_messageOpcode = 0;
+
     OATPP_COMPONENT(std::shared_ptr<spdlog::logger>, appLogger);
-    OATPP_COMPONENT(std::shared_ptr<oatpp::data::mapping::ObjectMapper>, apiObjectMapper);
     OATPP_COMPONENT(std::shared_ptr<creatures::ws::MessageProcessor>, messageProcessor);
 
     /**
@@ -88,6 +155,23 @@ class ClientConnection : public oatpp::websocket::WebSocket::Listener {
     const oatpp::websocket::WebSocket &ourSocket;
 
     std::shared_ptr<ClientCafe> cafe;
+
+    /**
+     * Everything waiting to go out to the client
+     */
+    ClientOutbox outbox;
+
+    /**
+     * What the client's asked to be sent (and a mutex to protect it)
+     */
+    TopicSubscriptions subscriptions;
+    std::mutex subscriptionsMutex;
+
+    /**
+     * The creatures the client's bound to slots for binary stream frames. Only the reader
+     * thread uses these.
+     */
+    StreamSlots streamSlots;
 };
 
 } // namespace creatures::ws
\ No newline at end of file
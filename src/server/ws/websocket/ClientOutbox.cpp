@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "server/ws/websocket/ClientOutbox.h"
+
+#include "util/threadName.h"
+
+namespace creatures ::ws {
+
+OutboxPolicy outboxPolicyFor(std::optional<MessageType> type) {
+    if (!type) {
+        return OutboxPolicy::Keep;
+    }
+    switch (*type) {
+    case MessageType::ServerCounters:
+    case MessageType::VirtualStatusLights:
+        return OutboxPolicy::LatestOnly;
+    case MessageType::LogMessage:
+        return OutboxPolicy::DropOldest;
+    default:
+        return OutboxPolicy::Keep;
+    }
+}
+
+ClientOutbox::ClientOutbox(int64_t clientId, size_t capacity, Send send, Hangup hangup)
+    : clientId_(clientId), capacity_(std::max<size_t>(capacity, 1)), send_(std::move(send)),
+      hangup_(std::move(hangup)) {}
+
+ClientOutbox::~ClientOutbox() { stop(); }
+
+void ClientOutbox::start() { writer_ = std::thread(&ClientOutbox::runWriter, this); }
+
+ClientOutbox::Offer ClientOutbox::offer(std::optional<MessageType> type, std::shared_ptr<const std::string> message) {
+    std::unique_lock lock(mutex_);
+    if (closed_) {
+        return Offer::Closed;
+    }
+
+    const auto policy = outboxPolicyFor(type);
+    if (policy == OutboxPolicy::LatestOnly) {
+        const auto waiting =
+            std::find_if(queue_.begin(), queue_.end(), [type](const Entry &entry) { return entry.type == type; });
+        if (waiting != queue_.end()) {
+            waiting->message = std::move(message);
+            return Offer::Coalesced;
+        }
+    }
+
+    auto result = Offer::Queued;
+    if (queue_.size() >= capacity_) {
+        if (policy == OutboxPolicy::DropOldest && !dropFirst(*type)) {
+            // Nothing older of its kind to push out, so this one's the one that goes
+            return Offer::Dropped;
+        }
+
+        // Logs are the only thing we're willing to lose to make room for anything else
+        if (policy != OutboxPolicy::DropOldest && !dropFirst(MessageType::LogMessage)) {
+            closed_ = true;
+            queue_.clear();
+            lock.unlock();
+            waiting_.notify_one();
+            hangup_();
+            return Offer::TooFarBehind;
+        }
+        result = Offer::Dropped;
+    }
+
+    queue_.push_back(Entry{Frame::Text, type, std::move(message)});
+    lock.unlock();
+    waiting_.notify_one();
+    return result;
+}
+
+ClientOutbox::Offer ClientOutbox::offerPing() {
+    std::unique_lock lock(mutex_);
+    if (closed_) {
+        return Offer::Closed;
+    }
+    const bool pingWaiting = std::any_of(queue_.begin(), queue_.end(),
+                                         [](const Entry &entry) { return entry.frame == Frame::Ping; });
+    if (pingWaiting) {
+        return Offer::Coalesced;
+    }
+    if (queue_.size() >= capacity_) {
+        return Offer::Dropped;
+    }
+    static const auto ping = std::make_shared<const std::string>("ping");
+    queue_.push_back(Entry{Frame::Ping, std::nullopt, ping});
+    lock.unlock();
+    waiting_.notify_one();
+    return Offer::Queued;
+}
+
+ClientOutbox::Offer ClientOutbox::offerPong(std::shared_ptr<const std::string> payload) {
+    std::unique_lock lock(mutex_);
+    if (closed_) {
+        return Offer::Closed;
+    }
+    const auto waiting =
+        std::find_if(queue_.begin(), queue_.end(), [](const Entry &entry) { return entry.frame == Frame::Pong; });
+    if (waiting != queue_.end()) {
+        waiting->message = std::move(payload);
+        return Offer::Coalesced;
+    }
+    queue_.push_front(Entry{Frame::Pong, std::nullopt, std::move(payload)});
+    lock.unlock();
+    waiting_.notify_one();
+    return Offer::Queued;
+}
+
+/** With mutex_ held */
+bool ClientOutbox::dropFirst(MessageType type) {
+    const auto oldest =
+        std::find_if(queue_.begin(), queue_.end(), [type](const Entry &entry) { return entry.type == type; });
+    if (oldest == queue_.end()) {
+        return false;
+    }
+    queue_.erase(oldest);
+    return true;
+}
+
+void ClientOutbox::stop() {
+    {
+        std::lock_guard lock(mutex_);
+        closed_ = true;
+        queue_.clear();
+    }
+    waiting_.notify_one();
+    if (writer_.joinable() && writer_.get_id() != std::this_thread::get_id()) {
+        writer_.join();
+    }
+}
+
+size_t ClientOutbox::depth() {
+    std::lock_guard lock(mutex_);
+    return queue_.size();
+}
+
+bool ClientOutbox::isClosed() {
+    std::lock_guard lock(mutex_);
+    return closed_;
+}
+
+void ClientOutbox::runWriter() {
+
+    // Make sure this shows up in the debugger correctly
+    setThreadName(fmt::format("ws-client-{}", clientId_));
+
+    while (true) {
+        Entry entry;
+        {
+            std::unique_lock lock(mutex_);
+            waiting_.wait(lock, [this] { return closed_ || !queue_.empty(); });
+            if (closed_) {
+                return;
+            }
+            entry = std::move(queue_.front());
+            queue_.pop_front();
+        }
+
+        if (!send_(entry.frame, entry.message)) {
+            std::lock_guard lock(mutex_);
+            closed_ = true;
+            queue_.clear();
+            return;
+        }
+    }
+}
+
+} // namespace creatures::ws
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include "server/ws/dto/websocket/MessageTypes.h"
+
+namespace creatures ::ws {
+
+/**
+ * How a client's queue makes room when it's backed up
+ */
+enum class OutboxPolicy {
+    /** Every one has to be delivered (the default) */
+    Keep,
+
+    /** Only the newest one matters, so it replaces any still waiting */
+    LatestOnly,
+
+    /** Worth sending, but the oldest ones can go when there's no room */
+    DropOldest,
+};
+
+/**
+ * Which policy a message type gets
+ */
+OutboxPolicy outboxPolicyFor(std::optional<MessageType> type);
+
+/**
+ * The messages waiting to go out to one websocket client, and the thread that sends them
+ *
+ * Broadcasting only ever puts a message in the queue, so a client on a bad connection
+ * can't hold up anyone else. The queue is bounded: counters and status lights replace
+ * their previous copy, logs push out the oldest log, and a client that can't make room
+ * for anything else has fallen too far behind and gets hung up on.
+ *
+ * Messages are shared with every other client's queue, never copied.
+ */
+class ClientOutbox {
+
+  public:
+    /**
+     * What kind of websocket frame to send
+     */
+    enum class Frame { Text, Ping, Pong };
+
+    /**
+     * Send one frame to the client, blocking until it's gone
+     *
+     * @return false if the client's gone away and nothing more should be sent
+     */
+    using Send = std::function<bool(Frame frame, const std::shared_ptr<const std::string> &payload)>;
+
+    /**
+     * Hang up on the client. This has to unstick a Send that's blocked.
+     */
+    using Hangup = std::function<void()>;
+
+    /**
+     * What happened to an offered message
+     */
+    enum class Offer {
+        Queued,
+
+        /** It replaced an older message of the same type */
+        Coalesced,
+
+        /** It went in, but an older message was dropped to make room (or it was itself dropped) */
+        Dropped,
+
+        /** The client's too far behind; it's been hung up on */
+        TooFarBehind,
+
+        /** The client's already gone */
+        Closed,
+    };
+
+    ClientOutbox(int64_t clientId, size_t capacity, Send send, Hangup hangup);
+    ~ClientOutbox();
+
+    ClientOutbox(const ClientOutbox &) = delete;
+    ClientOutbox &operator=(const ClientOutbox &) = delete;
+
+    /**
+     * Start the thread that sends to the client
+     */
+    void start();
+
+    /**
+     * Queue a message for the client. This never waits on the client.
+     *
+     * @param type the message's type, if it has one
+     * @param message the message to send, shared with whoever else it's going to
+     * @return what happened to it
+     */
+    Offer offer(std::optional<MessageType> type, std::shared_ptr<const std::string> message);
+
+    /**
+     * Queue a ping, unless there's one waiting already. A ping never hangs up on anyone.
+     *
+     * @return what happened to it
+     */
+    Offer offerPing();
+
+    /**
+     * Queue the answer to a client's ping, ahead of any messages that are waiting. If an
+     * answer's still waiting it's replaced, since only the latest ping needs one.
+     *
+     * @param payload what the client's ping carried
+     * @return what happened to it
+     */
+    Offer offerPong(std::shared_ptr<const std::string> payload);
+
+    /**
+     * Stop sending and wait for the writer to finish. Anything still queued is thrown away.
+     */
+    void stop();
+
+    /**
+     * @return how many messages are waiting
+     */
+    [[nodiscard]] size_t depth();
+
+    /**
+     * @return true once the client's gone away or been hung up on
+     */
+    [[nodiscard]] bool isClosed();
+
+  private:
+    struct Entry {
+        Frame frame{Frame::Text};
+        std::optional<MessageType> type;
+        std::shared_ptr<const std::string> message;
+    };
+
+    /**
+     * Pull the first waiting message of a type out of the queue
+     *
+     * @return true if there was one
+     */
+    bool dropFirst(MessageType type);
+
+    void runWriter();
+
+    const int64_t clientId_;
+    const size_t capacity_;
+    const Send send_;
+    const Hangup hangup_;
+
+    std::mutex mutex_;
+    std::condition_variable waiting_;
+    std::deque<Entry> queue_;
+    bool closed_{false};
+
+    std::thread writer_;
+};
+
+} // namespace creatures::ws
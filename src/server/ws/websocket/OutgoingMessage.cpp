@@ -0,0 +1,33 @@
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include "server/metrics/counters.h"
+#include "server/ws/websocket/OutgoingMessage.h"
+
+namespace creatures {
+extern std::shared_ptr<SystemCounters> metrics;
+} // namespace creatures
+
+namespace creatures ::ws {
+
+oatpp::parser::json::mapping::ObjectMapper &threadJsonMapper() {
+    thread_local const auto mapper = oatpp::parser::json::mapping::ObjectMapper::createShared();
+    return *mapper;
+}
+
+OutgoingMessage outgoingMessageFrom(std::optional<MessageType> type, const oatpp::String &json) {
+    return OutgoingMessage{type, json.getPtr()};
+}
+
+OutgoingMessage finishSerializing(MessageType type, const oatpp::String &json,
+                                  std::chrono::steady_clock::time_point started) {
+    const auto elapsed = std::chrono::steady_clock::now() - started;
+    if (metrics) {
+        metrics->recordWebsocketSerialization(
+            type, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+    return OutgoingMessage{type, json.getPtr()};
+}
+
+} // namespace creatures::ws
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include <oatpp/core/Types.hpp>
+#include <oatpp/parser/json/mapping/ObjectMapper.hpp>
+
+#include "server/ws/dto/websocket/MessageTypes.h"
+
+namespace creatures ::ws {
+
+/**
+ * A message on its way out to the websocket clients
+ *
+ * It's serialized once, and every client it goes to shares the same buffer rather than
+ * getting a copy of its own. Nothing may change the buffer once it's been made.
+ */
+struct OutgoingMessage {
+    std::optional<MessageType> type;
+    std::shared_ptr<const std::string> json;
+};
+
+/**
+ * The JSON mapper for the current thread
+ *
+ * Making a mapper for every message adds up when logs are flowing, so each thread that
+ * sends messages keeps one around.
+ */
+oatpp::parser::json::mapping::ObjectMapper &threadJsonMapper();
+
+/**
+ * Wrap a message that's already JSON, such as a report a client sent that's being passed
+ * along to the others. This shares the string rather than copying it.
+ *
+ * @param type the message's type, if it has one
+ * @param json the message
+ */
+OutgoingMessage outgoingMessageFrom(std::optional<MessageType> type, const oatpp::String &json);
+
+/**
+ * Take a freshly serialized message and record how long it took to make
+ *
+ * @param type the message's type
+ * @param json the serialized message
+ * @param started when serializing started
+ */
+OutgoingMessage finishSerializing(MessageType type, const oatpp::String &json,
+                                  std::chrono::steady_clock::time_point started);
+
+/**
+ * Serialize a message for the websocket clients, once, with this thread's mapper
+ *
+ * The time it takes is counted against the message's type in the server counters.
+ *
+ * @param type the message's type (which should match its command)
+ * @param message the message to send
+ * @return the message, ready to go on websocketOutgoingMessages
+ */
+template <class T> OutgoingMessage serializeForClients(MessageType type, const oatpp::Object<T> &message) {
+    const auto started = std::chrono::steady_clock::now();
+    return finishSerializing(type, threadJsonMapper().writeToString(message), started);
+}
+
+} // namespace creatures::ws
@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include <oatpp/core/macro/codegen.hpp>
+#include <oatpp/parser/json/mapping/ObjectMapper.hpp>
+
+#include "server/ws/websocket/TopicSubscriptions.h"
+
+namespace creatures ::ws {
+
+namespace {
+
+#include OATPP_CODEGEN_BEGIN(DTO)
+
+/**
+ * Just the parts of a message's payload that subscriptions can filter on
+ */
+class TopicDetailsPayloadDto : public oatpp::DTO {
+
+    DTO_INIT(TopicDetailsPayloadDto, DTO)
+
+    DTO_FIELD(String, creature_id);
+    DTO_FIELD(UInt32, universe);
+    DTO_FIELD(String, level);
+};
+
+class TopicDetailsDto : public WebSocketMessageDto<oatpp::Object<TopicDetailsPayloadDto>> {
+
+    DTO_INIT(TopicDetailsDto, WebSocketMessageDto<oatpp::Object<TopicDetailsPayloadDto>>)
+};
+
+#include OATPP_CODEGEN_END(DTO)
+
+// What was last published, for anyone about to build a message
+std::array<std::atomic<bool>, allMessageTypes.size()> publishedTypes{};
+std::atomic<LogLevel> publishedLowestLogLevel{LogLevel::off};
+
+size_t indexOf(MessageType type) { return static_cast<size_t>(type); }
+
+} // namespace
+
+bool TopicFilter::isEmpty() const { return !creatureId && !universe && !minimumLogLevel; }
+
+bool TopicFilter::matches(const MessageTopic &topic) const {
+    if (creatureId && topic.creatureId != creatureId) {
+        return false;
+    }
+    if (universe && topic.universe != universe) {
+        return false;
+    }
+    if (minimumLogLevel && (!topic.logLevel || *topic.logLevel < *minimumLogLevel)) {
+        return false;
+    }
+    return true;
+}
+
+void TopicSubscriptions::subscribe(MessageType type, TopicFilter filter) {
+    selective_ = true;
+    auto &filters = topics_[type];
+    if (std::find(filters.begin(), filters.end(), filter) == filters.end()) {
+        filters.push_back(std::move(filter));
+    }
+}
+
+void TopicSubscriptions::unsubscribe(MessageType type) {
+    selective_ = true;
+    topics_.erase(type);
+}
+
+bool TopicSubscriptions::wantsAny(MessageType type) const { return !selective_ || topics_.contains(type); }
+
+bool TopicSubscriptions::needsDetails(MessageType type) const {
+    if (!selective_) {
+        return false;
+    }
+    const auto found = topics_.find(type);
+    return found != topics_.end() &&
+           std::none_of(found->second.begin(), found->second.end(),
+                        [](const TopicFilter &filter) { return filter.isEmpty(); });
+}
+
+bool TopicSubscriptions::wants(const MessageTopic &topic) const {
+    if (!selective_) {
+        return true;
+    }
+    if (!topic.type) {
+        return false;
+    }
+    const auto found = topics_.find(*topic.type);
+    return found != topics_.end() && std::any_of(found->second.begin(), found->second.end(),
+                                                 [&topic](const TopicFilter &filter) { return filter.matches(topic); });
+}
+
+std::optional<LogLevel> TopicSubscriptions::lowestLogLevel() const {
+    if (!selective_) {
+        return LogLevel::trace;
+    }
+    const auto found = topics_.find(MessageType::LogMessage);
+    if (found == topics_.end()) {
+        return std::nullopt;
+    }
+    auto lowest = LogLevel::off;
+    for (const auto &filter : found->second) {
+        lowest = std::min(lowest, filter.minimumLogLevel.value_or(LogLevel::trace));
+    }
+    return lowest;
+}
+
+void TopicInterest::include(const TopicSubscriptions &subscriptions) {
+    for (const auto type : allMessageTypes) {
+        types_[indexOf(type)] = types_[indexOf(type)] || subscriptions.wantsAny(type);
+    }
+    if (const auto lowest = subscriptions.lowestLogLevel()) {
+        lowestLogLevel_ = std::min(lowestLogLevel_, *lowest);
+    }
+}
+
+void TopicInterest::publish() const {
+    for (size_t index = 0; index < types_.size(); ++index) {
+        publishedTypes[index].store(types_[index], std::memory_order_relaxed);
+    }
+    publishedLowestLogLevel.store(lowestLogLevel_, std::memory_order_relaxed);
+}
+
+bool anyoneSubscribedTo(MessageType type) { return publishedTypes[indexOf(type)].load(std::memory_order_relaxed); }
+
+bool anyoneSubscribedToLogsAt(LogLevel level) {
+    return anyoneSubscribedTo(MessageType::LogMessage) &&
+           level >= publishedLowestLogLevel.load(std::memory_order_relaxed);
+}
+
+void addTopicDetails(MessageTopic &topic, std::string_view json) {
+
+    // Only the command and a few payload fields matter, so let everything else through
+    static const auto mapper = [] {
+        auto permissiveJsonMapper = oatpp::parser::json::mapping::ObjectMapper::createShared();
+        permissiveJsonMapper->getDeserializer()->getConfig()->allowUnknownFields = true;
+        return permissiveJsonMapper;
+    }();
+
+    try {
+        const oatpp::String message(json.data(), static_cast<v_buff_size>(json.size()));
+        const auto details = mapper->readFromString<oatpp::Object<TopicDetailsDto>>(message);
+        if (!details || !details->payload) {
+            return;
+        }
+        const auto &payload = details->payload;
+        if (payload->creature_id) {
+            topic.creatureId = std::string(payload->creature_id);
+        }
+        if (payload->universe) {
+            topic.universe = *payload->universe;
+        }
+        if (payload->level) {
+            topic.logLevel = fromString(std::string(payload->level));
+        }
+    } catch (const std::exception &) {
+        // Whatever it has that can't be read can't match a filter, which is the right answer
+    }
+}
+
+Result<std::vector<TopicRequest>> topicRequestsFromDto(const oatpp::Object<SubscriptionPayloadDto> &payload) {
+    if (!payload || !payload->topics || payload->topics->empty()) {
+        return Result<std::vector<TopicRequest>>{ServerError(ServerError::InvalidData, "No topics were given")};
+    }
+
+    std::vector<TopicRequest> requests;
+    requests.reserve(payload->topics->size());
+    for (const auto &topic : *payload->topics) {
+        if (!topic || !topic->type) {
+            return Result<std::vector<TopicRequest>>{ServerError(ServerError::InvalidData, "Every topic needs a type")};
+        }
+
+        const auto type = std::find_if(allMessageTypes.begin(), allMessageTypes.end(),
+                                       [&topic](MessageType candidate) { return toString(candidate) == *topic->type; });
+        if (type == allMessageTypes.end()) {
+            return Result<std::vector<TopicRequest>>{
+                ServerError(ServerError::InvalidData, fmt::format("There's no such topic as '{}'", *topic->type))};
+        }
+
+        TopicRequest request{*type, {}};
+        if (topic->creature_id) {
+            request.filter.creatureId = std::string(topic->creature_id);
+        }
+        if (topic->universe) {
+            request.filter.universe = *topic->universe;
+        }
+        if (topic->log_level) {
+            try {
+                request.filter.minimumLogLevel = fromString(std::string(topic->log_level));
+            } catch (const std::invalid_argument &) {
+                return Result<std::vector<TopicRequest>>{ServerError(
+                    ServerError::InvalidData, fmt::format("'{}' isn't a log level", std::string(topic->log_level)))};
+            }
+        }
+        requests.push_back(std::move(request));
+    }
+    return Result<std::vector<TopicRequest>>{requests};
+}
+
+} // namespace creatures::ws
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <oatpp/core/Types.hpp>
+
+#include "model/LogLevel.h"
+#include "server/ws/dto/websocket/MessageTypes.h"
+#include "server/ws/messaging/SubscriptionCommandDTO.h"
+#include "util/Result.h"
+
+namespace creatures ::ws {
+
+/**
+ * What an outgoing message is about, for matching it against what clients asked for
+ *
+ * Only the messages that carry a detail have it filled in: the creature for sensor
+ * reports, idle changes and activity, the universe for playlist status, and the level
+ * for logs.
+ */
+struct MessageTopic {
+    std::optional<MessageType> type;
+    std::optional<std::string> creatureId;
+    std::optional<uint32_t> universe;
+    std::optional<LogLevel> logLevel;
+};
+
+/**
+ * Narrows down a subscription. Anything left empty matches everything, and anything
+ * that's set only matches messages that carry it.
+ */
+struct TopicFilter {
+    std::optional<std::string> creatureId;
+    std::optional<uint32_t> universe;
+    std::optional<LogLevel> minimumLogLevel;
+
+    [[nodiscard]] bool isEmpty() const;
+    [[nodiscard]] bool matches(const MessageTopic &topic) const;
+
+    bool operator==(const TopicFilter &other) const = default;
+};
+
+/**
+ * One topic a client's asked to subscribe to (or unsubscribe from)
+ */
+struct TopicRequest {
+    MessageType type;
+    TopicFilter filter;
+};
+
+/**
+ * What one client has asked to be sent
+ *
+ * A client that's never subscribed to anything gets everything, which is what clients
+ * from before subscriptions existed expect. Its first subscription narrows it down to
+ * just what it's subscribed to.
+ */
+class TopicSubscriptions {
+  public:
+    /**
+     * Add a topic. Subscribing to the same type more than once gets messages that match
+     * any of the filters.
+     */
+    void subscribe(MessageType type, TopicFilter filter);
+
+    /**
+     * Drop every subscription to a type, whatever it was filtered on
+     */
+    void unsubscribe(MessageType type);
+
+    /**
+     * @return true once the client has subscribed to something
+     */
+    [[nodiscard]] bool isSelective() const { return selective_; }
+
+    /**
+     * @return true if any message of this type could go to the client
+     */
+    [[nodiscard]] bool wantsAny(MessageType type) const;
+
+    /**
+     * @return true if deciding whether the client wants a message of this type means
+     *         looking at the message's details
+     */
+    [[nodiscard]] bool needsDetails(MessageType type) const;
+
+    /**
+     * @return true if the client wants this message
+     */
+    [[nodiscard]] bool wants(const MessageTopic &topic) const;
+
+    /**
+     * @return the lowest log level the client wants, or std::nullopt if it doesn't want logs
+     */
+    [[nodiscard]] std::optional<LogLevel> lowestLogLevel() const;
+
+  private:
+    bool selective_{false};
+    std::unordered_map<MessageType, std::vector<TopicFilter>> topics_;
+};
+
+/**
+ * What every connected client wants, put together
+ *
+ * ClientCafe publishes one of these whenever a client comes, goes, or changes what it's
+ * subscribed to. Whoever builds messages can then skip the ones nobody would get.
+ */
+class TopicInterest {
+  public:
+    void include(const TopicSubscriptions &subscriptions);
+
+    /**
+     * Make this what anyoneSubscribedTo() and anyoneSubscribedToLogsAt() answer from
+     */
+    void publish() const;
+
+  private:
+    std::array<bool, allMessageTypes.size()> types_{};
+    LogLevel lowestLogLevel_{LogLevel::off};
+};
+
+/**
+ * @return true if any connected client might want a message of this type
+ */
+bool anyoneSubscribedTo(MessageType type);
+
+/**
+ * @return true if any connected client wants log messages at this level
+ */
+bool anyoneSubscribedToLogsAt(LogLevel level);
+
+/**
+ * Fill in the details of a message's topic from the message itself
+ *
+ * This parses the payload, so it's only worth doing when a client is filtering on them.
+ *
+ * @param topic the topic to fill in, with its type already set
+ * @param json the serialized message
+ */
+void addTopicDetails(MessageTopic &topic, std::string_view json);
+
+/**
+ * Turn the topics from a subscribe or unsubscribe message into requests
+ *
+ * @param payload the message's payload
+ * @return the requests, or ServerError::InvalidData if a topic doesn't make sense
+ */
+Result<std::vector<TopicRequest>> topicRequestsFromDto(const oatpp::Object<SubscriptionPayloadDto> &payload);
+
+} // namespace creatures::ws
@@ -17,13 +17,12 @@
 #include <opus.h>
 
 #include <fmt/format.h>
-#include <nlohmann/json.hpp>
 #include <spdlog/spdlog.h>
 
 #include "AudioCache.h"
-#include "JsonParser.h"
 #include "server/namespace-stuffs.h"
 #include "util/ObservabilityManager.h"
+#include "util/OpusCacheFile.h"
 
 namespace creatures {
 extern std::shared_ptr<ObservabilityManager> observability;
@@ -36,9 +35,9 @@ namespace {
 
 // Version 3 adds the encoder-state silence pre-roll used by RTP startup.
 constexpr uint32_t AUDIO_CACHE_FORMAT_VERSION = 3;
-constexpr const char *CACHE_COMPLETE_MARKER = ".complete";
+constexpr const char *CACHE_FILE_EXTENSION = ".opuscache";
 
-uint64_t stablePathHash(const std::string &value) {
+uint64_t stableHash(const std::string &value) {
     // FNV-1a is stable across processes and standard-library versions, unlike
     // std::hash. This hash is for collision-resistant cache names, not security.
     uint64_t hash = 14695981039346656037ULL;
@@ -49,6 +48,21 @@ uint64_t stablePathHash(const std::string &value) {
     return hash;
 }
 
+// Anything that changes what the encoder produces has to change this, so old
+// cache files stop matching
+uint64_t encoderFingerprint() {
+    static const uint64_t fingerprint =
+        stableHash(fmt::format("v{}:{}Hz:{}ch:{}ms:{}priming:{}bps:fec:{}", AUDIO_CACHE_FORMAT_VERSION, RTP_SRATE,
+                               RTP_STREAMING_CHANNELS, RTP_FRAME_MS, RTP_PRIMING_FRAMES, RTP_BITRATE,
+                               opus_get_version_string()));
+    return fingerprint;
+}
+
+OpusCacheStamp stampFor(const AudioCache::SourceFileInfo &sourceInfo) {
+    return OpusCacheStamp{encoderFingerprint(), static_cast<uint64_t>(sourceInfo.fileSize),
+                          static_cast<int64_t>(sourceInfo.modTime.time_since_epoch().count())};
+}
+
 } // namespace
 
 AudioCache::AudioCache(const std::string &soundDirectory) : soundDirectory_(soundDirectory) {
@@ -87,17 +101,8 @@ std::shared_ptr<AudioCache::CachedAudioData> AudioCache::tryLoadFromCache(const
         const auto keyMutex = getKeyMutex(sourceFilePath);
         std::lock_guard lock(*keyMutex);
 
-        // Fast check: do all cache files exist?
-        if (!allCacheFilesExist(sourceFilePath)) {
-            cacheMisses_++;
-            if (span)
-                span->setAttribute("cache_result", "miss_files_missing");
-            debug("Cache miss: files missing for {}", sourceFilePath);
-            return nullptr;
-        }
-
-        // Get current source file info for validation
-        auto sourceInfoResult = getSourceFileInfo(sourceFilePath);
+        // Only the size and modification time; the checksum is only worked out when saving
+        auto sourceInfoResult = getSourceFileInfo(sourceFilePath, false);
         if (!sourceInfoResult.isSuccess()) {
             cacheMisses_++;
             if (span) {
@@ -109,71 +114,37 @@ std::shared_ptr<AudioCache::CachedAudioData> AudioCache::tryLoadFromCache(const
             return nullptr;
         }
 
-        auto currentSourceInfo = sourceInfoResult.getValue().value();
-
-        // Load and validate the first channel file (they should all have the same metadata)
-        auto channel0Path = getCacheFilePath(sourceFilePath, 0);
-        auto loadResult = loadOggOpusWithMetadata(channel0Path);
-        if (!loadResult.isSuccess()) {
+        const auto stamp = stampFor(sourceInfoResult.getValue().value());
+        auto mapResult = mapOpusCacheFile(getCacheFilePath(sourceFilePath), stamp);
+        if (!mapResult.isSuccess()) {
             cacheMisses_++;
-            if (span) {
-                span->setAttribute("cache_result", "miss_load_error");
-                span->setError(loadResult.getError()->getMessage());
+            const auto mapError = mapResult.getError().value();
+            if (mapError.getCode() == ServerError::NotFound) {
+                if (span)
+                    span->setAttribute("cache_result", "miss_files_missing");
+                debug("Cache miss: no cache file for {}", sourceFilePath);
+                return nullptr;
             }
-            debug("Cache miss: failed to load channel 0 cache file: {}", loadResult.getError()->getMessage());
-            clearCache(sourceFilePath);
-            return nullptr;
-        }
-
-        auto [firstChannelFrames, cachedSourceInfo] = loadResult.getValue().value();
 
-        // Validate that source file hasn't changed
-        if (!(currentSourceInfo == cachedSourceInfo)) {
-            cacheMisses_++;
-            if (span)
-                span->setAttribute("cache_result", "miss_file_changed");
-            debug("Cache miss: source file has changed for {}", sourceFilePath);
-            // Clear stale cache
+            if (mapError.getCode() == ServerError::Conflict) {
+                if (span)
+                    span->setAttribute("cache_result", "miss_file_changed");
+                debug("Cache miss: {}", mapError.getMessage());
+            } else {
+                if (span) {
+                    span->setAttribute("cache_result", "miss_load_error");
+                    span->setError(mapError.getMessage());
+                }
+                warn("Cache miss: failed to load the cache file for {}: {}", sourceFilePath, mapError.getMessage());
+            }
+            // Clear the stale or damaged cache
             clearCache(sourceFilePath);
             return nullptr;
         }
 
-        // Source file is valid! Load all channels
         auto cachedData = std::make_shared<CachedAudioData>();
-        cachedData->framesPerChannel = firstChannelFrames.size();
-        cachedData->encodedFrames[0] = std::move(firstChannelFrames);
-
-        // Load remaining channels (1-16)
-        for (uint8_t ch = 1; ch < RTP_STREAMING_CHANNELS; ++ch) {
-            auto channelPath = getCacheFilePath(sourceFilePath, ch);
-            auto channelResult = loadOggOpusWithMetadata(channelPath);
-            if (!channelResult.isSuccess()) {
-                cacheMisses_++;
-                if (span) {
-                    span->setAttribute("cache_result", "miss_channel_load_error");
-                    span->setError(
-                        fmt::format("Channel {} load failed: {}", ch, channelResult.getError()->getMessage()));
-                }
-                warn("Cache miss: failed to load channel {} for {}: {}", ch, sourceFilePath,
-                     channelResult.getError()->getMessage());
-                clearCache(sourceFilePath);
-                return nullptr;
-            }
-
-            auto [channelFrames, channelSourceInfo] = channelResult.getValue().value();
-
-            // Sanity check: all channels should have same frame count and source info
-            if (channelFrames.size() != cachedData->framesPerChannel || !(channelSourceInfo == currentSourceInfo)) {
-                cacheMisses_++;
-                if (span)
-                    span->setAttribute("cache_result", "miss_inconsistent_channels");
-                warn("Cache miss: inconsistent channel data for {}", sourceFilePath);
-                clearCache(sourceFilePath); // Clear corrupted cache
-                return nullptr;
-            }
-
-            cachedData->encodedFrames[ch] = std::move(channelFrames);
-        }
+        cachedData->frames = mapResult.getValue().value();
+        cachedData->framesPerChannel = cachedData->frames->framesPerChannel();
 
         cacheHits_++;
         if (span) {
@@ -182,7 +153,7 @@ std::shared_ptr<AudioCache::CachedAudioData> AudioCache::tryLoadFromCache(const
             span->setSuccess();
         }
 
-        debug("Cache hit: loaded {} frames from cache for {}", cachedData->framesPerChannel, sourceFilePath);
+        debug("Cache hit: mapped {} frames from cache for {}", cachedData->framesPerChannel, sourceFilePath);
         return cachedData;
 
     } catch (const std::exception &e) {
@@ -196,6 +167,20 @@ std::shared_ptr<AudioCache::CachedAudioData> AudioCache::tryLoadFromCache(const
     }
 }
 
+bool AudioCache::isCached(const std::string &sourceFilePath) const {
+    try {
+        auto sourceInfoResult = getSourceFileInfo(sourceFilePath, false);
+        if (!sourceInfoResult.isSuccess()) {
+            return false;
+        }
+        return mapOpusCacheFile(getCacheFilePath(sourceFilePath), stampFor(sourceInfoResult.getValue().value()))
+            .isSuccess();
+    } catch (const std::exception &e) {
+        debug("Unable to check the cache for {}: {}", sourceFilePath, e.what());
+        return false;
+    }
+}
+
 Result<void> AudioCache::saveToCache(const std::string &sourceFilePath, const CachedAudioData &audioData,
                                      std::shared_ptr<OperationSpan> parentSpan) {
 
@@ -216,18 +201,17 @@ Result<void> AudioCache::saveToCache(const std::string &sourceFilePath, const Ca
                 span->setError(errorMsg);
             return Result<void>{ServerError(ServerError::InvalidData, errorMsg)};
         }
-        for (uint8_t ch = 0; ch < RTP_STREAMING_CHANNELS; ++ch) {
-            if (audioData.encodedFrames[ch].size() != audioData.framesPerChannel) {
-                const auto errorMsg = fmt::format("Cannot cache channel {} with {} frames; expected {}", ch,
-                                                  audioData.encodedFrames[ch].size(), audioData.framesPerChannel);
-                if (span)
-                    span->setError(errorMsg);
-                return Result<void>{ServerError(ServerError::InvalidData, errorMsg)};
-            }
+        if (!audioData.frames || audioData.frames->framesPerChannel() != audioData.framesPerChannel) {
+            const auto errorMsg =
+                fmt::format("Cannot cache {} frames per channel; expected {}",
+                            audioData.frames ? audioData.frames->framesPerChannel() : 0, audioData.framesPerChannel);
+            if (span)
+                span->setError(errorMsg);
+            return Result<void>{ServerError(ServerError::InvalidData, errorMsg)};
         }
 
-        // Get source file info for metadata
-        auto sourceInfoResult = getSourceFileInfo(sourceFilePath);
+        // Get source file info for the header; this is the only time the source is hashed
+        auto sourceInfoResult = getSourceFileInfo(sourceFilePath, true);
         if (!sourceInfoResult.isSuccess()) {
             if (span)
                 span->setError(sourceInfoResult.getError()->getMessage());
@@ -236,63 +220,39 @@ Result<void> AudioCache::saveToCache(const std::string &sourceFilePath, const Ca
 
         auto sourceInfo = sourceInfoResult.getValue().value();
 
-        // Ensure cache directory exists
+        // Sounds cached in the old one-file-per-channel layout had a directory here
         auto cacheDir = getCacheDirectoryPath(sourceFilePath);
-        std::filesystem::create_directories(cacheDir);
-        const auto completeMarker = std::filesystem::path(cacheDir) / CACHE_COMPLETE_MARKER;
         std::error_code filesystemError;
-        std::filesystem::remove(completeMarker, filesystemError);
-
-        // Save each channel through a temporary file. The completion marker is
-        // written last, so a crash or partial write is always treated as a miss.
-        for (uint8_t ch = 0; ch < RTP_STREAMING_CHANNELS; ++ch) {
-            auto cachePath = getCacheFilePath(sourceFilePath, ch);
-            const auto temporaryPath = cachePath + ".tmp";
+        std::filesystem::remove_all(cacheDir, filesystemError);
+
+        // Write through a temporary file and rename it into place, so a crash
+        // or partial write never leaves a cache file behind that looks complete
+        const auto cachePath = getCacheFilePath(sourceFilePath);
+        std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path());
+        const auto temporaryPath = cachePath + ".tmp";
+        std::filesystem::remove(temporaryPath, filesystemError);
+        auto saveResult =
+            writeOpusCacheFile(temporaryPath, *audioData.frames, stampFor(sourceInfo), sourceInfo.checksum);
+        if (!saveResult.isSuccess()) {
+            if (span)
+                span->setError(saveResult.getError()->getMessage());
             std::filesystem::remove(temporaryPath, filesystemError);
-            auto saveResult = saveAsOggOpusWithMetadata(temporaryPath, audioData.encodedFrames[ch], sourceInfo);
-            if (!saveResult.isSuccess()) {
-                if (span)
-                    span->setError(saveResult.getError()->getMessage());
-                // Clean up partially written cache
-                clearCache(sourceFilePath);
-                return saveResult;
-            }
+            return saveResult;
+        }
 
+        filesystemError.clear();
+        std::filesystem::rename(temporaryPath, cachePath, filesystemError);
+        if (filesystemError) {
+            // Windows does not replace an existing destination; retry after
+            // removing it. Per-key locking keeps readers out of this window.
+            std::filesystem::remove(cachePath, filesystemError);
             filesystemError.clear();
             std::filesystem::rename(temporaryPath, cachePath, filesystemError);
-            if (filesystemError) {
-                // Windows does not replace an existing destination; retry after
-                // removing it. Per-key locking keeps readers out of this window.
-                std::filesystem::remove(cachePath, filesystemError);
-                filesystemError.clear();
-                std::filesystem::rename(temporaryPath, cachePath, filesystemError);
-            }
-            if (filesystemError) {
-                clearCache(sourceFilePath);
-                return Result<void>{
-                    ServerError(ServerError::InternalError,
-                                fmt::format("Failed to publish cache channel {}: {}", ch, filesystemError.message()))};
-            }
         }
-
-        const auto temporaryMarker = completeMarker.string() + ".tmp";
-        {
-            std::ofstream marker(temporaryMarker, std::ios::trunc);
-            marker << AUDIO_CACHE_FORMAT_VERSION;
-            marker.flush();
-            if (!marker.good()) {
-                clearCache(sourceFilePath);
-                return Result<void>{
-                    ServerError(ServerError::InternalError, "Failed to write audio cache completion marker")};
-            }
-        }
-        filesystemError.clear();
-        std::filesystem::rename(temporaryMarker, completeMarker, filesystemError);
         if (filesystemError) {
             clearCache(sourceFilePath);
             return Result<void>{ServerError(
-                ServerError::InternalError,
-                fmt::format("Failed to publish audio cache completion marker: {}", filesystemError.message()))};
+                ServerError::InternalError, fmt::format("Failed to publish cache file: {}", filesystemError.message()))};
         }
 
         if (span)
@@ -314,9 +274,10 @@ Result<void> AudioCache::clearCache(const std::string &sourceFilePath) {
         const auto keyMutex = getKeyMutex(sourceFilePath);
         std::lock_guard lock(*keyMutex);
 
-        auto cacheDir = getCacheDirectoryPath(sourceFilePath);
-        if (std::filesystem::exists(cacheDir)) {
-            std::filesystem::remove_all(cacheDir);
+        // The cache file, plus the directory the old one-file-per-channel layout used
+        const auto removedFile = std::filesystem::remove(getCacheFilePath(sourceFilePath));
+        const auto removedLegacy = std::filesystem::remove_all(getCacheDirectoryPath(sourceFilePath));
+        if (removedFile || removedLegacy > 0) {
             debug("Cleared cache for {}", sourceFilePath);
         }
         return Result<void>();
@@ -350,10 +311,8 @@ AudioCache::CacheStats AudioCache::getStats() const {
 
 // Private implementation methods
 
-std::string AudioCache::getCacheFilePath(const std::string &sourceFilePath, uint8_t channel) const {
-    auto cacheDirPath = getCacheDirectoryPath(sourceFilePath);
-    auto filename = fmt::format("ch{:02d}.opus", channel);
-    return (std::filesystem::path(cacheDirPath) / filename).string();
+std::string AudioCache::getCacheFilePath(const std::string &sourceFilePath) const {
+    return getCacheDirectoryPath(sourceFilePath) + CACHE_FILE_EXTENSION;
 }
 
 namespace {
@@ -416,7 +375,7 @@ std::string AudioCache::getCacheDirectoryPath(const std::string &sourceFilePath)
 
         auto filename = canonicalSourcePath.stem().string();
         auto sanitized = sanitizeComponent(filename);
-        const auto pathHash = fmt::format("{:016x}", stablePathHash(canonicalSourcePath.string()));
+        const auto pathHash = fmt::format("{:016x}", stableHash(canonicalSourcePath.string()));
         sanitized = fmt::format("{}_{}", sanitized, pathHash);
 
         std::filesystem::path baseCachePath = cacheDirectory_;
@@ -435,7 +394,8 @@ std::string AudioCache::getCacheDirectoryPath(const std::string &sourceFilePath)
     }
 }
 
-Result<AudioCache::SourceFileInfo> AudioCache::getSourceFileInfo(const std::string &filePath) const {
+Result<AudioCache::SourceFileInfo> AudioCache::getSourceFileInfo(const std::string &filePath,
+                                                                  bool includeChecksum) const {
     try {
         if (!std::filesystem::exists(filePath)) {
             return Result<SourceFileInfo>{
@@ -453,11 +413,13 @@ Result<AudioCache::SourceFileInfo> AudioCache::getSourceFileInfo(const std::stri
         info.modTime = std::filesystem::last_write_time(filePath);
         info.fileSize = std::filesystem::file_size(filePath);
 
-        auto checksumResult = calculateFileChecksum(filePath);
-        if (!checksumResult.isSuccess()) {
-            return Result<SourceFileInfo>{checksumResult.getError().value()};
+        if (includeChecksum) {
+            auto checksumResult = calculateFileChecksum(filePath);
+            if (!checksumResult.isSuccess()) {
+                return Result<SourceFileInfo>{checksumResult.getError().value()};
+            }
+            info.checksum = checksumResult.getValue().value();
         }
-        info.checksum = checksumResult.getValue().value();
 
         return Result<SourceFileInfo>{info};
 
@@ -544,261 +506,6 @@ Result<std::string> AudioCache::calculateFileChecksum(const std::string &filePat
     }
 }
 
-Result<std::pair<std::vector<std::vector<uint8_t>>, AudioCache::SourceFileInfo>>
-AudioCache::loadOggOpusWithMetadata(const std::string &oggFilePath) const {
-    // For now, implement a simple file format:
-    // - Standard OGG Opus file with audio data
-    // - Metadata stored in OGG comments/tags
-    //
-    // This is a simplified implementation - in production you'd want to use
-    // libogg and libopus properly for full OGG Opus support
-
-    try {
-        std::ifstream file(oggFilePath, std::ios::binary);
-        if (!file.is_open()) {
-            return Result<std::pair<std::vector<std::vector<uint8_t>>, SourceFileInfo>>{
-                ServerError(ServerError::NotFound, fmt::format("Cache file not found: {}", oggFilePath))};
-        }
-
-        // For this implementation, we'll use a simple binary format:
-        // [metadata_size:4][metadata_json][frame_count:4][frame_sizes:frame_count*4][frame_data...]
-
-        uint32_t metadataSize;
-        file.read(reinterpret_cast<char *>(&metadataSize), sizeof(metadataSize));
-        if (!file.good()) {
-            return Result<std::pair<std::vector<std::vector<uint8_t>>, SourceFileInfo>>{
-                ServerError(ServerError::InvalidData, "Failed to read metadata size")};
-        }
-
-        // Validate metadata size to prevent memory exhaustion
-        constexpr uint32_t MAX_METADATA_SIZE = 64 * 1024; // 64KB should be more than enough
-        if (metadataSize == 0) {
-            return Result<std::pair<std::vector<std::vector<uint8_t>>, SourceFileInfo>>{
-                ServerError(ServerError::InvalidData, "Metadata size is zero")};
-        }
-        if (metadataSize > MAX_METADATA_SIZE) {
-            return Result<std::pair<std::vector<std::vector<uint8_t>>, SourceFileInfo>>{
-                ServerError(ServerError::InvalidData,
-                            fmt::format("Metadata size {} exceeds maximum {} bytes", metadataSize, MAX_METADATA_SIZE))};
-        }
-
-        std::string metadataJson;
-        try {
-            metadataJson.resize(metadataSize);
-        } catch (const std::bad_alloc &e) {
-            return Result<std::pair<std::vector<std::vector<uint8_t>>, SourceFileInfo>>{
-                ServerError(ServerError::InternalError,
-                            fmt::format("Failed to allocate {} bytes for metadata: {}", metadataSize, e.what()))};
-        }
-
-        file.read(metadataJson.data(), metadataSize);
-        if (!file.good() || static_cast<uint32_t>(file.gcount()) != metadataSize) {
-            return Result<std::pair<std::vector<std::vector<uint8_t>>, SourceFileInfo>>{
-                ServerError(ServerError::InvalidData, fmt::format("Failed to read metadata: expected {} bytes, got {}",
-                                                                  metadataSize, file.gcount()))};
-        }
-
-        // Parse metadata from JSON safely
-        SourceFileInfo sourceInfo;
-        auto jsonResult = JsonParser::parseJsonString(metadataJson, "audio cache metadata");
-        if (!jsonResult.isSuccess()) {
-            auto error = jsonResult.getError().value();
-            warn("Failed to parse audio cache metadata: {}", error.getMessage());
-            return Result<std::pair<std::vector<std::vector<uint8_t>>, SourceFileInfo>>{error};
-        }
-        try {
-            auto jsonData = jsonResult.getValue().value();
-            const auto cacheVersion = jsonData.value("version", 0U);
-            const bool formatMatches = cacheVersion == AUDIO_CACHE_FORMAT_VERSION &&
-                                       jsonData.value("sample_rate", 0) == RTP_SRATE &&
-                                       jsonData.value("channels", 0) == RTP_STREAMING_CHANNELS &&
-                                       jsonData.value("frame_ms", 0) == RTP_FRAME_MS &&
-                                       jsonData.value("priming_frames", 0) == RTP_PRIMING_FRAMES &&
-                                       jsonData.value("bitrate", 0) == RTP_BITRATE && jsonData.value("fec", false) &&
-                                       jsonData.value("opus_version", std::string{}) == opus_get_version_string();
-            if (!formatMatches) {
-                return Result<std::pair<std::vector<std::vector<uint8_t>>, SourceFileInfo>>{
-                    ServerError(ServerError::InvalidData, "Audio cache format or encoder fingerprint changed")};
-            }
-
-            sourceInfo.filePath = jsonData.at("path").get<std::string>();
-            sourceInfo.fileSize = jsonData.at("size").get<std::uintmax_t>();
-            sourceInfo.checksum = jsonData.at("checksum").get<std::string>();
-
-            // Get current modification time for the cached file path
-            // (we don't store modTime in JSON since it's not easily serializable)
-            if (std::filesystem::exists(sourceInfo.filePath)) {
-                sourceInfo.modTime = std::filesystem::last_write_time(sourceInfo.filePath);
-            } else {
-                return Result<std::pair<std::vector<std::vector<uint8_t>>, SourceFileInfo>>{
-                    ServerError(ServerError::NotFound,
-                                fmt::format("Cached source file no longer exists: {}", sourceInfo.filePath))};
-            }
-        } catch (const std::exception &e) {
-            return Result<std::pair<std::vector<std::vector<uint8_t>>, SourceFileInfo>>{ServerError(
-                ServerError::InvalidData, fmt::format("Failed to parse cache metadata JSON: {}", e.what()))};
-        }
-
-        uint32_t frameCount;
-        file.read(reinterpret_cast<char *>(&frameCount), sizeof(frameCount));
-        if (!file.good()) {
-            return Result<std::pair<std::vector<std::vector<uint8_t>>, SourceFileInfo>>{
-                ServerError(ServerError::InvalidData, "Failed to read frame count")};
-        }
-
-        // Validate frame count to prevent memory exhaustion attacks
-        constexpr uint32_t MAX_FRAME_COUNT = 2000000; // ~5.5 hours at 48kHz/10ms frames
-        if (frameCount == 0) {
-            return Result<std::pair<std::vector<std::vector<uint8_t>>, SourceFileInfo>>{
-                ServerError(ServerError::InvalidData, "Frame count is zero")};
-        }
-        if (frameCount > MAX_FRAME_COUNT) {
-            return Result<std::pair<std::vector<std::vector<uint8_t>>, SourceFileInfo>>{
-                ServerError(ServerError::InvalidData,
-                            fmt::format("Frame count {} exceeds maximum {} frames", frameCount, MAX_FRAME_COUNT))};
-        }
-
-        // Check for potential overflow in allocation size (only if SIZE_MAX allows it)
-        if constexpr (SIZE_MAX / sizeof(uint32_t) / 2 < UINT32_MAX) {
-            constexpr size_t MAX_ALLOCATION_SIZE = SIZE_MAX / sizeof(uint32_t) / 2;
-            if (frameCount > MAX_ALLOCATION_SIZE) {
-                return Result<std::pair<std::vector<std::vector<uint8_t>>, SourceFileInfo>>{
-                    ServerError(ServerError::InvalidData,
-                                fmt::format("Frame count {} would cause allocation overflow", frameCount))};
-            }
-        }
-
-        std::vector<uint32_t> frameSizes;
-        try {
-            frameSizes.resize(frameCount);
-        } catch (const std::bad_alloc &e) {
-            return Result<std::pair<std::vector<std::vector<uint8_t>>, SourceFileInfo>>{
-                ServerError(ServerError::InternalError,
-                            fmt::format("Failed to allocate memory for {} frame sizes: {}", frameCount, e.what()))};
-        }
-
-        const size_t bytesToRead = frameCount * sizeof(uint32_t);
-        file.read(reinterpret_cast<char *>(frameSizes.data()), bytesToRead);
-        if (!file.good() || static_cast<size_t>(file.gcount()) != bytesToRead) {
-            return Result<std::pair<std::vector<std::vector<uint8_t>>, SourceFileInfo>>{ServerError(
-                ServerError::InvalidData,
-                fmt::format("Failed to read frame sizes: expected {} bytes, got {}", bytesToRead, file.gcount()))};
-        }
-
-        std::vector<std::vector<uint8_t>> frames;
-        try {
-            frames.resize(frameCount);
-        } catch (const std::bad_alloc &e) {
-            return Result<std::pair<std::vector<std::vector<uint8_t>>, SourceFileInfo>>{
-                ServerError(ServerError::InternalError,
-                            fmt::format("Failed to allocate memory for {} frames: {}", frameCount, e.what()))};
-        }
-
-        // Validate and load individual frame data with size limits
-        constexpr uint32_t MAX_FRAME_SIZE = 8192; // 8KB per frame should be more than enough for Opus
-        size_t totalDataSize = 0;
-        constexpr size_t MAX_TOTAL_DATA_SIZE = 512 * 1024 * 1024; // 512MB total data limit
-
-        for (uint32_t i = 0; i < frameCount; ++i) {
-            // Validate individual frame size
-            if (frameSizes[i] > MAX_FRAME_SIZE) {
-                return Result<std::pair<std::vector<std::vector<uint8_t>>, SourceFileInfo>>{
-                    ServerError(ServerError::InvalidData, fmt::format("Frame {} size {} exceeds maximum {} bytes", i,
-                                                                      frameSizes[i], MAX_FRAME_SIZE))};
-            }
-
-            // Track total data size to prevent memory exhaustion
-            totalDataSize += frameSizes[i];
-            if (totalDataSize > MAX_TOTAL_DATA_SIZE) {
-                return Result<std::pair<std::vector<std::vector<uint8_t>>, SourceFileInfo>>{ServerError(
-                    ServerError::InvalidData, fmt::format("Total frame data size {} exceeds maximum {} bytes",
-                                                          totalDataSize, MAX_TOTAL_DATA_SIZE))};
-            }
-
-            try {
-                frames[i].resize(frameSizes[i]);
-            } catch (const std::bad_alloc &e) {
-                return Result<std::pair<std::vector<std::vector<uint8_t>>, SourceFileInfo>>{
-                    ServerError(ServerError::InternalError, fmt::format("Failed to allocate {} bytes for frame {}: {}",
-                                                                        frameSizes[i], i, e.what()))};
-            }
-
-            file.read(reinterpret_cast<char *>(frames[i].data()), frameSizes[i]);
-            if (!file.good() || static_cast<uint32_t>(file.gcount()) != frameSizes[i]) {
-                return Result<std::pair<std::vector<std::vector<uint8_t>>, SourceFileInfo>>{ServerError(
-                    ServerError::InvalidData, fmt::format("Failed to read frame {} data: expected {} bytes, got {}", i,
-                                                          frameSizes[i], file.gcount()))};
-            }
-        }
-
-        return Result<std::pair<std::vector<std::vector<uint8_t>>, SourceFileInfo>>{
-            std::make_pair(std::move(frames), sourceInfo)};
-
-    } catch (const std::exception &e) {
-        return Result<std::pair<std::vector<std::vector<uint8_t>>, SourceFileInfo>>{
-            ServerError(ServerError::InternalError, fmt::format("Exception loading cache file: {}", e.what()))};
-    }
-}
-
-Result<void> AudioCache::saveAsOggOpusWithMetadata(const std::string &oggFilePath,
-                                                   const std::vector<std::vector<uint8_t>> &frames,
-                                                   const SourceFileInfo &sourceInfo) const {
-
-    try {
-        std::ofstream file(oggFilePath, std::ios::binary);
-        if (!file.is_open()) {
-            return Result<void>(
-                ServerError(ServerError::Forbidden, fmt::format("Cannot create cache file: {}", oggFilePath)));
-        }
-
-        // Versioned internal packet format. This is intentionally not an Ogg
-        // container; it stores already packetized Opus frames for fast RTP use.
-        const nlohmann::json metadataJson = {
-            {"version", AUDIO_CACHE_FORMAT_VERSION},
-            {"path", sourceInfo.filePath},
-            {"size", sourceInfo.fileSize},
-            {"checksum", sourceInfo.checksum},
-            {"sample_rate", RTP_SRATE},
-            {"channels", RTP_STREAMING_CHANNELS},
-            {"frame_ms", RTP_FRAME_MS},
-            {"priming_frames", RTP_PRIMING_FRAMES},
-            {"bitrate", RTP_BITRATE},
-            {"fec", true},
-            {"opus_version", opus_get_version_string()},
-        };
-        const std::string metadata = metadataJson.dump();
-
-        uint32_t metadataSize = static_cast<uint32_t>(metadata.size());
-        file.write(reinterpret_cast<const char *>(&metadataSize), sizeof(metadataSize));
-        file.write(metadata.data(), metadata.size());
-
-        // Write frame count
-        uint32_t frameCount = static_cast<uint32_t>(frames.size());
-        file.write(reinterpret_cast<const char *>(&frameCount), sizeof(frameCount));
-
-        // Write frame sizes
-        for (const auto &frame : frames) {
-            uint32_t frameSize = static_cast<uint32_t>(frame.size());
-            file.write(reinterpret_cast<const char *>(&frameSize), sizeof(frameSize));
-        }
-
-        // Write frame data
-        for (const auto &frame : frames) {
-            file.write(reinterpret_cast<const char *>(frame.data()), frame.size());
-        }
-
-        if (!file.good()) {
-            return Result<void>(ServerError(ServerError::InternalError, "Failed to write cache file data"));
-        }
-
-        return Result<void>();
-
-    } catch (const std::exception &e) {
-        return Result<void>(
-            ServerError(ServerError::InternalError, fmt::format("Exception saving cache file: {}", e.what())));
-    }
-}
-
 Result<void> AudioCache::ensureCacheDirectoryWritable() const {
     try {
         // Create cache directory if it doesn't exist
@@ -826,18 +533,3 @@ Result<void> AudioCache::ensureCacheDirectoryWritable() const {
             ServerError(ServerError::InternalError, fmt::format("Failed to validate cache directory: {}", e.what())));
     }
 }
-
-bool AudioCache::allCacheFilesExist(const std::string &sourceFilePath) const {
-    const auto completeMarker = std::filesystem::path(getCacheDirectoryPath(sourceFilePath)) / CACHE_COMPLETE_MARKER;
-    if (!std::filesystem::is_regular_file(completeMarker)) {
-        return false;
-    }
-
-    for (uint8_t ch = 0; ch < RTP_STREAMING_CHANNELS; ++ch) {
-        auto cachePath = getCacheFilePath(sourceFilePath, ch);
-        if (!std::filesystem::exists(cachePath)) {
-            return false;
-        }
-    }
-    return true;
-}
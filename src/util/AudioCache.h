@@ -3,17 +3,16 @@
 //
 #pragma once
 
-#include <array>
 #include <atomic>
 #include <filesystem>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
-#include <vector>
 
 #include "server/config.h"
 #include "util/ObservabilityManager.h"
+#include "util/OpusFrameArena.h"
 #include "util/Result.h"
 
 namespace creatures::util {
@@ -22,8 +21,10 @@ namespace creatures::util {
  * @brief Fast cache for pre-encoded Opus audio files
  *
  * This class provides a caching layer for 17-channel WAV files that have been
- * encoded to Opus. Cached files use a versioned internal packet format with
- * source metadata for cache invalidation.
+ * encoded to Opus. Each sound is cached as one file (see OpusCacheFile.h)
+ * that's memory-mapped on a hit, and checked against the source's size and
+ * modification time, so a hit doesn't read or hash the WAV and doesn't copy
+ * any packets.
  */
 class AudioCache {
   public:
@@ -34,7 +35,7 @@ class AudioCache {
         std::string filePath;
         std::filesystem::file_time_type modTime;
         std::uintmax_t fileSize;
-        std::string checksum; // SHA-256 hash of file content
+        std::string checksum; // SHA-256 hash of file content (only filled in when saving)
 
         bool operator==(const SourceFileInfo &other) const {
             return filePath == other.filePath && modTime == other.modTime && fileSize == other.fileSize &&
@@ -44,10 +45,14 @@ class AudioCache {
 
     /**
      * @brief Cached audio data for all 17 channels
+     *
+     * The frames are shared as-is with whoever loads them (AudioStreamBuffer
+     * hands the same arena straight to the RTP server), so they're never copied.
+     * On a hit they're a view of the mapped cache file.
      */
     struct CachedAudioData {
         std::size_t framesPerChannel;
-        std::array<std::vector<std::vector<uint8_t>>, RTP_STREAMING_CHANNELS> encodedFrames;
+        std::shared_ptr<const OpusFrameArena> frames;
     };
 
     AudioCache(const std::string &soundDirectory);
@@ -56,7 +61,7 @@ class AudioCache {
     /**
      * @brief Try to load cached audio data for a source file
      *
-     * Checks if every channel packet file exists and matches the source.
+     * Maps the sound's cache file if there is one and it matches the source.
      *
      * @param sourceFilePath Path to source WAV file
      * @param parentSpan Optional telemetry span
@@ -65,11 +70,22 @@ class AudioCache {
     std::shared_ptr<CachedAudioData> tryLoadFromCache(const std::string &sourceFilePath,
                                                       std::shared_ptr<OperationSpan> parentSpan = nullptr);
 
+    /**
+     * @brief Check for a cache file that matches the source, without loading it
+     *
+     * Doesn't count as a hit or a miss, and leaves a stale cache file alone.
+     *
+     * @param sourceFilePath Path to source WAV file
+     * @return true if tryLoadFromCache() would hit
+     */
+    bool isCached(const std::string &sourceFilePath) const;
+
     /**
      * @brief Save encoded audio data to cache
      *
-     * Stores the encoded frames as packet files (one per channel) with embedded
-     * metadata about the source file and encoder configuration.
+     * Stores the encoded frames for every channel in one file, along with the
+     * source file's size, modification time, and checksum and a fingerprint of
+     * the encoder configuration.
      *
      * @param sourceFilePath Path to source WAV file
      * @param audioData Encoded audio data to cache
@@ -111,12 +127,12 @@ class AudioCache {
     mutable std::unordered_map<std::string, std::weak_ptr<CacheKeyMutex>> keyMutexes_;
 
     /**
-     * @brief Generate cache file path for a source file and channel
+     * @brief Generate cache file path for a source file
      */
-    std::string getCacheFilePath(const std::string &sourceFilePath, uint8_t channel) const;
+    std::string getCacheFilePath(const std::string &sourceFilePath) const;
 
     /**
-     * @brief Generate cache directory path for a source file
+     * @brief Generate cache directory path for a source file (where the old per-channel files went)
      */
     std::string getCacheDirectoryPath(const std::string &sourceFilePath) const;
 
@@ -124,36 +140,20 @@ class AudioCache {
 
     /**
      * @brief Extract source file information for cache validation
+     *
+     * @param includeChecksum hash the whole file too (only needed when saving)
      */
-    Result<SourceFileInfo> getSourceFileInfo(const std::string &filePath) const;
+    Result<SourceFileInfo> getSourceFileInfo(const std::string &filePath, bool includeChecksum) const;
 
     /**
      * @brief Calculate SHA-256 checksum of a file (fast, streaming)
      */
     Result<std::string> calculateFileChecksum(const std::string &filePath) const;
 
-    /**
-     * @brief Load OGG Opus file and extract embedded metadata
-     */
-    Result<std::pair<std::vector<std::vector<uint8_t>>, SourceFileInfo>>
-    loadOggOpusWithMetadata(const std::string &oggFilePath) const;
-
-    /**
-     * @brief Save audio frames as OGG Opus with embedded metadata
-     */
-    Result<void> saveAsOggOpusWithMetadata(const std::string &oggFilePath,
-                                           const std::vector<std::vector<uint8_t>> &frames,
-                                           const SourceFileInfo &sourceInfo) const;
-
     /**
      * @brief Ensure cache directory exists and is writable
      */
     Result<void> ensureCacheDirectoryWritable() const;
-
-    /**
-     * @brief Check if all cache files exist for a source file
-     */
-    bool allCacheFilesExist(const std::string &sourceFilePath) const;
 };
 
 } // namespace creatures::util
@@ -0,0 +1,166 @@
+#include "util/Base64.h"
+
+#include <array>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CREATURES_BASE64_SSSE3 1
+#endif
+
+namespace creatures::util {
+
+namespace {
+
+    constexpr uint8_t kInvalid = 0xFF;
+
+    constexpr std::array<uint8_t, 256> makeDecodeTable() {
+        constexpr std::string_view alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::array<uint8_t, 256> table{};
+        table.fill(kInvalid);
+        for (std::size_t i = 0; i < alphabet.size(); ++i) {
+            table[static_cast<uint8_t>(alphabet[i])] = static_cast<uint8_t>(i);
+        }
+        return table;
+    }
+
+    constexpr auto kDecode = makeDecodeTable();
+
+    // Four characters without padding into three bytes
+    inline bool decodeQuartet(const char *in, uint8_t *out) {
+        const uint32_t a = kDecode[static_cast<uint8_t>(in[0])];
+        const uint32_t b = kDecode[static_cast<uint8_t>(in[1])];
+        const uint32_t c = kDecode[static_cast<uint8_t>(in[2])];
+        const uint32_t d = kDecode[static_cast<uint8_t>(in[3])];
+        if ((a | b | c | d) & 0x80) {
+            return false;
+        }
+        const uint32_t bits = a << 18 | b << 12 | c << 6 | d;
+        out[0] = static_cast<uint8_t>(bits >> 16);
+        out[1] = static_cast<uint8_t>(bits >> 8);
+        out[2] = static_cast<uint8_t>(bits);
+        return true;
+    }
+
+#ifdef CREATURES_BASE64_SSSE3
+
+    /**
+     * Decode 16 characters at a time into 12 bytes (Muła & Lemire's SSSE3
+     * approach: classify each character by its nibbles, add the right offset
+     * to turn it into its 6 bit value, then squeeze the 6 bit values together).
+     *
+     * Each store writes 16 bytes, so we stop while there's still at least 24
+     * characters left. That also keeps the padded last quartet for the scalar
+     * code. Stops early on anything that isn't base64 and lets the scalar code
+     * find it.
+     *
+     * @return how many characters were decoded
+     */
+    __attribute__((target("ssse3"))) std::size_t decodeBlocksSsse3(const char *in, std::size_t length, uint8_t *out) {
+        const __m128i lutLo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A,
+                                            0x1B, 0x1B, 0x1B, 0x1A);
+        const __m128i lutHi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10,
+                                            0x10, 0x10, 0x10, 0x10);
+        const __m128i lutRoll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+        const __m128i nibbleMask = _mm_set1_epi8(0x0F);
+        const __m128i slash = _mm_set1_epi8('/');
+        const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+        std::size_t consumed = 0;
+        while (length - consumed >= 24) {
+            __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + consumed));
+
+            const __m128i hiNibbles = _mm_and_si128(_mm_srli_epi32(chars, 4), nibbleMask);
+            const __m128i loNibbles = _mm_and_si128(chars, nibbleMask);
+            const __m128i hi = _mm_shuffle_epi8(lutHi, hiNibbles);
+            const __m128i lo = _mm_shuffle_epi8(lutLo, loNibbles);
+            if (_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128())) != 0) {
+                break;
+            }
+
+            // '/' shares its high nibble with '+', so it gets its own offset
+            const __m128i isSlash = _mm_cmpeq_epi8(chars, slash);
+            const __m128i roll = _mm_shuffle_epi8(lutRoll, _mm_add_epi8(isSlash, hiNibbles));
+            chars = _mm_add_epi8(chars, roll);
+
+            // 00aaaaaa 00bbbbbb 00cccccc 00dddddd -> aaaaaabb bbbbcccc ccdddddd
+            const __m128i pairs = _mm_maddubs_epi16(chars, _mm_set1_epi32(0x01400140));
+            const __m128i quads = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + consumed / 4 * 3), _mm_shuffle_epi8(quads, pack));
+
+            consumed += 16;
+        }
+        return consumed;
+    }
+
+    bool haveSsse3() {
+        static const bool have = __builtin_cpu_supports("ssse3");
+        return have;
+    }
+
+#endif
+
+} // namespace
+
+std::optional<std::size_t> base64DecodedSize(std::string_view encoded) {
+    if (encoded.size() % 4 != 0) {
+        return std::nullopt;
+    }
+    std::size_t size = encoded.size() / 4 * 3;
+    if (!encoded.empty() && encoded.back() == '=') {
+        --size;
+        if (encoded[encoded.size() - 2] == '=') {
+            --size;
+        }
+    }
+    return size;
+}
+
+bool base64DecodeInto(std::string_view encoded, std::span<uint8_t> out) {
+    const auto size = base64DecodedSize(encoded);
+    if (!size || *size != out.size()) {
+        return false;
+    }
+    if (encoded.empty()) {
+        return true;
+    }
+
+    const char *in = encoded.data();
+    uint8_t *bytes = out.data();
+    std::size_t consumed = 0;
+
+#ifdef CREATURES_BASE64_SSSE3
+    if (haveSsse3()) {
+        consumed = decodeBlocksSsse3(in, encoded.size(), bytes);
+    }
+#endif
+
+    // Everything up to the last quartet, which is the only one that can have padding
+    const std::size_t lastQuartet = encoded.size() - 4;
+    for (; consumed < lastQuartet; consumed += 4) {
+        if (!decodeQuartet(in + consumed, bytes + consumed / 4 * 3)) {
+            return false;
+        }
+    }
+
+    const char *tail = in + lastQuartet;
+    uint8_t *tailOut = bytes + lastQuartet / 4 * 3;
+    const std::size_t padding = encoded.size() / 4 * 3 - *size;
+    if (padding == 0) {
+        return decodeQuartet(tail, tailOut);
+    }
+
+    const uint32_t a = kDecode[static_cast<uint8_t>(tail[0])];
+    const uint32_t b = kDecode[static_cast<uint8_t>(tail[1])];
+    const uint32_t c = padding == 1 ? kDecode[static_cast<uint8_t>(tail[2])] : 0;
+    if ((a | b | c) & 0x80) {
+        return false;
+    }
+    const uint32_t bits = a << 18 | b << 12 | c << 6;
+    tailOut[0] = static_cast<uint8_t>(bits >> 16);
+    if (padding == 1) {
+        tailOut[1] = static_cast<uint8_t>(bits >> 8);
+    }
+    return true;
+}
+
+} // namespace creatures::util
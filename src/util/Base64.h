@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace creatures::util {
+
+/**
+ * Decoding base64 straight into a buffer we already own
+ *
+ * base64::from_base64() hands back a fresh std::string every call, which is
+ * fine for the odd blob but adds up when we're unpacking thousands of DMX
+ * frames into one PackedFrames buffer. These write into the caller's span
+ * instead, and use SSSE3 for the long runs when the CPU has it.
+ *
+ * Only padded, standard-alphabet base64 is accepted (same as base64.hpp).
+ */
+
+/** @return how many bytes `encoded` decodes to, or nullopt if its length can't be base64 */
+[[nodiscard]] std::optional<std::size_t> base64DecodedSize(std::string_view encoded);
+
+/**
+ * Decode `encoded` into `out`, which must be exactly base64DecodedSize() bytes
+ *
+ * @return false if `encoded` has a character that isn't base64, or `out` is the wrong size
+ */
+[[nodiscard]] bool base64DecodeInto(std::string_view encoded, std::span<uint8_t> out);
+
+} // namespace creatures::util
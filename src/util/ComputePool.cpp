@@ -0,0 +1,304 @@
+#include "ComputePool.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <string_view>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#include <fmt/format.h>
+
+#include "server/namespace-stuffs.h"
+#include "util/threadName.h"
+
+namespace creatures::util {
+
+namespace {
+
+// Which pool (if any) the current thread works for, and which worker it is
+thread_local const ComputePool *currentPool = nullptr;
+thread_local std::size_t currentWorker = 0;
+
+std::mutex sharedPoolMutex;
+std::shared_ptr<ComputePool> sharedPool;
+
+// Highest CPU number parseCpuList() accepts
+constexpr int MAX_CPU = 4095;
+
+} // namespace
+
+ComputePool::ComputePool(std::size_t threads, std::vector<int> _cpus, std::string _name)
+    : cpus(std::move(_cpus)), name(std::move(_name)) {
+    if (threads == 0) {
+        throw std::invalid_argument("ComputePool requires at least one thread");
+    }
+
+    queues.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    workers.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i) {
+        workers.emplace_back(&ComputePool::workerLoop, this, i);
+    }
+    debug("compute pool {} started with {} threads on {} CPUs", name, threads,
+          cpus.empty() ? std::string{"any"} : fmt::to_string(cpus.size()));
+}
+
+ComputePool::~ComputePool() {
+    {
+        std::lock_guard lock(sleepMutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+
+    for (auto &worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void ComputePool::submit(Task task) {
+    // Our own workers keep what they make; everybody else's is dealt out in turn
+    const auto index = currentPool == this ? currentWorker
+                                           : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    {
+        std::lock_guard lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    queued.fetch_add(1, std::memory_order_release);
+
+    // Taking the lock makes sure a worker that just found nothing to do is waiting before we wake it
+    {
+        std::lock_guard lock(sleepMutex);
+    }
+    workAvailable.notify_one();
+}
+
+void ComputePool::parallelFor(std::size_t count, const std::function<void(std::size_t)> &body) {
+    if (count == 0) {
+        return;
+    }
+
+    struct Group {
+        std::mutex mutex;
+        std::condition_variable finished;
+        std::size_t remaining;
+        std::exception_ptr firstError;
+    } group;
+    group.remaining = count;
+
+    for (std::size_t i = 0; i < count; ++i) {
+        submit([&group, &body, i] {
+            std::exception_ptr thrown;
+            try {
+                body(i);
+            } catch (...) {
+                thrown = std::current_exception();
+            }
+
+            // Everything happens under the lock so the waiter can't return (and the group go away) early
+            std::lock_guard lock(group.mutex);
+            if (thrown && !group.firstError) {
+                group.firstError = thrown;
+            }
+            if (--group.remaining == 0) {
+                group.finished.notify_all();
+            }
+        });
+    }
+
+    if (currentPool == this) {
+        // One of our workers; tying it up while it waits could leave nobody to do the work
+        while (true) {
+            {
+                std::lock_guard lock(group.mutex);
+                if (group.remaining == 0) {
+                    break;
+                }
+            }
+            if (auto task = takeTask(currentWorker)) {
+                runTask(*task);
+                continue;
+            }
+            // Everything left of ours is already running somewhere
+            std::unique_lock lock(group.mutex);
+            group.finished.wait(lock, [&group] { return group.remaining == 0; });
+            break;
+        }
+    } else {
+        std::unique_lock lock(group.mutex);
+        group.finished.wait(lock, [&group] { return group.remaining == 0; });
+    }
+
+    std::lock_guard lock(group.mutex);
+    if (group.firstError) {
+        std::rethrow_exception(group.firstError);
+    }
+}
+
+ComputePool::Stats ComputePool::getStats() const {
+    return Stats{tasksRun.load(std::memory_order_relaxed), tasksStolen.load(std::memory_order_relaxed)};
+}
+
+std::shared_ptr<ComputePool> ComputePool::shared() {
+    std::lock_guard lock(sharedPoolMutex);
+    if (!sharedPool) {
+        sharedPool = std::make_shared<ComputePool>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    return sharedPool;
+}
+
+void ComputePool::setShared(std::shared_ptr<ComputePool> pool) {
+    std::shared_ptr<ComputePool> previous;
+    {
+        std::lock_guard lock(sharedPoolMutex);
+        previous = std::exchange(sharedPool, std::move(pool));
+    }
+    // The old pool (if this was the last of it) finishes its work and stops here, outside the lock
+}
+
+std::vector<int> ComputePool::allowedCpus() {
+    std::vector<int> allowed;
+#if defined(__linux__)
+    cpu_set_t affinity;
+    CPU_ZERO(&affinity);
+    if (sched_getaffinity(0, sizeof(affinity), &affinity) != 0) {
+        warn("Unable to read this thread's CPU affinity: {}", std::strerror(errno));
+        return allowed;
+    }
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &affinity)) {
+            allowed.push_back(cpu);
+        }
+    }
+#endif
+    return allowed;
+}
+
+Result<std::vector<int>> ComputePool::parseCpuList(const std::string &list) {
+    using ParseResult = Result<std::vector<int>>;
+    const auto invalid = [&list](const std::string &why) {
+        return ParseResult{ServerError(ServerError::InvalidData, fmt::format("Invalid CPU list '{}': {}", list, why))};
+    };
+
+    const auto parseCpu = [](std::string_view text, int &cpu) {
+        const auto *end = text.data() + text.size();
+        const auto [stoppedAt, status] = std::from_chars(text.data(), end, cpu);
+        return status == std::errc{} && stoppedAt == end && cpu >= 0 && cpu <= MAX_CPU;
+    };
+
+    std::vector<int> parsed;
+    std::string_view remaining = list;
+    while (!remaining.empty()) {
+        const auto comma = remaining.find(',');
+        const auto range = remaining.substr(0, comma);
+        remaining = comma == std::string_view::npos ? std::string_view{} : remaining.substr(comma + 1);
+
+        int first = 0;
+        int last = 0;
+        if (const auto dash = range.find('-'); dash == std::string_view::npos) {
+            if (!parseCpu(range, first)) {
+                return invalid(fmt::format("'{}' isn't a CPU number", range));
+            }
+            last = first;
+        } else if (!parseCpu(range.substr(0, dash), first) || !parseCpu(range.substr(dash + 1), last) ||
+                   last < first) {
+            return invalid(fmt::format("'{}' isn't a range of CPUs", range));
+        }
+        for (int cpu = first; cpu <= last; ++cpu) {
+            parsed.push_back(cpu);
+        }
+    }
+
+    std::sort(parsed.begin(), parsed.end());
+    parsed.erase(std::unique(parsed.begin(), parsed.end()), parsed.end());
+    if (parsed.empty()) {
+        return invalid("it's empty");
+    }
+    return ParseResult{parsed};
+}
+
+Result<void> ComputePool::pinThisThread(const std::vector<int> &cpuList) {
+#if defined(__linux__)
+    if (!cpuList.empty()) {
+        cpu_set_t affinity;
+        CPU_ZERO(&affinity);
+        for (const auto cpu : cpuList) {
+            if (cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &affinity);
+            }
+        }
+        if (sched_setaffinity(0, sizeof(affinity), &affinity) != 0) {
+            return Result<void>{ServerError(ServerError::InternalError, std::strerror(errno))};
+        }
+    }
+#endif
+    return Result<void>{};
+}
+
+void ComputePool::workerLoop(std::size_t index) {
+    currentPool = this;
+    currentWorker = index;
+    setThreadName(fmt::format("{}{}", name, index));
+
+    if (const auto pinned = pinThisThread(cpus); !pinned.isSuccess()) {
+        warn("Unable to pin compute pool {} to its CPUs: {}", name, pinned.getError()->getMessage());
+    }
+
+    while (true) {
+        if (auto task = takeTask(index)) {
+            runTask(*task);
+            continue;
+        }
+
+        std::unique_lock lock(sleepMutex);
+        workAvailable.wait(lock, [this] { return stopping || queued.load(std::memory_order_acquire) > 0; });
+        if (stopping && queued.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+    }
+}
+
+std::optional<ComputePool::Task> ComputePool::takeTask(std::size_t index) {
+    for (std::size_t offset = 0; offset < queues.size(); ++offset) {
+        auto &queue = *queues[(index + offset) % queues.size()];
+        std::lock_guard lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            continue;
+        }
+
+        std::optional<Task> task;
+        if (offset == 0) {
+            task.emplace(std::move(queue.tasks.back()));
+            queue.tasks.pop_back();
+        } else {
+            task.emplace(std::move(queue.tasks.front()));
+            queue.tasks.pop_front();
+            tasksStolen.fetch_add(1, std::memory_order_relaxed);
+        }
+        queued.fetch_sub(1, std::memory_order_relaxed);
+        return task;
+    }
+    return std::nullopt;
+}
+
+void ComputePool::runTask(Task &task) {
+    try {
+        task();
+    } catch (const std::exception &e) {
+        error("A task on compute pool {} failed: {}", name, e.what());
+    } catch (...) {
+        error("A task on compute pool {} failed", name);
+    }
+    tasksRun.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace creatures::util
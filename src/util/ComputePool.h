@@ -0,0 +1,138 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "util/Result.h"
+
+namespace creatures::util {
+
+/**
+ * A fixed set of worker threads for CPU-heavy audio work (Opus, MP3 and Ogg encoding, downmixing)
+ *
+ * Every worker has its own queue. Work submitted from outside the pool is
+ * dealt out to the queues in turn, work submitted from a worker goes on that
+ * worker's own queue, and a worker that runs out steals from the others.
+ *
+ * The workers can be pinned to a set of CPUs. Keeping them off the cores the
+ * event loop and the RTP sender run on means a burst of cache-miss encodes
+ * can't make either of those late.
+ *
+ * There's one pool for the whole process (shared()), configured at startup.
+ * Things that need to stay within a tighter budget (the audio cache
+ * prewarmer) make their own.
+ */
+class ComputePool {
+
+  public:
+    using Task = std::function<void()>;
+
+    struct Stats {
+        uint64_t tasksRun{0};
+        uint64_t tasksStolen{0}; // run by a worker other than the one they were queued for
+    };
+
+    /**
+     * Starts the workers
+     *
+     * @param threads how many workers (at least one)
+     * @param cpus the CPUs the workers may run on; empty leaves them wherever the thread that made the pool may run
+     * @param name the workers are named this, plus their number
+     */
+    explicit ComputePool(std::size_t threads, std::vector<int> cpus = {}, std::string name = "Compute");
+
+    /** Finishes everything that's queued, then stops the workers */
+    ~ComputePool();
+
+    ComputePool(const ComputePool &) = delete;
+    ComputePool &operator=(const ComputePool &) = delete;
+
+    /** Queue a task and return right away. Exceptions it throws are logged and dropped. */
+    void submit(Task task);
+
+    /**
+     * Run body(0) through body(count - 1) on the pool and wait for all of them
+     *
+     * Safe to call from one of the pool's own workers; it runs queued work
+     * while it waits instead of blocking a worker. If any of them throw, the
+     * first exception is rethrown once they've all finished.
+     */
+    void parallelFor(std::size_t count, const std::function<void(std::size_t)> &body);
+
+    /** Run one function on the pool, wait for it, and hand back what it returned (or rethrow what it threw) */
+    template <typename Function> auto run(Function &&function) -> std::invoke_result_t<Function &> {
+        using Value = std::invoke_result_t<Function &>;
+        if constexpr (std::is_void_v<Value>) {
+            parallelFor(1, [&function](std::size_t) { function(); });
+        } else {
+            std::optional<Value> value;
+            parallelFor(1, [&function, &value](std::size_t) { value.emplace(function()); });
+            return std::move(*value);
+        }
+    }
+
+    [[nodiscard]] std::size_t threadCount() const { return workers.size(); }
+
+    /** The CPUs the workers are pinned to (empty if they aren't) */
+    [[nodiscard]] const std::vector<int> &getCpus() const { return cpus; }
+
+    [[nodiscard]] Stats getStats() const;
+
+    /** The process-wide pool. Until setShared() is called it's one worker per CPU, unpinned. */
+    static std::shared_ptr<ComputePool> shared();
+
+    /** Replace the process-wide pool; the old one stops once nothing's using it any more */
+    static void setShared(std::shared_ptr<ComputePool> pool);
+
+    /** The CPUs this thread is allowed to run on, lowest first (empty if that can't be found out) */
+    static std::vector<int> allowedCpus();
+
+    /** Parse a CPU list like "2-7,12" (the format taskset and isolcpus use) */
+    static Result<std::vector<int>> parseCpuList(const std::string &list);
+
+    /** Keep the calling thread on these CPUs; an empty list leaves it where it is */
+    static Result<void> pinThisThread(const std::vector<int> &cpuList);
+
+  private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void workerLoop(std::size_t index);
+
+    // Our own newest task first, then the oldest one from anybody else
+    std::optional<Task> takeTask(std::size_t index);
+
+    void runTask(Task &task);
+
+    const std::vector<int> cpus;
+    const std::string name;
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::atomic<std::size_t> queued{0};
+    std::atomic<std::size_t> nextQueue{0};
+
+    std::mutex sleepMutex;
+    std::condition_variable workAvailable;
+    bool stopping = false;
+
+    std::atomic<uint64_t> tasksRun{0};
+    std::atomic<uint64_t> tasksStolen{0};
+
+    std::vector<std::thread> workers;
+};
+
+} // namespace creatures::util
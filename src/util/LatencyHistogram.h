@@ -0,0 +1,158 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace creatures {
+
+/**
+ * Always-on, fixed-size histogram of durations (or any non-negative count), HDR style.
+ *
+ * Values land in log-linear buckets: every power of two is split into
+ * SUB_BUCKETS equal slices, so anything read back is within 1/SUB_BUCKETS
+ * (12.5%) of what was recorded, from 1 up to 2^MAX_VALUE_BITS (about 18
+ * minutes in nanoseconds). Bigger values are counted in the top bucket.
+ *
+ * Exactly one thread may call record(). Any thread may call snapshot(). The
+ * writer only does relaxed loads and stores, with no locks and no
+ * read-modify-write instructions, so it's cheap enough to run on every event
+ * loop tick. A snapshot taken mid-record() can be a sample behind in some
+ * fields, which doesn't matter for metrics.
+ *
+ * Histograms that several threads write to use recordConcurrent() instead,
+ * which does the same with relaxed read-modify-writes. Don't mix the two on
+ * one histogram.
+ */
+class LatencyHistogram {
+  public:
+    static constexpr unsigned SUB_BUCKET_BITS = 3;
+    static constexpr std::size_t SUB_BUCKETS = std::size_t{1} << SUB_BUCKET_BITS;
+    static constexpr unsigned MAX_VALUE_BITS = 40;
+    static constexpr uint64_t MAX_VALUE = (uint64_t{1} << MAX_VALUE_BITS) - 1;
+    static constexpr std::size_t BUCKETS = SUB_BUCKETS * (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1);
+
+    /** A copy of the histogram that can be read at leisure */
+    struct Snapshot {
+        uint64_t count = 0;
+        uint64_t sum = 0;
+        uint64_t max = 0;
+        std::array<uint64_t, BUCKETS> buckets = {};
+
+        [[nodiscard]] double mean() const { return count ? static_cast<double>(sum) / static_cast<double>(count) : 0.0; }
+
+        /**
+         * @param percentile 0 to 100
+         * @return the highest value that's equivalent (same bucket) to the one at that percentile, 0 if empty
+         */
+        [[nodiscard]] uint64_t valueAtPercentile(double percentile) const {
+            if (count == 0) {
+                return 0;
+            }
+            const auto wanted = std::max<uint64_t>(
+                1, static_cast<uint64_t>(std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * count)));
+            uint64_t seen = 0;
+            for (std::size_t i = 0; i < BUCKETS; ++i) {
+                seen += buckets[i];
+                if (seen >= wanted) {
+                    return std::min(bucketHighest(i), max);
+                }
+            }
+            return max;
+        }
+
+        /** @return what was recorded after `earlier` (max stays the overall max, capped by the buckets) */
+        [[nodiscard]] Snapshot since(const Snapshot &earlier) const {
+            Snapshot delta;
+            delta.count = count - earlier.count;
+            delta.sum = sum - earlier.sum;
+            for (std::size_t i = 0; i < BUCKETS; ++i) {
+                delta.buckets[i] = buckets[i] - earlier.buckets[i];
+                if (delta.buckets[i] != 0) {
+                    delta.max = std::min(bucketHighest(i), max);
+                }
+            }
+            return delta;
+        }
+    };
+
+    void record(uint64_t value) {
+        value = std::min(value, MAX_VALUE);
+        bump(buckets[bucketFor(value)]);
+        bump(count);
+        sum.store(sum.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        if (value > max.load(std::memory_order_relaxed)) {
+            max.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    /** record(), for when more than one thread records into this histogram */
+    void recordConcurrent(uint64_t value) {
+        value = std::min(value, MAX_VALUE);
+        buckets[bucketFor(value)].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(value, std::memory_order_relaxed);
+        auto seen = max.load(std::memory_order_relaxed);
+        while (value > seen && !max.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    [[nodiscard]] Snapshot snapshot() const {
+        Snapshot copy;
+        for (std::size_t i = 0; i < BUCKETS; ++i) {
+            copy.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+            copy.count += copy.buckets[i];
+        }
+        copy.sum = sum.load(std::memory_order_relaxed);
+        copy.max = max.load(std::memory_order_relaxed);
+        return copy;
+    }
+
+    [[nodiscard]] uint64_t totalCount() const { return count.load(std::memory_order_relaxed); }
+
+    /** @return which bucket a value goes in */
+    static constexpr std::size_t bucketFor(uint64_t value) {
+        value = std::min(value, MAX_VALUE);
+        if (value < SUB_BUCKETS) {
+            return static_cast<std::size_t>(value);
+        }
+        const auto magnitude = static_cast<unsigned>(std::bit_width(value)); // > SUB_BUCKET_BITS
+        const auto shift = magnitude - SUB_BUCKET_BITS - 1;
+        const auto subBucket = static_cast<std::size_t>(value >> shift) - SUB_BUCKETS;
+        return SUB_BUCKETS * (magnitude - SUB_BUCKET_BITS) + subBucket;
+    }
+
+    /** @return the smallest value that lands in a bucket */
+    static constexpr uint64_t bucketLowest(std::size_t bucket) {
+        if (bucket < SUB_BUCKETS) {
+            return bucket;
+        }
+        const auto segment = bucket / SUB_BUCKETS;
+        return (SUB_BUCKETS + bucket % SUB_BUCKETS) << (segment - 1);
+    }
+
+    /** @return the largest value that lands in a bucket */
+    static constexpr uint64_t bucketHighest(std::size_t bucket) {
+        if (bucket < SUB_BUCKETS) {
+            return bucket;
+        }
+        return bucketLowest(bucket) + (uint64_t{1} << (bucket / SUB_BUCKETS - 1)) - 1;
+    }
+
+  private:
+    // Only the writer ever stores, so a plain load + store is enough
+    static void bump(std::atomic<uint64_t> &counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<uint64_t>, BUCKETS> buckets = {};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> max{0};
+};
+
+} // namespace creatures
@@ -131,6 +131,9 @@ void ObservabilityManager::initializeMetricInstruments() {
     totalFramesCounter_ = meter_->CreateUInt64Counter("creature_server_total_frames",
                                                       "Total number of frames processed by the event loop", "{frames}");
 
+    eventLoopBlockedFramesCounter_ = meter_->CreateUInt64Counter(
+        "creature_server_event_loop_blocked_frames", "Total event loop frames that waited on database I/O", "{frames}");
+
     eventsProcessedCounter_ = meter_->CreateUInt64Counter(
         "creature_server_events_processed", "Total number of events processed by the event loop", "{events}");
 
@@ -164,6 +167,9 @@ void ObservabilityManager::initializeMetricInstruments() {
     rtpEventsProcessedCounter_ = meter_->CreateUInt64Counter(
         "creature_server_rtp_events_processed", "Total number of RTP audio chunk events processed", "{events}");
 
+    rtpEncodeUnderrunsCounter_ = meter_->CreateUInt64Counter(
+        "creature_server_rtp_encode_underruns", "Total RTP packets held back waiting on the Opus encoder", "{packets}");
+
     rtpSendFailuresCounter_ = meter_->CreateUInt64Counter("creature_server_rtp_send_failures",
                                                           "Total number of failed RTP output sends", "{failures}");
 
@@ -179,6 +185,41 @@ void ObservabilityManager::initializeMetricInstruments() {
         "creature_server_rtp_circuit_breaker_trips",
         "Total times the RTP send-failure circuit breaker terminated an output generation", "{trips}");
 
+    rtpSendSyscallsCounter_ =
+        meter_->CreateUInt64Counter("creature_server_rtp_send_syscalls",
+                                    "Total calls into the kernel the RTP output made to send frame sets", "{calls}");
+
+    rtpMixerUnderrunsCounter_ = meter_->CreateUInt64Counter(
+        "creature_server_rtp_mixer_underruns",
+        "Total frames a mixed RTP track had no audio ready for and played silence instead", "{frames}");
+
+    rtpPacketsSuppressedCounter_ =
+        meter_->CreateUInt64Counter("creature_server_rtp_packets_suppressed",
+                                    "Total RTP packets left unsent because their channel was silent", "{packets}");
+
+    rtpFrameSetSendLatencyGauge_ = meter_->CreateDoubleGauge(
+        "creature_server_rtp_frame_set_send_latency",
+        "Time to hand each RTP frame set (every channel) to the kernel since the last export, by quantile", "us");
+
+    rtpPacketJitterGauge_ = meter_->CreateDoubleGauge(
+        "creature_server_rtp_packet_jitter",
+        "How far each RTP packet's send time strayed from its timestamp since the last export, by channel and quantile",
+        "us");
+
+    rtpPacingLatenessGauge_ = meter_->CreateDoubleGauge(
+        "creature_server_rtp_pacing_lateness",
+        "How late the paced RTP output woke up for each frame set since the last export, by quantile", "us");
+
+    websocketSerializationGauge_ = meter_->CreateDoubleGauge(
+        "creature_server_websocket_serialization_time",
+        "Time to serialize each websocket message since the last export, by message type and quantile", "us");
+
+    streamFrameLatencyGauge_ = meter_->CreateDoubleGauge(
+        "creature_server_stream_frame_latency",
+        "Time from a streamed frame arriving to it being written to its universe since the last export, by path and "
+        "quantile",
+        "us");
+
     rtpAudioLoadersActiveGauge_ = meter_->CreateDoubleGauge(
         "creature_server_rtp_audio_loaders_active", "Cooperative RTP audio loader jobs currently running", "{jobs}");
 
@@ -203,6 +244,22 @@ void ObservabilityManager::initializeMetricInstruments() {
         meter_->CreateUInt64Counter("creature_server_rtp_audio_loads_failed",
                                     "Total cooperative RTP audio loader jobs that threw an exception", "{jobs}");
 
+    audioPrewarmPendingGauge_ = meter_->CreateDoubleGauge(
+        "creature_server_audio_prewarm_pending", "Sounds left in the audio cache prewarmer's current scan", "{sounds}");
+
+    audioPrewarmScansCounter_ = meter_->CreateUInt64Counter(
+        "creature_server_audio_prewarm_scans", "Total times the audio cache prewarmer checked every sound", "{scans}");
+
+    audioPrewarmCheckedCounter_ = meter_->CreateUInt64Counter(
+        "creature_server_audio_prewarm_checked", "Total sounds the audio cache prewarmer has checked", "{sounds}");
+
+    audioPrewarmEncodedCounter_ = meter_->CreateUInt64Counter(
+        "creature_server_audio_prewarm_encoded", "Total sounds the audio cache prewarmer had to encode", "{sounds}");
+
+    audioPrewarmFailedCounter_ =
+        meter_->CreateUInt64Counter("creature_server_audio_prewarm_failed",
+                                    "Total sounds the audio cache prewarmer was unable to encode", "{sounds}");
+
     localAudioPlaybacksActiveGauge_ = meter_->CreateDoubleGauge("creature_server_local_audio_playbacks_active",
                                                                 "Local audio device jobs currently running", "{jobs}");
 
@@ -210,6 +267,14 @@ void ObservabilityManager::initializeMetricInstruments() {
         meter_->CreateDoubleGauge("creature_server_local_audio_playbacks_queued",
                                   "Local audio jobs waiting in the last-request-wins slot", "{jobs}");
 
+    eventLoopLatencyGauge_ = meter_->CreateDoubleGauge(
+        "creature_server_event_loop_latency",
+        "Event loop tick and event timings since the last export, by histogram and quantile", "us");
+
+    eventLoopEventsPerTickGauge_ =
+        meter_->CreateDoubleGauge("creature_server_event_loop_events_per_tick",
+                                  "Events run per event loop tick since the last export, by quantile", "{events}");
+
     localAudioPlaybacksAcceptedCounter_ = meter_->CreateUInt64Counter(
         "creature_server_local_audio_playbacks_accepted", "Total local audio playback jobs admitted", "{jobs}");
 
@@ -253,6 +318,18 @@ void ObservabilityManager::initializeMetricInstruments() {
     websocketPongsReceivedCounter_ = meter_->CreateUInt64Counter("creature_server_websocket_pongs_received",
                                                                  "Total number of WebSocket pongs received", "{pongs}");
 
+    websocketMessagesCoalescedCounter_ = meter_->CreateUInt64Counter(
+        "creature_server_websocket_messages_coalesced",
+        "Total WebSocket messages that replaced a stale copy still queued for a client", "{messages}");
+
+    websocketMessagesDroppedCounter_ = meter_->CreateUInt64Counter(
+        "creature_server_websocket_messages_dropped",
+        "Total WebSocket messages dropped because a client had fallen behind", "{messages}");
+
+    websocketSlowClientHangupsCounter_ =
+        meter_->CreateUInt64Counter("creature_server_websocket_slow_client_hangups",
+                                    "Total WebSocket clients hung up on for falling too far behind", "{clients}");
+
     // Initialize sensor metric instruments (gauges for current readings)
     boardTemperatureGauge_ = meter_->CreateDoubleGauge("creature_server_board_temperature",
                                                        "Current board temperature for each creature", "[degF]");
@@ -293,6 +370,7 @@ void ObservabilityManager::exportMetrics(const std::shared_ptr<SystemCounters> &
     // we need to track the previous values and only send the difference.
     // (Gauges below need none of this — they Record() the absolute value.)
     static std::atomic<uint64_t> lastTotalFrames{0};
+    static std::atomic<uint64_t> lastEventLoopBlockedFrames{0};
     static std::atomic<uint64_t> lastEventsProcessed{0};
     static std::atomic<uint64_t> lastFramesStreamed{0};
     static std::atomic<uint64_t> lastDmxEventsProcessed{0};
@@ -304,15 +382,23 @@ void ObservabilityManager::exportMetrics(const std::shared_ptr<SystemCounters> &
     static std::atomic<uint64_t> lastPlaylistStatusRequests{0};
     static std::atomic<uint64_t> lastRestRequestsProcessed{0};
     static std::atomic<uint64_t> lastRtpEventsProcessed{0};
+    static std::atomic<uint64_t> lastRtpEncodeUnderruns{0};
     static std::atomic<uint64_t> lastRtpSendFailures{0};
     static std::atomic<uint64_t> lastRtpSendFailuresSuppressed{0};
     static std::atomic<uint64_t> lastRtpSendRecoveries{0};
     static std::atomic<uint64_t> lastRtpCircuitBreakerTrips{0};
+    static std::atomic<uint64_t> lastRtpSendSyscalls{0};
+    static std::atomic<uint64_t> lastRtpMixerUnderruns{0};
+    static std::atomic<uint64_t> lastRtpPacketsSuppressed{0};
     static std::atomic<uint64_t> lastRtpAudioLoadsAccepted{0};
     static std::atomic<uint64_t> lastRtpAudioLoadsCompleted{0};
     static std::atomic<uint64_t> lastRtpAudioLoadsRejected{0};
     static std::atomic<uint64_t> lastRtpAudioLoadsCancelled{0};
     static std::atomic<uint64_t> lastRtpAudioLoadsFailed{0};
+    static std::atomic<uint64_t> lastAudioPrewarmScans{0};
+    static std::atomic<uint64_t> lastAudioPrewarmChecked{0};
+    static std::atomic<uint64_t> lastAudioPrewarmEncoded{0};
+    static std::atomic<uint64_t> lastAudioPrewarmFailed{0};
     static std::atomic<uint64_t> lastLocalAudioPlaybacksAccepted{0};
     static std::atomic<uint64_t> lastLocalAudioPlaybacksCompleted{0};
     static std::atomic<uint64_t> lastLocalAudioPlaybacksReplaced{0};
@@ -326,6 +412,9 @@ void ObservabilityManager::exportMetrics(const std::shared_ptr<SystemCounters> &
     static std::atomic<uint64_t> lastWebsocketMessagesSent{0};
     static std::atomic<uint64_t> lastWebsocketPingsSent{0};
     static std::atomic<uint64_t> lastWebsocketPongsReceived{0};
+    static std::atomic<uint64_t> lastWebsocketMessagesCoalesced{0};
+    static std::atomic<uint64_t> lastWebsocketMessagesDropped{0};
+    static std::atomic<uint64_t> lastWebsocketSlowClientHangups{0};
 
     // Calculate deltas and send them
     uint64_t currentTotalFrames = metrics->getTotalFrames();
@@ -333,6 +422,12 @@ void ObservabilityManager::exportMetrics(const std::shared_ptr<SystemCounters> &
     if (deltaTotalFrames > 0)
         totalFramesCounter_->Add(deltaTotalFrames);
 
+    uint64_t currentEventLoopBlockedFrames = metrics->getEventLoopBlockedFrames();
+    uint64_t deltaEventLoopBlockedFrames =
+        currentEventLoopBlockedFrames - lastEventLoopBlockedFrames.exchange(currentEventLoopBlockedFrames);
+    if (deltaEventLoopBlockedFrames > 0)
+        eventLoopBlockedFramesCounter_->Add(deltaEventLoopBlockedFrames);
+
     uint64_t currentEventsProcessed = metrics->getEventsProcessed();
     uint64_t deltaEventsProcessed = currentEventsProcessed - lastEventsProcessed.exchange(currentEventsProcessed);
     if (deltaEventsProcessed > 0)
@@ -393,6 +488,12 @@ void ObservabilityManager::exportMetrics(const std::shared_ptr<SystemCounters> &
     if (deltaRtpEventsProcessed > 0)
         rtpEventsProcessedCounter_->Add(deltaRtpEventsProcessed);
 
+    uint64_t currentRtpEncodeUnderruns = metrics->getRtpEncodeUnderruns();
+    uint64_t deltaRtpEncodeUnderruns =
+        currentRtpEncodeUnderruns - lastRtpEncodeUnderruns.exchange(currentRtpEncodeUnderruns);
+    if (deltaRtpEncodeUnderruns > 0)
+        rtpEncodeUnderrunsCounter_->Add(deltaRtpEncodeUnderruns);
+
     uint64_t currentRtpSendFailures = metrics->getRtpSendFailures();
     uint64_t deltaRtpSendFailures = currentRtpSendFailures - lastRtpSendFailures.exchange(currentRtpSendFailures);
     if (deltaRtpSendFailures > 0)
@@ -416,6 +517,23 @@ void ObservabilityManager::exportMetrics(const std::shared_ptr<SystemCounters> &
     if (deltaRtpCircuitBreakerTrips > 0)
         rtpCircuitBreakerTripsCounter_->Add(deltaRtpCircuitBreakerTrips);
 
+    uint64_t currentRtpSendSyscalls = metrics->getRtpSendSyscalls();
+    uint64_t deltaRtpSendSyscalls = currentRtpSendSyscalls - lastRtpSendSyscalls.exchange(currentRtpSendSyscalls);
+    if (deltaRtpSendSyscalls > 0)
+        rtpSendSyscallsCounter_->Add(deltaRtpSendSyscalls);
+
+    uint64_t currentRtpMixerUnderruns = metrics->getRtpMixerUnderruns();
+    uint64_t deltaRtpMixerUnderruns =
+        currentRtpMixerUnderruns - lastRtpMixerUnderruns.exchange(currentRtpMixerUnderruns);
+    if (deltaRtpMixerUnderruns > 0)
+        rtpMixerUnderrunsCounter_->Add(deltaRtpMixerUnderruns);
+
+    uint64_t currentRtpPacketsSuppressed = metrics->getRtpPacketsSuppressed();
+    uint64_t deltaRtpPacketsSuppressed =
+        currentRtpPacketsSuppressed - lastRtpPacketsSuppressed.exchange(currentRtpPacketsSuppressed);
+    if (deltaRtpPacketsSuppressed > 0)
+        rtpPacketsSuppressedCounter_->Add(deltaRtpPacketsSuppressed);
+
     // Gauges record the absolute reading every cycle — no delta tracking, and no
     // skip-if-unchanged, so a steady value keeps reporting instead of going stale.
     rtpAudioLoadersActiveGauge_->Record(static_cast<double>(metrics->getRtpAudioLoadersActive()));
@@ -451,6 +569,32 @@ void ObservabilityManager::exportMetrics(const std::shared_ptr<SystemCounters> &
     if (deltaRtpAudioLoadsFailed > 0)
         rtpAudioLoadsFailedCounter_->Add(deltaRtpAudioLoadsFailed);
 
+    audioPrewarmPendingGauge_->Record(static_cast<double>(metrics->getAudioPrewarmPending()));
+
+    uint64_t currentAudioPrewarmScans = metrics->getAudioPrewarmScans();
+    uint64_t deltaAudioPrewarmScans =
+        currentAudioPrewarmScans - lastAudioPrewarmScans.exchange(currentAudioPrewarmScans);
+    if (deltaAudioPrewarmScans > 0)
+        audioPrewarmScansCounter_->Add(deltaAudioPrewarmScans);
+
+    uint64_t currentAudioPrewarmChecked = metrics->getAudioPrewarmChecked();
+    uint64_t deltaAudioPrewarmChecked =
+        currentAudioPrewarmChecked - lastAudioPrewarmChecked.exchange(currentAudioPrewarmChecked);
+    if (deltaAudioPrewarmChecked > 0)
+        audioPrewarmCheckedCounter_->Add(deltaAudioPrewarmChecked);
+
+    uint64_t currentAudioPrewarmEncoded = metrics->getAudioPrewarmEncoded();
+    uint64_t deltaAudioPrewarmEncoded =
+        currentAudioPrewarmEncoded - lastAudioPrewarmEncoded.exchange(currentAudioPrewarmEncoded);
+    if (deltaAudioPrewarmEncoded > 0)
+        audioPrewarmEncodedCounter_->Add(deltaAudioPrewarmEncoded);
+
+    uint64_t currentAudioPrewarmFailed = metrics->getAudioPrewarmFailed();
+    uint64_t deltaAudioPrewarmFailed =
+        currentAudioPrewarmFailed - lastAudioPrewarmFailed.exchange(currentAudioPrewarmFailed);
+    if (deltaAudioPrewarmFailed > 0)
+        audioPrewarmFailedCounter_->Add(deltaAudioPrewarmFailed);
+
     localAudioPlaybacksActiveGauge_->Record(static_cast<double>(metrics->getLocalAudioPlaybacksActive()));
     localAudioPlaybacksQueuedGauge_->Record(static_cast<double>(metrics->getLocalAudioPlaybacksQueued()));
 
@@ -537,9 +681,98 @@ void ObservabilityManager::exportMetrics(const std::shared_ptr<SystemCounters> &
     if (deltaWebsocketPongsReceived > 0)
         websocketPongsReceivedCounter_->Add(deltaWebsocketPongsReceived);
 
+    uint64_t currentWebsocketMessagesCoalesced = metrics->getWebsocketMessagesCoalesced();
+    uint64_t deltaWebsocketMessagesCoalesced =
+        currentWebsocketMessagesCoalesced - lastWebsocketMessagesCoalesced.exchange(currentWebsocketMessagesCoalesced);
+    if (deltaWebsocketMessagesCoalesced > 0)
+        websocketMessagesCoalescedCounter_->Add(deltaWebsocketMessagesCoalesced);
+
+    uint64_t currentWebsocketMessagesDropped = metrics->getWebsocketMessagesDropped();
+    uint64_t deltaWebsocketMessagesDropped =
+        currentWebsocketMessagesDropped - lastWebsocketMessagesDropped.exchange(currentWebsocketMessagesDropped);
+    if (deltaWebsocketMessagesDropped > 0)
+        websocketMessagesDroppedCounter_->Add(deltaWebsocketMessagesDropped);
+
+    uint64_t currentWebsocketSlowClientHangups = metrics->getWebsocketSlowClientHangups();
+    uint64_t deltaWebsocketSlowClientHangups =
+        currentWebsocketSlowClientHangups - lastWebsocketSlowClientHangups.exchange(currentWebsocketSlowClientHangups);
+    if (deltaWebsocketSlowClientHangups > 0)
+        websocketSlowClientHangupsCounter_->Add(deltaWebsocketSlowClientHangups);
+
+    exportLatencyHistograms(*metrics);
+
     debug("Metrics exported to OTel");
 }
 
+void ObservabilityManager::exportLatencyHistograms(SystemCounters &metrics) {
+    if (!eventLoopLatencyGauge_ || !eventLoopEventsPerTickGauge_ || !rtpFrameSetSendLatencyGauge_ ||
+        !rtpPacketJitterGauge_ || !rtpPacingLatenessGauge_ || !websocketSerializationGauge_ ||
+        !streamFrameLatencyGauge_) {
+        return;
+    }
+
+    // The histograms count from startup; report the interval since the last export so a bad
+    // minute doesn't disappear into hours of good ones
+    static std::unordered_map<std::string, LatencyHistogram::Snapshot> lastSnapshots;
+
+    constexpr std::array<std::pair<const char *, double>, 4> quantiles{
+        {{"p50", 50.0}, {"p99", 99.0}, {"p999", 99.9}, {"max", 100.0}}};
+
+    const auto exportOne = [&](const std::string &name, const LatencyHistogram &histogram, bool nanoseconds,
+                               metrics_api::Gauge<double> &latencyGauge, const std::string &channel = {},
+                               const char *channelAttribute = "channel") {
+        auto snapshot = histogram.snapshot();
+        auto &last = lastSnapshots[channel.empty() ? name : name + "/" + channel];
+        const auto interval = snapshot.since(last);
+        last = std::move(snapshot);
+        if (interval.count == 0) {
+            return;
+        }
+
+        std::unordered_map<std::string, std::string> attributes;
+        if (nanoseconds) {
+            attributes["histogram"] = name;
+        }
+        if (!channel.empty()) {
+            attributes[channelAttribute] = channel;
+        }
+        for (const auto &[quantile, percentile] : quantiles) {
+            attributes["quantile"] = quantile;
+            const auto value = static_cast<double>(interval.valueAtPercentile(percentile));
+            if (nanoseconds) {
+                latencyGauge.Record(value / 1000.0, attributes);
+            } else {
+                eventLoopEventsPerTickGauge_->Record(value, attributes);
+            }
+        }
+    };
+
+    const auto &timings = metrics.getEventLoopTimings();
+    auto &eventLoopLatency = *eventLoopLatencyGauge_;
+    exportOne("tickWork", timings.tickWorkNs, true, eventLoopLatency);
+    exportOne("tickOverrun", timings.tickOverrunNs, true, eventLoopLatency);
+    exportOne("oversleep", timings.oversleepNs, true, eventLoopLatency);
+    exportOne("eventsPerTick", timings.eventsPerTick, false, eventLoopLatency);
+    for (std::size_t slot = 0; slot < EventTypes::count(); ++slot) {
+        exportOne(EventTypes::name(slot), timings.eventExecutionNs[slot], true, eventLoopLatency);
+    }
+    exportOne("rtpFrameSetSend", metrics.getRtpFrameSetSendTimes(), true, *rtpFrameSetSendLatencyGauge_);
+    exportOne("rtpPacingLateness", metrics.getRtpPacingLateness(), true, *rtpPacingLatenessGauge_);
+    const auto &jitter = metrics.getRtpPacketJitter();
+    for (std::size_t channel = 0; channel < jitter.size(); ++channel) {
+        exportOne("rtpPacketJitter", jitter[channel], true, *rtpPacketJitterGauge_, std::to_string(channel));
+    }
+    const auto &serialization = metrics.getWebsocketSerializationTimes();
+    for (const auto type : ws::allMessageTypes) {
+        exportOne("websocketSerialization", serialization[static_cast<std::size_t>(type)], true,
+                  *websocketSerializationGauge_, ws::toString(type), "message_type");
+    }
+    exportOne("streamFrame", metrics.getStreamFrameFastLaneLatency(), true, *streamFrameLatencyGauge_, "fastLane",
+              "path");
+    exportOne("streamFrame", metrics.getStreamFrameFullPathLatency(), true, *streamFrameLatencyGauge_, "fullPath",
+              "path");
+}
+
 void ObservabilityManager::exportSensorMetrics(const std::shared_ptr<SensorDataCache> &sensorDataCache) {
     if (!initialized_ || !sensorDataCache) {
         return;
@@ -31,6 +31,7 @@ namespace creatures {
 class RequestSpan;
 class OperationSpan;
 class SamplingSpan;
+class SystemCounters;
 
 /**
  * A wrapper around OpenTelemetry for the Creature Server
@@ -153,6 +154,7 @@ class ObservabilityManager {
     // Individual counter instruments - we'll create these once and reuse them
     // This avoids the overhead of looking them up every time we export
     opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Counter<uint64_t>> totalFramesCounter_;
+    opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Counter<uint64_t>> eventLoopBlockedFramesCounter_;
     opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Counter<uint64_t>> eventsProcessedCounter_;
     opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Counter<uint64_t>> framesStreamedCounter_;
     opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Counter<uint64_t>> dmxEventsProcessedCounter_;
@@ -164,10 +166,14 @@ class ObservabilityManager {
     opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Counter<uint64_t>> playlistStatusRequestsCounter_;
     opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Counter<uint64_t>> restRequestsProcessedCounter_;
     opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Counter<uint64_t>> rtpEventsProcessedCounter_;
+    opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Counter<uint64_t>> rtpEncodeUnderrunsCounter_;
     opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Counter<uint64_t>> rtpSendFailuresCounter_;
     opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Counter<uint64_t>> rtpSendFailuresSuppressedCounter_;
     opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Counter<uint64_t>> rtpSendRecoveriesCounter_;
     opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Counter<uint64_t>> rtpCircuitBreakerTripsCounter_;
+    opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Counter<uint64_t>> rtpSendSyscallsCounter_;
+    opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Counter<uint64_t>> rtpMixerUnderrunsCounter_;
+    opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Counter<uint64_t>> rtpPacketsSuppressedCounter_;
     opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Gauge<double>> rtpAudioLoadersActiveGauge_;
     opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Gauge<double>> rtpAudioLoadsQueuedGauge_;
     opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Counter<uint64_t>> rtpAudioLoadsAcceptedCounter_;
@@ -175,6 +181,11 @@ class ObservabilityManager {
     opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Counter<uint64_t>> rtpAudioLoadsRejectedCounter_;
     opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Counter<uint64_t>> rtpAudioLoadsCancelledCounter_;
     opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Counter<uint64_t>> rtpAudioLoadsFailedCounter_;
+    opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Gauge<double>> audioPrewarmPendingGauge_;
+    opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Counter<uint64_t>> audioPrewarmScansCounter_;
+    opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Counter<uint64_t>> audioPrewarmCheckedCounter_;
+    opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Counter<uint64_t>> audioPrewarmEncodedCounter_;
+    opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Counter<uint64_t>> audioPrewarmFailedCounter_;
     opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Gauge<double>> localAudioPlaybacksActiveGauge_;
     opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Gauge<double>> localAudioPlaybacksQueuedGauge_;
     opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Counter<uint64_t>> localAudioPlaybacksAcceptedCounter_;
@@ -190,6 +201,9 @@ class ObservabilityManager {
     opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Counter<uint64_t>> websocketMessagesSentCounter_;
     opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Counter<uint64_t>> websocketPingsSentCounter_;
     opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Counter<uint64_t>> websocketPongsReceivedCounter_;
+    opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Counter<uint64_t>> websocketMessagesCoalescedCounter_;
+    opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Counter<uint64_t>> websocketMessagesDroppedCounter_;
+    opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Counter<uint64_t>> websocketSlowClientHangupsCounter_;
 
     // Sensor metric instruments - gauges for current readings
     opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Gauge<double>> boardTemperatureGauge_;
@@ -203,8 +217,20 @@ class ObservabilityManager {
     opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Gauge<double>> dynamixelVoltageGauge_;
     opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Gauge<double>> dynamixelPositionGauge_;
 
+    // Event loop histograms, summarized per export interval - keyed by histogram and quantile
+    opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Gauge<double>> eventLoopLatencyGauge_;
+    opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Gauge<double>> eventLoopEventsPerTickGauge_;
+    opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Gauge<double>> rtpFrameSetSendLatencyGauge_;
+    opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Gauge<double>> rtpPacketJitterGauge_;
+    opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Gauge<double>> rtpPacingLatenessGauge_;
+    opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Gauge<double>> websocketSerializationGauge_;
+    opentelemetry::nostd::unique_ptr<opentelemetry::metrics::Gauge<double>> streamFrameLatencyGauge_;
+
     bool initialized_;
 
+    /** Record the quantiles of what each event loop (and RTP output) histogram saw since the last export */
+    void exportLatencyHistograms(SystemCounters &metrics);
+
     /**
      * Parse a W3C traceparent header into a SpanContext for remote parent propagation.
      *
@@ -0,0 +1,189 @@
+
+#include "OpusCacheFile.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fmt/format.h>
+
+#include "server/config.h"
+
+namespace creatures::util {
+
+namespace {
+
+constexpr std::array<char, 8> FILE_MAGIC = {'C', 'R', 'O', 'P', 'U', 'S', '\0', '\0'};
+constexpr uint32_t FILE_VERSION = 2; // 2: index entries flag silent frames
+
+struct FileHeader {
+    std::array<char, 8> magic;
+    uint32_t version;
+    uint32_t channels;
+    uint64_t encoderFingerprint;
+    uint64_t sourceSize;
+    int64_t sourceModTime;
+    uint64_t framesPerChannel;
+    uint64_t indexOffset;
+    uint64_t dataOffset;
+    uint64_t dataSize;
+    std::array<char, 64> sourceSha256;
+};
+static_assert(std::is_trivially_copyable_v<FileHeader>);
+static_assert(sizeof(FileHeader) % alignof(OpusFrameArena::PackedEntry) == 0);
+
+// Unmaps the file once the last view of it is gone
+class Mapping {
+  public:
+    Mapping(void *_address, std::size_t _length) : address(_address), length(_length) {}
+    ~Mapping() { munmap(address, length); }
+
+    Mapping(const Mapping &) = delete;
+    Mapping &operator=(const Mapping &) = delete;
+
+  private:
+    void *address;
+    std::size_t length;
+};
+
+} // namespace
+
+Result<void> writeOpusCacheFile(const std::string &path, const OpusFrameArena &frames, const OpusCacheStamp &stamp,
+                                const std::string &sourceSha256) {
+    try {
+        const auto framesPerChannel = frames.framesPerChannel();
+
+        // Packets go frame by frame, but the index is channel by channel like the arena's
+        std::vector<OpusFrameArena::PackedEntry> index(framesPerChannel * RTP_STREAMING_CHANNELS);
+        uint64_t dataSize = 0;
+        for (std::size_t frameIndex = 0; frameIndex < framesPerChannel; ++frameIndex) {
+            for (uint8_t channel = 0; channel < RTP_STREAMING_CHANNELS; ++channel) {
+                const auto length = static_cast<uint32_t>(frames.frame(channel, frameIndex).size());
+                const uint32_t flags = frames.isSilent(channel, frameIndex) ? OpusFrameArena::SILENT_FRAME : 0U;
+                index[channel * framesPerChannel + frameIndex] = {dataSize, length, flags};
+                dataSize += length;
+            }
+        }
+
+        FileHeader header{};
+        header.magic = FILE_MAGIC;
+        header.version = FILE_VERSION;
+        header.channels = RTP_STREAMING_CHANNELS;
+        header.encoderFingerprint = stamp.encoderFingerprint;
+        header.sourceSize = stamp.sourceSize;
+        header.sourceModTime = stamp.sourceModTime;
+        header.framesPerChannel = framesPerChannel;
+        header.indexOffset = sizeof(FileHeader);
+        header.dataOffset = header.indexOffset + index.size() * sizeof(OpusFrameArena::PackedEntry);
+        header.dataSize = dataSize;
+        std::copy_n(sourceSha256.begin(), std::min(sourceSha256.size(), header.sourceSha256.size()),
+                    header.sourceSha256.begin());
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return Result<void>(ServerError(ServerError::Forbidden, fmt::format("Cannot create cache file: {}", path)));
+        }
+
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(index.data()),
+                   static_cast<std::streamsize>(index.size() * sizeof(OpusFrameArena::PackedEntry)));
+        for (std::size_t frameIndex = 0; frameIndex < framesPerChannel; ++frameIndex) {
+            for (uint8_t channel = 0; channel < RTP_STREAMING_CHANNELS; ++channel) {
+                const auto packet = frames.frame(channel, frameIndex);
+                file.write(reinterpret_cast<const char *>(packet.data()), static_cast<std::streamsize>(packet.size()));
+            }
+        }
+        file.flush();
+
+        if (!file.good()) {
+            return Result<void>(ServerError(ServerError::InternalError, "Failed to write cache file data"));
+        }
+        return Result<void>();
+
+    } catch (const std::exception &e) {
+        return Result<void>(
+            ServerError(ServerError::InternalError, fmt::format("Exception saving cache file: {}", e.what())));
+    }
+}
+
+Result<std::shared_ptr<const OpusFrameArena>> mapOpusCacheFile(const std::string &path,
+                                                               const OpusCacheStamp &expected) {
+    using MapResult = Result<std::shared_ptr<const OpusFrameArena>>;
+
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        if (errno == ENOENT) {
+            return MapResult{ServerError(ServerError::NotFound, fmt::format("Cache file not found: {}", path))};
+        }
+        return MapResult{ServerError(ServerError::InternalError,
+                                     fmt::format("Cannot open cache file {}: {}", path, std::strerror(errno)))};
+    }
+
+    struct stat fileStatus {};
+    if (fstat(fd, &fileStatus) != 0) {
+        const auto errorMsg = fmt::format("Cannot stat cache file {}: {}", path, std::strerror(errno));
+        close(fd);
+        return MapResult{ServerError(ServerError::InternalError, errorMsg)};
+    }
+    const auto fileSize = static_cast<uint64_t>(fileStatus.st_size);
+    if (fileSize < sizeof(FileHeader)) {
+        close(fd);
+        return MapResult{
+            ServerError(ServerError::InvalidData, fmt::format("Cache file is too short to have a header: {}", path))};
+    }
+
+    void *address = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // The mapping keeps the file open
+    if (address == MAP_FAILED) {
+        return MapResult{ServerError(ServerError::InternalError,
+                                     fmt::format("Cannot map cache file {}: {}", path, std::strerror(errno)))};
+    }
+    auto mapping = std::make_shared<const Mapping>(address, fileSize);
+    const auto *bytes = static_cast<const uint8_t *>(address);
+
+    FileHeader header{};
+    std::memcpy(&header, bytes, sizeof(header));
+
+    if (header.magic != FILE_MAGIC) {
+        return MapResult{ServerError(ServerError::InvalidData, fmt::format("Not an Opus cache file: {}", path))};
+    }
+    if (header.version != FILE_VERSION || header.channels != RTP_STREAMING_CHANNELS) {
+        return MapResult{ServerError(ServerError::Conflict,
+                                     fmt::format("Cache file {} is version {} with {} channels", path, header.version,
+                                                 header.channels))};
+    }
+
+    const OpusCacheStamp stamp{header.encoderFingerprint, header.sourceSize, header.sourceModTime};
+    if (stamp != expected) {
+        return MapResult{ServerError(ServerError::Conflict,
+                                     fmt::format("Cache file {} was written for a different source or encoder", path))};
+    }
+
+    // Everything has to fit exactly, so none of the index or data can be past the end of the mapping
+    const auto entries = header.framesPerChannel * RTP_STREAMING_CHANNELS;
+    if (header.framesPerChannel == 0 || header.framesPerChannel > RTP_MAX_FRAMES_PER_CHANNEL ||
+        header.indexOffset != sizeof(FileHeader) ||
+        header.dataOffset != header.indexOffset + entries * sizeof(OpusFrameArena::PackedEntry) ||
+        header.dataOffset > fileSize || header.dataSize != fileSize - header.dataOffset) {
+        return MapResult{ServerError(ServerError::InvalidData,
+                                     fmt::format("Cache file {} doesn't match its header ({} bytes)", path, fileSize))};
+    }
+
+    // Playback walks through the file in order; get the kernel reading it now
+    static_cast<void>(posix_madvise(address, fileSize, POSIX_MADV_WILLNEED));
+
+    const auto *index = reinterpret_cast<const OpusFrameArena::PackedEntry *>(bytes + header.indexOffset);
+    return MapResult{OpusFrameArena::view(header.framesPerChannel, {index, entries},
+                                          {bytes + header.dataOffset, header.dataSize}, std::move(mapping))};
+}
+
+} // namespace creatures::util
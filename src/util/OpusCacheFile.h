@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "util/OpusFrameArena.h"
+#include "util/Result.h"
+
+namespace creatures::util {
+
+/**
+ * What a cache file has to match to be used: the encoder settings it was
+ * written with, and the size and modification time of the WAV it came from
+ */
+struct OpusCacheStamp {
+    uint64_t encoderFingerprint = 0;
+    uint64_t sourceSize = 0;
+    int64_t sourceModTime = 0; // std::filesystem::file_time_type ticks
+
+    bool operator==(const OpusCacheStamp &other) const = default;
+};
+
+/**
+ * Write every channel's packets to one cache file
+ *
+ * The file is a fixed header, an index with an (offset, length, flags) entry
+ * per packet (channel by channel, like OpusFrameArena's), and then the packets
+ * themselves, frame by frame so the 17 packets played together are next to
+ * each other. Everything is in native byte order; cache directories are
+ * per host.
+ *
+ * This writes in place; write to a temporary name and rename it.
+ *
+ * @param sourceSha256 hex checksum of the source, kept for reference (loading never needs it)
+ */
+Result<void> writeOpusCacheFile(const std::string &path, const OpusFrameArena &frames, const OpusCacheStamp &stamp,
+                                const std::string &sourceSha256);
+
+/**
+ * Map a cache file into memory and hand back a view of its packets
+ *
+ * Only the header is checked, so this takes the same time however long the
+ * sound is, and nothing is copied. The pages are read in as they're played
+ * (with a hint to the kernel to start reading ahead now).
+ *
+ * @return NotFound if there's no file, Conflict if it was written for a
+ *         different stamp, InvalidData if it's damaged
+ */
+Result<std::shared_ptr<const OpusFrameArena>> mapOpusCacheFile(const std::string &path,
+                                                               const OpusCacheStamp &expected);
+
+} // namespace creatures::util
@@ -0,0 +1,110 @@
+
+#include "OpusFrameArena.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+#include <fmt/format.h>
+
+namespace creatures::util {
+
+namespace {
+
+// Blocks after the first grow from here (doubling each time) when the size hint comes up short
+constexpr std::size_t MIN_BLOCK_BYTES = 64 * 1024;
+constexpr std::size_t MAX_BLOCK_BYTES = 16 * 1024 * 1024;
+
+} // namespace
+
+OpusFrameArena::OpusFrameArena(std::size_t framesPerChannel, std::size_t expectedBytes)
+    : framesPerChannel_(framesPerChannel), index_(framesPerChannel * RTP_STREAMING_CHANNELS) {
+    if (expectedBytes > 0) {
+        blocks_.push_back(Block{std::make_unique_for_overwrite<uint8_t[]>(expectedBytes), expectedBytes, 0});
+    }
+}
+
+OpusFrameArena::OpusFrameArena(std::size_t framesPerChannel, std::span<const PackedEntry> index,
+                               std::span<const uint8_t> data, std::shared_ptr<const void> owner)
+    : framesPerChannel_(framesPerChannel), viewIndex_(index), viewData_(data), viewOwner_(std::move(owner)) {}
+
+std::shared_ptr<const OpusFrameArena> OpusFrameArena::view(std::size_t framesPerChannel,
+                                                           std::span<const PackedEntry> index,
+                                                           std::span<const uint8_t> data,
+                                                           std::shared_ptr<const void> owner) {
+    if (framesPerChannel == 0 || index.size() != framesPerChannel * RTP_STREAMING_CHANNELS) {
+        throw std::invalid_argument(
+            fmt::format("An Opus frame view of {} frames per channel needs {} index entries; got {}", framesPerChannel,
+                        framesPerChannel * RTP_STREAMING_CHANNELS, index.size()));
+    }
+    // The constructor is private, so no make_shared
+    return std::shared_ptr<const OpusFrameArena>(new OpusFrameArena(framesPerChannel, index, data, std::move(owner)));
+}
+
+void OpusFrameArena::set(uint8_t channel, std::size_t frameIndex, std::span<const uint8_t> packet, bool silent) {
+    if (channel >= RTP_STREAMING_CHANNELS || frameIndex >= framesPerChannel_) {
+        throw std::out_of_range(
+            fmt::format("Opus frame {} on channel {} is outside the arena ({} frames per channel)", frameIndex,
+                        channel, framesPerChannel_));
+    }
+
+    auto *destination = allocate(packet.size());
+    if (!packet.empty()) {
+        std::memcpy(destination, packet.data(), packet.size());
+    }
+    index_[channel * framesPerChannel_ + frameIndex] =
+        Entry{destination, static_cast<uint32_t>(packet.size()), silent ? SILENT_FRAME : 0U};
+}
+
+std::span<uint8_t> OpusFrameArena::allocateChannel(uint8_t channel, std::span<const uint32_t> lengths) {
+    if (channel >= RTP_STREAMING_CHANNELS) {
+        throw std::out_of_range(fmt::format("Opus channel {} is outside the arena", channel));
+    }
+    if (lengths.size() != framesPerChannel_) {
+        throw std::invalid_argument(fmt::format("Got {} Opus frame lengths for channel {}; expected {}",
+                                                lengths.size(), channel, framesPerChannel_));
+    }
+
+    const auto channelBytes = std::accumulate(lengths.begin(), lengths.end(), std::size_t{0});
+    auto *destination = allocate(channelBytes);
+
+    auto *next = destination;
+    for (std::size_t frame = 0; frame < lengths.size(); ++frame) {
+        index_[channel * framesPerChannel_ + frame] = Entry{next, lengths[frame]};
+        next += lengths[frame];
+    }
+    return {destination, channelBytes};
+}
+
+bool OpusFrameArena::operator==(const OpusFrameArena &other) const {
+    if (framesPerChannel_ != other.framesPerChannel_) {
+        return false;
+    }
+    for (uint8_t channel = 0; channel < RTP_STREAMING_CHANNELS; ++channel) {
+        for (std::size_t frameIndex = 0; frameIndex < framesPerChannel_; ++frameIndex) {
+            if (!std::ranges::equal(frame(channel, frameIndex), other.frame(channel, frameIndex)) ||
+                isSilent(channel, frameIndex) != other.isSilent(channel, frameIndex)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+uint8_t *OpusFrameArena::allocate(std::size_t bytes) {
+    if (blocks_.empty() || blocks_.back().capacity - blocks_.back().used < bytes) {
+        const auto grown = blocks_.empty() ? MIN_BLOCK_BYTES : std::min(blocks_.back().capacity * 2, MAX_BLOCK_BYTES);
+        const auto capacity = std::max({bytes, MIN_BLOCK_BYTES, grown});
+        blocks_.push_back(Block{std::make_unique_for_overwrite<uint8_t[]>(capacity), capacity, 0});
+    }
+
+    auto &block = blocks_.back();
+    auto *destination = block.bytes.get() + block.used;
+    block.used += bytes;
+    bytesUsed_ += bytes;
+    return destination;
+}
+
+} // namespace creatures::util
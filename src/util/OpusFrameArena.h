@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "server/config.h"
+
+namespace creatures::util {
+
+/**
+ * Every encoded Opus packet for one 17-channel sound, packed back to back
+ *
+ * Packets live in a handful of big byte blocks instead of a vector each, and
+ * an index of (pointer, length) pairs points into them, channel by channel.
+ * When the caller knows roughly how many bytes are coming (the encoder runs
+ * in CBR mode, so it usually does) that's a single allocation.
+ *
+ * There's one writer. Blocks never move once they're allocated, so frames the
+ * writer has already filled in stay put while it keeps appending. Readers must
+ * only look at frames somebody has published to them (AudioStreamBuffer's
+ * ready watermark does that), and once the arena is complete it's meant to be
+ * shared read-only, through a shared_ptr<const OpusFrameArena>.
+ *
+ * An arena can also be a view of packets that live somewhere else, like a
+ * memory-mapped cache file (see view()). Views are read-only.
+ */
+class OpusFrameArena {
+  public:
+    /** PackedEntry::flags: the packet's audio was silent (see RTP_SILENCE_PEAK) */
+    static constexpr uint32_t SILENT_FRAME = 1U << 0U;
+
+    /** Where a packet is in a view's data, as stored in a cache file */
+    struct PackedEntry {
+        uint64_t offset = 0;
+        uint32_t length = 0;
+        uint32_t flags = 0;
+    };
+    static_assert(sizeof(PackedEntry) == 16);
+
+    /**
+     * @param framesPerChannel how many packets each channel holds
+     * @param expectedBytes how many packet bytes to allocate up front (more blocks are added if it's not enough)
+     */
+    explicit OpusFrameArena(std::size_t framesPerChannel, std::size_t expectedBytes = 0);
+
+    /**
+     * Read packets in place instead of copying them in
+     *
+     * @param index one entry per frame, channel by channel, like the arena's own index
+     * @param data the bytes the index's offsets are relative to
+     * @param owner keeps index and data alive for as long as the view is around
+     * @throws std::invalid_argument if the index isn't framesPerChannel * RTP_STREAMING_CHANNELS long
+     */
+    static std::shared_ptr<const OpusFrameArena> view(std::size_t framesPerChannel,
+                                                      std::span<const PackedEntry> index,
+                                                      std::span<const uint8_t> data,
+                                                      std::shared_ptr<const void> owner);
+
+    OpusFrameArena(const OpusFrameArena &) = delete;
+    OpusFrameArena &operator=(const OpusFrameArena &) = delete;
+
+    [[nodiscard]] std::size_t framesPerChannel() const { return framesPerChannel_; }
+
+    /** @return one packet; empty if it was never set */
+    [[nodiscard]] std::span<const uint8_t> frame(uint8_t channel, std::size_t frameIndex) const {
+        const auto slot = channel * framesPerChannel_ + frameIndex;
+        if (!viewIndex_.empty()) {
+            const auto &entry = viewIndex_[slot];
+            // A damaged file gets an empty packet, not a read past the end of the data
+            if (entry.offset > viewData_.size() || entry.length > viewData_.size() - entry.offset) {
+                return {};
+            }
+            return viewData_.subspan(entry.offset, entry.length);
+        }
+        const auto &entry = index_[slot];
+        return {entry.data, entry.length};
+    }
+
+    /** @return true if the frame's audio was silent, so the packet needn't be sent */
+    [[nodiscard]] bool isSilent(uint8_t channel, std::size_t frameIndex) const {
+        const auto slot = channel * framesPerChannel_ + frameIndex;
+        const uint32_t flags = viewIndex_.empty() ? index_[slot].flags : viewIndex_[slot].flags;
+        return (flags & SILENT_FRAME) != 0;
+    }
+
+    /**
+     * Copy a packet in. Each frame should only be set once.
+     *
+     * @param silent the frame's audio was silent
+     * @throws std::out_of_range if the channel or frame doesn't exist
+     */
+    void set(uint8_t channel, std::size_t frameIndex, std::span<const uint8_t> packet, bool silent = false);
+
+    /**
+     * Make room for a whole channel at once, back to back, and point its index at it
+     *
+     * Used by the cache to read a channel's packet data straight off disk into place.
+     *
+     * @param lengths the length of every packet in the channel, in order
+     * @return where to write the packets
+     * @throws std::out_of_range if the channel doesn't exist
+     * @throws std::invalid_argument if lengths isn't framesPerChannel() long
+     */
+    std::span<uint8_t> allocateChannel(uint8_t channel, std::span<const uint32_t> lengths);
+
+    /** @return how many packet bytes are stored */
+    [[nodiscard]] std::size_t byteSize() const { return viewIndex_.empty() ? bytesUsed_ : viewData_.size(); }
+
+    /** @return how many blocks the packets are spread across (none for a view) */
+    [[nodiscard]] std::size_t blockCount() const { return blocks_.size(); }
+
+    /** @return true if this is a view of packets stored elsewhere */
+    [[nodiscard]] bool isView() const { return !viewIndex_.empty(); }
+
+    /** Same packets, flagged the same, in the same places (the bytes, not where they're stored) */
+    bool operator==(const OpusFrameArena &other) const;
+
+  private:
+    struct Entry {
+        const uint8_t *data = nullptr;
+        uint32_t length = 0;
+        uint32_t flags = 0; // PackedEntry's
+    };
+
+    struct Block {
+        std::unique_ptr<uint8_t[]> bytes;
+        std::size_t capacity = 0;
+        std::size_t used = 0;
+    };
+
+    OpusFrameArena(std::size_t framesPerChannel, std::span<const PackedEntry> index, std::span<const uint8_t> data,
+                   std::shared_ptr<const void> owner);
+
+    uint8_t *allocate(std::size_t bytes);
+
+    std::size_t framesPerChannel_;
+    std::vector<Entry> index_; // [channel * framesPerChannel_ + frame]
+    std::vector<Block> blocks_;
+    std::size_t bytesUsed_ = 0;
+
+    // Only set for views
+    std::span<const PackedEntry> viewIndex_;
+    std::span<const uint8_t> viewData_;
+    std::shared_ptr<const void> viewOwner_;
+};
+
+} // namespace creatures::util
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <new>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace creatures {
+
+/**
+ * Fixed-capacity, lock-free, single-producer / single-consumer ring.
+ *
+ * Exactly one thread may call tryPush() and exactly one (other) thread may
+ * call tryPop() at a time. Neither side ever blocks or allocates once the ring
+ * is constructed; a full ring simply rejects the push so the caller can pick
+ * its own overflow policy.
+ *
+ * Capacity is rounded up to a power of two so the index math is a mask.
+ *
+ * @tparam T must be default-constructible and move-assignable
+ */
+template <typename T> class SpscRing {
+  public:
+    explicit SpscRing(size_t capacity)
+        : mask_(std::bit_ceil(capacity < 2 ? size_t{2} : capacity) - 1), slots_(mask_ + 1) {}
+
+    SpscRing(const SpscRing &) = delete;
+    SpscRing &operator=(const SpscRing &) = delete;
+
+    /**
+     * Producer side. Only consumes the value on success, so a caller can fall
+     * back to some other path with it when the ring is full.
+     */
+    template <typename U> [[nodiscard]] bool tryPush(U &&value) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cachedHead_ > mask_) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail - cachedHead_ > mask_) {
+                return false;
+            }
+        }
+        slots_[tail & mask_] = std::forward<U>(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    [[nodiscard]] bool tryPop(T &out) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cachedTail_) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head == cachedTail_) {
+                return false;
+            }
+        }
+        out = std::move(slots_[head & mask_]);
+        // Leave a moved-from (empty) value behind so owning types like
+        // shared_ptr drop their reference on the consumer side, not whenever
+        // the producer next laps this slot.
+        slots_[head & mask_] = T{};
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    [[nodiscard]] std::optional<T> tryPop() {
+        T value{};
+        if (!tryPop(value)) {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    /**
+     * Approximate number of queued items. Exact only when called from the
+     * producer or consumer while the other side is idle.
+     */
+    [[nodiscard]] size_t size() const {
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        const size_t head = head_.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    [[nodiscard]] bool empty() const { return size() == 0; }
+
+    [[nodiscard]] size_t capacity() const { return mask_ + 1; }
+
+  private:
+    // Keep the producer and consumer indices on separate cache lines so the
+    // two threads don't false-share on every push/pop.
+    static constexpr size_t kCacheLine = 64;
+
+    const size_t mask_;
+    std::vector<T> slots_;
+
+    alignas(kCacheLine) std::atomic<size_t> head_{0};
+    size_t cachedTail_{0}; // consumer-private
+
+    alignas(kCacheLine) std::atomic<size_t> tail_{0};
+    size_t cachedHead_{0}; // producer-private
+};
+
+} // namespace creatures
@@ -11,7 +11,7 @@
 #include "util/MessageQueue.h"
 
 namespace creatures {
-extern std::shared_ptr<moodycamel::BlockingConcurrentQueue<std::string>>
+extern std::shared_ptr<moodycamel::BlockingConcurrentQueue<ws::OutgoingMessage>>
     websocketOutgoingMessages;
 }
 
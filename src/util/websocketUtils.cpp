@@ -1,8 +1,9 @@
 
+#include <utility>
+
 #include <spdlog/spdlog.h>
 
 #include <oatpp/core/Types.hpp>
-#include <oatpp/parser/json/mapping/ObjectMapper.hpp>
 
 #include "blockingconcurrentqueue.h"
 
@@ -18,6 +19,8 @@
 #include "server/ws/dto/websocket/MessageTypes.h"
 #include "server/ws/dto/websocket/NoticeMessage.h"
 #include "server/ws/dto/websocket/PlaylistStatusMessage.h"
+#include "server/ws/websocket/OutgoingMessage.h"
+#include "server/ws/websocket/TopicSubscriptions.h"
 #include "util/Result.h"
 #include "util/helpers.h"
 #include "util/websocketUtils.h"
@@ -26,7 +29,7 @@
 
 namespace creatures {
 
-extern std::shared_ptr<moodycamel::BlockingConcurrentQueue<std::string>> websocketOutgoingMessages;
+extern std::shared_ptr<moodycamel::BlockingConcurrentQueue<ws::OutgoingMessage>> websocketOutgoingMessages;
 extern std::shared_ptr<EventLoop> eventLoop;
 
 /**
@@ -43,6 +46,11 @@ Result<bool> broadcastNoticeToAllClients(const std::string &message) {
         return Result<bool>{ServerError(ServerError::InternalError, "Websocket queue unavailable")};
     }
 
+    // No sense building a message that no client is subscribed to
+    if (!ws::anyoneSubscribedTo(ws::MessageType::Notice)) {
+        return Result<bool>{true};
+    }
+
     try {
         // Create the actual Notice object
         Notice notice;
@@ -54,13 +62,11 @@ Result<bool> broadcastNoticeToAllClients(const std::string &message) {
         noticeMessage->command = toString(ws::MessageType::Notice);
         noticeMessage->payload = creatures::convertToDto(notice);
 
-        // Make a JSON mapper
-        auto jsonMapper = oatpp::parser::json::mapping::ObjectMapper::createShared();
+        // Serialize it once; every client shares the result
+        auto outgoingMessage = ws::serializeForClients(ws::MessageType::Notice, noticeMessage);
+        debug("Outgoing notice to clients: {}", *outgoingMessage.json);
 
-        std::string outgoingMessage = jsonMapper->writeToString(noticeMessage);
-        debug("Outgoing notice to clients: {}", outgoingMessage);
-
-        websocketOutgoingMessages->enqueue(outgoingMessage);
+        websocketOutgoingMessages->enqueue(std::move(outgoingMessage));
         return Result<bool>{true};
     } catch (const std::exception &e) {
         return Result<bool>{ServerError(ServerError::InternalError, e.what())};
@@ -96,6 +102,11 @@ Result<bool> broadcastCacheInvalidationToAllClients(const CacheType &type) {
         return Result<bool>{ServerError(ServerError::InvalidData, errorMessage)};
     }
 
+    // No sense building a message that no client is subscribed to
+    if (!ws::anyoneSubscribedTo(ws::MessageType::CacheInvalidation)) {
+        return Result<bool>{true};
+    }
+
     try {
         CacheInvalidation cacheInvalidation{};
         cacheInvalidation.cache_type = type;
@@ -105,13 +116,11 @@ Result<bool> broadcastCacheInvalidationToAllClients(const CacheType &type) {
         invalidateMessage->command = toString(ws::MessageType::CacheInvalidation);
         invalidateMessage->payload = creatures::convertToDto(cacheInvalidation);
 
-        // Make a JSON mapper
-        auto jsonMapper = oatpp::parser::json::mapping::ObjectMapper::createShared();
-
-        std::string outgoingMessage = jsonMapper->writeToString(invalidateMessage);
-        debug("Outgoing cache invalidation to clients: {}", outgoingMessage);
+        // Serialize it once; every client shares the result
+        auto outgoingMessage = ws::serializeForClients(ws::MessageType::CacheInvalidation, invalidateMessage);
+        debug("Outgoing cache invalidation to clients: {}", *outgoingMessage.json);
 
-        websocketOutgoingMessages->enqueue(outgoingMessage);
+        websocketOutgoingMessages->enqueue(std::move(outgoingMessage));
         return Result<bool>{true};
     } catch (const std::exception &e) {
         return Result<bool>{ServerError(ServerError::InternalError, e.what())};
@@ -143,6 +152,11 @@ Result<bool> broadcastPlaylistStatusToAllClients(const PlaylistStatus &playlistS
         return Result<bool>{ServerError(ServerError::InternalError, "Websocket queue unavailable")};
     }
 
+    // No sense building a message that no client is subscribed to
+    if (!ws::anyoneSubscribedTo(ws::MessageType::PlaylistStatus)) {
+        return Result<bool>{true};
+    }
+
     try {
 
         // Create the message to send with the command and payload
@@ -150,13 +164,11 @@ Result<bool> broadcastPlaylistStatusToAllClients(const PlaylistStatus &playlistS
         playlistStatusMessage->command = toString(ws::MessageType::PlaylistStatus);
         playlistStatusMessage->payload = creatures::convertToDto(playlistStatus);
 
-        // Make a JSON mapper
-        auto jsonMapper = oatpp::parser::json::mapping::ObjectMapper::createShared();
-
-        std::string outgoingMessage = jsonMapper->writeToString(playlistStatusMessage);
-        debug("Outgoing playlist update for clients: {}", outgoingMessage);
+        // Serialize it once; every client shares the result
+        auto outgoingMessage = ws::serializeForClients(ws::MessageType::PlaylistStatus, playlistStatusMessage);
+        debug("Outgoing playlist update for clients: {}", *outgoingMessage.json);
 
-        websocketOutgoingMessages->enqueue(outgoingMessage);
+        websocketOutgoingMessages->enqueue(std::move(outgoingMessage));
         return Result<bool>{true};
     } catch (const std::exception &e) {
         return Result<bool>{ServerError(ServerError::InternalError, e.what())};
@@ -175,6 +187,11 @@ Result<bool> broadcastJobProgressToAllClients(const jobs::JobState &jobState) {
         return Result<bool>{ServerError(ServerError::InternalError, "Websocket queue unavailable")};
     }
 
+    // No sense building a message that no client is subscribed to
+    if (!ws::anyoneSubscribedTo(ws::MessageType::JobProgress)) {
+        return Result<bool>{true};
+    }
+
     try {
         // Create the DTO
         auto progressDto = oatpp::Object<ws::JobProgressDto>::createShared();
@@ -189,13 +206,11 @@ Result<bool> broadcastJobProgressToAllClients(const jobs::JobState &jobState) {
         progressMessage->command = toString(ws::MessageType::JobProgress);
         progressMessage->payload = progressDto;
 
-        // Make a JSON mapper
-        auto jsonMapper = oatpp::parser::json::mapping::ObjectMapper::createShared();
+        // Serialize it once; every client shares the result
+        auto outgoingMessage = ws::serializeForClients(ws::MessageType::JobProgress, progressMessage);
+        debug("Outgoing job progress for clients: {}", *outgoingMessage.json);
 
-        std::string outgoingMessage = jsonMapper->writeToString(progressMessage);
-        debug("Outgoing job progress for clients: {}", outgoingMessage);
-
-        websocketOutgoingMessages->enqueue(outgoingMessage);
+        websocketOutgoingMessages->enqueue(std::move(outgoingMessage));
         return Result<bool>{true};
     } catch (const std::exception &e) {
         return Result<bool>{ServerError(ServerError::InternalError, e.what())};
@@ -214,6 +229,11 @@ Result<bool> broadcastJobCompleteToAllClients(const jobs::JobState &jobState) {
         return Result<bool>{ServerError(ServerError::InternalError, "Websocket queue unavailable")};
     }
 
+    // No sense building a message that no client is subscribed to
+    if (!ws::anyoneSubscribedTo(ws::MessageType::JobComplete)) {
+        return Result<bool>{true};
+    }
+
     try {
         // Create the DTO
         auto completeDto = oatpp::Object<ws::JobCompleteDto>::createShared();
@@ -228,13 +248,11 @@ Result<bool> broadcastJobCompleteToAllClients(const jobs::JobState &jobState) {
         completeMessage->command = toString(ws::MessageType::JobComplete);
         completeMessage->payload = completeDto;
 
-        // Make a JSON mapper
-        auto jsonMapper = oatpp::parser::json::mapping::ObjectMapper::createShared();
-
-        std::string outgoingMessage = jsonMapper->writeToString(completeMessage);
-        debug("Outgoing job completion for clients: {}", outgoingMessage);
+        // Serialize it once; every client shares the result
+        auto outgoingMessage = ws::serializeForClients(ws::MessageType::JobComplete, completeMessage);
+        debug("Outgoing job completion for clients: {}", *outgoingMessage.json);
 
-        websocketOutgoingMessages->enqueue(outgoingMessage);
+        websocketOutgoingMessages->enqueue(std::move(outgoingMessage));
         return Result<bool>{true};
     } catch (const std::exception &e) {
         return Result<bool>{ServerError(ServerError::InternalError, e.what())};
@@ -244,4 +262,14 @@ Result<bool> broadcastJobCompleteToAllClients(const jobs::JobState &jobState) {
     }
 }
 
+void forwardToAllClients(const oatpp::String &message) {
+    if (!websocketOutgoingMessages) {
+        return;
+    }
+    const auto type = ws::messageTypeOf(*message);
+    if (!type || ws::anyoneSubscribedTo(*type)) {
+        websocketOutgoingMessages->enqueue(ws::outgoingMessageFrom(type, message));
+    }
+}
+
 } // namespace creatures
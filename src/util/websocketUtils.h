@@ -3,6 +3,8 @@
 
 #include <string>
 
+#include <oatpp/core/Types.hpp>
+
 #include "model/CacheInvalidation.h"
 #include "model/PlaylistStatus.h"
 #include "server/jobs/JobState.h"
@@ -71,4 +73,14 @@ Result<bool> broadcastJobProgressToAllClients(const jobs::JobState &jobState);
  */
 Result<bool> broadcastJobCompleteToAllClients(const jobs::JobState &jobState);
 
+/**
+ * Pass a message one client sent along to all of them as-is
+ *
+ * The client's buffer is shared rather than re-serialized, and nothing is sent
+ * if no client is subscribed to the message's type.
+ *
+ * @param message the JSON the client sent
+ */
+void forwardToAllClients(const oatpp::String &message);
+
 } // namespace creatures
@@ -0,0 +1,190 @@
+/**
+ * Cache-miss encode benchmark: a thread per channel per load vs. the compute pool
+ *
+ * Encodes several 17-channel files at once the way AudioStreamBuffer used to
+ * (fresh, primed encoders for every load and 17 std::async threads for every
+ * chunk) and the way it does now (primed encoders from the PrimedEncoderPool,
+ * each chunk's channels on a ComputePool kept off the first two CPUs). While
+ * that's going on, a stand-in for the event loop ticks every millisecond on
+ * CPU 0 and records how late each wakeup was.
+ *
+ * Reports encode throughput (channel-frames a second) and the tick's lateness.
+ *
+ * Not part of ctest. Build with -DCREATURE_SERVER_BUILD_BENCHMARKS=ON and run
+ * ./creature-server-bench --gtest_filter='ComputePoolBench.*'
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <future>
+#include <memory>
+#include <numbers>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#include <gtest/gtest.h>
+
+#include "server/config.h"
+#include "server/eventloop/sleep.h"
+#include "server/rtp/opus/OpusEncoderWrapper.h"
+#include "server/rtp/opus/OpusPriming.h"
+#include "server/rtp/opus/PrimedEncoderPool.h"
+#include "util/ComputePool.h"
+#include "util/LatencyHistogram.h"
+
+namespace creatures {
+
+namespace {
+
+constexpr std::size_t kLoads = 4;                    // cache misses at the same time
+constexpr std::size_t kFramesPerLoad = 300;          // 3 seconds each
+constexpr auto kTick = std::chrono::milliseconds(1); // like the event loop
+constexpr int kTickCpu = 0;
+
+using Chunk = std::array<std::array<std::vector<uint8_t>, RTP_ENCODE_CHUNK_FRAMES>, RTP_STREAMING_CHANNELS>;
+
+// Something for the encoder to chew on: a different tone on each channel
+std::vector<int16_t> makePcm() {
+    std::vector<int16_t> pcm(kFramesPerLoad * RTP_SAMPLES * RTP_STREAMING_CHANNELS);
+    for (std::size_t sample = 0; sample < kFramesPerLoad * RTP_SAMPLES; ++sample) {
+        for (std::size_t channel = 0; channel < RTP_STREAMING_CHANNELS; ++channel) {
+            const double hz = 110.0 * static_cast<double>(channel + 1);
+            const double seconds = static_cast<double>(sample) / static_cast<double>(RTP_SRATE);
+            pcm[sample * RTP_STREAMING_CHANNELS + channel] =
+                static_cast<int16_t>(8000.0 * std::sin(2.0 * std::numbers::pi * hz * seconds));
+        }
+    }
+    return pcm;
+}
+
+void encodeChannel(rtp::opus::Encoder &encoder, const int16_t *pcm, std::size_t channel, std::size_t frameCount,
+                   std::array<std::vector<uint8_t>, RTP_ENCODE_CHUNK_FRAMES> &packets) {
+    for (std::size_t frame = 0; frame < frameCount; ++frame) {
+        const int16_t *frameBase = pcm + frame * RTP_SAMPLES * RTP_STREAMING_CHANNELS;
+        std::array<int16_t, RTP_SAMPLES> mono{};
+        for (std::size_t s = 0; s < RTP_SAMPLES; ++s) {
+            mono[s] = frameBase[s * RTP_STREAMING_CHANNELS + channel];
+        }
+        packets[frame] = encoder.encode(mono.data());
+    }
+}
+
+// The old way: new encoders for every load, a new thread for every channel of every chunk
+void encodeWithThreads(const std::vector<int16_t> &pcm) {
+    std::array<rtp::opus::Encoder, RTP_STREAMING_CHANNELS> encoders;
+    for (auto &encoder : encoders) {
+        static_cast<void>(rtp::opus::encodePrimingSequence(encoder));
+    }
+    Chunk chunk;
+    for (std::size_t first = 0; first < kFramesPerLoad; first += RTP_ENCODE_CHUNK_FRAMES) {
+        const auto frameCount = std::min(RTP_ENCODE_CHUNK_FRAMES, kFramesPerLoad - first);
+        const int16_t *base = pcm.data() + first * RTP_SAMPLES * RTP_STREAMING_CHANNELS;
+        std::array<std::future<void>, RTP_STREAMING_CHANNELS> futures;
+        for (std::size_t channel = 0; channel < RTP_STREAMING_CHANNELS; ++channel) {
+            futures[channel] = std::async(std::launch::async, [&, channel] {
+                encodeChannel(encoders[channel], base, channel, frameCount, chunk[channel]);
+            });
+        }
+        for (auto &future : futures) {
+            future.get();
+        }
+    }
+}
+
+// The new way: primed encoders from the pool, channels on the compute pool
+void encodeWithPool(const std::vector<int16_t> &pcm, util::ComputePool &pool,
+                    const std::shared_ptr<rtp::opus::PrimedEncoderPool> &encoderPool) {
+    std::array<rtp::opus::PrimedEncoderPool::Lease, RTP_STREAMING_CHANNELS> encoders;
+    for (auto &encoder : encoders) {
+        encoder = encoderPool->acquire();
+    }
+    Chunk chunk;
+    for (std::size_t first = 0; first < kFramesPerLoad; first += RTP_ENCODE_CHUNK_FRAMES) {
+        const auto frameCount = std::min(RTP_ENCODE_CHUNK_FRAMES, kFramesPerLoad - first);
+        const int16_t *base = pcm.data() + first * RTP_SAMPLES * RTP_STREAMING_CHANNELS;
+        pool.parallelFor(RTP_STREAMING_CHANNELS, [&](std::size_t channel) {
+            encodeChannel(*encoders[channel], base, channel, frameCount, chunk[channel]);
+        });
+    }
+}
+
+void pinToCpu(int cpu) {
+#if defined(__linux__)
+    cpu_set_t affinity;
+    CPU_ZERO(&affinity);
+    CPU_SET(cpu, &affinity);
+    static_cast<void>(sched_setaffinity(0, sizeof(affinity), &affinity));
+#else
+    static_cast<void>(cpu);
+#endif
+}
+
+// Run kLoads encodes at once while the ticker runs, and report both
+void runLoads(const char *label, const std::function<void()> &encodeOneLoad) {
+    LatencyHistogram lateness;
+    std::atomic<bool> encoding{true};
+    std::thread ticker([&] {
+        pinToCpu(kTickCpu);
+        auto target = std::chrono::steady_clock::now() + kTick;
+        while (encoding.load(std::memory_order_relaxed)) {
+            sleepUntil(target);
+            const auto woke = std::chrono::steady_clock::now();
+            lateness.record(
+                static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(woke - target).count()));
+            target += kTick;
+        }
+    });
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> loads;
+    for (std::size_t i = 0; i < kLoads; ++i) {
+        loads.emplace_back(encodeOneLoad);
+    }
+    for (auto &load : loads) {
+        load.join();
+    }
+    const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    encoding = false;
+    ticker.join();
+
+    const auto channelFrames = static_cast<double>(kLoads * kFramesPerLoad * RTP_STREAMING_CHANNELS);
+    const auto snapshot = lateness.snapshot();
+    std::printf("%-8s %8.0f channel-frames/s (%5.2fs) | tick late p50 %7.1fus p99 %7.1fus p99.9 %7.1fus max %8.1fus\n",
+                label, channelFrames / seconds, seconds, static_cast<double>(snapshot.valueAtPercentile(50)) / 1000.0,
+                static_cast<double>(snapshot.valueAtPercentile(99)) / 1000.0,
+                static_cast<double>(snapshot.valueAtPercentile(99.9)) / 1000.0,
+                static_cast<double>(snapshot.max) / 1000.0);
+}
+
+} // namespace
+
+TEST(ComputePoolBench, ThreadsPerLoadVsPool) {
+    const auto pcm = makePcm();
+
+    auto cpus = util::ComputePool::allowedCpus();
+    if (cpus.size() > COMPUTE_POOL_RESERVED_CPUS + 1) {
+        cpus.erase(cpus.begin(), cpus.begin() + COMPUTE_POOL_RESERVED_CPUS);
+    }
+    util::ComputePool pool(std::max<std::size_t>(1, cpus.size()), cpus, "BenchPool");
+    auto encoderPool = std::make_shared<rtp::opus::PrimedEncoderPool>(kLoads * RTP_STREAMING_CHANNELS);
+
+    std::printf("\n%zu loads of %zu frames at once, ticking every %lldms on CPU %d; pool has %zu threads\n", kLoads,
+                kFramesPerLoad, static_cast<long long>(kTick.count()), kTickCpu, pool.threadCount());
+    runLoads("threads", [&pcm] { encodeWithThreads(pcm); });
+    runLoads("pool", [&] { encodeWithPool(pcm, pool, encoderPool); });
+
+    // Again, now that the encoder pool has encoders to hand out
+    runLoads("pool", [&] { encodeWithPool(pcm, pool, encoderPool); });
+}
+
+} // namespace creatures
@@ -0,0 +1,70 @@
+/**
+ * Event loop sleep benchmark: plain sleep vs. hybrid sleep/spin
+ *
+ * Runs the event loop's 1ms tick with no work in it, once sleeping with
+ * sleepUntil() (what the loop does in "sleep" mode) and once with
+ * hybridSleepUntil() (what it does in "hybrid" mode), and reports how late
+ * each wakeup was and how much CPU the thread burned doing it.
+ *
+ * Not part of ctest. Build with -DCREATURE_SERVER_BUILD_BENCHMARKS=ON and run
+ * ./creature-server-bench --gtest_filter='EventLoopSleepBench.*'
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <functional>
+
+#include <gtest/gtest.h>
+
+#include "server/eventloop/sleep.h"
+#include "util/LatencyHistogram.h"
+
+namespace creatures {
+
+namespace {
+
+constexpr int kTicks = 3000;
+constexpr auto kPeriod = std::chrono::milliseconds(1);
+constexpr auto kSpin = std::chrono::microseconds(100);
+
+double threadCpuSeconds() {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) / 1e9;
+}
+
+void runTicks(const char *label, const std::function<void(std::chrono::steady_clock::time_point)> &sleeper) {
+    LatencyHistogram oversleep;
+    const auto cpuStart = threadCpuSeconds();
+    const auto wallStart = std::chrono::steady_clock::now();
+
+    auto target = wallStart + kPeriod;
+    for (int i = 0; i < kTicks; ++i) {
+        sleeper(target);
+        const auto woke = std::chrono::steady_clock::now();
+        oversleep.record(
+            static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(woke - target).count()));
+        target += kPeriod;
+    }
+
+    const auto wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    const auto cpu = threadCpuSeconds() - cpuStart;
+    const auto snapshot = oversleep.snapshot();
+    std::printf("%-7s oversleep p50 %7.1fus p99 %7.1fus p99.9 %7.1fus max %8.1fus | cpu %4.1f%% of a core\n", label,
+                static_cast<double>(snapshot.valueAtPercentile(50)) / 1000.0,
+                static_cast<double>(snapshot.valueAtPercentile(99)) / 1000.0,
+                static_cast<double>(snapshot.valueAtPercentile(99.9)) / 1000.0,
+                static_cast<double>(snapshot.max) / 1000.0, 100.0 * cpu / wall);
+}
+
+} // namespace
+
+TEST(EventLoopSleepBench, SleepVsHybrid) {
+    std::printf("\n%d ticks of %lldms, hybrid spins for the last %lldus\n", kTicks,
+                static_cast<long long>(kPeriod.count()), static_cast<long long>(kSpin.count()));
+    runTicks("sleep", [](auto deadline) { sleepUntil(deadline); });
+    runTicks("hybrid", [](auto deadline) { hybridSleepUntil(deadline, kSpin); });
+}
+
+} // namespace creatures
@@ -0,0 +1,217 @@
+/**
+ * EventScheduler benchmark: timing wheel vs. the old mutex + priority_queue
+ *
+ * Drives both schedulers with the load a busy show produces — 16 creature
+ * playback runners each emitting a DMX event per frame, fixture pattern ticks
+ * at 40 Hz, the RTP frame cadence, and a few HTTP threads submitting from the
+ * side — and reports events/sec flat-out plus tick jitter at the real 1 ms
+ * pace.
+ *
+ * Not part of ctest. Build with -DCREATURE_SERVER_BUILD_BENCHMARKS=ON and run
+ * ./creature-server-bench --gtest_filter='EventSchedulerBench.*'
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "server/eventloop/scheduler.h"
+
+namespace creatures {
+
+namespace {
+
+constexpr int kCreatures = 16;
+constexpr int kFixtures = 24;
+constexpr framenum_t kFixtureTickFrames = 25;
+constexpr framenum_t kRtpFrames = 10;
+constexpr int kHttpThreads = 4;
+
+/**
+ * What the event loop used before the timing wheel, kept here as the baseline
+ */
+class LegacyEventScheduler {
+  public:
+    void bindConsumerThread() {}
+
+    void submit(std::shared_ptr<Event> event) {
+        std::lock_guard lock(mutex_);
+        queue_.push(std::move(event));
+    }
+
+    void advanceTo(framenum_t frame) { now_ = frame; }
+
+    std::shared_ptr<Event> popDue() {
+        std::lock_guard lock(mutex_);
+        if (queue_.empty() || queue_.top()->frameNumber > now_) {
+            return nullptr;
+        }
+        auto event = queue_.top();
+        queue_.pop();
+        return event;
+    }
+
+  private:
+    struct Comparator {
+        bool operator()(const std::shared_ptr<Event> &a, const std::shared_ptr<Event> &b) const {
+            return a->frameNumber > b->frameNumber;
+        }
+    };
+
+    std::mutex mutex_;
+    std::priority_queue<std::shared_ptr<Event>, std::vector<std::shared_ptr<Event>>, Comparator> queue_;
+    framenum_t now_ = 0;
+};
+
+template <typename Scheduler> class LeafEvent : public EventBase<LeafEvent<Scheduler>> {
+  public:
+    explicit LeafEvent(framenum_t frame) : EventBase<LeafEvent<Scheduler>>(frame) {}
+    Result<framenum_t> executeImpl() { return Result<framenum_t>{this->frameNumber}; }
+};
+
+/**
+ * Reschedules itself every `period` frames, optionally fanning out a leaf
+ * event on the same frame the way PlaybackRunnerEvent used to emit DMXEvents
+ */
+template <typename Scheduler> class PeriodicEvent : public EventBase<PeriodicEvent<Scheduler>> {
+  public:
+    PeriodicEvent(framenum_t frame, Scheduler &scheduler_, framenum_t period_, bool emitsLeaf_, framenum_t until_)
+        : EventBase<PeriodicEvent<Scheduler>>(frame), scheduler(scheduler_), period(period_), emitsLeaf(emitsLeaf_),
+          until(until_) {}
+
+    Result<framenum_t> executeImpl() {
+        if (emitsLeaf) {
+            scheduler.submit(std::make_shared<LeafEvent<Scheduler>>(this->frameNumber));
+        }
+        const framenum_t next = this->frameNumber + period;
+        if (next <= until) {
+            scheduler.submit(
+                std::make_shared<PeriodicEvent<Scheduler>>(next, scheduler, period, emitsLeaf, until));
+        }
+        return Result<framenum_t>{this->frameNumber};
+    }
+
+  private:
+    Scheduler &scheduler;
+    framenum_t period;
+    bool emitsLeaf;
+    framenum_t until;
+};
+
+struct RunStats {
+    uint64_t events = 0;
+    double seconds = 0.0;
+    std::vector<double> lateness_us; // how late each tick started vs. its deadline
+    std::vector<double> busy_us;     // time spent draining each tick
+};
+
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    const auto index = static_cast<size_t>(p * static_cast<double>(values.size() - 1));
+    return values[index];
+}
+
+template <typename Scheduler> RunStats runShowLoad(framenum_t frames, bool paced) {
+    using clock = std::chrono::steady_clock;
+
+    Scheduler scheduler;
+    scheduler.bindConsumerThread();
+
+    for (int i = 0; i < kCreatures; ++i) {
+        scheduler.submit(std::make_shared<PeriodicEvent<Scheduler>>(1, scheduler, 1, true, frames));
+    }
+    for (int i = 0; i < kFixtures; ++i) {
+        scheduler.submit(std::make_shared<PeriodicEvent<Scheduler>>(
+            1 + static_cast<framenum_t>(i), scheduler, kFixtureTickFrames, false, frames));
+    }
+    scheduler.submit(std::make_shared<PeriodicEvent<Scheduler>>(1, scheduler, kRtpFrames, false, frames));
+
+    // HTTP-ish side traffic: a handful of threads dropping in one-off events
+    std::atomic<bool> stop{false};
+    std::atomic<framenum_t> currentFrame{0};
+    std::vector<std::thread> http;
+    for (int t = 0; t < kHttpThreads; ++t) {
+        http.emplace_back([&] {
+            while (!stop.load(std::memory_order_relaxed)) {
+                scheduler.submit(
+                    std::make_shared<LeafEvent<Scheduler>>(currentFrame.load(std::memory_order_relaxed) + 5));
+                std::this_thread::sleep_for(std::chrono::microseconds(250));
+            }
+        });
+    }
+
+    RunStats stats;
+    if (paced) {
+        stats.lateness_us.reserve(frames);
+        stats.busy_us.reserve(frames);
+    }
+
+    const auto start = clock::now();
+    auto deadline = start;
+    for (framenum_t frame = 1; frame <= frames; ++frame) {
+        if (paced) {
+            deadline += std::chrono::milliseconds(EVENT_LOOP_PERIOD_MS);
+            std::this_thread::sleep_until(deadline);
+        }
+        const auto tickStart = clock::now();
+        currentFrame.store(frame, std::memory_order_relaxed);
+
+        scheduler.advanceTo(frame);
+        while (auto event = scheduler.popDue()) {
+            event->execute();
+            ++stats.events;
+        }
+
+        if (paced) {
+            const auto tickEnd = clock::now();
+            stats.lateness_us.push_back(std::chrono::duration<double, std::micro>(tickStart - deadline).count());
+            stats.busy_us.push_back(std::chrono::duration<double, std::micro>(tickEnd - tickStart).count());
+        }
+    }
+    stats.seconds = std::chrono::duration<double>(clock::now() - start).count();
+
+    stop.store(true);
+    for (auto &thread : http) {
+        thread.join();
+    }
+    return stats;
+}
+
+void report(const char *name, const RunStats &flatOut, const RunStats &paced) {
+    std::printf("%-22s %12.0f events/s | tick late p50 %7.1fus p99 %7.1fus max %8.1fus | busy p50 %6.1fus p99 "
+                "%6.1fus max %7.1fus\n",
+                name, static_cast<double>(flatOut.events) / flatOut.seconds, percentile(paced.lateness_us, 0.50),
+                percentile(paced.lateness_us, 0.99), percentile(paced.lateness_us, 1.0),
+                percentile(paced.busy_us, 0.50), percentile(paced.busy_us, 0.99), percentile(paced.busy_us, 1.0));
+}
+
+} // namespace
+
+TEST(EventSchedulerBench, ShowLoadTimingWheelVsPriorityQueue) {
+    constexpr framenum_t flatOutFrames = 200'000;
+    constexpr framenum_t pacedFrames = 5'000;
+
+    const auto legacyFlat = runShowLoad<LegacyEventScheduler>(flatOutFrames, false);
+    const auto wheelFlat = runShowLoad<EventScheduler>(flatOutFrames, false);
+    const auto legacyPaced = runShowLoad<LegacyEventScheduler>(pacedFrames, true);
+    const auto wheelPaced = runShowLoad<EventScheduler>(pacedFrames, true);
+
+    std::printf("\n%d creatures + %d fixtures + RTP + %d HTTP threads\n", kCreatures, kFixtures, kHttpThreads);
+    report("priority_queue+mutex", legacyFlat, legacyPaced);
+    report("timing wheel", wheelFlat, wheelPaced);
+
+    EXPECT_GT(wheelFlat.events, 0U);
+}
+
+} // namespace creatures
@@ -0,0 +1,162 @@
+/**
+ * PlaybackSession construction benchmark: packed frames vs. a vector per frame
+ *
+ * Builds a 10 minute, 16 creature dialog animation (20 ms frames, 8 channels
+ * per creature) and measures what it costs to get it ready to play:
+ *
+ *   - legacy:  decoding every base64 frame into its own std::vector, the way
+ *              PlaybackSession used to build TrackState::decodedFrames
+ *   - api:     PackedFrames::fromBase64Frames(), what a PUT of the animation costs now
+ *   - stored:  decoding the packed BSON binary, what loading it from Mongo costs now
+ *   - session: constructing the PlaybackSession itself, which only shares the buffers
+ *
+ * Reports wall time and how much resident memory each one leaves behind.
+ *
+ * Not part of ctest. Build with -DCREATURE_SERVER_BUILD_BENCHMARKS=ON and run
+ * ./creature-server-bench --gtest_filter='PlaybackSessionBench.*'
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <base64.hpp>
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include "model/Animation.h"
+#include "model/PackedFrames.h"
+#include "server/animation/PlaybackSession.h"
+#include "util/Base64.h"
+#include "util/ObservabilityManager.h"
+
+namespace creatures {
+
+// PlaybackSession reports to this when it's set; the benchmark leaves it off
+std::shared_ptr<ObservabilityManager> observability;
+
+namespace {
+
+constexpr int kCreatures = 16;
+constexpr uint32_t kMsPerFrame = 20;
+constexpr std::size_t kFrames = 10 * 60 * 1000 / kMsPerFrame;
+constexpr std::size_t kChannels = 8;
+constexpr int kRuns = 5;
+
+// Resident set size in bytes, from /proc (0 where there isn't one)
+long residentBytes() {
+    std::ifstream statm("/proc/self/statm");
+    long size = 0;
+    long resident = 0;
+    if (!(statm >> size >> resident)) {
+        return 0;
+    }
+    return resident * sysconf(_SC_PAGESIZE);
+}
+
+std::vector<std::vector<std::string>> makeEncodedTracks() {
+    std::mt19937 rng(7);
+    std::vector<std::vector<std::string>> tracks(kCreatures);
+    std::string frame(kChannels, '\0');
+    for (auto &track : tracks) {
+        track.reserve(kFrames);
+        for (std::size_t i = 0; i < kFrames; ++i) {
+            for (auto &channel : frame) {
+                channel = static_cast<char>(rng());
+            }
+            track.push_back(base64::to_base64(frame));
+        }
+    }
+    return tracks;
+}
+
+// Best time over a few runs. Memory comes from the first run, since later runs
+// reuse pages the allocator held on to from it.
+template <typename Fn> void report(const char *label, Fn &&fn) {
+    using clock = std::chrono::steady_clock;
+
+    double bestMs = 0.0;
+    long firstGrowth = 0;
+    for (int run = 0; run < kRuns; ++run) {
+        const auto rssBefore = residentBytes();
+        const auto start = clock::now();
+        auto kept = fn();
+        const auto elapsed = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        const auto growth = residentBytes() - rssBefore;
+        if (run == 0 || elapsed < bestMs) {
+            bestMs = elapsed;
+        }
+        if (run == 0) {
+            firstGrowth = growth;
+        }
+    }
+    std::printf("%-8s %9.2f ms   RSS +%8.2f MiB\n", label, bestMs,
+                static_cast<double>(firstGrowth) / (1024.0 * 1024.0));
+}
+
+} // namespace
+
+TEST(PlaybackSessionBench, TenMinuteSixteenCreatureDialog) {
+    const auto encoded = makeEncodedTracks();
+
+    std::printf("\n%d tracks x %zu frames x %zu channels (%.1f MiB of DMX)\n", kCreatures, kFrames, kChannels,
+                static_cast<double>(kCreatures * kFrames * kChannels) / (1024.0 * 1024.0));
+
+    report("legacy", [&] {
+        std::vector<std::vector<std::vector<uint8_t>>> tracks;
+        tracks.reserve(encoded.size());
+        for (const auto &frames : encoded) {
+            auto &decoded = tracks.emplace_back();
+            decoded.reserve(frames.size());
+            for (const auto &frame : frames) {
+                const auto raw = base64::from_base64(frame);
+                decoded.emplace_back(raw.begin(), raw.end());
+            }
+        }
+        return tracks;
+    });
+
+    report("api", [&] {
+        std::vector<PackedFrames> tracks;
+        for (const auto &frames : encoded) {
+            tracks.push_back(PackedFrames::fromBase64Frames(frames).getValue().value());
+        }
+        return tracks;
+    });
+
+    // What Mongo hands back: one base64 string per track
+    Animation animation;
+    animation.id = "bench";
+    animation.metadata.title = "Ten minute dialog";
+    animation.metadata.milliseconds_per_frame = kMsPerFrame;
+    std::vector<std::string> stored;
+    for (int i = 0; i < kCreatures; ++i) {
+        Track track;
+        track.id = fmt::format("track-{}", i);
+        track.creature_id = fmt::format("creature-{}", i);
+        track.frames = PackedFrames::fromBase64Frames(encoded[i]).getValue().value();
+        const auto bytes = track.frames.data();
+        stored.push_back(
+            base64::to_base64(std::string_view(reinterpret_cast<const char *>(bytes.data()), bytes.size())));
+        animation.tracks.push_back(std::move(track));
+    }
+
+    report("stored", [&] {
+        std::vector<PackedFrames> tracks;
+        for (const auto &blob : stored) {
+            std::vector<uint8_t> bytes(util::base64DecodedSize(blob).value());
+            EXPECT_TRUE(util::base64DecodeInto(blob, bytes));
+            tracks.push_back(PackedFrames::fromBytes(kChannels, kFrames, std::move(bytes)).getValue().value());
+        }
+        return tracks;
+    });
+
+    report("session", [&] { return std::make_unique<PlaybackSession>(animation, 1, 0); });
+}
+
+} // namespace creatures
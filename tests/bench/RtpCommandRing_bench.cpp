@@ -0,0 +1,209 @@
+/**
+ * RTP output command handoff benchmark: mutex/deque/condvar vs. the SPSC ring
+ *
+ * A stand-in for the event loop hands a command to a stand-in for the RTP
+ * output worker every millisecond, first the way BoundedCommandQueue used to
+ * (a command with a lease, two shared_ptrs and a trace context, through a
+ * mutex, a std::deque and a condition variable), then the way
+ * MultiOpusRtpServer does now (a small plain command through RtpCommandRing,
+ * the worker sleeping on a futex).
+ *
+ * Reports how long the producer spent in the push and how long it took from
+ * the push to the worker having the command in hand.
+ *
+ * Not part of ctest. Build with -DCREATURE_SERVER_BUILD_BENCHMARKS=ON and run
+ * ./creature-server-bench --gtest_filter='RtpCommandRingBench.*'
+ */
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include "server/eventloop/sleep.h"
+#include "server/rtp/AsyncAudioTraceContext.h"
+#include "server/rtp/RtpCommandRing.h"
+#include "server/rtp/RtpOutputCoordinator.h"
+#include "server/rtp/RtpStreamTable.h"
+#include "util/LatencyHistogram.h"
+
+namespace creatures {
+
+namespace {
+
+constexpr int kCommands = 3000;
+constexpr auto kPeriod = std::chrono::milliseconds(1); // one command per event loop tick
+constexpr std::size_t kCapacity = 64;
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t nanosecondsSince(Clock::time_point start) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+}
+
+void report(const char *label, const char *what, const LatencyHistogram &histogram) {
+    const auto snapshot = histogram.snapshot();
+    std::printf("%-8s %-7s p50 %7.2fus p99 %7.2fus p99.9 %7.2fus max %8.2fus\n", label, what,
+                static_cast<double>(snapshot.valueAtPercentile(50)) / 1000.0,
+                static_cast<double>(snapshot.valueAtPercentile(99)) / 1000.0,
+                static_cast<double>(snapshot.valueAtPercentile(99.9)) / 1000.0,
+                static_cast<double>(snapshot.max) / 1000.0);
+}
+
+// What went through the queue before
+struct OldCommand {
+    int type{0};
+    rtp::RtpOutputLease lease;
+    std::shared_ptr<int> buffer;
+    std::size_t frameIndex{0};
+    std::size_t skippedFrames{0};
+    bool releaseAfterSend{false};
+    std::shared_ptr<void> releaseAfterSendHold;
+    rtp::AsyncAudioTraceContext traceContext;
+    Clock::time_point pushed;
+};
+
+// BoundedCommandQueue as it was, minus eraseIf()
+class MutexQueue {
+  public:
+    bool tryPush(OldCommand command) {
+        {
+            std::lock_guard lock(mutex_);
+            if (stopped_ || queue_.size() >= kCapacity) {
+                return false;
+            }
+            queue_.push_back(std::move(command));
+        }
+        condition_.notify_one();
+        return true;
+    }
+
+    std::optional<OldCommand> waitPop() {
+        std::unique_lock lock(mutex_);
+        condition_.wait(lock, [this] { return stopped_ || !queue_.empty(); });
+        if (stopped_) {
+            return std::nullopt;
+        }
+        OldCommand command = std::move(queue_.front());
+        queue_.pop_front();
+        return command;
+    }
+
+    void stop() {
+        {
+            std::lock_guard lock(mutex_);
+            stopped_ = true;
+        }
+        condition_.notify_all();
+    }
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::deque<OldCommand> queue_;
+    bool stopped_{false};
+};
+
+// What goes through the ring now
+struct NewCommand {
+    int type{0};
+    rtp::RtpStreamTable::Handle stream;
+    rtp::RtpStreamTable::Handle retire;
+    std::size_t frameIndex{0};
+    std::size_t skippedFrames{0};
+    uint64_t enqueueFrame{0};
+    bool releaseAfterSend{false};
+    Clock::time_point pushed;
+};
+
+rtp::AsyncAudioTraceContext traceContext() {
+    return rtp::AsyncAudioTraceContext{"4bf92f3577b34da6a3ce929d0e0e4736", "00f067aa0ba902b7",
+                                       "session-0123456789abcdef", "animation-0123456789abcdef",
+                                       "a-reasonably-long-sound-file-name.wav", 0};
+}
+
+} // namespace
+
+TEST(RtpCommandRingBench, MutexQueueVsRing) {
+    std::printf("\n%d commands, one every %lldms\n", kCommands, static_cast<long long>(kPeriod.count()));
+
+    {
+        MutexQueue queue;
+        LatencyHistogram push;
+        LatencyHistogram handoff;
+        std::thread worker([&] {
+            while (auto command = queue.waitPop()) {
+                handoff.record(nanosecondsSince(command->pushed));
+            }
+        });
+
+        const rtp::RtpOutputLease lease{1, "animation-0123456789abcdef"};
+        auto buffer = std::make_shared<int>(0);
+        auto context = traceContext();
+        auto target = Clock::now() + kPeriod;
+        for (int i = 0; i < kCommands; ++i) {
+            sleepUntil(target);
+            target += kPeriod;
+            context.enqueueFrame = static_cast<uint64_t>(i);
+            const auto started = Clock::now();
+            // The copies the event loop made on every frame: lease, buffer and trace context
+            static_cast<void>(queue.tryPush(
+                OldCommand{2, lease, buffer, static_cast<std::size_t>(i), 0, false, nullptr, context, started}));
+            push.record(nanosecondsSince(started));
+        }
+        std::this_thread::sleep_for(kPeriod * 10);
+        queue.stop();
+        worker.join();
+        report("mutex", "push", push);
+        report("mutex", "handoff", handoff);
+    }
+
+    {
+        rtp::RtpCommandRing<NewCommand> ring(kCapacity);
+        rtp::RtpStreamTable streams;
+        LatencyHistogram push;
+        LatencyHistogram handoff;
+        std::thread worker([&] {
+            NewCommand command;
+            while (ring.waitPop(command) == rtp::RtpCommandWait::Command) {
+                handoff.record(nanosecondsSince(command.pushed));
+                static_cast<void>(streams.find(command.stream));
+            }
+        });
+
+        // The stream's opened once; every frame after that just names it
+        const auto stream = streams.open(
+            rtp::RtpStream{rtp::RtpOutputLease{1, "animation-0123456789abcdef"}, nullptr, nullptr, traceContext()});
+        ASSERT_TRUE(stream.has_value());
+        auto target = Clock::now() + kPeriod;
+        for (int i = 0; i < kCommands; ++i) {
+            sleepUntil(target);
+            target += kPeriod;
+            const auto started = Clock::now();
+            NewCommand command;
+            command.type = 2;
+            command.stream = *stream;
+            command.frameIndex = static_cast<std::size_t>(i);
+            command.enqueueFrame = static_cast<uint64_t>(i);
+            command.pushed = started;
+            static_cast<void>(streams.isOpen(*stream) && ring.tryPush(command));
+            push.record(nanosecondsSince(started));
+        }
+        std::this_thread::sleep_for(kPeriod * 10);
+        ring.stop();
+        worker.join();
+        report("ring", "push", push);
+        report("ring", "handoff", handoff);
+    }
+}
+
+} // namespace creatures
@@ -0,0 +1,135 @@
+/**
+ * Stream frame decode benchmark: JSON with base64 vs. binary stream frames
+ *
+ * Decodes the same stream frame (32 channels for one creature) over and over
+ * on one thread, first the way a "stream-frame" JSON message is handled (the
+ * object mapper reads the whole command, the creature ID is copied out, and
+ * the base64 is decoded into a fresh vector), then the way a binary stream
+ * frame is (the header is read in place and the slot looked up in the
+ * connection's StreamSlots). Writing the channels to the universe costs the
+ * same either way, so it's left out.
+ *
+ * Reports frames a second on one core, and how many creatures at 50 Hz that
+ * would keep up with.
+ *
+ * Not part of ctest. Build with -DCREATURE_SERVER_BUILD_BENCHMARKS=ON and run
+ * ./creature-server-bench --gtest_filter='StreamFrameBench.*'
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <base64.hpp>
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+#include <oatpp/core/Types.hpp>
+#include <oatpp/parser/json/mapping/ObjectMapper.hpp>
+
+#include "server/ws/messaging/BinaryStreamFrame.h"
+#include "server/ws/messaging/StreamFrameCommandDTO.h"
+
+namespace creatures::ws {
+
+namespace {
+
+constexpr auto kRunTime = std::chrono::milliseconds(2000);
+constexpr size_t kChannels = 32;
+constexpr double kFramesPerCreature = 50.0;
+
+const std::string kCreatureId = "6543a1f2e4b0c8d9a1b2c3d4";
+
+using Clock = std::chrono::steady_clock;
+
+struct Throughput {
+    uint64_t frames{0};
+    uint64_t checksum{0};
+    double seconds{0};
+
+    [[nodiscard]] double framesPerSecond() const { return static_cast<double>(frames) / seconds; }
+};
+
+/**
+ * Decode frames until the time's up. `decode` returns one of the frame's bytes, so the
+ * compiler can't throw the work away.
+ */
+Throughput run(const std::function<uint8_t(uint32_t)> &decode) {
+    Throughput result;
+    const auto start = Clock::now();
+    auto now = start;
+    while (now - start < kRunTime) {
+        for (int batch = 0; batch < 1000; ++batch) {
+            result.checksum += decode(static_cast<uint32_t>(result.frames));
+            result.frames++;
+        }
+        now = Clock::now();
+    }
+    result.seconds = std::chrono::duration<double>(now - start).count();
+    return result;
+}
+
+void report(const char *label, size_t messageBytes, const Throughput &throughput) {
+    std::printf("%-7s %4zu bytes  %10.0f frames/s/core  %7.2fus/frame  %8.0f creatures at 50 Hz\n", label,
+                messageBytes, throughput.framesPerSecond(), 1e6 / throughput.framesPerSecond(),
+                throughput.framesPerSecond() / kFramesPerCreature);
+}
+
+} // namespace
+
+TEST(StreamFrameBench, JsonVsBinary) {
+    std::vector<uint8_t> channels(kChannels);
+    for (size_t channel = 0; channel < kChannels; ++channel) {
+        channels[channel] = static_cast<uint8_t>(channel * 7);
+    }
+
+    // What the console sends now
+    const auto mapper = oatpp::parser::json::mapping::ObjectMapper::createShared();
+    const oatpp::String json = fmt::format(R"({{"command":"stream-frame","payload":{{"creature_id":"{}",)"
+                                           R"("universe":1,"data":"{}"}}}})",
+                                           kCreatureId,
+                                           base64::to_base64(std::string(channels.begin(), channels.end())));
+
+    const auto jsonResult = run([&](uint32_t) {
+        const auto dto = mapper->readFromString<oatpp::Object<StreamFrameCommandDTO>>(json);
+        const std::string creatureId = dto->payload->creature_id;
+        const universe_t universe = dto->payload->universe;
+        const auto decoded = base64::from_base64(std::string(dto->payload->data));
+        const std::vector<uint8_t> frameData(decoded.begin(), decoded.end());
+        return static_cast<uint8_t>(frameData.back() + creatureId.size() + universe);
+    });
+
+    // ...and what it can send instead, once it's bound slot 0
+    StreamSlots slots;
+    slots.bind({{0, kCreatureId}});
+    auto binary = writeBinaryStreamFrame(BinaryStreamFrame{0, 1, 0, channels}).getValue().value();
+
+    const auto binaryResult = run([&](uint32_t sequence) {
+        // A new sequence number each time, the way they'd arrive
+        binary[4] = static_cast<uint8_t>(sequence >> 24);
+        binary[5] = static_cast<uint8_t>(sequence >> 16);
+        binary[6] = static_cast<uint8_t>(sequence >> 8);
+        binary[7] = static_cast<uint8_t>(sequence);
+
+        const auto frame = *readBinaryStreamFrame(binary).getValue();
+        const auto *creatureId = slots.creatureIn(frame.slot);
+        if (!creatureId || !slots.accept(frame.slot, frame.sequence)) {
+            return uint8_t{0};
+        }
+        return static_cast<uint8_t>(frame.channels.back() + creatureId->size() + frame.universe);
+    });
+
+    std::printf("\n%zu channels per frame, one thread\n", kChannels);
+    report("json", json->size(), jsonResult);
+    report("binary", binary.size(), binaryResult);
+    std::printf("binary is %.1fx the frames\n", binaryResult.framesPerSecond() / jsonResult.framesPerSecond());
+
+    EXPECT_EQ(jsonResult.checksum / jsonResult.frames, binaryResult.checksum / binaryResult.frames);
+    EXPECT_GT(binaryResult.frames, 0U);
+}
+
+} // namespace creatures::ws
@@ -0,0 +1,181 @@
+/**
+ * Stream frame latency benchmark: the fast lane vs. the long way
+ *
+ * Times each frame from when the handler gets it to when its channels are in
+ * the universe the E1.31 worker sends from, the same span the server's stream
+ * frame latency histograms cover. Each websocket thread streams 32 channels to
+ * its own four creatures, the way one console connection does.
+ *
+ *   - fast lane: find the creature's context, push its deadline out, and write
+ *                the channels
+ *   - full path: what every frame did before there was a fast lane, and what
+ *                a session's first frame still does: read the generation, look
+ *                the creature up in the cache, mark it streaming and open its
+ *                context under the streaming lock, then write the channels
+ *
+ * The full path here leaves out cancelling the creature's playback and checking
+ * its universe's playlist, which need a running SessionManager, so its numbers
+ * are a floor on what the long way really costs.
+ *
+ * Reports per-frame p50/p99/p99.9/max with 1 and 4 websocket threads sending
+ * back to back.
+ *
+ * Not part of ctest. Build with -DCREATURE_SERVER_BUILD_BENCHMARKS=ON and run
+ * ./creature-server-bench --gtest_filter='StreamingContextsBench.*'
+ */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+#include <spdlog/sinks/null_sink.h>
+#include <spdlog/spdlog.h>
+
+#include "Universe.h"
+#include "model/Creature.h"
+#include "server/ws/messaging/StreamingContexts.h"
+#include "util/cache.h"
+
+namespace creatures::ws {
+
+namespace {
+
+constexpr size_t kFramesPerThread = 500000;
+constexpr int kCreaturesPerThread = 4;
+constexpr size_t kChannels = 32;
+constexpr universe_t kUniverse = 1;
+constexpr e131::MergeSource kDirect{1, MERGE_PRIORITY_DEFAULT};
+
+using Clock = std::chrono::steady_clock;
+
+// What the handler shares between its websocket threads
+struct Streaming {
+    e131::Universe universe;
+    ObjectCache<creatureId_t, Creature> creatureCache;
+    StreamingContexts contexts;
+    std::mutex streamingMutex;
+
+    // CreatureService's streaming registry
+    std::mutex registryMutex;
+    std::unordered_set<creatureId_t> registry;
+
+    framenum_t deadline{1000};
+
+    explicit Streaming(std::shared_ptr<spdlog::logger> logger) : universe(std::move(logger)) {}
+};
+
+creatureId_t creatureIdFor(int thread, int creature) {
+    return fmt::format("6543a1f2e4b0c8d9a1b2{:04x}", thread * 16 + creature);
+}
+
+void fastLane(Streaming &streaming, const creatureId_t &creatureId, std::span<const uint8_t> channels) {
+    const auto context = streaming.contexts.findCurrent(creatureId, kUniverse);
+    if (context && channels.size() <= context->channelCount && context->extend(streaming.deadline)) {
+        streaming.universe.setFragment(kDirect, static_cast<uint16_t>(context->channelOffset), channels);
+    }
+}
+
+void fullPath(Streaming &streaming, const creatureId_t &creatureId, std::span<const uint8_t> channels) {
+    const auto generation = streaming.contexts.currentGeneration();
+    const auto creature = streaming.creatureCache.get(creatureId);
+    {
+        std::lock_guard lock(streaming.streamingMutex);
+        auto previous = streaming.contexts.find(creatureId);
+        {
+            std::lock_guard registryLock(streaming.registryMutex);
+            streaming.registry.insert(creatureId);
+        }
+        streaming.contexts.open(creatureId, kUniverse, creature->channel_offset,
+                                static_cast<uint16_t>(channels.size()), generation,
+                                previous ? previous->startedAt : Clock::now(), streaming.deadline);
+    }
+    streaming.universe.setFragment(kDirect, creature->channel_offset, channels);
+}
+
+double percentile(std::vector<double> &sorted, double p) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    return sorted[static_cast<size_t>(p * static_cast<double>(sorted.size() - 1))];
+}
+
+template <typename Path> std::vector<double> run(Streaming &streaming, int threadCount, Path path) {
+    std::vector<std::vector<double>> samples(static_cast<size_t>(threadCount));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t] {
+            std::array<creatureId_t, kCreaturesPerThread> creatureIds;
+            for (int c = 0; c < kCreaturesPerThread; ++c) {
+                creatureIds[static_cast<size_t>(c)] = creatureIdFor(t, c);
+            }
+            std::array<uint8_t, kChannels> channels{};
+            auto &latencies = samples[static_cast<size_t>(t)];
+            latencies.reserve(kFramesPerThread);
+            for (size_t frame = 0; frame < kFramesPerThread; ++frame) {
+                channels.fill(static_cast<uint8_t>(frame));
+                const auto received = Clock::now();
+                path(streaming, creatureIds[frame % kCreaturesPerThread], channels);
+                latencies.push_back(std::chrono::duration<double, std::nano>(Clock::now() - received).count());
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    std::vector<double> all;
+    for (auto &latencies : samples) {
+        all.insert(all.end(), latencies.begin(), latencies.end());
+    }
+    std::sort(all.begin(), all.end());
+    return all;
+}
+
+void report(const char *label, int threadCount, std::vector<double> &sorted) {
+    std::printf("%-9s %d threads  p50 %6.0fns  p99 %7.0fns  p99.9 %8.0fns  max %9.0fns\n", label, threadCount,
+                percentile(sorted, 0.50), percentile(sorted, 0.99), percentile(sorted, 0.999),
+                percentile(sorted, 1.0));
+}
+
+} // namespace
+
+TEST(StreamingContextsBench, FastLaneVsFullPath) {
+    auto logger =
+        std::make_shared<spdlog::logger>("streaming-bench", std::make_shared<spdlog::sinks::null_sink_mt>());
+
+    std::printf("\n%zu channels a frame, %d creatures per websocket thread, %zu frames per thread\n", kChannels,
+                kCreaturesPerThread, kFramesPerThread);
+    for (int threadCount : {1, 4}) {
+        Streaming streaming(logger);
+        for (int t = 0; t < threadCount; ++t) {
+            for (int c = 0; c < kCreaturesPerThread; ++c) {
+                Creature creature;
+                creature.id = creatureIdFor(t, c);
+                creature.channel_offset = static_cast<uint16_t>(1 + (t * kCreaturesPerThread + c) * kChannels);
+                streaming.creatureCache.put(creature.id, creature);
+            }
+        }
+
+        // The long way first, which leaves every creature with a context for the fast lane
+        auto full = run(streaming, threadCount, fullPath);
+        auto fast = run(streaming, threadCount, fastLane);
+
+        report("full path", threadCount, full);
+        report("fast lane", threadCount, fast);
+
+        EXPECT_EQ(streaming.contexts.size(), static_cast<size_t>(threadCount * kCreaturesPerThread));
+    }
+}
+
+} // namespace creatures::ws
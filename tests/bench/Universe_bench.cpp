@@ -0,0 +1,173 @@
+/**
+ * Universe contention benchmark: seqlock vs. the old mutex-guarded array
+ *
+ * N writer threads write small fragments into one universe (the way playback
+ * runners write a creature's channels every frame) while a reader copies the
+ * whole universe at 50 Hz like the E1.31 worker does. Reports writer
+ * throughput flat-out, then writer stalls and reader copy time with each
+ * writer paced at the event loop's 1 ms frame.
+ *
+ * Not part of ctest. Build with -DCREATURE_SERVER_BUILD_BENCHMARKS=ON and run
+ * ./creature-server-bench --gtest_filter='UniverseBench.*'
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <spdlog/sinks/null_sink.h>
+#include <spdlog/spdlog.h>
+
+#include "Universe.h"
+
+namespace creatures::e131 {
+
+namespace {
+
+constexpr auto kRunTime = std::chrono::milliseconds(2000);
+constexpr auto kReaderPeriod = std::chrono::milliseconds(20);
+constexpr auto kWriterPeriod = std::chrono::milliseconds(1);
+constexpr size_t kFragmentSize = 16;
+constexpr int kFragmentsPerFrame = 16;
+
+/**
+ * What Universe used to be, kept here as the baseline
+ */
+class LegacyUniverse {
+  public:
+    void setFragment(uint16_t firstSlot, std::span<const uint8_t> values) {
+        std::lock_guard<std::mutex> lock(valuesMutex);
+        std::copy(values.begin(), values.end(), state.begin() + firstSlot);
+    }
+
+    void copyStateTo(std::span<uint8_t, UNIVERSE_SLOT_COUNT> out) const {
+        std::lock_guard<std::mutex> lock(valuesMutex);
+        std::copy(state.begin(), state.end(), out.begin());
+    }
+
+  private:
+    std::array<uint8_t, UNIVERSE_SLOT_COUNT> state{};
+    mutable std::mutex valuesMutex;
+};
+
+struct RunStats {
+    uint64_t writes = 0;
+    double seconds = 0.0;
+    std::vector<double> write_ns; // sampled writer latency
+    std::vector<double> read_ns;  // every reader copy
+};
+
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    const auto index = static_cast<size_t>(p * static_cast<double>(values.size() - 1));
+    return values[index];
+}
+
+template <typename U> RunStats runContention(U &universe, int writerCount, bool paced) {
+    using clock = std::chrono::steady_clock;
+
+    std::atomic<bool> stop{false};
+    std::vector<uint64_t> writes(static_cast<size_t>(writerCount), 0);
+    std::vector<std::vector<double>> writeSamples(static_cast<size_t>(writerCount));
+
+    std::vector<std::thread> writers;
+    for (int w = 0; w < writerCount; ++w) {
+        writers.emplace_back([&, w] {
+            std::array<uint8_t, kFragmentSize> values{};
+            const auto firstSlot =
+                static_cast<uint16_t>(1 + (w * kFragmentSize) % (UNIVERSE_SLOT_COUNT - kFragmentSize));
+            uint64_t count = 0;
+            auto &samples = writeSamples[static_cast<size_t>(w)];
+            auto next = clock::now();
+            while (!stop.load(std::memory_order_relaxed)) {
+                if (!paced) {
+                    values.fill(static_cast<uint8_t>(count++));
+                    universe.setFragment(firstSlot, values);
+                    continue;
+                }
+
+                // A frame's worth of writes, each one timed
+                next += kWriterPeriod;
+                std::this_thread::sleep_until(next);
+                for (int i = 0; i < kFragmentsPerFrame; ++i) {
+                    values.fill(static_cast<uint8_t>(count++));
+                    const auto start = clock::now();
+                    universe.setFragment(firstSlot, values);
+                    samples.push_back(std::chrono::duration<double, std::nano>(clock::now() - start).count());
+                }
+            }
+            writes[static_cast<size_t>(w)] = count;
+        });
+    }
+
+    RunStats stats;
+    std::array<uint8_t, UNIVERSE_SLOT_COUNT> state{};
+    const auto start = clock::now();
+    auto next = start;
+    while (clock::now() - start < kRunTime) {
+        next += kReaderPeriod;
+        std::this_thread::sleep_until(next);
+        const auto readStart = clock::now();
+        universe.copyStateTo(state);
+        stats.read_ns.push_back(std::chrono::duration<double, std::nano>(clock::now() - readStart).count());
+    }
+
+    stop.store(true);
+    for (auto &thread : writers) {
+        thread.join();
+    }
+    stats.seconds = std::chrono::duration<double>(clock::now() - start).count();
+
+    for (int w = 0; w < writerCount; ++w) {
+        stats.writes += writes[static_cast<size_t>(w)];
+        auto &samples = writeSamples[static_cast<size_t>(w)];
+        stats.write_ns.insert(stats.write_ns.end(), samples.begin(), samples.end());
+    }
+    return stats;
+}
+
+void report(const char *name, int writerCount, const RunStats &flatOut, const RunStats &paced) {
+    std::printf("%-8s %d writers %12.0f writes/s | paced write p50 %5.0fns p99 %6.0fns max %9.0fns | "
+                "50Hz read p50 %6.0fns p99 %8.0fns max %9.0fns\n",
+                name, writerCount, static_cast<double>(flatOut.writes) / flatOut.seconds,
+                percentile(paced.write_ns, 0.50), percentile(paced.write_ns, 0.99), percentile(paced.write_ns, 1.0),
+                percentile(paced.read_ns, 0.50), percentile(paced.read_ns, 0.99), percentile(paced.read_ns, 1.0));
+}
+
+} // namespace
+
+TEST(UniverseBench, WritersVsFiftyHertzReader) {
+    auto logger =
+        std::make_shared<spdlog::logger>("universe-bench", std::make_shared<spdlog::sinks::null_sink_mt>());
+
+    std::printf("\n%zu-byte fragments, %d per writer per %lldms frame when paced, reader every %lldms\n",
+                kFragmentSize, kFragmentsPerFrame, static_cast<long long>(kWriterPeriod.count()),
+                static_cast<long long>(kReaderPeriod.count()));
+    for (int writerCount : {1, 2, 4, 8}) {
+        LegacyUniverse legacy;
+        Universe seqlock(logger);
+
+        const auto legacyFlat = runContention(legacy, writerCount, false);
+        const auto seqlockFlat = runContention(seqlock, writerCount, false);
+        const auto legacyPaced = runContention(legacy, writerCount, true);
+        const auto seqlockPaced = runContention(seqlock, writerCount, true);
+
+        report("mutex", writerCount, legacyFlat, legacyPaced);
+        report("seqlock", writerCount, seqlockFlat, seqlockPaced);
+
+        EXPECT_GT(seqlockFlat.writes, 0U);
+    }
+}
+
+} // namespace creatures::e131
@@ -0,0 +1,100 @@
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#include <gtest/gtest.h>
+#include <spdlog/sinks/null_sink.h>
+#include <spdlog/spdlog.h>
+
+#include "SendOnChange.h"
+#include "Universe.h"
+
+namespace creatures::e131 {
+
+namespace {
+
+using namespace std::chrono_literals;
+
+constexpr auto kKeepAlive = std::chrono::milliseconds(E131_DEFAULT_KEEP_ALIVE_MS);
+
+std::shared_ptr<spdlog::logger> quietLogger() {
+    return std::make_shared<spdlog::logger>("send-on-change-test", std::make_shared<spdlog::sinks::null_sink_mt>());
+}
+
+// One pass of the worker: returns true if the frame went out
+bool tick(SendOnChange &changes, Universe &universe, std::array<uint8_t, UNIVERSE_SLOT_COUNT> &packet,
+          SendOnChange::Clock::time_point now) {
+    const auto version = universe.copyStateTo(packet);
+    if (changes.canSkip(version, packet, now, kKeepAlive)) {
+        return false;
+    }
+    changes.sent(now);
+    return true;
+}
+
+} // namespace
+
+TEST(SendOnChange, RepeatsThenHoldsBackUnchangedFrames) {
+    Universe universe(quietLogger());
+    SendOnChange changes;
+    std::array<uint8_t, UNIVERSE_SLOT_COUNT> packet{};
+    const std::array<uint8_t, 3> values{1, 2, 3};
+    universe.setFragment(10, values);
+
+    auto now = SendOnChange::Clock::time_point(1s);
+    EXPECT_TRUE(tick(changes, universe, packet, now));
+    for (int repeat = 0; repeat < E131_UNCHANGED_REPEATS; ++repeat) {
+        now += 20ms;
+        EXPECT_TRUE(tick(changes, universe, packet, now));
+    }
+    now += 20ms;
+    EXPECT_FALSE(tick(changes, universe, packet, now));
+}
+
+TEST(SendOnChange, IdenticalRewritesAreStillUnchanged) {
+    Universe universe(quietLogger());
+    SendOnChange changes;
+    std::array<uint8_t, UNIVERSE_SLOT_COUNT> packet{};
+    const std::array<uint8_t, 3> values{1, 2, 3};
+
+    auto now = SendOnChange::Clock::time_point(1s);
+    universe.setFragment(10, values);
+    EXPECT_TRUE(tick(changes, universe, packet, now));
+    for (int repeat = 0; repeat < E131_UNCHANGED_REPEATS; ++repeat) {
+        now += 20ms;
+        universe.setFragment(10, values);
+        EXPECT_TRUE(tick(changes, universe, packet, now));
+    }
+
+    // What playback does every tick: the version moves but the bytes don't
+    for (int frame = 0; frame < 10; ++frame) {
+        now += 20ms;
+        universe.setFragment(10, values);
+        EXPECT_FALSE(tick(changes, universe, packet, now));
+    }
+
+    // ...until they do
+    const std::array<uint8_t, 3> moved{1, 2, 4};
+    now += 20ms;
+    universe.setFragment(10, moved);
+    EXPECT_TRUE(tick(changes, universe, packet, now));
+}
+
+TEST(SendOnChange, SendsAKeepAliveWhenItsDue) {
+    Universe universe(quietLogger());
+    SendOnChange changes;
+    std::array<uint8_t, UNIVERSE_SLOT_COUNT> packet{};
+
+    auto now = SendOnChange::Clock::time_point(1s);
+    for (int frame = 0; frame <= E131_UNCHANGED_REPEATS; ++frame) {
+        EXPECT_TRUE(tick(changes, universe, packet, now));
+        now += 20ms;
+    }
+    EXPECT_FALSE(tick(changes, universe, packet, now));
+
+    now += kKeepAlive;
+    EXPECT_TRUE(tick(changes, universe, packet, now));
+    EXPECT_FALSE(tick(changes, universe, packet, now + 20ms));
+}
+
+} // namespace creatures::e131
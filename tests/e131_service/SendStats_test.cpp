@@ -0,0 +1,34 @@
+#include <gtest/gtest.h>
+
+#include "SendStats.h"
+
+namespace creatures::e131 {
+
+TEST(UniverseSendStats, SubMicrosecondSendsLandInTheFirstBucket) {
+    UniverseSendStats stats;
+    stats.recordSendTime(0);
+    EXPECT_EQ(stats.sendTimeHistogram[0], 1U);
+}
+
+TEST(UniverseSendStats, BucketsArePowersOfTwo) {
+    UniverseSendStats stats;
+    stats.recordSendTime(1);   // [1, 2)
+    stats.recordSendTime(3);   // [2, 4)
+    stats.recordSendTime(4);   // [4, 8)
+    stats.recordSendTime(7);   // [4, 8)
+    stats.recordSendTime(100); // [64, 128)
+
+    EXPECT_EQ(stats.sendTimeHistogram[1], 1U);
+    EXPECT_EQ(stats.sendTimeHistogram[2], 1U);
+    EXPECT_EQ(stats.sendTimeHistogram[3], 2U);
+    EXPECT_EQ(stats.sendTimeHistogram[7], 1U);
+}
+
+TEST(UniverseSendStats, SlowSendsPileIntoTheLastBucket) {
+    UniverseSendStats stats;
+    stats.recordSendTime(uint64_t{1} << 20);
+    stats.recordSendTime(UINT64_MAX);
+    EXPECT_EQ(stats.sendTimeHistogram[UniverseSendStats::SEND_TIME_BUCKETS - 1], 2U);
+}
+
+} // namespace creatures::e131
@@ -0,0 +1,301 @@
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <spdlog/sinks/null_sink.h>
+#include <spdlog/spdlog.h>
+
+#include "Universe.h"
+
+namespace creatures::e131 {
+
+namespace {
+
+std::shared_ptr<spdlog::logger> quietLogger() {
+    return std::make_shared<spdlog::logger>("universe-test", std::make_shared<spdlog::sinks::null_sink_mt>());
+}
+
+} // namespace
+
+TEST(Universe, StartsDark) {
+    Universe universe(quietLogger());
+    const auto state = universe.getState();
+    for (auto value : state) {
+        EXPECT_EQ(value, 0);
+    }
+}
+
+TEST(Universe, FragmentLandsAtItsSlots) {
+    Universe universe(quietLogger());
+
+    // Straddles a word boundary on purpose
+    const std::array<uint8_t, 5> values{10, 20, 30, 40, 50};
+    universe.setFragment(6, values);
+
+    const auto state = universe.getState();
+    EXPECT_EQ(state[5], 0);
+    EXPECT_EQ(state[6], 10);
+    EXPECT_EQ(state[7], 20);
+    EXPECT_EQ(state[8], 30);
+    EXPECT_EQ(state[9], 40);
+    EXPECT_EQ(state[10], 50);
+    EXPECT_EQ(state[11], 0);
+}
+
+TEST(Universe, LaterFragmentsOnlyTouchTheirOwnSlots) {
+    Universe universe(quietLogger());
+
+    const std::array<uint8_t, 3> first{1, 2, 3};
+    const std::array<uint8_t, 2> second{9, 9};
+    universe.setFragment(1, first);
+    universe.setFragment(3, second);
+
+    const auto state = universe.getState();
+    EXPECT_EQ(state[1], 1);
+    EXPECT_EQ(state[2], 2);
+    EXPECT_EQ(state[3], 9);
+    EXPECT_EQ(state[4], 9);
+    EXPECT_EQ(state[5], 0);
+}
+
+TEST(Universe, FillsToTheLastSlot) {
+    Universe universe(quietLogger());
+
+    std::vector<uint8_t> values(UNIVERSE_SLOT_COUNT - 1, 0xAB);
+    universe.setFragment(1, values);
+
+    const auto state = universe.getState();
+    EXPECT_EQ(state[0], 0);
+    EXPECT_EQ(state[1], 0xAB);
+    EXPECT_EQ(state[UNIVERSE_SLOT_COUNT - 1], 0xAB);
+}
+
+TEST(Universe, RejectsOutOfBoundsWrites) {
+    Universe universe(quietLogger());
+
+    const std::array<uint8_t, 2> values{7, 7};
+    universe.setFragment(0, values);
+    universe.setFragment(UNIVERSE_SLOT_COUNT - 1, values);
+
+    const auto state = universe.getState();
+    for (auto value : state) {
+        EXPECT_EQ(value, 0);
+    }
+}
+
+TEST(Universe, VersionOnlyMovesWhenSomethingIsWritten) {
+    Universe universe(quietLogger());
+    std::array<uint8_t, UNIVERSE_SLOT_COUNT> state{};
+
+    const auto first = universe.copyStateTo(state);
+    EXPECT_EQ(universe.copyStateTo(state), first);
+
+    const std::array<uint8_t, 1> values{42};
+    universe.setFragment(1, values);
+    const auto second = universe.copyStateTo(state);
+    EXPECT_NE(second, first);
+    EXPECT_EQ(universe.copyStateTo(state), second);
+
+    // Rejected writes don't count
+    universe.setFragment(0, values);
+    EXPECT_EQ(universe.copyStateTo(state), second);
+}
+
+TEST(UniverseMerge, HigherPriorityWinsWhicheverWritesLast) {
+    Universe universe(quietLogger());
+    const MergeSource low{1, 50};
+    const MergeSource high{2, 150};
+
+    const std::array<uint8_t, 2> highValues{10, 10};
+    const std::array<uint8_t, 2> lowValues{200, 200};
+    universe.setFragment(high, 1, highValues);
+    universe.setFragment(low, 1, lowValues);
+
+    const auto state = universe.getState();
+    EXPECT_EQ(state[1], 10);
+    EXPECT_EQ(state[2], 10);
+}
+
+TEST(UniverseMerge, LowerPriorityOnlyShowsWhereTheHigherOneIsntDriving) {
+    Universe universe(quietLogger());
+    const MergeSource low{1, 50};
+    const MergeSource high{2, 150};
+
+    const std::array<uint8_t, 4> lowValues{1, 2, 3, 4};
+    const std::array<uint8_t, 2> highValues{90, 91};
+    universe.setFragment(low, 1, lowValues);
+    universe.setFragment(high, 2, highValues);
+
+    const auto state = universe.getState();
+    EXPECT_EQ(state[1], 1);
+    EXPECT_EQ(state[2], 90);
+    EXPECT_EQ(state[3], 91);
+    EXPECT_EQ(state[4], 4);
+}
+
+TEST(UniverseMerge, ReleasingRevealsTheSourceUnderneath) {
+    Universe universe(quietLogger());
+    const MergeSource low{1, 50};
+    const MergeSource high{2, 150};
+
+    const std::array<uint8_t, 2> lowValues{33, 44};
+    const std::array<uint8_t, 2> highValues{99, 99};
+    universe.setFragment(low, 1, lowValues);
+    universe.setFragment(high, 1, highValues);
+    universe.releaseSlots(high, 1, 2);
+
+    auto state = universe.getState();
+    EXPECT_EQ(state[1], 33);
+    EXPECT_EQ(state[2], 44);
+
+    // And with nobody left, the slots go dark
+    universe.releaseSlots(low, 1, 1);
+    state = universe.getState();
+    EXPECT_EQ(state[1], 0);
+    EXPECT_EQ(state[2], 44);
+}
+
+TEST(UniverseMerge, APatternShowsThroughAgainWhenPlaybackEnds) {
+    Universe universe(quietLogger());
+    const MergeSource playback{1, 100};
+    const MergeSource pattern{2, 50};
+    const MergeSource hold{4, 0};
+
+    const std::array<uint8_t, 2> patternValues{10, 20};
+    const std::array<uint8_t, 2> playbackValues{200, 201};
+    universe.setFragment(pattern, 1, patternValues);
+    universe.setFragment(playback, 1, playbackValues);
+    EXPECT_EQ(universe.getState()[1], 200);
+
+    universe.handOffSlots(playback, hold, 1, 2);
+    auto state = universe.getState();
+    EXPECT_EQ(state[1], 10);
+    EXPECT_EQ(state[2], 20);
+
+    // The pattern keeps going, and playback doesn't come back
+    const std::array<uint8_t, 2> nextPatternValues{11, 21};
+    universe.setFragment(pattern, 1, nextPatternValues);
+    state = universe.getState();
+    EXPECT_EQ(state[1], 11);
+    EXPECT_EQ(state[2], 21);
+}
+
+TEST(UniverseMerge, HandedOffSlotsStayPutWithNothingUnderneath) {
+    Universe universe(quietLogger());
+    const MergeSource playback{1, 100};
+    const MergeSource hold{4, 0};
+
+    const std::array<uint8_t, 3> playbackValues{77, 88, 99};
+    universe.setFragment(playback, 5, playbackValues);
+
+    // Only the slots playback was driving move, and none of them go dark
+    universe.handOffSlots(playback, hold, 4, 4);
+    auto state = universe.getState();
+    EXPECT_EQ(state[4], 0);
+    EXPECT_EQ(state[5], 77);
+    EXPECT_EQ(state[6], 88);
+    EXPECT_EQ(state[7], 99);
+
+    // The next playback takes them straight back
+    const std::array<uint8_t, 1> nextValue{5};
+    universe.setFragment(playback, 6, nextValue);
+    EXPECT_EQ(universe.getState()[6], 5);
+
+    // Releasing the hold is what finally lets them go
+    universe.releaseSlots(hold, 5, 1);
+    EXPECT_EQ(universe.getState()[5], 0);
+}
+
+TEST(UniverseMerge, LtpTieGoesToTheLatestWrite) {
+    Universe universe(quietLogger());
+    const MergeSource a{1, 100};
+    const MergeSource b{2, 100};
+
+    const std::array<uint8_t, 1> big{200};
+    const std::array<uint8_t, 1> small{20};
+    universe.setFragment(a, 1, big);
+    universe.setFragment(b, 1, small);
+    EXPECT_EQ(universe.getState()[1], 20);
+
+    universe.setFragment(a, 1, big);
+    EXPECT_EQ(universe.getState()[1], 200);
+}
+
+TEST(UniverseMerge, HtpTieGoesToTheBiggestValue) {
+    Universe universe(quietLogger());
+    universe.setMergeMode(MergeMode::HighestTakesPrecedence);
+    const MergeSource a{1, 100};
+    const MergeSource b{2, 100};
+
+    const std::array<uint8_t, 1> big{200};
+    const std::array<uint8_t, 1> small{20};
+    universe.setFragment(a, 1, big);
+    universe.setFragment(b, 1, small);
+    EXPECT_EQ(universe.getState()[1], 200);
+
+    universe.releaseSlots(a, 1, 1);
+    EXPECT_EQ(universe.getState()[1], 20);
+}
+
+TEST(UniverseMerge, ChangingModeReMergesWhatsAlreadyThere) {
+    Universe universe(quietLogger());
+    const MergeSource a{1, 100};
+    const MergeSource b{2, 100};
+
+    const std::array<uint8_t, 1> big{200};
+    const std::array<uint8_t, 1> small{20};
+    universe.setFragment(a, 1, big);
+    universe.setFragment(b, 1, small);
+    EXPECT_EQ(universe.getState()[1], 20);
+
+    universe.setMergeMode(MergeMode::HighestTakesPrecedence);
+    EXPECT_EQ(universe.getState()[1], 200);
+}
+
+TEST(Universe, OutputRateIsClamped) {
+    Universe universe(quietLogger());
+    EXPECT_EQ(universe.getOutputRate(), UNIVERSE_DEFAULT_OUTPUT_RATE_HZ);
+
+    universe.setOutputRate(0);
+    EXPECT_EQ(universe.getOutputRate(), 1U);
+
+    universe.setOutputRate(1000000);
+    EXPECT_EQ(universe.getOutputRate(), UNIVERSE_MAX_OUTPUT_RATE_HZ);
+}
+
+TEST(Universe, ReaderNeverSeesATornWrite) {
+    Universe universe(quietLogger());
+
+    // The writer fills the whole universe with one value at a time, so any
+    // snapshot with two different values in it came from a torn read.
+    std::atomic<bool> stop{false};
+    std::thread writer([&] {
+        std::vector<uint8_t> values(UNIVERSE_SLOT_COUNT - 1);
+        uint8_t fill = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            std::fill(values.begin(), values.end(), ++fill);
+            universe.setFragment(1, values);
+        }
+    });
+
+    std::array<uint8_t, UNIVERSE_SLOT_COUNT> state{};
+    int torn = 0;
+    for (int i = 0; i < 20000; ++i) {
+        universe.copyStateTo(state);
+        for (size_t slot = 2; slot < state.size(); ++slot) {
+            if (state[slot] != state[1]) {
+                ++torn;
+                break;
+            }
+        }
+    }
+
+    stop.store(true);
+    writer.join();
+    EXPECT_EQ(torn, 0);
+}
+
+} // namespace creatures::e131
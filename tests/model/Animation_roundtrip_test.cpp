@@ -48,7 +48,7 @@ Track makeCreatureTrack(const std::string &animationId) {
     track.id = "aaaaaaaa-1111-4222-8333-444455556666";
     track.creature_id = "bbbbbbbb-1111-4222-8333-444455556666";
     track.animation_id = animationId;
-    track.frames = {"ZnJhbWUx", "ZnJhbWUy"};
+    track.frames = PackedFrames::fromBase64Frames({"ZnJhbWUx", "ZnJhbWUy"}).getValue().value();
     return track;
 }
 
@@ -57,7 +57,7 @@ Track makeFixtureTrack(const std::string &animationId) {
     track.id = "cccccccc-1111-4222-8333-444455556666";
     track.fixture_id = "dddddddd-1111-4222-8333-444455556666";
     track.animation_id = animationId;
-    track.frames = {"ZnJhbWUx", "ZnJhbWUy"};
+    track.frames = PackedFrames::fromBase64Frames({"ZnJhbWUx", "ZnJhbWUy"}).getValue().value();
     return track;
 }
 
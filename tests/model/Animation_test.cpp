@@ -19,11 +19,38 @@ class AnimationTest : public ::testing::Test {
                            .creature_id = "creature456",
                            .fixture_id = "",
                            .animation_id = "anim123",
-                           .frames = {"base64encodedframe1", "base64encodedframe2"}};
+                           .frames = PackedFrames::fromBase64Frames({"ZnJhbWUx", "ZnJhbWUy"}).getValue().value()};
         animation.tracks.push_back(trackData);
     }
 };
 
+TEST_F(AnimationTest, DtoRoundTripKeepsTheFrames) {
+    const auto back = convertFromDto(convertToDto(animation));
+
+    ASSERT_TRUE(back.isSuccess()) << back.getError()->getMessage();
+    ASSERT_EQ(back.getValue()->tracks.size(), 1u);
+    EXPECT_EQ(back.getValue()->tracks[0].frames, animation.tracks[0].frames);
+}
+
+TEST_F(AnimationTest, CorruptFrameInATrackDtoIsAnError) {
+    auto trackDto = convertToDto(animation.tracks[0]);
+    trackDto->frames->back() = "ZnJh*WUx";
+
+    const auto track = convertFromDto(trackDto.getPtr());
+    ASSERT_FALSE(track.isSuccess());
+    EXPECT_EQ(track.getError()->getCode(), ServerError::InvalidData);
+}
+
+TEST_F(AnimationTest, CorruptFrameFailsTheWholeAnimation) {
+    auto animationDto = convertToDto(animation);
+    animationDto->tracks[0]->frames->front() = "ZnJh*WUx";
+
+    // Rather than loading with an empty track that plays nothing
+    const auto back = convertFromDto(animationDto);
+    ASSERT_FALSE(back.isSuccess());
+    EXPECT_EQ(back.getError()->getCode(), ServerError::InvalidData);
+}
+
 //    TEST_F(AnimationTest, Serialization) {
 //        nlohmann::json j = animation;
 //        ASSERT_EQ(j["id"], animation.id);
@@ -0,0 +1,115 @@
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include "model/Animation.h"
+#include "model/PackedFrames.h"
+#include "server/database.h"
+
+namespace creatures {
+
+namespace {
+
+PackedFrames framesOf(const std::vector<std::vector<uint8_t>> &frames) {
+    PackedFrames packed;
+    for (const auto &frame : frames) {
+        packed.push_back(frame);
+    }
+    return packed;
+}
+
+nlohmann::json trackJsonWith(const PackedFrames &frames) {
+    nlohmann::json j{{"id", "track-1"}, {"animation_id", "anim-1"}, {"creature_id", "creature-1"}};
+    storeTrackFrames(j, frames);
+    return j;
+}
+
+} // namespace
+
+TEST(PackedFramesTest, PacksFramesBackToBack) {
+    const auto frames = framesOf({{1, 2, 3}, {4, 5, 6}});
+
+    EXPECT_EQ(frames.size(), 2u);
+    EXPECT_EQ(frames.width(), 3u);
+    EXPECT_EQ(std::vector<uint8_t>(frames.data().begin(), frames.data().end()),
+              (std::vector<uint8_t>{1, 2, 3, 4, 5, 6}));
+    EXPECT_EQ(frames[1][0], 4);
+    EXPECT_EQ(frames.back()[2], 6);
+}
+
+TEST(PackedFramesTest, RejectsFramesOfADifferentWidth) {
+    auto frames = framesOf({{1, 2, 3}});
+    EXPECT_THROW(frames.push_back(std::vector<uint8_t>{1, 2}), std::invalid_argument);
+
+    auto decoded = PackedFrames::fromBase64Frames({"AQID", "AQI="});
+    EXPECT_FALSE(decoded.isSuccess());
+}
+
+TEST(PackedFramesTest, Base64RoundTrips) {
+    auto decoded = PackedFrames::fromBase64Frames({"ZnJhbWUx", "ZnJhbWUy"});
+    ASSERT_TRUE(decoded.isSuccess());
+    const auto frames = decoded.getValue().value();
+
+    EXPECT_EQ(frames.size(), 2u);
+    EXPECT_EQ(frames.width(), 6u);
+    EXPECT_EQ(frames.toBase64Frames(), (std::vector<std::string>{"ZnJhbWUx", "ZnJhbWUy"}));
+}
+
+TEST(PackedFramesTest, CopiesShareUntilWritten) {
+    const auto original = framesOf({{1, 2}, {3, 4}});
+    auto copy = original;
+    EXPECT_EQ(copy.data().data(), original.data().data());
+
+    copy.mutableFrame(1)[0] = 99;
+    EXPECT_NE(copy.data().data(), original.data().data());
+    EXPECT_EQ(original[1][0], 3);
+    EXPECT_EQ(copy[1][0], 99);
+}
+
+TEST(PackedFramesTest, FromBytesChecksTheLength) {
+    EXPECT_TRUE(PackedFrames::fromBytes(2, 3, std::vector<uint8_t>(6)).isSuccess());
+    EXPECT_FALSE(PackedFrames::fromBytes(2, 3, std::vector<uint8_t>(5)).isSuccess());
+}
+
+TEST(PackedFramesTest, StoredFramesParseBack) {
+    const auto frames = framesOf({{1, 2, 3}, {4, 5, 6}, {7, 8, 9}});
+    auto j = trackJsonWith(frames);
+
+    ASSERT_TRUE(j["frames"].contains("$binary"));
+    auto result = Database::parseTrackJson(j);
+    ASSERT_TRUE(result.isSuccess()) << (result.getError() ? result.getError()->getMessage() : "parse failed");
+    EXPECT_EQ(result.getValue()->frames, frames);
+}
+
+TEST(PackedFramesTest, LegacyExtendedJsonBinaryParses) {
+    // What bsoncxx::to_json hands back in its default (legacy) mode
+    const auto frames = framesOf({{1, 2, 3}, {4, 5, 6}});
+    auto j = trackJsonWith(frames);
+    j["frames"] = {{"$binary", j["frames"]["$binary"]["base64"]}, {"$type", "00"}};
+
+    auto result = Database::parseTrackJson(j);
+    ASSERT_TRUE(result.isSuccess()) << (result.getError() ? result.getError()->getMessage() : "parse failed");
+    EXPECT_EQ(result.getValue()->frames, frames);
+}
+
+TEST(PackedFramesTest, StoredFramesMustMatchTheirShape) {
+    auto j = trackJsonWith(framesOf({{1, 2, 3}, {4, 5, 6}}));
+    j["frame_count"] = 3;
+
+    EXPECT_FALSE(Database::parseTrackJson(j).isSuccess());
+}
+
+TEST(PackedFramesTest, CorruptStoredFramesAreAnError) {
+    auto j = trackJsonWith(framesOf({{1, 2, 3}, {4, 5, 6}}));
+    j["frames"]["$binary"]["base64"] = "ZnJh*WUx";
+
+    const auto result = Database::parseTrackJson(j);
+    ASSERT_FALSE(result.isSuccess());
+    EXPECT_EQ(result.getError()->getCode(), ServerError::InvalidData);
+}
+
+} // namespace creatures
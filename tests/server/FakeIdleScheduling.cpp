@@ -8,12 +8,25 @@
 namespace creatures {
 
 framenum_t EventLoop::getNextFrameNumber() const { return 0; }
+bool EventLoop::onLoopThread() { return false; }
 
 // Stubs to satisfy the linker for tests that include FixturePatternRunner.cpp.
 // Never invoked by the live-control unit tests (which only call setLive()/hasLive());
 // the symbols just need to resolve because the runner's other methods reference them.
 void EventLoop::scheduleEvent(const std::shared_ptr<Event> & /*e*/) {}
 Result<framenum_t> DMXEvent::executeImpl() { return Result<framenum_t>{0}; }
+bool DMXEvent::writeSlots(DmxSource /*source*/, universe_t /*universe*/, uint32_t /*channelOffset*/,
+                          std::span<const uint8_t> /*data*/) {
+    return true;
+}
+bool DMXEvent::releaseSlots(DmxSource /*source*/, universe_t /*universe*/, uint32_t /*channelOffset*/,
+                            uint16_t /*count*/) {
+    return true;
+}
+bool DMXEvent::handOffSlots(DmxSource /*source*/, universe_t /*universe*/, uint32_t /*channelOffset*/,
+                            uint16_t /*count*/) {
+    return true;
+}
 
 Result<framenum_t> scheduleAnimation(framenum_t /*startingFrame*/, const Animation & /*animation*/,
                                      universe_t /*universe*/, creatures::runtime::ActivityReason /*reason*/) {
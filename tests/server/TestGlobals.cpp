@@ -8,7 +8,9 @@ std::shared_ptr<Database> db;
 std::shared_ptr<ObservabilityManager> observability;
 std::shared_ptr<ObjectCache<creatureId_t, Creature>> creatureCache;
 std::shared_ptr<ObjectCache<creatureId_t, universe_t>> creatureUniverseMap;
-std::shared_ptr<moodycamel::BlockingConcurrentQueue<std::string>> websocketOutgoingMessages;
+std::shared_ptr<AnimationCache> animationCache;
+std::shared_ptr<PlaylistPrefetcher> playlistPrefetcher;
+std::shared_ptr<moodycamel::BlockingConcurrentQueue<ws::OutgoingMessage>> websocketOutgoingMessages;
 std::shared_ptr<SystemCounters> metrics;
 std::shared_ptr<EventLoop> eventLoop;
 std::shared_ptr<SessionManager> sessionManager;
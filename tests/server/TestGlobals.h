@@ -5,6 +5,7 @@
 
 #include "blockingconcurrentqueue.h"
 #include "model/Creature.h"
+#include "server/ws/websocket/OutgoingMessage.h"
 #include "util/cache.h"
 
 namespace creatures {
@@ -14,6 +15,8 @@ class EventLoop;
 class SessionManager;
 class Configuration;
 class SystemCounters;
+class AnimationCache;
+class PlaylistPrefetcher;
 } // namespace creatures
 
 namespace creatures {
@@ -22,7 +25,9 @@ extern std::shared_ptr<Database> db;
 extern std::shared_ptr<ObservabilityManager> observability;
 extern std::shared_ptr<ObjectCache<creatureId_t, Creature>> creatureCache;
 extern std::shared_ptr<ObjectCache<creatureId_t, universe_t>> creatureUniverseMap;
-extern std::shared_ptr<moodycamel::BlockingConcurrentQueue<std::string>> websocketOutgoingMessages;
+extern std::shared_ptr<AnimationCache> animationCache;
+extern std::shared_ptr<PlaylistPrefetcher> playlistPrefetcher;
+extern std::shared_ptr<moodycamel::BlockingConcurrentQueue<ws::OutgoingMessage>> websocketOutgoingMessages;
 extern std::shared_ptr<SystemCounters> metrics;
 extern std::shared_ptr<EventLoop> eventLoop;
 extern std::shared_ptr<SessionManager> sessionManager;
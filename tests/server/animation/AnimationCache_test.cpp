@@ -0,0 +1,111 @@
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "server/animation/AnimationCache.h"
+
+namespace creatures {
+
+namespace {
+
+// One track of `frameCount` frames, 100 bytes each
+std::shared_ptr<const Animation> animationOf(const std::string &id, std::size_t frameCount) {
+    auto animation = std::make_shared<Animation>();
+    animation->id = id;
+    Track track;
+    track.id = id + "-track";
+    std::vector<uint8_t> frame(100);
+    for (std::size_t i = 0; i < frameCount; ++i) {
+        track.frames.push_back(frame);
+    }
+    animation->tracks.push_back(std::move(track));
+    return animation;
+}
+
+} // namespace
+
+TEST(AnimationCache, HitsShareTheCachedFrames) {
+    AnimationCache cache(1024 * 1024);
+    const auto animation = animationOf("a", 10);
+    ASSERT_TRUE(cache.put(animation, cache.generation()));
+
+    const auto hit = cache.get("a");
+    ASSERT_NE(hit, nullptr);
+    EXPECT_EQ(hit->tracks[0].frames.data().data(), animation->tracks[0].frames.data().data());
+
+    // A copy (what Database::getAnimation hands out) still shares them
+    const Animation copy = *hit;
+    EXPECT_EQ(copy.tracks[0].frames.data().data(), animation->tracks[0].frames.data().data());
+
+    EXPECT_EQ(cache.get("b"), nullptr);
+    EXPECT_EQ(cache.hits(), 1u);
+    EXPECT_EQ(cache.misses(), 1u);
+}
+
+TEST(AnimationCache, EvictsTheLeastRecentlyUsed) {
+    const auto entryBytes = AnimationCache::footprint(*animationOf("x", 10));
+    AnimationCache cache(entryBytes * 2);
+
+    ASSERT_TRUE(cache.put(animationOf("a", 10), cache.generation()));
+    ASSERT_TRUE(cache.put(animationOf("b", 10), cache.generation()));
+    ASSERT_NE(cache.get("a"), nullptr); // a is now newer than b
+
+    ASSERT_TRUE(cache.put(animationOf("c", 10), cache.generation()));
+    EXPECT_NE(cache.get("a"), nullptr);
+    EXPECT_EQ(cache.get("b"), nullptr);
+    EXPECT_NE(cache.get("c"), nullptr);
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_LE(cache.bytes(), entryBytes * 2);
+}
+
+TEST(AnimationCache, SkipsAnimationsBiggerThanTheWholeCache) {
+    AnimationCache cache(500);
+    EXPECT_FALSE(cache.put(animationOf("big", 10), cache.generation()));
+    EXPECT_EQ(cache.size(), 0u);
+
+    AnimationCache off(0);
+    EXPECT_FALSE(off.put(animationOf("a", 1), off.generation()));
+}
+
+TEST(AnimationCache, EvictedAnimationsStayAliveForWhoeverHasThem) {
+    const auto entryBytes = AnimationCache::footprint(*animationOf("x", 10));
+    AnimationCache cache(entryBytes);
+
+    ASSERT_TRUE(cache.put(animationOf("a", 10), cache.generation()));
+    const auto playing = cache.get("a");
+    ASSERT_TRUE(cache.put(animationOf("b", 10), cache.generation()));
+
+    EXPECT_EQ(cache.get("a"), nullptr);
+    ASSERT_NE(playing, nullptr);
+    EXPECT_EQ(playing->tracks[0].frames.size(), 10u);
+}
+
+TEST(AnimationCache, InvalidateDropsTheEntry) {
+    AnimationCache cache(1024 * 1024);
+    ASSERT_TRUE(cache.put(animationOf("a", 1), cache.generation()));
+    ASSERT_TRUE(cache.put(animationOf("b", 1), cache.generation()));
+
+    cache.invalidate("a");
+    EXPECT_EQ(cache.get("a"), nullptr);
+    EXPECT_NE(cache.get("b"), nullptr);
+
+    cache.invalidateAll();
+    EXPECT_EQ(cache.get("b"), nullptr);
+    EXPECT_EQ(cache.bytes(), 0u);
+}
+
+TEST(AnimationCache, LoadsThatRaceAnInvalidationArentKept) {
+    AnimationCache cache(1024 * 1024);
+
+    const auto generation = cache.generation();
+    // ...the load is off talking to Mongo when someone saves the animation
+    cache.invalidate("a");
+
+    EXPECT_FALSE(cache.put(animationOf("a", 1), generation));
+    EXPECT_EQ(cache.get("a"), nullptr);
+}
+
+} // namespace creatures
@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+
+#include "server/animation/DmxFootprint.h"
+
+namespace creatures {
+
+namespace {
+
+TEST(DmxFootprints, KeepsTheWidestFrameForEachTrack) {
+    DmxFootprints footprints;
+    footprints.note(0, 1, 10, 8);
+    footprints.note(1, 1, 40, 4);
+    footprints.note(0, 1, 10, 12);
+    footprints.note(0, 1, 10, 6);
+
+    EXPECT_EQ(footprints.all(), (std::vector<DmxFootprint>{{1, 10, 12}, {1, 40, 4}}));
+}
+
+TEST(DmxFootprints, RemembersWhereAMovedTrackWasWriting) {
+    DmxFootprints footprints;
+    footprints.note(0, 1, 10, 8);
+
+    // The creature was re-patched mid-playback
+    footprints.note(0, 2, 10, 8);
+    footprints.note(0, 2, 20, 8);
+
+    EXPECT_EQ(footprints.all(), (std::vector<DmxFootprint>{{1, 10, 8}, {2, 10, 8}, {2, 20, 8}}));
+}
+
+TEST(DmxFootprints, MergesTracksOnTheSameChannels) {
+    DmxFootprints footprints;
+    footprints.note(3, 1, 10, 4);
+    footprints.note(0, 1, 10, 8);
+
+    EXPECT_EQ(footprints.all(), (std::vector<DmxFootprint>{{1, 10, 8}}));
+}
+
+} // namespace
+
+} // namespace creatures
@@ -0,0 +1,36 @@
+#include <gtest/gtest.h>
+
+#include "server/animation/PlaybackCacheLookups.h"
+
+namespace creatures {
+
+namespace {
+
+TEST(PlaybackCacheLookups, OnlyOneLookupAtATime) {
+    PlaybackCacheLookups lookups;
+
+    EXPECT_TRUE(lookups.begin());
+    EXPECT_FALSE(lookups.begin());
+
+    lookups.finish({});
+    EXPECT_TRUE(lookups.begin());
+}
+
+TEST(PlaybackCacheLookups, RemembersWhatTheDatabaseDidntHave) {
+    PlaybackCacheLookups lookups;
+    EXPECT_FALSE(lookups.isNotFound("beaky"));
+
+    ASSERT_TRUE(lookups.begin());
+    lookups.finish({"beaky"});
+    EXPECT_TRUE(lookups.isNotFound("beaky"));
+    EXPECT_FALSE(lookups.isNotFound("mango"));
+
+    // A later lookup that finds everything else doesn't forget it
+    ASSERT_TRUE(lookups.begin());
+    lookups.finish({});
+    EXPECT_TRUE(lookups.isNotFound("beaky"));
+}
+
+} // namespace
+
+} // namespace creatures
@@ -0,0 +1,157 @@
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "server/animation/PlaylistPrefetcher.h"
+
+namespace creatures {
+
+namespace {
+
+// Counts loads and names the item after the playlist it came from
+struct CountingLoader {
+    std::atomic<int> calls{0};
+
+    PlaylistPrefetcher::Loader loader() {
+        return [this](const playlistId_t &playlistId) {
+            calls++;
+            PlaylistPrefetcher::Item item;
+            item.playlist.id = playlistId;
+            item.animationId = playlistId + "-animation";
+            return Result<PlaylistPrefetcher::Item>{item};
+        };
+    }
+};
+
+// take() until something shows up (or give up after a few seconds)
+std::optional<Result<PlaylistPrefetcher::Item>> waitFor(PlaylistPrefetcher &prefetcher, universe_t universe,
+                                                        const playlistId_t &playlistId) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (auto item = prefetcher.take(universe, playlistId)) {
+            return item;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return std::nullopt;
+}
+
+} // namespace
+
+TEST(PlaylistPrefetcher, TakeNeverWaitsForTheLoad) {
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    PlaylistPrefetcher prefetcher(1, [released](const playlistId_t &playlistId) {
+        released.wait();
+        PlaylistPrefetcher::Item item;
+        item.animationId = playlistId + "-animation";
+        return Result<PlaylistPrefetcher::Item>{item};
+    });
+
+    EXPECT_FALSE(prefetcher.take(1, "p").has_value());
+    EXPECT_FALSE(prefetcher.take(1, "p").has_value());
+
+    release.set_value();
+    const auto item = waitFor(prefetcher, 1, "p");
+    ASSERT_TRUE(item.has_value());
+    ASSERT_TRUE(item->isSuccess());
+    EXPECT_EQ(item->getValue()->animationId, "p-animation");
+
+    // Taken, so the next take starts the one after it
+    EXPECT_FALSE(prefetcher.take(1, "p").has_value());
+}
+
+TEST(PlaylistPrefetcher, LoadsOneItemAheadPerUniverse) {
+    CountingLoader counting;
+    PlaylistPrefetcher prefetcher(2, counting.loader());
+
+    prefetcher.request(1, "p");
+    prefetcher.request(1, "p");
+    prefetcher.request(2, "q");
+    ASSERT_TRUE(waitFor(prefetcher, 1, "p").has_value());
+    ASSERT_TRUE(waitFor(prefetcher, 2, "q").has_value());
+    EXPECT_EQ(counting.calls.load(), 2);
+}
+
+TEST(PlaylistPrefetcher, ItemsForAnotherPlaylistArentHandedOut) {
+    CountingLoader counting;
+    PlaylistPrefetcher prefetcher(1, counting.loader());
+
+    prefetcher.request(1, "old");
+    const auto item = waitFor(prefetcher, 1, "new");
+    ASSERT_TRUE(item.has_value());
+    EXPECT_EQ(item->getValue()->playlist.id, "new");
+}
+
+TEST(PlaylistPrefetcher, InvalidateAllStartsOver) {
+    CountingLoader counting;
+    PlaylistPrefetcher prefetcher(1, counting.loader());
+
+    prefetcher.request(1, "p");
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (counting.calls.load() == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    prefetcher.invalidateAll();
+    ASSERT_TRUE(waitFor(prefetcher, 1, "p").has_value());
+    EXPECT_EQ(counting.calls.load(), 2);
+}
+
+TEST(PlaylistPrefetcher, LoaderExceptionsComeBackAsErrors) {
+    PlaylistPrefetcher prefetcher(1, [](const playlistId_t &) -> Result<PlaylistPrefetcher::Item> {
+        throw std::runtime_error("mongo went away");
+    });
+
+    const auto item = waitFor(prefetcher, 1, "p");
+    ASSERT_TRUE(item.has_value());
+    ASSERT_FALSE(item->isSuccess());
+    EXPECT_NE(item->getError()->getMessage().find("mongo went away"), std::string::npos);
+}
+
+TEST(PlaylistPrefetcher, BackgroundTasksRunOncePerKey) {
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    std::atomic<int> runs{0};
+    CountingLoader counting;
+    PlaylistPrefetcher prefetcher(1, counting.loader());
+
+    auto task = [&runs, released] {
+        released.wait();
+        runs++;
+    };
+    EXPECT_TRUE(prefetcher.runInBackground("creature:beaky", task));
+
+    // Asking again every frame while it's still going doesn't pile up loads
+    EXPECT_FALSE(prefetcher.runInBackground("creature:beaky", task));
+    EXPECT_FALSE(prefetcher.runInBackground("creature:beaky", task));
+
+    release.set_value();
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!prefetcher.runInBackground("creature:beaky", task) && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    while (runs.load() < 2 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(runs.load(), 2);
+}
+
+TEST(PlaylistPrefetcher, ABackgroundTaskThatThrowsDoesntStopTheWorker) {
+    CountingLoader counting;
+    PlaylistPrefetcher prefetcher(1, counting.loader());
+
+    EXPECT_TRUE(prefetcher.runInBackground("idle:beaky", [] { throw std::runtime_error("mongo went away"); }));
+
+    // Both the same worker, so the load only happens if the worker survived
+    ASSERT_TRUE(waitFor(prefetcher, 1, "p").has_value());
+    EXPECT_EQ(counting.calls.load(), 1);
+}
+
+} // namespace creatures
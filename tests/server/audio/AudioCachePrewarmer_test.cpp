@@ -0,0 +1,188 @@
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#include <gtest/gtest.h>
+
+#include "server/audio/AudioCachePrewarmer.h"
+
+namespace creatures::audio {
+
+namespace {
+
+using Stats = AudioCachePrewarmer::Stats;
+using Pool = std::shared_ptr<util::ComputePool>;
+
+AudioCachePrewarmer::Lister listing(std::vector<std::string> sounds) {
+    return [sounds] { return Result<std::vector<std::string>>{sounds}; };
+}
+
+// Wait (a few seconds at most) for the stats to get somewhere
+bool waitFor(const AudioCachePrewarmer &prewarmer, const std::function<bool(const Stats &)> &done) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (done(prewarmer.getStats())) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+} // namespace
+
+TEST(AudioCachePrewarmer, WarmsEachSoundOnceInOrder) {
+    std::mutex warmedMutex;
+    std::vector<std::string> warmed;
+    AudioCachePrewarmer prewarmer({}, listing({"a.wav", "b.wav", "a.wav", ""}),
+                                  [&](const std::string &sound, const std::atomic<bool> &, const Pool &) {
+                                      std::lock_guard lock(warmedMutex);
+                                      warmed.push_back(sound);
+                                      return Result<bool>{true};
+                                  });
+
+    // Nothing happens until somebody asks
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(prewarmer.getStats().checked, 0u);
+
+    prewarmer.requestScan();
+    ASSERT_TRUE(waitFor(prewarmer, [](const Stats &stats) { return stats.scans == 1; }));
+
+    std::lock_guard lock(warmedMutex);
+    EXPECT_EQ(warmed, (std::vector<std::string>{"a.wav", "b.wav"}));
+}
+
+TEST(AudioCachePrewarmer, CountsWhatItDid) {
+    std::vector<Stats> published;
+    std::mutex publishedMutex;
+    AudioCachePrewarmer prewarmer(
+        {}, listing({"cached.wav", "new.wav", "broken.wav", "throws.wav"}),
+        [](const std::string &sound, const std::atomic<bool> &, const Pool &) -> Result<bool> {
+            if (sound == "broken.wav") {
+                return Result<bool>{ServerError(ServerError::InvalidData, "not a WAV")};
+            }
+            if (sound == "throws.wav") {
+                throw std::runtime_error("disk went away");
+            }
+            return Result<bool>{sound == "new.wav"};
+        },
+        [&](const Stats &stats) {
+            std::lock_guard lock(publishedMutex);
+            published.push_back(stats);
+        });
+
+    prewarmer.requestScan();
+    ASSERT_TRUE(waitFor(prewarmer, [](const Stats &stats) { return stats.scans == 1; }));
+
+    const auto stats = prewarmer.getStats();
+    EXPECT_EQ(stats.checked, 4u);
+    EXPECT_EQ(stats.encoded, 1u);
+    EXPECT_EQ(stats.failed, 2u);
+    EXPECT_EQ(stats.pending, 0u);
+
+    std::lock_guard lock(publishedMutex);
+    ASSERT_FALSE(published.empty());
+    EXPECT_EQ(published.front().pending, 4u);
+}
+
+TEST(AudioCachePrewarmer, AskingAgainStartsTheScanOver) {
+    std::atomic<int> listings{0};
+    std::promise<void> firstStarted;
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    std::atomic<int> warms{0};
+
+    AudioCachePrewarmer prewarmer(
+        {},
+        [&] {
+            listings++;
+            return Result<std::vector<std::string>>{std::vector<std::string>{"a.wav", "b.wav"}};
+        },
+        [&](const std::string &, const std::atomic<bool> &, const Pool &) {
+            if (warms++ == 0) {
+                firstStarted.set_value();
+                released.wait();
+            }
+            return Result<bool>{false};
+        });
+
+    prewarmer.requestScan();
+    firstStarted.get_future().wait();
+    prewarmer.requestScan();
+    prewarmer.requestScan();
+    release.set_value();
+
+    ASSERT_TRUE(waitFor(prewarmer, [](const Stats &stats) { return stats.scans == 1; }));
+    EXPECT_EQ(listings.load(), 2);
+    EXPECT_EQ(warms.load(), 3); // a.wav, then a.wav and b.wav again
+}
+
+TEST(AudioCachePrewarmer, ShutdownCancelsTheSoundInProgress) {
+    std::promise<void> started;
+    AudioCachePrewarmer prewarmer({}, listing({"long.wav", "never.wav"}),
+                                  [&](const std::string &sound, const std::atomic<bool> &stopping, const Pool &) {
+                                      EXPECT_EQ(sound, "long.wav");
+                                      started.set_value();
+                                      while (!stopping) {
+                                          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                                      }
+                                      return Result<bool>{ServerError(ServerError::InternalError, "cancelled")};
+                                  });
+
+    prewarmer.requestScan();
+    started.get_future().wait();
+    prewarmer.shutdown();
+    prewarmer.requestScan();
+
+    EXPECT_EQ(prewarmer.getStats().checked, 0u);
+    EXPECT_EQ(prewarmer.getStats().failed, 0u);
+}
+
+#if defined(__linux__)
+TEST(AudioCachePrewarmer, WarmsWithinItsBudget) {
+    std::atomic<int> niceLevel{-100};
+    std::atomic<int> cores{-1};
+    AudioCachePrewarmer prewarmer({.niceLevel = 15, .maxCores = 1}, listing({"a.wav"}),
+                                  [&](const std::string &, const std::atomic<bool> &, const Pool &pool) {
+                                      // Check from the pool it encodes on
+                                      EXPECT_EQ(pool->threadCount(), 1u);
+                                      pool->run([&] {
+                                          errno = 0;
+                                          niceLevel = getpriority(PRIO_PROCESS, static_cast<id_t>(gettid()));
+                                          cpu_set_t affinity;
+                                          CPU_ZERO(&affinity);
+                                          sched_getaffinity(0, sizeof(affinity), &affinity);
+                                          cores = CPU_COUNT(&affinity);
+                                      });
+                                      return Result<bool>{true};
+                                  });
+
+    prewarmer.requestScan();
+    ASSERT_TRUE(waitFor(prewarmer, [](const Stats &stats) { return stats.scans == 1; }));
+    EXPECT_EQ(niceLevel.load(), 15);
+    EXPECT_EQ(cores.load(), 1);
+}
+#endif
+
+TEST(AudioCachePrewarmer, NeedsAtLeastOneCore) {
+    EXPECT_THROW(AudioCachePrewarmer({.niceLevel = 10, .maxCores = 0}, listing({}),
+                                     [](const std::string &, const std::atomic<bool> &, const Pool &) {
+                                         return Result<bool>{true};
+                                     }),
+                 std::invalid_argument);
+}
+
+} // namespace creatures::audio
@@ -0,0 +1,134 @@
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "server/eventloop/timerwheel.h"
+
+namespace creatures {
+
+namespace {
+
+std::vector<framenum_t> collectDue(TimerWheel &wheel) {
+    std::vector<framenum_t> due;
+    while (auto *node = wheel.popDue()) {
+        due.push_back(node->deadline);
+    }
+    return due;
+}
+
+} // namespace
+
+TEST(TimerWheel, PastAndCurrentDeadlinesAreDueImmediately) {
+    TimerWheel wheel(100);
+    TimerWheelNode past{nullptr, 50};
+    TimerWheelNode now{nullptr, 100};
+
+    wheel.insert(&past);
+    wheel.insert(&now);
+
+    EXPECT_EQ(wheel.size(), 2U);
+    EXPECT_EQ(collectDue(wheel), std::vector<framenum_t>({50, 100}));
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheel, ExpiresEachNodeOnItsOwnFrame) {
+    TimerWheel wheel;
+    std::vector<TimerWheelNode> nodes;
+    const std::vector<framenum_t> deadlines = {1, 2, 255, 256, 257, 1000, 65535, 65536, 70000, 16777216};
+    nodes.reserve(deadlines.size());
+    for (auto deadline : deadlines) {
+        nodes.push_back(TimerWheelNode{nullptr, deadline});
+    }
+    for (auto &node : nodes) {
+        wheel.insert(&node);
+    }
+
+    std::vector<framenum_t> expired;
+    for (framenum_t frame = 1; frame <= 16777216; ++frame) {
+        wheel.advanceTo(frame);
+        while (auto *node = wheel.popDue()) {
+            EXPECT_EQ(node->deadline, frame);
+            expired.push_back(node->deadline);
+        }
+    }
+
+    EXPECT_EQ(expired, deadlines);
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheel, KeepsInsertionOrderWithinAFrame) {
+    TimerWheel wheel;
+    TimerWheelNode a{nullptr, 10};
+    TimerWheelNode b{nullptr, 10};
+    TimerWheelNode c{nullptr, 10};
+
+    wheel.insert(&a);
+    wheel.insert(&b);
+    wheel.insert(&c);
+    wheel.advanceTo(10);
+
+    EXPECT_EQ(wheel.popDue(), &a);
+    EXPECT_EQ(wheel.popDue(), &b);
+    EXPECT_EQ(wheel.popDue(), &c);
+    EXPECT_EQ(wheel.popDue(), nullptr);
+}
+
+TEST(TimerWheel, NodesInsertedWhileDrainingForTheCurrentFrameRunThisFrame) {
+    TimerWheel wheel;
+    TimerWheelNode first{nullptr, 5};
+    TimerWheelNode followUp{nullptr, 5};
+
+    wheel.insert(&first);
+    wheel.advanceTo(5);
+
+    ASSERT_EQ(wheel.popDue(), &first);
+    wheel.insert(&followUp);
+    EXPECT_EQ(wheel.popDue(), &followUp);
+}
+
+TEST(TimerWheel, DeadlinesPastTheTopLevelParkOnOverflowAndStillExpire) {
+    // Only fifteen frames apart, but the deadline sits on the far side of the
+    // 2^32 boundary, so it can't be filed on any level until the wheel wraps.
+    constexpr framenum_t start = (framenum_t{1} << 32) - 10;
+    constexpr framenum_t farAway = (framenum_t{1} << 32) + 5;
+    TimerWheel wheel(start);
+    TimerWheelNode node{nullptr, farAway};
+
+    wheel.insert(&node);
+    wheel.advanceTo(farAway - 1);
+    EXPECT_EQ(wheel.popDue(), nullptr);
+
+    wheel.advanceTo(farAway);
+    EXPECT_EQ(wheel.popDue(), &node);
+}
+
+TEST(TimerWheel, SkipsIdleStretchesWithoutLosingOverflow) {
+    TimerWheel wheel;
+    TimerWheelNode node{nullptr, (framenum_t{1} << 33) + 7};
+
+    wheel.insert(&node);
+    wheel.advanceTo((framenum_t{1} << 33) + 6);
+    EXPECT_EQ(wheel.popDue(), nullptr);
+
+    wheel.advanceTo((framenum_t{1} << 33) + 7);
+    EXPECT_EQ(wheel.popDue(), &node);
+}
+
+TEST(TimerWheel, DrainHandsBackEveryNode) {
+    TimerWheel wheel;
+    TimerWheelNode soon{nullptr, 3};
+    TimerWheelNode later{nullptr, 300000};
+    TimerWheelNode due{nullptr, 0};
+    wheel.insert(&soon);
+    wheel.insert(&later);
+    wheel.insert(&due);
+
+    size_t drained = 0;
+    wheel.drain([&drained](TimerWheelNode *) { ++drained; });
+
+    EXPECT_EQ(drained, 3U);
+    EXPECT_TRUE(wheel.empty());
+}
+
+} // namespace creatures
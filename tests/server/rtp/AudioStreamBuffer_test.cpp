@@ -0,0 +1,153 @@
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <numbers>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "server/config.h"
+#include "server/rtp/AudioStreamBuffer.h"
+#include "server/rtp/opus/OpusEncoderWrapper.h"
+#include "server/rtp/opus/OpusPriming.h"
+#include "server/voice/PcmWavWriter.h"
+#include "util/AudioCache.h"
+#include "util/ComputePool.h"
+
+namespace creatures::rtp {
+namespace {
+
+namespace fs = std::filesystem;
+
+constexpr std::size_t kFrames = 150; // 1.5s, several encode chunks with a short one at the end
+constexpr uint16_t kAudioChannel = 1;
+
+class AudioStreamBufferTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        root_ = fs::temp_directory_path() /
+                ("audio-stream-buffer-test-" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()));
+        fs::create_directories(root_);
+
+        // A tone that changes pitch, so every frame encodes differently
+        mono_.resize(kFrames * RTP_SAMPLES);
+        for (std::size_t i = 0; i < mono_.size(); ++i) {
+            const double hz = 220.0 + static_cast<double>(i / RTP_SAMPLES) * 3.0;
+            const double t = static_cast<double>(i) / RTP_SRATE;
+            mono_[i] = static_cast<int16_t>(8000.0 * std::sin(2.0 * std::numbers::pi * hz * t));
+        }
+        wavPath_ = root_ / "tone.wav";
+        std::vector<uint8_t> pcm(mono_.size() * sizeof(int16_t));
+        std::memcpy(pcm.data(), mono_.data(), pcm.size());
+        ASSERT_TRUE(voice::writePcmToMultichannelWav(pcm, wavPath_, kAudioChannel, RTP_SRATE).isSuccess());
+
+        AudioStreamBuffer::setAudioCacheInstance(nullptr);
+        AudioStreamBuffer::setEncodeLeadFrames(DEFAULT_RTP_ENCODE_LEAD_MS / RTP_FRAME_MS);
+    }
+
+    void TearDown() override {
+        AudioStreamBuffer::setAudioCacheInstance(nullptr);
+        AudioStreamBuffer::setEncodeLeadFrames(DEFAULT_RTP_ENCODE_LEAD_MS / RTP_FRAME_MS);
+        std::error_code error;
+        fs::remove_all(root_, error);
+    }
+
+    // What encoding the whole channel in one go produces
+    [[nodiscard]] std::vector<std::vector<uint8_t>> encodeInOnePass() const {
+        opus::Encoder encoder;
+        static_cast<void>(opus::encodePrimingSequence(encoder));
+        std::vector<std::vector<uint8_t>> frames;
+        for (std::size_t frame = 0; frame < kFrames; ++frame) {
+            frames.push_back(encoder.encode(mono_.data() + frame * RTP_SAMPLES));
+        }
+        return frames;
+    }
+
+    fs::path root_;
+    fs::path wavPath_;
+    std::vector<int16_t> mono_;
+};
+
+TEST_F(AudioStreamBufferTest, StreamingReturnsOnceTheLeadIsEncoded) {
+    AudioStreamBuffer::setEncodeLeadFrames(5);
+
+    const auto buffer = AudioStreamBuffer::streamFromWavFile(wavPath_.string());
+    ASSERT_NE(buffer, nullptr);
+    EXPECT_EQ(buffer->getFrameCount(), kFrames);
+    EXPECT_GE(buffer->getFramesReady(), 5u);
+
+    ASSERT_TRUE(buffer->waitForFrames(kFrames));
+    EXPECT_TRUE(buffer->isFullyEncoded());
+    EXPECT_FALSE(buffer->hasEncodeFailed());
+}
+
+TEST_F(AudioStreamBufferTest, ChunkBoundariesDontShowInTheOutput) {
+    const auto buffer = AudioStreamBuffer::loadFromWavFile(wavPath_.string());
+    ASSERT_NE(buffer, nullptr);
+    ASSERT_TRUE(buffer->isFullyEncoded());
+
+    const auto expected = encodeInOnePass();
+    for (std::size_t frame = 0; frame < kFrames; ++frame) {
+        const auto encoded = buffer->getEncodedFrame(kAudioChannel - 1, frame);
+        EXPECT_EQ(std::vector<uint8_t>(encoded.begin(), encoded.end()), expected[frame]) << "frame " << frame;
+    }
+}
+
+TEST_F(AudioStreamBufferTest, FinishedEncodesAreCached) {
+    const auto cache = std::make_shared<util::AudioCache>(root_.string());
+    AudioStreamBuffer::setAudioCacheInstance(cache);
+
+    auto buffer = AudioStreamBuffer::loadFromWavFile(wavPath_.string());
+    ASSERT_NE(buffer, nullptr);
+    const auto lastFrame = buffer->getEncodedFrame(kAudioChannel - 1, kFrames - 1);
+    const std::vector<uint8_t> expected(lastFrame.begin(), lastFrame.end());
+
+    // Dropping the buffer waits for the encode thread, which writes the cache on its way out
+    buffer.reset();
+
+    const auto cached = cache->tryLoadFromCache(wavPath_.string());
+    ASSERT_NE(cached, nullptr);
+    EXPECT_EQ(cached->framesPerChannel, kFrames);
+    const auto cachedFrame = cached->frames->frame(kAudioChannel - 1, kFrames - 1);
+    EXPECT_EQ(std::vector<uint8_t>(cachedFrame.begin(), cachedFrame.end()), expected);
+
+    const auto hit = AudioStreamBuffer::streamFromWavFile(wavPath_.string());
+    ASSERT_NE(hit, nullptr);
+    EXPECT_TRUE(hit->isFullyEncoded());
+
+    // The hit reads straight out of the arena the cache loaded
+    const auto hitFrame = hit->getEncodedFrame(kAudioChannel - 1, kFrames - 1);
+    EXPECT_EQ(std::vector<uint8_t>(hitFrame.begin(), hitFrame.end()), expected);
+}
+
+TEST_F(AudioStreamBufferTest, PrewarmingOnlyEncodesWhatIsntCached) {
+    const std::atomic<bool> cancelled{false};
+    const auto pool = std::make_shared<util::ComputePool>(2, std::vector<int>{}, "Prewarm");
+    EXPECT_FALSE(AudioStreamBuffer::prewarm(wavPath_.string(), cancelled, pool).isSuccess());
+
+    const auto cache = std::make_shared<util::AudioCache>(root_.string());
+    AudioStreamBuffer::setAudioCacheInstance(cache);
+
+    const auto first = AudioStreamBuffer::prewarm(wavPath_.string(), cancelled, pool);
+    ASSERT_TRUE(first.isSuccess());
+    EXPECT_TRUE(first.getValue().value());
+    EXPECT_TRUE(cache->isCached(wavPath_.string()));
+    EXPECT_GT(pool->getStats().tasksRun, 0u);
+
+    const auto second = AudioStreamBuffer::prewarm(wavPath_.string(), cancelled, pool);
+    ASSERT_TRUE(second.isSuccess());
+    EXPECT_FALSE(second.getValue().value());
+    EXPECT_EQ(cache->getStats().cacheHits, 0u);
+}
+
+TEST_F(AudioStreamBufferTest, MissingFilesFailUpFront) {
+    EXPECT_EQ(AudioStreamBuffer::streamFromWavFile((root_ / "missing.wav").string()), nullptr);
+}
+
+} // namespace
+} // namespace creatures::rtp
@@ -0,0 +1,74 @@
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "server/config.h"
+#include "server/rtp/opus/OpusEncoderWrapper.h"
+#include "server/rtp/opus/OpusPriming.h"
+#include "server/rtp/opus/PrimedEncoderPool.h"
+
+namespace creatures::rtp::opus {
+
+namespace {
+
+std::array<int16_t, RTP_SAMPLES> testFrame(int seed) {
+    std::array<int16_t, RTP_SAMPLES> frame{};
+    for (size_t sampleIndex = 0; sampleIndex < frame.size(); ++sampleIndex) {
+        frame[sampleIndex] = static_cast<int16_t>(((sampleIndex + seed) % 97) * 200 - 9600);
+    }
+    return frame;
+}
+
+} // namespace
+
+TEST(PrimedEncoderPool, ReusedEncodersStartLikeNewOnes) {
+    auto pool = std::make_shared<PrimedEncoderPool>(1);
+    const Encoder *first = nullptr;
+    {
+        auto lease = pool->acquire();
+        first = &*lease;
+        for (int seed = 0; seed < 10; ++seed) {
+            const auto frame = testFrame(seed);
+            static_cast<void>(lease->encode(frame.data()));
+        }
+    }
+    EXPECT_EQ(pool->idleCount(), 1u);
+
+    auto reused = pool->acquire();
+    EXPECT_EQ(&*reused, first);
+    EXPECT_EQ(pool->idleCount(), 0u);
+
+    Encoder fresh;
+    static_cast<void>(encodePrimingSequence(fresh));
+    for (int seed = 20; seed < 25; ++seed) {
+        const auto frame = testFrame(seed);
+        EXPECT_EQ(reused->encode(frame.data()), fresh.encode(frame.data()));
+    }
+}
+
+TEST(PrimedEncoderPool, KeepsOnlySoMany) {
+    auto pool = std::make_shared<PrimedEncoderPool>(2);
+    {
+        std::vector<PrimedEncoderPool::Lease> leases;
+        for (int i = 0; i < 5; ++i) {
+            leases.push_back(pool->acquire());
+        }
+    }
+    EXPECT_EQ(pool->idleCount(), 2u);
+}
+
+TEST(PrimedEncoderPool, LeasesCanOutliveTheirPool) {
+    auto pool = std::make_shared<PrimedEncoderPool>(1);
+    auto lease = pool->acquire();
+    std::weak_ptr<PrimedEncoderPool> weakPool = pool;
+    pool.reset();
+    EXPECT_FALSE(weakPool.expired());
+
+    lease = PrimedEncoderPool::Lease{};
+    EXPECT_TRUE(weakPool.expired());
+}
+
+} // namespace creatures::rtp::opus
@@ -63,6 +63,18 @@ TEST(RtpClockMapping, MatchesFrameClockWhenLateFramesAreSkipped) {
     EXPECT_EQ(frameClock.current(), mapping.at(monotonicEpoch + 40ms).rtpTimestamp);
 }
 
+TEST(RtpClockMapping, FindsWhenATimestampIsDue) {
+    const auto monotonicEpoch = RtpClockMapping::MonotonicClock::time_point{} + 10s;
+    const RtpClockMapping mapping(monotonicEpoch, RtpClockMapping::WallClock::time_point{},
+                                  std::numeric_limits<uint32_t>::max() - 100U, RTP_SRATE);
+    RtpFrameClock frameClock(mapping.rtpEpoch());
+
+    EXPECT_EQ(mapping.monotonicAt(frameClock.current()), monotonicEpoch);
+    frameClock.advance(3); // across the wrap
+    EXPECT_EQ(mapping.monotonicAt(frameClock.current()), monotonicEpoch + 30ms);
+    EXPECT_EQ(mapping.at(mapping.monotonicAt(frameClock.current())).rtpTimestamp, frameClock.current());
+}
+
 TEST(RtpClockMapping, RejectsAZeroSampleRate) {
     EXPECT_THROW(
         RtpClockMapping(RtpClockMapping::MonotonicClock::time_point{}, RtpClockMapping::WallClock::time_point{}, 0, 0),
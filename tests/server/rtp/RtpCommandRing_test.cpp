@@ -0,0 +1,119 @@
+#include <chrono>
+#include <cstddef>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "server/rtp/RtpCommandRing.h"
+
+namespace creatures::rtp {
+
+TEST(RtpCommandRing, RejectsWorkAtCapacityWithoutBlocking) {
+    RtpCommandRing<int> ring(2);
+
+    EXPECT_TRUE(ring.tryPush(10));
+    EXPECT_TRUE(ring.tryPush(20));
+    EXPECT_TRUE(ring.full());
+    EXPECT_FALSE(ring.tryPush(30));
+    EXPECT_EQ(ring.size(), 2U);
+
+    int first = 0;
+    int second = 0;
+    ASSERT_EQ(ring.waitPop(first), RtpCommandWait::Command);
+    ASSERT_EQ(ring.waitPop(second), RtpCommandWait::Command);
+    EXPECT_EQ(first, 10);
+    EXPECT_EQ(second, 20);
+    EXPECT_FALSE(ring.full());
+}
+
+TEST(RtpCommandRing, StopDiscardsPendingWorkAndRejectsProducers) {
+    RtpCommandRing<int> ring(2);
+    ASSERT_TRUE(ring.tryPush(1));
+
+    ring.stop();
+
+    int command = 0;
+    EXPECT_EQ(ring.waitPop(command), RtpCommandWait::Stopped);
+    EXPECT_FALSE(ring.tryPush(2));
+    EXPECT_EQ(ring.size(), 0U);
+}
+
+TEST(RtpCommandRing, MaximumDurationWorkCannotGrowPastCapacity) {
+    constexpr size_t capacity = 64;
+    constexpr size_t maximumCacheFrames = 2'000'000;
+    RtpCommandRing<size_t> ring(capacity);
+
+    size_t accepted = 0;
+    for (size_t frame = 0; frame < maximumCacheFrames; ++frame) {
+        if (ring.tryPush(frame)) {
+            ++accepted;
+        }
+    }
+
+    EXPECT_EQ(accepted, capacity);
+    EXPECT_EQ(ring.size(), capacity);
+}
+
+TEST(RtpCommandRing, WakeWithoutACommand) {
+    RtpCommandRing<int> ring(4);
+    ring.wake();
+
+    int command = 0;
+    EXPECT_EQ(ring.waitPop(command), RtpCommandWait::Woken);
+
+    // Commands go first, and a wake is only reported once
+    ring.wake();
+    ASSERT_TRUE(ring.tryPush(7));
+    EXPECT_EQ(ring.waitPop(command), RtpCommandWait::Command);
+    EXPECT_EQ(command, 7);
+    EXPECT_EQ(ring.waitPop(command), RtpCommandWait::Woken);
+}
+
+TEST(RtpCommandRing, SleepingConsumerSeesEveryCommandInOrder) {
+    constexpr size_t commands = 20'000;
+    RtpCommandRing<size_t> ring(8);
+
+    size_t received = 0;
+    bool inOrder = true;
+    std::thread consumer([&] {
+        size_t command = 0;
+        while (ring.waitPop(command) == RtpCommandWait::Command) {
+            inOrder = inOrder && command == received;
+            ++received;
+            if (received == commands) {
+                return;
+            }
+        }
+    });
+
+    // Let the consumer fall asleep now and then so both wakeup paths get used
+    for (size_t command = 0; command < commands; ++command) {
+        while (!ring.tryPush(command)) {
+            std::this_thread::yield();
+        }
+        if (command % 1000 == 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+    consumer.join();
+
+    EXPECT_EQ(received, commands);
+    EXPECT_TRUE(inOrder);
+}
+
+TEST(RtpCommandRing, StopWakesASleepingConsumer) {
+    RtpCommandRing<int> ring(4);
+    RtpCommandWait waited = RtpCommandWait::Command;
+    std::thread consumer([&] {
+        int command = 0;
+        waited = ring.waitPop(command);
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ring.stop();
+    consumer.join();
+
+    EXPECT_EQ(waited, RtpCommandWait::Stopped);
+}
+
+} // namespace creatures::rtp
@@ -0,0 +1,260 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "server/config.h"
+#include "server/rtp/PcmMix.h"
+#include "server/rtp/RtpMixSource.h"
+#include "server/rtp/RtpMixer.h"
+
+namespace creatures::rtp {
+namespace {
+
+constexpr uint8_t TEST_CHANNEL = 3;
+
+// A mono source holding `frames` frames of one constant sample, already finished
+std::shared_ptr<RtpMixSource> constantSource(int16_t sample, size_t frames) {
+    auto source = std::make_shared<RtpMixSource>(1, frames + 1);
+    const std::vector<int16_t> samples(frames * RTP_SAMPLES, sample);
+    EXPECT_EQ(source->write(samples), samples.size());
+    source->finish();
+    return source;
+}
+
+RtpMixTrackOptions onChannel(RtpMixRole role, float gainDb = 0.0F) {
+    RtpMixTrackOptions options;
+    options.role = role;
+    options.gainDb = gainDb;
+    options.channel = TEST_CHANNEL;
+    return options;
+}
+
+TEST(PcmMix, VectorPathMatchesScalarArithmetic) {
+    // An odd length so the scalar tail runs too
+    constexpr size_t count = 37;
+    std::vector<int16_t> samples(count);
+    for (size_t index = 0; index < count; ++index) {
+        samples[index] = static_cast<int16_t>(index % 2 == 0 ? std::numeric_limits<int16_t>::max() - index
+                                                             : std::numeric_limits<int16_t>::min() + index);
+    }
+    const int16_t gain = toMixGain(3.5F);
+
+    std::vector<int32_t> bus(count, 1000);
+    accumulateScaled(bus.data(), samples.data(), count, gain);
+
+    for (size_t index = 0; index < count; ++index) {
+        const int32_t expected = 1000 + ((static_cast<int32_t>(samples[index]) * gain) >> PCM_MIX_GAIN_SHIFT);
+        EXPECT_EQ(bus[index], expected) << "sample " << index;
+    }
+    EXPECT_EQ(peakMagnitude(bus.data(), count),
+              std::abs(*std::max_element(bus.begin(), bus.end(), [](int32_t left, int32_t right) {
+                  return std::abs(left) < std::abs(right);
+              })));
+}
+
+TEST(PcmMix, SaturatesInsteadOfWrapping) {
+    const std::vector<int32_t> bus = {0, 40000, -40000, 32767, -32768, 12, -12, 70000, -70000};
+    std::vector<int16_t> out(bus.size());
+
+    saturateToInt16(bus.data(), out.data(), bus.size());
+
+    EXPECT_EQ(out, (std::vector<int16_t>{0, 32767, -32768, 32767, -32768, 12, -12, 32767, -32768}));
+}
+
+TEST(RtpMixSource, ReadsInterleavedAudioBackChannelByChannel) {
+    constexpr uint16_t channels = 2;
+    RtpMixSource source(channels, 4);
+    std::vector<int16_t> interleaved(RTP_SAMPLES * channels);
+    for (size_t frame = 0; frame < RTP_SAMPLES; ++frame) {
+        interleaved[frame * channels] = static_cast<int16_t>(frame);
+        interleaved[frame * channels + 1] = static_cast<int16_t>(-static_cast<int>(frame));
+    }
+    ASSERT_EQ(source.write(interleaved), RTP_SAMPLES);
+
+    std::vector<int16_t> planar(RTP_SAMPLES * channels);
+    ASSERT_EQ(source.read(planar), RtpMixSource::Read::Frame);
+
+    for (size_t frame = 0; frame < RTP_SAMPLES; ++frame) {
+        EXPECT_EQ(planar[frame], static_cast<int16_t>(frame));
+        EXPECT_EQ(planar[RTP_SAMPLES + frame], static_cast<int16_t>(-static_cast<int>(frame)));
+    }
+}
+
+TEST(RtpMixSource, UnderrunsUntilFinishedThenPadsTheLastFrame) {
+    RtpMixSource source(1, 4);
+    std::vector<int16_t> planar(RTP_SAMPLES);
+
+    EXPECT_EQ(source.read(planar), RtpMixSource::Read::Underrun);
+
+    const std::vector<int16_t> partial(RTP_SAMPLES / 2, 500);
+    ASSERT_EQ(source.write(partial), partial.size());
+    EXPECT_EQ(source.read(planar), RtpMixSource::Read::Underrun);
+
+    source.finish();
+    ASSERT_EQ(source.read(planar), RtpMixSource::Read::Frame);
+    EXPECT_EQ(planar.front(), 500);
+    EXPECT_EQ(planar.back(), 0);
+    EXPECT_EQ(source.read(planar), RtpMixSource::Read::Finished);
+}
+
+TEST(RtpMixSource, FullRingTakesNothing) {
+    RtpMixSource source(1, 2);
+    const std::vector<int16_t> samples(RTP_SAMPLES * 3, 1);
+
+    EXPECT_EQ(source.write(samples), RTP_SAMPLES * 2U);
+    EXPECT_TRUE(source.full());
+    EXPECT_EQ(source.write(samples), 0U);
+}
+
+TEST(RtpMixer, SumsTracksWithTheirGains) {
+    RtpMixer mixer(RtpMixer::Options{});
+    ASSERT_TRUE(mixer.addTrack(constantSource(1000, 4), onChannel(RtpMixRole::Program)).isSuccess());
+    ASSERT_TRUE(mixer.addTrack(constantSource(2000, 4), onChannel(RtpMixRole::Program, -6.0F)).isSuccess());
+
+    const auto &mixed = mixer.mixFrame(0);
+
+    // -6dB is a hair over half
+    EXPECT_NEAR(mixed[TEST_CHANNEL][0], 1000 + 1002, 2);
+    EXPECT_NEAR(mixed[TEST_CHANNEL][RTP_SAMPLES - 1], 2002, 2);
+    EXPECT_EQ(mixed[0][0], 0);
+}
+
+TEST(RtpMixer, DucksBedTracksWhileDialogPlays) {
+    RtpMixer::Options options;
+    options.duckDb = -12.0F;
+    options.duckAttackMs = 20;
+    options.duckReleaseMs = 40;
+    RtpMixer mixer(options);
+
+    ASSERT_TRUE(mixer.addTrack(constantSource(1000, 20), onChannel(RtpMixRole::Bed)).isSuccess());
+    ASSERT_TRUE(mixer.addTrack(constantSource(0, 3), onChannel(RtpMixRole::Dialog)).isSuccess());
+
+    // Two 10ms frames to duck all the way
+    mixer.mixFrame(0);
+    EXPECT_FLOAT_EQ(mixer.getDuckDb(), -6.0F);
+    const auto &ducked = mixer.mixFrame(0);
+    EXPECT_FLOAT_EQ(mixer.getDuckDb(), -12.0F);
+    EXPECT_NEAR(ducked[TEST_CHANNEL][0], 251, 2);
+
+    // The dialog runs out, and the bed comes back up over four frames
+    mixer.mixFrame(0);
+    mixer.mixFrame(0);
+    EXPECT_EQ(mixer.getTrackCount(), 1U);
+    EXPECT_FLOAT_EQ(mixer.getDuckDb(), -12.0F);
+    mixer.mixFrame(0);
+    EXPECT_FLOAT_EQ(mixer.getDuckDb(), -9.0F);
+    for (int frame = 0; frame < 3; ++frame) {
+        mixer.mixFrame(0);
+    }
+    EXPECT_FLOAT_EQ(mixer.getDuckDb(), 0.0F);
+    EXPECT_EQ(mixer.mixFrame(0)[TEST_CHANNEL][0], 1000);
+}
+
+TEST(RtpMixer, LimiterKeepsPeaksUnderTheCeiling) {
+    RtpMixer::Options options;
+    options.limiterCeilingDb = -6.0F;
+    RtpMixer mixer(options);
+    for (int track = 0; track < 4; ++track) {
+        ASSERT_TRUE(mixer.addTrack(constantSource(20000, 4), onChannel(RtpMixRole::Program)).isSuccess());
+    }
+
+    const auto &mixed = mixer.mixFrame(0);
+
+    const auto ceiling = static_cast<int16_t>(32767.0F * 0.5012F);
+    EXPECT_LE(mixed[TEST_CHANNEL][0], ceiling);
+    EXPECT_GT(mixed[TEST_CHANNEL][0], ceiling - 10);
+}
+
+TEST(RtpMixer, FinishedTracksStopCounting) {
+    RtpMixer mixer(RtpMixer::Options{});
+    ASSERT_TRUE(mixer.addTrack(constantSource(100, 1), onChannel(RtpMixRole::Program)).isSuccess());
+    EXPECT_EQ(mixer.getTrackCount(), 1U);
+
+    mixer.mixFrame(0);
+    EXPECT_EQ(mixer.getTrackCount(), 1U);
+    mixer.mixFrame(0);
+    EXPECT_EQ(mixer.getTrackCount(), 0U);
+}
+
+TEST(RtpMixer, UnderrunsPlaySilenceAndAreCounted) {
+    RtpMixer mixer(RtpMixer::Options{});
+    auto source = std::make_shared<RtpMixSource>(1, 4);
+    ASSERT_TRUE(mixer.addTrack(source, onChannel(RtpMixRole::Program)).isSuccess());
+
+    EXPECT_EQ(mixer.mixFrame(0)[TEST_CHANNEL][0], 0);
+    EXPECT_EQ(mixer.takeUnderruns(), 1U);
+    EXPECT_EQ(mixer.takeUnderruns(), 0U);
+    EXPECT_EQ(mixer.getTrackCount(), 1U);
+}
+
+TEST(RtpMixer, ClearStopsCountingStraightAway) {
+    RtpMixer mixer(RtpMixer::Options{});
+    auto playing = constantSource(100, 10);
+    auto waiting = constantSource(100, 10);
+    ASSERT_TRUE(mixer.addTrack(playing, onChannel(RtpMixRole::Program)).isSuccess());
+    mixer.mixFrame(0);
+    ASSERT_TRUE(mixer.addTrack(waiting, onChannel(RtpMixRole::Program)).isSuccess());
+
+    mixer.clear();
+
+    EXPECT_EQ(mixer.getTrackCount(), 0U);
+    EXPECT_TRUE(waiting->isCancelled());
+    EXPECT_EQ(mixer.mixFrame(0)[TEST_CHANNEL][0], 0);
+    EXPECT_TRUE(playing->isCancelled());
+}
+
+TEST(RtpMixer, CancelledSourcesLeaveTheMixStraightAway) {
+    RtpMixer mixer(RtpMixer::Options{});
+    auto source = constantSource(100, 10);
+    ASSERT_TRUE(mixer.addTrack(source, onChannel(RtpMixRole::Dialog)).isSuccess());
+    EXPECT_EQ(mixer.mixFrame(0)[TEST_CHANNEL][0], 100);
+    EXPECT_FALSE(source->isDrained());
+
+    source->cancel();
+
+    EXPECT_TRUE(source->isDrained());
+    EXPECT_EQ(mixer.mixFrame(0)[TEST_CHANNEL][0], 0);
+    EXPECT_EQ(mixer.getTrackCount(), 0U);
+}
+
+TEST(RtpMixSource, DrainedOnceTheLastFrameIsRead) {
+    auto source = constantSource(100, 2);
+    std::vector<int16_t> planar(RTP_SAMPLES);
+
+    ASSERT_EQ(source->read(planar), RtpMixSource::Read::Frame);
+    EXPECT_FALSE(source->isDrained());
+    ASSERT_EQ(source->read(planar), RtpMixSource::Read::Frame);
+    EXPECT_TRUE(source->isDrained());
+}
+
+TEST(RtpMixer, RefusesTracksPastTheLimit) {
+    RtpMixer mixer(RtpMixer::Options{});
+    for (size_t track = 0; track < RTP_MIXER_MAX_TRACKS; ++track) {
+        ASSERT_TRUE(mixer.addTrack(constantSource(1, 1), onChannel(RtpMixRole::Program)).isSuccess());
+    }
+
+    const auto refused = mixer.addTrack(constantSource(1, 1), onChannel(RtpMixRole::Program));
+
+    ASSERT_FALSE(refused.isSuccess());
+    EXPECT_EQ(refused.getError()->getCode(), ServerError::Conflict);
+}
+
+TEST(RtpMixer, RejectsChannelsAndGainsOutOfRange) {
+    RtpMixer mixer(RtpMixer::Options{});
+    RtpMixTrackOptions badChannel;
+    badChannel.channel = RTP_STREAMING_CHANNELS;
+    RtpMixTrackOptions badGain;
+    badGain.gainDb = 40.0F;
+
+    EXPECT_EQ(mixer.addTrack(constantSource(1, 1), badChannel).getError()->getCode(), ServerError::InvalidData);
+    EXPECT_EQ(mixer.addTrack(constantSource(1, 1), badGain).getError()->getCode(), ServerError::InvalidData);
+    EXPECT_EQ(mixer.getTrackCount(), 0U);
+}
+
+} // namespace
+} // namespace creatures::rtp
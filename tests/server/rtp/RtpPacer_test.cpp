@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "server/config.h"
+#include "server/rtp/RtpClockMapping.h"
+#include "server/rtp/RtpPacer.h"
+#include "server/rtp/SendmmsgRtpTransport.h"
+
+namespace creatures::rtp {
+namespace {
+
+using namespace std::chrono_literals;
+
+uint32_t readU32(const uint8_t *bytes) {
+    return (static_cast<uint32_t>(bytes[0]) << 24U) | (static_cast<uint32_t>(bytes[1]) << 16U) |
+           (static_cast<uint32_t>(bytes[2]) << 8U) | bytes[3];
+}
+
+RtcpSender::SentOctets everyChannelSent() {
+    RtcpSender::SentOctets sentOctets{};
+    sentOctets.fill(100U);
+    return sentOctets;
+}
+
+TEST(RtpPacer, HasNoDeadlinesWithoutAStream) {
+    const RtpPacer pacer;
+
+    EXPECT_FALSE(pacer.deadline(0U).has_value());
+    EXPECT_EQ(pacer.waitUntilDue(0U), 0ns);
+}
+
+TEST(RtpPacer, DeadlinesFollowTheStreamsRtpClock) {
+    const auto monotonicEpoch = RtpPacer::Clock::time_point{} + 10s;
+    const uint32_t rtpEpoch = UINT32_MAX - RTP_SAMPLES + 1U; // the next frame set's timestamp wraps
+    RtpPacer pacer;
+    pacer.beginStream(RtpClockMapping(monotonicEpoch, RtpClockMapping::WallClock::time_point{}, rtpEpoch, RTP_SRATE));
+
+    EXPECT_EQ(pacer.deadline(rtpEpoch), monotonicEpoch);
+    EXPECT_EQ(pacer.deadline(rtpEpoch + RTP_SAMPLES), monotonicEpoch + 10ms);
+    EXPECT_EQ(pacer.deadline(rtpEpoch + 3U * RTP_SAMPLES), monotonicEpoch + 30ms);
+}
+
+TEST(RtpPacer, SleepsUntilTheDeadline) {
+    const auto clockMapping = RtpClockMapping::capture(RTP_SRATE);
+    RtpPacer pacer;
+    pacer.beginStream(clockMapping);
+
+    const uint32_t timestamp = clockMapping.rtpEpoch() + 2U * RTP_SAMPLES;
+    const auto lateness = pacer.waitUntilDue(timestamp);
+
+    EXPECT_GE(RtpPacer::Clock::now(), clockMapping.monotonicAt(timestamp));
+    EXPECT_GE(lateness, 0ns);
+}
+
+TEST(RtpPacer, MeasuresEachChannelAgainstItsLastPacket) {
+    const auto start = RtpPacer::Clock::time_point{} + 1s;
+    RtpPacer pacer;
+    RtpPacer::ChannelJitter jitter;
+
+    auto sentOctets = everyChannelSent();
+    sentOctets[1] = 0; // channel 1 misses the second frame set
+    pacer.recordSent(0U, everyChannelSent(), start, jitter);
+    pacer.recordSent(RTP_SAMPLES, sentOctets, start + 12ms, jitter);
+    pacer.recordSent(2U * RTP_SAMPLES, everyChannelSent(), start + 20ms, jitter);
+
+    // Channel 0: 12ms for a 10ms step, then 8ms for the next one
+    const auto channel0 = jitter[0].snapshot();
+    EXPECT_EQ(channel0.count, 2U);
+    EXPECT_NEAR(static_cast<double>(channel0.max), 2'000'000.0, 2'000'000.0 * 0.125);
+
+    // Channel 1: 20ms for a 20ms step, measured from the first frame set
+    const auto channel1 = jitter[1].snapshot();
+    EXPECT_EQ(channel1.count, 1U);
+    EXPECT_EQ(channel1.max, 0U);
+}
+
+// Stands in for the multicast groups: every channel goes to one socket on loopback
+class Receiver {
+  public:
+    Receiver() {
+        socket_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(socket_, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+        socklen_t length = sizeof(address);
+        getsockname(socket_, reinterpret_cast<sockaddr *>(&address), &length);
+        port_ = ntohs(address.sin_port);
+
+        timeval timeout{.tv_sec = 2, .tv_usec = 0};
+        setsockopt(socket_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    }
+    ~Receiver() { close(socket_); }
+
+    [[nodiscard]] uint16_t port() const { return port_; }
+
+    // Empty if nothing turned up in time
+    std::vector<uint8_t> receive() {
+        std::vector<uint8_t> packet(2048);
+        const auto received = recv(socket_, packet.data(), packet.size(), 0);
+        packet.resize(received < 0 ? 0 : static_cast<size_t>(received));
+        return packet;
+    }
+
+  private:
+    int socket_{-1};
+    uint16_t port_{0};
+};
+
+struct Arrival {
+    uint32_t timestamp{0};
+    RtpPacer::Clock::time_point receivedAt;
+};
+
+/*
+ * Replays a short session the way the output worker sends one (decoder
+ * priming, then audio with one late skip) through the sendmmsg transport to a
+ * socket on loopback, and checks the packets turn up spaced by their RTP
+ * timestamps rather than by however fast the loop can go.
+ */
+TEST(RtpPacer, ReplaysASessionAtTheRtpClockRate) {
+    constexpr uint32_t kSynchronizationSource = 7000U;
+    constexpr size_t kFrameSets = RTP_PRIMING_FRAMES + 30;
+    constexpr size_t kSkippedAfter = RTP_PRIMING_FRAMES + 10;
+
+    Receiver receiver;
+    SendmmsgRtpTransport::Groups groups;
+    groups.fill("127.0.0.1");
+    SendmmsgRtpTransport transport(groups, receiver.port(), 0);
+    RtpTransport::SynchronizationSources sources{};
+    for (size_t channel = 0; channel < RTP_STREAMING_CHANNELS; ++channel) {
+        sources[channel] = kSynchronizationSource + static_cast<uint32_t>(channel);
+    }
+    transport.setSynchronizationSources(sources);
+
+    // Only channel 0's packets are timed; the rest just have to be drained
+    std::vector<Arrival> arrivals;
+    std::thread receiving([&] {
+        for (size_t i = 0; i < kFrameSets * RTP_STREAMING_CHANNELS; ++i) {
+            const auto packet = receiver.receive();
+            if (packet.size() < RTP_HEADER_BYTES) {
+                return;
+            }
+            if (readU32(packet.data() + 8) == kSynchronizationSource) {
+                arrivals.push_back(Arrival{readU32(packet.data() + 4), RtpPacer::Clock::now()});
+            }
+        }
+    });
+
+    const std::array<uint8_t, 40> payload{};
+    RtpTransport::FrameSet frames;
+    frames.fill(payload);
+
+    const auto clockMapping = RtpClockMapping::capture(RTP_SRATE);
+    RtpPacer pacer;
+    RtpPacer::ChannelJitter jitter;
+    pacer.beginStream(clockMapping);
+    uint32_t timestamp = clockMapping.rtpEpoch();
+    for (size_t frameSet = 0; frameSet < kFrameSets; ++frameSet) {
+        if (frameSet == kSkippedAfter) {
+            timestamp += RTP_SAMPLES; // what a late frame's skippedFrames does to the frame clock
+        }
+        static_cast<void>(pacer.waitUntilDue(timestamp));
+        const auto sentAt = RtpPacer::Clock::now();
+        const auto sent = transport.sendFrameSet(frames, timestamp);
+        EXPECT_EQ(sent.error, 0);
+        pacer.recordSent(timestamp, sent.sentOctets, sentAt, jitter);
+        timestamp += RTP_SAMPLES;
+    }
+    receiving.join();
+
+    ASSERT_EQ(arrivals.size(), kFrameSets);
+    EXPECT_EQ(jitter[0].snapshot().count, kFrameSets - 1);
+
+    // Loose enough for a busy CI box: it's the rate that matters, not the microseconds
+    std::vector<int64_t> deviations;
+    for (size_t i = 1; i < arrivals.size(); ++i) {
+        const auto spacing = arrivals[i].receivedAt - arrivals[i - 1].receivedAt;
+        const auto expected = clockMapping.monotonicAt(arrivals[i].timestamp) -
+                              clockMapping.monotonicAt(arrivals[i - 1].timestamp);
+        deviations.push_back(
+            std::abs(std::chrono::duration_cast<std::chrono::microseconds>(spacing - expected).count()));
+    }
+    std::sort(deviations.begin(), deviations.end());
+    EXPECT_LT(deviations[deviations.size() / 2], 2'000) << "median deviation from the RTP clock, us";
+
+    const auto session = arrivals.back().receivedAt - arrivals.front().receivedAt;
+    EXPECT_GE(session, (kFrameSets - 1) * 10ms); // can't be early; the skip only makes it later
+    EXPECT_LT(session, kFrameSets * 10ms + 50ms);
+}
+
+} // namespace
+} // namespace creatures::rtp
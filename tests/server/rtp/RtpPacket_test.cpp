@@ -0,0 +1,36 @@
+#include <array>
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+#include "server/rtp/RtpPacket.h"
+
+namespace creatures::rtp {
+namespace {
+
+TEST(RtpPacket, WritesTheFixedHeaderInNetworkOrder) {
+    std::array<uint8_t, RTP_HEADER_BYTES> header{};
+    writeRtpHeader(header, {
+                               .payloadType = 96,
+                               .sequenceNumber = 0x1234U,
+                               .timestamp = 0x5566'7788U,
+                               .synchronizationSource = 0x99aa'bbccU,
+                           });
+
+    const std::array<uint8_t, RTP_HEADER_BYTES> expected{0x80, 96,   0x12, 0x34, 0x55, 0x66,
+                                                         0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc};
+    EXPECT_EQ(header, expected);
+}
+
+TEST(RtpPacket, SetsTheMarkerBitAndKeepsThePayloadTypeToSevenBits) {
+    std::array<uint8_t, RTP_HEADER_BYTES> header{};
+    writeRtpHeader(header, {.payloadType = 0xffU, .marker = true});
+    EXPECT_EQ(header[0], 0x80U);
+    EXPECT_EQ(header[1], 0xffU);
+
+    writeRtpHeader(header, {.payloadType = 0xe0U});
+    EXPECT_EQ(header[1], 0x60U);
+}
+
+} // namespace
+} // namespace creatures::rtp
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+
+#include "server/config.h"
+#include "server/rtp/RtpSilenceGate.h"
+
+namespace creatures::rtp {
+
+TEST(RtpSilenceGate, SendsEverythingWhenDisabled) {
+    RtpSilenceGate gate(false, 4);
+
+    for (int frame = 0; frame < 10; ++frame) {
+        EXPECT_TRUE(gate.admit(0, true));
+    }
+}
+
+TEST(RtpSilenceGate, SendsAKeepaliveEveryFewSilentFrames) {
+    RtpSilenceGate gate(true, 4);
+
+    EXPECT_TRUE(gate.admit(0, false));
+    EXPECT_FALSE(gate.admit(0, true));
+    EXPECT_FALSE(gate.admit(0, true));
+    EXPECT_FALSE(gate.admit(0, true));
+    EXPECT_TRUE(gate.admit(0, true));
+    EXPECT_FALSE(gate.admit(0, true));
+}
+
+TEST(RtpSilenceGate, SoundStartsTheCountOver) {
+    RtpSilenceGate gate(true, 3);
+
+    EXPECT_FALSE(gate.admit(0, true));
+    EXPECT_FALSE(gate.admit(0, true));
+    EXPECT_TRUE(gate.admit(0, false));
+    EXPECT_FALSE(gate.admit(0, true));
+    EXPECT_FALSE(gate.admit(0, true));
+    EXPECT_TRUE(gate.admit(0, true));
+}
+
+TEST(RtpSilenceGate, ChannelsAreCountedSeparately) {
+    RtpSilenceGate gate(true, 2);
+
+    EXPECT_FALSE(gate.admit(0, true));
+    EXPECT_TRUE(gate.admit(1, false));
+    EXPECT_TRUE(gate.admit(0, true));
+    EXPECT_FALSE(gate.admit(RTP_STREAMING_CHANNELS - 1, true));
+}
+
+TEST(RtpSilenceGate, ResetStartsEveryChannelOver) {
+    RtpSilenceGate gate(true, 2);
+    EXPECT_FALSE(gate.admit(0, true));
+
+    gate.reset();
+
+    EXPECT_FALSE(gate.admit(0, true));
+    EXPECT_TRUE(gate.admit(0, true));
+}
+
+} // namespace creatures::rtp
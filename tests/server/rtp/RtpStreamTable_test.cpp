@@ -0,0 +1,83 @@
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include "server/rtp/RtpStreamTable.h"
+
+namespace creatures::rtp {
+
+namespace {
+
+RtpStream testStream(uint64_t generation, std::shared_ptr<void> hold = nullptr) {
+    RtpStream stream;
+    stream.lease = RtpOutputLease{generation, "test"};
+    stream.releaseAfterSendHold = std::move(hold);
+    stream.traceContext.soundFile = "test.wav";
+    return stream;
+}
+
+} // namespace
+
+TEST(RtpStreamTable, HandlesArePlainBytes) {
+    EXPECT_TRUE(std::is_trivially_copyable_v<RtpStreamTable::Handle>);
+}
+
+TEST(RtpStreamTable, ClosedHandlesStopResolving) {
+    RtpStreamTable table;
+    const auto handle = table.open(testStream(7));
+    ASSERT_TRUE(handle.has_value());
+
+    const auto *stream = table.find(*handle);
+    ASSERT_NE(stream, nullptr);
+    EXPECT_EQ(stream->lease.generation, 7U);
+    EXPECT_EQ(stream->traceContext.soundFile, "test.wav");
+
+    table.close(*handle);
+    EXPECT_FALSE(table.isOpen(*handle));
+    EXPECT_EQ(table.find(*handle), nullptr);
+
+    // Closing again is harmless
+    table.close(*handle);
+    EXPECT_EQ(table.openCount(), 0U);
+}
+
+TEST(RtpStreamTable, ReusedSlotsDoNotAnswerToOldHandles) {
+    RtpStreamTable table;
+    std::optional<RtpStreamTable::Handle> first;
+    for (size_t i = 0; i < RtpStreamTable::SLOTS; ++i) {
+        const auto handle = table.open(testStream(1));
+        ASSERT_TRUE(handle.has_value());
+        if (!first) {
+            first = handle;
+        }
+    }
+    EXPECT_FALSE(table.open(testStream(2)).has_value());
+
+    table.close(*first);
+    const auto second = table.open(testStream(2));
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(second->slot, first->slot);
+    EXPECT_EQ(table.find(*first), nullptr);
+    ASSERT_NE(table.find(*second), nullptr);
+    EXPECT_EQ(table.find(*second)->lease.generation, 2U);
+}
+
+TEST(RtpStreamTable, ClosingLetsGoOfTheHold) {
+    RtpStreamTable table;
+    auto hold = std::make_shared<int>(1);
+    std::weak_ptr<int> watch = hold;
+
+    ASSERT_TRUE(table.open(testStream(3, std::move(hold))).has_value());
+    ASSERT_TRUE(table.open(testStream(4)).has_value());
+    EXPECT_FALSE(watch.expired());
+
+    EXPECT_EQ(table.closeIf([](const RtpStream &stream) { return stream.lease.generation == 3; }), 1U);
+    EXPECT_TRUE(watch.expired());
+    EXPECT_EQ(table.openCount(), 1U);
+}
+
+} // namespace creatures::rtp
@@ -0,0 +1,192 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "server/config.h"
+#include "server/rtp/SendmmsgRtpTransport.h"
+
+namespace creatures::rtp {
+namespace {
+
+uint16_t readU16(const uint8_t *bytes) { return static_cast<uint16_t>((bytes[0] << 8U) | bytes[1]); }
+
+uint32_t readU32(const uint8_t *bytes) {
+    return (static_cast<uint32_t>(bytes[0]) << 24U) | (static_cast<uint32_t>(bytes[1]) << 16U) |
+           (static_cast<uint32_t>(bytes[2]) << 8U) | bytes[3];
+}
+
+// Stands in for the multicast groups: every channel goes to one socket on loopback
+class Receiver {
+  public:
+    Receiver() {
+        socket_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(socket_, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+        socklen_t length = sizeof(address);
+        getsockname(socket_, reinterpret_cast<sockaddr *>(&address), &length);
+        port_ = ntohs(address.sin_port);
+
+        timeval timeout{.tv_sec = 2, .tv_usec = 0};
+        setsockopt(socket_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    }
+    ~Receiver() { close(socket_); }
+
+    [[nodiscard]] uint16_t port() const { return port_; }
+
+    std::vector<uint8_t> receive() {
+        std::vector<uint8_t> packet(2048);
+        const auto received = recv(socket_, packet.data(), packet.size(), 0);
+        packet.resize(received < 0 ? 0 : static_cast<size_t>(received));
+        return packet;
+    }
+
+  private:
+    int socket_{-1};
+    uint16_t port_{0};
+};
+
+SendmmsgRtpTransport::Groups loopbackGroups() {
+    SendmmsgRtpTransport::Groups groups;
+    groups.fill("127.0.0.1");
+    return groups;
+}
+
+RtpTransport::SynchronizationSources testSources() {
+    RtpTransport::SynchronizationSources sources{};
+    for (size_t channel = 0; channel < RTP_STREAMING_CHANNELS; ++channel) {
+        sources[channel] = 5000U + static_cast<uint32_t>(channel);
+    }
+    return sources;
+}
+
+TEST(SendmmsgRtpTransport, SendsEveryChannelWithItsOwnHeader) {
+    Receiver receiver;
+    SendmmsgRtpTransport transport(loopbackGroups(), receiver.port(), 0);
+    transport.setSynchronizationSources(testSources());
+
+    std::array<std::vector<uint8_t>, RTP_STREAMING_CHANNELS> payloads;
+    RtpTransport::FrameSet frames;
+    for (size_t channel = 0; channel < RTP_STREAMING_CHANNELS; ++channel) {
+        payloads[channel] = std::vector<uint8_t>(10 + channel, static_cast<uint8_t>(channel));
+        frames[channel] = payloads[channel];
+    }
+
+    const auto result = transport.sendFrameSet(frames, 123'456U);
+    EXPECT_EQ(result.error, 0);
+    EXPECT_GE(result.syscalls, 1U);
+#if defined(__linux__)
+    EXPECT_EQ(result.syscalls, 1U);
+#endif
+
+    std::map<uint32_t, std::vector<uint8_t>> bySource;
+    for (size_t i = 0; i < RTP_STREAMING_CHANNELS; ++i) {
+        auto packet = receiver.receive();
+        ASSERT_GE(packet.size(), RTP_HEADER_BYTES);
+        bySource[readU32(packet.data() + 8)] = std::move(packet);
+    }
+
+    for (size_t channel = 0; channel < RTP_STREAMING_CHANNELS; ++channel) {
+        EXPECT_EQ(result.sentOctets[channel], payloads[channel].size());
+
+        const auto &packet = bySource.at(5000U + static_cast<uint32_t>(channel));
+        EXPECT_EQ(packet[0], 0x80U);
+        EXPECT_EQ(packet[1], RTP_OPUS_PAYLOAD_PT);
+        EXPECT_EQ(readU32(packet.data() + 4), 123'456U);
+        EXPECT_EQ(std::vector<uint8_t>(packet.begin() + RTP_HEADER_BYTES, packet.end()), payloads[channel]);
+    }
+}
+
+TEST(SendmmsgRtpTransport, CountsEachChannelsSequenceUpFromARandomStart) {
+    Receiver receiver;
+    SendmmsgRtpTransport transport(loopbackGroups(), receiver.port(), 0);
+    transport.setSynchronizationSources(testSources());
+
+    const std::array<uint8_t, 4> payload{1, 2, 3, 4};
+    RtpTransport::FrameSet frames;
+    frames.fill(payload);
+
+    std::map<uint32_t, std::vector<uint16_t>> sequences;
+    for (uint32_t frame = 0; frame < 3; ++frame) {
+        ASSERT_EQ(transport.sendFrameSet(frames, frame * RTP_SAMPLES).error, 0);
+        for (size_t i = 0; i < RTP_STREAMING_CHANNELS; ++i) {
+            const auto packet = receiver.receive();
+            ASSERT_GE(packet.size(), RTP_HEADER_BYTES);
+            sequences[readU32(packet.data() + 8)].push_back(readU16(packet.data() + 2));
+        }
+    }
+
+    ASSERT_EQ(sequences.size(), RTP_STREAMING_CHANNELS);
+    for (const auto &[source, numbers] : sequences) {
+        ASSERT_EQ(numbers.size(), 3U) << source;
+        EXPECT_EQ(static_cast<uint16_t>(numbers[1] - numbers[0]), 1U) << source;
+        EXPECT_EQ(static_cast<uint16_t>(numbers[2] - numbers[1]), 1U) << source;
+    }
+}
+
+TEST(SendmmsgRtpTransport, LeavesOutEmptyPacketsAndMarksTheNextOne) {
+    Receiver receiver;
+    SendmmsgRtpTransport transport(loopbackGroups(), receiver.port(), 0);
+    transport.setSynchronizationSources(testSources());
+
+    const std::array<uint8_t, 4> payload{1, 2, 3, 4};
+    RtpTransport::FrameSet frames;
+    frames.fill(payload);
+
+    std::map<uint32_t, std::vector<std::vector<uint8_t>>> bySource;
+    auto receiveAll = [&](size_t packets) {
+        for (size_t i = 0; i < packets; ++i) {
+            auto packet = receiver.receive();
+            ASSERT_GE(packet.size(), RTP_HEADER_BYTES);
+            bySource[readU32(packet.data() + 8)].push_back(std::move(packet));
+        }
+    };
+
+    ASSERT_EQ(transport.sendFrameSet(frames, 0).error, 0);
+    receiveAll(RTP_STREAMING_CHANNELS);
+
+    // Channel 2 is silent for a frame set
+    frames[2] = {};
+    const auto skipped = transport.sendFrameSet(frames, RTP_SAMPLES);
+    ASSERT_EQ(skipped.error, 0);
+    EXPECT_EQ(skipped.sentOctets[2], 0U);
+    EXPECT_EQ(skipped.sentOctets[3], payload.size());
+    receiveAll(RTP_STREAMING_CHANNELS - 1);
+
+    frames[2] = payload;
+    ASSERT_EQ(transport.sendFrameSet(frames, 2 * RTP_SAMPLES).error, 0);
+    receiveAll(RTP_STREAMING_CHANNELS);
+
+    const auto &silenced = bySource.at(5002U);
+    ASSERT_EQ(silenced.size(), 2U);
+    EXPECT_EQ(static_cast<uint16_t>(readU16(silenced[1].data() + 2) - readU16(silenced[0].data() + 2)), 1U);
+    EXPECT_EQ(readU32(silenced[1].data() + 4), 2U * RTP_SAMPLES);
+    EXPECT_EQ(silenced[0][1], RTP_OPUS_PAYLOAD_PT);
+    EXPECT_EQ(silenced[1][1], 0x80U | RTP_OPUS_PAYLOAD_PT);
+
+    const auto &steady = bySource.at(5003U);
+    ASSERT_EQ(steady.size(), 3U);
+    EXPECT_EQ(steady[2][1], RTP_OPUS_PAYLOAD_PT);
+}
+
+TEST(SendmmsgRtpTransport, RefusesAnAddressThatIsntOne) {
+    auto groups = loopbackGroups();
+    groups[3] = "not-an-address";
+    EXPECT_THROW(SendmmsgRtpTransport(groups, 5004, 0), std::invalid_argument);
+}
+
+} // namespace
+} // namespace creatures::rtp
@@ -14,12 +14,14 @@
 #include <gtest/gtest.h>
 
 #include "model/CacheInvalidation.h"
+#include "server/animation/AnimationCache.h"
 #include "server/database.h"
 #include "server/storage/Storage.h"
 
 namespace creatures {
 
 extern std::shared_ptr<Database> db;
+extern std::shared_ptr<AnimationCache> animationCache;
 
 namespace testing {
 void setFakeDatabaseSucceeds(bool v);
@@ -131,6 +133,24 @@ TEST_F(PublishersTest, DeleteAnimationFiresAnimationOnSuccess) {
     EXPECT_EQ(log(), std::vector{CacheType::Animation});
 }
 
+// The server's own decoded copy has to go right away, not on the next frame
+TEST_F(PublishersTest, DeleteAnimationDropsTheCachedCopyOnlyOnSuccess) {
+    auto savedCache = creatures::animationCache;
+    creatures::animationCache = std::make_shared<AnimationCache>(1024 * 1024);
+    auto animation = std::make_shared<creatures::Animation>();
+    animation->id = "some-anim-id";
+    ASSERT_TRUE(creatures::animationCache->put(animation, creatures::animationCache->generation()));
+
+    EXPECT_FALSE(deleteAnimation("some-anim-id").isSuccess());
+    EXPECT_NE(creatures::animationCache->get("some-anim-id"), nullptr);
+
+    creatures::testing::setFakeDatabaseSucceeds(true);
+    EXPECT_TRUE(deleteAnimation("some-anim-id").isSuccess());
+    EXPECT_EQ(creatures::animationCache->get("some-anim-id"), nullptr);
+
+    creatures::animationCache = savedCache;
+}
+
 TEST_F(PublishersTest, PublishAnimationFiresBothAnimationAndSoundListOnSuccess) {
     creatures::testing::setFakeDatabaseSucceeds(true);
     auto r = publishAnimation("{}");
@@ -2,7 +2,6 @@
 #include <string>
 #include <vector>
 
-#include <base64.hpp>
 #include <gtest/gtest.h>
 
 #include "server/voice/DialogAnimation.h"
@@ -43,7 +42,8 @@ TEST_F(DialogAnimationTest, MusicTailExtendsAnimationWithIdleFrames) {
     ASSERT_EQ(result.getValue()->tracks.size(), 1u);
     ASSERT_EQ(result.getValue()->tracks[0].frames.size(), 10u);
 
-    const auto lastFrame = base64::from_base64(result.getValue()->tracks[0].frames.back());
+    const auto animation = result.getValue().value();
+    const auto lastFrame = animation.tracks[0].frames.back();
     ASSERT_EQ(lastFrame.size(), 2u);
     EXPECT_EQ(static_cast<uint8_t>(lastFrame[0]), 0u);
     EXPECT_EQ(static_cast<uint8_t>(lastFrame[1]), 9u);
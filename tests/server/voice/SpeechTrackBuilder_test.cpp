@@ -1,8 +1,8 @@
 #include <cstdint>
+#include <span>
 #include <string>
 #include <vector>
 
-#include <base64.hpp>
 #include <gtest/gtest.h>
 
 #include "server/voice/SpeechTrackBuilder.h"
@@ -11,13 +11,10 @@ namespace creatures::voice {
 
 namespace {
 
-// Decode a base64-encoded track frame back into bytes. Used in expectations
-// to inspect what the builder actually emitted (which mouth byte landed
-// where, which base frame got cycled in, etc.).
-std::vector<uint8_t> decode(const std::string &encoded) {
-    const std::string raw = base64::from_base64(encoded);
-    return std::vector<uint8_t>(raw.begin(), raw.end());
-}
+// Copy a track frame out into bytes. Used in expectations to inspect what
+// the builder actually emitted (which mouth byte landed where, which base
+// frame got cycled in, etc.).
+std::vector<uint8_t> decode(std::span<const uint8_t> frame) { return std::vector<uint8_t>(frame.begin(), frame.end()); }
 
 // Three distinct 6-byte base frames so we can tell which one cycled in.
 const std::vector<std::vector<uint8_t>> &baseFramesABC() {
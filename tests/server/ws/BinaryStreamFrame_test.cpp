@@ -0,0 +1,151 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <oatpp/core/Types.hpp>
+
+#include "server/ws/messaging/BinaryStreamFrame.h"
+#include "server/ws/messaging/StreamBindingCommandDTO.h"
+
+namespace creatures ::ws {
+
+namespace {
+
+std::vector<uint8_t> encode(uint8_t slot, universe_t universe, uint32_t sequence,
+                            const std::vector<uint8_t> &channels) {
+    const auto message = writeBinaryStreamFrame(BinaryStreamFrame{slot, universe, sequence, channels});
+    EXPECT_TRUE(message.isSuccess());
+    return message.getValue().value_or(std::vector<uint8_t>{});
+}
+
+oatpp::Object<StreamSlotDto> makeSlot(uint32_t slot, const std::string &creatureId) {
+    auto dto = StreamSlotDto::createShared();
+    dto->slot = slot;
+    dto->creature_id = creatureId;
+    return dto;
+}
+
+oatpp::Object<StreamBindingPayloadDto> makePayload(std::initializer_list<oatpp::Object<StreamSlotDto>> slots) {
+    auto payload = StreamBindingPayloadDto::createShared();
+    payload->slots = oatpp::List<oatpp::Object<StreamSlotDto>>::createShared();
+    for (const auto &slot : slots) {
+        payload->slots->push_back(slot);
+    }
+    return payload;
+}
+
+TEST(BinaryStreamFrame, HeaderIsBigEndian) {
+    const auto message = encode(7, 0x0102, 0x0A0B0C0D, {0x7F, 0x80});
+
+    const std::vector<uint8_t> expected = {binaryStreamFrameVersion, 7, 0x01, 0x02, 0x0A, 0x0B, 0x0C, 0x0D, 0x7F, 0x80};
+    EXPECT_EQ(message, expected);
+}
+
+TEST(BinaryStreamFrame, ReadsBackWhatWasWritten) {
+    const std::vector<uint8_t> channels = {1, 2, 3, 250, 251, 252};
+    const auto message = encode(3, 42, 123456, channels);
+
+    const auto frame = readBinaryStreamFrame(message);
+    ASSERT_TRUE(frame.isSuccess());
+    EXPECT_EQ(frame.getValue()->slot, 3);
+    EXPECT_EQ(frame.getValue()->universe, 42U);
+    EXPECT_EQ(frame.getValue()->sequence, 123456U);
+    EXPECT_EQ(std::vector<uint8_t>(frame.getValue()->channels.begin(), frame.getValue()->channels.end()), channels);
+
+    // The channels are read in place, not copied
+    EXPECT_EQ(frame.getValue()->channels.data(), message.data() + binaryStreamFrameHeaderSize);
+}
+
+TEST(BinaryStreamFrame, TurnsAwayMessagesThatArentFrames) {
+    const std::vector<uint8_t> headerOnly = {binaryStreamFrameVersion, 0, 0, 1, 0, 0, 0, 1};
+    EXPECT_FALSE(readBinaryStreamFrame(headerOnly).isSuccess());
+    EXPECT_FALSE(readBinaryStreamFrame({}).isSuccess());
+
+    auto message = encode(0, 1, 1, {1, 2, 3});
+    message[0] = binaryStreamFrameVersion + 1;
+    const auto wrongVersion = readBinaryStreamFrame(message);
+    ASSERT_FALSE(wrongVersion.isSuccess());
+    EXPECT_EQ(wrongVersion.getError()->getCode(), ServerError::InvalidData);
+
+    std::vector<uint8_t> tooLong(binaryStreamFrameHeaderSize + binaryStreamFrameMaxChannels + 1);
+    tooLong[0] = binaryStreamFrameVersion;
+    EXPECT_FALSE(readBinaryStreamFrame(tooLong).isSuccess());
+
+    const std::vector<uint8_t> channels = {1};
+    EXPECT_FALSE(writeBinaryStreamFrame(BinaryStreamFrame{0, 70000, 1, channels}).isSuccess());
+}
+
+TEST(StreamSlots, NothingIsBoundUntilTheClientAsks) {
+    StreamSlots slots;
+
+    EXPECT_FALSE(slots.isEnabled());
+    EXPECT_EQ(slots.creatureIn(0), nullptr);
+    EXPECT_FALSE(slots.accept(0, 1));
+}
+
+TEST(StreamSlots, BindingReplacesWhatWasThere) {
+    StreamSlots slots;
+    slots.bind({{0, "beaky"}, {255, "mango"}});
+
+    EXPECT_TRUE(slots.isEnabled());
+    ASSERT_NE(slots.creatureIn(0), nullptr);
+    EXPECT_EQ(*slots.creatureIn(0), "beaky");
+    EXPECT_EQ(*slots.creatureIn(255), "mango");
+    EXPECT_EQ(slots.creatureIn(1), nullptr);
+
+    slots.bind({{1, "mango"}});
+    EXPECT_EQ(slots.creatureIn(0), nullptr);
+    EXPECT_EQ(*slots.creatureIn(1), "mango");
+
+    slots.bind({});
+    EXPECT_FALSE(slots.isEnabled());
+    EXPECT_EQ(slots.creatureIn(1), nullptr);
+}
+
+TEST(StreamSlots, DropsFramesThatArentNewer) {
+    StreamSlots slots;
+    slots.bind({{0, "beaky"}});
+
+    EXPECT_TRUE(slots.accept(0, 10));
+    EXPECT_TRUE(slots.accept(0, 12));
+    EXPECT_FALSE(slots.accept(0, 12));
+    EXPECT_FALSE(slots.accept(0, 11));
+
+    // Binding again starts over
+    slots.bind({{0, "beaky"}});
+    EXPECT_TRUE(slots.accept(0, 5));
+
+    // ...and the sequence number can wrap around
+    slots.bind({{0, "beaky"}});
+    EXPECT_TRUE(slots.accept(0, 0xFFFFFFFF));
+    EXPECT_TRUE(slots.accept(0, 0));
+    EXPECT_FALSE(slots.accept(0, 0xFFFFFFFF));
+}
+
+TEST(StreamSlots, TurnsABindingMessageIntoSlots) {
+    const auto bindings = streamSlotsFromDto(makePayload({makeSlot(0, "beaky"), makeSlot(9, "mango")}));
+
+    ASSERT_TRUE(bindings.isSuccess());
+    ASSERT_EQ(bindings.getValue()->size(), 2U);
+    EXPECT_EQ(bindings.getValue()->back().first, 9);
+    EXPECT_EQ(bindings.getValue()->back().second, "mango");
+
+    const auto off = streamSlotsFromDto(makePayload({}));
+    ASSERT_TRUE(off.isSuccess());
+    EXPECT_TRUE(off.getValue()->empty());
+}
+
+TEST(StreamSlots, TurnsAwayBindingsThatDontMakeSense) {
+    EXPECT_FALSE(streamSlotsFromDto(nullptr).isSuccess());
+    EXPECT_FALSE(streamSlotsFromDto(StreamBindingPayloadDto::createShared()).isSuccess());
+    EXPECT_FALSE(streamSlotsFromDto(makePayload({makeSlot(256, "beaky")})).isSuccess());
+    EXPECT_FALSE(streamSlotsFromDto(makePayload({makeSlot(1, "")})).isSuccess());
+    EXPECT_FALSE(streamSlotsFromDto(makePayload({makeSlot(1, "beaky"), makeSlot(1, "mango")})).isSuccess());
+    EXPECT_FALSE(streamSlotsFromDto(makePayload({StreamSlotDto::createShared()})).isSuccess());
+}
+
+} // namespace
+
+} // namespace creatures::ws
@@ -0,0 +1,307 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+#include "server/ws/dto/websocket/MessageTypes.h"
+#include "server/ws/websocket/ClientOutbox.h"
+
+namespace creatures ::ws {
+
+namespace {
+
+using namespace std::chrono_literals;
+
+std::string makeMessage(MessageType type, size_t number) {
+    return fmt::format(R"({{"command":"{}","payload":{{"number":{}}}}})", toString(type), number);
+}
+
+std::shared_ptr<const std::string> shared(std::string message) {
+    return std::make_shared<const std::string>(std::move(message));
+}
+
+// A websocket client that can be made to stop reading, like a console on bad Wi-Fi
+class FakeClient {
+  public:
+    explicit FakeClient(bool stalled) : stalled_(stalled) {}
+
+    bool send(ClientOutbox::Frame frame, const std::shared_ptr<const std::string> &payload) {
+        std::unique_lock lock(mutex_);
+        changed_.wait(lock, [this] { return !stalled_ || hungUp_; });
+        if (hungUp_) {
+            return false;
+        }
+        buffers_.push_back(payload.get());
+        if (frame == ClientOutbox::Frame::Ping) {
+            received_.push_back("<ping>");
+        } else if (frame == ClientOutbox::Frame::Pong) {
+            received_.push_back("<pong " + *payload + ">");
+        } else {
+            received_.push_back(*payload);
+        }
+        changed_.notify_all();
+        return true;
+    }
+
+    void hangUp() {
+        std::lock_guard lock(mutex_);
+        hungUp_ = true;
+        changed_.notify_all();
+    }
+
+    void unstall() {
+        std::lock_guard lock(mutex_);
+        stalled_ = false;
+        changed_.notify_all();
+    }
+
+    bool waitFor(const std::function<bool(const std::vector<std::string> &)> &done) {
+        std::unique_lock lock(mutex_);
+        return changed_.wait_for(lock, 5s, [&] { return done(received_); });
+    }
+
+    std::vector<std::string> received() {
+        std::lock_guard lock(mutex_);
+        return received_;
+    }
+
+    std::vector<const std::string *> buffers() {
+        std::lock_guard lock(mutex_);
+        return buffers_;
+    }
+
+    bool hungUp() {
+        std::lock_guard lock(mutex_);
+        return hungUp_;
+    }
+
+    std::unique_ptr<ClientOutbox> makeOutbox(int64_t clientId, size_t capacity) {
+        return std::make_unique<ClientOutbox>(
+            clientId, capacity,
+            [this](ClientOutbox::Frame frame, const std::shared_ptr<const std::string> &payload) {
+                return send(frame, payload);
+            },
+            [this] { hangUp(); });
+    }
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    bool stalled_;
+    bool hungUp_{false};
+    std::vector<std::string> received_;
+    std::vector<const std::string *> buffers_;
+};
+
+// Block the client on its first message, so the rest pile up behind it
+void stallOnFirstMessage(FakeClient &client, ClientOutbox &outbox) {
+    ASSERT_EQ(outbox.offer(MessageType::Notice, shared("first")), ClientOutbox::Offer::Queued);
+    const auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (outbox.depth() != 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(1ms);
+    }
+    ASSERT_EQ(outbox.depth(), 0U);
+    ASSERT_TRUE(client.received().empty());
+}
+
+TEST(MessageTypes, ReadsTheTypeFromTheCommand) {
+    EXPECT_EQ(messageTypeOf(makeMessage(MessageType::ServerCounters, 1)), MessageType::ServerCounters);
+    EXPECT_EQ(messageTypeOf(R"({ "command" : "log", "payload": {}})"), MessageType::LogMessage);
+    EXPECT_EQ(messageTypeOf(R"({"command":"no-such-thing"})"), std::nullopt);
+    EXPECT_EQ(messageTypeOf("not json at all"), std::nullopt);
+}
+
+TEST(ClientOutbox, KeepsOnlyTheLatestCounters) {
+    FakeClient client(true);
+    auto outbox = client.makeOutbox(1, 8);
+    outbox->start();
+    stallOnFirstMessage(client, *outbox);
+
+    const auto counters = makeMessage(MessageType::ServerCounters, 3);
+    EXPECT_EQ(outbox->offer(MessageType::ServerCounters, shared(makeMessage(MessageType::ServerCounters, 1))),
+              ClientOutbox::Offer::Queued);
+    EXPECT_EQ(outbox->offer(MessageType::JobProgress, shared("job")), ClientOutbox::Offer::Queued);
+    EXPECT_EQ(outbox->offer(MessageType::ServerCounters, shared(makeMessage(MessageType::ServerCounters, 2))),
+              ClientOutbox::Offer::Coalesced);
+    EXPECT_EQ(outbox->offer(MessageType::ServerCounters, shared(counters)), ClientOutbox::Offer::Coalesced);
+    EXPECT_EQ(outbox->depth(), 2U);
+
+    client.unstall();
+    ASSERT_TRUE(client.waitFor([](const auto &received) { return received.size() == 3; }));
+    EXPECT_EQ(client.received(), (std::vector<std::string>{"first", counters, "job"}));
+}
+
+TEST(ClientOutbox, LogsPushOutTheOldestLog) {
+    FakeClient client(true);
+    auto outbox = client.makeOutbox(1, 3);
+    outbox->start();
+    stallOnFirstMessage(client, *outbox);
+
+    ASSERT_EQ(outbox->offer(MessageType::LogMessage, shared("log 1")), ClientOutbox::Offer::Queued);
+    ASSERT_EQ(outbox->offer(MessageType::JobComplete, shared("done")), ClientOutbox::Offer::Queued);
+    ASSERT_EQ(outbox->offer(MessageType::LogMessage, shared("log 2")), ClientOutbox::Offer::Queued);
+    EXPECT_EQ(outbox->offer(MessageType::LogMessage, shared("log 3")), ClientOutbox::Offer::Dropped);
+    EXPECT_FALSE(outbox->isClosed());
+
+    client.unstall();
+    ASSERT_TRUE(client.waitFor([](const auto &received) { return received.size() == 4; }));
+    EXPECT_EQ(client.received(), (std::vector<std::string>{"first", "done", "log 2", "log 3"}));
+}
+
+TEST(ClientOutbox, HangsUpOnAClientThatFallsTooFarBehind) {
+    FakeClient client(true);
+    auto outbox = client.makeOutbox(1, 2);
+    outbox->start();
+    stallOnFirstMessage(client, *outbox);
+
+    ASSERT_EQ(outbox->offer(MessageType::LogMessage, shared("log")), ClientOutbox::Offer::Queued);
+    ASSERT_EQ(outbox->offer(MessageType::JobProgress, shared("job 1")), ClientOutbox::Offer::Queued);
+    EXPECT_EQ(outbox->offer(MessageType::JobProgress, shared("job 2")), ClientOutbox::Offer::Dropped);
+    EXPECT_EQ(outbox->offer(MessageType::JobProgress, shared("job 3")), ClientOutbox::Offer::TooFarBehind);
+
+    EXPECT_TRUE(client.hungUp());
+    EXPECT_TRUE(outbox->isClosed());
+    EXPECT_EQ(outbox->offer(MessageType::JobProgress, shared("job 4")), ClientOutbox::Offer::Closed);
+    outbox->stop();
+    EXPECT_TRUE(client.received().empty());
+}
+
+TEST(ClientOutbox, OnlyOnePingWaitsAtATime) {
+    FakeClient client(true);
+    auto outbox = client.makeOutbox(1, 8);
+    outbox->start();
+    stallOnFirstMessage(client, *outbox);
+
+    EXPECT_EQ(outbox->offerPing(), ClientOutbox::Offer::Queued);
+    EXPECT_EQ(outbox->offerPing(), ClientOutbox::Offer::Coalesced);
+
+    client.unstall();
+    ASSERT_TRUE(client.waitFor([](const auto &received) { return received.size() == 2; }));
+    EXPECT_EQ(client.received().back(), "<ping>");
+}
+
+TEST(ClientOutbox, PongsGoAheadOfWaitingMessages) {
+    FakeClient client(true);
+    auto outbox = client.makeOutbox(1, 8);
+    outbox->start();
+    stallOnFirstMessage(client, *outbox);
+
+    ASSERT_EQ(outbox->offer(MessageType::JobProgress, shared("job 1")), ClientOutbox::Offer::Queued);
+    EXPECT_EQ(outbox->offerPong(shared("a")), ClientOutbox::Offer::Queued);
+    EXPECT_EQ(outbox->offerPong(shared("b")), ClientOutbox::Offer::Coalesced);
+
+    client.unstall();
+    ASSERT_TRUE(client.waitFor([](const auto &received) { return received.size() == 3; }));
+    EXPECT_EQ(client.received(), (std::vector<std::string>{"first", "<pong b>", "job 1"}));
+}
+
+TEST(ClientOutbox, EveryClientSendsTheSameBuffer) {
+    FakeClient first(false);
+    FakeClient second(false);
+    auto firstOutbox = first.makeOutbox(1, 8);
+    auto secondOutbox = second.makeOutbox(2, 8);
+    firstOutbox->start();
+    secondOutbox->start();
+
+    const auto message = shared(makeMessage(MessageType::JobComplete, 1));
+    ASSERT_EQ(firstOutbox->offer(MessageType::JobComplete, message), ClientOutbox::Offer::Queued);
+    ASSERT_EQ(secondOutbox->offer(MessageType::JobComplete, message), ClientOutbox::Offer::Queued);
+
+    ASSERT_TRUE(first.waitFor([](const auto &received) { return received.size() == 1; }));
+    ASSERT_TRUE(second.waitFor([](const auto &received) { return received.size() == 1; }));
+    EXPECT_EQ(first.buffers().front(), message.get());
+    EXPECT_EQ(second.buffers().front(), message.get());
+
+    firstOutbox->stop();
+    secondOutbox->stop();
+}
+
+/*
+ * Fifty consoles connected, one of them stalled, and a steady stream of logs, counters and
+ * job updates going out to all of them the way ClientCafe broadcasts. Everyone else has to
+ * get every job update, the stalled one has to be hung up on, and broadcasting must never
+ * wait on it.
+ */
+TEST(ClientOutbox, OneStalledClientDoesntHoldUpFortyNineOthers) {
+    constexpr size_t clientCount = 50;
+    constexpr size_t stalledClient = 17;
+    constexpr size_t capacity = 64;
+    constexpr size_t messageCount = 2000;
+
+    std::vector<std::unique_ptr<FakeClient>> clients;
+    std::vector<std::unique_ptr<ClientOutbox>> outboxes;
+    for (size_t index = 0; index < clientCount; ++index) {
+        clients.push_back(std::make_unique<FakeClient>(index == stalledClient));
+        outboxes.push_back(clients.back()->makeOutbox(static_cast<int64_t>(index), capacity));
+        outboxes.back()->start();
+    }
+
+    size_t jobUpdates = 0;
+    std::string lastCounters;
+    auto slowestBroadcast = std::chrono::steady_clock::duration::zero();
+    for (size_t number = 0; number < messageCount; ++number) {
+        MessageType type = MessageType::LogMessage;
+        if (number % 10 == 6) {
+            type = MessageType::ServerCounters;
+        } else if (number % 10 == 8) {
+            type = MessageType::JobProgress;
+            ++jobUpdates;
+        }
+        const auto message = shared(makeMessage(type, number));
+        if (type == MessageType::ServerCounters) {
+            lastCounters = *message;
+        }
+
+        const auto started = std::chrono::steady_clock::now();
+        for (auto &outbox : outboxes) {
+            static_cast<void>(outbox->offer(type, message));
+        }
+        slowestBroadcast = std::max(slowestBroadcast, std::chrono::steady_clock::now() - started);
+
+        // About how fast a busy server sends them, so healthy clients can keep up
+        if (number % 16 == 0) {
+            std::this_thread::sleep_for(1ms);
+        }
+    }
+
+    EXPECT_TRUE(clients[stalledClient]->hungUp());
+    EXPECT_TRUE(outboxes[stalledClient]->isClosed());
+    EXPECT_LT(slowestBroadcast, 1s);
+
+    for (size_t index = 0; index < clientCount; ++index) {
+        if (index == stalledClient) {
+            continue;
+        }
+        ASSERT_TRUE(clients[index]->waitFor([&](const auto &received) {
+            return !received.empty() && received.back() == makeMessage(MessageType::LogMessage, messageCount - 1);
+        })) << "client " << index;
+        ASSERT_FALSE(clients[index]->hungUp()) << "client " << index;
+
+        size_t received = 0;
+        bool sawLastCounters = false;
+        for (const auto &message : clients[index]->received()) {
+            received += messageTypeOf(message) == MessageType::JobProgress ? 1 : 0;
+            sawLastCounters = sawLastCounters || message == lastCounters;
+        }
+        EXPECT_EQ(received, jobUpdates) << "client " << index;
+        EXPECT_TRUE(sawLastCounters) << "client " << index;
+    }
+
+    for (auto &outbox : outboxes) {
+        outbox->stop();
+    }
+}
+
+} // namespace
+
+} // namespace creatures::ws
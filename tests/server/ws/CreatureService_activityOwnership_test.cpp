@@ -23,7 +23,8 @@ class ActivityOwnershipTest : public ::testing::Test {
   protected:
     void SetUp() override {
         creatures::observability = std::make_shared<creatures::ObservabilityManager>();
-        creatures::websocketOutgoingMessages = std::make_shared<moodycamel::BlockingConcurrentQueue<std::string>>();
+        creatures::websocketOutgoingMessages =
+            std::make_shared<moodycamel::BlockingConcurrentQueue<creatures::ws::OutgoingMessage>>();
     }
 
     void TearDown() override {
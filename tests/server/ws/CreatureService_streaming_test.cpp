@@ -17,7 +17,8 @@ class CreatureServiceStreamingTest : public ::testing::Test {
     void SetUp() override {
         // Reset globals used by CreatureService
         creatures::observability = std::make_shared<creatures::ObservabilityManager>();
-        creatures::websocketOutgoingMessages = std::make_shared<moodycamel::BlockingConcurrentQueue<std::string>>();
+        creatures::websocketOutgoingMessages =
+            std::make_shared<moodycamel::BlockingConcurrentQueue<creatures::ws::OutgoingMessage>>();
     }
 
     void TearDown() override {
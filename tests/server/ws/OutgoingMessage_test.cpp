@@ -0,0 +1,85 @@
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <oatpp/core/Types.hpp>
+
+#include "model/Notice.h"
+#include "server/metrics/counters.h"
+#include "server/ws/dto/websocket/MessageTypes.h"
+#include "server/ws/dto/websocket/NoticeMessage.h"
+#include "server/ws/websocket/OutgoingMessage.h"
+
+#include "../TestGlobals.h"
+
+namespace creatures ::ws {
+
+namespace {
+
+oatpp::Object<NoticeMessage> makeNotice(const std::string &text) {
+    auto payload = NoticeDto::createShared();
+    payload->timestamp = "2026-10-17T12:00:00Z";
+    payload->message = text;
+
+    auto message = NoticeMessage::createShared();
+    message->command = toString(MessageType::Notice);
+    message->payload = payload;
+    return message;
+}
+
+uint64_t noticesSerialized() {
+    return metrics->getWebsocketSerializationTimes()[static_cast<std::size_t>(MessageType::Notice)].totalCount();
+}
+
+class OutgoingMessageTest : public ::testing::Test {
+  protected:
+    void SetUp() override { metrics = std::make_shared<SystemCounters>(); }
+    void TearDown() override { metrics.reset(); }
+};
+
+TEST_F(OutgoingMessageTest, SerializesOnceAndCountsTheTime) {
+    const auto outgoing = serializeForClients(MessageType::Notice, makeNotice("hello"));
+
+    ASSERT_NE(outgoing.json, nullptr);
+    EXPECT_EQ(outgoing.type, MessageType::Notice);
+    EXPECT_EQ(messageTypeOf(*outgoing.json), MessageType::Notice);
+    EXPECT_NE(outgoing.json->find("hello"), std::string::npos);
+    EXPECT_EQ(noticesSerialized(), 1U);
+}
+
+TEST_F(OutgoingMessageTest, PassesAlongAClientsMessageWithoutCopyingIt) {
+    const oatpp::String report = R"({"command":"board-sensor-report","payload":{}})";
+    const auto outgoing = outgoingMessageFrom(MessageType::BoardSensorReport, report);
+
+    EXPECT_EQ(outgoing.json.get(), report.get());
+    EXPECT_EQ(noticesSerialized(), 0U);
+}
+
+TEST_F(OutgoingMessageTest, EveryThreadCanSerializeAtOnce) {
+    constexpr size_t threadCount = 8;
+    constexpr size_t messagesPerThread = 200;
+
+    std::vector<std::thread> threads;
+    for (size_t thread = 0; thread < threadCount; ++thread) {
+        threads.emplace_back([thread] {
+            for (size_t number = 0; number < messagesPerThread; ++number) {
+                const auto text = std::to_string(thread) + "/" + std::to_string(number);
+                const auto outgoing = serializeForClients(MessageType::Notice, makeNotice(text));
+                EXPECT_NE(outgoing.json->find(text), std::string::npos);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(noticesSerialized(), threadCount * messagesPerThread);
+}
+
+} // namespace
+
+} // namespace creatures::ws
@@ -0,0 +1,112 @@
+#include <chrono>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "server/ws/messaging/StreamingContexts.h"
+
+namespace creatures ::ws {
+
+namespace {
+
+const auto kStartedAt = std::chrono::steady_clock::time_point(std::chrono::seconds(10));
+
+TEST(StreamingContexts, NothingIsStreamingAtFirst) {
+    StreamingContexts contexts;
+
+    EXPECT_EQ(contexts.size(), 0U);
+    EXPECT_EQ(contexts.find("beaky"), nullptr);
+    EXPECT_EQ(contexts.findCurrent("beaky", 1), nullptr);
+}
+
+TEST(StreamingContexts, FindsTheContextForItsUniverse) {
+    StreamingContexts contexts;
+    const auto opened = contexts.open("beaky", 1, 40, 32, contexts.currentGeneration(), kStartedAt, 100);
+
+    const auto found = contexts.findCurrent("beaky", 1);
+    ASSERT_EQ(found, opened);
+    EXPECT_EQ(found->channelOffset, 40U);
+    EXPECT_EQ(found->startedAt, kStartedAt);
+    EXPECT_EQ(found->deadline.load(), 100U);
+
+    // The console moved the creature to another universe, so it has to take the long way
+    EXPECT_EQ(contexts.findCurrent("beaky", 2), nullptr);
+    EXPECT_EQ(contexts.findCurrent("mango", 1), nullptr);
+}
+
+TEST(StreamingContexts, InvalidatingSendsEveryoneTheLongWay) {
+    StreamingContexts contexts;
+    const auto generation = contexts.currentGeneration();
+    contexts.open("beaky", 1, 40, 32, generation, kStartedAt, 100);
+
+    contexts.invalidate();
+    EXPECT_EQ(contexts.findCurrent("beaky", 1), nullptr);
+
+    // ...but it's still there for the timeout to find
+    ASSERT_NE(contexts.find("beaky"), nullptr);
+    EXPECT_EQ(contexts.size(), 1U);
+
+    // Something resolved before the change landed stays stale
+    contexts.open("beaky", 1, 40, 32, generation, kStartedAt, 100);
+    EXPECT_EQ(contexts.findCurrent("beaky", 1), nullptr);
+
+    contexts.open("beaky", 1, 48, 32, contexts.currentGeneration(), kStartedAt, 100);
+    ASSERT_NE(contexts.findCurrent("beaky", 1), nullptr);
+    EXPECT_EQ(contexts.findCurrent("beaky", 1)->channelOffset, 48U);
+}
+
+TEST(StreamingContexts, OpeningAgainReplacesTheContext) {
+    StreamingContexts contexts;
+    const auto first = contexts.open("beaky", 1, 40, 32, contexts.currentGeneration(), kStartedAt, 100);
+    const auto second = contexts.open("beaky", 2, 40, 32, contexts.currentGeneration(), kStartedAt, 200);
+
+    EXPECT_EQ(contexts.size(), 1U);
+    EXPECT_EQ(contexts.findCurrent("beaky", 1), nullptr);
+    EXPECT_EQ(contexts.findCurrent("beaky", 2), second);
+
+    // Whoever still holds the old one can keep using it
+    EXPECT_EQ(first->universe, 1U);
+}
+
+TEST(StreamingContexts, ClosingLeavesANewerContextAlone) {
+    StreamingContexts contexts;
+    const auto first = contexts.open("beaky", 1, 40, 32, contexts.currentGeneration(), kStartedAt, 100);
+    const auto second = contexts.open("beaky", 2, 40, 32, contexts.currentGeneration(), kStartedAt, 200);
+
+    EXPECT_FALSE(contexts.close(first));
+    EXPECT_EQ(contexts.find("beaky"), second);
+
+    EXPECT_TRUE(contexts.close(second));
+    EXPECT_EQ(contexts.find("beaky"), nullptr);
+    EXPECT_EQ(contexts.size(), 0U);
+
+    EXPECT_FALSE(contexts.close(second));
+}
+
+TEST(StreamingContexts, AFrameThatExtendsFirstKeepsTheContextOpen) {
+    StreamingContexts contexts;
+    const auto context = contexts.open("beaky", 1, 40, 32, contexts.currentGeneration(), kStartedAt, 100);
+
+    // The timeout saw 100 go by, but a frame pushed it out before the timeout could claim it
+    const auto checked = context->deadline.load();
+    EXPECT_TRUE(context->extend(150));
+    EXPECT_FALSE(context->expire(checked));
+    EXPECT_FALSE(context->isClosed());
+    EXPECT_EQ(context->deadline.load(), 150U);
+
+    EXPECT_TRUE(context->expire(150));
+    EXPECT_TRUE(context->isClosed());
+}
+
+TEST(StreamingContexts, AnExpiredContextCantBeExtended) {
+    StreamingContexts contexts;
+    const auto context = contexts.open("beaky", 1, 40, 32, contexts.currentGeneration(), kStartedAt, 100);
+
+    ASSERT_TRUE(context->expire(100));
+    EXPECT_FALSE(context->extend(150));
+    EXPECT_TRUE(context->isClosed());
+}
+
+} // namespace
+
+} // namespace creatures::ws
@@ -0,0 +1,200 @@
+#include <optional>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <oatpp/core/Types.hpp>
+
+#include "model/LogLevel.h"
+#include "server/ws/dto/websocket/MessageTypes.h"
+#include "server/ws/messaging/SubscriptionCommandDTO.h"
+#include "server/ws/websocket/TopicSubscriptions.h"
+
+namespace creatures ::ws {
+
+namespace {
+
+MessageTopic topicFor(MessageType type) { return MessageTopic{type, std::nullopt, std::nullopt, std::nullopt}; }
+
+MessageTopic creatureTopic(MessageType type, const std::string &creatureId) {
+    auto topic = topicFor(type);
+    topic.creatureId = creatureId;
+    return topic;
+}
+
+MessageTopic logTopic(LogLevel level) {
+    auto topic = topicFor(MessageType::LogMessage);
+    topic.logLevel = level;
+    return topic;
+}
+
+oatpp::Object<TopicDto> makeTopicDto(const std::string &type) {
+    auto topic = TopicDto::createShared();
+    topic->type = type;
+    return topic;
+}
+
+oatpp::Object<SubscriptionPayloadDto> makePayload(const oatpp::Object<TopicDto> &topic) {
+    auto payload = SubscriptionPayloadDto::createShared();
+    payload->topics = oatpp::List<oatpp::Object<TopicDto>>::createShared();
+    payload->topics->push_back(topic);
+    return payload;
+}
+
+TEST(TopicSubscriptions, ClientsGetEverythingUntilTheySubscribe) {
+    TopicSubscriptions subscriptions;
+
+    EXPECT_FALSE(subscriptions.isSelective());
+    EXPECT_TRUE(subscriptions.wants(topicFor(MessageType::ServerCounters)));
+    EXPECT_TRUE(subscriptions.wants(logTopic(LogLevel::trace)));
+    EXPECT_TRUE(subscriptions.wants(MessageTopic{}));
+    EXPECT_FALSE(subscriptions.needsDetails(MessageType::LogMessage));
+    EXPECT_EQ(subscriptions.lowestLogLevel(), LogLevel::trace);
+}
+
+TEST(TopicSubscriptions, SubscribingNarrowsItDown) {
+    TopicSubscriptions subscriptions;
+    subscriptions.subscribe(MessageType::JobProgress, {});
+
+    EXPECT_TRUE(subscriptions.isSelective());
+    EXPECT_TRUE(subscriptions.wants(topicFor(MessageType::JobProgress)));
+    EXPECT_FALSE(subscriptions.wants(topicFor(MessageType::ServerCounters)));
+    EXPECT_FALSE(subscriptions.wants(MessageTopic{}));
+    EXPECT_FALSE(subscriptions.wantsAny(MessageType::LogMessage));
+    EXPECT_FALSE(subscriptions.needsDetails(MessageType::JobProgress));
+    EXPECT_EQ(subscriptions.lowestLogLevel(), std::nullopt);
+}
+
+TEST(TopicSubscriptions, FiltersOnTheCreature) {
+    TopicSubscriptions subscriptions;
+    subscriptions.subscribe(MessageType::CreatureActivity, TopicFilter{"beaky", std::nullopt, std::nullopt});
+
+    EXPECT_TRUE(subscriptions.needsDetails(MessageType::CreatureActivity));
+    EXPECT_TRUE(subscriptions.wants(creatureTopic(MessageType::CreatureActivity, "beaky")));
+    EXPECT_FALSE(subscriptions.wants(creatureTopic(MessageType::CreatureActivity, "mango")));
+    EXPECT_FALSE(subscriptions.wants(topicFor(MessageType::CreatureActivity)));
+
+    // A second subscription to the same type widens it
+    subscriptions.subscribe(MessageType::CreatureActivity, TopicFilter{"mango", std::nullopt, std::nullopt});
+    EXPECT_TRUE(subscriptions.wants(creatureTopic(MessageType::CreatureActivity, "mango")));
+
+    // ...and one without a filter takes every creature, so the details don't matter
+    subscriptions.subscribe(MessageType::CreatureActivity, {});
+    EXPECT_FALSE(subscriptions.needsDetails(MessageType::CreatureActivity));
+    EXPECT_TRUE(subscriptions.wants(topicFor(MessageType::CreatureActivity)));
+}
+
+TEST(TopicSubscriptions, FiltersOnTheUniverse) {
+    TopicSubscriptions subscriptions;
+    subscriptions.subscribe(MessageType::PlaylistStatus, TopicFilter{std::nullopt, 3, std::nullopt});
+
+    auto topic = topicFor(MessageType::PlaylistStatus);
+    topic.universe = 3;
+    EXPECT_TRUE(subscriptions.wants(topic));
+    topic.universe = 4;
+    EXPECT_FALSE(subscriptions.wants(topic));
+}
+
+TEST(TopicSubscriptions, FiltersLogsOnTheirLevel) {
+    TopicSubscriptions subscriptions;
+    subscriptions.subscribe(MessageType::LogMessage, TopicFilter{std::nullopt, std::nullopt, LogLevel::warn});
+
+    EXPECT_FALSE(subscriptions.wants(logTopic(LogLevel::info)));
+    EXPECT_TRUE(subscriptions.wants(logTopic(LogLevel::warn)));
+    EXPECT_TRUE(subscriptions.wants(logTopic(LogLevel::critical)));
+    EXPECT_EQ(subscriptions.lowestLogLevel(), LogLevel::warn);
+}
+
+TEST(TopicSubscriptions, UnsubscribingDropsEveryFilterForTheType) {
+    TopicSubscriptions subscriptions;
+    subscriptions.subscribe(MessageType::CreatureActivity, TopicFilter{"beaky", std::nullopt, std::nullopt});
+    subscriptions.subscribe(MessageType::CreatureActivity, TopicFilter{"mango", std::nullopt, std::nullopt});
+    subscriptions.subscribe(MessageType::Notice, {});
+
+    subscriptions.unsubscribe(MessageType::CreatureActivity);
+    EXPECT_FALSE(subscriptions.wantsAny(MessageType::CreatureActivity));
+    EXPECT_TRUE(subscriptions.wants(topicFor(MessageType::Notice)));
+
+    // Unsubscribing from everything leaves a client that gets nothing, not the firehose
+    subscriptions.unsubscribe(MessageType::Notice);
+    EXPECT_TRUE(subscriptions.isSelective());
+    EXPECT_FALSE(subscriptions.wants(topicFor(MessageType::Notice)));
+}
+
+TEST(TopicInterest, PublishesWhatAnyClientWants) {
+    TopicSubscriptions counters;
+    counters.subscribe(MessageType::ServerCounters, {});
+
+    TopicSubscriptions warnings;
+    warnings.subscribe(MessageType::LogMessage, TopicFilter{std::nullopt, std::nullopt, LogLevel::warn});
+
+    TopicInterest interest;
+    interest.include(counters);
+    interest.include(warnings);
+    interest.publish();
+
+    EXPECT_TRUE(anyoneSubscribedTo(MessageType::ServerCounters));
+    EXPECT_TRUE(anyoneSubscribedTo(MessageType::LogMessage));
+    EXPECT_FALSE(anyoneSubscribedTo(MessageType::VirtualStatusLights));
+    EXPECT_FALSE(anyoneSubscribedToLogsAt(LogLevel::debug));
+    EXPECT_TRUE(anyoneSubscribedToLogsAt(LogLevel::error));
+
+    // A client that's never subscribed brings everything back
+    TopicSubscriptions firehose;
+    interest.include(firehose);
+    interest.publish();
+    EXPECT_TRUE(anyoneSubscribedTo(MessageType::VirtualStatusLights));
+    EXPECT_TRUE(anyoneSubscribedToLogsAt(LogLevel::trace));
+
+    // ...and with nobody connected, nothing's wanted
+    TopicInterest{}.publish();
+    EXPECT_FALSE(anyoneSubscribedTo(MessageType::Notice));
+    EXPECT_FALSE(anyoneSubscribedToLogsAt(LogLevel::critical));
+}
+
+TEST(TopicSubscriptions, ReadsTheDetailsOutOfAMessage) {
+    auto activity = topicFor(MessageType::CreatureActivity);
+    addTopicDetails(activity, R"({"command":"creature-activity","payload":{"creature_id":"beaky","state":"idle"}})");
+    EXPECT_EQ(activity.creatureId, "beaky");
+
+    auto log = topicFor(MessageType::LogMessage);
+    addTopicDetails(log, R"({"command":"log","payload":{"level":"error","message":"oh no"}})");
+    EXPECT_EQ(log.logLevel, LogLevel::error);
+
+    auto playlist = topicFor(MessageType::PlaylistStatus);
+    addTopicDetails(playlist, R"({"command":"playlist-status","payload":{"universe":2,"playing":true}})");
+    EXPECT_EQ(playlist.universe, 2U);
+
+    auto junk = topicFor(MessageType::Notice);
+    addTopicDetails(junk, "not json at all");
+    EXPECT_EQ(junk.creatureId, std::nullopt);
+}
+
+TEST(TopicSubscriptions, TurnsTopicsIntoRequests) {
+    auto topic = makeTopicDto("log");
+    topic->log_level = "warning";
+    const auto requests = topicRequestsFromDto(makePayload(topic));
+
+    ASSERT_TRUE(requests.isSuccess());
+    ASSERT_EQ(requests.getValue()->size(), 1U);
+    EXPECT_EQ(requests.getValue()->front().type, MessageType::LogMessage);
+    EXPECT_EQ(requests.getValue()->front().filter.minimumLogLevel, LogLevel::warn);
+}
+
+TEST(TopicSubscriptions, TurnsAwayTopicsThatDontMakeSense) {
+    EXPECT_FALSE(topicRequestsFromDto(nullptr).isSuccess());
+    EXPECT_FALSE(topicRequestsFromDto(SubscriptionPayloadDto::createShared()).isSuccess());
+    EXPECT_FALSE(topicRequestsFromDto(makePayload(TopicDto::createShared())).isSuccess());
+
+    const auto unknown = topicRequestsFromDto(makePayload(makeTopicDto("no-such-thing")));
+    ASSERT_FALSE(unknown.isSuccess());
+    EXPECT_EQ(unknown.getError()->getCode(), ServerError::InvalidData);
+
+    auto topic = makeTopicDto("log");
+    topic->log_level = "loud";
+    EXPECT_FALSE(topicRequestsFromDto(makePayload(topic)).isSuccess());
+}
+
+} // namespace
+
+} // namespace creatures::ws
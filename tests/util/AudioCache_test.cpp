@@ -1,5 +1,7 @@
+#include <array>
 #include <filesystem>
 #include <fstream>
+#include <memory>
 #include <string>
 #include <thread>
 #include <vector>
@@ -35,15 +37,24 @@ class AudioCacheTest : public ::testing::Test {
     }
 
     static AudioCache::CachedAudioData makeAudioData(uint8_t marker) {
-        AudioCache::CachedAudioData data{};
-        data.framesPerChannel = 2;
+        auto frames = std::make_shared<OpusFrameArena>(2);
         for (uint8_t channel = 0; channel < RTP_STREAMING_CHANNELS; ++channel) {
-            data.encodedFrames[channel] = {
-                {marker, channel, 0},
-                {marker, channel, 1},
-            };
+            const std::array<uint8_t, 3> first{marker, channel, 0};
+            const std::array<uint8_t, 4> second{marker, channel, 1, 1};
+            frames->set(channel, 0, first);
+            frames->set(channel, 1, second, channel % 2 == 1); // some silent, so the flags round-trip too
         }
-        return data;
+        return AudioCache::CachedAudioData{2, frames};
+    }
+
+    std::vector<fs::path> cacheFiles() const {
+        std::vector<fs::path> files;
+        for (const auto &entry : fs::recursive_directory_iterator(root_ / ".opus_cache")) {
+            if (entry.path().extension() == ".opuscache") {
+                files.push_back(entry.path());
+            }
+        }
+        return files;
     }
 
     fs::path root_;
@@ -60,7 +71,7 @@ TEST_F(AudioCacheTest, RoundTripsVersionedPacketData) {
     const auto loaded = cache.tryLoadFromCache(source.string());
     ASSERT_NE(loaded, nullptr);
     EXPECT_EQ(loaded->framesPerChannel, expected.framesPerChannel);
-    EXPECT_EQ(loaded->encodedFrames, expected.encodedFrames);
+    EXPECT_EQ(*loaded->frames, *expected.frames);
 }
 
 TEST_F(AudioCacheTest, SameBasenameInDifferentDirectoriesDoesNotCollide) {
@@ -77,15 +88,15 @@ TEST_F(AudioCacheTest, SameBasenameInDifferentDirectoriesDoesNotCollide) {
     const auto secondLoaded = cache.tryLoadFromCache(secondSource.string());
     ASSERT_NE(firstLoaded, nullptr);
     ASSERT_NE(secondLoaded, nullptr);
-    EXPECT_EQ(firstLoaded->encodedFrames, firstData.encodedFrames);
-    EXPECT_EQ(secondLoaded->encodedFrames, secondData.encodedFrames);
+    EXPECT_EQ(*firstLoaded->frames, *firstData.frames);
+    EXPECT_EQ(*secondLoaded->frames, *secondData.frames);
 }
 
-TEST_F(AudioCacheTest, RejectsMismatchedChannelFrameCounts) {
+TEST_F(AudioCacheTest, RejectsMismatchedFrameCounts) {
     const auto source = writeSource("inconsistent.wav", "source-audio");
     AudioCache cache(root_.string());
     auto inconsistent = makeAudioData(0x33);
-    inconsistent.encodedFrames[7].pop_back();
+    inconsistent.framesPerChannel = 3;
 
     const auto saveResult = cache.saveToCache(source.string(), inconsistent);
 
@@ -107,7 +118,7 @@ TEST_F(AudioCacheTest, ConcurrentReadersHaveRaceFreeStatistics) {
     for (size_t index = 0; index < readerCount; ++index) {
         readers.emplace_back([&, index] {
             const auto loaded = cache.tryLoadFromCache(source.string());
-            succeeded[index] = loaded && loaded->encodedFrames == expected.encodedFrames ? 1 : 0;
+            succeeded[index] = loaded && *loaded->frames == *expected.frames ? 1 : 0;
         });
     }
     for (auto &reader : readers) {
@@ -120,5 +131,42 @@ TEST_F(AudioCacheTest, ConcurrentReadersHaveRaceFreeStatistics) {
     EXPECT_EQ(cache.getStats().cacheHits, readerCount);
 }
 
+TEST_F(AudioCacheTest, HitsAreMappedInPlace) {
+    const auto source = writeSource("mapped.wav", "mapped-source");
+    AudioCache cache(root_.string());
+    const auto expected = makeAudioData(0x55);
+    ASSERT_TRUE(cache.saveToCache(source.string(), expected).isSuccess());
+
+    const auto loaded = cache.tryLoadFromCache(source.string());
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_TRUE(loaded->frames->isView());
+    EXPECT_EQ(loaded->frames->byteSize(), RTP_STREAMING_CHANNELS * 7u);
+    EXPECT_EQ(*loaded->frames, *expected.frames);
+}
+
+TEST_F(AudioCacheTest, ChangedSourcesMiss) {
+    const auto source = writeSource("changed.wav", "original");
+    AudioCache cache(root_.string());
+    ASSERT_TRUE(cache.saveToCache(source.string(), makeAudioData(0x66)).isSuccess());
+
+    writeSource("changed.wav", "a longer replacement");
+
+    EXPECT_EQ(cache.tryLoadFromCache(source.string()), nullptr);
+    EXPECT_TRUE(cacheFiles().empty());
+}
+
+TEST_F(AudioCacheTest, DamagedFilesMiss) {
+    const auto source = writeSource("damaged.wav", "damaged-source");
+    AudioCache cache(root_.string());
+    ASSERT_TRUE(cache.saveToCache(source.string(), makeAudioData(0x77)).isSuccess());
+
+    const auto files = cacheFiles();
+    ASSERT_EQ(files.size(), 1u);
+    fs::resize_file(files.front(), fs::file_size(files.front()) - 1);
+
+    EXPECT_EQ(cache.tryLoadFromCache(source.string()), nullptr);
+    EXPECT_TRUE(cacheFiles().empty());
+}
+
 } // namespace
 } // namespace creatures::util
@@ -0,0 +1,62 @@
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <base64.hpp>
+#include <gtest/gtest.h>
+
+#include "util/Base64.h"
+
+namespace {
+
+std::vector<uint8_t> decode(const std::string &encoded) {
+    std::vector<uint8_t> out(creatures::util::base64DecodedSize(encoded).value());
+    EXPECT_TRUE(creatures::util::base64DecodeInto(encoded, out));
+    return out;
+}
+
+} // namespace
+
+TEST(Base64, DecodesEachAmountOfPadding) {
+    EXPECT_EQ(decode(""), std::vector<uint8_t>{});
+    EXPECT_EQ(decode("AQ=="), (std::vector<uint8_t>{1}));
+    EXPECT_EQ(decode("AQI="), (std::vector<uint8_t>{1, 2}));
+    EXPECT_EQ(decode("AQID"), (std::vector<uint8_t>{1, 2, 3}));
+}
+
+// Long enough strings go through the SIMD path on x86, so check it against base64.hpp
+TEST(Base64, MatchesBase64HppAtEveryLength) {
+    std::mt19937 rng(42);
+    for (std::size_t length = 0; length < 300; ++length) {
+        std::string raw(length, '\0');
+        for (auto &c : raw) {
+            c = static_cast<char>(rng());
+        }
+        const auto decoded = decode(base64::to_base64(raw));
+        EXPECT_EQ(std::string(decoded.begin(), decoded.end()), raw) << "length " << length;
+    }
+}
+
+TEST(Base64, RejectsCharactersOutsideTheAlphabet) {
+    const std::string good = base64::to_base64(std::string(64, 'x'));
+    std::vector<uint8_t> out(creatures::util::base64DecodedSize(good).value());
+
+    for (std::size_t position : {0u, 17u, 40u, 80u}) {
+        for (char bad : {'!', '-', '_', '=', '\0', static_cast<char>(0xC3)}) {
+            auto encoded = good;
+            encoded[position] = bad;
+            EXPECT_FALSE(creatures::util::base64DecodeInto(encoded, out)) << "'" << bad << "' at " << position;
+        }
+    }
+}
+
+TEST(Base64, RejectsBadLengthsAndBuffers) {
+    EXPECT_FALSE(creatures::util::base64DecodedSize("AQI").has_value());
+
+    std::vector<uint8_t> tooSmall(2);
+    EXPECT_FALSE(creatures::util::base64DecodeInto("AQID", tooSmall));
+
+    std::vector<uint8_t> one(1);
+    EXPECT_FALSE(creatures::util::base64DecodeInto("A===", one));
+}
@@ -0,0 +1,151 @@
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "util/ComputePool.h"
+
+using creatures::util::ComputePool;
+
+TEST(ComputePool, RunsEveryIndexOnce) {
+    ComputePool pool(4);
+    std::vector<std::atomic<int>> runs(1000);
+    pool.parallelFor(runs.size(), [&runs](std::size_t i) { runs[i]++; });
+
+    for (const auto &count : runs) {
+        EXPECT_EQ(count.load(), 1);
+    }
+}
+
+TEST(ComputePool, SpreadsTheWorkOverItsThreads) {
+    ComputePool pool(4);
+    std::mutex threadsMutex;
+    std::set<std::thread::id> threads;
+    std::atomic<int> started{0};
+
+    // Nobody finishes until everybody's started, so it takes all four
+    pool.parallelFor(4, [&](std::size_t) {
+        {
+            std::lock_guard lock(threadsMutex);
+            threads.insert(std::this_thread::get_id());
+        }
+        started++;
+        while (started.load() < 4) {
+            std::this_thread::yield();
+        }
+    });
+
+    EXPECT_EQ(threads.size(), 4u);
+    EXPECT_EQ(threads.count(std::this_thread::get_id()), 0u);
+}
+
+TEST(ComputePool, HandsBackTheFirstException) {
+    ComputePool pool(2);
+    std::atomic<int> finished{0};
+    EXPECT_THROW(pool.parallelFor(8,
+                                  [&finished](std::size_t i) {
+                                      finished++;
+                                      if (i == 3) {
+                                          throw std::runtime_error("channel 3 broke");
+                                      }
+                                  }),
+                 std::runtime_error);
+
+    // The rest still ran, and the pool still works
+    EXPECT_EQ(finished.load(), 8);
+    EXPECT_EQ(pool.run([] { return std::string{"still here"}; }), "still here");
+}
+
+TEST(ComputePool, WorkersCanWaitOnTheirOwnPool) {
+    // With one thread, a worker that just blocked would wait forever
+    ComputePool pool(1);
+    const auto total = pool.run([&pool] {
+        std::atomic<int> sum{0};
+        pool.parallelFor(10, [&sum](std::size_t i) { sum += static_cast<int>(i); });
+        return sum.load();
+    });
+    EXPECT_EQ(total, 45);
+}
+
+TEST(ComputePool, IdleWorkersStealFromBusyOnes) {
+    ComputePool pool(2);
+    std::atomic<int> finished{0};
+
+    // One worker queues everything on itself. Whichever task gets picked up first holds on until
+    // the rest are done, which takes both workers, so one of them has to take from the other's queue
+    pool.run([&pool, &finished] {
+        std::atomic<bool> oneIsWaiting{false};
+        pool.parallelFor(20, [&finished, &oneIsWaiting](std::size_t) {
+            if (!oneIsWaiting.exchange(true)) {
+                while (finished.load() < 19) {
+                    std::this_thread::yield();
+                }
+            }
+            finished++;
+        });
+    });
+
+    EXPECT_EQ(finished.load(), 20);
+    EXPECT_GT(pool.getStats().tasksStolen, 0u);
+}
+
+TEST(ComputePool, FinishesWhatsQueuedBeforeStopping) {
+    std::atomic<int> ran{0};
+    {
+        ComputePool pool(1);
+        for (int i = 0; i < 50; ++i) {
+            pool.submit([&ran] {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+                ran++;
+            });
+        }
+    }
+    EXPECT_EQ(ran.load(), 50);
+}
+
+TEST(ComputePool, ParsesCpuLists) {
+    EXPECT_EQ(ComputePool::parseCpuList("2-4,0,3").getValue().value(), (std::vector<int>{0, 2, 3, 4}));
+    EXPECT_EQ(ComputePool::parseCpuList("7").getValue().value(), (std::vector<int>{7}));
+
+    for (const auto *bad : {"", "4-2", "a", "1,,2", "-1", "1-", "99999"}) {
+        const auto parsed = ComputePool::parseCpuList(bad);
+        EXPECT_FALSE(parsed.isSuccess()) << bad;
+    }
+}
+
+TEST(ComputePool, NeedsAThread) { EXPECT_THROW(ComputePool(0), std::invalid_argument); }
+
+#if defined(__linux__)
+TEST(ComputePool, PinsItsWorkers) {
+    const auto allowed = ComputePool::allowedCpus();
+    ASSERT_FALSE(allowed.empty());
+
+    ComputePool pool(2, {allowed.back()});
+    const auto cpus = pool.run([] { return ComputePool::allowedCpus(); });
+    EXPECT_EQ(cpus, (std::vector<int>{allowed.back()}));
+    EXPECT_EQ(pool.getCpus(), (std::vector<int>{allowed.back()}));
+}
+
+TEST(ComputePool, PinsOtherThreads) {
+    const auto allowed = ComputePool::allowedCpus();
+    ASSERT_FALSE(allowed.empty());
+
+    std::vector<int> unpinned;
+    std::vector<int> pinned;
+    std::thread([&] {
+        EXPECT_TRUE(ComputePool::pinThisThread({}).isSuccess());
+        unpinned = ComputePool::allowedCpus();
+        EXPECT_TRUE(ComputePool::pinThisThread({allowed.front()}).isSuccess());
+        pinned = ComputePool::allowedCpus();
+    }).join();
+    EXPECT_EQ(unpinned, allowed);
+    EXPECT_EQ(pinned, (std::vector<int>{allowed.front()}));
+}
+#endif
@@ -0,0 +1,117 @@
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "util/LatencyHistogram.h"
+
+using creatures::LatencyHistogram;
+
+TEST(LatencyHistogram, BucketsCoverEveryValueExactlyOnce) {
+    EXPECT_EQ(LatencyHistogram::bucketLowest(0), 0u);
+    for (std::size_t i = 0; i < LatencyHistogram::BUCKETS; ++i) {
+        const auto lowest = LatencyHistogram::bucketLowest(i);
+        const auto highest = LatencyHistogram::bucketHighest(i);
+        ASSERT_LE(lowest, highest) << "bucket " << i;
+        EXPECT_EQ(LatencyHistogram::bucketFor(lowest), i) << "bucket " << i;
+        EXPECT_EQ(LatencyHistogram::bucketFor(highest), i) << "bucket " << i;
+        if (i + 1 < LatencyHistogram::BUCKETS) {
+            EXPECT_EQ(LatencyHistogram::bucketLowest(i + 1), highest + 1) << "bucket " << i;
+        }
+    }
+    EXPECT_EQ(LatencyHistogram::bucketHighest(LatencyHistogram::BUCKETS - 1), LatencyHistogram::MAX_VALUE);
+}
+
+TEST(LatencyHistogram, EmptyReadsAsZero) {
+    LatencyHistogram histogram;
+    const auto snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count, 0u);
+    EXPECT_EQ(snapshot.mean(), 0.0);
+    EXPECT_EQ(snapshot.valueAtPercentile(99), 0u);
+}
+
+TEST(LatencyHistogram, PercentilesAreWithinABucket) {
+    LatencyHistogram histogram;
+    for (uint64_t value = 1; value <= 100000; ++value) {
+        histogram.record(value);
+    }
+
+    const auto snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count, 100000u);
+    EXPECT_EQ(snapshot.max, 100000u);
+    EXPECT_DOUBLE_EQ(snapshot.mean(), 50000.5);
+    for (const double percentile : {1.0, 50.0, 90.0, 99.0, 99.9}) {
+        const auto exact = static_cast<double>(percentile * 1000);
+        const auto reported = static_cast<double>(snapshot.valueAtPercentile(percentile));
+        EXPECT_GE(reported, exact) << "p" << percentile;
+        EXPECT_LE(reported, exact * 1.125) << "p" << percentile;
+    }
+    EXPECT_EQ(snapshot.valueAtPercentile(100), 100000u);
+}
+
+TEST(LatencyHistogram, SinceOnlySeesNewValues) {
+    LatencyHistogram histogram;
+    for (int i = 0; i < 1000; ++i) {
+        histogram.record(10);
+    }
+    const auto before = histogram.snapshot();
+
+    for (int i = 0; i < 10; ++i) {
+        histogram.record(5000);
+    }
+    const auto interval = histogram.snapshot().since(before);
+    EXPECT_EQ(interval.count, 10u);
+    EXPECT_EQ(interval.sum, 50000u);
+    EXPECT_GE(interval.valueAtPercentile(50), 5000u);
+    EXPECT_EQ(interval.max, 5000u);
+}
+
+TEST(LatencyHistogram, HugeValuesLandInTheTopBucket) {
+    LatencyHistogram histogram;
+    histogram.record(UINT64_MAX);
+    const auto snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.buckets[LatencyHistogram::BUCKETS - 1], 1u);
+    EXPECT_EQ(snapshot.max, LatencyHistogram::MAX_VALUE);
+}
+
+TEST(LatencyHistogram, SnapshotsWhileRecordingNeverGoBackwards) {
+    LatencyHistogram histogram;
+    std::mt19937_64 rng(7);
+    uint64_t lastCount = 0;
+    for (int round = 0; round < 100; ++round) {
+        for (int i = 0; i < 100; ++i) {
+            histogram.record(rng() % 1000000);
+        }
+        const auto snapshot = histogram.snapshot();
+        EXPECT_GE(snapshot.count, lastCount);
+        EXPECT_EQ(snapshot.count, histogram.totalCount());
+        lastCount = snapshot.count;
+    }
+}
+
+TEST(LatencyHistogram, ConcurrentRecordsAreAllCounted) {
+    LatencyHistogram histogram;
+    constexpr int threadCount = 4;
+    constexpr uint64_t perThread = 20000;
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < threadCount; ++t) {
+        writers.emplace_back([&histogram, t] {
+            for (uint64_t value = 1; value <= perThread; ++value) {
+                histogram.recordConcurrent(value * static_cast<uint64_t>(t + 1));
+            }
+        });
+    }
+    for (auto &writer : writers) {
+        writer.join();
+    }
+
+    const auto snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count, threadCount * perThread);
+    EXPECT_EQ(histogram.totalCount(), threadCount * perThread);
+    EXPECT_EQ(snapshot.sum, perThread * (perThread + 1) / 2 * (threadCount * (threadCount + 1) / 2));
+    EXPECT_EQ(snapshot.max, perThread * threadCount);
+}
@@ -0,0 +1,130 @@
+#include <array>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "util/OpusFrameArena.h"
+
+using creatures::util::OpusFrameArena;
+
+namespace {
+
+std::vector<uint8_t> bytes(std::span<const uint8_t> frame) { return {frame.begin(), frame.end()}; }
+
+} // namespace
+
+TEST(OpusFrameArena, HandsBackWhatWasSet) {
+    OpusFrameArena arena(3);
+    arena.set(0, 0, std::array<uint8_t, 2>{1, 2});
+    arena.set(16, 2, std::array<uint8_t, 3>{3, 4, 5});
+
+    EXPECT_EQ(bytes(arena.frame(0, 0)), (std::vector<uint8_t>{1, 2}));
+    EXPECT_EQ(bytes(arena.frame(16, 2)), (std::vector<uint8_t>{3, 4, 5}));
+    EXPECT_TRUE(arena.frame(5, 1).empty());
+    EXPECT_EQ(arena.byteSize(), 5u);
+}
+
+TEST(OpusFrameArena, ASizeHintMeansOneBlock) {
+    constexpr std::size_t frames = 100;
+    OpusFrameArena arena(frames, frames * RTP_STREAMING_CHANNELS * 320);
+    const std::vector<uint8_t> packet(320, 0x7f);
+    for (uint8_t channel = 0; channel < RTP_STREAMING_CHANNELS; ++channel) {
+        for (std::size_t frame = 0; frame < frames; ++frame) {
+            arena.set(channel, frame, packet);
+        }
+    }
+
+    EXPECT_EQ(arena.blockCount(), 1u);
+    EXPECT_EQ(arena.frame(3, 1).data() + 320, arena.frame(3, 2).data());
+}
+
+TEST(OpusFrameArena, FramesDontMoveWhenItGrows) {
+    constexpr std::size_t frames = 1000;
+    OpusFrameArena arena(frames);
+    const std::vector<uint8_t> packet(320, 0x11);
+    arena.set(0, 0, packet);
+    const auto *first = arena.frame(0, 0).data();
+
+    for (uint8_t channel = 0; channel < RTP_STREAMING_CHANNELS; ++channel) {
+        for (std::size_t frame = channel == 0 ? 1 : 0; frame < frames; ++frame) {
+            arena.set(channel, frame, packet);
+        }
+    }
+
+    EXPECT_GT(arena.blockCount(), 1u);
+    EXPECT_EQ(arena.frame(0, 0).data(), first);
+    EXPECT_EQ(bytes(arena.frame(0, 0)), packet);
+    EXPECT_EQ(bytes(arena.frame(16, frames - 1)), packet);
+}
+
+TEST(OpusFrameArena, AllocatedChannelsAreBackToBack) {
+    OpusFrameArena arena(3);
+    const std::array<uint32_t, 3> lengths{2, 0, 3};
+    auto channel = arena.allocateChannel(4, lengths);
+    ASSERT_EQ(channel.size(), 5u);
+    const std::array<uint8_t, 5> data{9, 8, 7, 6, 5};
+    std::copy(data.begin(), data.end(), channel.begin());
+
+    EXPECT_EQ(bytes(arena.frame(4, 0)), (std::vector<uint8_t>{9, 8}));
+    EXPECT_TRUE(arena.frame(4, 1).empty());
+    EXPECT_EQ(bytes(arena.frame(4, 2)), (std::vector<uint8_t>{7, 6, 5}));
+}
+
+TEST(OpusFrameArena, RejectsFramesThatArentThere) {
+    OpusFrameArena arena(2);
+    const std::array<uint8_t, 1> packet{1};
+    EXPECT_THROW(arena.set(RTP_STREAMING_CHANNELS, 0, packet), std::out_of_range);
+    EXPECT_THROW(arena.set(0, 2, packet), std::out_of_range);
+    EXPECT_THROW(arena.allocateChannel(0, std::array<uint32_t, 3>{1, 1, 1}), std::invalid_argument);
+}
+
+TEST(OpusFrameArena, ComparesTheBytesNotWhereTheyLive) {
+    OpusFrameArena packed(2, 1024);
+    OpusFrameArena spread(2);
+    OpusFrameArena different(2);
+    for (uint8_t channel = 0; channel < RTP_STREAMING_CHANNELS; ++channel) {
+        const std::array<uint8_t, 2> packet{channel, 1};
+        packed.set(channel, 0, packet);
+        packed.set(channel, 1, packet);
+        spread.set(channel, 1, packet);
+        spread.set(channel, 0, packet);
+        different.set(channel, 0, packet);
+        different.set(channel, 1, channel == 16 ? std::array<uint8_t, 2>{16, 2} : packet);
+    }
+    EXPECT_EQ(packed, spread);
+    EXPECT_FALSE(packed == different);
+}
+
+TEST(OpusFrameArena, ViewsReadInPlace) {
+    const std::vector<uint8_t> data{1, 2, 3, 4, 5};
+    std::vector<OpusFrameArena::PackedEntry> index(RTP_STREAMING_CHANNELS);
+    index[0] = {0, 2, 0};
+    index[1] = {2, 3, 0};
+    index[2] = {4, 2, 0}; // runs off the end
+
+    const auto view = OpusFrameArena::view(1, index, data, nullptr);
+    EXPECT_TRUE(view->isView());
+    EXPECT_EQ(view->frame(0, 0).data(), data.data());
+    EXPECT_EQ(bytes(view->frame(1, 0)), (std::vector<uint8_t>{3, 4, 5}));
+    EXPECT_TRUE(view->frame(2, 0).empty());
+    EXPECT_THROW(OpusFrameArena::view(2, index, data, nullptr), std::invalid_argument);
+}
+
+TEST(OpusFrameArena, RemembersWhichFramesWereSilent) {
+    OpusFrameArena arena(2);
+    const std::array<uint8_t, 1> packet{1};
+    arena.set(3, 0, packet);
+    arena.set(3, 1, packet, true);
+
+    EXPECT_FALSE(arena.isSilent(3, 0));
+    EXPECT_TRUE(arena.isSilent(3, 1));
+
+    std::vector<OpusFrameArena::PackedEntry> index(RTP_STREAMING_CHANNELS);
+    index[5] = {0, 1, OpusFrameArena::SILENT_FRAME};
+    const auto view = OpusFrameArena::view(1, index, packet, nullptr);
+    EXPECT_TRUE(view->isSilent(5, 0));
+    EXPECT_FALSE(view->isSilent(4, 0));
+}